@@ -11,6 +11,9 @@ cpp_examples = [
     ("dynamic-global-routing", "True", "True"),
     ("global-injection-slash32", "True", "True"),
     ("global-routing-slash32", "True", "True"),
+    ("global-routing-fat-tree", "True", "True"),
+    ("global-routing-link-flap --nodes=40 --flaps=5", "True", "True"),
+    ("global-routing-link-flap --nodes=40 --flaps=5 --compactRoutes=1", "True", "True"),
     ("mixed-global-routing", "True", "True"),
     ("simple-alternate-routing", "True", "True"),
     ("simple-global-routing", "True", "True"),
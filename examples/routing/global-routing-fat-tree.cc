@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+// This program measures the time taken to populate the global routing
+// tables of a k-ary fat-tree of point-to-point links: (k/2)^2 core switches
+// and k pods of k/2 aggregation and k/2 edge switches, each edge switch
+// having k/2 hosts.  The SPF calculations of the switches are run by
+// --numThreads threads, and the routing tables do not depend on it.
+//
+// Example:
+//   ./ns3 run "global-routing-fat-tree --k=16 --numThreads=4"
+
+#include <iostream>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/global-route-manager.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("GlobalRoutingFatTree");
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t k = 8;
+  uint32_t numThreads = 1;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("k", "The number of ports of the switches (even)", k);
+  cmd.AddValue ("numThreads", "The number of threads computing the routes", numThreads);
+  cmd.Parse (argc, argv);
+
+  if (k < 2 || k % 2 != 0)
+    {
+      NS_FATAL_ERROR ("The number of ports must be even");
+    }
+  Config::SetGlobal ("GlobalRoutingNumThreads", UintegerValue (numThreads));
+
+  uint32_t half = k / 2;
+  NodeContainer core;
+  core.Create (half * half);
+  std::vector<NodeContainer> aggregation (k);
+  std::vector<NodeContainer> edge (k);
+  NodeContainer hosts;
+  for (uint32_t pod = 0; pod < k; pod++)
+    {
+      aggregation[pod].Create (half);
+      edge[pod].Create (half);
+    }
+  hosts.Create (k * half * half);
+
+  InternetStackHelper internet;
+  internet.InstallAll ();
+
+  PointToPointHelper p2p;
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.0.0.0", "255.255.255.252");
+  uint32_t nLinks = 0;
+  for (uint32_t pod = 0; pod < k; pod++)
+    {
+      for (uint32_t a = 0; a < half; a++)
+        {
+          // aggregation switch a of each pod is linked to the core switches
+          // a * k / 2 to (a + 1) * k / 2 - 1
+          for (uint32_t c = 0; c < half; c++)
+            {
+              ipv4.Assign (p2p.Install (aggregation[pod].Get (a), core.Get (a * half + c)));
+              ipv4.NewNetwork ();
+              nLinks++;
+            }
+          for (uint32_t e = 0; e < half; e++)
+            {
+              ipv4.Assign (p2p.Install (aggregation[pod].Get (a), edge[pod].Get (e)));
+              ipv4.NewNetwork ();
+              nLinks++;
+            }
+        }
+      for (uint32_t e = 0; e < half; e++)
+        {
+          for (uint32_t h = 0; h < half; h++)
+            {
+              ipv4.Assign (p2p.Install (edge[pod].Get (e), hosts.Get ((pod * half + e) * half + h)));
+              ipv4.NewNetwork ();
+              nLinks++;
+            }
+        }
+    }
+  std::cout << "Fat-tree with k=" << k << ": " << NodeList::GetNNodes () << " nodes, "
+            << nLinks << " links" << std::endl;
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  GlobalRouteManager::BuildGlobalRoutingDatabase ();
+  int64_t databaseMs = clock.End ();
+  clock.Start ();
+  GlobalRouteManager::InitializeRoutes ();
+  int64_t routesMs = clock.End ();
+
+  uint64_t nRoutes = 0;
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); i++)
+    {
+      Ptr<GlobalRouter> router = (*i)->GetObject<GlobalRouter> ();
+      nRoutes += router->GetRoutingProtocol ()->GetNRoutes ();
+    }
+  std::cout << "Global routing database built in " << databaseMs << " ms" << std::endl;
+  std::cout << nRoutes << " routes computed in " << routesMs << " ms using "
+            << numThreads << " threads" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
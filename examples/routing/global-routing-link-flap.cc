@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+// This program compares the time taken to update the global routing tables
+// after a link failure or repair by a full recomputation (deleting the
+// routes, rebuilding the link state database and running SPF from every
+// router) and by the incremental update of
+// Ipv4GlobalRoutingHelper::RecomputeRoutingTables, which only reruns SPF
+// from the routers whose shortest paths are affected by the change.
+//
+// The topology is a random connected graph of --nodes routers (2000 by
+// default) connected by point-to-point links: each router is linked to a
+// random router created before it, and random links are added until the
+// average degree of the routers is --degree.  The metrics of the links are
+// drawn between 1 and --maxMetric.  Each of the --flaps link flaps brings a
+// random link down and then up again, and the routes are updated after each
+// event by both methods.
+//
+// The routers recalculated by the incremental update are those whose
+// shortest paths may use the link, so the gain depends on the topology: with
+// --maxMetric=1, most links are on the shortest paths of most routers.
+//
+// The memory used by the routes of each router is also reported; with
+// --compactRoutes=1 the routes are stored in compact route tables.
+//
+// Example:
+//   ./ns3 run "global-routing-link-flap --nodes=200 --flaps=20"
+
+#include <iostream>
+#include <set>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/global-route-manager.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("GlobalRoutingLinkFlap");
+
+// Set both ends of a point-to-point link up or down
+static void
+SetLinkUp (NetDeviceContainer link, bool up)
+{
+  for (uint32_t i = 0; i < link.GetN (); i++)
+    {
+      Ptr<NetDevice> device = link.Get (i);
+      Ptr<Ipv4> ipv4 = device->GetNode ()->GetObject<Ipv4> ();
+      int32_t interface = ipv4->GetInterfaceForDevice (device);
+      if (up)
+        {
+          ipv4->SetUp (interface);
+        }
+      else
+        {
+          ipv4->SetDown (interface);
+        }
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nodes = 2000;
+  double degree = 4;
+  uint32_t maxMetric = 10;
+  uint32_t flaps = 10;
+  bool compactRoutes = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("nodes", "The number of routers", nodes);
+  cmd.AddValue ("degree", "The average number of links of the routers", degree);
+  cmd.AddValue ("maxMetric", "The maximum metric of the links", maxMetric);
+  cmd.AddValue ("flaps", "The number of link flaps", flaps);
+  cmd.AddValue ("compactRoutes", "Store the routes in compact route tables", compactRoutes);
+  cmd.Parse (argc, argv);
+
+  if (nodes < 2 || maxMetric < 1)
+    {
+      NS_FATAL_ERROR ("The topology needs at least two routers and a positive metric");
+    }
+  uint64_t nLinks = std::max<uint64_t> (nodes - 1, degree * nodes / 2);
+  if (nLinks > static_cast<uint64_t> (nodes) * (nodes - 1) / 2)
+    {
+      NS_FATAL_ERROR ("The average degree must be less than the number of routers");
+    }
+
+  Config::SetDefault ("ns3::Ipv4GlobalRouting::CompactRoutes", BooleanValue (compactRoutes));
+
+  NodeContainer routers;
+  routers.Create (nodes);
+  InternetStackHelper internet;
+  internet.Install (routers);
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  std::set<std::pair<uint32_t, uint32_t> > pairs;
+  for (uint32_t n = 1; n < nodes; n++)
+    {
+      pairs.insert (std::make_pair (random->GetInteger (0, n - 1), n));
+    }
+  while (pairs.size () < nLinks)
+    {
+      uint32_t a = random->GetInteger (0, nodes - 1);
+      uint32_t b = random->GetInteger (0, nodes - 1);
+      if (a != b)
+        {
+          pairs.insert (std::make_pair (std::min (a, b), std::max (a, b)));
+        }
+    }
+
+  PointToPointHelper p2p;
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.0.0.0", "255.255.255.252");
+  std::vector<NetDeviceContainer> links;
+  for (std::set<std::pair<uint32_t, uint32_t> >::const_iterator i = pairs.begin (); i != pairs.end (); i++)
+    {
+      NetDeviceContainer link = p2p.Install (routers.Get (i->first), routers.Get (i->second));
+      ipv4.Assign (link);
+      ipv4.NewNetwork ();
+      uint16_t metric = random->GetInteger (1, maxMetric);
+      for (uint32_t j = 0; j < link.GetN (); j++)
+        {
+          Ptr<Ipv4> stack = link.Get (j)->GetNode ()->GetObject<Ipv4> ();
+          stack->SetMetric (stack->GetInterfaceForDevice (link.Get (j)), metric);
+        }
+      links.push_back (link);
+    }
+  std::cout << nodes << " routers, " << links.size () << " links" << std::endl;
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  std::cout << "Routing tables populated in " << clock.End () << " ms" << std::endl;
+  std::size_t bytes = 0;
+  for (uint32_t i = 0; i < nodes; i++)
+    {
+      bytes += routers.Get (i)->GetObject<GlobalRouter> ()->GetRoutingProtocol ()->GetMemoryUsage ();
+    }
+  std::cout << "Routes of " << bytes / nodes << " bytes per router" << std::endl;
+
+  int64_t fullMs = 0;
+  int64_t incrementalMs = 0;
+  for (uint32_t flap = 0; flap < flaps; flap++)
+    {
+      NetDeviceContainer link = links[random->GetInteger (0, links.size () - 1)];
+      for (bool up : {false, true})
+        {
+          SetLinkUp (link, up);
+
+          clock.Start ();
+          Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+          incrementalMs += clock.End ();
+
+          clock.Start ();
+          GlobalRouteManager::DeleteGlobalRoutes ();
+          GlobalRouteManager::BuildGlobalRoutingDatabase ();
+          GlobalRouteManager::InitializeRoutes ();
+          fullMs += clock.End ();
+        }
+    }
+
+  std::cout << 2 * flaps << " link events:" << std::endl;
+  std::cout << "  full recomputation:  " << fullMs << " ms" << std::endl;
+  std::cout << "  incremental update:  " << incrementalMs << " ms" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -10,7 +10,10 @@
 cpp_examples = [
     ("star", "True", "True"),
     ("tcp-large-transfer", "True", "True"),
+    ("tcp-many-connections --connections=100", "True", "True"),
     ("tcp-star-server", "True", "True"),
+    ("tcp-segmentation-offload --bottleneck=100Mbps --time=2 --offload=16", "True", "True"),
+    ("tcp-timer-wheel --flows=100 --time=3 --timerWheel=1", "True", "True"),
     ("tcp-variants-comparison", "True", "True"),
     ("tcp-validation --firstTcpType=dctcp --linkRate=50Mbps --baseRtt=10ms --queueUseEcn=1 --stopTime=15s --validate=dctcp-10ms", "True", "True"),
     ("tcp-validation --firstTcpType=dctcp --linkRate=50Mbps --baseRtt=80ms --queueUseEcn=1 --stopTime=40s --validate=dctcp-80ms", "True", "True"),
@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+// This program measures the time taken to simulate a server holding many
+// concurrent TCP connections, which exercises the demultiplexing of the
+// received packets to the endpoints of the server.
+//
+//   client 0 -----+
+//   client 1 -----+---- server (PacketSink)
+//   ...      -----+
+//
+// The --connections connections (50000 by default) are opened to a
+// PacketSink during the first --openTime seconds, from as many client nodes
+// as needed to allocate their ephemeral ports.  All the connections stay
+// open, and each of them then sends --packets packets of --packetSize bytes
+// at random times during the following --sendTime seconds.
+//
+// The program reports the number of connections accepted and of packets and
+// bytes received by the server, and the wall clock time of the simulation.
+//
+// Example:
+//   ./ns3 run "tcp-many-connections --connections=5000"
+
+#include <iostream>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpManyConnections");
+
+/// The number of connections opened by each client node
+static const uint32_t CONNECTIONS_PER_CLIENT = 16000;
+
+// Send a packet on a connection
+static void
+SendPacket (Ptr<Socket> socket, uint32_t packetSize)
+{
+  socket->Send (Create<Packet> (packetSize));
+}
+
+// Count the packets received by the server
+static void
+CountReceived (uint32_t *received, Ptr<const Packet>, const Address &)
+{
+  (*received)++;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t connections = 50000;
+  uint32_t packets = 2;
+  uint32_t packetSize = 100;
+  double openTime = 5;
+  double sendTime = 5;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("connections", "The number of concurrent connections", connections);
+  cmd.AddValue ("packets", "The number of packets sent on each connection", packets);
+  cmd.AddValue ("packetSize", "The size of the packets in bytes", packetSize);
+  cmd.AddValue ("openTime", "The time during which the connections are opened, in seconds", openTime);
+  cmd.AddValue ("sendTime", "The time during which the packets are sent, in seconds", sendTime);
+  cmd.Parse (argc, argv);
+
+  if (connections == 0 || openTime <= 0 || sendTime <= 0)
+    {
+      NS_FATAL_ERROR ("The number of connections and the times must be positive");
+    }
+
+  // Small buffers keep the memory used by the sockets low
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (4 * packetSize * packets));
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (4 * packetSize * packets));
+
+  uint32_t nClients = (connections + CONNECTIONS_PER_CLIENT - 1) / CONNECTIONS_PER_CLIENT;
+  Ptr<Node> server = CreateObject<Node> ();
+  NodeContainer clients;
+  clients.Create (nClients);
+  InternetStackHelper internet;
+  internet.Install (server);
+  internet.Install (clients);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("10Gbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  p2p.SetQueue ("ns3::DropTailQueue", "MaxSize", StringValue ("100000p"));
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.255.252");
+  Ipv4Address serverAddress;
+  for (uint32_t i = 0; i < nClients; i++)
+    {
+      Ipv4InterfaceContainer interfaces = ipv4.Assign (p2p.Install (server, clients.Get (i)));
+      serverAddress = interfaces.GetAddress (0);
+      ipv4.NewNetwork ();
+    }
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  uint16_t port = 9;
+  PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApp = sinkHelper.Install (server);
+  sinkApp.Start (Seconds (0));
+  Ptr<PacketSink> sink = DynamicCast<PacketSink> (sinkApp.Get (0));
+  uint32_t received = 0;
+  sink->TraceConnectWithoutContext ("Rx", MakeBoundCallback (&CountReceived, &received));
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  std::vector<Ptr<Socket> > sockets;
+  for (uint32_t c = 0; c < connections; c++)
+    {
+      Ptr<Socket> socket = Socket::CreateSocket (clients.Get (c / CONNECTIONS_PER_CLIENT),
+                                                 TcpSocketFactory::GetTypeId ());
+      socket->Bind ();
+      Simulator::Schedule (Seconds (openTime * c / connections), &Socket::Connect,
+                           socket, Address (InetSocketAddress (serverAddress, port)));
+      for (uint32_t p = 0; p < packets; p++)
+        {
+          Simulator::Schedule (Seconds (openTime + 1 + random->GetValue (0, sendTime)),
+                               &SendPacket, socket, packetSize);
+        }
+      sockets.push_back (socket);
+    }
+
+  std::cout << connections << " connections from " << nClients << " clients" << std::endl;
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Stop (Seconds (openTime + sendTime + 2));
+  Simulator::Run ();
+  int64_t ms = clock.End ();
+
+  std::cout << "Connections accepted by the server: " << sink->GetAcceptedSockets ().size () << std::endl;
+  std::cout << "Packets received by the server:     " << received << std::endl;
+  std::cout << "Bytes received by the server:       " << sink->GetTotalRx () << std::endl;
+  std::cout << "Simulated in " << ms << " ms" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
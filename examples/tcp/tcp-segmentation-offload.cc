@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+// This program measures the cost of simulating high-rate TCP bulk
+// transfers, with and without segmentation offload.
+//
+//   sender ---- router ---- receiver (PacketSink)
+//
+// The --flows bulk transfers share a --bottleneck link to the receiver
+// until --time.  With --offload=k, the sockets send up to k segments of new
+// data at once as a super-segment (the SegmentationOffload attribute of
+// TcpSocketBase), which the point-to-point devices transmit as a whole in
+// the time of its segments.  The receiver acknowledges a super-segment as
+// the segments it carries.
+//
+// The program reports the goodput, the number of packets sent by the IP
+// layer of the sender, the number of events processed by the simulator and
+// the wall clock time of the simulation.  A super-segment is split into
+// segments before the queue discs, which drop and mark each packet, so the
+// devices have no queue disc and queues of bytes, with room for the
+// segments of the super-segments.
+//
+// Example:
+//   ./ns3 run "tcp-segmentation-offload --offload=16"
+
+#include <iostream>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/traffic-control-module.h"
+#include "ns3/applications-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpSegmentationOffload");
+
+/// The number of packets sent by the IP layer of the sender
+static uint64_t g_txPackets = 0;
+
+/**
+ * Count the packets sent by the IP layer of the sender.
+ * \param packet The packet.
+ * \param ipv4 The IPv4 protocol.
+ * \param interface The interface.
+ */
+static void
+Tx (Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  g_txPackets++;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t flows = 4;
+  std::string bottleneck = "1Gbps";
+  double time = 3;
+  uint32_t offload = 1;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("flows", "The number of concurrent flows", flows);
+  cmd.AddValue ("bottleneck", "The data rate of the link to the receiver", bottleneck);
+  cmd.AddValue ("time", "The duration of the simulation, in seconds", time);
+  cmd.AddValue ("offload", "The maximum number of segments of a super-segment", offload);
+  cmd.Parse (argc, argv);
+
+  if (flows == 0 || offload == 0 || time <= 1)
+    {
+      NS_FATAL_ERROR ("The number of flows and segments must be positive and the duration longer than a second");
+    }
+
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (4 << 20));
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (4 << 20));
+  Config::SetDefault ("ns3::TcpSocketBase::SegmentationOffload", UintegerValue (offload));
+
+  Ptr<Node> sender = CreateObject<Node> ();
+  Ptr<Node> router = CreateObject<Node> ();
+  Ptr<Node> receiver = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (sender);
+  internet.Install (router);
+  internet.Install (receiver);
+
+  PointToPointHelper access;
+  access.SetDeviceAttribute ("DataRate", StringValue ("10Gbps"));
+  access.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  access.SetQueue ("ns3::DropTailQueue", "MaxSize", StringValue ("4MB"));
+  PointToPointHelper link;
+  link.SetDeviceAttribute ("DataRate", StringValue (bottleneck));
+  link.SetChannelAttribute ("Delay", StringValue ("5ms"));
+  link.SetQueue ("ns3::DropTailQueue", "MaxSize", StringValue ("4MB"));
+  NetDeviceContainer accessDevices = access.Install (sender, router);
+  NetDeviceContainer linkDevices = link.Install (router, receiver);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  ipv4.Assign (accessDevices);
+  ipv4.SetBase ("10.1.2.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = ipv4.Assign (linkDevices);
+
+  // Remove the default queue discs installed by the address helper
+  TrafficControlHelper tch;
+  tch.Uninstall (accessDevices);
+  tch.Uninstall (linkDevices);
+  Ipv4Address receiverAddress = interfaces.GetAddress (1);
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  uint16_t port = 9;
+  PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApp = sinkHelper.Install (receiver);
+  sinkApp.Start (Seconds (0));
+  Ptr<PacketSink> sink = DynamicCast<PacketSink> (sinkApp.Get (0));
+
+  BulkSendHelper bulkHelper ("ns3::TcpSocketFactory", InetSocketAddress (receiverAddress, port));
+  for (uint32_t f = 0; f < flows; f++)
+    {
+      ApplicationContainer bulkApp = bulkHelper.Install (sender);
+      bulkApp.Start (Seconds (0.1 * f / flows));
+    }
+  sender->GetObject<Ipv4L3Protocol> ()->TraceConnectWithoutContext ("Tx", MakeCallback (&Tx));
+
+  std::cout << flows << " flows, super-segments of up to " << offload << " segments" << std::endl;
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Stop (Seconds (time));
+  Simulator::Run ();
+  int64_t ms = clock.End ();
+
+  std::cout << "Bytes received:       " << sink->GetTotalRx () << std::endl;
+  std::cout << "Goodput:              " << sink->GetTotalRx () * 8 / time / 1e6 << " Mbps" << std::endl;
+  std::cout << "Packets sent:         " << g_txPackets << std::endl;
+  std::cout << "Events processed:     " << Simulator::GetEventCount () << std::endl;
+  std::cout << "Simulated in " << ms << " ms" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
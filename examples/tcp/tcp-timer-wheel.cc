@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+// This program measures the events processed by the simulator for many
+// concurrent long-lived TCP flows, whose retransmission and delayed ACK
+// timers are re-armed on almost every segment.
+//
+//   sender 0 -----+
+//   sender 1 -----+---- router ---- receiver (PacketSink)
+//   ...      -----+
+//
+// The --flows bulk transfers (10000 by default) start during the first
+// second, from as many sender nodes as needed to allocate their ephemeral
+// ports, and share a --bottleneck link to the receiver until --time.
+//
+// The program reports the bytes received, the number of events processed
+// by the simulator (including the cancelled events it skipped), the number
+// of timer events cancelled before their expiration, their residency (the
+// average number of cancelled timer events held by the scheduler), and the
+// wall clock time of the simulation.  With --timerWheel=1 the timers of the
+// sockets are stored in a timer wheel of each node (the TimerWheel
+// attribute of TcpL4Protocol) and leave almost no cancelled event in the
+// scheduler.
+//
+// Example:
+//   ./ns3 run "tcp-timer-wheel --flows=1000 --timerWheel=1"
+
+#include <iostream>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpTimerWheel");
+
+/// The number of flows sent by each sender node
+static const uint32_t FLOWS_PER_SENDER = 10000;
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t flows = 10000;
+  std::string bottleneck = "500Mbps";
+  double time = 10;
+  bool timerWheel = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("flows", "The number of concurrent flows", flows);
+  cmd.AddValue ("bottleneck", "The data rate of the link to the receiver", bottleneck);
+  cmd.AddValue ("time", "The duration of the simulation, in seconds", time);
+  cmd.AddValue ("timerWheel", "Store the timers of the sockets in timer wheels", timerWheel);
+  cmd.Parse (argc, argv);
+
+  if (flows == 0 || time <= 1)
+    {
+      NS_FATAL_ERROR ("The number of flows must be positive and the duration longer than a second");
+    }
+
+  Config::SetDefault ("ns3::TcpL4Protocol::TimerWheel", BooleanValue (timerWheel));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
+
+  uint32_t nSenders = (flows + FLOWS_PER_SENDER - 1) / FLOWS_PER_SENDER;
+  NodeContainer senders;
+  senders.Create (nSenders);
+  Ptr<Node> router = CreateObject<Node> ();
+  Ptr<Node> receiver = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (senders);
+  internet.Install (router);
+  internet.Install (receiver);
+
+  PointToPointHelper access;
+  access.SetDeviceAttribute ("DataRate", StringValue ("10Gbps"));
+  access.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  PointToPointHelper link;
+  link.SetDeviceAttribute ("DataRate", StringValue (bottleneck));
+  link.SetChannelAttribute ("Delay", StringValue ("10ms"));
+  link.SetQueue ("ns3::DropTailQueue", "MaxSize", StringValue ("1000p"));
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.255.252");
+  for (uint32_t i = 0; i < nSenders; i++)
+    {
+      ipv4.Assign (access.Install (senders.Get (i), router));
+      ipv4.NewNetwork ();
+    }
+  Ipv4InterfaceContainer interfaces = ipv4.Assign (link.Install (router, receiver));
+  Ipv4Address receiverAddress = interfaces.GetAddress (1);
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  uint16_t port = 9;
+  PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApp = sinkHelper.Install (receiver);
+  sinkApp.Start (Seconds (0));
+  Ptr<PacketSink> sink = DynamicCast<PacketSink> (sinkApp.Get (0));
+
+  BulkSendHelper bulkHelper ("ns3::TcpSocketFactory", InetSocketAddress (receiverAddress, port));
+  for (uint32_t f = 0; f < flows; f++)
+    {
+      ApplicationContainer bulkApp = bulkHelper.Install (senders.Get (f / FLOWS_PER_SENDER));
+      bulkApp.Start (Seconds (1.0 * f / flows));
+    }
+
+  std::cout << flows << " flows from " << nSenders << " senders, timer wheel "
+            << (timerWheel ? "enabled" : "disabled") << std::endl;
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Stop (Seconds (time));
+  Simulator::Run ();
+  int64_t ms = clock.End ();
+
+  std::cout << "Bytes received:               " << sink->GetTotalRx () << std::endl;
+  std::cout << "Events processed:             " << Simulator::GetEventCount () << std::endl;
+  std::cout << "Cancelled timer events:       " << WheelTimer::GetCancelledEvents () << std::endl;
+  std::cout << "Cancelled timer residency:    "
+            << WheelTimer::GetCancelledEventResidency ().GetSeconds () / time << " events" << std::endl;
+  std::cout << "Simulated in " << ms << " ms" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
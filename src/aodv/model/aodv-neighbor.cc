@@ -37,10 +37,8 @@ NS_LOG_COMPONENT_DEFINE ("AodvNeighbors");
 
 namespace aodv {
 Neighbors::Neighbors (Time delay)
-  : m_ntimer (Timer::CANCEL_ON_DESTROY)
+  : m_delay (delay)
 {
-  m_ntimer.SetDelay (delay);
-  m_ntimer.SetFunction (&Neighbors::Purge, this);
   m_txErrorCallback = MakeCallback (&Neighbors::ProcessTxError, this);
 }
 
@@ -135,15 +133,16 @@ Neighbors::Purge ()
         }
     }
   m_nb.erase (std::remove_if (m_nb.begin (), m_nb.end (), pred), m_nb.end ());
-  m_ntimer.Cancel ();
-  m_ntimer.Schedule ();
+  ScheduleTimer ();
 }
 
 void
 Neighbors::ScheduleTimer ()
 {
-  m_ntimer.Cancel ();
-  m_ntimer.Schedule ();
+  // The purge is rescheduled at each update of the list, which leaves no
+  // cancelled event in the scheduler
+  m_calendar.Cancel (m_purge);
+  m_purge = m_calendar.Schedule (m_delay, &Neighbors::Purge, this);
 }
 
 void
@@ -31,7 +31,7 @@
 
 #include <vector>
 #include "ns3/simulator.h"
-#include "ns3/timer.h"
+#include "ns3/expiry-calendar.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/callback.h"
 #include "ns3/arp-cache.h"
@@ -103,7 +103,7 @@ public:
   void Update (Ipv4Address addr, Time expire);
   /// Remove all expired entries
   void Purge ();
-  /// Schedule m_ntimer.
+  /// Schedule the next purge of the list.
   void ScheduleTimer ();
   /// Remove all entries
   void Clear ()
@@ -152,8 +152,12 @@ private:
   Callback<void, Ipv4Address> m_handleLinkFailure;
   /// TX error callback
   Callback<void, WifiMacHeader const &> m_txErrorCallback;
-  /// Timer for neighbor's list. Schedule Purge().
-  Timer m_ntimer;
+  /// Delay between the purges of the list
+  Time m_delay;
+  /// Calendar of the purges of the list
+  ExpiryCalendar m_calendar;
+  /// Next purge of the list
+  ExpiryCalendar::Id m_purge;
   /// vector of entries
   std::vector<Neighbor> m_nb;
   /// list of ARP cached to be used for layer 2 notifications processing
@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * This program measures the cost of the queries on the buildings of a
+ * synthetic Manhattan grid (142x142 blocks by default, i.e., about 20000
+ * buildings), as performed by MobilityBuildingInfo::MakeConsistent (which
+ * buildings contain a position) and by BuildingsChannelConditionModel
+ * (whether a building blocks the line of sight between two positions).
+ *
+ * Each query is performed by checking every building of the BuildingList,
+ * as done before the introduction of the spatial index, and by means of
+ * the indexed BuildingList methods. The time per query (in microseconds)
+ * and the number of queries with different results, which must be zero,
+ * are printed.
+ */
+
+#include <iostream>
+#include <chrono>
+#include "ns3/core-module.h"
+#include "ns3/building-allocator.h"
+#include "ns3/building-list.h"
+#include "ns3/building.h"
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t gridWidth = 142;
+  double blockSize = 80;
+  double streetWidth = 20;
+  double maxDistance = 500;
+  uint32_t numQueries = 2000;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("gridWidth", "Number of blocks along each side of the grid", gridWidth);
+  cmd.AddValue ("blockSize", "Side of a block (m)", blockSize);
+  cmd.AddValue ("streetWidth", "Width of the streets (m)", streetWidth);
+  cmd.AddValue ("maxDistance", "Maximum distance between the two ends of a line of sight (m)", maxDistance);
+  cmd.AddValue ("numQueries", "Number of queries of each type", numQueries);
+  cmd.Parse (argc, argv);
+
+  Ptr<GridBuildingAllocator> gridBuildingAllocator = CreateObject<GridBuildingAllocator> ();
+  gridBuildingAllocator->SetAttribute ("GridWidth", UintegerValue (gridWidth));
+  gridBuildingAllocator->SetAttribute ("LengthX", DoubleValue (blockSize));
+  gridBuildingAllocator->SetAttribute ("LengthY", DoubleValue (blockSize));
+  gridBuildingAllocator->SetAttribute ("DeltaX", DoubleValue (streetWidth));
+  gridBuildingAllocator->SetAttribute ("DeltaY", DoubleValue (streetWidth));
+  gridBuildingAllocator->SetAttribute ("Height", DoubleValue (20));
+  gridBuildingAllocator->Create (gridWidth * gridWidth);
+  double side = gridWidth * (blockSize + streetWidth);
+
+  // the positions of the users are random, 1.5 m above the ground, and the
+  // other end of a line of sight is a base station at most maxDistance away
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  std::vector<Vector> positions;
+  std::vector<Vector> others;
+  for (uint32_t n = 0; n < numQueries; n++)
+    {
+      Vector position (random->GetValue (0, side), random->GetValue (0, side), 1.5);
+      positions.push_back (position);
+      double distance = random->GetValue (0, maxDistance);
+      double angle = random->GetValue (0, 2 * M_PI);
+      others.push_back (Vector (position.x + distance * std::cos (angle), position.y + distance * std::sin (angle), 25));
+    }
+
+  std::cout << BuildingList::GetNBuildings () << " buildings" << std::endl;
+
+  // build the index before measuring the indexed queries
+  BuildingList::GetBuildingsAt (positions[0]);
+
+  std::vector<uint32_t> linearResults;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  for (const auto &position : positions)
+    {
+      uint32_t found = 0;
+      for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
+        {
+          if ((*bit)->IsInside (position))
+            {
+              found = (*bit)->GetId () + 1;
+            }
+        }
+      linearResults.push_back (found);
+    }
+  std::chrono::duration<double, std::micro> linearTime = std::chrono::steady_clock::now () - start;
+
+  uint32_t mismatches = 0;
+  start = std::chrono::steady_clock::now ();
+  for (uint32_t n = 0; n < numQueries; n++)
+    {
+      std::vector<Ptr<Building> > buildings = BuildingList::GetBuildingsAt (positions[n]);
+      mismatches += ((buildings.empty () ? 0 : buildings.back ()->GetId () + 1) != linearResults[n]);
+    }
+  std::chrono::duration<double, std::micro> indexTime = std::chrono::steady_clock::now () - start;
+  std::cout << "position queries: linear " << linearTime.count () / numQueries << " us, indexed "
+            << indexTime.count () / numQueries << " us, " << mismatches << " mismatches" << std::endl;
+
+  linearResults.clear ();
+  start = std::chrono::steady_clock::now ();
+  for (uint32_t n = 0; n < numQueries; n++)
+    {
+      bool blocked = false;
+      for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End () && !blocked; ++bit)
+        {
+          blocked = (*bit)->IsIntersect (positions[n], others[n]);
+        }
+      linearResults.push_back (blocked);
+    }
+  linearTime = std::chrono::steady_clock::now () - start;
+
+  mismatches = 0;
+  start = std::chrono::steady_clock::now ();
+  for (uint32_t n = 0; n < numQueries; n++)
+    {
+      mismatches += (BuildingList::IsAnyBuildingIntersecting (positions[n], others[n]) != static_cast<bool> (linearResults[n]));
+    }
+  indexTime = std::chrono::steady_clock::now () - start;
+  std::cout << "line of sight queries: linear " << linearTime.count () / numQueries << " us, indexed "
+            << indexTime.count () / numQueries << " us, " << mismatches << " mismatches" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -181,22 +181,14 @@ OutdoorPositionAllocator::GetNext () const
 
       NS_LOG_INFO ("Position " << position);
 
-      bool inside = false;
-      for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
-        {
-          if ((*bit)->IsInside (position))
-            {
-              NS_LOG_INFO ("Position " << position << " is inside the building with boundaries "
-                                       << (*bit)->GetBoundaries ().xMin << " " << (*bit)->GetBoundaries ().xMax << " "
-                                       << (*bit)->GetBoundaries ().yMin << " " << (*bit)->GetBoundaries ().yMax << " "
-                                       << (*bit)->GetBoundaries ().zMin << " " << (*bit)->GetBoundaries ().zMax);
-              inside = true;
-              break;
-            }
-        }
-
-      if (inside)
+      std::vector<Ptr<Building> > buildings = BuildingList::GetBuildingsAt (position);
+      if (!buildings.empty ())
         {
+          Box boundaries = buildings.front ()->GetBoundaries ();
+          NS_LOG_INFO ("Position " << position << " is inside the building with boundaries "
+                                   << boundaries.xMin << " " << boundaries.xMax << " "
+                                   << boundaries.yMin << " " << boundaries.yMax << " "
+                                   << boundaries.zMin << " " << boundaries.zMax);
           NS_LOG_INFO ("Inside a building, attempt " << attempts << " out of " << m_maxAttempts);
           attempts++;
         }
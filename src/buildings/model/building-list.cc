@@ -27,6 +27,9 @@
 #include "ns3/assert.h"
 #include "building-list.h"
 #include "building.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace ns3 {
 
@@ -76,6 +79,30 @@ public:
    * \returns the container size
    */
   uint32_t GetNBuildings (void);
+  /**
+   * Gets the buildings which contain a position
+   * \param position the position
+   * \returns the buildings, ordered by ID
+   */
+  std::vector<Ptr<Building> > GetBuildingsAt (const Vector &position);
+  /**
+   * Gets the buildings which intersect a line segment
+   * \param l1 one end of the line segment
+   * \param l2 the other end of the line segment
+   * \returns the buildings, ordered by ID
+   */
+  std::vector<Ptr<Building> > GetBuildingsIntersecting (const Vector &l1, const Vector &l2);
+  /**
+   * Checks if a building intersects a line segment
+   * \param l1 one end of the line segment
+   * \param l2 the other end of the line segment
+   * \returns true if at least one building intersects the line segment
+   */
+  bool IsAnyBuildingIntersecting (const Vector &l1, const Vector &l2);
+  /**
+   * Invalidate the index of the buildings
+   */
+  void InvalidateIndex (void);
 
   /**
    * Get the Singleton instance of BuildingListPriv (or create one)
@@ -97,7 +124,44 @@ private:
    * 
    */
   static void Delete (void);
+  /**
+   * Build the index of the buildings, if it is not valid
+   */
+  void UpdateIndex (void);
+  /**
+   * \param x the x coordinate
+   * \returns the column of the cell containing x, clamped to the grid
+   */
+  uint32_t GetColumn (double x) const;
+  /**
+   * \param y the y coordinate
+   * \returns the row of the cell containing y, clamped to the grid
+   */
+  uint32_t GetRow (double y) const;
+  /**
+   * Gets the buildings whose footprint is registered in a cell crossed by
+   * a line segment. Every building is returned once.
+   * \param l1 one end of the line segment
+   * \param l2 the other end of the line segment
+   * \returns the indices of the buildings, in no particular order
+   */
+  std::vector<uint32_t> GetCandidates (const Vector &l1, const Vector &l2);
+
   std::vector<Ptr<Building> > m_buildings; //!< Container of Building
+
+  // The index is a uniform grid of square cells over the footprints of the
+  // buildings. Each cell stores the indices of the buildings whose
+  // footprint, enlarged by m_margin, overlaps the cell, in increasing order.
+  bool m_indexValid;                          //!< whether the index reflects the current buildings
+  double m_xMin;                              //!< x coordinate of the lower left corner of the grid
+  double m_yMin;                              //!< y coordinate of the lower left corner of the grid
+  double m_cellSize;                          //!< side of a cell
+  double m_margin;                            //!< the footprints are enlarged by this margin to absorb rounding errors
+  uint32_t m_nColumns;                        //!< number of columns of the grid
+  uint32_t m_nRows;                           //!< number of rows of the grid
+  std::vector<std::vector<uint32_t> > m_cells; //!< the indices of the buildings of each cell, row by row
+  std::vector<uint32_t> m_visited;            //!< the last query which visited each building
+  uint32_t m_query;                           //!< the number of the current query
 };
 
 NS_OBJECT_ENSURE_REGISTERED (BuildingListPriv);
@@ -143,6 +207,14 @@ BuildingListPriv::Delete (void)
 
 
 BuildingListPriv::BuildingListPriv ()
+  : m_indexValid (false),
+    m_xMin (0),
+    m_yMin (0),
+    m_cellSize (1),
+    m_margin (0),
+    m_nColumns (0),
+    m_nRows (0),
+    m_query (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -161,6 +233,9 @@ BuildingListPriv::DoDispose (void)
       *i = 0;
     }
   m_buildings.erase (m_buildings.begin (), m_buildings.end ());
+  m_cells.clear ();
+  m_visited.clear ();
+  m_indexValid = false;
   Object::DoDispose ();
 }
 
@@ -170,6 +245,7 @@ BuildingListPriv::Add (Ptr<Building> building)
 {
   uint32_t index = m_buildings.size ();
   m_buildings.push_back (building);
+  m_indexValid = false;
   Simulator::ScheduleWithContext (index, TimeStep (0), &Building::Initialize, building);
   return index;
 
@@ -198,6 +274,204 @@ BuildingListPriv::GetBuilding (uint32_t n)
   return m_buildings.at (n);
 }
 
+void
+BuildingListPriv::InvalidateIndex (void)
+{
+  m_indexValid = false;
+}
+
+void
+BuildingListPriv::UpdateIndex (void)
+{
+  if (m_indexValid)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << m_buildings.size ());
+
+  m_cells.clear ();
+  m_visited.assign (m_buildings.size (), 0);
+  m_query = 0;
+  m_indexValid = true;
+  if (m_buildings.empty ())
+    {
+      m_nColumns = 0;
+      m_nRows = 0;
+      return;
+    }
+
+  // the side of the cells is the mean of the largest side of the footprints
+  double xMin = std::numeric_limits<double>::max ();
+  double xMax = std::numeric_limits<double>::lowest ();
+  double yMin = std::numeric_limits<double>::max ();
+  double yMax = std::numeric_limits<double>::lowest ();
+  double sideSum = 0;
+  for (const auto &building : m_buildings)
+    {
+      Box box = building->GetBoundaries ();
+      xMin = std::min (xMin, box.xMin);
+      xMax = std::max (xMax, box.xMax);
+      yMin = std::min (yMin, box.yMin);
+      yMax = std::max (yMax, box.yMax);
+      sideSum += std::max (box.xMax - box.xMin, box.yMax - box.yMin);
+    }
+  double cellSize = sideSum / m_buildings.size ();
+  if (!(cellSize > 0))
+    {
+      cellSize = std::max (std::max (xMax - xMin, yMax - yMin), 1.0);
+    }
+  // limit the number of cells in case of sparse buildings
+  double maxCells = 4.0 * m_buildings.size () + 64;
+  while (((xMax - xMin) / cellSize + 1) * ((yMax - yMin) / cellSize + 1) > maxCells)
+    {
+      cellSize *= 2;
+    }
+
+  m_cellSize = cellSize;
+  m_margin = 1e-6 * cellSize;
+  m_xMin = xMin - m_margin;
+  m_yMin = yMin - m_margin;
+  m_nColumns = static_cast<uint32_t> (std::floor ((xMax + m_margin - m_xMin) / m_cellSize)) + 1;
+  m_nRows = static_cast<uint32_t> (std::floor ((yMax + m_margin - m_yMin) / m_cellSize)) + 1;
+  m_cells.resize (static_cast<std::size_t> (m_nColumns) * m_nRows);
+  NS_LOG_LOGIC ("index of " << m_buildings.size () << " buildings with " << m_nColumns << "x"
+                << m_nRows << " cells of side " << m_cellSize);
+
+  for (uint32_t index = 0; index < m_buildings.size (); index++)
+    {
+      Box box = m_buildings[index]->GetBoundaries ();
+      uint32_t columnLast = GetColumn (box.xMax + m_margin);
+      uint32_t rowLast = GetRow (box.yMax + m_margin);
+      for (uint32_t row = GetRow (box.yMin - m_margin); row <= rowLast; row++)
+        {
+          for (uint32_t column = GetColumn (box.xMin - m_margin); column <= columnLast; column++)
+            {
+              m_cells[static_cast<std::size_t> (row) * m_nColumns + column].push_back (index);
+            }
+        }
+    }
+}
+
+uint32_t
+BuildingListPriv::GetColumn (double x) const
+{
+  double column = std::floor ((x - m_xMin) / m_cellSize);
+  return static_cast<uint32_t> (std::min (std::max (column, 0.0), m_nColumns - 1.0));
+}
+
+uint32_t
+BuildingListPriv::GetRow (double y) const
+{
+  double row = std::floor ((y - m_yMin) / m_cellSize);
+  return static_cast<uint32_t> (std::min (std::max (row, 0.0), m_nRows - 1.0));
+}
+
+std::vector<Ptr<Building> >
+BuildingListPriv::GetBuildingsAt (const Vector &position)
+{
+  UpdateIndex ();
+  std::vector<Ptr<Building> > buildings;
+  if (m_buildings.empty ())
+    {
+      return buildings;
+    }
+  // a cell stores the indices of its buildings in increasing order
+  for (uint32_t index : m_cells[static_cast<std::size_t> (GetRow (position.y)) * m_nColumns + GetColumn (position.x)])
+    {
+      if (m_buildings[index]->IsInside (position))
+        {
+          buildings.push_back (m_buildings[index]);
+        }
+    }
+  return buildings;
+}
+
+std::vector<uint32_t>
+BuildingListPriv::GetCandidates (const Vector &l1, const Vector &l2)
+{
+  UpdateIndex ();
+  std::vector<uint32_t> candidates;
+  if (m_buildings.empty ())
+    {
+      return candidates;
+    }
+  if (++m_query == 0)
+    {
+      std::fill (m_visited.begin (), m_visited.end (), 0);
+      m_query = 1;
+    }
+
+  // visit the cells crossed by the segment, column by column
+  double xLow = std::min (l1.x, l2.x);
+  double xHigh = std::max (l1.x, l2.x);
+  double yLow = std::min (l1.y, l2.y);
+  double yHigh = std::max (l1.y, l2.y);
+  uint32_t columnFirst = GetColumn (xLow - m_margin);
+  uint32_t columnLast = GetColumn (xHigh + m_margin);
+  for (uint32_t column = columnFirst; column <= columnLast; column++)
+    {
+      double y1 = yLow;
+      double y2 = yHigh;
+      if (l1.x != l2.x)
+        {
+          // the part of the segment within the column
+          double x1 = (column == columnFirst) ? xLow : m_xMin + column * m_cellSize;
+          double x2 = (column == columnLast) ? xHigh : m_xMin + (column + 1) * m_cellSize;
+          double slope = (l2.y - l1.y) / (l2.x - l1.x);
+          y1 = std::max (yLow, std::min (l1.y + (x1 - l1.x) * slope, l1.y + (x2 - l1.x) * slope));
+          y2 = std::min (yHigh, std::max (l1.y + (x1 - l1.x) * slope, l1.y + (x2 - l1.x) * slope));
+          if (!(y1 <= y2))
+            {
+              // nearly vertical segment
+              y1 = yLow;
+              y2 = yHigh;
+            }
+        }
+      uint32_t rowLast = GetRow (y2 + m_margin);
+      for (uint32_t row = GetRow (y1 - m_margin); row <= rowLast; row++)
+        {
+          for (uint32_t index : m_cells[static_cast<std::size_t> (row) * m_nColumns + column])
+            {
+              if (m_visited[index] != m_query)
+                {
+                  m_visited[index] = m_query;
+                  candidates.push_back (index);
+                }
+            }
+        }
+    }
+  return candidates;
+}
+
+std::vector<Ptr<Building> >
+BuildingListPriv::GetBuildingsIntersecting (const Vector &l1, const Vector &l2)
+{
+  std::vector<uint32_t> candidates = GetCandidates (l1, l2);
+  std::sort (candidates.begin (), candidates.end ());
+  std::vector<Ptr<Building> > buildings;
+  for (uint32_t index : candidates)
+    {
+      if (m_buildings[index]->IsIntersect (l1, l2))
+        {
+          buildings.push_back (m_buildings[index]);
+        }
+    }
+  return buildings;
+}
+
+bool
+BuildingListPriv::IsAnyBuildingIntersecting (const Vector &l1, const Vector &l2)
+{
+  for (uint32_t index : GetCandidates (l1, l2))
+    {
+      if (m_buildings[index]->IsIntersect (l1, l2))
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
 }
 
 /**
@@ -232,5 +506,25 @@ BuildingList::GetNBuildings (void)
 {
   return BuildingListPriv::Get ()->GetNBuildings ();
 }
+std::vector<Ptr<Building> >
+BuildingList::GetBuildingsAt (const Vector &position)
+{
+  return BuildingListPriv::Get ()->GetBuildingsAt (position);
+}
+std::vector<Ptr<Building> >
+BuildingList::GetBuildingsIntersecting (const Vector &l1, const Vector &l2)
+{
+  return BuildingListPriv::Get ()->GetBuildingsIntersecting (l1, l2);
+}
+bool
+BuildingList::IsAnyBuildingIntersecting (const Vector &l1, const Vector &l2)
+{
+  return BuildingListPriv::Get ()->IsAnyBuildingIntersecting (l1, l2);
+}
+void
+BuildingList::NotifyBoundariesChanged (void)
+{
+  BuildingListPriv::Get ()->InvalidateIndex ();
+}
 
 } // namespace ns3
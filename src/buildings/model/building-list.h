@@ -25,6 +25,7 @@
 
 #include <vector>
 #include "ns3/ptr.h"
+#include "ns3/vector.h"
 
 namespace ns3 {
 
@@ -66,6 +67,39 @@ public:
    * \returns the number of buildings currently in the list.
    */
   static uint32_t GetNBuildings (void);
+
+  /**
+   * The buildings are indexed by a uniform 2D grid over their footprints,
+   * so that only the buildings close to the given position are checked.
+   *
+   * \param position the position
+   * \returns the buildings which contain the given position (see
+   *          Building::IsInside), ordered by building ID.
+   */
+  static std::vector<Ptr<Building> > GetBuildingsAt (const Vector &position);
+  /**
+   * Only the buildings whose footprint is close to the line segment are
+   * checked, see GetBuildingsAt.
+   *
+   * \param l1 one end of the line segment
+   * \param l2 the other end of the line segment
+   * \returns the buildings which intersect the line segment (see
+   *          Building::IsIntersect), ordered by building ID.
+   */
+  static std::vector<Ptr<Building> > GetBuildingsIntersecting (const Vector &l1, const Vector &l2);
+  /**
+   * \param l1 one end of the line segment
+   * \param l2 the other end of the line segment
+   * \returns true if at least one building intersects the line segment
+   *          (see Building::IsIntersect).
+   */
+  static bool IsAnyBuildingIntersecting (const Vector &l1, const Vector &l2);
+  /**
+   * Invalidate the index of the buildings, which is rebuilt by the next
+   * query. This method is called automatically when a building is added
+   * and from Building::SetBoundaries.
+   */
+  static void NotifyBoundariesChanged (void);
 };
 
 } // namespace ns3
@@ -51,9 +51,45 @@ BuildingsChannelConditionModel::~BuildingsChannelConditionModel ()
 {
 }
 
+void
+BuildingsChannelConditionModel::DoDispose ()
+{
+  m_channelConditions.Clear ();
+  ChannelConditionModel::DoDispose ();
+}
+
+void
+BuildingsChannelConditionModel::ClearChannelConditions (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_channelConditions.Clear ();
+}
+
 Ptr<ChannelCondition>
 BuildingsChannelConditionModel::GetChannelCondition (Ptr<const MobilityModel> a,
                                                      Ptr<const MobilityModel> b) const
+{
+  NS_LOG_FUNCTION (this);
+  // the velocities are checked first, as mobility models may lazily update
+  // their position (and notify a course change) when queried
+  if (!(a->GetVelocity () == Vector () && b->GetVelocity () == Vector ()))
+    {
+      NS_LOG_LOGIC ("Moving node, channel condition not stored");
+      return ComputeChannelCondition (a, b);
+    }
+
+  Ptr<ChannelCondition> cond = m_channelConditions.Lookup (a, b, Seconds (0), true);
+  if (cond == nullptr)
+    {
+      cond = ComputeChannelCondition (a, b);
+      m_channelConditions.Store (a, b, cond);
+    }
+  return cond;
+}
+
+Ptr<ChannelCondition>
+BuildingsChannelConditionModel::ComputeChannelCondition (Ptr<const MobilityModel> a,
+                                                         Ptr<const MobilityModel> b) const
 {
   NS_LOG_FUNCTION (this);
   Ptr<MobilityBuildingInfo> a1 = a->GetObject<MobilityBuildingInfo> ();
@@ -117,19 +153,9 @@ BuildingsChannelConditionModel::GetChannelCondition (Ptr<const MobilityModel> a,
 bool
 BuildingsChannelConditionModel::IsLineOfSightBlocked (const ns3::Vector &l1, const ns3::Vector &l2) const
 {
-  for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
-    {
-      if ((*bit)->IsIntersect (l1, l2))
-        {
-          // The line of sight should be blocked if the line-segment between
-          // l1 and l2 intersects one of the buildings.
-          return true;
-        }
-    }
-
-  // The line of sight should not be blocked if the line-segment between
-  // l1 and l2 did not intersect any building.
-  return false;
+  // The line of sight should be blocked if the line-segment between
+  // l1 and l2 intersects one of the buildings.
+  return BuildingList::IsAnyBuildingIntersecting (l1, l2);
 }
 
 int64_t
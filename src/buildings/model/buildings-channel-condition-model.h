@@ -34,6 +34,12 @@ class MobilityModel;
  * \brief Determines the channel condition based on the buildings deployed in the
  * scenario
  *
+ * The channel conditions of pairs of static nodes (i.e., nodes whose velocity
+ * is null) are stored and reused until the course of one of the two nodes
+ * changes. The stored conditions must be removed by calling
+ * ClearChannelConditions if the buildings are modified after the channel
+ * conditions have been computed.
+ *
  * Code adapted from MmWave3gppBuildingsPropagationLossModel
  */
 class BuildingsChannelConditionModel : public ChannelConditionModel
@@ -77,7 +83,24 @@ public:
    */
   virtual int64_t AssignStreams (int64_t stream) override;
 
+  /**
+   * Remove all the stored channel conditions
+   */
+  void ClearChannelConditions (void);
+
+protected:
+  virtual void DoDispose () override;
+
 private:
+  /**
+   * Computes the condition of the channel between a and b.
+   *
+   * \param a mobility model
+   * \param b mobility model
+   * \return the condition of the channel between a and b
+   */
+  Ptr<ChannelCondition> ComputeChannelCondition (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b) const;
+
   /**
    * \brief Checks if the line of sight between position l1 and position l2 is
    *        blocked by a building.
@@ -87,6 +110,8 @@ private:
    * \return true if the line of sight is blocked, false otherwise
    */
   bool IsLineOfSightBlocked (const Vector &l1, const Vector &l2) const;
+
+  mutable ChannelConditionStore m_channelConditions; //!< the channel conditions of the pairs of static nodes
 };
 
 } // end ns3 namespace
@@ -0,0 +1,194 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/building.h"
+#include "ns3/building-list.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("BuildingListTest");
+
+/**
+ * \ingroup building-test
+ * \ingroup tests
+ *
+ * Test case for the spatial index of the BuildingList. It checks that the
+ * buildings returned by the indexed queries are the same, in the same
+ * order, as those found by checking every building, for random and
+ * boundary positions and segments, also after the boundaries of some
+ * buildings are changed.
+ */
+class BuildingListIndexTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  BuildingListIndexTestCase ();
+
+  /**
+   * Destructor
+   */
+  virtual ~BuildingListIndexTestCase ();
+
+private:
+  /**
+   * Builds the simulation scenario and perform the tests
+   */
+  virtual void DoRun (void);
+
+  /**
+   * Check the buildings containing a position
+   * \param position the position
+   */
+  void CheckPosition (const Vector &position);
+
+  /**
+   * Check the buildings intersecting a line segment
+   * \param l1 one end of the line segment
+   * \param l2 the other end of the line segment
+   */
+  void CheckSegment (const Vector &l1, const Vector &l2);
+};
+
+BuildingListIndexTestCase::BuildingListIndexTestCase ()
+  : TestCase ("Check the results of the spatial index of the BuildingList")
+{
+}
+
+BuildingListIndexTestCase::~BuildingListIndexTestCase ()
+{
+}
+
+void
+BuildingListIndexTestCase::CheckPosition (const Vector &position)
+{
+  std::vector<Ptr<Building> > expected;
+  for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
+    {
+      if ((*bit)->IsInside (position))
+        {
+          expected.push_back (*bit);
+        }
+    }
+  std::vector<Ptr<Building> > buildings = BuildingList::GetBuildingsAt (position);
+  NS_TEST_ASSERT_MSG_EQ ((buildings == expected), true, "Unexpected buildings at " << position);
+}
+
+void
+BuildingListIndexTestCase::CheckSegment (const Vector &l1, const Vector &l2)
+{
+  std::vector<Ptr<Building> > expected;
+  for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
+    {
+      if ((*bit)->IsIntersect (l1, l2))
+        {
+          expected.push_back (*bit);
+        }
+    }
+  std::vector<Ptr<Building> > buildings = BuildingList::GetBuildingsIntersecting (l1, l2);
+  NS_TEST_ASSERT_MSG_EQ ((buildings == expected), true, "Unexpected buildings intersecting " << l1 << " - " << l2);
+  NS_TEST_ASSERT_MSG_EQ (BuildingList::IsAnyBuildingIntersecting (l1, l2), !expected.empty (),
+                         "Unexpected intersection between " << l1 << " - " << l2 << " and the buildings");
+}
+
+void
+BuildingListIndexTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+
+  // a grid of buildings separated by streets, plus some random buildings,
+  // possibly overlapping the others, with very different sizes
+  std::vector<Ptr<Building> > buildings;
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      for (uint32_t j = 0; j < 10; j++)
+        {
+          Ptr<Building> b = CreateObject<Building> ();
+          b->SetBoundaries (Box (i * 70.0, i * 70.0 + 50.0, j * 70.0, j * 70.0 + 50.0, 0.0, 10.0 + i + j));
+          buildings.push_back (b);
+        }
+    }
+  for (uint32_t n = 0; n < 50; n++)
+    {
+      double x = random->GetValue (-100, 800);
+      double y = random->GetValue (-100, 800);
+      double size = (n % 10 == 0) ? random->GetValue (100, 300) : random->GetValue (1, 30);
+      Ptr<Building> b = CreateObject<Building> ();
+      b->SetBoundaries (Box (x, x + size, y, y + size / 2, 0.0, random->GetValue (1, 30)));
+      buildings.push_back (b);
+    }
+
+  for (uint32_t round = 0; round < 2; round++)
+    {
+      // positions on the corners and on the sides of the buildings
+      for (const auto &b : buildings)
+        {
+          Box box = b->GetBoundaries ();
+          CheckPosition (Vector (box.xMin, box.yMin, box.zMin));
+          CheckPosition (Vector (box.xMax, box.yMax, box.zMax));
+          CheckPosition (Vector (box.xMax, (box.yMin + box.yMax) / 2, 1.5));
+          CheckSegment (Vector (box.xMin, box.yMin - 10, 1.5), Vector (box.xMin, box.yMax + 10, 1.5));
+          CheckSegment (Vector (box.xMax + 10, box.yMax, 1.5), Vector (box.xMax + 50, box.yMax, 1.5));
+          CheckSegment (Vector (box.xMin - 5, box.yMin, 1.5), Vector (box.xMin, box.yMin - 5, 1.5));
+        }
+      // random positions and segments, also outside the area with buildings
+      for (uint32_t n = 0; n < 2000; n++)
+        {
+          Vector l1 (random->GetValue (-300, 1000), random->GetValue (-300, 1000), random->GetValue (0, 40));
+          Vector l2 (random->GetValue (-300, 1000), random->GetValue (-300, 1000), random->GetValue (0, 40));
+          CheckPosition (l1);
+          CheckSegment (l1, l2);
+          CheckSegment (l1, Vector (l1.x + random->GetValue (-20, 20), l1.y + random->GetValue (-20, 20), l1.z));
+          CheckSegment (l1, Vector (l1.x, l2.y, l2.z));
+          CheckSegment (l1, l1);
+        }
+
+      // the index must be updated when the boundaries of a building change
+      for (uint32_t n = 0; n < buildings.size (); n += 7)
+        {
+          Box box = buildings[n]->GetBoundaries ();
+          buildings[n]->SetBoundaries (Box (box.xMin + 500, box.xMax + 520, box.yMin - 200, box.yMax - 190, box.zMin, box.zMax));
+        }
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup building-test
+ * \ingroup tests
+ * Test suite for the BuildingList
+ */
+class BuildingListTestSuite : public TestSuite
+{
+public:
+  BuildingListTestSuite ();
+};
+
+BuildingListTestSuite::BuildingListTestSuite ()
+  : TestSuite ("building-list", UNIT)
+{
+  AddTestCase (new BuildingListIndexTestCase, TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static BuildingListTestSuite g_buildingListTestSuite;
@@ -142,6 +142,84 @@ BuildingsChannelConditionModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup building-test
+ * \ingroup tests
+ *
+ * Test case for the channel conditions stored by the
+ * BuildingsChannelConditionModel. It checks that the conditions precomputed
+ * for all the pairs of nodes are correct and that a stored condition is
+ * updated when a node is moved.
+ */
+class BuildingsChannelConditionStoreTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  BuildingsChannelConditionStoreTestCase ();
+
+  /**
+   * Destructor
+   */
+  virtual ~BuildingsChannelConditionStoreTestCase ();
+
+private:
+  /**
+   * Builds the simulation scenario and perform the tests
+   */
+  virtual void DoRun (void);
+};
+
+BuildingsChannelConditionStoreTestCase::BuildingsChannelConditionStoreTestCase ()
+  : TestCase ("Test case for the channel conditions stored by the BuildingsChannelConditionModel")
+{
+}
+
+BuildingsChannelConditionStoreTestCase::~BuildingsChannelConditionStoreTestCase ()
+{
+}
+
+void
+BuildingsChannelConditionStoreTestCase::DoRun (void)
+{
+  Ptr<Building> building = Create<Building> ();
+  building->SetBoundaries (Box (0.0, 10.0, 0.0, 10.0, 0.0, 5.0));
+
+  NodeContainer nodes;
+  nodes.Create (3);
+  std::vector<Vector> positions = {Vector (-5.0, 5.0, 1.5), Vector (20.0, 5.0, 1.5), Vector (5.0, 20.0, 1.5)};
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (positions[i]);
+      nodes.Get (i)->AggregateObject (mobility);
+    }
+  BuildingsHelper::Install (nodes);
+  Ptr<MobilityModel> a = nodes.Get (0)->GetObject<MobilityModel> ();
+  Ptr<MobilityModel> b = nodes.Get (1)->GetObject<MobilityModel> ();
+  Ptr<MobilityModel> c = nodes.Get (2)->GetObject<MobilityModel> ();
+
+  Ptr<BuildingsChannelConditionModel> condModel = CreateObject<BuildingsChannelConditionModel> ();
+  condModel->PrecomputeChannelConditions (nodes);
+
+  Ptr<ChannelCondition> cond = condModel->GetChannelCondition (a, b);
+  NS_TEST_ASSERT_MSG_EQ (cond->GetLosCondition (), ChannelCondition::NLOS, "Got unexpected channel condition");
+  NS_TEST_ASSERT_MSG_EQ (condModel->GetChannelCondition (b, a), cond, "The channel condition should be reused");
+  NS_TEST_ASSERT_MSG_EQ (condModel->GetChannelCondition (a, c)->GetLosCondition (), ChannelCondition::LOS,
+                         "Got unexpected channel condition");
+  NS_TEST_ASSERT_MSG_EQ (condModel->GetChannelCondition (c, b)->GetLosCondition (), ChannelCondition::LOS,
+                         "Got unexpected channel condition");
+
+  // the building no longer blocks the line of sight once b is moved
+  b->SetPosition (Vector (-5.0, 20.0, 1.5));
+  cond = condModel->GetChannelCondition (a, b);
+  NS_TEST_ASSERT_MSG_EQ (cond->GetLosCondition (), ChannelCondition::LOS, "The channel condition should be updated");
+  NS_TEST_ASSERT_MSG_EQ (condModel->GetChannelCondition (a, b), cond, "The channel condition should be reused");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup building-test
  * \ingroup tests
@@ -157,6 +235,7 @@ BuildingsChannelConditionModelsTestSuite::BuildingsChannelConditionModelsTestSui
   : TestSuite ("buildings-channel-condition-model", UNIT)
 {
   AddTestCase (new BuildingsChannelConditionModelTestCase, TestCase::QUICK);
+  AddTestCase (new BuildingsChannelConditionStoreTestCase, TestCase::QUICK);
 }
 
 /// Static variable for test initialization
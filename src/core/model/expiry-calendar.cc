@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "expiry-calendar.h"
+#include "assert.h"
+#include "log.h"
+#include "simulator.h"
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::ExpiryCalendar implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ExpiryCalendar");
+
+ExpiryCalendar::Id::Id ()
+  : m_uid (0)
+{}
+
+uint64_t
+ExpiryCalendar::Id::GetUid (void) const
+{
+  return m_uid;
+}
+
+ExpiryCalendar::ExpiryCalendar ()
+  : m_lastUid (0),
+    m_scheduled (false),
+    m_expiring (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ExpiryCalendar::~ExpiryCalendar ()
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+}
+
+ExpiryCalendar::Id
+ExpiryCalendar::Schedule (const Time &delay, const Ptr<EventImpl> &event)
+{
+  NS_LOG_FUNCTION (this << delay << event);
+  NS_ASSERT_MSG (!delay.IsStrictlyNegative (), "The expiration must not be in the past");
+  Id id;
+  id.m_expiry = Simulator::Now () + delay;
+  id.m_uid = ++m_lastUid;
+  m_calendar.insert (m_calendar.end (), std::make_pair (Key (id.m_expiry, id.m_uid), event));
+  if (!m_expiring && (!m_scheduled || id.m_expiry < m_next))
+    {
+      ScheduleNext ();
+    }
+  return id;
+}
+
+bool
+ExpiryCalendar::Cancel (const Id &id)
+{
+  NS_LOG_FUNCTION (this << id.m_uid);
+  // The simulator event is left pending: it reschedules itself if it finds
+  // no due expiration
+  return m_calendar.erase (Key (id.m_expiry, id.m_uid)) > 0;
+}
+
+bool
+ExpiryCalendar::IsRunning (const Id &id) const
+{
+  return m_calendar.find (Key (id.m_expiry, id.m_uid)) != m_calendar.end ();
+}
+
+void
+ExpiryCalendar::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_calendar.clear ();
+  m_event.Cancel ();
+  m_scheduled = false;
+}
+
+uint32_t
+ExpiryCalendar::GetSize (void) const
+{
+  return m_calendar.size ();
+}
+
+void
+ExpiryCalendar::Expire (void)
+{
+  NS_LOG_FUNCTION (this);
+  Time now = Simulator::Now ();
+  m_scheduled = false;
+  m_expiring = true;
+  // An expiration may schedule or cancel the others, so the first one is
+  // looked up again after each of them
+  while (!m_calendar.empty () && m_calendar.begin ()->first.first <= now)
+    {
+      std::map<Key, Ptr<EventImpl> >::iterator first = m_calendar.begin ();
+      Ptr<EventImpl> event = first->second;
+      m_calendar.erase (first);
+      event->Invoke ();
+    }
+  m_expiring = false;
+  ScheduleNext ();
+}
+
+void
+ExpiryCalendar::ScheduleNext (void)
+{
+  if (m_calendar.empty ())
+    {
+      return;
+    }
+  Time next = m_calendar.begin ()->first.first;
+  if (m_scheduled && m_event.IsRunning ())
+    {
+      if (m_next <= next)
+        {
+          return;
+        }
+      m_event.Cancel ();
+    }
+  NS_LOG_LOGIC ("Next expiration at " << next);
+  m_next = next;
+  m_scheduled = true;
+  m_event = Simulator::Schedule (next - Simulator::Now (), &ExpiryCalendar::Expire, this);
+}
+
+} // namespace ns3
@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef EXPIRY_CALENDAR_H
+#define EXPIRY_CALENDAR_H
+
+#include <map>
+#include <utility>
+#include "nstime.h"
+#include "event-id.h"
+#include "event-impl.h"
+#include "make-event.h"
+#include "ptr.h"
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::ExpiryCalendar declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup timer
+ * \brief A calendar of expirations with a single pending simulator event.
+ *
+ * The routing protocols keep soft state, such as the tuples of OLSR or the
+ * neighbors of AODV, which expires unless it is refreshed.  Scheduling a
+ * simulator event for every expiration fills the scheduler with a large
+ * number of events, most of which find the state refreshed or are cancelled
+ * when the state is refreshed.
+ *
+ * The expirations scheduled on a calendar are instead stored in the
+ * calendar, ordered by time, and the calendar schedules a single simulator
+ * event, at the earliest expiration.  Scheduling and cancelling an
+ * expiration do not schedule or cancel simulator events, unless the new
+ * expiration is earlier than all the others: a simulator event which finds
+ * no due expiration is simply rescheduled at the next one.  The
+ * expirations are invoked at their exact time, in the order in which they
+ * were scheduled when they expire at the same time, but the order of an
+ * expiration and of the other events which expire at the same time may
+ * differ from Simulator::Schedule.
+ *
+ * The destructor cancels all the expirations.
+ */
+class ExpiryCalendar
+{
+public:
+  /**
+   * \brief The identifier of an expiration.
+   *
+   * A default-constructed identifier identifies no expiration.
+   */
+  class Id
+  {
+  public:
+    Id ();
+    /**
+     * \returns The unique identifier of the expiration, or 0 for a
+     * default-constructed identifier.
+     */
+    uint64_t GetUid (void) const;
+
+  private:
+    friend class ExpiryCalendar;
+    Time m_expiry;   //!< The expiration time
+    uint64_t m_uid;  //!< The unique identifier, or 0
+  };
+
+  ExpiryCalendar ();
+  ~ExpiryCalendar ();
+
+  /**
+   * \brief Schedule an expiration which invokes a member method.
+   *
+   * \tparam MEM \deduced Class method function signature type.
+   * \tparam OBJ \deduced Class type of the object.
+   * \tparam Ts \deduced Argument types.
+   * \param [in] delay The relative expiration time.
+   * \param [in] mem_ptr Member method pointer to invoke.
+   * \param [in] obj The object on which to invoke the member method.
+   * \param [in] args Arguments to pass to the invoked method.
+   * \returns The identifier of the expiration.
+   */
+  template <typename MEM, typename OBJ, typename... Ts>
+  Id Schedule (const Time &delay, MEM mem_ptr, OBJ obj, Ts... args);
+  /**
+   * \brief Schedule an expiration which invokes an event.
+   *
+   * \param [in] delay The relative expiration time.
+   * \param [in] event The event to invoke.
+   * \returns The identifier of the expiration.
+   */
+  Id Schedule (const Time &delay, const Ptr<EventImpl> &event);
+
+  /**
+   * \brief Cancel an expiration.
+   * \param [in] id The identifier of the expiration.
+   * \returns true if the expiration was pending.
+   */
+  bool Cancel (const Id &id);
+  /**
+   * \param [in] id The identifier of an expiration.
+   * \returns true if the expiration is pending.
+   */
+  bool IsRunning (const Id &id) const;
+  /**
+   * \brief Cancel all the expirations.
+   */
+  void Clear (void);
+  /**
+   * \returns The number of pending expirations.
+   */
+  uint32_t GetSize (void) const;
+
+private:
+  /**
+   * \brief Invoke the due expirations, and schedule the simulator event of
+   * the next one.
+   */
+  void Expire (void);
+  /**
+   * \brief Schedule the simulator event at the earliest expiration, unless
+   * an event is already scheduled before it.
+   */
+  void ScheduleNext (void);
+
+  /** Copy constructor, deleted. */
+  ExpiryCalendar (const ExpiryCalendar &) = delete;
+  /**
+   * Assignment operator, deleted.
+   * \returns The calendar.
+   */
+  ExpiryCalendar & operator = (const ExpiryCalendar &) = delete;
+
+  /// The key of an expiration: its time and unique identifier
+  typedef std::pair<Time, uint64_t> Key;
+
+  std::map<Key, Ptr<EventImpl> > m_calendar;  //!< The pending expirations
+  uint64_t m_lastUid;                         //!< The last unique identifier
+  EventId m_event;                            //!< The simulator event
+  Time m_next;                                //!< The time of the simulator event
+  bool m_scheduled;                           //!< Whether the simulator event is pending
+  bool m_expiring;                            //!< Whether Expire is running
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+template <typename MEM, typename OBJ, typename... Ts>
+ExpiryCalendar::Id
+ExpiryCalendar::Schedule (const Time &delay, MEM mem_ptr, OBJ obj, Ts... args)
+{
+  return Schedule (delay, Ptr<EventImpl> (MakeEvent (mem_ptr, obj, args...), false));
+}
+
+} // namespace ns3
+
+#endif /* EXPIRY_CALENDAR_H */
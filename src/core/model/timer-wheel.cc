@@ -0,0 +1,388 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "timer-wheel.h"
+#include "abort.h"
+#include "assert.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel and ns3::WheelTimer implementations.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TimerWheel");
+
+NS_OBJECT_ENSURE_REGISTERED (TimerWheel);
+
+namespace {
+
+/**
+ * \ingroup timer
+ * \param [in] bits A non-zero bitmap.
+ * \returns The index of the lowest bit set.
+ */
+uint32_t
+LowestBit (uint64_t bits)
+{
+  // De Bruijn multiplication of the isolated lowest bit
+  static const uint32_t index[64] = {
+    0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+    62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+    63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+    46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+  };
+  NS_ASSERT (bits != 0);
+  return index[((bits & (~bits + 1)) * 0x03f79d71b4cb0a89ULL) >> 58];
+}
+
+} // unnamed namespace
+
+TypeId
+TimerWheel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TimerWheel")
+    .SetParent<Object> ()
+    .SetGroupName ("Core")
+    .AddConstructor<TimerWheel> ()
+    .AddAttribute ("Resolution",
+                   "The duration of a tick of the wheel.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&TimerWheel::SetResolution,
+                                     &TimerWheel::GetResolution),
+                   MakeTimeChecker (TimeStep (1)))
+  ;
+  return tid;
+}
+
+TimerWheel::TimerWheel ()
+  : m_resolution (MilliSeconds (1)),
+    m_context (Simulator::NO_CONTEXT),
+    m_nTimers (0),
+    m_current (0)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t level = 0; level < LEVELS; level++)
+    {
+      m_used[level] = 0;
+      for (uint32_t slot = 0; slot < SLOTS; slot++)
+        {
+          m_slots[level][slot] = 0;
+        }
+    }
+}
+
+TimerWheel::~TimerWheel ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_nTimers == 0);
+}
+
+void
+TimerWheel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t level = 0; level < LEVELS; level++)
+    {
+      while (m_used[level] != 0)
+        {
+          uint32_t slot = LowestBit (m_used[level]);
+          while (m_slots[level][slot] != 0)
+            {
+              m_slots[level][slot]->Cancel ();
+            }
+        }
+    }
+  m_ticks.clear ();
+  Object::DoDispose ();
+}
+
+void
+TimerWheel::SetResolution (Time resolution)
+{
+  NS_LOG_FUNCTION (this << resolution);
+  NS_ABORT_MSG_IF (!resolution.IsStrictlyPositive (), "The resolution of a timer wheel must be positive");
+  NS_ABORT_MSG_IF (m_nTimers != 0, "The resolution of a timer wheel cannot change while timers are armed");
+  m_current = m_current * m_resolution.GetTimeStep () / resolution.GetTimeStep ();
+  m_resolution = resolution;
+}
+
+Time
+TimerWheel::GetResolution (void) const
+{
+  return m_resolution;
+}
+
+void
+TimerWheel::SetContext (uint32_t context)
+{
+  NS_LOG_FUNCTION (this << context);
+  m_context = context;
+}
+
+uint32_t
+TimerWheel::GetNTimers (void) const
+{
+  return m_nTimers;
+}
+
+uint64_t
+TimerWheel::GetTick (Time time) const
+{
+  return time.GetTimeStep () / m_resolution.GetTimeStep ();
+}
+
+void
+TimerWheel::Insert (WheelTimer *timer)
+{
+  NS_LOG_FUNCTION (this << timer);
+  // No slot before the current tick is left to process
+  m_current = std::max (m_current, GetTick (Simulator::Now ()));
+  Link (timer);
+  if (timer->m_impl != 0)
+    {
+      uint32_t shift = timer->m_level * SLOT_BITS;
+      ScheduleTick ((GetTick (timer->m_expiry) >> shift) << shift);
+    }
+}
+
+void
+TimerWheel::Remove (WheelTimer *timer)
+{
+  NS_LOG_FUNCTION (this << timer);
+  if (timer->m_prev != 0)
+    {
+      timer->m_prev->m_next = timer->m_next;
+    }
+  else
+    {
+      m_slots[timer->m_level][timer->m_slot] = timer->m_next;
+      if (timer->m_next == 0)
+        {
+          m_used[timer->m_level] &= ~(uint64_t (1) << timer->m_slot);
+        }
+    }
+  if (timer->m_next != 0)
+    {
+      timer->m_next->m_prev = timer->m_prev;
+    }
+  timer->m_prev = 0;
+  timer->m_next = 0;
+  m_nTimers--;
+}
+
+void
+TimerWheel::Link (WheelTimer *timer)
+{
+  uint64_t tick = GetTick (timer->m_expiry);
+  if (tick <= m_current)
+    {
+      Expire (timer);
+      return;
+    }
+  // The level is the highest digit of the tick which differs from the
+  // current tick, and the slot is this digit
+  uint64_t diff = tick ^ m_current;
+  uint32_t level = 0;
+  while (level + 1 < LEVELS && (diff >> ((level + 1) * SLOT_BITS)) != 0)
+    {
+      level++;
+    }
+  uint32_t slot = (tick >> (level * SLOT_BITS)) & (SLOTS - 1);
+  timer->m_level = level;
+  timer->m_slot = slot;
+  timer->m_prev = 0;
+  timer->m_next = m_slots[level][slot];
+  if (timer->m_next != 0)
+    {
+      timer->m_next->m_prev = timer;
+    }
+  m_slots[level][slot] = timer;
+  m_used[level] |= uint64_t (1) << slot;
+  m_nTimers++;
+}
+
+void
+TimerWheel::Expire (WheelTimer *timer)
+{
+  NS_LOG_FUNCTION (this << timer);
+  // The reference to the event owned by the timer is transferred to the
+  // simulator, which releases it after invoking or discarding the event
+  timer->m_event = Simulator::Schedule (timer->m_expiry - Simulator::Now (),
+                                        Ptr<EventImpl> (timer->m_impl));
+  timer->m_impl = 0;
+}
+
+void
+TimerWheel::Tick (uint64_t tick)
+{
+  NS_LOG_FUNCTION (this << tick);
+  m_ticks.erase (tick);
+  m_current = std::max (m_current, tick);
+  // Move the timers of the slots which start at this tick to the lower
+  // levels, down to the timers which expire during this tick
+  for (uint32_t level = LEVELS; level-- > 0; )
+    {
+      uint32_t slot = (m_current >> (level * SLOT_BITS)) & (SLOTS - 1);
+      if ((m_used[level] & (uint64_t (1) << slot)) == 0)
+        {
+          continue;
+        }
+      WheelTimer *timer = m_slots[level][slot];
+      m_slots[level][slot] = 0;
+      m_used[level] &= ~(uint64_t (1) << slot);
+      while (timer != 0)
+        {
+          WheelTimer *next = timer->m_next;
+          timer->m_prev = 0;
+          timer->m_next = 0;
+          m_nTimers--;
+          Link (timer);
+          timer = next;
+        }
+    }
+  ScheduleNextTick ();
+}
+
+void
+TimerWheel::ScheduleNextTick (void)
+{
+  // The slots of a level start after those of the lower levels
+  for (uint32_t level = 0; level < LEVELS; level++)
+    {
+      uint32_t shift = level * SLOT_BITS;
+      uint32_t digit = (m_current >> shift) & (SLOTS - 1);
+      uint64_t later = (digit + 1 < SLOTS) ? m_used[level] & (~uint64_t (0) << (digit + 1)) : 0;
+      if (later != 0)
+        {
+          uint64_t high = (shift + SLOT_BITS < 64) ? (m_current >> (shift + SLOT_BITS)) << (shift + SLOT_BITS) : 0;
+          ScheduleTick (high | (uint64_t (LowestBit (later)) << shift));
+          return;
+        }
+    }
+}
+
+void
+TimerWheel::ScheduleTick (uint64_t tick)
+{
+  if (m_ticks.empty () || tick < *m_ticks.begin ())
+    {
+      NS_LOG_LOGIC ("Schedule tick " << tick);
+      m_ticks.insert (tick);
+      Time delay = TimeStep (tick * m_resolution.GetTimeStep ()) - Simulator::Now ();
+      uint32_t context = (m_context != Simulator::NO_CONTEXT) ? m_context : Simulator::GetContext ();
+      Simulator::ScheduleWithContext (context, delay, &TimerWheel::Tick, Ptr<TimerWheel> (this), tick);
+    }
+}
+
+uint64_t WheelTimer::g_cancelledEvents = 0;
+int64_t WheelTimer::g_cancelledResidency = 0;
+
+WheelTimer::WheelTimer ()
+  : m_wheel (0),
+    m_event (),
+    m_impl (0),
+    m_expiry (),
+    m_prev (0),
+    m_next (0),
+    m_level (0),
+    m_slot (0)
+{
+}
+
+WheelTimer::~WheelTimer ()
+{
+  Cancel ();
+}
+
+void
+WheelTimer::SetWheel (Ptr<TimerWheel> wheel)
+{
+  NS_LOG_FUNCTION (this << wheel);
+  NS_ASSERT_MSG (!IsRunning (), "The wheel of a running timer cannot change");
+  m_wheel = wheel;
+}
+
+Ptr<TimerWheel>
+WheelTimer::GetWheel (void) const
+{
+  return m_wheel;
+}
+
+void
+WheelTimer::DoSchedule (const Time &delay, EventImpl *event)
+{
+  NS_ASSERT_MSG (delay.IsPositive (), "WheelTimer::Schedule(): Negative delay");
+  m_impl = event;
+  m_expiry = Simulator::Now () + delay;
+  m_wheel->Insert (this);
+}
+
+void
+WheelTimer::Cancel (void)
+{
+  if (m_impl != 0)
+    {
+      m_wheel->Remove (this);
+      m_impl->Unref ();
+      m_impl = 0;
+    }
+  if (m_event.IsRunning ())
+    {
+      g_cancelledEvents++;
+      g_cancelledResidency += Simulator::GetDelayLeft (m_event).GetTimeStep ();
+      m_event.Cancel ();
+    }
+}
+
+bool
+WheelTimer::IsExpired (void) const
+{
+  return !IsRunning ();
+}
+
+bool
+WheelTimer::IsRunning (void) const
+{
+  return m_impl != 0 || m_event.IsRunning ();
+}
+
+Time
+WheelTimer::GetDelayLeft (void) const
+{
+  if (m_impl != 0)
+    {
+      return m_expiry - Simulator::Now ();
+    }
+  return Simulator::GetDelayLeft (m_event);
+}
+
+uint64_t
+WheelTimer::GetCancelledEvents (void)
+{
+  return g_cancelledEvents;
+}
+
+Time
+WheelTimer::GetCancelledEventResidency (void)
+{
+  return TimeStep (g_cancelledResidency);
+}
+
+} // namespace ns3
@@ -0,0 +1,299 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <set>
+#include "object.h"
+#include "nstime.h"
+#include "event-id.h"
+#include "event-impl.h"
+#include "make-event.h"
+#include "simulator.h"
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel and ns3::WheelTimer declarations.
+ */
+
+namespace ns3 {
+
+class WheelTimer;
+
+/**
+ * \ingroup timer
+ * \brief A hierarchical timing wheel shared by many WheelTimer.
+ *
+ * Protocols which arm a timer for every packet, such as the retransmission
+ * timer of TCP, cancel almost all of them before they expire.  A cancelled
+ * event stays in the scheduler of the simulator until its expiration time,
+ * so that the scheduler holds and skips a large number of cancelled events.
+ *
+ * The timers attached to a wheel are instead stored in the slots of a
+ * hierarchical timing wheel, with a resolution of one tick: arming,
+ * re-arming and cancelling a timer only link or unlink it from a slot, in
+ * constant time.  The wheel schedules a single simulator event, at the next
+ * tick at which a slot must be processed.  The timers of the slots of the
+ * higher levels are moved to the lower levels as the time advances, and the
+ * timers which expire during the current tick are then scheduled as
+ * simulator events at their exact expiration time.  The timers therefore
+ * expire at the same time as with Simulator::Schedule, but the order of the
+ * events which expire at the same time may differ.
+ *
+ * The wheel has levels of 64 slots; the slots of level \f$l\f$ span
+ * \f$64^l\f$ ticks.
+ */
+class TimerWheel : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TimerWheel ();
+  virtual ~TimerWheel ();
+
+  /**
+   * \brief Set the resolution of the wheel.
+   *
+   * The resolution cannot be changed while timers are armed.
+   *
+   * \param [in] resolution The duration of a tick.
+   */
+  void SetResolution (Time resolution);
+  /**
+   * \returns The duration of a tick.
+   */
+  Time GetResolution (void) const;
+
+  /**
+   * \brief Set the context of the events scheduled by the wheel.
+   *
+   * By default, the events are scheduled in the context of the timer
+   * which needs them.
+   *
+   * \param [in] context The context, usually the id of a node.
+   */
+  void SetContext (uint32_t context);
+
+  /**
+   * \returns The number of timers linked to the slots of the wheel.
+   */
+  uint32_t GetNTimers (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  friend class WheelTimer;
+
+  /// The number of bits of the index of a slot
+  static const uint32_t SLOT_BITS = 6;
+  /// The number of slots of a level
+  static const uint32_t SLOTS = 1 << SLOT_BITS;
+  /// The number of levels needed for 64 bit ticks
+  static const uint32_t LEVELS = (64 + SLOT_BITS - 1) / SLOT_BITS;
+
+  /**
+   * \brief Arm a timer whose expiration time and event are set.
+   * \param [in] timer The timer.
+   */
+  void Insert (WheelTimer *timer);
+  /**
+   * \brief Unlink a timer from its slot.
+   * \param [in] timer The timer.
+   */
+  void Remove (WheelTimer *timer);
+  /**
+   * \brief Link a timer to the slot of its expiration tick, or schedule its
+   * event if it expires during the current tick.
+   * \param [in] timer The timer.
+   */
+  void Link (WheelTimer *timer);
+  /**
+   * \brief Schedule the event of a timer at its expiration time.
+   * \param [in] timer The timer.
+   */
+  void Expire (WheelTimer *timer);
+  /**
+   * \brief Process the slots which start at a tick.
+   * \param [in] tick The tick.
+   */
+  void Tick (uint64_t tick);
+  /**
+   * \brief Schedule the event of the next tick at which a slot must be
+   * processed, unless an event is already scheduled before it.
+   */
+  void ScheduleNextTick (void);
+  /**
+   * \brief Schedule the event of a tick, unless an event is already
+   * scheduled before it.
+   * \param [in] tick The tick.
+   */
+  void ScheduleTick (uint64_t tick);
+  /**
+   * \param [in] time A time.
+   * \returns The tick of the time.
+   */
+  uint64_t GetTick (Time time) const;
+
+  Time m_resolution;            //!< The duration of a tick
+  uint32_t m_context;           //!< The context of the events
+  uint32_t m_nTimers;           //!< The number of linked timers
+  uint64_t m_current;           //!< The current tick
+  std::set<uint64_t> m_ticks;   //!< The ticks of the scheduled events
+  uint64_t m_used[LEVELS];      //!< The bitmap of the non-empty slots of each level
+  WheelTimer *m_slots[LEVELS][SLOTS]; //!< The lists of timers of the slots
+};
+
+/**
+ * \ingroup timer
+ * \brief A timer which can be attached to a TimerWheel.
+ *
+ * A WheelTimer is used like the EventId of an event scheduled with
+ * Simulator::Schedule: scheduling it cancels the previous expiration, and
+ * it can be cancelled and queried for the time left.  Without a wheel, it
+ * simply holds a simulator event; with a wheel, it holds a simulator event
+ * only during the last tick before its expiration.
+ *
+ * The destructor cancels the timer.
+ */
+class WheelTimer
+{
+public:
+  WheelTimer ();
+  ~WheelTimer ();
+
+  /**
+   * \brief Attach the timer to a wheel.
+   *
+   * The timer must not be running.
+   *
+   * \param [in] wheel The wheel, or 0 to use plain simulator events.
+   */
+  void SetWheel (Ptr<TimerWheel> wheel);
+  /**
+   * \returns The wheel of the timer, or 0.
+   */
+  Ptr<TimerWheel> GetWheel (void) const;
+
+  /**
+   * \brief Cancel the timer and schedule it to invoke a member method.
+   *
+   * \tparam MEM \deduced Class method function signature type.
+   * \tparam OBJ \deduced Class type of the object.
+   * \tparam Ts \deduced Argument types.
+   * \param [in] delay The relative expiration time.
+   * \param [in] mem_ptr Member method pointer to invoke.
+   * \param [in] obj The object on which to invoke the member method.
+   * \param [in] args Arguments to pass to the invoked method.
+   */
+  template <typename MEM, typename OBJ, typename... Ts>
+  void Schedule (const Time &delay, MEM mem_ptr, OBJ obj, Ts... args);
+
+  /**
+   * \brief Cancel the timer.
+   */
+  void Cancel (void);
+  /**
+   * \returns true if the timer has expired, has been cancelled or was
+   * never scheduled.
+   */
+  bool IsExpired (void) const;
+  /**
+   * \returns true if the timer is scheduled to expire.
+   */
+  bool IsRunning (void) const;
+  /**
+   * \returns The time left until the expiration, or zero if the timer is
+   * not running.
+   */
+  Time GetDelayLeft (void) const;
+
+  /**
+   * \returns The number of simulator events of the WheelTimer which have
+   * been cancelled before their expiration.
+   */
+  static uint64_t GetCancelledEvents (void);
+  /**
+   * \returns The sum of the time left until the expiration of the
+   * simulator events of the WheelTimer which have been cancelled, during
+   * which they stayed in the scheduler.
+   */
+  static Time GetCancelledEventResidency (void);
+
+private:
+  friend class TimerWheel;
+
+  /**
+   * \brief Arm the timer on its wheel.
+   * \param [in] delay The relative expiration time.
+   * \param [in] event The event to invoke.
+   */
+  void DoSchedule (const Time &delay, EventImpl *event);
+
+  /** Copy constructor, deleted. */
+  WheelTimer (const WheelTimer &) = delete;
+  /**
+   * Assignment operator, deleted.
+   * \returns The timer.
+   */
+  WheelTimer & operator = (const WheelTimer &) = delete;
+
+  Ptr<TimerWheel> m_wheel;  //!< The wheel, or 0
+  EventId m_event;          //!< The simulator event
+  EventImpl *m_impl;        //!< The event to schedule, while linked to the wheel
+  Time m_expiry;            //!< The expiration time, while linked to the wheel
+  WheelTimer *m_prev;       //!< The previous timer of the slot
+  WheelTimer *m_next;       //!< The next timer of the slot
+  uint8_t m_level;          //!< The level of the slot
+  uint8_t m_slot;           //!< The index of the slot
+
+  static uint64_t g_cancelledEvents;    //!< The number of cancelled events
+  static int64_t g_cancelledResidency;  //!< The time steps left by the cancelled events
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+template <typename MEM, typename OBJ, typename... Ts>
+void
+WheelTimer::Schedule (const Time &delay, MEM mem_ptr, OBJ obj, Ts... args)
+{
+  Cancel ();
+  if (m_wheel == 0)
+    {
+      m_event = Simulator::Schedule (delay, mem_ptr, obj, args...);
+    }
+  else
+    {
+      DoSchedule (delay, MakeEvent (mem_ptr, obj, args...));
+    }
+}
+
+} // namespace ns3
+
+#endif /* TIMER_WHEEL_H */
@@ -0,0 +1,347 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include <vector>
+#include "ns3/expiry-calendar.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup timer
+ * \ingroup timer-tests
+ * ExpiryCalendar test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup timer-tests
+ *
+ * Schedule and cancel expirations at random times, with delays of all
+ * scales, and check that they are invoked exactly at their time, in the
+ * order in which they were scheduled.
+ */
+class ExpiryCalendarRandomTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  ExpiryCalendarRandomTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Perform a random operation on a random expiration.
+   */
+  void Step (void);
+  /**
+   * Function invoked when an expiration is due.
+   * \param i The index of the expiration.
+   * \param order The order in which it was scheduled.
+   */
+  void Expire (uint32_t i, uint64_t order);
+
+  ExpiryCalendar m_calendar;              //!< The calendar
+  Ptr<UniformRandomVariable> m_random;    //!< The random variable
+  std::vector<ExpiryCalendar::Id> m_ids;  //!< The identifiers of the expirations
+  std::vector<bool> m_running;            //!< The expected state of the expirations
+  std::vector<Time> m_expiry;             //!< The expected expiration times
+  uint64_t m_order;                       //!< The number of scheduled expirations
+  uint64_t m_lastOrder;                   //!< The order of the last invoked expiration
+  Time m_lastTime;                        //!< The time of the last invoked expiration
+  uint32_t m_expired;                     //!< The number of expirations
+};
+
+ExpiryCalendarRandomTestCase::ExpiryCalendarRandomTestCase ()
+  : TestCase ("Check random expirations"),
+    m_order (0),
+    m_lastOrder (0),
+    m_expired (0)
+{}
+
+void
+ExpiryCalendarRandomTestCase::Expire (uint32_t i, uint64_t order)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_running[i], true, "Unexpected expiration " << i);
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), m_expiry[i], "Wrong time of expiration " << i);
+  NS_TEST_ASSERT_MSG_EQ (m_calendar.IsRunning (m_ids[i]), false, "An invoked expiration is pending");
+  if (Simulator::Now () == m_lastTime)
+    {
+      NS_TEST_ASSERT_MSG_GT (order, m_lastOrder, "Wrong order of the expirations at the same time");
+    }
+  m_lastTime = Simulator::Now ();
+  m_lastOrder = order;
+  m_running[i] = false;
+  m_expired++;
+}
+
+void
+ExpiryCalendarRandomTestCase::Step (void)
+{
+  if (Simulator::Now () >= Seconds (100))
+    {
+      return;
+    }
+  uint32_t i = m_random->GetInteger (0, m_ids.size () - 1);
+  NS_TEST_ASSERT_MSG_EQ (m_calendar.IsRunning (m_ids[i]), m_running[i], "Wrong state of expiration " << i);
+
+  uint32_t operation = m_random->GetInteger (0, 9);
+  if (operation < 7)
+    {
+      // Delays from zero to hours; half of the expirations are rounded up
+      // to the millisecond, so that they often expire at the same time
+      static const int64_t scales[] = {0, 1, 1000, 1000000, 100000000, 10000000000, 10000000000000};
+      int64_t scale = scales[m_random->GetInteger (0, 6)];
+      Time delay = NanoSeconds (static_cast<int64_t> (m_random->GetValue (0, 1) * scale));
+      if (m_random->GetInteger (0, 1))
+        {
+          int64_t expiry = (Simulator::Now () + delay).GetNanoSeconds ();
+          delay = NanoSeconds ((expiry + 999999) / 1000000 * 1000000) - Simulator::Now ();
+        }
+      m_calendar.Cancel (m_ids[i]);
+      m_ids[i] = m_calendar.Schedule (delay, &ExpiryCalendarRandomTestCase::Expire, this, i, ++m_order);
+      m_running[i] = true;
+      m_expiry[i] = Simulator::Now () + delay;
+    }
+  else if (operation < 9)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_calendar.Cancel (m_ids[i]), m_running[i], "Wrong state of expiration " << i);
+      m_running[i] = false;
+    }
+  Simulator::Schedule (MicroSeconds (m_random->GetInteger (0, 2000)), &ExpiryCalendarRandomTestCase::Step, this);
+}
+
+void
+ExpiryCalendarRandomTestCase::DoRun (void)
+{
+  m_random = CreateObject<UniformRandomVariable> ();
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      m_ids.push_back (ExpiryCalendar::Id ());
+      m_running.push_back (false);
+      m_expiry.push_back (Time (0));
+    }
+  Simulator::Schedule (Seconds (1), &ExpiryCalendarRandomTestCase::Step, this);
+  Simulator::Stop (Seconds (100));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_GT (m_expired, 10000, "Too few expirations");
+
+  // Run the expirations which are still pending
+  uint32_t pending = 0;
+  for (uint32_t i = 0; i < m_ids.size (); i++)
+    {
+      if (m_running[i] && m_expiry[i] >= Seconds (1000))
+        {
+          m_calendar.Cancel (m_ids[i]);
+          m_running[i] = false;
+        }
+      pending += m_running[i];
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_calendar.GetSize (), pending, "Wrong number of pending expirations");
+  Simulator::Run ();
+  for (uint32_t i = 0; i < m_ids.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_running[i], false, "Expiration " << i << " was not invoked");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_calendar.GetSize (), 0, "Expirations left in the calendar");
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup timer-tests
+ *
+ * Check the expirations which schedule and cancel expirations, and clear
+ * the calendar, while they are invoked.
+ */
+class ExpiryCalendarReentrancyTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  ExpiryCalendarReentrancyTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Function invoked when an expiration is due.
+   * \param i The index of the expiration.
+   */
+  void Expire (uint32_t i);
+
+  ExpiryCalendar m_calendar;           //!< The calendar
+  std::vector<ExpiryCalendar::Id> m_ids; //!< The identifiers of the expirations
+  std::vector<uint32_t> m_invoked;     //!< The indexes of the invoked expirations
+  std::vector<Time> m_times;           //!< The times of the invoked expirations
+};
+
+ExpiryCalendarReentrancyTestCase::ExpiryCalendarReentrancyTestCase ()
+  : TestCase ("Check the expirations which change the calendar")
+{}
+
+void
+ExpiryCalendarReentrancyTestCase::Expire (uint32_t i)
+{
+  m_invoked.push_back (i);
+  m_times.push_back (Simulator::Now ());
+  switch (i)
+    {
+    case 0:
+      // Cancel expiration 1, due at the same time, and schedule expiration
+      // 3 now, after expiration 2
+      NS_TEST_ASSERT_MSG_EQ (m_calendar.Cancel (m_ids[1]), true, "Expiration 1 is not pending");
+      m_ids[3] = m_calendar.Schedule (Seconds (0), &ExpiryCalendarReentrancyTestCase::Expire, this, 3);
+      break;
+    case 3:
+      // Schedule expiration 4 before expiration 5
+      m_ids[4] = m_calendar.Schedule (Seconds (1), &ExpiryCalendarReentrancyTestCase::Expire, this, 4);
+      break;
+    case 4:
+      m_calendar.Clear ();
+      break;
+    default:
+      break;
+    }
+}
+
+void
+ExpiryCalendarReentrancyTestCase::DoRun (void)
+{
+  m_ids.resize (6);
+  m_ids[0] = m_calendar.Schedule (Seconds (1), &ExpiryCalendarReentrancyTestCase::Expire, this, 0);
+  m_ids[1] = m_calendar.Schedule (Seconds (1), &ExpiryCalendarReentrancyTestCase::Expire, this, 1);
+  m_ids[2] = m_calendar.Schedule (Seconds (1), &ExpiryCalendarReentrancyTestCase::Expire, this, 2);
+  m_ids[5] = m_calendar.Schedule (Seconds (3), &ExpiryCalendarReentrancyTestCase::Expire, this, 5);
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_invoked.size (), 4, "Wrong number of expirations");
+  const uint32_t invoked[] = {0, 2, 3, 4};
+  const Time times[] = {Seconds (1), Seconds (1), Seconds (1), Seconds (2)};
+  for (uint32_t i = 0; i < m_invoked.size () && i < 4; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_invoked[i], invoked[i], "Wrong expiration " << i);
+      NS_TEST_ASSERT_MSG_EQ (m_times[i], times[i], "Wrong time of expiration " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_calendar.GetSize (), 0, "Expirations left in the calendar");
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup timer-tests
+ *
+ * Check that an expiration which is rescheduled before it is due, as soft
+ * state refreshed by periodic messages, does not schedule a simulator
+ * event each time, and that the calendar schedules a single event.
+ */
+class ExpiryCalendarEventsTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  ExpiryCalendarEventsTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Reschedule the expirations.
+   * \param calendar The calendar.
+   */
+  void Refresh (ExpiryCalendar *calendar);
+  /**
+   * Function invoked when an expiration is due.
+   * \param i The index of the expiration.
+   */
+  void Expire (uint32_t i);
+
+  std::vector<ExpiryCalendar::Id> m_ids;  //!< The identifiers of the expirations
+  uint32_t m_refreshed;                   //!< The number of refreshes
+  uint32_t m_expired;                     //!< The number of expirations
+  Time m_expiredTime;                     //!< The time of the last expiration
+};
+
+ExpiryCalendarEventsTestCase::ExpiryCalendarEventsTestCase ()
+  : TestCase ("Check the events scheduled by refreshed expirations")
+{}
+
+void
+ExpiryCalendarEventsTestCase::Refresh (ExpiryCalendar *calendar)
+{
+  for (uint32_t i = 0; i < m_ids.size (); i++)
+    {
+      calendar->Cancel (m_ids[i]);
+      m_ids[i] = calendar->Schedule (MilliSeconds (200 + i), &ExpiryCalendarEventsTestCase::Expire, this, i);
+    }
+  if (++m_refreshed < 1000)
+    {
+      Simulator::Schedule (MilliSeconds (100), &ExpiryCalendarEventsTestCase::Refresh, this, calendar);
+    }
+}
+
+void
+ExpiryCalendarEventsTestCase::Expire (uint32_t i)
+{
+  m_expired++;
+  m_expiredTime = Simulator::Now ();
+}
+
+void
+ExpiryCalendarEventsTestCase::DoRun (void)
+{
+  m_ids.resize (100);
+  m_refreshed = 0;
+  m_expired = 0;
+  ExpiryCalendar calendar;
+  Simulator::ScheduleNow (&ExpiryCalendarEventsTestCase::Refresh, this, &calendar);
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_expired, 100, "Wrong number of expirations");
+  NS_TEST_ASSERT_MSG_EQ (m_expiredTime, MilliSeconds (99900 + 299), "Wrong time of the last expiration");
+  // The refreshes, one wake-up per refresh period and one per expiration
+  NS_TEST_ASSERT_MSG_LT (Simulator::GetEventCount (), 2200, "Too many events scheduled by the calendar");
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup timer-tests
+ * ExpiryCalendar test suite
+ */
+class ExpiryCalendarTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  ExpiryCalendarTestSuite ()
+    : TestSuite ("expiry-calendar", UNIT)
+  {
+    AddTestCase (new ExpiryCalendarRandomTestCase ());
+    AddTestCase (new ExpiryCalendarReentrancyTestCase ());
+    AddTestCase (new ExpiryCalendarEventsTestCase ());
+  }
+};
+
+/**
+ * \ingroup timer-tests
+ * ExpiryCalendarTestSuite instance variable.
+ */
+static ExpiryCalendarTestSuite g_expiryCalendarTestSuite;
+
+
+}  // namespace tests
+
+}  // namespace ns3
@@ -0,0 +1,275 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include <vector>
+#include "ns3/timer-wheel.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup timer
+ * \ingroup timer-tests
+ * TimerWheel test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup timer-tests
+ *
+ * Arm, cancel and query timers at random times and with delays of all
+ * scales, and check that they expire exactly at the expected time.
+ */
+class TimerWheelRandomTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param resolution The resolution of the wheel, or zero for no wheel.
+   */
+  TimerWheelRandomTestCase (Time resolution);
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Perform a random operation on a random timer.
+   */
+  void Step (void);
+  /**
+   * Function invoked when a timer expires.
+   * \param i The index of the timer.
+   */
+  void Expire (uint32_t i);
+
+  Time m_resolution;                  //!< The resolution of the wheel
+  Ptr<UniformRandomVariable> m_random; //!< The random variable
+  std::vector<WheelTimer *> m_timers; //!< The timers
+  std::vector<bool> m_running;        //!< The expected state of the timers
+  std::vector<Time> m_expiry;         //!< The expected expiration times
+  uint32_t m_expired;                 //!< The number of expirations
+};
+
+TimerWheelRandomTestCase::TimerWheelRandomTestCase (Time resolution)
+  : TestCase ("Check random timers with a wheel resolution of " + std::to_string (resolution.GetMicroSeconds ()) + " us"),
+    m_resolution (resolution),
+    m_expired (0)
+{}
+
+void
+TimerWheelRandomTestCase::Expire (uint32_t i)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_running[i], true, "Unexpected expiration of timer " << i);
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), m_expiry[i], "Wrong expiration time of timer " << i);
+  NS_TEST_ASSERT_MSG_EQ (m_timers[i]->IsRunning (), false, "An expiring timer is not running");
+  m_running[i] = false;
+  m_expired++;
+}
+
+void
+TimerWheelRandomTestCase::Step (void)
+{
+  if (Simulator::Now () >= Seconds (100))
+    {
+      return;
+    }
+  uint32_t i = m_random->GetInteger (0, m_timers.size () - 1);
+  WheelTimer *timer = m_timers[i];
+  NS_TEST_ASSERT_MSG_EQ (timer->IsRunning (), m_running[i], "Wrong state of timer " << i);
+  NS_TEST_ASSERT_MSG_EQ (timer->IsExpired (), !m_running[i], "Wrong state of timer " << i);
+  Time left = m_running[i] ? m_expiry[i] - Simulator::Now () : Time (0);
+  NS_TEST_ASSERT_MSG_EQ (timer->GetDelayLeft (), left, "Wrong delay left of timer " << i);
+
+  uint32_t operation = m_random->GetInteger (0, 9);
+  if (operation < 7)
+    {
+      // Delays from zero to hours, with any number of time steps
+      static const int64_t scales[] = {0, 1, 1000, 1000000, 100000000, 10000000000, 10000000000000};
+      int64_t scale = scales[m_random->GetInteger (0, 6)];
+      Time delay = NanoSeconds (static_cast<int64_t> (m_random->GetValue (0, 1) * scale));
+      timer->Schedule (delay, &TimerWheelRandomTestCase::Expire, this, i);
+      m_running[i] = true;
+      m_expiry[i] = Simulator::Now () + delay;
+    }
+  else if (operation < 9)
+    {
+      timer->Cancel ();
+      m_running[i] = false;
+    }
+  Simulator::Schedule (MicroSeconds (m_random->GetInteger (0, 2000)), &TimerWheelRandomTestCase::Step, this);
+}
+
+void
+TimerWheelRandomTestCase::DoRun (void)
+{
+  m_random = CreateObject<UniformRandomVariable> ();
+  Ptr<TimerWheel> wheel;
+  if (m_resolution.IsStrictlyPositive ())
+    {
+      wheel = CreateObject<TimerWheel> ();
+      wheel->SetResolution (m_resolution);
+    }
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      m_timers.push_back (new WheelTimer ());
+      m_timers.back ()->SetWheel (wheel);
+      m_running.push_back (false);
+      m_expiry.push_back (Time (0));
+    }
+  Simulator::Schedule (Seconds (1), &TimerWheelRandomTestCase::Step, this);
+  Simulator::Stop (Seconds (100));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_GT (m_expired, 1000, "Too few timers expired");
+
+  // Run the timers which are still armed to their expiration
+  for (uint32_t i = 0; i < m_timers.size (); i++)
+    {
+      if (m_running[i] && m_expiry[i] < Seconds (1000))
+        {
+          m_timers[i]->Schedule (m_expiry[i] - Simulator::Now (), &TimerWheelRandomTestCase::Expire, this, i);
+        }
+      else
+        {
+          m_timers[i]->Cancel ();
+          m_running[i] = false;
+        }
+    }
+  Simulator::Run ();
+  for (uint32_t i = 0; i < m_timers.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_running[i], false, "Timer " << i << " did not expire");
+      delete m_timers[i];
+    }
+  if (wheel != 0)
+    {
+      NS_TEST_ASSERT_MSG_EQ (wheel->GetNTimers (), 0, "Timers left in the wheel");
+    }
+  m_timers.clear ();
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup timer-tests
+ *
+ * Check that a timer which is re-armed before its expiration leaves no
+ * cancelled event in the scheduler when it is attached to a wheel.
+ */
+class TimerWheelEventsTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  TimerWheelEventsTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Re-arm the timer.
+   * \param timer The timer.
+   */
+  void Rearm (WheelTimer *timer);
+  /** Function invoked when the timer expires. */
+  void Expire (void);
+
+  uint32_t m_rearmed;  //!< The number of times the timer was re-armed
+  Time m_expiredTime;  //!< The expiration time
+};
+
+TimerWheelEventsTestCase::TimerWheelEventsTestCase ()
+  : TestCase ("Check the events scheduled by a re-armed timer")
+{}
+
+void
+TimerWheelEventsTestCase::Rearm (WheelTimer *timer)
+{
+  timer->Schedule (MilliSeconds (200), &TimerWheelEventsTestCase::Expire, this);
+  if (++m_rearmed < 10000)
+    {
+      Simulator::Schedule (MilliSeconds (1), &TimerWheelEventsTestCase::Rearm, this, timer);
+    }
+}
+
+void
+TimerWheelEventsTestCase::Expire (void)
+{
+  m_expiredTime = Simulator::Now ();
+}
+
+void
+TimerWheelEventsTestCase::DoRun (void)
+{
+  uint64_t events[2];
+  uint64_t cancelled[2];
+  for (uint32_t wheel = 0; wheel < 2; wheel++)
+    {
+      m_rearmed = 0;
+      m_expiredTime = Time (0);
+      WheelTimer timer;
+      if (wheel)
+        {
+          timer.SetWheel (CreateObject<TimerWheel> ());
+        }
+      uint64_t before = WheelTimer::GetCancelledEvents ();
+      Simulator::ScheduleNow (&TimerWheelEventsTestCase::Rearm, this, &timer);
+      Simulator::Run ();
+      events[wheel] = Simulator::GetEventCount ();
+      cancelled[wheel] = WheelTimer::GetCancelledEvents () - before;
+      NS_TEST_ASSERT_MSG_EQ (m_expiredTime, MilliSeconds (9999 + 200), "Wrong expiration time");
+      timer.SetWheel (0);
+      Simulator::Destroy ();
+    }
+  // Without a wheel, each re-arm cancels an event
+  NS_TEST_ASSERT_MSG_EQ (cancelled[0], 9999, "Wrong number of cancelled events");
+  NS_TEST_ASSERT_MSG_EQ (cancelled[1], 0, "Wrong number of cancelled events");
+  NS_TEST_ASSERT_MSG_GT (events[0], 19000, "Wrong number of events");
+  NS_TEST_ASSERT_MSG_LT (events[1], 11000, "Too many events scheduled by the wheel");
+}
+
+
+/**
+ * \ingroup timer-tests
+ * TimerWheel test suite
+ */
+class TimerWheelTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  TimerWheelTestSuite ()
+    : TestSuite ("timer-wheel", UNIT)
+  {
+    AddTestCase (new TimerWheelRandomTestCase (Time (0)));
+    AddTestCase (new TimerWheelRandomTestCase (MilliSeconds (1)));
+    AddTestCase (new TimerWheelRandomTestCase (MicroSeconds (7)));
+    AddTestCase (new TimerWheelRandomTestCase (Seconds (3)));
+    AddTestCase (new TimerWheelEventsTestCase ());
+  }
+};
+
+/**
+ * \ingroup timer-tests
+ * TimerWheelTestSuite instance variable.
+ */
+static TimerWheelTestSuite g_timerWheelTestSuite;
+
+
+}  // namespace tests
+
+}  // namespace ns3
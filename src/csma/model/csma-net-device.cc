@@ -29,6 +29,7 @@
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
 #include "ns3/pointer.h"
+#include "ns3/segmentation-offload-tag.h"
 #include "ns3/trace-source-accessor.h"
 #include "csma-net-device.h"
 #include "csma-channel.h"
@@ -522,7 +523,14 @@ CsmaNetDevice::TransmitStart (void)
           m_backoff.ResetBackoffTime ();
           m_txMachineState = BUSY;
 
-          Time tEvent = m_bps.CalculateBytesTxTime (m_currentPkt->GetSize ());
+          // A super-segment takes the time of its segments on the wire
+          uint32_t size = m_currentPkt->GetSize ();
+          SegmentationOffloadTag offload;
+          if (m_currentPkt->PeekPacketTag (offload))
+            {
+              size = offload.GetWireSize (size);
+            }
+          Time tEvent = m_bps.CalculateBytesTxTime (size);
           NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << tEvent.As (Time::S));
           Simulator::Schedule (tEvent, &CsmaNetDevice::TransmitCompleteEvent, this);
         }
@@ -1048,6 +1056,36 @@ CsmaNetDevice::SupportsSendFrom () const
   return true;
 }
 
+bool
+CsmaNetDevice::SupportsSegmentationOffload (Ptr<const Packet> packet) const
+{
+  NS_LOG_FUNCTION (this << packet);
+  // The length of the LLC frames is limited by the MTU
+  if (m_encapMode != DIX || m_channel == 0)
+    {
+      return false;
+    }
+  SegmentationOffloadTag offload;
+  bool found = packet->PeekPacketTag (offload);
+  NS_ASSERT_MSG (found, "Not a super-segment");
+  EthernetHeader header (false);
+  EthernetTrailer trailer;
+  if (!offload.FitsIn (m_queue, packet->GetSize () + header.GetSerializedSize () + trailer.GetSerializedSize ()))
+    {
+      return false;
+    }
+  // The receive error models of the other devices act on each segment
+  for (std::size_t i = 0; i < m_channel->GetNDevices (); i++)
+    {
+      Ptr<CsmaNetDevice> device = m_channel->GetCsmaDevice (i);
+      if (device != this && device->m_receiveErrorModel != 0)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
 int64_t
 CsmaNetDevice::AssignStreams (int64_t stream)
 {
@@ -326,6 +326,7 @@ public:
 
   virtual void SetPromiscReceiveCallback (PromiscReceiveCallback cb);
   virtual bool SupportsSendFrom (void) const;
+  virtual bool SupportsSegmentationOffload (Ptr<const Packet> packet) const;
 
  /**
   * Assign a fixed random variable stream number to the random variables
@@ -601,7 +601,6 @@ RoutingProtocol::RecvDsdv (Ptr<Socket> socket)
                     << sender << " to " << receiver << ". Details are: Destination: " << dsdvHeader.GetDst () << ", Seq No: "
                     << dsdvHeader.GetDstSeqno () << ", HopCount: " << dsdvHeader.GetHopCount ());
       RoutingTableEntry fwdTableEntry, advTableEntry;
-      EventId event;
       bool permanentTableVerifier = m_routingTable.LookupRoute (dsdvHeader.GetDst (),fwdTableEntry);
       if (permanentTableVerifier == false)
         {
@@ -668,9 +667,10 @@ RoutingProtocol::RecvDsdv (Ptr<Socket> socket)
                       advTableEntry.SetSettlingTime (tempSettlingtime);
                       NS_LOG_DEBUG ("Added Settling Time:" << tempSettlingtime.As (Time::S)
                                                            << " as there is no event running for this route");
-                      event = Simulator::Schedule (tempSettlingtime,&RoutingProtocol::SendTriggeredUpdate,this);
-                      m_advRoutingTable.AddIpv4Event (dsdvHeader.GetDst (),event);
-                      NS_LOG_DEBUG ("EventCreated EventUID: " << event.GetUid ());
+                      m_advRoutingTable.AddIpv4Event (dsdvHeader.GetDst (),tempSettlingtime,
+                                                      &RoutingProtocol::SendTriggeredUpdate,this);
+                      NS_LOG_DEBUG ("EventCreated EventUID: "
+                                    << m_advRoutingTable.GetEventId (dsdvHeader.GetDst ()).GetUid ());
                       // if received changed metric, use it but adv it only after wst
                       m_routingTable.Update (advTableEntry);
                       m_advRoutingTable.Update (advTableEntry);
@@ -708,9 +708,10 @@ RoutingProtocol::RecvDsdv (Ptr<Socket> socket)
                       advTableEntry.SetSettlingTime (tempSettlingtime);
                       NS_LOG_DEBUG ("Added Settling Time," << tempSettlingtime.As (Time::S)
                                                            << " as there is no current event running for this route");
-                      event = Simulator::Schedule (tempSettlingtime,&RoutingProtocol::SendTriggeredUpdate,this);
-                      m_advRoutingTable.AddIpv4Event (dsdvHeader.GetDst (),event);
-                      NS_LOG_DEBUG ("EventCreated EventUID: " << event.GetUid ());
+                      m_advRoutingTable.AddIpv4Event (dsdvHeader.GetDst (),tempSettlingtime,
+                                                      &RoutingProtocol::SendTriggeredUpdate,this);
+                      NS_LOG_DEBUG ("EventCreated EventUID: "
+                                    << m_advRoutingTable.GetEventId (dsdvHeader.GetDst ()).GetUid ());
                       // if received changed metric, use it but adv it only after wst
                       m_routingTable.Update (advTableEntry);
                       m_advRoutingTable.Update (advTableEntry);
@@ -833,7 +834,7 @@ RoutingProtocol::SendTriggeredUpdate ()
             }
           else
             {
-              EventId event = m_advRoutingTable.GetEventId (temp.GetDestination ());
+              ExpiryCalendar::Id event = m_advRoutingTable.GetEventId (temp.GetDestination ());
               NS_ASSERT (event.GetUid () != 0);
               NS_LOG_DEBUG ("EventID " << event.GetUid () << " associated with "
                                        << temp.GetDestination () << " has not expired, waiting in adv table");
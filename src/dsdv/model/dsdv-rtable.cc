@@ -294,19 +294,10 @@ RoutingTable::Print (Ptr<OutputStreamWrapper> stream, Time::Unit unit /*= Time::
   (*os).copyfmt (oldState);
 }
 
-bool
-RoutingTable::AddIpv4Event (Ipv4Address address,
-                            EventId id)
-{
-  std::pair<std::map<Ipv4Address, EventId>::iterator, bool> result = m_ipv4Events.insert (std::make_pair (address,id));
-  return result.second;
-}
-
 bool
 RoutingTable::AnyRunningEvent (Ipv4Address address)
 {
-  EventId event;
-  std::map<Ipv4Address, EventId>::const_iterator i = m_ipv4Events.find (address);
+  std::map<Ipv4Address, ExpiryCalendar::Id>::const_iterator i = m_ipv4Events.find (address);
   if (m_ipv4Events.empty ())
     {
       return false;
@@ -315,66 +306,45 @@ RoutingTable::AnyRunningEvent (Ipv4Address address)
     {
       return false;
     }
-  event = i->second;
-  if (event.IsRunning ())
-    {
-      return true;
-    }
-  else
-    {
-      return false;
-    }
+  return m_ipv4EventCalendar.IsRunning (i->second);
 }
 
 bool
 RoutingTable::ForceDeleteIpv4Event (Ipv4Address address)
 {
-  EventId event;
-  std::map<Ipv4Address, EventId>::const_iterator i = m_ipv4Events.find (address);
+  std::map<Ipv4Address, ExpiryCalendar::Id>::iterator i = m_ipv4Events.find (address);
   if (m_ipv4Events.empty () || i == m_ipv4Events.end ())
     {
       return false;
     }
-  event = i->second;
-  Simulator::Cancel (event);
-  m_ipv4Events.erase (address);
+  m_ipv4EventCalendar.Cancel (i->second);
+  m_ipv4Events.erase (i);
   return true;
 }
 
 bool
 RoutingTable::DeleteIpv4Event (Ipv4Address address)
 {
-  EventId event;
-  std::map<Ipv4Address, EventId>::const_iterator i = m_ipv4Events.find (address);
+  std::map<Ipv4Address, ExpiryCalendar::Id>::iterator i = m_ipv4Events.find (address);
   if (m_ipv4Events.empty () || i == m_ipv4Events.end ())
     {
       return false;
     }
-  event = i->second;
-  if (event.IsRunning ())
+  if (m_ipv4EventCalendar.IsRunning (i->second))
     {
       return false;
     }
-  if (event.IsExpired ())
-    {
-      event.Cancel ();
-      m_ipv4Events.erase (address);
-      return true;
-    }
-  else
-    {
-      m_ipv4Events.erase (address);
-      return true;
-    }
+  m_ipv4Events.erase (i);
+  return true;
 }
 
-EventId
+ExpiryCalendar::Id
 RoutingTable::GetEventId (Ipv4Address address)
 {
-  std::map <Ipv4Address, EventId>::const_iterator i = m_ipv4Events.find (address);
+  std::map <Ipv4Address, ExpiryCalendar::Id>::const_iterator i = m_ipv4Events.find (address);
   if (m_ipv4Events.empty () || i == m_ipv4Events.end ())
     {
-      return EventId ();
+      return ExpiryCalendar::Id ();
     }
   else
     {
@@ -38,6 +38,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-route.h"
 #include "ns3/timer.h"
+#include "ns3/expiry-calendar.h"
 #include "ns3/net-device.h"
 #include "ns3/output-stream-wrapper.h"
 
@@ -406,13 +407,19 @@ public:
   RoutingTableSize ();
   /**
   * Add an event for a destination address so that the update to for that destination is sent
-  * after the event is completed.
+  * after the event is completed.  The events are scheduled on the calendar of the table,
+  * which holds a single simulator event.
+  * \tparam MEM \deduced Class method function signature type.
+  * \tparam OBJ \deduced Class type of the object.
   * \param address destination address for which this event is running.
-  * \param id unique eventid that was generated.
+  * \param delay the delay after which the event is completed.
+  * \param mem_ptr member method to invoke when the event is completed.
+  * \param obj the object on which to invoke the member method.
   * \return true on success
   */
+  template <typename MEM, typename OBJ>
   bool
-  AddIpv4Event (Ipv4Address address, EventId id);
+  AddIpv4Event (Ipv4Address address, const Time &delay, MEM mem_ptr, OBJ obj);
   /**
   * Clear up the entry from the map after the event is completed
   * \param address destination address for which this event is running.
@@ -437,11 +444,11 @@ public:
   bool
   ForceDeleteIpv4Event (Ipv4Address address);
   /**
-    * Get the EcentId associated with that address.
+    * Get the identifier of the event associated with that address.
     * \param address destination address for which this event is running.
-    * \return EventId on finding out an event is associated else return NULL.
+    * \return the identifier of the event on finding out an event is associated, else a null identifier.
     */
-  EventId
+  ExpiryCalendar::Id
   GetEventId (Ipv4Address address);
 
   /**
@@ -466,11 +473,22 @@ private:
   /// an entry in the routing table.
   std::map<Ipv4Address, RoutingTableEntry> m_ipv4AddressEntry;
   /// an entry in the event table.
-  std::map<Ipv4Address, EventId> m_ipv4Events;
+  std::map<Ipv4Address, ExpiryCalendar::Id> m_ipv4Events;
+  /// the calendar of the events.
+  ExpiryCalendar m_ipv4EventCalendar;
   /// hold down time of an expired route
   Time m_holddownTime;
 
 };
+
+template <typename MEM, typename OBJ>
+bool
+RoutingTable::AddIpv4Event (Ipv4Address address, const Time &delay, MEM mem_ptr, OBJ obj)
+{
+  ExpiryCalendar::Id id = m_ipv4EventCalendar.Schedule (delay, mem_ptr, obj);
+  std::pair<std::map<Ipv4Address, ExpiryCalendar::Id>::iterator, bool> result = m_ipv4Events.insert (std::make_pair (address,id));
+  return result.second;
+}
 }
 }
 #endif /* DSDV_RTABLE_H */
@@ -22,6 +22,7 @@
 #include "ns3/ipv4-global-routing.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/log.h"
+#include "ns3/system-wall-clock-ms.h"
 
 namespace ns3 {
 
@@ -60,15 +61,23 @@ Ipv4GlobalRoutingHelper::Create (Ptr<Node> node) const
 void 
 Ipv4GlobalRoutingHelper::PopulateRoutingTables (void)
 {
+  SystemWallClockMs clock;
+  clock.Start ();
   GlobalRouteManager::BuildGlobalRoutingDatabase ();
+  int64_t databaseMs = clock.End ();
+  clock.Start ();
   GlobalRouteManager::InitializeRoutes ();
+  int64_t routesMs = clock.End ();
+  NS_LOG_INFO ("Routing tables populated in " << databaseMs + routesMs << " ms (" <<
+               databaseMs << " ms to build the database, " << routesMs << " ms to compute the routes)");
 }
 void 
 Ipv4GlobalRoutingHelper::RecomputeRoutingTables (void)
 {
-  GlobalRouteManager::DeleteGlobalRoutes ();
-  GlobalRouteManager::BuildGlobalRoutingDatabase ();
-  GlobalRouteManager::InitializeRoutes ();
+  SystemWallClockMs clock;
+  clock.Start ();
+  GlobalRouteManager::UpdateGlobalRoutes ();
+  NS_LOG_INFO ("Routing tables recomputed in " << clock.End () << " ms");
 }
 
 
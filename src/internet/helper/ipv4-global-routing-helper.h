@@ -68,21 +68,29 @@ public:
    * routers.
    *
    * All this function does is call the functions
-   * BuildGlobalRoutingDatabase () and  InitializeRoutes ().
+   * BuildGlobalRoutingDatabase () and  InitializeRoutes ().  The routes of
+   * the routers are computed by the number of threads given by the
+   * GlobalRoutingNumThreads global value, and the time taken by each phase
+   * is logged at the INFO level of the GlobalRoutingHelper log component.
    *
    */
   static void PopulateRoutingTables (void);
   /**
-   * \brief Remove all routes that were previously installed in a prior call
-   * to either PopulateRoutingTables() or RecomputeRoutingTables(), and 
-   * add a new set of routes.
-   * 
+   * \brief Update the routes that were previously installed in a prior call
+   * to either PopulateRoutingTables() or RecomputeRoutingTables() to the
+   * current topology.
+   *
    * This method does not change the set of nodes
    * over which GlobalRouting is being used, but it will dynamically update
    * its representation of the global topology before recomputing routes.
    * Users must first call PopulateRoutingTables() and then may subsequently
    * call RecomputeRoutingTables() at any later time in the simulation.
    *
+   * The update is done by GlobalRouteManager::UpdateGlobalRoutes (): the
+   * shortest paths are only recalculated from the routers affected by the
+   * changes of the topology, and the routes of the other routers are
+   * patched in place.  The resulting routing tables are the same as the
+   * ones of a full recomputation.
    */
   static void RecomputeRoutingTables (void);
 private:
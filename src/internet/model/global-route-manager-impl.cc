@@ -26,10 +26,18 @@
 #include <vector>
 #include <queue>
 #include <algorithm>
+#include <functional>
 #include <iostream>
+#include <sstream>
+#include <unordered_map>
 #include "ns3/assert.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
+#include "ns3/core-config.h"
+#include "ns3/system-thread.h"
+#include "ns3/system-wall-clock-ms.h"
 #include "ns3/node-list.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
@@ -38,11 +46,24 @@
 #include "global-route-manager-impl.h"
 #include "candidate-queue.h"
 #include "ipv4-global-routing.h"
+#include "ipv4-routing-table-entry.h"
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("GlobalRouteManagerImpl");
 
+/**
+ * \relates GlobalRouteManagerImpl
+ * \anchor GlobalValueGlobalRoutingNumThreads
+ * \brief The number of threads used to compute the global routes.
+ */
+static GlobalValue g_globalRoutingNumThreads = GlobalValue ("GlobalRoutingNumThreads",
+                                                            "The number of threads used to run the SPF "
+                                                            "calculations of the global routers. The routes "
+                                                            "do not depend on this value.",
+                                                            UintegerValue (1),
+                                                            MakeUintegerChecker<uint32_t> (1));
+
 /**
  * \brief Stream insertion operator.
  *
@@ -530,6 +551,260 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
   return 0;
 }
 
+// ---------------------------------------------------------------------------
+//
+// GlobalRouteManagerLSDBSnapshot Implementation
+//
+// ---------------------------------------------------------------------------
+
+const uint32_t GlobalRouteManagerLSDBSnapshot::NONE;
+
+GlobalRouteManagerLSDBSnapshot::GlobalRouteManagerLSDBSnapshot (const GlobalRouteManagerLSDB &lsdb)
+{
+  NS_LOG_FUNCTION (this << &lsdb);
+  typedef GlobalRouteManagerLSDB::LSDBMap_t::const_iterator CIter_t;
+//
+// The vertices are numbered in the order of the database, which is sorted by
+// link state ID.  A network finds its attached routers as GetLSAByLinkData
+// does, that is the first LSA in the database with a transit link record
+// whose link data is the address of the attached router.
+//
+  std::unordered_map<uint32_t, uint32_t> byLinkData;
+  m_vertices.reserve (lsdb.m_database.size ());
+  for (CIter_t i = lsdb.m_database.begin (); i != lsdb.m_database.end (); i++)
+    {
+      GlobalRoutingLSA *lsa = i->second;
+      Vertex vertex;
+      vertex.type = SPFVertex::VertexUnknown;
+      if (lsa->GetLSType () == GlobalRoutingLSA::RouterLSA)
+        {
+          vertex.type = SPFVertex::VertexRouter;
+        }
+      else if (lsa->GetLSType () == GlobalRoutingLSA::NetworkLSA)
+        {
+          vertex.type = SPFVertex::VertexNetwork;
+        }
+      vertex.id = lsa->GetLinkStateId ();
+      vertex.mask = lsa->GetNetworkLSANetworkMask ();
+      vertex.firstLink = 0;
+      vertex.nLinks = 0;
+      for (uint32_t j = 0; j < lsa->GetNLinkRecords (); j++)
+        {
+          GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
+          if (lr->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork)
+            {
+              byLinkData.insert (std::make_pair (lr->GetLinkData ().Get (), m_vertices.size ()));
+            }
+        }
+      m_vertices.push_back (vertex);
+    }
+
+  std::vector<uint32_t> nodeIds (m_vertices.size (), NONE);
+  std::unordered_map<uint32_t, uint32_t> byRouterId;
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); i++)
+    {
+      Ptr<GlobalRouter> rtr = (*i)->GetObject<GlobalRouter> ();
+      if (rtr)
+        {
+          byRouterId.insert (std::make_pair (rtr->GetRouterId ().Get (), (*i)->GetId ()));
+        }
+    }
+
+  uint32_t v = 0;
+  for (CIter_t i = lsdb.m_database.begin (); i != lsdb.m_database.end (); i++, v++)
+    {
+      GlobalRoutingLSA *lsa = i->second;
+      Vertex &vertex = m_vertices[v];
+      vertex.firstLink = m_links.size ();
+      if (vertex.type == SPFVertex::VertexNetwork)
+        {
+          for (uint32_t j = 0; j < lsa->GetNAttachedRouters (); j++)
+            {
+              Link link;
+              link.type = GlobalRoutingLinkRecord::Unknown;
+              link.linkData = lsa->GetAttachedRouter (j);
+              link.metric = 0;
+              std::unordered_map<uint32_t, uint32_t>::const_iterator w = byLinkData.find (link.linkData.Get ());
+              link.target = (w != byLinkData.end ()) ? w->second : NONE;
+              link.outIf = -1;
+              m_links.push_back (link);
+            }
+          vertex.nLinks = m_links.size () - vertex.firstLink;
+          continue;
+        }
+//
+// The interfaces of a router are those of the node with its router ID,
+// looked up as FindOutgoingInterfaceId does when the router is the root of
+// the SPF tree.
+//
+      Ptr<Ipv4> ipv4;
+      std::unordered_map<uint32_t, uint32_t>::const_iterator node = byRouterId.find (vertex.id.Get ());
+      if (node != byRouterId.end ())
+        {
+          ipv4 = NodeList::GetNode (node->second)->GetObject<Ipv4> ();
+          NS_ASSERT_MSG (ipv4,
+                         "GlobalRouteManagerLSDBSnapshot::GlobalRouteManagerLSDBSnapshot (): "
+                         "GetObject for <Ipv4> interface failed");
+        }
+      uint32_t nTransits = 0;
+      for (uint32_t j = 0; j < lsa->GetNLinkRecords (); j++)
+        {
+          GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
+          Link link;
+          link.type = lr->GetLinkType ();
+          link.linkId = lr->GetLinkId ();
+          link.linkData = lr->GetLinkData ();
+          link.metric = lr->GetMetric ();
+          link.target = NONE;
+          link.outIf = -1;
+          if (link.type == GlobalRoutingLinkRecord::PointToPoint
+              || link.type == GlobalRoutingLinkRecord::TransitNetwork)
+            {
+              nTransits++;
+              link.target = FindVertex (link.linkId);
+            }
+          if (ipv4 && link.type == GlobalRoutingLinkRecord::PointToPoint)
+            {
+              link.outIf = ipv4->GetInterfaceForPrefix (link.linkData, Ipv4Mask ("255.255.255.255"));
+            }
+          else if (ipv4 && link.type == GlobalRoutingLinkRecord::TransitNetwork && link.target != NONE)
+            {
+              const Vertex &w = m_vertices[link.target];
+              link.outIf = ipv4->GetInterfaceForPrefix (w.id, w.mask);
+            }
+          m_links.push_back (link);
+        }
+      vertex.nLinks = m_links.size () - vertex.firstLink;
+      if (nTransits == 0)
+        {
+          NS_LOG_WARN ("all nodes should have at least one transit link:" << vertex.id);
+        }
+    }
+
+  for (uint32_t i = 0; i < lsdb.GetNumExtLSAs (); i++)
+    {
+      GlobalRoutingLSA *extlsa = lsdb.GetExtLSA (i);
+      ExtLSA ext;
+      ext.advertisingRouter = FindVertex (extlsa->GetAdvertisingRouter ());
+      ext.mask = extlsa->GetNetworkLSANetworkMask ();
+      ext.network = extlsa->GetLinkStateId ().CombineMask (ext.mask);
+      m_extLSAs.push_back (ext);
+    }
+  NS_LOG_LOGIC ("LSDB snapshot of " << m_vertices.size () << " vertices, " <<
+                m_links.size () << " links and " << m_extLSAs.size () << " external LSAs");
+}
+
+uint32_t
+GlobalRouteManagerLSDBSnapshot::GetNVertices (void) const
+{
+  return m_vertices.size ();
+}
+
+const GlobalRouteManagerLSDBSnapshot::Vertex&
+GlobalRouteManagerLSDBSnapshot::GetVertex (uint32_t v) const
+{
+  NS_ASSERT (v < m_vertices.size ());
+  return m_vertices[v];
+}
+
+const GlobalRouteManagerLSDBSnapshot::Link&
+GlobalRouteManagerLSDBSnapshot::GetLink (uint32_t i) const
+{
+  NS_ASSERT (i < m_links.size ());
+  return m_links[i];
+}
+
+/**
+ * \brief Compare the link state ID of a vertex with an address.
+ * \param vertex the vertex
+ * \param id the address
+ * \returns true if the link state ID of the vertex is lower than the address
+ */
+static bool
+VertexIdLess (const GlobalRouteManagerLSDBSnapshot::Vertex &vertex, Ipv4Address id)
+{
+  return vertex.id < id;
+}
+
+uint32_t
+GlobalRouteManagerLSDBSnapshot::FindVertex (Ipv4Address id) const
+{
+  std::vector<Vertex>::const_iterator i = std::lower_bound (m_vertices.begin (), m_vertices.end (),
+                                                            id, &VertexIdLess);
+  if (i == m_vertices.end () || i->id != id)
+    {
+      return NONE;
+    }
+  return i - m_vertices.begin ();
+}
+
+uint32_t
+GlobalRouteManagerLSDBSnapshot::GetNExtLSAs (void) const
+{
+  return m_extLSAs.size ();
+}
+
+const GlobalRouteManagerLSDBSnapshot::ExtLSA&
+GlobalRouteManagerLSDBSnapshot::GetExtLSA (uint32_t i) const
+{
+  NS_ASSERT (i < m_extLSAs.size ());
+  return m_extLSAs[i];
+}
+
+/**
+ * @brief Compare two links of LSDB snapshots.
+ * @param a the first link
+ * @param b the second link
+ * @returns true if the links are the same
+ */
+static bool
+SameLink (const GlobalRouteManagerLSDBSnapshot::Link &a, const GlobalRouteManagerLSDBSnapshot::Link &b)
+{
+  return a.type == b.type && a.linkId == b.linkId && a.linkData == b.linkData
+         && a.metric == b.metric && a.target == b.target && a.outIf == b.outIf;
+}
+
+bool
+GlobalRouteManagerLSDBSnapshot::Compare (const GlobalRouteManagerLSDBSnapshot &previous,
+                                         std::vector<uint32_t> &changed) const
+{
+  NS_LOG_FUNCTION (this << &previous);
+  if (m_vertices.size () != previous.m_vertices.size ()
+      || m_extLSAs.size () != previous.m_extLSAs.size ())
+    {
+      return false;
+    }
+  for (std::size_t i = 0; i < m_extLSAs.size (); i++)
+    {
+      const ExtLSA &a = m_extLSAs[i];
+      const ExtLSA &b = previous.m_extLSAs[i];
+      if (a.advertisingRouter != b.advertisingRouter || a.network != b.network || a.mask != b.mask)
+        {
+          return false;
+        }
+    }
+  changed.clear ();
+  for (uint32_t v = 0; v < m_vertices.size (); v++)
+    {
+      const Vertex &a = m_vertices[v];
+      const Vertex &b = previous.m_vertices[v];
+      if (a.type != b.type || a.id != b.id || a.mask != b.mask)
+        {
+          return false;
+        }
+      bool same = (a.nLinks == b.nLinks);
+      for (uint32_t i = 0; same && i < a.nLinks; i++)
+        {
+          same = SameLink (m_links[a.firstLink + i], previous.m_links[b.firstLink + i]);
+        }
+      if (!same)
+        {
+          changed.push_back (v);
+        }
+    }
+  return true;
+}
+
 // ---------------------------------------------------------------------------
 //
 // GlobalRouteManagerImpl Implementation
@@ -538,7 +813,9 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
 
 GlobalRouteManagerImpl::GlobalRouteManagerImpl () 
   :
-    m_spfroot (0)
+    m_spfroot (0),
+    m_snapshot (0),
+    m_nCalculated (0)
 {
   NS_LOG_FUNCTION (this);
   m_lsdb = new GlobalRouteManagerLSDB ();
@@ -551,6 +828,7 @@ GlobalRouteManagerImpl::~GlobalRouteManagerImpl ()
     {
       delete m_lsdb;
     }
+  delete m_snapshot;
 }
 
 void
@@ -578,18 +856,13 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes ()
           continue;
         }
       Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-      uint32_t j = 0;
-      uint32_t nRoutes = gr->GetNRoutes ();
       NS_LOG_LOGIC ("Deleting " << gr->GetNRoutes ()<< " routes from node " << node->GetId ());
-      // Each time we delete route 0, the route index shifts downward
-      // We can delete all routes if we delete the route numbered 0
-      // nRoutes times
-      for (j = 0; j < nRoutes; j++)
-        {
-          NS_LOG_LOGIC ("Deleting global route " << j << " from node " << node->GetId ());
-          gr->RemoveRoute (0);
-        }
-      NS_LOG_LOGIC ("Deleted " << j << " global routes from node "<< node->GetId ());
+      // The routes are removed by range, which does not cost a lookup of
+      // each route in the compact route tables
+      std::vector<Ipv4RoutingTableEntry> none;
+      gr->ReplaceHostRoutes (0, gr->GetNHostRoutes (), none);
+      gr->ReplaceNetworkRoutes (0, gr->GetNNetworkRoutes (), none);
+      gr->ReplaceASExternalRoutes (0, gr->GetNASExternalRoutes (), none);
     }
   if (m_lsdb)
     {
@@ -597,6 +870,9 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes ()
       delete m_lsdb;
       m_lsdb = new GlobalRouteManagerLSDB ();
     }
+  delete m_snapshot;
+  m_snapshot = 0;
+  m_trees.clear ();
 }
 
 //
@@ -658,6 +934,982 @@ GlobalRouteManagerImpl::BuildGlobalRoutingDatabase ()
     }
 }
 
+/**
+ * \ingroup globalrouting
+ *
+ * \brief Runs the SPF calculations of the routers first, first + step,
+ * first + 2 * step, ... of a list against an LSDB snapshot.
+ *
+ * This is the calculation of SPFCalculate, with the state of the vertices
+ * kept in arrays indexed as the snapshot, which are reused by the successive
+ * calculations.  The candidates are ordered as in the CandidateQueue: by
+ * distance from the root, networks before routers, and then in the order in
+ * which they were last pushed.  The routes, including the order of the
+ * equal-cost ones, are thus the same as those added by SPFCalculate.  The
+ * routes are collected in the task and then set through plain pointers, so
+ * that the reference counts are never modified concurrently by different
+ * tasks, and the routing protocol of a router is only accessed by the task
+ * which computes its routes.
+ *
+ * The distance of each vertex of the tree, and the position of the routes to
+ * the point-to-point links and the stub networks of each router, are kept in
+ * the SPFTree of the root.  When the routes are updated, the shortest paths
+ * of a root do not change if no link of a changed vertex was on one of them
+ * or would shorten or add one, and the vertices are then reached in the
+ * same order, through the same exits.  Only the routes to the links and the
+ * stub networks of the changed routers are then replaced, at their
+ * positions in the routing table.
+ */
+class GlobalRouteManagerImpl::SPFTask
+{
+public:
+  /**
+   * Constructor
+   * \param lsdb the LSDB snapshot
+   * \param roots the routers whose routes are computed
+   * \param first the index of the first router whose routes are computed by this task
+   * \param step the distance between two routers whose routes are computed by this task
+   * \param previous the LSDB snapshot of the previous calculation, or 0
+   * \param changed the vertices whose links are not the same in the two snapshots
+   */
+  SPFTask (const GlobalRouteManagerLSDBSnapshot *lsdb, const std::vector<SPFRoot> *roots,
+           std::size_t first, std::size_t step,
+           const GlobalRouteManagerLSDBSnapshot *previous, const std::vector<uint32_t> *changed);
+  /**
+   * Compute the routes of the routers assigned to this task
+   */
+  void Run (void);
+  /**
+   * \returns the number of routers whose SPF calculation was run
+   */
+  uint32_t GetNCalculated (void) const;
+
+private:
+  /// The LSDB snapshot
+  typedef GlobalRouteManagerLSDBSnapshot Snapshot;
+  /// The exit directions from the root to a vertex
+  typedef std::vector<SPFVertex::NodeExit_t> Exits_t;
+  /// A list of routes
+  typedef std::vector<Ipv4RoutingTableEntry> Routes_t;
+
+  /// An entry of the candidate queue
+  struct Candidate
+  {
+    uint32_t distance; //!< the distance of the vertex from the root
+    uint32_t isRouter; //!< 1 for a router, 0 for a network
+    uint32_t sequence; //!< the sequence number of the entry
+    uint32_t vertex;   //!< the vertex
+    /**
+     * \param o the other entry
+     * \returns true if this entry is popped after the other one
+     */
+    bool operator> (const Candidate &o) const
+    {
+      if (distance != o.distance)
+        {
+          return distance > o.distance;
+        }
+      if (isRouter != o.isRouter)
+        {
+          return isRouter > o.isRouter;
+        }
+      return sequence > o.sequence;
+    }
+  };
+
+  /**
+   * Compute the routes of a router, as SPFCalculate
+   * \param root the router
+   */
+  void Calculate (const SPFRoot &root);
+  /**
+   * Install a default route if the root is a stub, as CheckForStubNode
+   * \returns true if the root is a stub
+   */
+  bool CheckForStubNode (void);
+  /**
+   * Examine the links of a vertex in the SPF tree, as SPFNext
+   * \param v the vertex
+   */
+  void Next (uint32_t v);
+  /**
+   * Calculate the exit directions from the root through a vertex to another,
+   * as SPFNexthopCalculation
+   * \param v the parent vertex
+   * \param w the destination vertex
+   * \param link the link from v to w
+   * \param exits the exit directions to w, which are updated
+   */
+  void NexthopCalculation (uint32_t v, uint32_t w, uint32_t link, Exits_t &exits) const;
+  /**
+   * Search for a link between two vertices, as SPFGetNextLink
+   * \param v the vertex whose links are searched
+   * \param w the vertex at the other end of the link
+   * \returns the first link of v to w, or NONE
+   */
+  uint32_t GetLink (uint32_t v, uint32_t w) const;
+  /**
+   * Push a vertex to the candidate queue
+   * \param w the vertex
+   */
+  void Push (uint32_t w);
+  /**
+   * Pop the closest vertex from the candidate queue
+   * \returns the vertex, or NONE if the queue is empty
+   */
+  uint32_t Pop (void);
+  /**
+   * Add the routes to a vertex added to the SPF tree, as SPFIntraAddRouter
+   * and SPFIntraAddTransit
+   * \param v the vertex
+   */
+  void AddIntraRoutes (uint32_t v);
+  /**
+   * Add the routes to the stub networks of the SPF tree, as SPFProcessStubs
+   * \param v the vertex of the subtree
+   */
+  void ProcessStubs (uint32_t v);
+  /**
+   * Add the routes to an AS external network, as ProcessASExternals
+   * \param ext the AS external LSA
+   */
+  void AddExtRoutes (const Snapshot::ExtLSA &ext);
+  /**
+   * Add the network routes to a vertex
+   * \param network the network
+   * \param mask the mask of the network
+   * \param v the vertex
+   */
+  void AddNetworkRoutes (Ipv4Address network, Ipv4Mask mask, uint32_t v);
+
+  /**
+   * Check whether the shortest paths of a router may be changed by the
+   * changed vertices, or whether its routes cannot be updated in place
+   * \param root the router
+   * \returns true if the SPF calculation of the router must be run
+   */
+  bool NeedsCalculation (const SPFRoot &root) const;
+  /**
+   * Update the routes of a router whose shortest paths are not changed
+   * \param root the router
+   */
+  void Patch (const SPFRoot &root);
+
+  const Snapshot *m_lsdb; //!< the LSDB snapshot
+  const std::vector<SPFRoot> *m_roots; //!< the routers whose routes are computed
+  std::size_t m_first; //!< the index of the first router whose routes are computed by this task
+  std::size_t m_step; //!< the distance between two routers whose routes are computed by this task
+  const Snapshot *m_previous; //!< the LSDB snapshot of the previous calculation
+  const std::vector<uint32_t> *m_changed; //!< the vertices changed since the previous calculation
+  uint32_t m_nCalculated; //!< the number of routers whose SPF calculation was run
+
+  uint32_t m_root; //!< the root of the current calculation
+  SPFTree *m_tree; //!< the SPF tree of the root
+  std::vector<GlobalRoutingLSA::SPFStatus> m_status; //!< the status of each vertex
+  std::vector<uint32_t> m_distance; //!< the distance of each vertex from the root
+  std::vector<uint32_t> m_sequence; //!< the sequence number of the candidate entry of each vertex
+  std::vector<bool> m_processed; //!< whether the stubs of each vertex were processed
+  std::vector<std::vector<uint32_t> > m_parents; //!< the parents of each vertex
+  std::vector<std::vector<uint32_t> > m_children; //!< the children of each vertex
+  std::vector<Exits_t> m_exits; //!< the exit directions from the root to each vertex
+  std::vector<uint32_t> m_explored; //!< the vertices whose state must be reset
+  /// the candidate queue
+  std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate> > m_candidates;
+  uint32_t m_nextSequence; //!< the sequence number of the next candidate entry
+  Exits_t m_equalCostExits; //!< the exit directions of an equal-cost path
+  Routes_t m_hostRoutes; //!< the host routes of the root
+  Routes_t m_networkRoutes; //!< the network routes of the root
+  Routes_t m_externalRoutes; //!< the AS external routes of the root
+};
+
+GlobalRouteManagerImpl::SPFTask::SPFTask (const GlobalRouteManagerLSDBSnapshot *lsdb,
+                                          const std::vector<SPFRoot> *roots,
+                                          std::size_t first, std::size_t step,
+                                          const GlobalRouteManagerLSDBSnapshot *previous,
+                                          const std::vector<uint32_t> *changed)
+  : m_lsdb (lsdb),
+    m_roots (roots),
+    m_first (first),
+    m_step (step),
+    m_previous (previous),
+    m_changed (changed),
+    m_nCalculated (0),
+    m_root (Snapshot::NONE),
+    m_tree (0),
+    m_nextSequence (0)
+{
+}
+
+void
+GlobalRouteManagerImpl::SPFTask::Run (void)
+{
+  uint32_t nVertices = m_lsdb->GetNVertices ();
+  m_status.assign (nVertices, GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED);
+  m_distance.assign (nVertices, SPF_INFINITY);
+  m_sequence.assign (nVertices, 0);
+  m_processed.assign (nVertices, false);
+  m_parents.resize (nVertices);
+  m_children.resize (nVertices);
+  m_exits.resize (nVertices);
+  for (std::size_t i = m_first; i < m_roots->size (); i += m_step)
+    {
+      const SPFRoot &root = (*m_roots)[i];
+      if (root.incremental && !NeedsCalculation (root))
+        {
+          Patch (root);
+        }
+      else
+        {
+          Calculate (root);
+          m_nCalculated++;
+        }
+    }
+}
+
+uint32_t
+GlobalRouteManagerImpl::SPFTask::GetNCalculated (void) const
+{
+  return m_nCalculated;
+}
+
+void
+GlobalRouteManagerImpl::SPFTask::Calculate (const SPFRoot &root)
+{
+  m_root = root.vertex;
+  m_tree = root.tree;
+  SPFTreeVertex none;
+  none.distance = SPF_INFINITY;
+  none.nExits = 0;
+  none.hostFirst = 0;
+  none.stubFirst = 0;
+  m_tree->vertices.assign (m_lsdb->GetNVertices (), none);
+  m_hostRoutes.clear ();
+  m_networkRoutes.clear ();
+  m_externalRoutes.clear ();
+
+  m_status[m_root] = GlobalRoutingLSA::LSA_SPF_IN_SPFTREE;
+  m_distance[m_root] = 0;
+  m_explored.push_back (m_root);
+
+  if (!CheckForStubNode ())
+    {
+      for (uint32_t v = m_root; v != Snapshot::NONE; v = Pop ())
+        {
+          if (v != m_root)
+            {
+              m_status[v] = GlobalRoutingLSA::LSA_SPF_IN_SPFTREE;
+              for (std::size_t i = 0; i < m_parents[v].size (); i++)
+                {
+                  m_children[m_parents[v][i]].push_back (v);
+                }
+              AddIntraRoutes (v);
+            }
+          Next (v);
+        }
+      ProcessStubs (m_root);
+      for (uint32_t i = 0; i < m_lsdb->GetNExtLSAs (); i++)
+        {
+          AddExtRoutes (m_lsdb->GetExtLSA (i));
+        }
+    }
+
+  for (std::size_t i = 0; i < m_explored.size (); i++)
+    {
+      uint32_t v = m_explored[i];
+      if (m_status[v] == GlobalRoutingLSA::LSA_SPF_IN_SPFTREE)
+        {
+          m_tree->vertices[v].distance = m_distance[v];
+        }
+      m_status[v] = GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED;
+      m_distance[v] = SPF_INFINITY;
+      m_processed[v] = false;
+      m_parents[v].clear ();
+      m_children[v].clear ();
+      m_exits[v].clear ();
+    }
+  m_explored.clear ();
+  m_nextSequence = 0;
+
+  // The routes replace those of the previous calculation, or are added to
+  // the routes of the router when they are initialized
+  Ipv4GlobalRouting *routing = root.routing;
+  routing->ReplaceHostRoutes (root.replace ? 0 : routing->GetNHostRoutes (),
+                              root.replace ? routing->GetNHostRoutes () : 0, m_hostRoutes);
+  routing->ReplaceNetworkRoutes (root.replace ? 0 : routing->GetNNetworkRoutes (),
+                                 root.replace ? routing->GetNNetworkRoutes () : 0, m_networkRoutes);
+  routing->ReplaceASExternalRoutes (root.replace ? 0 : routing->GetNASExternalRoutes (),
+                                    root.replace ? routing->GetNASExternalRoutes () : 0, m_externalRoutes);
+  m_tree->nHostRoutes = m_hostRoutes.size ();
+  m_tree->nNetworkRoutes = m_networkRoutes.size ();
+  m_tree->nExternalRoutes = m_externalRoutes.size ();
+}
+
+bool
+GlobalRouteManagerImpl::SPFTask::CheckForStubNode (void)
+{
+  const Snapshot::Vertex &root = m_lsdb->GetVertex (m_root);
+  uint32_t transits = 0;
+  uint32_t transitLink = Snapshot::NONE;
+  for (uint32_t i = root.firstLink; i < root.firstLink + root.nLinks; i++)
+    {
+      GlobalRoutingLinkRecord::LinkType type = m_lsdb->GetLink (i).type;
+      if (type == GlobalRoutingLinkRecord::TransitNetwork
+          || type == GlobalRoutingLinkRecord::PointToPoint)
+        {
+          transits++;
+          transitLink = i;
+        }
+    }
+  if (transits == 0)
+    {
+      return true;
+    }
+  if (transits == 1 && m_lsdb->GetLink (transitLink).type == GlobalRoutingLinkRecord::PointToPoint)
+    {
+      // Install a default route to the next hop, which is the local address
+      // of the link record of the peer to this router
+      const Snapshot::Link &link = m_lsdb->GetLink (transitLink);
+      NS_ASSERT (link.target != Snapshot::NONE);
+      const Snapshot::Vertex &w = m_lsdb->GetVertex (link.target);
+      for (uint32_t j = w.firstLink; j < w.firstLink + w.nLinks; j++)
+        {
+          const Snapshot::Link &lr = m_lsdb->GetLink (j);
+          if (lr.type == GlobalRoutingLinkRecord::PointToPoint && lr.linkId == root.id)
+            {
+              m_networkRoutes.push_back (Ipv4RoutingTableEntry::CreateNetworkRouteTo (Ipv4Address::GetZero (),
+                                                                                      Ipv4Mask::GetZero (),
+                                                                                      lr.linkData, link.outIf));
+              return true;
+            }
+        }
+    }
+  return false;
+}
+
+void
+GlobalRouteManagerImpl::SPFTask::Next (uint32_t v)
+{
+  const Snapshot::Vertex &vertex = m_lsdb->GetVertex (v);
+  for (uint32_t i = vertex.firstLink; i < vertex.firstLink + vertex.nLinks; i++)
+    {
+      const Snapshot::Link &l = m_lsdb->GetLink (i);
+      uint32_t w = l.target;
+      uint32_t distance = m_distance[v];
+      if (vertex.type == SPFVertex::VertexRouter)
+        {
+          // Links to stub networks are considered in the second stage
+          if (l.type == GlobalRoutingLinkRecord::StubNetwork)
+            {
+              continue;
+            }
+          NS_ASSERT_MSG (l.type == GlobalRoutingLinkRecord::PointToPoint
+                         || l.type == GlobalRoutingLinkRecord::TransitNetwork, "illegal Link Type");
+          NS_ASSERT (w != Snapshot::NONE);
+          distance += l.metric;
+        }
+      else if (w == Snapshot::NONE)
+        {
+          continue;
+        }
+
+      if (m_status[w] == GlobalRoutingLSA::LSA_SPF_IN_SPFTREE)
+        {
+          continue;
+        }
+      if (m_status[w] == GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED)
+        {
+          m_explored.push_back (w);
+          NexthopCalculation (v, w, i, m_exits[w]);
+          m_distance[w] = distance;
+          m_parents[w].assign (1, v);
+          m_status[w] = GlobalRoutingLSA::LSA_SPF_CANDIDATE;
+          Push (w);
+        }
+      else if (m_distance[w] == distance)
+        {
+          // Equal-cost path: merge the exit directions and the parents
+          m_equalCostExits.clear ();
+          NexthopCalculation (v, w, i, m_equalCostExits);
+          Exits_t &exits = m_exits[w];
+          exits.insert (exits.end (), m_equalCostExits.begin (), m_equalCostExits.end ());
+          std::sort (exits.begin (), exits.end ());
+          exits.erase (std::unique (exits.begin (), exits.end ()), exits.end ());
+          if (std::find (m_parents[w].begin (), m_parents[w].end (), v) == m_parents[w].end ())
+            {
+              m_parents[w].push_back (v);
+            }
+        }
+      else if (m_distance[w] > distance)
+        {
+          // Lower-cost path: the candidate is pushed again with the new
+          // distance, and the previous entry is ignored when popped
+          NexthopCalculation (v, w, i, m_exits[w]);
+          m_distance[w] = distance;
+          m_parents[w].assign (1, v);
+          Push (w);
+        }
+    }
+}
+
+void
+GlobalRouteManagerImpl::SPFTask::NexthopCalculation (uint32_t v, uint32_t w, uint32_t link,
+                                                     Exits_t &exits) const
+{
+  if (v == m_root)
+    {
+      // The next hop is the address of the router adjacent to the root, or
+      // none for a network adjacent to the root
+      Ipv4Address nextHop = Ipv4Address::GetZero ();
+      if (m_lsdb->GetVertex (w).type == SPFVertex::VertexRouter)
+        {
+          uint32_t linkRemote = GetLink (w, v);
+          NS_ASSERT (linkRemote != Snapshot::NONE);
+          nextHop = m_lsdb->GetLink (linkRemote).linkData;
+        }
+      exits.assign (1, SPFVertex::NodeExit_t (nextHop, m_lsdb->GetLink (link).outIf));
+    }
+  else if (m_lsdb->GetVertex (v).type == SPFVertex::VertexNetwork)
+    {
+      // A network directly connecting the root to the router w gives the
+      // next hop, found in the link record of w to the network
+      if (m_parents[v].front () == m_root)
+        {
+          NS_ASSERT (m_lsdb->GetVertex (w).type == SPFVertex::VertexRouter);
+          uint32_t linkRemote = GetLink (w, v);
+          if (linkRemote != Snapshot::NONE)
+            {
+              NS_ASSERT (m_exits[v].size () == 1);
+              exits.assign (1, SPFVertex::NodeExit_t (m_lsdb->GetLink (linkRemote).linkData,
+                                                      m_exits[v].front ().second));
+            }
+        }
+      else
+        {
+          NS_ASSERT (m_exits[v].size () == 1);
+          exits.assign (1, m_exits[v].front ());
+        }
+    }
+  else
+    {
+      // The exit directions are inherited from the vertex closer to the root
+      exits = m_exits[v];
+    }
+}
+
+uint32_t
+GlobalRouteManagerImpl::SPFTask::GetLink (uint32_t v, uint32_t w) const
+{
+  const Snapshot::Vertex &vertex = m_lsdb->GetVertex (v);
+  Ipv4Address id = m_lsdb->GetVertex (w).id;
+  for (uint32_t i = vertex.firstLink; i < vertex.firstLink + vertex.nLinks; i++)
+    {
+      if (m_lsdb->GetLink (i).linkId == id)
+        {
+          return i;
+        }
+    }
+  return Snapshot::NONE;
+}
+
+void
+GlobalRouteManagerImpl::SPFTask::Push (uint32_t w)
+{
+  Candidate candidate;
+  candidate.distance = m_distance[w];
+  candidate.isRouter = (m_lsdb->GetVertex (w).type == SPFVertex::VertexRouter) ? 1 : 0;
+  candidate.sequence = m_nextSequence++;
+  candidate.vertex = w;
+  m_sequence[w] = candidate.sequence;
+  m_candidates.push (candidate);
+}
+
+uint32_t
+GlobalRouteManagerImpl::SPFTask::Pop (void)
+{
+  while (!m_candidates.empty ())
+    {
+      Candidate candidate = m_candidates.top ();
+      m_candidates.pop ();
+      if (m_status[candidate.vertex] == GlobalRoutingLSA::LSA_SPF_CANDIDATE
+          && m_sequence[candidate.vertex] == candidate.sequence)
+        {
+          return candidate.vertex;
+        }
+    }
+  return Snapshot::NONE;
+}
+
+void
+GlobalRouteManagerImpl::SPFTask::AddIntraRoutes (uint32_t v)
+{
+  const Snapshot::Vertex &vertex = m_lsdb->GetVertex (v);
+  if (vertex.type == SPFVertex::VertexRouter)
+    {
+      // Host routes to the local addresses of the point-to-point links of v
+      const Exits_t &exits = m_exits[v];
+      SPFTreeVertex &state = m_tree->vertices[v];
+      state.hostFirst = m_hostRoutes.size ();
+      for (std::size_t j = 0; j < exits.size (); j++)
+        {
+          if (exits[j].second >= 0)
+            {
+              state.nExits++;
+            }
+        }
+      for (uint32_t i = vertex.firstLink; i < vertex.firstLink + vertex.nLinks; i++)
+        {
+          const Snapshot::Link &l = m_lsdb->GetLink (i);
+          if (l.type != GlobalRoutingLinkRecord::PointToPoint)
+            {
+              continue;
+            }
+          for (std::size_t j = 0; j < exits.size (); j++)
+            {
+              if (exits[j].second >= 0)
+                {
+                  m_hostRoutes.push_back (Ipv4RoutingTableEntry::CreateHostRouteTo (l.linkData, exits[j].first,
+                                                                                    exits[j].second));
+                }
+            }
+        }
+    }
+  else
+    {
+      NS_ASSERT_MSG (vertex.type == SPFVertex::VertexNetwork, "illegal SPFVertex type");
+      AddNetworkRoutes (vertex.id.CombineMask (vertex.mask), vertex.mask, v);
+    }
+}
+
+void
+GlobalRouteManagerImpl::SPFTask::ProcessStubs (uint32_t v)
+{
+  const Snapshot::Vertex &vertex = m_lsdb->GetVertex (v);
+  if (vertex.type == SPFVertex::VertexRouter && v != m_root)
+    {
+      m_tree->vertices[v].stubFirst = m_networkRoutes.size ();
+      for (uint32_t i = vertex.firstLink; i < vertex.firstLink + vertex.nLinks; i++)
+        {
+          const Snapshot::Link &l = m_lsdb->GetLink (i);
+          if (l.type == GlobalRoutingLinkRecord::StubNetwork)
+            {
+              Ipv4Mask mask (l.linkData.Get ());
+              AddNetworkRoutes (l.linkId.CombineMask (mask), mask, v);
+            }
+        }
+    }
+  for (std::size_t i = 0; i < m_children[v].size (); i++)
+    {
+      uint32_t child = m_children[v][i];
+      if (!m_processed[child])
+        {
+          ProcessStubs (child);
+          m_processed[child] = true;
+        }
+    }
+}
+
+void
+GlobalRouteManagerImpl::SPFTask::AddExtRoutes (const Snapshot::ExtLSA &ext)
+{
+  // All the vertices in the SPF tree are reached by ProcessASExternals, which
+  // adds the routes through the advertising router unless it is the root
+  uint32_t v = ext.advertisingRouter;
+  if (v == Snapshot::NONE || v == m_root
+      || m_status[v] != GlobalRoutingLSA::LSA_SPF_IN_SPFTREE
+      || m_lsdb->GetVertex (v).type != SPFVertex::VertexRouter)
+    {
+      return;
+    }
+  const Exits_t &exits = m_exits[v];
+  for (std::size_t i = 0; i < exits.size (); i++)
+    {
+      if (exits[i].second >= 0)
+        {
+          m_externalRoutes.push_back (Ipv4RoutingTableEntry::CreateNetworkRouteTo (ext.network, ext.mask,
+                                                                                   exits[i].first,
+                                                                                   exits[i].second));
+        }
+    }
+}
+
+void
+GlobalRouteManagerImpl::SPFTask::AddNetworkRoutes (Ipv4Address network, Ipv4Mask mask, uint32_t v)
+{
+  const Exits_t &exits = m_exits[v];
+  for (std::size_t i = 0; i < exits.size (); i++)
+    {
+      if (exits[i].second >= 0)
+        {
+          m_networkRoutes.push_back (Ipv4RoutingTableEntry::CreateNetworkRouteTo (network, mask,
+                                                                                  exits[i].first,
+                                                                                  exits[i].second));
+        }
+    }
+}
+
+/**
+ * \brief Check whether a vertex is adjacent to a router, directly or
+ * through a network.
+ * \param lsdb the LSDB snapshot
+ * \param r the router
+ * \param u the vertex
+ * \returns true if u is adjacent to r
+ */
+static bool
+IsAdjacent (const GlobalRouteManagerLSDBSnapshot *lsdb, uint32_t r, uint32_t u)
+{
+  const GlobalRouteManagerLSDBSnapshot::Vertex &root = lsdb->GetVertex (r);
+  for (uint32_t i = root.firstLink; i < root.firstLink + root.nLinks; i++)
+    {
+      uint32_t w = lsdb->GetLink (i).target;
+      if (w == u)
+        {
+          return true;
+        }
+      if (w == GlobalRouteManagerLSDBSnapshot::NONE
+          || lsdb->GetVertex (w).type != SPFVertex::VertexNetwork)
+        {
+          continue;
+        }
+      const GlobalRouteManagerLSDBSnapshot::Vertex &network = lsdb->GetVertex (w);
+      for (uint32_t j = network.firstLink; j < network.firstLink + network.nLinks; j++)
+        {
+          if (lsdb->GetLink (j).target == u)
+            {
+              return true;
+            }
+        }
+    }
+  return false;
+}
+
+/**
+ * \brief Check whether a vertex of an LSDB snapshot has a link.
+ * \param lsdb the LSDB snapshot
+ * \param vertex the vertex
+ * \param link the link
+ * \returns true if the vertex has the same link
+ */
+static bool
+HasLink (const GlobalRouteManagerLSDBSnapshot *lsdb, const GlobalRouteManagerLSDBSnapshot::Vertex &vertex,
+         const GlobalRouteManagerLSDBSnapshot::Link &link)
+{
+  for (uint32_t i = vertex.firstLink; i < vertex.firstLink + vertex.nLinks; i++)
+    {
+      if (SameLink (lsdb->GetLink (i), link))
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+/**
+ * \brief Count the links of a given type of a vertex.
+ * \param lsdb the LSDB snapshot
+ * \param vertex the vertex
+ * \param type the type of the links
+ * \returns the number of links
+ */
+static uint32_t
+CountLinks (const GlobalRouteManagerLSDBSnapshot *lsdb, const GlobalRouteManagerLSDBSnapshot::Vertex &vertex,
+            GlobalRoutingLinkRecord::LinkType type)
+{
+  uint32_t n = 0;
+  for (uint32_t i = vertex.firstLink; i < vertex.firstLink + vertex.nLinks; i++)
+    {
+      if (lsdb->GetLink (i).type == type)
+        {
+          n++;
+        }
+    }
+  return n;
+}
+
+bool
+GlobalRouteManagerImpl::SPFTask::NeedsCalculation (const SPFRoot &root) const
+{
+  const SPFTree &tree = *root.tree;
+  if (tree.vertices.size () != m_lsdb->GetNVertices ()
+      || root.routing->GetNHostRoutes () != tree.nHostRoutes
+      || root.routing->GetNNetworkRoutes () != tree.nNetworkRoutes
+      || root.routing->GetNASExternalRoutes () != tree.nExternalRoutes)
+    {
+      return true;
+    }
+  for (std::size_t k = 0; k < m_changed->size (); k++)
+    {
+      uint32_t u = (*m_changed)[k];
+      if (u == root.vertex)
+        {
+          return true;
+        }
+      uint32_t distance = tree.vertices[u].distance;
+      if (distance == SPF_INFINITY)
+        {
+          // The links of a vertex out of the tree are not examined, and the
+          // links added to it by the other vertices are checked with them
+          continue;
+        }
+      // The next hops to the routers adjacent to the root are their
+      // addresses in the link records to the root or to a network
+      if (IsAdjacent (m_previous, root.vertex, u) || IsAdjacent (m_lsdb, root.vertex, u))
+        {
+          return true;
+        }
+
+      const Snapshot::Vertex &before = m_previous->GetVertex (u);
+      const Snapshot::Vertex &after = m_lsdb->GetVertex (u);
+      bool isRouter = (after.type == SPFVertex::VertexRouter);
+      // A removed link which was on a shortest path
+      for (uint32_t i = before.firstLink; i < before.firstLink + before.nLinks; i++)
+        {
+          const Snapshot::Link &l = m_previous->GetLink (i);
+          if ((isRouter && l.type == GlobalRoutingLinkRecord::StubNetwork)
+              || l.target == Snapshot::NONE || HasLink (m_lsdb, after, l))
+            {
+              continue;
+            }
+          if (distance + l.metric == tree.vertices[l.target].distance)
+            {
+              return true;
+            }
+        }
+      // An added link which shortens a path or gives an equal-cost one
+      for (uint32_t i = after.firstLink; i < after.firstLink + after.nLinks; i++)
+        {
+          const Snapshot::Link &l = m_lsdb->GetLink (i);
+          if ((isRouter && l.type == GlobalRoutingLinkRecord::StubNetwork)
+              || HasLink (m_previous, before, l))
+            {
+              continue;
+            }
+          if (l.target == Snapshot::NONE || distance + l.metric <= tree.vertices[l.target].distance)
+            {
+              return true;
+            }
+        }
+      // The exits of a router are found in its routes, and routes are only
+      // inserted after existing ones
+      if (isRouter && tree.vertices[u].nExits > 0)
+        {
+          if ((CountLinks (m_previous, before, GlobalRoutingLinkRecord::PointToPoint) == 0
+               && CountLinks (m_lsdb, after, GlobalRoutingLinkRecord::PointToPoint) > 0)
+              || (CountLinks (m_previous, before, GlobalRoutingLinkRecord::StubNetwork) == 0
+                  && CountLinks (m_lsdb, after, GlobalRoutingLinkRecord::StubNetwork) > 0))
+            {
+              return true;
+            }
+        }
+    }
+  return false;
+}
+
+void
+GlobalRouteManagerImpl::SPFTask::Patch (const SPFRoot &root)
+{
+  SPFTree &tree = *root.tree;
+  Ipv4GlobalRouting *routing = root.routing;
+  for (std::size_t k = 0; k < m_changed->size (); k++)
+    {
+      uint32_t u = (*m_changed)[k];
+      SPFTreeVertex &state = tree.vertices[u];
+      const Snapshot::Vertex &before = m_previous->GetVertex (u);
+      const Snapshot::Vertex &after = m_lsdb->GetVertex (u);
+      if (state.distance == SPF_INFINITY || state.nExits == 0 || after.type != SPFVertex::VertexRouter)
+        {
+          continue;
+        }
+
+      // The exits to u are those of its first route
+      uint32_t nHost = CountLinks (m_previous, before, GlobalRoutingLinkRecord::PointToPoint) * state.nExits;
+      uint32_t nStub = CountLinks (m_previous, before, GlobalRoutingLinkRecord::StubNetwork) * state.nExits;
+      uint32_t first = (nHost > 0) ? state.hostFirst : tree.nHostRoutes + state.stubFirst;
+      if (nHost == 0 && nStub == 0)
+        {
+          continue;
+        }
+      m_equalCostExits.clear ();
+      for (uint32_t j = 0; j < state.nExits; j++)
+        {
+          Ipv4RoutingTableEntry *route = routing->GetRoute (first + j);
+          m_equalCostExits.push_back (SPFVertex::NodeExit_t (route->GetGateway (), route->GetInterface ()));
+        }
+
+      m_hostRoutes.clear ();
+      m_networkRoutes.clear ();
+      for (uint32_t i = after.firstLink; i < after.firstLink + after.nLinks; i++)
+        {
+          const Snapshot::Link &l = m_lsdb->GetLink (i);
+          for (std::size_t j = 0; j < m_equalCostExits.size (); j++)
+            {
+              const SPFVertex::NodeExit_t &exit = m_equalCostExits[j];
+              if (l.type == GlobalRoutingLinkRecord::PointToPoint)
+                {
+                  m_hostRoutes.push_back (Ipv4RoutingTableEntry::CreateHostRouteTo (l.linkData, exit.first,
+                                                                                    exit.second));
+                }
+              else if (l.type == GlobalRoutingLinkRecord::StubNetwork)
+                {
+                  Ipv4Mask mask (l.linkData.Get ());
+                  m_networkRoutes.push_back (Ipv4RoutingTableEntry::CreateNetworkRouteTo (l.linkId.CombineMask (mask),
+                                                                                          mask, exit.first,
+                                                                                          exit.second));
+                }
+            }
+        }
+
+      // Replace the routes of u, and move the positions of the routes after them
+      uint32_t hostFirst = state.hostFirst;
+      uint32_t stubFirst = state.stubFirst;
+      if (nHost > 0 || !m_hostRoutes.empty ())
+        {
+          routing->ReplaceHostRoutes (hostFirst, nHost, m_hostRoutes);
+          tree.nHostRoutes += m_hostRoutes.size () - nHost;
+        }
+      if (nStub > 0 || !m_networkRoutes.empty ())
+        {
+          routing->ReplaceNetworkRoutes (stubFirst, nStub, m_networkRoutes);
+          tree.nNetworkRoutes += m_networkRoutes.size () - nStub;
+        }
+      for (std::size_t v = 0; v < tree.vertices.size (); v++)
+        {
+          SPFTreeVertex &other = tree.vertices[v];
+          if (other.distance == SPF_INFINITY)
+            {
+              continue;
+            }
+          if (other.hostFirst > hostFirst)
+            {
+              other.hostFirst += m_hostRoutes.size () - nHost;
+            }
+          if (other.stubFirst > stubFirst)
+            {
+              other.stubFirst += m_networkRoutes.size () - nStub;
+            }
+        }
+    }
+}
+
+std::vector<GlobalRouteManagerImpl::SPFRoot>
+GlobalRouteManagerImpl::GetSPFRoots (const GlobalRouteManagerLSDBSnapshot &lsdb, bool replace,
+                                     bool incremental)
+{
+  NS_LOG_FUNCTION (this << &lsdb << replace << incremental);
+  std::vector<SPFRoot> roots;
+  std::map<uint32_t, SPFTree> trees;
+//
+// Walk the list of nodes in the system.
+//
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+    {
+      Ptr<Node> node = *i;
+//
+// Look for the GlobalRouter interface that indicates that the node is
+// participating in routing.
+//
+      Ptr<GlobalRouter> rtr = 
+        node->GetObject<GlobalRouter> ();
+      if (!rtr)
+        {
+          continue;
+        }
+
+//
+// if the node has a global router interface, and is assigned to our systemId
+// (distributed sim), then run the global routing algorithms.  The routes of
+// the other routers are deleted when they are replaced.
+//
+      uint32_t systemId = Simulator::GetSystemId ();
+      if (node->GetSystemId () != systemId || rtr->GetNumLSAs () == 0)
+        {
+          if (replace)
+            {
+              Ptr<Ipv4GlobalRouting> gr = rtr->GetRoutingProtocol ();
+              std::vector<Ipv4RoutingTableEntry> none;
+              gr->ReplaceHostRoutes (0, gr->GetNHostRoutes (), none);
+              gr->ReplaceNetworkRoutes (0, gr->GetNNetworkRoutes (), none);
+              gr->ReplaceASExternalRoutes (0, gr->GetNASExternalRoutes (), none);
+            }
+          continue;
+        }
+
+      SPFRoot root;
+      root.vertex = lsdb.FindVertex (rtr->GetRouterId ());
+      NS_ASSERT_MSG (root.vertex != GlobalRouteManagerLSDBSnapshot::NONE
+                     && lsdb.GetVertex (root.vertex).type == SPFVertex::VertexRouter,
+                     "GlobalRouteManagerImpl::GetSPFRoots (): "
+                     "No router LSA for router " << rtr->GetRouterId ());
+      root.routing = PeekPointer (rtr->GetRoutingProtocol ());
+      NS_ASSERT (root.routing);
+      root.tree = &trees[node->GetId ()];
+      root.replace = replace;
+      root.incremental = false;
+      std::map<uint32_t, SPFTree>::iterator previous = m_trees.find (node->GetId ());
+      if (incremental && previous != m_trees.end ())
+        {
+          std::swap (*root.tree, previous->second);
+          root.incremental = true;
+        }
+      roots.push_back (root);
+    }
+  m_trees.swap (trees);
+  return roots;
+}
+
+uint32_t
+GlobalRouteManagerImpl::RunSPFTasks (const GlobalRouteManagerLSDBSnapshot *lsdb,
+                                     const std::vector<SPFRoot> &roots,
+                                     const GlobalRouteManagerLSDBSnapshot *previous,
+                                     const std::vector<uint32_t> &changed)
+{
+  NS_LOG_FUNCTION (this << lsdb << roots.size () << previous << changed.size ());
+//
+// Run the SPF calculations of the routers.  The calling thread runs its share
+// of the calculations while the other threads are running.  Each calculation
+// only writes to the routing table of its root, so the routes do not depend
+// on the number of threads.
+//
+  UintegerValue numThreads;
+  g_globalRoutingNumThreads.GetValue (numThreads);
+  std::size_t numTasks = std::min<std::size_t> (numThreads.Get (), roots.size ());
+#ifndef HAVE_PTHREAD_H
+  numTasks = std::min<std::size_t> (numTasks, 1);
+#endif
+  std::vector<SPFTask> tasks;
+  for (std::size_t i = 0; i < numTasks; i++)
+    {
+      tasks.push_back (SPFTask (lsdb, &roots, i, numTasks, previous, &changed));
+    }
+#ifdef HAVE_PTHREAD_H
+  std::vector<Ptr<SystemThread> > threads;
+  for (std::size_t i = 1; i < numTasks; i++)
+    {
+      threads.push_back (Create<SystemThread> (MakeCallback (&SPFTask::Run, &tasks[i])));
+      threads.back ()->Start ();
+    }
+#endif
+  if (numTasks > 0)
+    {
+      tasks[0].Run ();
+    }
+#ifdef HAVE_PTHREAD_H
+  for (std::size_t i = 0; i < threads.size (); i++)
+    {
+      threads[i]->Join ();
+    }
+#endif
+  uint32_t nCalculated = 0;
+  for (std::size_t i = 0; i < tasks.size (); i++)
+    {
+      nCalculated += tasks[i].GetNCalculated ();
+    }
+  NS_LOG_LOGIC ("SPF calculation of " << nCalculated << " of " << roots.size () <<
+                " routers run using " << numTasks << " threads");
+  return nCalculated;
+}
+
 //
 // For each node that is a global router (which is determined by the presence
 // of an aggregated GlobalRouter interface), run the Dijkstra SPF calculation
@@ -695,38 +1947,84 @@ void
 GlobalRouteManagerImpl::InitializeRoutes ()
 {
   NS_LOG_FUNCTION (this);
-//
-// Walk the list of nodes in the system.
-//
+  SystemWallClockMs clock;
+  clock.Start ();
+  GlobalRouteManagerLSDBSnapshot *lsdb = new GlobalRouteManagerLSDBSnapshot (*m_lsdb);
+  int64_t snapshotMs = clock.End ();
+
   NS_LOG_INFO ("About to start SPF calculation");
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+  clock.Start ();
+  std::vector<SPFRoot> roots = GetSPFRoots (*lsdb, false, false);
+  m_nCalculated = RunSPFTasks (lsdb, roots, 0, std::vector<uint32_t> ());
+  int64_t spfMs = clock.End ();
+  NS_LOG_INFO ("Finished SPF calculation of " << roots.size () << " routers in " <<
+               spfMs << " ms, LSDB snapshot of " << lsdb->GetNVertices () <<
+               " vertices built in " << snapshotMs << " ms");
+  NS_LOG_INFO ("Memory of the routing tables: " << GetMemoryUsage (roots));
+
+  // The snapshot and the SPF trees are kept to update the routes
+  delete m_snapshot;
+  m_snapshot = lsdb;
+}
+
+void
+GlobalRouteManagerImpl::UpdateGlobalRoutes ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_snapshot == 0)
     {
-      Ptr<Node> node = *i;
-//
-// Look for the GlobalRouter interface that indicates that the node is
-// participating in routing.
-//
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
+      DeleteGlobalRoutes ();
+      BuildGlobalRoutingDatabase ();
+      InitializeRoutes ();
+      return;
+    }
 
-      uint32_t systemId = Simulator::GetSystemId ();
-      // Ignore nodes that are not assigned to our systemId (distributed sim)
-      if (node->GetSystemId () != systemId) 
-        {
-          continue;
-        }
+  SystemWallClockMs clock;
+  clock.Start ();
+  delete m_lsdb;
+  m_lsdb = new GlobalRouteManagerLSDB ();
+  BuildGlobalRoutingDatabase ();
+  GlobalRouteManagerLSDBSnapshot *lsdb = new GlobalRouteManagerLSDBSnapshot (*m_lsdb);
+  int64_t databaseMs = clock.End ();
+
+//
+// If the routers and networks are the same as in the previous snapshot, the
+// routes of a router are only calculated again if its shortest paths may
+// be changed by the links of the changed routers and networks.
+//
+  clock.Start ();
+  std::vector<uint32_t> changed;
+  bool comparable = lsdb->Compare (*m_snapshot, changed);
+  std::vector<SPFRoot> roots = GetSPFRoots (*lsdb, true, comparable);
+  m_nCalculated = RunSPFTasks (lsdb, roots, m_snapshot, changed);
+  int64_t spfMs = clock.End ();
+  NS_LOG_INFO ("Updated the routes of " << roots.size () << " routers in " << spfMs <<
+               " ms, SPF calculation run for " << m_nCalculated << " routers, " <<
+               (comparable ? changed.size () : lsdb->GetNVertices ()) << " LSAs changed, " <<
+               "LSDB rebuilt in " << databaseMs << " ms");
+
+  delete m_snapshot;
+  m_snapshot = lsdb;
+}
 
-//
-// if the node has a global router interface, then run the global routing
-// algorithms.
-//
-      if (rtr && rtr->GetNumLSAs () )
-        {
-          SPFCalculate (rtr->GetRouterId ());
-        }
+std::string
+GlobalRouteManagerImpl::GetMemoryUsage (const std::vector<SPFRoot> &roots)
+{
+  std::size_t routeBytes = 0;
+  std::size_t maxRouteBytes = 0;
+  std::size_t treeBytes = 0;
+  for (std::size_t i = 0; i < roots.size (); i++)
+    {
+      std::size_t bytes = roots[i].routing->GetMemoryUsage ();
+      routeBytes += bytes;
+      maxRouteBytes = std::max (maxRouteBytes, bytes);
+      treeBytes += roots[i].tree->vertices.capacity () * sizeof (SPFTreeVertex);
     }
-  NS_LOG_INFO ("Finished SPF calculation");
+  std::size_t n = std::max<std::size_t> (roots.size (), 1);
+  std::ostringstream oss;
+  oss << "routes of " << routeBytes / n << " bytes per router on average (" << maxRouteBytes <<
+    " at most), SPF trees of " << treeBytes / n << " bytes per router";
+  return oss.str ();
 }
 
 //
@@ -1242,6 +2540,12 @@ GlobalRouteManagerImpl::SPFGetNextLink (
 //
 // Used for unit tests.
 //
+uint32_t
+GlobalRouteManagerImpl::DebugGetNCalculated (void) const
+{
+  return m_nCalculated;
+}
+
 void
 GlobalRouteManagerImpl::DebugSPFCalculate (Ipv4Address root)
 {
@@ -682,6 +682,8 @@ private:
   LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
   std::vector<GlobalRoutingLSA*> m_extdatabase; //!< database of External Link State Advertisements
 
+  friend class GlobalRouteManagerLSDBSnapshot;
+
 /**
  * @brief GlobalRouteManagerLSDB copy construction is disallowed.  There's no 
  * need for it and a compiler provided shallow copy would be wrong.
@@ -698,6 +700,113 @@ private:
   GlobalRouteManagerLSDB& operator= (GlobalRouteManagerLSDB& lsdb);
 };
 
+/**
+ * @brief A read-only, array-based copy of a Global Route Manager Link State
+ * Database.
+ *
+ * The SPF calculations of all the routers are run against the same snapshot,
+ * possibly by different threads, so nothing is modified once it is built.
+ * The router and network LSAs are numbered in the order of the database and
+ * become the vertices of the snapshot.  The links of each vertex are stored
+ * contiguously, with the index of the vertex at the other end of each link
+ * resolved once, instead of searching the database for it in each SPF
+ * calculation.  The outgoing interfaces of the links of each router are
+ * looked up on its node when the snapshot is built, so that the SPF
+ * calculations do not need to access the nodes.
+ */
+class GlobalRouteManagerLSDBSnapshot
+{
+public:
+  /// The index of a vertex or a link which does not exist
+  static const uint32_t NONE = 0xffffffff;
+
+  /// A router or a network
+  struct Vertex
+  {
+    SPFVertex::VertexType type; //!< the type of the vertex
+    Ipv4Address id;             //!< the link state ID of the LSA
+    Ipv4Mask mask;              //!< the network mask of a network
+    uint32_t firstLink;         //!< the index of the first link of the vertex
+    uint32_t nLinks;            //!< the number of links of the vertex
+  };
+
+  /**
+   * A link record of a router, or an attached router of a network. The link
+   * ID and the metric are not used by the links of a network.
+   */
+  struct Link
+  {
+    GlobalRoutingLinkRecord::LinkType type; //!< the type of the link record
+    Ipv4Address linkId;   //!< the link ID of the link record
+    Ipv4Address linkData; //!< the link data of the link record, or the attached router
+    uint16_t metric;      //!< the metric of the link record
+    uint32_t target;      //!< the vertex at the other end of the link, or NONE
+    int32_t outIf;        //!< the interface of the router to the link, or -1
+  };
+
+  /// An AS external LSA
+  struct ExtLSA
+  {
+    uint32_t advertisingRouter; //!< the vertex of the advertising router, or NONE
+    Ipv4Address network;        //!< the external network
+    Ipv4Mask mask;              //!< the mask of the external network
+  };
+
+  /**
+   * @brief Build the snapshot of a Link State Database.
+   * @param lsdb the Link State Database
+   */
+  GlobalRouteManagerLSDBSnapshot (const GlobalRouteManagerLSDB &lsdb);
+
+  /**
+   * @returns the number of vertices
+   */
+  uint32_t GetNVertices (void) const;
+  /**
+   * @param v the index of the vertex
+   * @returns the vertex
+   */
+  const Vertex& GetVertex (uint32_t v) const;
+  /**
+   * @param i the index of the link
+   * @returns the link
+   */
+  const Link& GetLink (uint32_t i) const;
+  /**
+   * @brief Look up the vertex of an LSA, as GlobalRouteManagerLSDB::GetLSA.
+   * @param id the link state ID of the LSA
+   * @returns the index of the vertex, or NONE
+   */
+  uint32_t FindVertex (Ipv4Address id) const;
+  /**
+   * @returns the number of AS external LSAs
+   */
+  uint32_t GetNExtLSAs (void) const;
+  /**
+   * @param i the index of the AS external LSA
+   * @returns the AS external LSA
+   */
+  const ExtLSA& GetExtLSA (uint32_t i) const;
+  /**
+   * @brief Compare the snapshot with a previous snapshot.
+   *
+   * The two snapshots are comparable if they have the same vertices, in the
+   * same order, and the same AS external LSAs.
+   *
+   * @param previous the previous snapshot
+   * @param changed the vertices whose links are not the same in the two
+   * snapshots, in increasing order
+   * @returns true if the snapshots are comparable, false otherwise, in which
+   * case changed is not set
+   */
+  bool Compare (const GlobalRouteManagerLSDBSnapshot &previous, std::vector<uint32_t> &changed) const;
+
+private:
+  std::vector<Vertex> m_vertices; //!< the vertices, sorted by link state ID
+  std::vector<Link> m_links;      //!< the links of all the vertices
+  std::vector<ExtLSA> m_extLSAs;  //!< the AS external LSAs
+};
+
 /**
  * @brief A global router implementation.
  *
@@ -732,9 +841,25 @@ public:
 /**
  * @brief Compute routes using a Dijkstra SPF computation and populate
  * per-node forwarding tables
+ *
+ * The SPF calculations of the routers are run against a snapshot of the
+ * LSDB, using the number of threads given by the GlobalRoutingNumThreads
+ * global value.  The routing tables do not depend on the number of threads.
  */
   virtual void InitializeRoutes ();
 
+/**
+ * @brief Rebuild the routing database and update the routes of the nodes
+ *
+ * The routes are the same as those computed by DeleteGlobalRoutes (),
+ * BuildGlobalRoutingDatabase () and InitializeRoutes ().  The SPF
+ * calculation of a router is only run again if a link in its shortest-path
+ * tree, or one which would shorten a path, is changed.  The other routers
+ * only update the routes to the point-to-point links and to the stub
+ * networks which are changed, and the routing tables are modified in place.
+ */
+  virtual void UpdateGlobalRoutes ();
+
 /**
  * @brief Debugging routine; allow client code to supply a pre-built LSDB
  * @param lsdb the pre-built LSDB
@@ -747,6 +872,13 @@ public:
  */
   void DebugSPFCalculate (Ipv4Address root);
 
+/**
+ * @brief Debugging routine; get the number of routers whose SPF calculation
+ * was run by the last call to InitializeRoutes () or UpdateGlobalRoutes ()
+ * @returns the number of routers
+ */
+  uint32_t DebugGetNCalculated (void) const;
+
 private:
 /**
  * @brief GlobalRouteManagerImpl copy construction is disallowed.
@@ -770,6 +902,78 @@ private:
   SPFVertex* m_spfroot; //!< the root node
   GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
 
+  /// The state of a vertex in the SPF tree of a router
+  struct SPFTreeVertex
+  {
+    uint32_t distance;  //!< the distance from the root, or SPF_INFINITY if the vertex is not in the tree
+    uint32_t nExits;    //!< the number of routes added to each destination through a router
+    uint32_t hostFirst; //!< the index of the first host route to the point-to-point links of a router
+    uint32_t stubFirst; //!< the index of the first network route to the stub networks of a router
+  };
+
+  /**
+   * The SPF tree of a router, kept from a calculation to the next one so that
+   * the routes of the router can be updated rather than calculated again if
+   * the tree is not changed.
+   */
+  struct SPFTree
+  {
+    std::vector<SPFTreeVertex> vertices; //!< the state of the vertices of the LSDB snapshot
+    uint32_t nHostRoutes;       //!< the number of host routes of the router
+    uint32_t nNetworkRoutes;    //!< the number of network routes of the router
+    uint32_t nExternalRoutes;   //!< the number of AS external routes of the router
+  };
+
+  /// A router whose routes are computed by InitializeRoutes or UpdateGlobalRoutes
+  struct SPFRoot
+  {
+    uint32_t vertex;            //!< the vertex of the router in the LSDB snapshot
+    Ipv4GlobalRouting *routing; //!< the routing protocol of the router
+    SPFTree *tree;              //!< the SPF tree of the router
+    bool replace;               //!< whether the routes replace all those of the router, or are added to them
+    bool incremental;           //!< whether the tree is that of the previous snapshot
+  };
+
+  /**
+   * @brief Collect the routers whose routes are computed, with their SPF
+   * trees.
+   * @param lsdb the LSDB snapshot
+   * @param replace whether the routes replace all those of the routers, in
+   * which case the routes of the other nodes are deleted
+   * @param incremental whether the trees of the previous calculation can be
+   * used to update the routes
+   * @returns the routers
+   */
+  std::vector<SPFRoot> GetSPFRoots (const GlobalRouteManagerLSDBSnapshot &lsdb, bool replace,
+                                    bool incremental);
+
+  /**
+   * @brief Run the SPF calculations or updates of routers, using the number
+   * of threads given by the GlobalRoutingNumThreads global value.
+   * @param lsdb the LSDB snapshot
+   * @param roots the routers
+   * @param previous the snapshot of the previous calculation, or 0
+   * @param changed the vertices whose links are not the same in the two
+   * snapshots
+   * @returns the number of routers whose SPF calculation was run
+   */
+  uint32_t RunSPFTasks (const GlobalRouteManagerLSDBSnapshot *lsdb, const std::vector<SPFRoot> &roots,
+                    const GlobalRouteManagerLSDBSnapshot *previous, const std::vector<uint32_t> &changed);
+
+  /**
+   * @brief Describe the memory used by the routes and the SPF trees of
+   * routers.
+   * @param roots the routers
+   * @returns the average and the largest memory used per router
+   */
+  static std::string GetMemoryUsage (const std::vector<SPFRoot> &roots);
+
+  GlobalRouteManagerLSDBSnapshot *m_snapshot; //!< the LSDB snapshot of the last calculation, or 0
+  uint32_t m_nCalculated; //!< the number of routers whose SPF calculation was run by the last calculation
+  std::map<uint32_t, SPFTree> m_trees; //!< the SPF trees of the routers, by node ID
+
+  class SPFTask;
+
   /**
    * \brief Test if a node is a stub, from an OSPF sense.
    *
@@ -65,6 +65,14 @@ public:
  */
   static void InitializeRoutes ();
 
+/**
+ * @brief Rebuild the routing database and update the per-node forwarding
+ * tables, as DeleteGlobalRoutes (), BuildGlobalRoutingDatabase () and
+ * InitializeRoutes () do, but only recomputing the routes which may have
+ * changed.
+ */
+  static void UpdateGlobalRoutes ();
+
 private:
 /**
  * @brief Global Route Manager copy construction is disallowed.  There's no 
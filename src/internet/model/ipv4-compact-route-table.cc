@@ -0,0 +1,337 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <algorithm>
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ipv4-compact-route-table.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ipv4CompactRouteTable");
+
+Ipv4CompactRouteTable::Ipv4CompactRouteTable ()
+  : m_n (0),
+    m_lastNextHop (0),
+    m_indexValid (false)
+{
+}
+
+void
+Ipv4CompactRouteTable::Clear (void)
+{
+  m_runs.clear ();
+  m_offsets.clear ();
+  m_n = 0;
+  m_nextHops.clear ();
+  m_nextHopIds.clear ();
+  m_masks.clear ();
+  m_indexValid = false;
+}
+
+uint32_t
+Ipv4CompactRouteTable::GetN (void) const
+{
+  return m_n;
+}
+
+uint64_t
+Ipv4CompactRouteTable::GetBlockSize (Ipv4Mask mask)
+{
+  uint32_t hostBits = ~mask.Get ();
+  if (hostBits == 0xffffffff || (hostBits & (hostBits + 1)) != 0)
+    {
+      return 0;
+    }
+  return static_cast<uint64_t> (hostBits) + 1;
+}
+
+Ipv4CompactRouteTable::Run
+Ipv4CompactRouteTable::Encode (const Ipv4RoutingTableEntry &route)
+{
+  Ipv4Address gateway = route.GetGateway ();
+  uint32_t interface = route.GetInterface ();
+  Ipv4Mask mask = route.GetDestNetworkMask ();
+  // The routes through a next hop are usually consecutive
+  if (m_lastNextHop >= m_nextHops.size ()
+      || m_nextHops[m_lastNextHop].first != gateway
+      || m_nextHops[m_lastNextHop].second != interface)
+    {
+      std::pair<uint32_t, uint32_t> key (gateway.Get (), interface);
+      std::map<std::pair<uint32_t, uint32_t>, uint32_t>::const_iterator hop = m_nextHopIds.find (key);
+      if (hop == m_nextHopIds.end ())
+        {
+          NS_ABORT_MSG_IF (m_nextHops.size () >= (1 << 24), "Too many next hops in a compact route table");
+          hop = m_nextHopIds.insert (std::make_pair (key, m_nextHops.size ())).first;
+          m_nextHops.push_back (std::make_pair (gateway, interface));
+        }
+      m_lastNextHop = hop->second;
+    }
+  uint32_t maskIndex = std::find (m_masks.begin (), m_masks.end (), mask) - m_masks.begin ();
+  if (maskIndex == m_masks.size ())
+    {
+      NS_ABORT_MSG_IF (maskIndex >= (1 << 8), "Too many masks in a compact route table");
+      m_masks.push_back (mask);
+    }
+  Run run;
+  run.address = route.GetDest ().Get ();
+  run.count = 1;
+  run.nextHop = m_lastNextHop;
+  run.mask = maskIndex;
+  return run;
+}
+
+Ipv4RoutingTableEntry
+Ipv4CompactRouteTable::Decode (const Run &run, uint32_t j) const
+{
+  uint32_t address = run.address + static_cast<uint32_t> (j * GetBlockSize (m_masks[run.mask]));
+  const std::pair<Ipv4Address, uint32_t> &hop = m_nextHops[run.nextHop];
+  return Ipv4RoutingTableEntry::CreateNetworkRouteTo (Ipv4Address (address), m_masks[run.mask],
+                                                      hop.first, hop.second);
+}
+
+bool
+Ipv4CompactRouteTable::Extends (const Run &run, const Run &next) const
+{
+  if (next.nextHop != run.nextHop || next.mask != run.mask)
+    {
+      return false;
+    }
+  uint64_t block = GetBlockSize (m_masks[run.mask]);
+  return block != 0
+         && (run.address & m_masks[run.mask].Get ()) == run.address
+         && run.address + run.count * block == next.address;
+}
+
+uint32_t
+Ipv4CompactRouteTable::FindRun (uint32_t i) const
+{
+  NS_ASSERT (i < m_n);
+  return std::upper_bound (m_offsets.begin (), m_offsets.end (), i) - m_offsets.begin () - 1;
+}
+
+Ipv4RoutingTableEntry
+Ipv4CompactRouteTable::Get (uint32_t i) const
+{
+  NS_ASSERT_MSG (i < m_n, "Route index out of bounds");
+  uint32_t r = FindRun (i);
+  return Decode (m_runs[r], i - m_offsets[r]);
+}
+
+void
+Ipv4CompactRouteTable::Add (const Ipv4RoutingTableEntry &route)
+{
+  Run run = Encode (route);
+  if (!m_runs.empty () && Extends (m_runs.back (), run))
+    {
+      m_runs.back ().count++;
+    }
+  else
+    {
+      m_offsets.push_back (m_n);
+      m_runs.push_back (run);
+    }
+  m_n++;
+  m_indexValid = false;
+}
+
+void
+Ipv4CompactRouteTable::Remove (uint32_t i)
+{
+  NS_ASSERT_MSG (i < m_n, "Route index out of bounds");
+  Replace (i, 1, std::vector<Ipv4RoutingTableEntry> ());
+}
+
+bool
+Ipv4CompactRouteTable::Replace (uint32_t first, uint32_t n, const std::vector<Ipv4RoutingTableEntry> &routes)
+{
+  NS_LOG_FUNCTION (this << first << n << routes.size ());
+  NS_ASSERT_MSG (first + n <= m_n, "Route range out of bounds");
+  if (first == 0 && n == m_n)
+    {
+      // The tables of next hops and masks are rebuilt with the routes
+      if (routes.size () == m_n)
+        {
+          uint32_t k = 0;
+          for (std::size_t r = 0; r < m_runs.size () && k < m_n; r++)
+            {
+              for (uint32_t j = 0; j < m_runs[r].count && k < m_n; j++, k++)
+                {
+                  if (!(Decode (m_runs[r], j) == routes[k]))
+                    {
+                      k = m_n + 1;
+                    }
+                }
+            }
+          if (k == m_n)
+            {
+              return false;
+            }
+        }
+      Clear ();
+      for (std::size_t k = 0; k < routes.size (); k++)
+        {
+          Add (routes[k]);
+        }
+      m_runs.shrink_to_fit ();
+      m_offsets.shrink_to_fit ();
+      return true;
+    }
+
+  // Decode the runs of the range, with the runs before and after it so that
+  // the new routes are merged with them
+  uint32_t a = (first > 0) ? FindRun (first - 1) : 0;
+  uint32_t b = (first + n < m_n) ? FindRun (first + n) + 1 : m_runs.size ();
+  uint32_t start = m_offsets[a];
+  std::vector<Ipv4RoutingTableEntry> before;
+  for (uint32_t r = a; r < b; r++)
+    {
+      for (uint32_t j = 0; j < m_runs[r].count; j++)
+        {
+          before.push_back (Decode (m_runs[r], j));
+        }
+    }
+  std::vector<Ipv4RoutingTableEntry> after (before.begin (), before.begin () + (first - start));
+  after.insert (after.end (), routes.begin (), routes.end ());
+  after.insert (after.end (), before.begin () + (first + n - start), before.end ());
+  if (after == before)
+    {
+      return false;
+    }
+
+  std::vector<Run> runs;
+  for (std::size_t k = 0; k < after.size (); k++)
+    {
+      Run run = Encode (after[k]);
+      if (!runs.empty () && Extends (runs.back (), run))
+        {
+          runs.back ().count++;
+        }
+      else
+        {
+          runs.push_back (run);
+        }
+    }
+  m_runs.erase (m_runs.begin () + a, m_runs.begin () + b);
+  m_runs.insert (m_runs.begin () + a, runs.begin (), runs.end ());
+  m_n = m_n - n + routes.size ();
+  m_offsets.resize (m_runs.size ());
+  for (uint32_t r = a; r < m_runs.size (); r++)
+    {
+      m_offsets[r] = (r == 0) ? 0 : m_offsets[r - 1] + m_runs[r - 1].count;
+    }
+  m_indexValid = false;
+  return true;
+}
+
+void
+Ipv4CompactRouteTable::UpdateIndex (void) const
+{
+  if (m_indexValid)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  m_index.resize (m_runs.size ());
+  m_maxCount.assign (m_masks.size (), 0);
+  for (uint32_t r = 0; r < m_runs.size (); r++)
+    {
+      m_index[r] = r;
+      m_maxCount[m_runs[r].mask] = std::max (m_maxCount[m_runs[r].mask], m_runs[r].count);
+    }
+  // The runs are sorted by mask, then by prefix, then in list order
+  std::sort (m_index.begin (), m_index.end (),
+             [this] (uint32_t a, uint32_t b)
+             {
+               const Run &x = m_runs[a];
+               const Run &y = m_runs[b];
+               uint32_t xPrefix = x.address & m_masks[x.mask].Get ();
+               uint32_t yPrefix = y.address & m_masks[y.mask].Get ();
+               return x.mask < y.mask || (x.mask == y.mask && (xPrefix < yPrefix || (xPrefix == yPrefix && a < b)));
+             });
+  m_index.shrink_to_fit ();
+  m_indexValid = true;
+}
+
+void
+Ipv4CompactRouteTable::Lookup (Ipv4Address dest, std::vector<Ipv4RoutingTableEntry> &routes) const
+{
+  NS_LOG_FUNCTION (this << dest);
+  UpdateIndex ();
+  m_matches.clear ();
+  for (uint32_t m = 0; m < m_masks.size (); m++)
+    {
+      if (m_maxCount[m] == 0)
+        {
+          continue;
+        }
+      uint32_t mask = m_masks[m].Get ();
+      uint64_t block = GetBlockSize (m_masks[m]);
+      uint32_t target = dest.Get () & mask;
+      // The runs which may contain the prefix of the destination start at
+      // most the length of the largest run before it
+      uint64_t span = (m_maxCount[m] - 1) * block;
+      uint32_t low = (target > span) ? target - span : 0;
+      std::vector<uint32_t>::const_iterator i =
+        std::lower_bound (m_index.begin (), m_index.end (), low,
+                          [this, m] (uint32_t r, uint32_t prefix)
+                          {
+                            const Run &run = m_runs[r];
+                            return run.mask < m || (run.mask == m && (run.address & m_masks[m].Get ()) < prefix);
+                          });
+      for (; i != m_index.end (); i++)
+        {
+          const Run &run = m_runs[*i];
+          if (run.mask != m || (run.address & mask) > target)
+            {
+              break;
+            }
+          uint64_t offset = target - (run.address & mask);
+          if (offset == 0)
+            {
+              m_matches.push_back (m_offsets[*i]);
+            }
+          else if (block != 0 && offset % block == 0 && offset / block < run.count)
+            {
+              m_matches.push_back (m_offsets[*i] + offset / block);
+            }
+        }
+    }
+  std::sort (m_matches.begin (), m_matches.end ());
+  for (std::size_t k = 0; k < m_matches.size (); k++)
+    {
+      routes.push_back (Get (m_matches[k]));
+    }
+}
+
+std::size_t
+Ipv4CompactRouteTable::GetMemoryUsage (void) const
+{
+  typedef std::map<std::pair<uint32_t, uint32_t>, uint32_t>::value_type NextHopId;
+  return sizeof (*this)
+         + m_runs.capacity () * sizeof (Run)
+         + m_offsets.capacity () * sizeof (uint32_t)
+         + m_nextHops.capacity () * sizeof (std::pair<Ipv4Address, uint32_t>)
+         + m_nextHopIds.size () * (sizeof (NextHopId) + 4 * sizeof (void *))
+         + m_masks.capacity () * sizeof (Ipv4Mask)
+         + m_index.capacity () * sizeof (uint32_t)
+         + m_maxCount.capacity () * sizeof (uint32_t)
+         + m_matches.capacity () * sizeof (uint32_t);
+}
+
+} // namespace ns3
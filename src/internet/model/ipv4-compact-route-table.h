@@ -0,0 +1,171 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef IPV4_COMPACT_ROUTE_TABLE_H
+#define IPV4_COMPACT_ROUTE_TABLE_H
+
+#include <stdint.h>
+#include <map>
+#include <utility>
+#include <vector>
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-routing-table-entry.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief A list of IPv4 unicast routes stored as compact arrays.
+ *
+ * The gateways and interfaces of the routes are stored once in a table of
+ * next hops, and their masks in a table of masks, so that a route is stored
+ * as its destination address and the indices of its next hop and mask.
+ * Consecutive routes to contiguous prefixes of the same length through the
+ * same next hop, such as the routes to the subnets allocated in sequence to
+ * the links of a router, are stored as a single run.
+ *
+ * The list has the semantics of a list of Ipv4RoutingTableEntry: the routes
+ * are accessed by their position, and the lookup of a destination returns
+ * all the matching routes, in list order.  The routes are looked up in an
+ * index of the runs sorted by prefix, which is rebuilt by the first lookup
+ * after a change of the list.
+ */
+class Ipv4CompactRouteTable
+{
+public:
+  Ipv4CompactRouteTable ();
+
+  /**
+   * \brief Remove all the routes.
+   */
+  void Clear (void);
+
+  /**
+   * \returns the number of routes
+   */
+  uint32_t GetN (void) const;
+
+  /**
+   * \param i the position of the route
+   * \returns a copy of the route
+   */
+  Ipv4RoutingTableEntry Get (uint32_t i) const;
+
+  /**
+   * \brief Add a route at the end of the list.
+   * \param route the route
+   */
+  void Add (const Ipv4RoutingTableEntry &route);
+
+  /**
+   * \brief Remove a route.
+   * \param i the position of the route
+   */
+  void Remove (uint32_t i);
+
+  /**
+   * \brief Replace a range of routes.
+   * \param first the position of the first route of the range
+   * \param n the number of routes of the range
+   * \param routes the routes which replace the range
+   * \returns true if the list was changed
+   */
+  bool Replace (uint32_t first, uint32_t n, const std::vector<Ipv4RoutingTableEntry> &routes);
+
+  /**
+   * \brief Find the routes whose prefix matches a destination.
+   * \param dest the destination
+   * \param routes the vector to which the matching routes are appended, in
+   * list order
+   */
+  void Lookup (Ipv4Address dest, std::vector<Ipv4RoutingTableEntry> &routes) const;
+
+  /**
+   * \returns the approximate number of bytes used by the routes and their
+   * index, not counting the overhead of the memory allocator
+   */
+  std::size_t GetMemoryUsage (void) const;
+
+private:
+  /// Consecutive routes to contiguous prefixes through the same next hop
+  struct Run
+  {
+    uint32_t address;      //!< the destination of the first route
+    uint32_t count;        //!< the number of routes
+    uint32_t nextHop : 24; //!< the index of the next hop of the routes
+    uint32_t mask : 8;     //!< the index of the mask of the routes
+  };
+
+  /**
+   * \param mask a mask
+   * \returns the number of addresses of a prefix of a contiguous mask, or
+   * zero if the mask is not contiguous or has no bit set
+   */
+  static uint64_t GetBlockSize (Ipv4Mask mask);
+
+  /**
+   * \brief Encode a route, adding its next hop and mask to their tables.
+   * \param route the route
+   * \returns a run of one route
+   */
+  Run Encode (const Ipv4RoutingTableEntry &route);
+
+  /**
+   * \param run a run
+   * \param j the index of a route in the run
+   * \returns the route
+   */
+  Ipv4RoutingTableEntry Decode (const Run &run, uint32_t j) const;
+
+  /**
+   * \param run a run
+   * \param next a run of one route
+   * \returns true if the route of next is the one following the routes of run
+   */
+  bool Extends (const Run &run, const Run &next) const;
+
+  /**
+   * \param i the position of a route
+   * \returns the index of the run of the route
+   */
+  uint32_t FindRun (uint32_t i) const;
+
+  /**
+   * \brief Rebuild the index of the runs if the list has changed.
+   */
+  void UpdateIndex (void) const;
+
+  std::vector<Run> m_runs;          //!< the runs, in list order
+  std::vector<uint32_t> m_offsets;  //!< the position of the first route of each run
+  uint32_t m_n;                     //!< the number of routes
+  /// the gateway and interface of each next hop
+  std::vector<std::pair<Ipv4Address, uint32_t> > m_nextHops;
+  /// the index of each next hop, by gateway and interface
+  std::map<std::pair<uint32_t, uint32_t>, uint32_t> m_nextHopIds;
+  uint32_t m_lastNextHop;           //!< the index of the next hop of the last encoded route
+  std::vector<Ipv4Mask> m_masks;    //!< the masks
+
+  mutable bool m_indexValid;                //!< true if the index matches the runs
+  mutable std::vector<uint32_t> m_index;    //!< the runs sorted by mask and prefix
+  mutable std::vector<uint32_t> m_maxCount; //!< the largest run of each mask
+  mutable std::vector<uint32_t> m_matches;  //!< lookup buffer
+};
+
+} // namespace ns3
+
+#endif /* IPV4_COMPACT_ROUTE_TABLE_H */
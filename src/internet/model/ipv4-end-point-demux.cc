@@ -18,6 +18,8 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 
+#include <algorithm>
+#include <functional>
 #include "ipv4-end-point-demux.h"
 #include "ipv4-end-point.h"
 #include "ipv4-interface-address.h"
@@ -28,6 +30,34 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Ipv4EndPointDemux");
 
+bool
+Ipv4EndPointDemux::Tuple::operator == (const Tuple &other) const
+{
+  return localAddress == other.localAddress && peerAddress == other.peerAddress
+         && localPort == other.localPort && peerPort == other.peerPort;
+}
+
+bool
+Ipv4EndPointDemux::Local::operator == (const Local &other) const
+{
+  return address == other.address && port == other.port && device == other.device;
+}
+
+std::size_t
+Ipv4EndPointDemux::TupleHash::operator () (const Tuple &x) const
+{
+  uint64_t addresses = (static_cast<uint64_t> (x.localAddress.Get ()) << 32) | x.peerAddress.Get ();
+  uint64_t ports = (static_cast<uint64_t> (x.localPort) << 16) | x.peerPort;
+  return std::hash<uint64_t> () (addresses ^ (ports * 0x9e3779b97f4a7c15ULL));
+}
+
+std::size_t
+Ipv4EndPointDemux::LocalHash::operator () (const Local &x) const
+{
+  uint64_t key = (static_cast<uint64_t> (x.address.Get ()) << 16) | x.port;
+  return std::hash<uint64_t> () (key) ^ std::hash<NetDevice *> () (x.device);
+}
+
 Ipv4EndPointDemux::Ipv4EndPointDemux ()
   : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152)
 {
@@ -40,39 +70,94 @@ Ipv4EndPointDemux::~Ipv4EndPointDemux ()
   for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
     {
       Ipv4EndPoint *endPoint = *i;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
   m_endPoints.clear ();
+  m_entries.clear ();
+  m_tuples.clear ();
+  m_locals.clear ();
+  m_ports.clear ();
 }
 
 bool
 Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
 {
   NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
-    {
-      if ((*i)->GetLocalPort  () == port) 
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_ports.find (port) != m_ports.end ();
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal (Ptr<NetDevice> boundNetDevice, Ipv4Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  Local local;
+  local.address = addr;
+  local.port = port;
+  local.device = PeekPointer (boundNetDevice);
+  return m_locals.find (local) != m_locals.end ();
+}
+
+Ipv4EndPoint *
+Ipv4EndPointDemux::Insert (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  Entry &entry = m_entries[endPoint];
+  entry.position = m_endPoints.insert (m_endPoints.end (), endPoint);
+  Index (endPoint, entry);
+  endPoint->m_demux = this;
+  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  return endPoint;
+}
+
+void
+Ipv4EndPointDemux::Index (Ipv4EndPoint *endPoint, Entry &entry)
+{
+  entry.tuple.localAddress = endPoint->GetLocalAddress ();
+  entry.tuple.peerAddress = endPoint->GetPeerAddress ();
+  entry.tuple.localPort = endPoint->GetLocalPort ();
+  entry.tuple.peerPort = endPoint->GetPeerPort ();
+  entry.local.address = entry.tuple.localAddress;
+  entry.local.port = entry.tuple.localPort;
+  entry.local.device = PeekPointer (endPoint->GetBoundNetDevice ());
+  m_tuples[entry.tuple].push_back (endPoint);
+  m_locals[entry.local]++;
+  m_ports[entry.local.port]++;
+}
+
+void
+Ipv4EndPointDemux::Unindex (Ipv4EndPoint *endPoint, const Entry &entry)
+{
+  std::unordered_map<Tuple, std::vector<Ipv4EndPoint *>, TupleHash>::iterator tuple = m_tuples.find (entry.tuple);
+  NS_ASSERT (tuple != m_tuples.end ());
+  std::vector<Ipv4EndPoint *> &endPoints = tuple->second;
+  endPoints.erase (std::find (endPoints.begin (), endPoints.end (), endPoint));
+  if (endPoints.empty ())
     {
-      if ((*i)->GetLocalPort () == port &&
-          (*i)->GetLocalAddress () == addr &&
-          (*i)->GetBoundNetDevice () == boundNetDevice)
-        {
-          return true;
-        }
+      m_tuples.erase (tuple);
     }
-  return false;
+  std::unordered_map<Local, uint32_t, LocalHash>::iterator local = m_locals.find (entry.local);
+  NS_ASSERT (local != m_locals.end ());
+  if (--local->second == 0)
+    {
+      m_locals.erase (local);
+    }
+  std::unordered_map<uint16_t, uint32_t>::iterator port = m_ports.find (entry.local.port);
+  NS_ASSERT (port != m_ports.end ());
+  if (--port->second == 0)
+    {
+      m_ports.erase (port);
+    }
+}
+
+void
+Ipv4EndPointDemux::Reindex (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  std::unordered_map<Ipv4EndPoint *, Entry>::iterator entry = m_entries.find (endPoint);
+  NS_ASSERT (entry != m_entries.end ());
+  Unindex (endPoint, entry->second);
+  Index (endPoint, entry->second);
 }
 
 Ipv4EndPoint *
@@ -85,10 +170,7 @@ Ipv4EndPointDemux::Allocate (void)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (Ipv4Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (Ipv4Address::GetAny (), port));
 }
 
 Ipv4EndPoint *
@@ -101,10 +183,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (address, port));
 }
 
 Ipv4EndPoint *
@@ -124,10 +203,7 @@ Ipv4EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice, Ipv4Address address,
       NS_LOG_WARN ("Duplicated endpoint.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (address, port));
 }
 
 Ipv4EndPoint *
@@ -136,40 +212,42 @@ Ipv4EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
                              Ipv4Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort << boundNetDevice);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  Tuple tuple;
+  tuple.localAddress = localAddress;
+  tuple.peerAddress = peerAddress;
+  tuple.localPort = localPort;
+  tuple.peerPort = peerPort;
+  std::unordered_map<Tuple, std::vector<Ipv4EndPoint *>, TupleHash>::const_iterator same = m_tuples.find (tuple);
+  if (same != m_tuples.end ())
     {
-      if ((*i)->GetLocalPort () == localPort &&
-          (*i)->GetLocalAddress () == localAddress &&
-          (*i)->GetPeerPort () == peerPort &&
-          (*i)->GetPeerAddress () == peerAddress &&
-          ((*i)->GetBoundNetDevice () == boundNetDevice || (*i)->GetBoundNetDevice () == 0))
+      for (std::vector<Ipv4EndPoint *>::const_iterator i = same->second.begin (); i != same->second.end (); i++)
         {
-          NS_LOG_WARN ("Duplicated endpoint.");
-          return 0;
+          if ((*i)->GetBoundNetDevice () == boundNetDevice || (*i)->GetBoundNetDevice () == 0)
+            {
+              NS_LOG_WARN ("Duplicated endpoint.");
+              return 0;
+            }
         }
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
-  return endPoint;
+  return Insert (endPoint);
 }
 
 void 
 Ipv4EndPointDemux::DeAllocate (Ipv4EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this << endPoint);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  std::unordered_map<Ipv4EndPoint *, Entry>::iterator entry = m_entries.find (endPoint);
+  if (entry == m_entries.end ())
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      return;
     }
+  Unindex (endPoint, entry->second);
+  m_endPoints.erase (entry->second.position);
+  m_entries.erase (entry);
+  endPoint->m_demux = 0;
+  delete endPoint;
 }
 
 /*
@@ -208,7 +286,46 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
   EndPoints retval4; // Exact match on all 4
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr << ":" << dport);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+
+  // Only the endpoints bound to the destination address, to the any address
+  // or to the network address of an address of the incoming interface, and
+  // connected to the source or to no peer, can match
+  std::vector<Ipv4Address> localAddresses (1, daddr);
+  if (daddr != Ipv4Address::GetAny ())
+    {
+      localAddresses.push_back (Ipv4Address::GetAny ());
+    }
+  for (uint32_t i = 0; incomingInterface && i < incomingInterface->GetNAddresses (); i++)
+    {
+      Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
+      Ipv4Address addrNetpart = addr.GetLocal ().CombineMask (addr.GetMask ());
+      if (std::find (localAddresses.begin (), localAddresses.end (), addrNetpart) == localAddresses.end ())
+        {
+          localAddresses.push_back (addrNetpart);
+        }
+    }
+  EndPoints candidates;
+  Tuple tuple;
+  tuple.localPort = dport;
+  for (std::vector<Ipv4Address>::const_iterator local = localAddresses.begin (); local != localAddresses.end (); local++)
+    {
+      tuple.localAddress = *local;
+      for (uint32_t peer = 0; peer < (saddr == Ipv4Address::GetAny () ? 1 : 2); peer++)
+        {
+          tuple.peerAddress = (peer == 0) ? saddr : Ipv4Address::GetAny ();
+          for (uint32_t port = 0; port < (sport == 0 ? 1 : 2); port++)
+            {
+              tuple.peerPort = (port == 0) ? sport : 0;
+              std::unordered_map<Tuple, std::vector<Ipv4EndPoint *>, TupleHash>::const_iterator found = m_tuples.find (tuple);
+              if (found != m_tuples.end ())
+                {
+                  candidates.insert (candidates.end (), found->second.begin (), found->second.end ());
+                }
+            }
+        }
+    }
+
+  for (EndPointsI i = candidates.begin (); i != candidates.end (); i++) 
     {
       Ipv4EndPoint* endP = *i;
 
@@ -343,6 +460,19 @@ Ipv4EndPointDemux::SimpleLookup (Ipv4Address daddr,
 {
   NS_LOG_FUNCTION (this << daddr << dport << saddr << sport);
 
+  // An exact match is found in the index, unless several endpoints which
+  // differ by their NetDevice match exactly
+  Tuple tuple;
+  tuple.localAddress = daddr;
+  tuple.peerAddress = saddr;
+  tuple.localPort = dport;
+  tuple.peerPort = sport;
+  std::unordered_map<Tuple, std::vector<Ipv4EndPoint *>, TupleHash>::const_iterator exact = m_tuples.find (tuple);
+  if (exact != m_tuples.end () && exact->second.size () == 1)
+    {
+      return exact->second.front ();
+    }
+
   // this code is a copy/paste version of an old BSD ip stack lookup
   // function.
   uint32_t genericity = 3;
@@ -23,6 +23,8 @@
 
 #include <stdint.h>
 #include <list>
+#include <unordered_map>
+#include <vector>
 #include "ns3/ipv4-address.h"
 #include "ipv4-interface.h"
 
@@ -40,6 +42,12 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * The endpoints are indexed in hash tables by their four-tuple and by their
+ * local address and port, so that the lookup of a packet only visits the
+ * endpoints whose addresses and ports may match it, rather than all the
+ * endpoints of the node.  The endpoints update the index when their
+ * addresses, ports or bound NetDevice change.
  */
 
 class Ipv4EndPointDemux {
@@ -166,6 +174,103 @@ public:
   void DeAllocate (Ipv4EndPoint *endPoint);
 
 private:
+  friend class Ipv4EndPoint;
+
+  /**
+   * \brief The four-tuple of an endpoint.
+   */
+  struct Tuple
+  {
+    Ipv4Address localAddress; //!< the local address
+    Ipv4Address peerAddress;  //!< the peer address
+    uint16_t localPort;       //!< the local port
+    uint16_t peerPort;        //!< the peer port
+
+    /**
+     * \param other the other tuple
+     * \returns true if both tuples are equal
+     */
+    bool operator == (const Tuple &other) const;
+  };
+
+  /**
+   * \brief The local address and port of an endpoint, and its bound NetDevice.
+   */
+  struct Local
+  {
+    Ipv4Address address; //!< the local address
+    uint16_t port;       //!< the local port
+    NetDevice *device;   //!< the bound NetDevice, or 0
+
+    /**
+     * \param other the other key
+     * \returns true if both keys are equal
+     */
+    bool operator == (const Local &other) const;
+  };
+
+  /**
+   * \brief Hash function of the four-tuples.
+   */
+  struct TupleHash
+  {
+    /**
+     * \param x the tuple
+     * \returns the hash of the tuple
+     */
+    std::size_t operator () (const Tuple &x) const;
+  };
+
+  /**
+   * \brief Hash function of the local keys.
+   */
+  struct LocalHash
+  {
+    /**
+     * \param x the key
+     * \returns the hash of the key
+     */
+    std::size_t operator () (const Local &x) const;
+  };
+
+  /**
+   * \brief The position of an endpoint in the list, and the keys it is
+   * indexed with.
+   */
+  struct Entry
+  {
+    EndPointsI position; //!< the position in m_endPoints
+    Tuple tuple;         //!< the four-tuple
+    Local local;         //!< the local address, port and NetDevice
+  };
+
+  /**
+   * \brief Add an endpoint at the end of the list, and index it.
+   * \param endPoint the endpoint
+   * \return the endpoint
+   */
+  Ipv4EndPoint *Insert (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Index an endpoint with its current addresses, ports and NetDevice.
+   * \param endPoint the endpoint
+   * \param entry the entry of the endpoint, whose keys are set
+   */
+  void Index (Ipv4EndPoint *endPoint, Entry &entry);
+
+  /**
+   * \brief Remove an endpoint from the index.
+   * \param endPoint the endpoint
+   * \param entry the entry of the endpoint
+   */
+  void Unindex (Ipv4EndPoint *endPoint, const Entry &entry);
+
+  /**
+   * \brief Update the index after a change of the addresses, ports or
+   * NetDevice of an endpoint.
+   * \param endPoint the endpoint
+   */
+  void Reindex (Ipv4EndPoint *endPoint);
 
   /**
    * \brief Allocate an ephemeral port.
@@ -192,6 +297,26 @@ private:
    * \brief A list of IPv4 end points.
    */
   EndPoints m_endPoints;
+
+  /**
+   * \brief The entry of each endpoint.
+   */
+  std::unordered_map<Ipv4EndPoint *, Entry> m_entries;
+
+  /**
+   * \brief The endpoints of each four-tuple.
+   */
+  std::unordered_map<Tuple, std::vector<Ipv4EndPoint *>, TupleHash> m_tuples;
+
+  /**
+   * \brief The number of endpoints of each local address, port and NetDevice.
+   */
+  std::unordered_map<Local, uint32_t, LocalHash> m_locals;
+
+  /**
+   * \brief The number of endpoints of each local port.
+   */
+  std::unordered_map<uint16_t, uint32_t> m_ports;
 };
 
 } // namespace ns3
@@ -16,6 +16,7 @@
 // Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 //
 
+#include <algorithm>
 #include <vector>
 #include <iomanip>
 #include "ns3/names.h"
@@ -27,6 +28,7 @@
 #include "ns3/ipv4-route.h"
 #include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/boolean.h"
+#include "ns3/abort.h"
 #include "ns3/node.h"
 #include "ipv4-global-routing.h"
 #include "global-route-manager.h"
@@ -53,13 +55,25 @@ Ipv4GlobalRouting::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&Ipv4GlobalRouting::m_respondToInterfaceEvents),
                    MakeBooleanChecker ())
+    .AddAttribute ("CompactRoutes",
+                   "Set to true to store the routes in compact tables of destinations and next hop indices, "
+                   "which use less memory than the default routing table entries; this can only be changed "
+                   "while the routing table is empty",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Ipv4GlobalRouting::SetCompactRoutes,
+                                        &Ipv4GlobalRouting::GetCompactRoutes),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 Ipv4GlobalRouting::Ipv4GlobalRouting () 
   : m_randomEcmpRouting (false),
-    m_respondToInterfaceEvents (false)
+    m_respondToInterfaceEvents (false),
+    m_indexValid (false),
+    m_indexUsable (false),
+    m_indexPosition (0),
+    m_compactRoutes (false)
 {
   NS_LOG_FUNCTION (this);
 
@@ -77,9 +91,15 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
                                    uint32_t interface)
 {
   NS_LOG_FUNCTION (this << dest << nextHop << interface);
-  Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
-  *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, nextHop, interface);
-  m_hostRoutes.push_back (route);
+  Ipv4RoutingTableEntry route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, nextHop, interface);
+  if (m_compactRoutes)
+    {
+      m_compactHostRoutes.Add (route);
+      return;
+    }
+  Ipv4RoutingTableEntry *entry = new Ipv4RoutingTableEntry (route);
+  m_hostRoutes.push_back (entry);
+  AddToIndex (entry, 0);
 }
 
 void 
@@ -87,9 +107,15 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
                                    uint32_t interface)
 {
   NS_LOG_FUNCTION (this << dest << interface);
-  Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
-  *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, interface);
-  m_hostRoutes.push_back (route);
+  Ipv4RoutingTableEntry route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, interface);
+  if (m_compactRoutes)
+    {
+      m_compactHostRoutes.Add (route);
+      return;
+    }
+  Ipv4RoutingTableEntry *entry = new Ipv4RoutingTableEntry (route);
+  m_hostRoutes.push_back (entry);
+  AddToIndex (entry, 0);
 }
 
 void 
@@ -99,12 +125,18 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                       uint32_t interface)
 {
   NS_LOG_FUNCTION (this << network << networkMask << nextHop << interface);
-  Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
-  *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
-                                                        networkMask,
-                                                        nextHop,
-                                                        interface);
-  m_networkRoutes.push_back (route);
+  Ipv4RoutingTableEntry route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
+                                                                             networkMask,
+                                                                             nextHop,
+                                                                             interface);
+  if (m_compactRoutes)
+    {
+      m_compactNetworkRoutes.Add (route);
+      return;
+    }
+  Ipv4RoutingTableEntry *entry = new Ipv4RoutingTableEntry (route);
+  m_networkRoutes.push_back (entry);
+  AddToIndex (entry, &m_networkIndex);
 }
 
 void 
@@ -113,11 +145,17 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                       uint32_t interface)
 {
   NS_LOG_FUNCTION (this << network << networkMask << interface);
-  Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
-  *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
-                                                        networkMask,
-                                                        interface);
-  m_networkRoutes.push_back (route);
+  Ipv4RoutingTableEntry route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
+                                                                             networkMask,
+                                                                             interface);
+  if (m_compactRoutes)
+    {
+      m_compactNetworkRoutes.Add (route);
+      return;
+    }
+  Ipv4RoutingTableEntry *entry = new Ipv4RoutingTableEntry (route);
+  m_networkRoutes.push_back (entry);
+  AddToIndex (entry, &m_networkIndex);
 }
 
 void 
@@ -127,12 +165,18 @@ Ipv4GlobalRouting::AddASExternalRouteTo (Ipv4Address network,
                                          uint32_t interface)
 {
   NS_LOG_FUNCTION (this << network << networkMask << nextHop << interface);
-  Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
-  *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
-                                                        networkMask,
-                                                        nextHop,
-                                                        interface);
-  m_ASexternalRoutes.push_back (route);
+  Ipv4RoutingTableEntry route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
+                                                                             networkMask,
+                                                                             nextHop,
+                                                                             interface);
+  if (m_compactRoutes)
+    {
+      m_compactExternalRoutes.Add (route);
+      return;
+    }
+  Ipv4RoutingTableEntry *entry = new Ipv4RoutingTableEntry (route);
+  m_ASexternalRoutes.push_back (entry);
+  AddToIndex (entry, &m_externalIndex);
 }
 
 
@@ -146,71 +190,87 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
   typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
   RouteVec_t allRoutes;
 
-  NS_LOG_LOGIC ("Number of m_hostRoutes = " << m_hostRoutes.size ());
-  for (HostRoutesCI i = m_hostRoutes.begin (); 
-       i != m_hostRoutes.end (); 
-       i++) 
+  if (m_compactRoutes)
     {
-      NS_ASSERT ((*i)->IsHost ());
-      if ((*i)->GetDest () == dest)
+      m_compactFound.clear ();
+      LookupCompact (dest, oif, m_compactFound);
+      for (std::size_t i = 0; i < m_compactFound.size (); i++)
         {
-          if (oif != 0)
-            {
-              if (oif != m_ipv4->GetNetDevice ((*i)->GetInterface ()))
-                {
-                  NS_LOG_LOGIC ("Not on requested interface, skipping");
-                  continue;
-                }
-            }
-          allRoutes.push_back (*i);
-          NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << *i); 
+          allRoutes.push_back (&m_compactFound[i]);
         }
     }
-  if (allRoutes.size () == 0) // if no host route is found
+  else if (UpdateIndex ())
+    {
+      LookupIndex (dest, oif, allRoutes);
+    }
+  else
     {
-      NS_LOG_LOGIC ("Number of m_networkRoutes" << m_networkRoutes.size ());
-      for (NetworkRoutesI j = m_networkRoutes.begin (); 
-           j != m_networkRoutes.end (); 
-           j++) 
+      NS_LOG_LOGIC ("Number of m_hostRoutes = " << m_hostRoutes.size ());
+      for (HostRoutesCI i = m_hostRoutes.begin (); 
+           i != m_hostRoutes.end (); 
+           i++) 
         {
-          Ipv4Mask mask = (*j)->GetDestNetworkMask ();
-          Ipv4Address entry = (*j)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry)) 
+          NS_ASSERT ((*i)->IsHost ());
+          if ((*i)->GetDest () == dest)
             {
               if (oif != 0)
                 {
-                  if (oif != m_ipv4->GetNetDevice ((*j)->GetInterface ()))
+                  if (oif != m_ipv4->GetNetDevice ((*i)->GetInterface ()))
                     {
                       NS_LOG_LOGIC ("Not on requested interface, skipping");
                       continue;
                     }
                 }
-              allRoutes.push_back (*j);
-              NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << *j);
+              allRoutes.push_back (*i);
+              NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << *i); 
             }
         }
-    }
-  if (allRoutes.size () == 0)  // consider external if no host/network found
-    {
-      for (ASExternalRoutesI k = m_ASexternalRoutes.begin ();
-           k != m_ASexternalRoutes.end ();
-           k++)
+      if (allRoutes.size () == 0) // if no host route is found
         {
-          Ipv4Mask mask = (*k)->GetDestNetworkMask ();
-          Ipv4Address entry = (*k)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry))
+          NS_LOG_LOGIC ("Number of m_networkRoutes" << m_networkRoutes.size ());
+          for (NetworkRoutesI j = m_networkRoutes.begin (); 
+               j != m_networkRoutes.end (); 
+               j++) 
             {
-              NS_LOG_LOGIC ("Found external route" << *k);
-              if (oif != 0)
+              Ipv4Mask mask = (*j)->GetDestNetworkMask ();
+              Ipv4Address entry = (*j)->GetDestNetwork ();
+              if (mask.IsMatch (dest, entry)) 
                 {
-                  if (oif != m_ipv4->GetNetDevice ((*k)->GetInterface ()))
+                  if (oif != 0)
                     {
-                      NS_LOG_LOGIC ("Not on requested interface, skipping");
-                      continue;
+                      if (oif != m_ipv4->GetNetDevice ((*j)->GetInterface ()))
+                        {
+                          NS_LOG_LOGIC ("Not on requested interface, skipping");
+                          continue;
+                        }
+                    }
+                  allRoutes.push_back (*j);
+                  NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << *j);
+                }
+            }
+        }
+      if (allRoutes.size () == 0)  // consider external if no host/network found
+        {
+          for (ASExternalRoutesI k = m_ASexternalRoutes.begin ();
+               k != m_ASexternalRoutes.end ();
+               k++)
+            {
+              Ipv4Mask mask = (*k)->GetDestNetworkMask ();
+              Ipv4Address entry = (*k)->GetDestNetwork ();
+              if (mask.IsMatch (dest, entry))
+                {
+                  NS_LOG_LOGIC ("Found external route" << *k);
+                  if (oif != 0)
+                    {
+                      if (oif != m_ipv4->GetNetDevice ((*k)->GetInterface ()))
+                        {
+                          NS_LOG_LOGIC ("Not on requested interface, skipping");
+                          continue;
+                        }
                     }
+                  allRoutes.push_back (*k);
+                  break;
                 }
-              allRoutes.push_back (*k);
-              break;
             }
         }
     }
@@ -245,10 +305,182 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
     }
 }
 
+/**
+ * \brief Get the prefix of a route to a network.
+ * \param route the route
+ * \param prefix the prefix bytes
+ * \param length the prefix length
+ * \returns false if the mask of the route is not contiguous
+ */
+static bool
+GetRoutePrefix (const Ipv4RoutingTableEntry *route, uint8_t prefix[4], uint8_t &length)
+{
+  Ipv4Mask mask = route->GetDestNetworkMask ();
+  length = mask.GetPrefixLength ();
+  if (mask != Ipv4Mask (length == 0 ? 0 : 0xffffffff << (32 - length)))
+    {
+      return false;
+    }
+  route->GetDestNetwork ().Serialize (prefix);
+  return true;
+}
+
+void
+Ipv4GlobalRouting::AddToIndex (Ipv4RoutingTableEntry *route, NetworkIndex *index)
+{
+  if (!m_indexValid || !m_indexUsable)
+    {
+      return;
+    }
+  IndexedRoute indexed (m_indexPosition++, route);
+  if (index == 0)
+    {
+      m_hostIndex[route->GetDest ()].push_back (indexed);
+      return;
+    }
+  uint8_t prefix[4];
+  uint8_t length;
+  if (!GetRoutePrefix (route, prefix, length))
+    {
+      m_indexUsable = false;
+      return;
+    }
+  index->Insert (prefix, length, indexed);
+}
+
+bool
+Ipv4GlobalRouting::UpdateIndex (void)
+{
+  if (m_indexValid)
+    {
+      return m_indexUsable;
+    }
+  NS_LOG_FUNCTION (this);
+  m_hostIndex.clear ();
+  m_networkIndex.Clear ();
+  m_externalIndex.Clear ();
+  m_indexValid = true;
+  m_indexUsable = true;
+  m_indexPosition = 0;
+  for (HostRoutesCI i = m_hostRoutes.begin (); i != m_hostRoutes.end (); i++)
+    {
+      AddToIndex (*i, 0);
+    }
+  for (NetworkRoutesCI j = m_networkRoutes.begin (); j != m_networkRoutes.end (); j++)
+    {
+      AddToIndex (*j, &m_networkIndex);
+    }
+  for (ASExternalRoutesCI k = m_ASexternalRoutes.begin (); k != m_ASexternalRoutes.end (); k++)
+    {
+      AddToIndex (*k, &m_externalIndex);
+    }
+  return m_indexUsable;
+}
+
+/**
+ * \brief Compare the positions of two indexed routes.
+ * \param a the first route
+ * \param b the second route
+ * \returns true if the first route is before the second one
+ */
+static bool
+IsBefore (const std::pair<uint32_t, Ipv4RoutingTableEntry *> &a,
+          const std::pair<uint32_t, Ipv4RoutingTableEntry *> &b)
+{
+  return a.first < b.first;
+}
+
+void
+Ipv4GlobalRouting::LookupIndex (Ipv4Address dest, Ptr<NetDevice> oif,
+                                std::vector<Ipv4RoutingTableEntry *> &routes)
+{
+  NS_LOG_FUNCTION (this << dest << oif);
+  // All the host routes to the destination, else all the matching network
+  // routes in table order, else the first matching external route
+  HostIndex::const_iterator host = m_hostIndex.find (dest);
+  if (host != m_hostIndex.end ())
+    {
+      for (std::size_t i = 0; i < host->second.size (); i++)
+        {
+          Ipv4RoutingTableEntry *route = host->second[i].second;
+          if (oif == 0 || oif == m_ipv4->GetNetDevice (route->GetInterface ()))
+            {
+              routes.push_back (route);
+            }
+        }
+    }
+  uint8_t address[4];
+  dest.Serialize (address);
+  for (NetworkIndex *index : {&m_networkIndex, &m_externalIndex})
+    {
+      if (!routes.empty ())
+        {
+          return;
+        }
+      m_indexMatches.clear ();
+      index->Lookup (address, m_indexMatches);
+      m_indexRoutes.clear ();
+      for (std::size_t i = 0; i < m_indexMatches.size (); i++)
+        {
+          m_indexRoutes.insert (m_indexRoutes.end (), m_indexMatches[i]->begin (), m_indexMatches[i]->end ());
+        }
+      if (m_indexMatches.size () > 1)
+        {
+          std::sort (m_indexRoutes.begin (), m_indexRoutes.end (), &IsBefore);
+        }
+      for (std::size_t i = 0; i < m_indexRoutes.size (); i++)
+        {
+          Ipv4RoutingTableEntry *route = m_indexRoutes[i].second;
+          if (oif == 0 || oif == m_ipv4->GetNetDevice (route->GetInterface ()))
+            {
+              routes.push_back (route);
+              if (index == &m_externalIndex)
+                {
+                  return;
+                }
+            }
+        }
+    }
+}
+
+void
+Ipv4GlobalRouting::LookupCompact (Ipv4Address dest, Ptr<NetDevice> oif,
+                                  std::vector<Ipv4RoutingTableEntry> &routes)
+{
+  NS_LOG_FUNCTION (this << dest << oif);
+  // All the host routes to the destination, else all the matching network
+  // routes in table order, else the first matching external route
+  for (const Ipv4CompactRouteTable *table : {&m_compactHostRoutes, &m_compactNetworkRoutes,
+                                             &m_compactExternalRoutes})
+    {
+      m_compactMatches.clear ();
+      table->Lookup (dest, m_compactMatches);
+      for (std::size_t i = 0; i < m_compactMatches.size (); i++)
+        {
+          if (oif == 0 || oif == m_ipv4->GetNetDevice (m_compactMatches[i].GetInterface ()))
+            {
+              routes.push_back (m_compactMatches[i]);
+              if (table == &m_compactExternalRoutes)
+                {
+                  return;
+                }
+            }
+        }
+      if (!routes.empty ())
+        {
+          return;
+        }
+    }
+}
+
 uint32_t 
 Ipv4GlobalRouting::GetNRoutes (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_compactRoutes)
+    {
+      return m_compactHostRoutes.GetN () + m_compactNetworkRoutes.GetN () + m_compactExternalRoutes.GetN ();
+    }
   uint32_t n = 0;
   n += m_hostRoutes.size ();
   n += m_networkRoutes.size ();
@@ -260,6 +492,23 @@ Ipv4RoutingTableEntry *
 Ipv4GlobalRouting::GetRoute (uint32_t index) const
 {
   NS_LOG_FUNCTION (this << index);
+  if (m_compactRoutes)
+    {
+      if (index < m_compactHostRoutes.GetN ())
+        {
+          m_compactRoute = m_compactHostRoutes.Get (index);
+          return &m_compactRoute;
+        }
+      index -= m_compactHostRoutes.GetN ();
+      if (index < m_compactNetworkRoutes.GetN ())
+        {
+          m_compactRoute = m_compactNetworkRoutes.Get (index);
+          return &m_compactRoute;
+        }
+      index -= m_compactNetworkRoutes.GetN ();
+      m_compactRoute = m_compactExternalRoutes.Get (index);
+      return &m_compactRoute;
+    }
   if (index < m_hostRoutes.size ())
     {
       uint32_t tmp = 0;
@@ -309,6 +558,23 @@ void
 Ipv4GlobalRouting::RemoveRoute (uint32_t index)
 {
   NS_LOG_FUNCTION (this << index);
+  if (m_compactRoutes)
+    {
+      if (index < m_compactHostRoutes.GetN ())
+        {
+          m_compactHostRoutes.Remove (index);
+          return;
+        }
+      index -= m_compactHostRoutes.GetN ();
+      if (index < m_compactNetworkRoutes.GetN ())
+        {
+          m_compactNetworkRoutes.Remove (index);
+          return;
+        }
+      index -= m_compactNetworkRoutes.GetN ();
+      m_compactExternalRoutes.Remove (index);
+      return;
+    }
   if (index < m_hostRoutes.size ())
     {
       uint32_t tmp = 0;
@@ -321,6 +587,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
               NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_hostRoutes.size ());
               delete *i;
               m_hostRoutes.erase (i);
+              m_indexValid = false;
               NS_LOG_LOGIC ("Done removing host route " << index << "; host route remaining size = " << m_hostRoutes.size ());
               return;
             }
@@ -338,6 +605,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_networkRoutes.size ());
           delete *j;
           m_networkRoutes.erase (j);
+          m_indexValid = false;
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
           return;
         }
@@ -354,6 +622,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_ASexternalRoutes.size ());
           delete *k;
           m_ASexternalRoutes.erase (k);
+          m_indexValid = false;
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
           return;
         }
@@ -362,6 +631,179 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
   NS_ASSERT (false);
 }
 
+/**
+ * \brief Replace a range of a list of routes.
+ * \param list the list of routes
+ * \param first the index of the first route of the range
+ * \param n the number of routes of the range
+ * \param routes the routes which replace the range
+ * \returns true if the list was changed
+ */
+static bool
+ReplaceRouteRange (std::list<Ipv4RoutingTableEntry *> &list, uint32_t first, uint32_t n,
+                   const std::vector<Ipv4RoutingTableEntry> &routes)
+{
+  NS_ASSERT_MSG (first + n <= list.size (), "Route range out of bounds");
+  std::list<Ipv4RoutingTableEntry *>::iterator begin = list.begin ();
+  std::advance (begin, first);
+  std::list<Ipv4RoutingTableEntry *>::iterator end = begin;
+  std::advance (end, n);
+
+  // Keep the routes which are unchanged at both ends of the range
+  std::size_t head = 0;
+  while (head < n && head < routes.size () && **begin == routes[head])
+    {
+      begin++;
+      head++;
+    }
+  std::size_t tail = 0;
+  while (tail < n - head && tail < routes.size () - head)
+    {
+      std::list<Ipv4RoutingTableEntry *>::iterator last = end;
+      last--;
+      if (!(**last == routes[routes.size () - 1 - tail]))
+        {
+          break;
+        }
+      end = last;
+      tail++;
+    }
+  if (head == n && head == routes.size ())
+    {
+      return false;
+    }
+
+  // Overwrite the changed routes, then remove or add the remaining ones
+  std::size_t k = head;
+  std::size_t kEnd = routes.size () - tail;
+  while (begin != end && k < kEnd)
+    {
+      **begin = routes[k];
+      begin++;
+      k++;
+    }
+  while (begin != end)
+    {
+      delete *begin;
+      begin = list.erase (begin);
+    }
+  for (; k < kEnd; k++)
+    {
+      list.insert (end, new Ipv4RoutingTableEntry (routes[k]));
+    }
+  return true;
+}
+
+void
+Ipv4GlobalRouting::ReplaceHostRoutes (uint32_t first, uint32_t n,
+                                      const std::vector<Ipv4RoutingTableEntry> &routes)
+{
+  NS_LOG_FUNCTION (this << first << n << routes.size ());
+  if (m_compactRoutes)
+    {
+      m_compactHostRoutes.Replace (first, n, routes);
+    }
+  else if (ReplaceRouteRange (m_hostRoutes, first, n, routes))
+    {
+      m_indexValid = false;
+    }
+}
+
+void
+Ipv4GlobalRouting::ReplaceNetworkRoutes (uint32_t first, uint32_t n,
+                                         const std::vector<Ipv4RoutingTableEntry> &routes)
+{
+  NS_LOG_FUNCTION (this << first << n << routes.size ());
+  if (m_compactRoutes)
+    {
+      m_compactNetworkRoutes.Replace (first, n, routes);
+    }
+  else if (ReplaceRouteRange (m_networkRoutes, first, n, routes))
+    {
+      m_indexValid = false;
+    }
+}
+
+void
+Ipv4GlobalRouting::ReplaceASExternalRoutes (uint32_t first, uint32_t n,
+                                            const std::vector<Ipv4RoutingTableEntry> &routes)
+{
+  NS_LOG_FUNCTION (this << first << n << routes.size ());
+  if (m_compactRoutes)
+    {
+      m_compactExternalRoutes.Replace (first, n, routes);
+    }
+  else if (ReplaceRouteRange (m_ASexternalRoutes, first, n, routes))
+    {
+      m_indexValid = false;
+    }
+}
+
+uint32_t
+Ipv4GlobalRouting::GetNHostRoutes (void) const
+{
+  if (m_compactRoutes)
+    {
+      return m_compactHostRoutes.GetN ();
+    }
+  return m_hostRoutes.size ();
+}
+
+uint32_t
+Ipv4GlobalRouting::GetNNetworkRoutes (void) const
+{
+  if (m_compactRoutes)
+    {
+      return m_compactNetworkRoutes.GetN ();
+    }
+  return m_networkRoutes.size ();
+}
+
+uint32_t
+Ipv4GlobalRouting::GetNASExternalRoutes (void) const
+{
+  if (m_compactRoutes)
+    {
+      return m_compactExternalRoutes.GetN ();
+    }
+  return m_ASexternalRoutes.size ();
+}
+
+std::size_t
+Ipv4GlobalRouting::GetMemoryUsage (void) const
+{
+  if (m_compactRoutes)
+    {
+      return m_compactHostRoutes.GetMemoryUsage () + m_compactNetworkRoutes.GetMemoryUsage ()
+             + m_compactExternalRoutes.GetMemoryUsage ();
+    }
+  // Each route is allocated with the node of its list, and indexed in a hash
+  // table or in a prefix trie
+  std::size_t bytes = GetNRoutes () * (sizeof (Ipv4RoutingTableEntry) + 3 * sizeof (void *));
+  bytes += m_hostIndex.bucket_count () * sizeof (void *);
+  for (HostIndex::const_iterator i = m_hostIndex.begin (); i != m_hostIndex.end (); i++)
+    {
+      bytes += sizeof (HostIndex::value_type) + sizeof (void *) + i->second.capacity () * sizeof (IndexedRoute);
+    }
+  bytes += m_networkIndex.GetMemoryUsage () + m_externalIndex.GetMemoryUsage ();
+  return bytes;
+}
+
+void
+Ipv4GlobalRouting::SetCompactRoutes (bool compact)
+{
+  NS_LOG_FUNCTION (this << compact);
+  NS_ABORT_MSG_IF (compact != m_compactRoutes && GetNRoutes () > 0,
+                   "Ipv4GlobalRouting::SetCompactRoutes (): the routing table is not empty");
+  m_compactRoutes = compact;
+}
+
+bool
+Ipv4GlobalRouting::GetCompactRoutes (void) const
+{
+  return m_compactRoutes;
+}
+
 int64_t
 Ipv4GlobalRouting::AssignStreams (int64_t stream)
 {
@@ -392,6 +834,13 @@ Ipv4GlobalRouting::DoDispose (void)
     {
       delete (*l);
     }
+  m_hostIndex.clear ();
+  m_networkIndex.Clear ();
+  m_externalIndex.Clear ();
+  m_indexValid = false;
+  m_compactHostRoutes.Clear ();
+  m_compactNetworkRoutes.Clear ();
+  m_compactExternalRoutes.Clear ();
 
   Ipv4RoutingProtocol::DoDispose ();
 }
@@ -544,9 +993,7 @@ Ipv4GlobalRouting::NotifyInterfaceUp (uint32_t i)
   NS_LOG_FUNCTION (this << i);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::UpdateGlobalRoutes ();
     }
 }
 
@@ -556,9 +1003,7 @@ Ipv4GlobalRouting::NotifyInterfaceDown (uint32_t i)
   NS_LOG_FUNCTION (this << i);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::UpdateGlobalRoutes ();
     }
 }
 
@@ -568,9 +1013,7 @@ Ipv4GlobalRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress ad
   NS_LOG_FUNCTION (this << interface << address);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::UpdateGlobalRoutes ();
     }
 }
 
@@ -580,9 +1023,7 @@ Ipv4GlobalRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress
   NS_LOG_FUNCTION (this << interface << address);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::UpdateGlobalRoutes ();
     }
 }
 
@@ -21,13 +21,18 @@
 #define IPV4_GLOBAL_ROUTING_H
 
 #include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
 #include "ns3/ptr.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "ns3/ipv4-compact-route-table.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/routing-prefix-trie.h"
 
 namespace ns3 {
 
@@ -65,6 +70,12 @@ class Node;
  *
  * This class deals with Ipv4 unicast routes only.
  *
+ * The routes are stored as a list of Ipv4RoutingTableEntry objects, unless
+ * the CompactRoutes attribute is set, in which case they are stored in
+ * Ipv4CompactRouteTable lists of destinations and next hop indices, which
+ * use several times less memory in large topologies where every node has a
+ * route to every link.
+ *
  * \see Ipv4RoutingProtocol
  * \see GlobalRouteManager
  */
@@ -193,7 +204,8 @@ public:
    * \param i The index (into the routing table) of the route to retrieve.  If
    * the default route has been set, it will occupy index zero.
    * \return If route is set, a pointer to that Ipv4RoutingTableEntry is returned, otherwise
-   * a zero pointer is returned.
+   * a zero pointer is returned.  If the CompactRoutes attribute is set, the
+   * entry is a copy of the route, which is only valid until the next call.
    *
    * \see Ipv4RoutingTableEntry
    * \see Ipv4GlobalRouting::RemoveRoute
@@ -218,6 +230,71 @@ public:
    */
   void RemoveRoute (uint32_t i);
 
+  /**
+   * \brief Replace a range of the host routes.
+   *
+   * The routes of the range which are equal to the new ones at the beginning
+   * and at the end of the range are kept, and the other ones are overwritten,
+   * so that a range which is only partly changed is updated without
+   * reallocating all its routes.  This is used by the GlobalRouteManager to
+   * update the routes computed for this node.
+   *
+   * \param first The index of the first host route of the range.
+   * \param n The number of host routes of the range.
+   * \param routes The routes which replace the range.
+   */
+  void ReplaceHostRoutes (uint32_t first, uint32_t n,
+                          const std::vector<Ipv4RoutingTableEntry> &routes);
+
+  /**
+   * \brief Replace a range of the network routes.
+   *
+   * \param first The index of the first network route of the range.
+   * \param n The number of network routes of the range.
+   * \param routes The routes which replace the range.
+   *
+   * \see Ipv4GlobalRouting::ReplaceHostRoutes
+   */
+  void ReplaceNetworkRoutes (uint32_t first, uint32_t n,
+                             const std::vector<Ipv4RoutingTableEntry> &routes);
+
+  /**
+   * \brief Replace a range of the AS external routes.
+   *
+   * \param first The index of the first external route of the range.
+   * \param n The number of external routes of the range.
+   * \param routes The routes which replace the range.
+   *
+   * \see Ipv4GlobalRouting::ReplaceHostRoutes
+   */
+  void ReplaceASExternalRoutes (uint32_t first, uint32_t n,
+                                const std::vector<Ipv4RoutingTableEntry> &routes);
+
+  /**
+   * \brief Get the number of host routes.
+   * \returns the number of host routes
+   */
+  uint32_t GetNHostRoutes (void) const;
+
+  /**
+   * \brief Get the number of network routes, including the default route.
+   * \returns the number of network routes
+   */
+  uint32_t GetNNetworkRoutes (void) const;
+
+  /**
+   * \brief Get the number of AS external routes.
+   * \returns the number of AS external routes
+   */
+  uint32_t GetNASExternalRoutes (void) const;
+
+  /**
+   * \brief Get the memory used by the routes.
+   * \returns the approximate number of bytes used by the routes and their
+   * index, not counting the overhead of the memory allocator
+   */
+  std::size_t GetMemoryUsage (void) const;
+
   /**
    * Assign a fixed random variable stream number to the random variables
    * used by this model.  Return the number of streams (possibly zero) that
@@ -232,6 +309,17 @@ protected:
   void DoDispose (void);
 
 private:
+  /**
+   * \brief Set whether the routes are stored in compact route tables.
+   * \param compact whether the routes are stored in compact route tables
+   */
+  void SetCompactRoutes (bool compact);
+
+  /**
+   * \returns true if the routes are stored in compact route tables
+   */
+  bool GetCompactRoutes (void) const;
+
   /// Set to true if packets are randomly routed among ECMP; set to false for using only one route consistently
   bool m_randomEcmpRouting;
   /// Set to true if this interface should respond to interface events by globallly recomputing routes 
@@ -268,10 +356,68 @@ private:
    */
   Ptr<Ipv4Route> LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif = 0);
 
+  /// A route and its position in the routing table
+  typedef std::pair<uint32_t, Ipv4RoutingTableEntry *> IndexedRoute;
+  /// Index of the routes to hosts by destination
+  typedef std::unordered_map<Ipv4Address, std::vector<IndexedRoute>, Ipv4AddressHash> HostIndex;
+  /// Index of the routes to networks by prefix
+  typedef RoutingPrefixTrie<4, IndexedRoute> NetworkIndex;
+
+  /**
+   * \brief Find the routes to a destination in the route index.
+   *
+   * The routes are the same, and in the same order, as the ones
+   * found by scanning the routing table.
+   *
+   * \param dest destination address
+   * \param oif output interface if any (put 0 otherwise)
+   * \param routes the vector to which the routes are appended
+   */
+  void LookupIndex (Ipv4Address dest, Ptr<NetDevice> oif, std::vector<Ipv4RoutingTableEntry *> &routes);
+
+  /**
+   * \brief Find the routes to a destination in the compact route tables.
+   * \param dest destination address
+   * \param oif output interface if any (put 0 otherwise)
+   * \param routes the vector to which copies of the routes are appended
+   */
+  void LookupCompact (Ipv4Address dest, Ptr<NetDevice> oif, std::vector<Ipv4RoutingTableEntry> &routes);
+
+  /**
+   * \brief Rebuild the route index from the routing table if it is invalid.
+   * \returns true if the routes can be looked up in the index, false if a
+   * route to a network has a non-contiguous mask
+   */
+  bool UpdateIndex (void);
+
+  /**
+   * \brief Add a route at the end of the routing table to a valid index.
+   * \param route the route
+   * \param index the index of the route list, or 0 for the routes to hosts
+   */
+  void AddToIndex (Ipv4RoutingTableEntry *route, NetworkIndex *index);
+
   HostRoutes m_hostRoutes;             //!< Routes to hosts
   NetworkRoutes m_networkRoutes;       //!< Routes to networks
   ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+  HostIndex m_hostIndex;               //!< Index of m_hostRoutes
+  NetworkIndex m_networkIndex;         //!< Index of m_networkRoutes
+  NetworkIndex m_externalIndex;        //!< Index of m_ASexternalRoutes
+  bool m_indexValid;                   //!< True if the index matches the routing table
+  bool m_indexUsable;                  //!< True if all the masks are contiguous
+  uint32_t m_indexPosition;            //!< The position of the next route added to the index
+  std::vector<const NetworkIndex::Values *> m_indexMatches; //!< Lookup buffer
+  std::vector<IndexedRoute> m_indexRoutes;                  //!< Lookup buffer
+
+  bool m_compactRoutes;                          //!< True if the routes are stored in the compact tables
+  Ipv4CompactRouteTable m_compactHostRoutes;     //!< Routes to hosts, if compact
+  Ipv4CompactRouteTable m_compactNetworkRoutes;  //!< Routes to networks, if compact
+  Ipv4CompactRouteTable m_compactExternalRoutes; //!< External routes imported, if compact
+  mutable Ipv4RoutingTableEntry m_compactRoute;  //!< The copy of a route returned by GetRoute
+  std::vector<Ipv4RoutingTableEntry> m_compactMatches; //!< Lookup buffer
+  std::vector<Ipv4RoutingTableEntry> m_compactFound;   //!< Lookup buffer
+
   Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
@@ -35,6 +35,8 @@
 #include "ns3/boolean.h"
 #include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/traffic-control-layer.h"
+#include "ns3/queue-disc.h"
+#include "ns3/segmentation-offload-tag.h"
 
 #include "loopback-net-device.h"
 #include "arp-l3-protocol.h"
@@ -43,6 +45,7 @@
 #include "icmpv4-l4-protocol.h"
 #include "ipv4-interface.h"
 #include "ipv4-raw-socket-impl.h"
+#include "tcp-l4-protocol.h"
 
 namespace ns3 {
 
@@ -975,6 +978,21 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
       return;
     }
   Ptr<NetDevice> outDev = route->GetOutputDevice ();
+  SegmentationOffloadTag offload;
+  bool superSegment = packet->PeekPacketTag (offload);
+  if (superSegment && !CanSendSuperSegment (outDev, packet, ipHeader))
+    {
+      NS_LOG_LOGIC ("Segment a TCP super-segment of " << offload.GetPayloadSize () << " bytes");
+      std::list<Ptr<Packet> > segments;
+      TcpL4Protocol::Segment (packet, segments);
+      for (std::list<Ptr<Packet> >::iterator it = segments.begin (); it != segments.end (); it++)
+        {
+          Ipv4Header segmentHeader = ipHeader;
+          segmentHeader.SetPayloadSize ((*it)->GetSize ());
+          SendRealOut (route, *it, segmentHeader);
+        }
+      return;
+    }
   int32_t interface = GetInterfaceForDevice (outDev);
   NS_ASSERT (interface >= 0);
   Ptr<Ipv4Interface> outInterface = GetInterface (interface);
@@ -996,7 +1014,8 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
   if (outInterface->IsUp ())
     {
       NS_LOG_LOGIC ("Send to " << targetLabel << " " << target);
-      if ( packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu () )
+      // A super-segment is segmented by the device, not fragmented
+      if (!superSegment && packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu () )
         {
           std::list<Ipv4PayloadHeaderPair> listFragments;
           DoFragmentation (packet, ipHeader, outInterface->GetDevice ()->GetMtu (), listFragments);
@@ -1053,6 +1072,21 @@ Ipv4L3Protocol::IpMulticastForward (Ptr<Ipv4MulticastRoute> mrtentry, Ptr<const
 }
 
 // This function analogous to Linux ip_forward()
+bool
+Ipv4L3Protocol::CanSendSuperSegment (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                                     const Ipv4Header &ipHeader) const
+{
+  NS_LOG_FUNCTION (this << device << packet);
+  Ptr<TrafficControlLayer> tc = m_node->GetObject<TrafficControlLayer> ();
+  if (tc != 0 && tc->GetRootQueueDiscOnDevice (device) != 0)
+    {
+      return false;
+    }
+  Ptr<Packet> superSegment = packet->Copy ();
+  superSegment->AddHeader (ipHeader);
+  return device->SupportsSegmentationOffload (superSegment);
+}
+
 void
 Ipv4L3Protocol::IpForward (Ptr<Ipv4Route> rtentry, Ptr<const Packet> p, const Ipv4Header &header)
 {
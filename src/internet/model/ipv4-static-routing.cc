@@ -54,7 +54,9 @@ Ipv4StaticRouting::GetTypeId (void)
 }
 
 Ipv4StaticRouting::Ipv4StaticRouting () 
-  : m_ipv4 (0)
+  : m_indexValid (false),
+    m_indexUsable (false),
+    m_ipv4 (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -77,6 +79,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
     {
       Ipv4RoutingTableEntry *routePtr = new Ipv4RoutingTableEntry (route);
       m_networkRoutes.push_back (make_pair (routePtr, metric));
+      AddToIndex (--m_networkRoutes.end ());
     }
 }
 
@@ -96,6 +99,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
       Ipv4RoutingTableEntry *routePtr = new Ipv4RoutingTableEntry (route);
 
       m_networkRoutes.push_back (make_pair (routePtr, metric));
+      AddToIndex (--m_networkRoutes.end ());
     }
 }
 
@@ -154,6 +158,7 @@ Ipv4StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
                                                         networkMask,
                                                         outputInterface);
   m_networkRoutes.push_back (make_pair (route,0));
+  AddToIndex (--m_networkRoutes.end ());
 }
 
 uint32_t 
@@ -248,6 +253,92 @@ Ipv4StaticRouting::LookupRoute (const Ipv4RoutingTableEntry &route, uint32_t met
   return false;
 }
 
+bool
+Ipv4StaticRouting::UpdateIndex (void)
+{
+  if (m_indexValid)
+    {
+      return m_indexUsable;
+    }
+  NS_LOG_FUNCTION (this);
+  m_hostIndex.clear ();
+  m_networkIndex.Clear ();
+  m_indexValid = true;
+  m_indexUsable = true;
+  for (NetworkRoutesCI i = m_networkRoutes.begin (); i != m_networkRoutes.end (); i++)
+    {
+      AddToIndex (i);
+    }
+  return m_indexUsable;
+}
+
+void
+Ipv4StaticRouting::AddToIndex (NetworkRoutesCI route)
+{
+  if (!m_indexValid || !m_indexUsable)
+    {
+      return;
+    }
+  Ipv4Mask mask = route->first->GetDestNetworkMask ();
+  uint16_t length = mask.GetPrefixLength ();
+  if (mask != Ipv4Mask (length == 0 ? 0 : 0xffffffff << (32 - length)))
+    {
+      m_indexUsable = false;
+      return;
+    }
+  if (length == 32)
+    {
+      m_hostIndex[route->first->GetDestNetwork ()].push_back (route);
+      return;
+    }
+  uint8_t prefix[4];
+  route->first->GetDestNetwork ().Serialize (prefix);
+  m_networkIndex.Insert (prefix, length, route);
+}
+
+Ipv4RoutingTableEntry *
+Ipv4StaticRouting::LookupIndex (Ipv4Address dest, Ptr<NetDevice> oif)
+{
+  NS_LOG_FUNCTION (this << dest << oif);
+  HostIndex::const_iterator host = m_hostIndex.find (dest);
+  if (host != m_hostIndex.end ())
+    {
+      for (std::size_t i = 0; i < host->second.size (); i++)
+        {
+          Ipv4RoutingTableEntry *route = host->second[i]->first;
+          if (oif == 0 || oif == m_ipv4->GetNetDevice (route->GetInterface ()))
+            {
+              return route;
+            }
+        }
+    }
+  uint8_t address[4];
+  dest.Serialize (address);
+  m_indexMatches.clear ();
+  m_networkIndex.Lookup (address, m_indexMatches);
+  for (std::size_t k = m_indexMatches.size (); k-- > 0; )
+    {
+      const NetworkIndex::Values &routes = *m_indexMatches[k];
+      Ipv4RoutingTableEntry *best = 0;
+      uint32_t bestMetric = 0xffffffff;
+      for (std::size_t i = 0; i < routes.size (); i++)
+        {
+          Ipv4RoutingTableEntry *route = routes[i]->first;
+          if ((oif == 0 || oif == m_ipv4->GetNetDevice (route->GetInterface ()))
+              && routes[i]->second <= bestMetric)
+            {
+              best = route;
+              bestMetric = routes[i]->second;
+            }
+        }
+      if (best != 0)
+        {
+          return best;
+        }
+    }
+  return 0;
+}
+
 Ptr<Ipv4Route>
 Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
 {
@@ -269,56 +360,67 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
     }
 
 
-  for (NetworkRoutesI i = m_networkRoutes.begin (); 
-       i != m_networkRoutes.end (); 
-       i++) 
+  Ipv4RoutingTableEntry *route = 0;
+  if (UpdateIndex ())
     {
-      Ipv4RoutingTableEntry *j=i->first;
-      uint32_t metric =i->second;
-      Ipv4Mask mask = (j)->GetDestNetworkMask ();
-      uint16_t masklen = mask.GetPrefixLength ();
-      Ipv4Address entry = (j)->GetDestNetwork ();
-      NS_LOG_LOGIC ("Searching for route to " << dest << ", checking against route to " << entry << "/" << masklen);
-      if (mask.IsMatch (dest, entry)) 
+      route = LookupIndex (dest, oif);
+    }
+  else
+    {
+      for (NetworkRoutesI i = m_networkRoutes.begin (); 
+           i != m_networkRoutes.end (); 
+           i++) 
         {
-          NS_LOG_LOGIC ("Found global network route " << j << ", mask length " << masklen << ", metric " << metric);
-          if (oif != 0)
+          Ipv4RoutingTableEntry *j=i->first;
+          uint32_t metric =i->second;
+          Ipv4Mask mask = (j)->GetDestNetworkMask ();
+          uint16_t masklen = mask.GetPrefixLength ();
+          Ipv4Address entry = (j)->GetDestNetwork ();
+          NS_LOG_LOGIC ("Searching for route to " << dest << ", checking against route to " << entry << "/" << masklen);
+          if (mask.IsMatch (dest, entry)) 
             {
-              if (oif != m_ipv4->GetNetDevice (j->GetInterface ()))
+              NS_LOG_LOGIC ("Found global network route " << j << ", mask length " << masklen << ", metric " << metric);
+              if (oif != 0)
                 {
-                  NS_LOG_LOGIC ("Not on requested interface, skipping");
+                  if (oif != m_ipv4->GetNetDevice (j->GetInterface ()))
+                    {
+                      NS_LOG_LOGIC ("Not on requested interface, skipping");
+                      continue;
+                    }
+                }
+              if (masklen < longest_mask) // Not interested if got shorter mask
+                {
+                  NS_LOG_LOGIC ("Previous match longer, skipping");
                   continue;
                 }
-            }
-          if (masklen < longest_mask) // Not interested if got shorter mask
-            {
-              NS_LOG_LOGIC ("Previous match longer, skipping");
-              continue;
-            }
-          if (masklen > longest_mask) // Reset metric if longer masklen
-            {
-              shortest_metric = 0xffffffff;
-            }
-          longest_mask = masklen;
-          if (metric > shortest_metric)
-            {
-              NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
-              continue;
-            }
-          shortest_metric = metric;
-          Ipv4RoutingTableEntry* route = (j);
-          uint32_t interfaceIdx = route->GetInterface ();
-          rtentry = Create<Ipv4Route> ();
-          rtentry->SetDestination (route->GetDest ());
-          rtentry->SetSource (m_ipv4->SourceAddressSelection (interfaceIdx, route->GetDest ()));
-          rtentry->SetGateway (route->GetGateway ());
-          rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
-          if (masklen == 32)
-            {
-              break;
+              if (masklen > longest_mask) // Reset metric if longer masklen
+                {
+                  shortest_metric = 0xffffffff;
+                }
+              longest_mask = masklen;
+              if (metric > shortest_metric)
+                {
+                  NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
+                  continue;
+                }
+              shortest_metric = metric;
+              route = j;
+              if (masklen == 32)
+                {
+                  break;
+                }
             }
         }
     }
+  if (route != 0)
+    {
+      uint32_t interfaceIdx = route->GetInterface ();
+      rtentry = Create<Ipv4Route> ();
+      rtentry->SetDestination (route->GetDest ());
+      rtentry->SetSource (m_ipv4->SourceAddressSelection (interfaceIdx, route->GetDest ()));
+      rtentry->SetGateway (route->GetGateway ());
+      rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
+    }
   if (rtentry != 0)
     {
       NS_LOG_LOGIC ("Matching route via " << rtentry->GetGateway () << " at the end");
@@ -478,6 +580,7 @@ Ipv4StaticRouting::RemoveRoute (uint32_t index)
         {
           delete j->first;
           m_networkRoutes.erase (j);
+          m_indexValid = false;
           return;
         }
       tmp++;
@@ -610,6 +713,9 @@ Ipv4StaticRouting::DoDispose (void)
     {
       delete (*i);
     }
+  m_hostIndex.clear ();
+  m_networkIndex.Clear ();
+  m_indexValid = false;
   m_ipv4 = 0;
   Ipv4RoutingProtocol::DoDispose ();
 }
@@ -644,6 +750,7 @@ Ipv4StaticRouting::NotifyInterfaceDown (uint32_t i)
         {
           delete it->first;
           it = m_networkRoutes.erase (it);
+          m_indexValid = false;
         }
       else
         {
@@ -691,6 +798,7 @@ Ipv4StaticRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress
         {
           delete it->first;
           it = m_networkRoutes.erase (it);
+          m_indexValid = false;
         }
       else
         {
@@ -23,7 +23,9 @@
 #define IPV4_STATIC_ROUTING_H
 
 #include <list>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
@@ -31,6 +33,7 @@
 #include "ns3/ptr.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "ns3/routing-prefix-trie.h"
 
 namespace ns3 {
 
@@ -402,6 +405,37 @@ private:
   Ptr<Ipv4MulticastRoute> LookupStatic (Ipv4Address origin, Ipv4Address group,
                                         uint32_t interface);
 
+  /// Index of the routes to hosts by destination
+  typedef std::unordered_map<Ipv4Address, std::vector<NetworkRoutesCI>, Ipv4AddressHash> HostIndex;
+  /// Index of the other routes by prefix
+  typedef RoutingPrefixTrie<4, NetworkRoutesCI> NetworkIndex;
+
+  /**
+   * \brief Find the route to a destination in the route index.
+   *
+   * The route is the same as the one found by scanning the forwarding
+   * table: the first matching route to a host, else the last route with
+   * the lowest metric among the matching routes of longest prefix.
+   *
+   * \param dest destination address
+   * \param oif output interface if any (put 0 otherwise)
+   * \return the route, or 0 if no route matches
+   */
+  Ipv4RoutingTableEntry *LookupIndex (Ipv4Address dest, Ptr<NetDevice> oif);
+
+  /**
+   * \brief Rebuild the route index from the forwarding table if it is invalid.
+   * \returns true if the routes can be looked up in the index, false if a
+   * route has a non-contiguous mask
+   */
+  bool UpdateIndex (void);
+
+  /**
+   * \brief Add a route at the end of the forwarding table to a valid index.
+   * \param route the route
+   */
+  void AddToIndex (NetworkRoutesCI route);
+
   /**
    * \brief the forwarding table for network.
    */
@@ -412,6 +446,12 @@ private:
    */
   MulticastRoutes m_multicastRoutes;
 
+  HostIndex m_hostIndex;                     //!< Index of the routes to hosts
+  NetworkIndex m_networkIndex;               //!< Index of the other routes
+  bool m_indexValid;                         //!< True if the index matches the forwarding table
+  bool m_indexUsable;                        //!< True if all the masks are contiguous
+  std::vector<const NetworkIndex::Values *> m_indexMatches; //!< Lookup buffer
+
   /**
    * \brief Ipv4 reference.
    */
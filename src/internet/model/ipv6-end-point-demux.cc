@@ -18,6 +18,8 @@
  * Author: Sebastien Vincent <vincent@clarinet.u-strasbg.fr>
  */
 
+#include <algorithm>
+#include <functional>
 #include "ipv6-end-point-demux.h"
 #include "ipv6-end-point.h"
 #include "ns3/log.h"
@@ -26,6 +28,29 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Ipv6EndPointDemux");
 
+bool Ipv6EndPointDemux::Tuple::operator == (const Tuple &other) const
+{
+  return localAddress == other.localAddress && peerAddress == other.peerAddress
+         && localPort == other.localPort && peerPort == other.peerPort;
+}
+
+bool Ipv6EndPointDemux::Local::operator == (const Local &other) const
+{
+  return address == other.address && port == other.port && device == other.device;
+}
+
+std::size_t Ipv6EndPointDemux::TupleHash::operator () (const Tuple &x) const
+{
+  Ipv6AddressHash hash;
+  uint64_t ports = (static_cast<uint64_t> (x.localPort) << 16) | x.peerPort;
+  return hash (x.localAddress) ^ (hash (x.peerAddress) * 31) ^ std::hash<uint64_t> () (ports * 0x9e3779b97f4a7c15ULL);
+}
+
+std::size_t Ipv6EndPointDemux::LocalHash::operator () (const Local &x) const
+{
+  return Ipv6AddressHash () (x.address) ^ std::hash<uint16_t> () (x.port) ^ std::hash<NetDevice *> () (x.device);
+}
+
 Ipv6EndPointDemux::Ipv6EndPointDemux ()
   : m_ephemeral (49152),
     m_portFirst (49152),
@@ -40,37 +65,88 @@ Ipv6EndPointDemux::~Ipv6EndPointDemux ()
   for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
     {
       Ipv6EndPoint *endPoint = *i;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
   m_endPoints.clear ();
+  m_entries.clear ();
+  m_tuples.clear ();
+  m_locals.clear ();
+  m_ports.clear ();
 }
 
 bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
 {
   NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
-    {
-      if ((*i)->GetLocalPort  () == port)
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_ports.find (port) != m_ports.end ();
 }
 
 bool Ipv6EndPointDemux::LookupLocal (Ptr<NetDevice> boundNetDevice, Ipv6Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  Local local;
+  local.address = addr;
+  local.port = port;
+  local.device = PeekPointer (boundNetDevice);
+  return m_locals.find (local) != m_locals.end ();
+}
+
+Ipv6EndPoint* Ipv6EndPointDemux::Insert (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  Entry &entry = m_entries[endPoint];
+  entry.position = m_endPoints.insert (m_endPoints.end (), endPoint);
+  Index (endPoint, entry);
+  endPoint->m_demux = this;
+  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  return endPoint;
+}
+
+void Ipv6EndPointDemux::Index (Ipv6EndPoint *endPoint, Entry &entry)
+{
+  entry.tuple.localAddress = endPoint->GetLocalAddress ();
+  entry.tuple.peerAddress = endPoint->GetPeerAddress ();
+  entry.tuple.localPort = endPoint->GetLocalPort ();
+  entry.tuple.peerPort = endPoint->GetPeerPort ();
+  entry.local.address = entry.tuple.localAddress;
+  entry.local.port = entry.tuple.localPort;
+  entry.local.device = PeekPointer (endPoint->GetBoundNetDevice ());
+  m_tuples[entry.tuple].push_back (endPoint);
+  m_locals[entry.local]++;
+  m_ports[entry.local.port]++;
+}
+
+void Ipv6EndPointDemux::Unindex (Ipv6EndPoint *endPoint, const Entry &entry)
+{
+  std::unordered_map<Tuple, std::vector<Ipv6EndPoint *>, TupleHash>::iterator tuple = m_tuples.find (entry.tuple);
+  NS_ASSERT (tuple != m_tuples.end ());
+  std::vector<Ipv6EndPoint *> &endPoints = tuple->second;
+  endPoints.erase (std::find (endPoints.begin (), endPoints.end (), endPoint));
+  if (endPoints.empty ())
     {
-      if ((*i)->GetLocalPort () == port &&
-          (*i)->GetLocalAddress () == addr &&
-          (*i)->GetBoundNetDevice () == boundNetDevice)
-        {
-          return true;
-        }
+      m_tuples.erase (tuple);
+    }
+  std::unordered_map<Local, uint32_t, LocalHash>::iterator local = m_locals.find (entry.local);
+  NS_ASSERT (local != m_locals.end ());
+  if (--local->second == 0)
+    {
+      m_locals.erase (local);
+    }
+  std::unordered_map<uint16_t, uint32_t>::iterator port = m_ports.find (entry.local.port);
+  NS_ASSERT (port != m_ports.end ());
+  if (--port->second == 0)
+    {
+      m_ports.erase (port);
     }
-  return false;
+}
+
+void Ipv6EndPointDemux::Reindex (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  std::unordered_map<Ipv6EndPoint *, Entry>::iterator entry = m_entries.find (endPoint);
+  NS_ASSERT (entry != m_entries.end ());
+  Unindex (endPoint, entry->second);
+  Index (endPoint, entry->second);
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate ()
@@ -82,10 +158,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate ()
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (Ipv6Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (Ipv6Address::GetAny (), port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
@@ -97,10 +170,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (address, port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice, uint16_t port)
@@ -118,10 +188,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice, Ipv6Ad
       NS_LOG_WARN ("Duplicated endpoint.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (address, port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
@@ -129,39 +196,41 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
                                            Ipv6Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << boundNetDevice << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  Tuple tuple;
+  tuple.localAddress = localAddress;
+  tuple.peerAddress = peerAddress;
+  tuple.localPort = localPort;
+  tuple.peerPort = peerPort;
+  std::unordered_map<Tuple, std::vector<Ipv6EndPoint *>, TupleHash>::const_iterator same = m_tuples.find (tuple);
+  if (same != m_tuples.end ())
     {
-      if ((*i)->GetLocalPort () == localPort &&
-          (*i)->GetLocalAddress () == localAddress &&
-          (*i)->GetPeerPort () == peerPort &&
-          (*i)->GetPeerAddress () == peerAddress &&
-          ((*i)->GetBoundNetDevice () == boundNetDevice || (*i)->GetBoundNetDevice () == 0))
+      for (std::vector<Ipv6EndPoint *>::const_iterator i = same->second.begin (); i != same->second.end (); i++)
         {
-          NS_LOG_WARN ("Duplicated endpoint.");
-          return 0;
+          if ((*i)->GetBoundNetDevice () == boundNetDevice || (*i)->GetBoundNetDevice () == 0)
+            {
+              NS_LOG_WARN ("Duplicated endpoint.");
+              return 0;
+            }
         }
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
-  return endPoint;
+  return Insert (endPoint);
 }
 
 void Ipv6EndPointDemux::DeAllocate (Ipv6EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  std::unordered_map<Ipv6EndPoint *, Entry>::iterator entry = m_entries.find (endPoint);
+  if (entry == m_entries.end ())
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      return;
     }
+  Unindex (endPoint, entry->second);
+  m_endPoints.erase (entry->second.position);
+  m_entries.erase (entry);
+  endPoint->m_demux = 0;
+  delete endPoint;
 }
 
 /*
@@ -181,7 +250,31 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
   EndPoints retval4; /* Exact match on all 4 */
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+
+  /* Only the end points bound to the destination address or to the any
+     address, and connected to the source or to no peer, can match */
+  EndPoints candidates;
+  Tuple tuple;
+  tuple.localPort = dport;
+  for (uint32_t local = 0; local < (daddr == Ipv6Address::GetAny () ? 1 : 2); local++)
+    {
+      tuple.localAddress = (local == 0) ? daddr : Ipv6Address::GetAny ();
+      for (uint32_t peer = 0; peer < (saddr == Ipv6Address::GetAny () ? 1 : 2); peer++)
+        {
+          tuple.peerAddress = (peer == 0) ? saddr : Ipv6Address::GetAny ();
+          for (uint32_t port = 0; port < (sport == 0 ? 1 : 2); port++)
+            {
+              tuple.peerPort = (port == 0) ? sport : 0;
+              std::unordered_map<Tuple, std::vector<Ipv6EndPoint *>, TupleHash>::const_iterator found = m_tuples.find (tuple);
+              if (found != m_tuples.end ())
+                {
+                  candidates.insert (candidates.end (), found->second.begin (), found->second.end ());
+                }
+            }
+        }
+    }
+
+  for (EndPointsI i = candidates.begin (); i != candidates.end (); i++)
     {
       Ipv6EndPoint* endP = *i;
 
@@ -290,6 +383,19 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
 
 Ipv6EndPoint* Ipv6EndPointDemux::SimpleLookup (Ipv6Address dst, uint16_t dport, Ipv6Address src, uint16_t sport)
 {
+  /* An exact match is found in the index, unless several end points which
+     differ by their NetDevice match exactly */
+  Tuple tuple;
+  tuple.localAddress = dst;
+  tuple.peerAddress = src;
+  tuple.localPort = dport;
+  tuple.peerPort = sport;
+  std::unordered_map<Tuple, std::vector<Ipv6EndPoint *>, TupleHash>::const_iterator exact = m_tuples.find (tuple);
+  if (exact != m_tuples.end () && exact->second.size () == 1)
+    {
+      return exact->second.front ();
+    }
+
   uint32_t genericity = 3;
   Ipv6EndPoint *generic = 0;
 
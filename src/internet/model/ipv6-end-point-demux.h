@@ -23,6 +23,8 @@
 
 #include <stdint.h>
 #include <list>
+#include <unordered_map>
+#include <vector>
 #include "ns3/ipv6-address.h"
 #include "ipv6-interface.h"
 
@@ -34,6 +36,11 @@ class Ipv6EndPoint;
  * \ingroup ipv6
  *
  * \brief Demultiplexer for end points.
+ *
+ * The end points are indexed in hash tables by their four-tuple and by
+ * their local address and port, so that the lookup of a packet only visits
+ * the end points whose addresses and ports may match it.  The end points
+ * update the index when their addresses, ports or bound NetDevice change.
  */
 class Ipv6EndPointDemux
 {
@@ -153,6 +160,104 @@ public:
   EndPoints GetEndPoints () const;
 
 private:
+  friend class Ipv6EndPoint;
+
+  /**
+   * \brief The four-tuple of an end point.
+   */
+  struct Tuple
+  {
+    Ipv6Address localAddress; //!< the local address
+    Ipv6Address peerAddress;  //!< the peer address
+    uint16_t localPort;       //!< the local port
+    uint16_t peerPort;        //!< the peer port
+
+    /**
+     * \param other the other tuple
+     * \returns true if both tuples are equal
+     */
+    bool operator == (const Tuple &other) const;
+  };
+
+  /**
+   * \brief The local address and port of an end point, and its bound NetDevice.
+   */
+  struct Local
+  {
+    Ipv6Address address; //!< the local address
+    uint16_t port;       //!< the local port
+    NetDevice *device;   //!< the bound NetDevice, or 0
+
+    /**
+     * \param other the other key
+     * \returns true if both keys are equal
+     */
+    bool operator == (const Local &other) const;
+  };
+
+  /**
+   * \brief Hash function of the four-tuples.
+   */
+  struct TupleHash
+  {
+    /**
+     * \param x the tuple
+     * \returns the hash of the tuple
+     */
+    std::size_t operator () (const Tuple &x) const;
+  };
+
+  /**
+   * \brief Hash function of the local keys.
+   */
+  struct LocalHash
+  {
+    /**
+     * \param x the key
+     * \returns the hash of the key
+     */
+    std::size_t operator () (const Local &x) const;
+  };
+
+  /**
+   * \brief The position of an end point in the list, and the keys it is
+   * indexed with.
+   */
+  struct Entry
+  {
+    EndPointsI position; //!< the position in m_endPoints
+    Tuple tuple;         //!< the four-tuple
+    Local local;         //!< the local address, port and NetDevice
+  };
+
+  /**
+   * \brief Add an end point at the end of the list, and index it.
+   * \param endPoint the end point
+   * \return the end point
+   */
+  Ipv6EndPoint * Insert (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Index an end point with its current addresses, ports and NetDevice.
+   * \param endPoint the end point
+   * \param entry the entry of the end point, whose keys are set
+   */
+  void Index (Ipv6EndPoint *endPoint, Entry &entry);
+
+  /**
+   * \brief Remove an end point from the index.
+   * \param endPoint the end point
+   * \param entry the entry of the end point
+   */
+  void Unindex (Ipv6EndPoint *endPoint, const Entry &entry);
+
+  /**
+   * \brief Update the index after a change of the addresses, ports or
+   * NetDevice of an end point.
+   * \param endPoint the end point
+   */
+  void Reindex (Ipv6EndPoint *endPoint);
+
   /**
    * \brief Allocate a ephemeral port.
    * \return a port
@@ -178,6 +283,26 @@ private:
    * \brief A list of IPv6 end points.
    */
   EndPoints m_endPoints;
+
+  /**
+   * \brief The entry of each end point.
+   */
+  std::unordered_map<Ipv6EndPoint *, Entry> m_entries;
+
+  /**
+   * \brief The end points of each four-tuple.
+   */
+  std::unordered_map<Tuple, std::vector<Ipv6EndPoint *>, TupleHash> m_tuples;
+
+  /**
+   * \brief The number of end points of each local address, port and NetDevice.
+   */
+  std::unordered_map<Local, uint32_t, LocalHash> m_locals;
+
+  /**
+   * \brief The number of end points of each local port.
+   */
+  std::unordered_map<uint16_t, uint32_t> m_ports;
 };
 
 } /* namespace ns3 */
@@ -23,6 +23,7 @@
 #include "ns3/simulator.h"
 
 #include "ipv6-end-point.h"
+#include "ipv6-end-point-demux.h"
 
 namespace ns3
 {
@@ -34,7 +35,8 @@ Ipv6EndPoint::Ipv6EndPoint (Ipv6Address addr, uint16_t port)
     m_localPort (port),
     m_peerAddr (Ipv6Address::GetAny ()),
     m_peerPort (0),
-    m_rxEnabled (true)
+    m_rxEnabled (true),
+    m_demux (0)
 {
 }
 
@@ -57,6 +59,10 @@ Ipv6Address Ipv6EndPoint::GetLocalAddress ()
 void Ipv6EndPoint::SetLocalAddress (Ipv6Address addr)
 {
   m_localAddr = addr;
+  if (m_demux != 0)
+    {
+      m_demux->Reindex (this);
+    }
 }
 
 uint16_t Ipv6EndPoint::GetLocalPort ()
@@ -67,6 +73,10 @@ uint16_t Ipv6EndPoint::GetLocalPort ()
 void Ipv6EndPoint::SetLocalPort (uint16_t port)
 {
   m_localPort = port;
+  if (m_demux != 0)
+    {
+      m_demux->Reindex (this);
+    }
 }
 
 Ipv6Address Ipv6EndPoint::GetPeerAddress ()
@@ -82,7 +92,10 @@ uint16_t Ipv6EndPoint::GetPeerPort ()
 void Ipv6EndPoint::BindToNetDevice (Ptr<NetDevice> netdevice)
 {
   m_boundnetdevice = netdevice;
-  return;
+  if (m_demux != 0)
+    {
+      m_demux->Reindex (this);
+    }
 }
 
 Ptr<NetDevice> Ipv6EndPoint::GetBoundNetDevice (void)
@@ -94,6 +107,10 @@ void Ipv6EndPoint::SetPeer (Ipv6Address addr, uint16_t port)
 {
   m_peerAddr = addr;
   m_peerPort = port;
+  if (m_demux != 0)
+    {
+      m_demux->Reindex (this);
+    }
 }
 
 void Ipv6EndPoint::SetRxCallback (Callback<void, Ptr<Packet>, Ipv6Header, uint16_t, Ptr<Ipv6Interface> > callback)
@@ -34,6 +34,7 @@ namespace ns3
 
 class Header;
 class Packet;
+class Ipv6EndPointDemux;
 
 /**
  * \ingroup ipv6
@@ -192,6 +193,8 @@ public:
   bool IsRxEnabled (void);
 
 private:
+  friend class Ipv6EndPointDemux;
+
   /**
    * \brief The local address.
    */
@@ -236,6 +239,11 @@ private:
    * \brief true if the endpoint can receive packets.
    */
   bool m_rxEnabled;
+
+  /**
+   * \brief The demux which indexes the endpoint by its addresses and ports (if any).
+   */
+  Ipv6EndPointDemux *m_demux;
 };
 
 } /* namespace ns3 */
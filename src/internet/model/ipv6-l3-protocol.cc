@@ -31,6 +31,8 @@
 #include "ns3/mac16-address.h"
 #include "ns3/mac64-address.h"
 #include "ns3/traffic-control-layer.h"
+#include "ns3/queue-disc.h"
+#include "ns3/segmentation-offload-tag.h"
 
 #include "loopback-net-device.h"
 #include "ipv6-l3-protocol.h"
@@ -45,6 +47,7 @@
 #include "icmpv6-l4-protocol.h"
 #include "ndisc-cache.h"
 #include "ipv6-raw-socket-factory-impl.h"
+#include "tcp-l4-protocol.h"
 
 /// Minimum IPv6 MTU, as defined by \RFC{2460}
 #define IPV6_MIN_MTU 1280
@@ -1107,6 +1110,21 @@ void Ipv6L3Protocol::SendRealOut (Ptr<Ipv6Route> route, Ptr<Packet> packet, Ipv6
     }
 
   Ptr<NetDevice> dev = route->GetOutputDevice ();
+  SegmentationOffloadTag offload;
+  bool superSegment = packet->PeekPacketTag (offload);
+  if (superSegment && !CanSendSuperSegment (dev, packet, ipHeader))
+    {
+      NS_LOG_LOGIC ("Segment a TCP super-segment of " << offload.GetPayloadSize () << " bytes");
+      std::list<Ptr<Packet> > segments;
+      TcpL4Protocol::Segment (packet, segments);
+      for (std::list<Ptr<Packet> >::iterator it = segments.begin (); it != segments.end (); it++)
+        {
+          Ipv6Header segmentHeader = ipHeader;
+          segmentHeader.SetPayloadLength ((*it)->GetSize ());
+          SendRealOut (route, *it, segmentHeader);
+        }
+      return;
+    }
   int32_t interface = GetInterfaceForDevice (dev);
   NS_ASSERT (interface >= 0);
 
@@ -1143,7 +1161,8 @@ void Ipv6L3Protocol::SendRealOut (Ptr<Ipv6Route> route, Ptr<Packet> packet, Ipv6
       targetMtu = dev->GetMtu ();
     }
 
-  if (packet->GetSize () + ipHeader.GetSerializedSize () > targetMtu)
+  // A super-segment is segmented by the device, not fragmented
+  if (!superSegment && packet->GetSize () + ipHeader.GetSerializedSize () > targetMtu)
     {
       // Router => drop
       if (!fromMe)
@@ -1223,6 +1242,20 @@ void Ipv6L3Protocol::SendRealOut (Ptr<Ipv6Route> route, Ptr<Packet> packet, Ipv6
     }
 }
 
+bool Ipv6L3Protocol::CanSendSuperSegment (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                                          const Ipv6Header &ipHeader) const
+{
+  NS_LOG_FUNCTION (this << device << packet);
+  Ptr<TrafficControlLayer> tc = m_node->GetObject<TrafficControlLayer> ();
+  if (tc != 0 && tc->GetRootQueueDiscOnDevice (device) != 0)
+    {
+      return false;
+    }
+  Ptr<Packet> superSegment = packet->Copy ();
+  superSegment->AddHeader (ipHeader);
+  return device->SupportsSegmentationOffload (superSegment);
+}
+
 void Ipv6L3Protocol::IpForward (Ptr<const NetDevice> idev, Ptr<Ipv6Route> rtentry, Ptr<const Packet> p, const Ipv6Header& header)
 {
   NS_LOG_FUNCTION (this << rtentry << p << header);
@@ -592,6 +592,21 @@ private:
    */
   void SendRealOut (Ptr<Ipv6Route> route, Ptr<Packet> packet, Ipv6Header const& ipHeader);
 
+  /**
+   * \brief Check if a super-segment can be sent as a whole.
+   *
+   * The super-segment is split into segments before a device with a queue
+   * disc, which drops and marks each packet, or which cannot send it as a
+   * whole (see NetDevice::SupportsSegmentationOffload).
+   *
+   * \param device the output device
+   * \param packet the super-segment
+   * \param ipHeader the Ipv6 header of the super-segment
+   * \returns true if the super-segment can be sent as a whole
+   */
+  bool CanSendSuperSegment (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                            const Ipv6Header &ipHeader) const;
+
   /**
    * \brief Forward a packet.
    * \param idev Pointer to ingress network device
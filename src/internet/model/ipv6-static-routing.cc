@@ -18,6 +18,7 @@
  * Author: Sebastien Vincent <vincent@clarinet.u-strasbg.fr>
  */
 
+#include <cstring>
 #include <iomanip>
 #include "ns3/log.h"
 #include "ns3/node.h"
@@ -47,7 +48,9 @@ TypeId Ipv6StaticRouting::GetTypeId ()
 }
 
 Ipv6StaticRouting::Ipv6StaticRouting ()
-  : m_ipv6 (0)
+  : m_indexValid (false),
+    m_indexUsable (false),
+    m_ipv6 (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -163,6 +166,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
     {
       Ipv6RoutingTableEntry* routePtr = new Ipv6RoutingTableEntry (route);
       m_networkRoutes.push_back (std::make_pair (routePtr, metric));
+      AddToIndex (--m_networkRoutes.end ());
     }
 }
 
@@ -179,6 +183,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
     {
       Ipv6RoutingTableEntry* routePtr = new Ipv6RoutingTableEntry (route);
       m_networkRoutes.push_back (std::make_pair (routePtr, metric));
+      AddToIndex (--m_networkRoutes.end ());
     }
 }
 
@@ -191,6 +196,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
     {
       Ipv6RoutingTableEntry* routePtr = new Ipv6RoutingTableEntry (route);
       m_networkRoutes.push_back (std::make_pair (routePtr, metric));
+      AddToIndex (--m_networkRoutes.end ());
     }
 }
 
@@ -216,6 +222,7 @@ void Ipv6StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
   Ipv6Prefix networkMask = Ipv6Prefix (8);
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkMask, outputInterface);
   m_networkRoutes.push_back (std::make_pair (route, 0));
+  AddToIndex (--m_networkRoutes.end ());
 }
 
 uint32_t Ipv6StaticRouting::GetNMulticastRoutes () const
@@ -319,6 +326,83 @@ bool Ipv6StaticRouting::LookupRoute (const Ipv6RoutingTableEntry &route, uint32_
   return false;
 }
 
+bool Ipv6StaticRouting::UpdateIndex ()
+{
+  if (m_indexValid)
+    {
+      return m_indexUsable;
+    }
+  NS_LOG_FUNCTION (this);
+  m_networkIndex.Clear ();
+  m_indexValid = true;
+  m_indexUsable = true;
+  for (NetworkRoutesCI it = m_networkRoutes.begin (); it != m_networkRoutes.end (); it++)
+    {
+      AddToIndex (it);
+    }
+  return m_indexUsable;
+}
+
+void Ipv6StaticRouting::AddToIndex (NetworkRoutesCI route)
+{
+  if (!m_indexValid || !m_indexUsable)
+    {
+      return;
+    }
+  Ipv6Prefix mask = route->first->GetDestNetworkPrefix ();
+  uint8_t length = mask.GetPrefixLength ();
+  uint8_t maskBytes[16];
+  uint8_t contiguousBytes[16];
+  mask.GetBytes (maskBytes);
+  if (length <= 128)
+    {
+      Ipv6Prefix (length).GetBytes (contiguousBytes);
+    }
+  if (length > 128 || std::memcmp (maskBytes, contiguousBytes, 16) != 0)
+    {
+      m_indexUsable = false;
+      return;
+    }
+  uint8_t prefix[16];
+  route->first->GetDestNetwork ().GetBytes (prefix);
+  m_networkIndex.Insert (prefix, length, route);
+}
+
+Ipv6RoutingTableEntry *Ipv6StaticRouting::LookupIndex (Ipv6Address dst, Ptr<NetDevice> interface)
+{
+  NS_LOG_FUNCTION (this << dst << interface);
+  uint8_t address[16];
+  dst.GetBytes (address);
+  m_indexMatches.clear ();
+  m_networkIndex.Lookup (address, m_indexMatches);
+  for (std::size_t k = m_indexMatches.size (); k-- > 0; )
+    {
+      const NetworkIndex::Values &routes = *m_indexMatches[k];
+      Ipv6RoutingTableEntry* best = 0;
+      uint32_t bestMetric = 0xffffffff;
+      for (std::size_t i = 0; i < routes.size (); i++)
+        {
+          Ipv6RoutingTableEntry* route = routes[i]->first;
+          if ((!interface || interface == m_ipv6->GetNetDevice (route->GetInterface ()))
+              && routes[i]->second <= bestMetric)
+            {
+              /* the first matching route to a host is used */
+              if (route->GetDestNetworkPrefix ().GetPrefixLength () == 128)
+                {
+                  return route;
+                }
+              best = route;
+              bestMetric = routes[i]->second;
+            }
+        }
+      if (best)
+        {
+          return best;
+        }
+    }
+  return 0;
+}
+
 Ptr<Ipv6Route> Ipv6StaticRouting::LookupStatic (Ipv6Address dst, Ptr<NetDevice> interface)
 {
   NS_LOG_FUNCTION (this << dst << interface);
@@ -338,70 +422,82 @@ Ptr<Ipv6Route> Ipv6StaticRouting::LookupStatic (Ipv6Address dst, Ptr<NetDevice>
       return rtentry;
     }
 
-  for (NetworkRoutesI it = m_networkRoutes.begin (); it != m_networkRoutes.end (); it++)
+  Ipv6RoutingTableEntry* route = 0;
+  if (UpdateIndex ())
     {
-      Ipv6RoutingTableEntry* j = it->first;
-      uint32_t metric = it->second;
-      Ipv6Prefix mask = j->GetDestNetworkPrefix ();
-      uint16_t maskLen = mask.GetPrefixLength ();
-      Ipv6Address entry = j->GetDestNetwork ();
-
-      NS_LOG_LOGIC ("Searching for route to " << dst << ", mask length " << maskLen << ", metric " << metric);
-
-      if (mask.IsMatch (dst, entry))
+      route = LookupIndex (dst, interface);
+    }
+  else
+    {
+      for (NetworkRoutesI it = m_networkRoutes.begin (); it != m_networkRoutes.end (); it++)
         {
-          NS_LOG_LOGIC ("Found global network route " << *j << ", mask length " << maskLen << ", metric " << metric);
+          Ipv6RoutingTableEntry* j = it->first;
+          uint32_t metric = it->second;
+          Ipv6Prefix mask = j->GetDestNetworkPrefix ();
+          uint16_t maskLen = mask.GetPrefixLength ();
+          Ipv6Address entry = j->GetDestNetwork ();
 
-          /* if interface is given, check the route will output on this interface */
-          if (!interface || interface == m_ipv6->GetNetDevice (j->GetInterface ()))
-            {
-              if (maskLen < longestMask)
-                {
-                  NS_LOG_LOGIC ("Previous match longer, skipping");
-                  continue;
-                }
+          NS_LOG_LOGIC ("Searching for route to " << dst << ", mask length " << maskLen << ", metric " << metric);
 
-              if (maskLen > longestMask)
-                {
-                  shortestMetric = 0xffffffff;
-                }
+          if (mask.IsMatch (dst, entry))
+            {
+              NS_LOG_LOGIC ("Found global network route " << *j << ", mask length " << maskLen << ", metric " << metric);
 
-              longestMask = maskLen;
-              if (metric > shortestMetric)
+              /* if interface is given, check the route will output on this interface */
+              if (!interface || interface == m_ipv6->GetNetDevice (j->GetInterface ()))
                 {
-                  NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
-                  continue;
-                }
+                  if (maskLen < longestMask)
+                    {
+                      NS_LOG_LOGIC ("Previous match longer, skipping");
+                      continue;
+                    }
 
-              shortestMetric = metric;
-              Ipv6RoutingTableEntry* route = j;
-              uint32_t interfaceIdx = route->GetInterface ();
-              rtentry = Create<Ipv6Route> ();
+                  if (maskLen > longestMask)
+                    {
+                      shortestMetric = 0xffffffff;
+                    }
 
-              if (route->GetGateway ().IsAny ())
-                {
-                  rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetDest ()));
-                }
-              else if (route->GetDest ().IsAny ()) /* default route */
-                {
-                  rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetPrefixToUse ().IsAny () ? dst : route->GetPrefixToUse ()));
-                }
-              else
-                {
-                  rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetGateway ()));
-                }
+                  longestMask = maskLen;
+                  if (metric > shortestMetric)
+                    {
+                      NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
+                      continue;
+                    }
 
-              rtentry->SetDestination (route->GetDest ());
-              rtentry->SetGateway (route->GetGateway ());
-              rtentry->SetOutputDevice (m_ipv6->GetNetDevice (interfaceIdx));
-              if (maskLen == 128)
-                {
-                  break;
+                  shortestMetric = metric;
+                  route = j;
+                  if (maskLen == 128)
+                    {
+                      break;
+                    }
                 }
             }
         }
     }
 
+  if (route)
+    {
+      uint32_t interfaceIdx = route->GetInterface ();
+      rtentry = Create<Ipv6Route> ();
+
+      if (route->GetGateway ().IsAny ())
+        {
+          rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetDest ()));
+        }
+      else if (route->GetDest ().IsAny ()) /* default route */
+        {
+          rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetPrefixToUse ().IsAny () ? dst : route->GetPrefixToUse ()));
+        }
+      else
+        {
+          rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetGateway ()));
+        }
+
+      rtentry->SetDestination (route->GetDest ());
+      rtentry->SetGateway (route->GetGateway ());
+      rtentry->SetOutputDevice (m_ipv6->GetNetDevice (interfaceIdx));
+    }
+
   if (rtentry)
     {
       NS_LOG_LOGIC ("Matching route via " << rtentry->GetDestination () << " (Through " << rtentry->GetGateway () << ") at the end");
@@ -418,6 +514,8 @@ void Ipv6StaticRouting::DoDispose ()
       delete j->first;
     }
   m_networkRoutes.clear ();
+  m_networkIndex.Clear ();
+  m_indexValid = false;
 
   for (MulticastRoutesI i = m_multicastRoutes.begin (); i != m_multicastRoutes.end (); i = m_multicastRoutes.erase (i))
     {
@@ -568,6 +666,7 @@ void Ipv6StaticRouting::RemoveRoute (uint32_t index)
         {
           delete it->first;
           m_networkRoutes.erase (it);
+          m_indexValid = false;
           return;
         }
       tmp++;
@@ -587,6 +686,7 @@ void Ipv6StaticRouting::RemoveRoute (Ipv6Address network, Ipv6Prefix prefix, uin
         {
           delete it->first;
           m_networkRoutes.erase (it);
+          m_indexValid = false;
           return;
         }
     }
@@ -717,6 +817,7 @@ void Ipv6StaticRouting::NotifyInterfaceDown (uint32_t i)
         {
           delete it->first;
           it = m_networkRoutes.erase (it);
+          m_indexValid = false;
         }
       else
         {
@@ -754,6 +855,7 @@ void Ipv6StaticRouting::NotifyRemoveAddress (uint32_t interface, Ipv6InterfaceAd
         {
           delete it->first;
           it = m_networkRoutes.erase (it);
+          m_indexValid = false;
         }
       else
         {
@@ -802,6 +904,7 @@ void Ipv6StaticRouting::NotifyRemoveRoute (Ipv6Address dst, Ipv6Prefix mask, Ipv
             {
               delete j->first;
               j = m_networkRoutes.erase (j);
+              m_indexValid = false;
             }
           else
             {
@@ -24,12 +24,14 @@
 #include <stdint.h>
 
 #include <list>
+#include <vector>
 
 #include "ns3/ptr.h"
 #include "ns3/ipv6-address.h"
 #include "ns3/ipv6.h"
 #include "ns3/ipv6-header.h"
 #include "ns3/ipv6-routing-protocol.h"
+#include "ns3/routing-prefix-trie.h"
 
 namespace ns3 {
 
@@ -289,6 +291,35 @@ private:
    */
   Ptr<Ipv6MulticastRoute> LookupStatic (Ipv6Address origin, Ipv6Address group, uint32_t ifIndex);
 
+  /// Index of the routes by prefix
+  typedef RoutingPrefixTrie<16, NetworkRoutesCI> NetworkIndex;
+
+  /**
+   * \brief Find the route to a destination in the route index.
+   *
+   * The route is the same as the one found by scanning the forwarding
+   * table: the first matching route to a host, else the last route with
+   * the lowest metric among the matching routes of longest prefix.
+   *
+   * \param dest destination address
+   * \param interface output interface if any (put 0 otherwise)
+   * \return the route, or 0 if no route matches
+   */
+  Ipv6RoutingTableEntry *LookupIndex (Ipv6Address dest, Ptr<NetDevice> interface);
+
+  /**
+   * \brief Rebuild the route index from the forwarding table if it is invalid.
+   * \returns true if the routes can be looked up in the index, false if a
+   * route has a non-contiguous prefix
+   */
+  bool UpdateIndex ();
+
+  /**
+   * \brief Add a route at the end of the forwarding table to a valid index.
+   * \param route the route
+   */
+  void AddToIndex (NetworkRoutesCI route);
+
   /**
    * \brief the forwarding table for network.
    */
@@ -299,6 +330,11 @@ private:
    */
   MulticastRoutes m_multicastRoutes;
 
+  NetworkIndex m_networkIndex;               //!< Index of the routes
+  bool m_indexValid;                         //!< True if the index matches the forwarding table
+  bool m_indexUsable;                        //!< True if all the prefixes are contiguous
+  std::vector<const NetworkIndex::Values *> m_indexMatches; //!< Lookup buffer
+
   /**
    * \brief Ipv6 reference.
    */
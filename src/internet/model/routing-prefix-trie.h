@@ -0,0 +1,322 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ROUTING_PREFIX_TRIE_H
+#define ROUTING_PREFIX_TRIE_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief A path-compressed binary trie of address prefixes, used by the
+ * routing protocols to find the routes matching a destination address
+ * without scanning their routing tables.
+ *
+ * The addresses are N bytes long, in network order.  Each prefix holds
+ * the values inserted with it, in insertion order; a lookup returns the
+ * values of all the prefixes matching an address, from the shortest
+ * prefix to the longest one.  The nodes are stored in a vector, and the
+ * nodes emptied by Remove () are only reclaimed by Clear ().
+ *
+ * \tparam N the length of the addresses in bytes
+ * \tparam T the type of the values
+ */
+template <std::size_t N, typename T>
+class RoutingPrefixTrie
+{
+public:
+  /// The values of a prefix
+  typedef std::vector<T> Values;
+
+  RoutingPrefixTrie ();
+
+  /**
+   * \brief Remove all the prefixes.
+   */
+  void Clear (void);
+
+  /**
+   * \brief Add a value to a prefix.
+   * \param prefix the prefix bytes, the bits after the prefix length are ignored
+   * \param length the prefix length in bits
+   * \param value the value, added after the other values of the prefix
+   */
+  void Insert (const uint8_t prefix[N], uint8_t length, const T &value);
+
+  /**
+   * \brief Remove the first value of a prefix equal to a given value.
+   * \param prefix the prefix bytes
+   * \param length the prefix length in bits
+   * \param value the value
+   * \returns true if the value was found
+   */
+  bool Remove (const uint8_t prefix[N], uint8_t length, const T &value);
+
+  /**
+   * \brief Find the prefixes matching an address.
+   * \param address the address bytes
+   * \param matches the vector to which the values of the non-empty
+   * matching prefixes are appended, from the shortest prefix to the longest
+   */
+  void Lookup (const uint8_t address[N], std::vector<const Values *> &matches) const;
+
+  /**
+   * \returns the approximate number of bytes used by the nodes and their
+   * values, not counting the overhead of the memory allocator
+   */
+  std::size_t GetMemoryUsage (void) const;
+
+private:
+  /// A node of the trie: a prefix, its values and its subtries
+  struct Node
+  {
+    uint8_t key[N];     //!< the prefix bytes, zero after the prefix length
+    uint8_t length;     //!< the prefix length
+    uint32_t child[2];  //!< the subtries whose next bit is 0 and 1
+    Values values;      //!< the values of the prefix
+  };
+
+  /// Index of a missing child
+  static const uint32_t NONE = 0xffffffff;
+
+  /**
+   * \param key the key
+   * \param bit the bit index
+   * \returns the given bit of a key
+   */
+  static uint32_t GetBit (const uint8_t key[N], uint32_t bit);
+
+  /**
+   * \param a the first key
+   * \param b the second key
+   * \param length the maximum length
+   * \returns the number of leading bits common to both keys, up to length
+   */
+  static uint32_t GetCommonLength (const uint8_t a[N], const uint8_t b[N], uint32_t length);
+
+  /**
+   * \brief Append a new node with no child.
+   * \param prefix the prefix bytes
+   * \param length the prefix length
+   * \returns the index of the node
+   */
+  uint32_t NewNode (const uint8_t prefix[N], uint8_t length);
+
+  /**
+   * \param prefix the prefix bytes
+   * \param length the prefix length
+   * \returns the index of the node of a prefix, or NONE
+   */
+  uint32_t Find (const uint8_t prefix[N], uint8_t length) const;
+
+  std::vector<Node> m_nodes; //!< the nodes, the root being the empty prefix
+};
+
+template <std::size_t N, typename T>
+RoutingPrefixTrie<N, T>::RoutingPrefixTrie ()
+{
+  Clear ();
+}
+
+template <std::size_t N, typename T>
+void
+RoutingPrefixTrie<N, T>::Clear (void)
+{
+  uint8_t zero[N];
+  std::memset (zero, 0, N);
+  m_nodes.clear ();
+  NewNode (zero, 0);
+}
+
+template <std::size_t N, typename T>
+uint32_t
+RoutingPrefixTrie<N, T>::GetBit (const uint8_t key[N], uint32_t bit)
+{
+  return (key[bit / 8] >> (7 - bit % 8)) & 1;
+}
+
+template <std::size_t N, typename T>
+uint32_t
+RoutingPrefixTrie<N, T>::GetCommonLength (const uint8_t a[N], const uint8_t b[N], uint32_t length)
+{
+  uint32_t common = 0;
+  for (uint32_t i = 0; common < length; i++, common += 8)
+    {
+      uint8_t diff = a[i] ^ b[i];
+      if (diff != 0)
+        {
+          while ((diff & 0x80) == 0)
+            {
+              diff <<= 1;
+              common++;
+            }
+          break;
+        }
+    }
+  return std::min (common, length);
+}
+
+template <std::size_t N, typename T>
+uint32_t
+RoutingPrefixTrie<N, T>::NewNode (const uint8_t prefix[N], uint8_t length)
+{
+  NS_ASSERT (length <= N * 8);
+  Node node;
+  for (uint32_t i = 0; i < N; i++)
+    {
+      uint32_t bits = std::min<uint32_t> (8, length > i * 8 ? length - i * 8 : 0);
+      node.key[i] = prefix[i] & static_cast<uint8_t> (0xff00 >> bits);
+    }
+  node.length = length;
+  node.child[0] = NONE;
+  node.child[1] = NONE;
+  m_nodes.push_back (node);
+  return m_nodes.size () - 1;
+}
+
+template <std::size_t N, typename T>
+void
+RoutingPrefixTrie<N, T>::Insert (const uint8_t prefix[N], uint8_t length, const T &value)
+{
+  NS_ASSERT (length <= N * 8);
+  uint32_t parent = 0;
+  while (m_nodes[parent].length != length)
+    {
+      uint32_t bit = GetBit (prefix, m_nodes[parent].length);
+      uint32_t child = m_nodes[parent].child[bit];
+      if (child == NONE)
+        {
+          uint32_t leaf = NewNode (prefix, length);
+          m_nodes[parent].child[bit] = leaf;
+          m_nodes[leaf].values.push_back (value);
+          return;
+        }
+      uint32_t childLength = m_nodes[child].length;
+      uint32_t common = GetCommonLength (prefix, m_nodes[child].key, std::min<uint32_t> (length, childLength));
+      if (common == childLength)
+        {
+          parent = child;
+          continue;
+        }
+      // The prefix diverges from the child, or is a prefix of it: insert a
+      // node at the common length between the parent and the child
+      uint32_t split = NewNode (prefix, common);
+      m_nodes[split].child[GetBit (m_nodes[child].key, common)] = child;
+      m_nodes[parent].child[bit] = split;
+      if (common == length)
+        {
+          m_nodes[split].values.push_back (value);
+          return;
+        }
+      uint32_t leaf = NewNode (prefix, length);
+      m_nodes[split].child[GetBit (prefix, common)] = leaf;
+      m_nodes[leaf].values.push_back (value);
+      return;
+    }
+  m_nodes[parent].values.push_back (value);
+}
+
+template <std::size_t N, typename T>
+uint32_t
+RoutingPrefixTrie<N, T>::Find (const uint8_t prefix[N], uint8_t length) const
+{
+  uint32_t node = 0;
+  while (node != NONE && m_nodes[node].length < length)
+    {
+      node = m_nodes[node].child[GetBit (prefix, m_nodes[node].length)];
+      if (node != NONE
+          && GetCommonLength (prefix, m_nodes[node].key, std::min (length, m_nodes[node].length))
+          < std::min (length, m_nodes[node].length))
+        {
+          return NONE;
+        }
+    }
+  if (node == NONE || m_nodes[node].length != length)
+    {
+      return NONE;
+    }
+  return node;
+}
+
+template <std::size_t N, typename T>
+bool
+RoutingPrefixTrie<N, T>::Remove (const uint8_t prefix[N], uint8_t length, const T &value)
+{
+  uint32_t node = Find (prefix, length);
+  if (node == NONE)
+    {
+      return false;
+    }
+  Values &values = m_nodes[node].values;
+  for (typename Values::iterator i = values.begin (); i != values.end (); i++)
+    {
+      if (*i == value)
+        {
+          values.erase (i);
+          return true;
+        }
+    }
+  return false;
+}
+
+template <std::size_t N, typename T>
+void
+RoutingPrefixTrie<N, T>::Lookup (const uint8_t address[N], std::vector<const Values *> &matches) const
+{
+  uint32_t node = 0;
+  while (true)
+    {
+      const Node &n = m_nodes[node];
+      if (!n.values.empty ())
+        {
+          matches.push_back (&n.values);
+        }
+      if (n.length == N * 8)
+        {
+          return;
+        }
+      node = n.child[GetBit (address, n.length)];
+      if (node == NONE
+          || GetCommonLength (address, m_nodes[node].key, m_nodes[node].length) < m_nodes[node].length)
+        {
+          return;
+        }
+    }
+}
+
+template <std::size_t N, typename T>
+std::size_t
+RoutingPrefixTrie<N, T>::GetMemoryUsage (void) const
+{
+  std::size_t bytes = m_nodes.capacity () * sizeof (Node);
+  for (std::size_t i = 0; i < m_nodes.size (); i++)
+    {
+      bytes += m_nodes[i].values.capacity () * sizeof (T);
+    }
+  return bytes;
+}
+
+} // namespace ns3
+
+#endif /* ROUTING_PREFIX_TRIE_H */
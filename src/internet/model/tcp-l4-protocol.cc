@@ -27,6 +27,8 @@
 #include "ns3/packet.h"
 #include "ns3/node.h"
 #include "ns3/simulator.h"
+#include "ns3/timer-wheel.h"
+#include "ns3/segmentation-offload-tag.h"
 #include "ns3/ipv4-route.h"
 #include "ns3/ipv6-route.h"
 
@@ -92,12 +94,22 @@ TcpL4Protocol::GetTypeId (void)
                    ObjectVectorValue (),
                    MakeObjectVectorAccessor (&TcpL4Protocol::m_sockets),
                    MakeObjectVectorChecker<TcpSocketBase> ())
+    .AddAttribute ("TimerWheel",
+                   "If true, the retransmission and delayed ACK timers of the sockets "
+                   "are stored in a TimerWheel, so that the timers re-armed on every "
+                   "segment do not leave cancelled events in the scheduler.  The timers "
+                   "expire at the same time, but the order of the events which expire "
+                   "at the same time may differ.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpL4Protocol::m_useTimerWheel),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 TcpL4Protocol::TcpL4Protocol ()
-  : m_endPoints (new Ipv4EndPointDemux ()), m_endPoints6 (new Ipv6EndPointDemux ())
+  : m_endPoints (new Ipv4EndPointDemux ()), m_endPoints6 (new Ipv6EndPointDemux ()),
+    m_useTimerWheel (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -151,6 +163,20 @@ TcpL4Protocol::NotifyNewAggregate ()
   IpL4Protocol::NotifyNewAggregate ();
 }
 
+Ptr<TimerWheel>
+TcpL4Protocol::GetTimerWheel (void)
+{
+  if (m_useTimerWheel && m_timerWheel == 0)
+    {
+      m_timerWheel = CreateObject<TimerWheel> ();
+      if (m_node != 0)
+        {
+          m_timerWheel->SetContext (m_node->GetId ());
+        }
+    }
+  return m_timerWheel;
+}
+
 int
 TcpL4Protocol::GetProtocolNumber (void) const
 {
@@ -163,6 +189,12 @@ TcpL4Protocol::DoDispose (void)
   NS_LOG_FUNCTION (this);
   m_sockets.clear ();
 
+  if (m_timerWheel != 0)
+    {
+      m_timerWheel->Dispose ();
+      m_timerWheel = 0;
+    }
+
   if (m_endPoints != 0)
     {
       delete m_endPoints;
@@ -438,6 +470,19 @@ TcpL4Protocol::Receive (Ptr<Packet> packet,
 {
   NS_LOG_FUNCTION (this << packet << incomingIpHeader << incomingInterface);
 
+  SegmentationOffloadTag offload;
+  if (packet->PeekPacketTag (offload))
+    {
+      // The socket receives and acknowledges the segments of a super-segment
+      std::list<Ptr<Packet> > segments;
+      Segment (packet, segments);
+      for (std::list<Ptr<Packet> >::iterator it = segments.begin (); it != segments.end (); it++)
+        {
+          Receive (*it, incomingIpHeader, incomingInterface);
+        }
+      return IpL4Protocol::RX_OK;
+    }
+
   TcpHeader incomingTcpHeader;
   IpL4Protocol::RxStatus checksumControl;
 
@@ -506,6 +551,19 @@ TcpL4Protocol::Receive (Ptr<Packet> packet,
   NS_LOG_FUNCTION (this << packet << incomingIpHeader.GetSource () <<
                    incomingIpHeader.GetDestination ());
 
+  SegmentationOffloadTag offload;
+  if (packet->PeekPacketTag (offload))
+    {
+      // The socket receives and acknowledges the segments of a super-segment
+      std::list<Ptr<Packet> > segments;
+      Segment (packet, segments);
+      for (std::list<Ptr<Packet> >::iterator it = segments.begin (); it != segments.end (); it++)
+        {
+          Receive (*it, incomingIpHeader, interface);
+        }
+      return IpL4Protocol::RX_OK;
+    }
+
   TcpHeader incomingTcpHeader;
   IpL4Protocol::RxStatus checksumControl;
 
@@ -703,6 +761,31 @@ TcpL4Protocol::SendPacket (Ptr<Packet> pkt, const TcpHeader &outgoing,
   NS_FATAL_ERROR ("Trying to send a packet without IP addresses");
 }
 
+void
+TcpL4Protocol::Segment (Ptr<const Packet> packet, std::list<Ptr<Packet> > &segments)
+{
+  Ptr<Packet> payload = packet->Copy ();
+  SegmentationOffloadTag offload;
+  bool found = payload->RemovePacketTag (offload);
+  NS_ASSERT_MSG (found, "Not a super-segment");
+  TcpHeader header;
+  payload->RemoveHeader (header);
+  uint32_t size = payload->GetSize ();
+  for (uint32_t offset = 0; offset < size; offset += offload.GetSegmentSize ())
+    {
+      uint32_t length = std::min<uint32_t> (offload.GetSegmentSize (), size - offset);
+      Ptr<Packet> segment = payload->CreateFragment (offset, length);
+      TcpHeader segmentHeader = header;
+      segmentHeader.SetSequenceNumber (header.GetSequenceNumber () + offset);
+      if (offset + length < size)
+        {
+          segmentHeader.SetFlags (header.GetFlags () & ~(TcpHeader::FIN | TcpHeader::PSH));
+        }
+      segment->AddHeader (segmentHeader);
+      segments.push_back (segment);
+    }
+}
+
 void
 TcpL4Protocol::AddSocket (Ptr<TcpSocketBase> socket)
 {
@@ -22,6 +22,7 @@
 #define TCP_L4_PROTOCOL_H
 
 #include <stdint.h>
+#include <list>
 
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv6-address.h"
@@ -38,6 +39,7 @@ class Ipv4EndPointDemux;
 class Ipv6EndPointDemux;
 class Ipv4Interface;
 class TcpSocketBase;
+class TimerWheel;
 class Ipv4EndPoint;
 class Ipv6EndPoint;
 class NetDevice;
@@ -132,6 +134,17 @@ public:
     */
   Ptr<Socket> CreateSocket (TypeId congestionTypeId);
 
+  /**
+   * \brief Get the timer wheel of the sockets
+   *
+   * The wheel is created by the first call if the TimerWheel attribute is
+   * true.
+   *
+   * \return the timer wheel, or 0 if the timers of the sockets are plain
+   * simulator events
+   */
+  Ptr<TimerWheel> GetTimerWheel (void);
+
   /**
    * \brief Allocate an IPv4 Endpoint
    * \return the Endpoint
@@ -222,6 +235,19 @@ public:
                    const Address &saddr, const Address &daddr,
                    Ptr<NetDevice> oif = 0) const;
 
+  /**
+   * \brief Split a super-segment into segments
+   *
+   * The payload of the super-segment is split into segments of the size
+   * given by its SegmentationOffloadTag, each with a copy of its TCP header
+   * and the sequence number of its first byte.  The FIN and PSH flags are
+   * only set in the last segment.
+   *
+   * \param packet The super-segment, starting with its TCP header
+   * \param segments The list to which the segments are appended
+   */
+  static void Segment (Ptr<const Packet> packet, std::list<Ptr<Packet> > &segments);
+
   /**
    * \brief Make a socket fully operational
    *
@@ -325,6 +351,8 @@ private:
   TypeId m_congestionTypeId;       //!< The socket TypeId
   TypeId m_recoveryTypeId;         //!< The recovery TypeId
   std::vector<Ptr<TcpSocketBase> > m_sockets;      //!< list of sockets
+  bool m_useTimerWheel;            //!< Store the timers of the sockets in a timer wheel
+  Ptr<TimerWheel> m_timerWheel;    //!< The timer wheel of the sockets
   IpL4Protocol::DownTargetCallback m_downTarget;   //!< Callback to send packets over IPv4
   IpL4Protocol::DownTargetCallback6 m_downTarget6; //!< Callback to send packets over IPv6
 
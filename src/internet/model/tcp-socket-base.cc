@@ -42,6 +42,7 @@
 #include "ns3/pointer.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/data-rate.h"
+#include "ns3/segmentation-offload-tag.h"
 #include "ns3/object.h"
 #include "tcp-socket-base.h"
 #include "tcp-l4-protocol.h"
@@ -147,6 +148,13 @@ TcpSocketBase::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&TcpSocketBase::m_limitedTx),
                    MakeBooleanChecker ())
+    .AddAttribute ("SegmentationOffload",
+                   "Maximum number of segments of new data sent at once, as a "
+                   "super-segment which the device or the IP layer segments "
+                   "(1 disables the offload)",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&TcpSocketBase::m_segmentationOffload),
+                   MakeUintegerChecker<uint32_t> (1))
     .AddAttribute ("UseEcn", "Parameter to set ECN functionality",
                    EnumValue (TcpSocketState::Off),
                    MakeEnumAccessor (&TcpSocketBase::SetUseEcn),
@@ -350,6 +358,7 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     m_recoverActive (sock.m_recoverActive),
     m_retxThresh (sock.m_retxThresh),
     m_limitedTx (sock.m_limitedTx),
+    m_segmentationOffload (sock.m_segmentationOffload),
     m_isFirstPartialAck (sock.m_isFirstPartialAck),
     m_txTrace (sock.m_txTrace),
     m_rxTrace (sock.m_rxTrace),
@@ -365,6 +374,8 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     {
       m_rtt = sock.m_rtt->Copy ();
     }
+  m_retxEvent.SetWheel (sock.m_retxEvent.GetWheel ());
+  m_delAckEvent.SetWheel (sock.m_delAckEvent.GetWheel ());
   // Reset all callbacks to null
   Callback<void, Ptr< Socket > > vPS = MakeNullCallback<void, Ptr<Socket> > ();
   Callback<void, Ptr<Socket>, const Address &> vPSA = MakeNullCallback<void, Ptr<Socket>, const Address &> ();
@@ -481,6 +492,8 @@ void
 TcpSocketBase::SetTcp (Ptr<TcpL4Protocol> tcp)
 {
   m_tcp = tcp;
+  m_retxEvent.SetWheel (tcp->GetTimerWheel ());
+  m_delAckEvent.SetWheel (tcp->GetTimerWheel ());
 }
 
 /* Set an RTT estimator with this socket */
@@ -1374,7 +1387,7 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, const Address &fromAddress,
     { // Zero window: Enter persist state to send 1 byte to probe
       NS_LOG_LOGIC (this << " Enter zerowindow persist state");
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                    (Simulator::Now () + m_retxEvent.GetDelayLeft ()).GetSeconds ());
       m_retxEvent.Cancel ();
       NS_LOG_LOGIC ("Schedule persist timeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
@@ -2640,7 +2653,7 @@ TcpSocketBase::Destroy (void)
       m_tcp->RemoveSocket (this);
     }
   NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                (Simulator::Now () + m_retxEvent.GetDelayLeft ()).GetSeconds ());
   CancelAllTimers ();
 }
 
@@ -2656,7 +2669,7 @@ TcpSocketBase::Destroy6 (void)
       m_tcp->RemoveSocket (this);
     }
   NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                (Simulator::Now () + m_retxEvent.GetDelayLeft ()).GetSeconds ());
   CancelAllTimers ();
 }
 
@@ -2784,7 +2797,7 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
       NS_LOG_LOGIC ("Schedule retransmission timeout at time "
                     << Simulator::Now ().GetSeconds () << " to expire at time "
                     << (Simulator::Now () + m_rto.Get ()).GetSeconds ());
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::SendEmptyPacket, this, flags);
+      m_retxEvent.Schedule (m_rto, &TcpSocketBase::SendEmptyPacket, this, flags);
     }
 }
 
@@ -3087,6 +3100,10 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
     }
 
   AddSocketTags (p);
+  if (sz > m_tcb->m_segmentSize)
+    {
+      p->AddPacketTag (SegmentationOffloadTag (sz, m_tcb->m_segmentSize));
+    }
 
   if (m_closeOnEmpty && (remainingData == 0))
     {
@@ -3126,7 +3143,7 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
       NS_LOG_LOGIC (this << " SendDataPacket Schedule ReTxTimeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_rto.Get ()).GetSeconds () );
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
+      m_retxEvent.Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
     }
 
   m_txTrace (p, header, this);
@@ -3280,6 +3297,16 @@ TcpSocketBase::SendPendingData (bool withAck)
           // NextSeg () may have further constrained the segment size
           uint32_t maxSizeToSend = static_cast<uint32_t> (nextHigh - next);
           s = std::min (s, maxSizeToSend);
+          // New data may be sent as a super-segment of several segments,
+          // within the window and the largest IP packet
+          if (m_segmentationOffload > 1 && next >= m_tcb->m_highTxMark && s == m_tcb->m_segmentSize)
+            {
+              uint32_t rWndLeft = static_cast<uint32_t> (m_highRxAckMark.Get () + SequenceNumber32 (m_rWnd) - next);
+              uint32_t superSize = std::min (m_segmentationOffload * m_tcb->m_segmentSize,
+                                             std::min (availableWindow, rWndLeft));
+              superSize = std::min (superSize, SegmentationOffloadTag::MAX_PAYLOAD_SIZE);
+              s = std::max (s, superSize - superSize % m_tcb->m_segmentSize);
+            }
 
           // (C.2) If any of the data octets sent in (C.1) are below HighData,
           //       HighRxt MUST be set to the highest sequence number of the
@@ -3511,10 +3538,10 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
       else if (m_delAckEvent.IsExpired ())
         {
           m_congestionControl->CwndEvent (m_tcb, TcpSocketState::CA_EVENT_DELAYED_ACK);
-          m_delAckEvent = Simulator::Schedule (m_delAckTimeout,
-                                               &TcpSocketBase::DelAckTimeout, this);
+          m_delAckEvent.Schedule (m_delAckTimeout,
+                                  &TcpSocketBase::DelAckTimeout, this);
           NS_LOG_LOGIC (this << " scheduled delayed ACK at " <<
-                        (Simulator::Now () + Simulator::GetDelayLeft (m_delAckEvent)).GetSeconds ());
+                        (Simulator::Now () + m_delAckEvent.GetDelayLeft ()).GetSeconds ());
         }
     }
 }
@@ -3587,7 +3614,7 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack, bool resetRTO)
   if (m_state != SYN_RCVD && resetRTO)
     { // Set RTO unless the ACK is received in SYN_RCVD state
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                    (Simulator::Now () + m_retxEvent.GetDelayLeft ()).GetSeconds ());
       m_retxEvent.Cancel ();
       // On receiving a "New" ack we restart retransmission timer .. RFC 6298
       // RFC 6298, clause 2.4
@@ -3596,7 +3623,7 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack, bool resetRTO)
       NS_LOG_LOGIC (this << " Schedule ReTxTimeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_rto.Get ()).GetSeconds ());
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
+      m_retxEvent.Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
     }
 
   // Note the highest ACK and tell app to send more
@@ -3614,7 +3641,7 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack, bool resetRTO)
   if (m_txBuffer->Size () == 0 && m_state != FIN_WAIT_1 && m_state != CLOSING)
     { // No retransmit timer if no data to retransmit
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                    (Simulator::Now () + m_retxEvent.GetDelayLeft ()).GetSeconds ());
       m_retxEvent.Cancel ();
     }
 }
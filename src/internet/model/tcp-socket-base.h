@@ -28,6 +28,7 @@
 #include "ns3/ipv4-header.h"
 #include "ns3/ipv6-header.h"
 #include "ns3/timer.h"
+#include "ns3/timer-wheel.h"
 #include "ns3/sequence-number.h"
 #include "ns3/data-rate.h"
 #include "ns3/node.h"
@@ -1243,9 +1244,9 @@ protected:
 
 protected:
   // Counters and events
-  EventId           m_retxEvent     {}; //!< Retransmission event
+  WheelTimer        m_retxEvent;        //!< Retransmission event
   EventId           m_lastAckEvent  {}; //!< Last ACK timeout event
-  EventId           m_delAckEvent   {}; //!< Delayed ACK timeout event
+  WheelTimer        m_delAckEvent;      //!< Delayed ACK timeout event
   EventId           m_persistEvent  {}; //!< Persist event: Send 1 byte to probe for a non-zero Rx window
   EventId           m_timewaitEvent {}; //!< TIME_WAIT expiration event: Move this socket to CLOSED state
 
@@ -1323,6 +1324,7 @@ protected:
                                                   //!< which was set for handling previous congestion event.
   uint32_t               m_retxThresh {3};   //!< Fast Retransmit threshold
   bool                   m_limitedTx  {true}; //!< perform limited transmit
+  uint32_t               m_segmentationOffload {1}; //!< Maximum number of segments of a super-segment
 
   // Transmission Control Block
   Ptr<TcpSocketState>    m_tcb;               //!< Congestion control information
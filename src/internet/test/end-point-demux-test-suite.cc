@@ -0,0 +1,538 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+// Tests of the indexed lookups of Ipv4EndPointDemux and Ipv6EndPointDemux
+// against a scan of their end points, while end points are allocated,
+// changed and removed at random.
+
+#include <list>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv4-interface-address.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/ipv6-end-point-demux.h"
+#include "ns3/ipv6-interface.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the lookups of an end point demux against a scan of its end
+ * points.
+ *
+ * The addresses and ports are drawn from small sets, so that many end
+ * points share their addresses and ports and the wildcard matches are
+ * exercised.
+ *
+ * \tparam Demux the demux class
+ * \tparam EndPoint the end point class
+ * \tparam Address the address class
+ * \tparam Interface the interface class
+ */
+template <typename Demux, typename EndPoint, typename Address, typename Interface>
+class EndPointDemuxTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor.
+   * \param name the name of the test case
+   */
+  EndPointDemuxTestCase (std::string name);
+
+protected:
+  /// The end points of the demux
+  typedef std::list<EndPoint *> EndPoints;
+
+  /**
+   * \brief Find the best matches of a packet by scanning the end points, as
+   * the lookup did before the end points were indexed.
+   * \param endPoints the end points
+   * \param daddr the destination address
+   * \param dport the destination port
+   * \param saddr the source address
+   * \param sport the source port
+   * \param incomingInterface the incoming interface
+   * \returns the most-matching end points
+   */
+  virtual EndPoints Scan (const EndPoints &endPoints, Address daddr, uint16_t dport,
+                          Address saddr, uint16_t sport, Ptr<Interface> incomingInterface) = 0;
+
+  /**
+   * \param demux the demux
+   * \returns the end points of the demux, in allocation order
+   */
+  virtual EndPoints GetEndPoints (Demux &demux) = 0;
+
+  std::vector<Address> m_locals;       //!< the local addresses of the end points
+  std::vector<Address> m_peers;        //!< the peer addresses of the end points
+  std::vector<Address> m_destinations; //!< the destination addresses of the packets
+  std::vector<Ptr<Interface> > m_interfaces; //!< the incoming interfaces of the packets
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Check the lookups of a random packet.
+   * \param demux the demux
+   * \param random the random variable
+   */
+  void CheckLookups (Demux &demux, Ptr<UniformRandomVariable> random);
+
+  /**
+   * \brief Find the end point of an ICMP error by scanning the end points.
+   * \param endPoints the end points
+   * \param daddr the destination address
+   * \param dport the destination port
+   * \param saddr the source address
+   * \param sport the source port
+   * \returns the end point, or 0
+   */
+  static EndPoint *ScanSimple (const EndPoints &endPoints, Address daddr, uint16_t dport,
+                               Address saddr, uint16_t sport);
+
+  /**
+   * \param random the random variable
+   * \param values the values
+   * \returns a random value
+   */
+  template <typename T>
+  static T Draw (Ptr<UniformRandomVariable> random, const std::vector<T> &values);
+
+  std::vector<Ptr<NetDevice> > m_devices; //!< the NetDevices of the interfaces, and no NetDevice
+};
+
+template <typename Demux, typename EndPoint, typename Address, typename Interface>
+EndPointDemuxTestCase<Demux, EndPoint, Address, Interface>::EndPointDemuxTestCase (std::string name)
+  : TestCase (name)
+{
+}
+
+template <typename Demux, typename EndPoint, typename Address, typename Interface>
+template <typename T>
+T
+EndPointDemuxTestCase<Demux, EndPoint, Address, Interface>::Draw (Ptr<UniformRandomVariable> random,
+                                                                  const std::vector<T> &values)
+{
+  return values[random->GetInteger (0, values.size () - 1)];
+}
+
+template <typename Demux, typename EndPoint, typename Address, typename Interface>
+EndPoint *
+EndPointDemuxTestCase<Demux, EndPoint, Address, Interface>::ScanSimple (const EndPoints &endPoints,
+                                                                        Address daddr, uint16_t dport,
+                                                                        Address saddr, uint16_t sport)
+{
+  uint32_t genericity = 3;
+  EndPoint *generic = 0;
+  for (typename EndPoints::const_iterator i = endPoints.begin (); i != endPoints.end (); i++)
+    {
+      if ((*i)->GetLocalPort () != dport)
+        {
+          continue;
+        }
+      if ((*i)->GetLocalAddress () == daddr && (*i)->GetPeerPort () == sport
+          && (*i)->GetPeerAddress () == saddr)
+        {
+          return *i;
+        }
+      uint32_t tmp = ((*i)->GetLocalAddress () == Address::GetAny ())
+        + ((*i)->GetPeerAddress () == Address::GetAny ());
+      if (tmp < genericity)
+        {
+          generic = *i;
+          genericity = tmp;
+        }
+    }
+  return generic;
+}
+
+template <typename Demux, typename EndPoint, typename Address, typename Interface>
+void
+EndPointDemuxTestCase<Demux, EndPoint, Address, Interface>::CheckLookups (Demux &demux,
+                                                                          Ptr<UniformRandomVariable> random)
+{
+  EndPoints endPoints = GetEndPoints (demux);
+  Address daddr = Draw (random, m_destinations);
+  uint16_t dport = random->GetInteger (1, 3);
+  Address saddr = Draw (random, m_peers);
+  uint16_t sport = random->GetInteger (0, 2);
+  Ptr<Interface> incomingInterface = Draw (random, m_interfaces);
+
+  EndPoints expected = Scan (endPoints, daddr, dport, saddr, sport, incomingInterface);
+  // The lookup aborts when several end points match equally
+  if (expected.size () <= 1)
+    {
+      EndPoints found = demux.Lookup (daddr, dport, saddr, sport, incomingInterface);
+      NS_TEST_ASSERT_MSG_EQ (found.size (), expected.size (), "Wrong number of end points for "
+                             << daddr << ":" << dport << " from " << saddr << ":" << sport);
+      if (!expected.empty ())
+        {
+          NS_TEST_ASSERT_MSG_EQ (found.front (), expected.front (), "Wrong end point for "
+                                 << daddr << ":" << dport << " from " << saddr << ":" << sport);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (demux.SimpleLookup (daddr, dport, saddr, sport),
+                         ScanSimple (endPoints, daddr, dport, saddr, sport),
+                         "Wrong end point of an ICMP error for " << daddr << ":" << dport);
+
+  Ptr<NetDevice> device = Draw (random, m_devices);
+  Address local = Draw (random, m_locals);
+  bool localFound = false;
+  bool portFound = false;
+  for (typename EndPoints::const_iterator i = endPoints.begin (); i != endPoints.end (); i++)
+    {
+      portFound = portFound || (*i)->GetLocalPort () == dport;
+      localFound = localFound || ((*i)->GetLocalPort () == dport && (*i)->GetLocalAddress () == local
+                                  && (*i)->GetBoundNetDevice () == device);
+    }
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupLocal (device, local, dport), localFound,
+                         "Wrong local lookup of " << local << ":" << dport);
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (dport), portFound, "Wrong lookup of port " << dport);
+}
+
+template <typename Demux, typename EndPoint, typename Address, typename Interface>
+void
+EndPointDemuxTestCase<Demux, EndPoint, Address, Interface>::DoRun (void)
+{
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (5);
+  m_devices.clear ();
+  m_devices.push_back (0);
+  for (uint32_t i = 0; i < m_interfaces.size (); i++)
+    {
+      if (m_interfaces[i])
+        {
+          m_devices.push_back (m_interfaces[i]->GetDevice ());
+        }
+    }
+
+  Demux demux;
+  for (uint32_t step = 0; step < 3000; step++)
+    {
+      EndPoints endPoints = GetEndPoints (demux);
+      std::vector<EndPoint *> all (endPoints.begin (), endPoints.end ());
+      uint32_t action = random->GetInteger (0, 9);
+      if (action <= 2 && all.size () < 40)
+        {
+          Ptr<NetDevice> device = Draw (random, m_devices);
+          Address local = Draw (random, m_locals);
+          uint16_t localPort = random->GetInteger (1, 3);
+          Address peer = Draw (random, m_peers);
+          uint16_t peerPort = random->GetInteger (0, 2);
+          bool duplicate = false;
+          EndPoint *endPoint;
+          if (action == 0)
+            {
+              for (uint32_t i = 0; i < all.size (); i++)
+                {
+                  duplicate = duplicate || (all[i]->GetLocalPort () == localPort && all[i]->GetLocalAddress () == local
+                                            && (all[i]->GetBoundNetDevice () == device || all[i]->GetBoundNetDevice () == 0));
+                }
+              endPoint = demux.Allocate (device, local, localPort);
+            }
+          else if (action == 1)
+            {
+              for (uint32_t i = 0; i < all.size (); i++)
+                {
+                  duplicate = duplicate || (all[i]->GetLocalPort () == localPort && all[i]->GetLocalAddress () == local
+                                            && all[i]->GetPeerPort () == peerPort && all[i]->GetPeerAddress () == peer
+                                            && (all[i]->GetBoundNetDevice () == device || all[i]->GetBoundNetDevice () == 0));
+                }
+              endPoint = demux.Allocate (device, local, localPort, peer, peerPort);
+            }
+          else
+            {
+              endPoint = demux.Allocate (local);
+            }
+          NS_TEST_ASSERT_MSG_EQ ((endPoint == 0), duplicate, "Wrong detection of a duplicated end point");
+        }
+      else if (action == 3 && !all.empty ())
+        {
+          demux.DeAllocate (Draw (random, all));
+        }
+      else if (action == 4 && !all.empty ())
+        {
+          EndPoint *endPoint = Draw (random, all);
+          switch (random->GetInteger (0, 3))
+            {
+            case 0:
+              endPoint->SetPeer (Draw (random, m_peers), random->GetInteger (0, 2));
+              break;
+            case 1:
+              endPoint->SetLocalAddress (Draw (random, m_locals));
+              break;
+            case 2:
+              endPoint->BindToNetDevice (Draw (random, m_devices));
+              break;
+            default:
+              endPoint->SetRxEnabled (!endPoint->IsRxEnabled ());
+              break;
+            }
+        }
+      else
+        {
+          CheckLookups (demux, random);
+        }
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the lookups of Ipv4EndPointDemux against a scan of its end
+ * points.
+ */
+class Ipv4EndPointDemuxTestCase
+  : public EndPointDemuxTestCase<Ipv4EndPointDemux, Ipv4EndPoint, Ipv4Address, Ipv4Interface>
+{
+public:
+  Ipv4EndPointDemuxTestCase ();
+
+private:
+  virtual EndPoints Scan (const EndPoints &endPoints, Ipv4Address daddr, uint16_t dport,
+                          Ipv4Address saddr, uint16_t sport, Ptr<Ipv4Interface> incomingInterface);
+  virtual EndPoints GetEndPoints (Ipv4EndPointDemux &demux);
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase ()
+  : EndPointDemuxTestCase<Ipv4EndPointDemux, Ipv4EndPoint, Ipv4Address, Ipv4Interface>
+      ("Check the IPv4 end point demux lookups against a scan of the end points")
+{
+  const char *locals[] = {"0.0.0.0", "10.1.1.1", "10.1.1.0", "10.1.2.1", "10.1.2.0"};
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      m_locals.push_back (Ipv4Address (locals[i]));
+    }
+  const char *peers[] = {"0.0.0.0", "10.2.0.1", "10.2.0.2"};
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      m_peers.push_back (Ipv4Address (peers[i]));
+    }
+  const char *destinations[] = {"10.1.1.1", "10.1.1.255", "10.1.2.1", "10.1.2.255", "0.0.0.0"};
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      m_destinations.push_back (Ipv4Address (destinations[i]));
+    }
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<Ipv4Interface> interface = CreateObject<Ipv4Interface> ();
+      interface->SetDevice (CreateObject<SimpleNetDevice> ());
+      interface->AddAddress (Ipv4InterfaceAddress (m_locals[1 + 2 * i], Ipv4Mask ("/24")));
+      m_interfaces.push_back (interface);
+    }
+}
+
+Ipv4EndPointDemuxTestCase::EndPoints
+Ipv4EndPointDemuxTestCase::GetEndPoints (Ipv4EndPointDemux &demux)
+{
+  return demux.GetAllEndPoints ();
+}
+
+Ipv4EndPointDemuxTestCase::EndPoints
+Ipv4EndPointDemuxTestCase::Scan (const EndPoints &endPoints, Ipv4Address daddr, uint16_t dport,
+                                 Ipv4Address saddr, uint16_t sport, Ptr<Ipv4Interface> incomingInterface)
+{
+  EndPoints matches[4];
+  for (EndPoints::const_iterator i = endPoints.begin (); i != endPoints.end (); i++)
+    {
+      Ipv4EndPoint *endP = *i;
+      if (!endP->IsRxEnabled () || endP->GetLocalPort () != dport)
+        {
+          continue;
+        }
+      if (endP->GetBoundNetDevice () && endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
+        {
+          continue;
+        }
+      bool localExact = endP->GetLocalAddress () == daddr;
+      bool localWildCard = false;
+      if (!localExact)
+        {
+          localWildCard = endP->GetLocalAddress () == Ipv4Address::GetAny ();
+          for (uint32_t j = 0; j < incomingInterface->GetNAddresses (); j++)
+            {
+              Ipv4InterfaceAddress addr = incomingInterface->GetAddress (j);
+              Ipv4Address netPart = addr.GetLocal ().CombineMask (addr.GetMask ());
+              localWildCard = localWildCard || (endP->GetLocalAddress () == netPart
+                                                && daddr.CombineMask (addr.GetMask ()) == netPart);
+            }
+          if (!localWildCard)
+            {
+              continue;
+            }
+        }
+      bool peerExact = endP->GetPeerAddress () == saddr && endP->GetPeerPort () == sport;
+      bool peerWildCard = endP->GetPeerAddress () == Ipv4Address::GetAny () && endP->GetPeerPort () == 0;
+      if (localExact && peerExact)
+        {
+          matches[3].push_back (endP);
+        }
+      if (localWildCard && peerExact)
+        {
+          matches[2].push_back (endP);
+        }
+      if (localExact && peerWildCard)
+        {
+          matches[1].push_back (endP);
+        }
+      if (localWildCard && peerWildCard)
+        {
+          matches[0].push_back (endP);
+        }
+    }
+  for (uint32_t k = 3; k > 0; k--)
+    {
+      if (!matches[k].empty ())
+        {
+          return matches[k];
+        }
+    }
+  return matches[0];
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the lookups of Ipv6EndPointDemux against a scan of its end
+ * points.
+ */
+class Ipv6EndPointDemuxTestCase
+  : public EndPointDemuxTestCase<Ipv6EndPointDemux, Ipv6EndPoint, Ipv6Address, Ipv6Interface>
+{
+public:
+  Ipv6EndPointDemuxTestCase ();
+
+private:
+  virtual EndPoints Scan (const EndPoints &endPoints, Ipv6Address daddr, uint16_t dport,
+                          Ipv6Address saddr, uint16_t sport, Ptr<Ipv6Interface> incomingInterface);
+  virtual EndPoints GetEndPoints (Ipv6EndPointDemux &demux);
+};
+
+Ipv6EndPointDemuxTestCase::Ipv6EndPointDemuxTestCase ()
+  : EndPointDemuxTestCase<Ipv6EndPointDemux, Ipv6EndPoint, Ipv6Address, Ipv6Interface>
+      ("Check the IPv6 end point demux lookups against a scan of the end points")
+{
+  const char *locals[] = {"::", "2001:1::1", "2001:2::1", "ff02::2"};
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      m_locals.push_back (Ipv6Address (locals[i]));
+    }
+  const char *peers[] = {"::", "2001:9::1", "2001:9::2"};
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      m_peers.push_back (Ipv6Address (peers[i]));
+    }
+  m_destinations = m_locals;
+  m_destinations.push_back (Ipv6Address ("2001:3::1"));
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<Ipv6Interface> interface = CreateObject<Ipv6Interface> ();
+      interface->SetDevice (CreateObject<SimpleNetDevice> ());
+      m_interfaces.push_back (interface);
+    }
+  m_interfaces.push_back (0);
+}
+
+Ipv6EndPointDemuxTestCase::EndPoints
+Ipv6EndPointDemuxTestCase::GetEndPoints (Ipv6EndPointDemux &demux)
+{
+  return demux.GetEndPoints ();
+}
+
+Ipv6EndPointDemuxTestCase::EndPoints
+Ipv6EndPointDemuxTestCase::Scan (const EndPoints &endPoints, Ipv6Address daddr, uint16_t dport,
+                                 Ipv6Address saddr, uint16_t sport, Ptr<Ipv6Interface> incomingInterface)
+{
+  EndPoints matches[4];
+  for (EndPoints::const_iterator i = endPoints.begin (); i != endPoints.end (); i++)
+    {
+      Ipv6EndPoint *endP = *i;
+      if (!endP->IsRxEnabled () || endP->GetLocalPort () != dport)
+        {
+          continue;
+        }
+      if (endP->GetBoundNetDevice ()
+          && (!incomingInterface || endP->GetBoundNetDevice () != incomingInterface->GetDevice ()))
+        {
+          continue;
+        }
+      bool localExact = endP->GetLocalAddress () == daddr;
+      bool localWildCard = endP->GetLocalAddress () == Ipv6Address::GetAny ();
+      bool localAllRouters = endP->GetLocalAddress () == Ipv6Address::GetAllRoutersMulticast ();
+      if (!(localExact || localWildCard))
+        {
+          continue;
+        }
+      bool peerExact = endP->GetPeerAddress () == saddr && endP->GetPeerPort () == sport;
+      bool peerWildCard = endP->GetPeerAddress () == Ipv6Address::GetAny () && endP->GetPeerPort () == 0;
+      if (localWildCard && peerWildCard)
+        {
+          matches[0].push_back (endP);
+        }
+      if ((localExact || localAllRouters) && peerWildCard)
+        {
+          matches[1].push_back (endP);
+        }
+      if (localWildCard && peerExact)
+        {
+          matches[2].push_back (endP);
+        }
+      if (localExact && peerExact)
+        {
+          matches[3].push_back (endP);
+        }
+    }
+  for (uint32_t k = 3; k > 0; k--)
+    {
+      if (!matches[k].empty ())
+        {
+          return matches[k];
+        }
+    }
+  return matches[0];
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief End point demux TestSuite
+ */
+class EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  EndPointDemuxTestSuite ();
+};
+
+EndPointDemuxTestSuite::EndPointDemuxTestSuite ()
+  : TestSuite ("end-point-demux", UNIT)
+{
+  AddTestCase (new Ipv4EndPointDemuxTestCase, TestCase::QUICK);
+  AddTestCase (new Ipv6EndPointDemuxTestCase, TestCase::QUICK);
+}
+
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite; //!< Static variable for test initialization
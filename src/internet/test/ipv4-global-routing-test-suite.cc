@@ -14,6 +14,7 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
 #include <vector>
 #include "ns3/boolean.h"
 #include "ns3/config.h"
@@ -41,6 +42,8 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/ipv4-global-routing.h"
+#include "ns3/global-route-manager-impl.h"
+#include "ns3/global-router-interface.h"
 #include "ns3/bridge-helper.h"
 
 using namespace ns3;
@@ -1244,6 +1247,659 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Get the routing tables of global routing nodes.
+ * \param nodes the nodes
+ * \param remove whether the routes are removed
+ * \returns the routes of each node
+ */
+static std::vector<std::string>
+GetGlobalRoutes (const NodeContainer &nodes, bool remove)
+{
+  std::vector<std::string> tables;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<GlobalRouter> router = nodes.Get (i)->GetObject<GlobalRouter> ();
+      Ptr<Ipv4GlobalRouting> routing = router->GetRoutingProtocol ();
+      std::ostringstream table;
+      for (uint32_t j = 0; j < routing->GetNRoutes (); j++)
+        {
+          table << *routing->GetRoute (j) << std::endl;
+        }
+      while (remove && routing->GetNRoutes () > 0)
+        {
+          routing->RemoveRoute (0);
+        }
+      tables.push_back (table.str ());
+    }
+  return tables;
+}
+
+/**
+ * \brief Build a topology of 38 global routing nodes.
+ *
+ * Routers 0 to 23 are on a ring of point-to-point links with chords, which
+ * give many equal-cost paths.  Hosts 24 to 29 are attached to a single
+ * router, routers 0 to 3 have a stub network and router 5 injects an
+ * external route.  Routers 30 to 37 form a separate tree of point-to-point
+ * links and LANs (the SPF calculation does not support the equal-cost paths
+ * to a LAN which is not adjacent to the root).
+ *
+ * \param nodes the nodes, which are created
+ * \returns the devices of each link, in the order of the ring, the hosts, the
+ * stub networks and the tree
+ */
+static std::vector<NetDeviceContainer>
+BuildGlobalRoutingMesh (NodeContainer &nodes)
+{
+  uint32_t nRouters = 24;
+  nodes.Create (nRouters + 14);
+  InternetStackHelper internet;
+  Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+  internet.SetRoutingHelper (ipv4RoutingHelper);
+  internet.Install (nodes);
+
+  std::vector<NetDeviceContainer> links;
+  SimpleNetDeviceHelper p2pHelper;
+  p2pHelper.SetNetDevicePointToPointMode (true);
+  SimpleNetDeviceHelper lanHelper;
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.0.0.0", "255.255.255.0");
+  for (uint32_t i = 0; i < nRouters; i++)
+    {
+      std::vector<uint32_t> peers;
+      peers.push_back ((i + 1) % nRouters);
+      if (i % 3 == 0)
+        {
+          peers.push_back ((i + 7) % nRouters);
+        }
+      for (uint32_t j = 0; j < peers.size (); j++)
+        {
+          NodeContainer pair (nodes.Get (i), nodes.Get (peers[j]));
+          links.push_back (p2pHelper.Install (pair, CreateObject<SimpleChannel> ()));
+          ipv4.Assign (links.back ());
+          ipv4.NewNetwork ();
+        }
+    }
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      NodeContainer pair (nodes.Get (nRouters + i), nodes.Get (4 * i + 1));
+      links.push_back (p2pHelper.Install (pair, CreateObject<SimpleChannel> ()));
+      ipv4.Assign (links.back ());
+      ipv4.NewNetwork ();
+    }
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      links.push_back (lanHelper.Install (nodes.Get (i), CreateObject<SimpleChannel> ()));
+      ipv4.Assign (links.back ());
+      ipv4.NewNetwork ();
+    }
+  uint32_t tree[][3] = {{30, 31, 0}, {31, 32, 33}, {33, 34, 0}, {34, 35, 36}, {36, 37, 0}, {32, 0, 0}};
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      NodeContainer link;
+      for (uint32_t j = 0; j < 3 && (j == 0 || tree[i][j] != 0); j++)
+        {
+          link.Add (nodes.Get (tree[i][j]));
+        }
+      if (link.GetN () == 2)
+        {
+          links.push_back (p2pHelper.Install (link, CreateObject<SimpleChannel> ()));
+        }
+      else
+        {
+          links.push_back (lanHelper.Install (link, CreateObject<SimpleChannel> ()));
+        }
+      ipv4.Assign (links.back ());
+      ipv4.NewNetwork ();
+    }
+  // different metrics on some interfaces
+  nodes.Get (2)->GetObject<Ipv4> ()->SetMetric (1, 3);
+  nodes.Get (9)->GetObject<Ipv4> ()->SetMetric (2, 2);
+  nodes.Get (5)->GetObject<GlobalRouter> ()->InjectRoute (Ipv4Address ("172.16.0.0"), Ipv4Mask ("255.255.0.0"));
+  return links;
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the routes computed by the SPF calculations run in
+ * parallel against the LSDB snapshot are those of the sequential SPF
+ * calculations, including the order of the equal-cost routes.
+ */
+class Ipv4GlobalRoutingParallelSpfTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingParallelSpfTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ipv4GlobalRoutingParallelSpfTestCase::Ipv4GlobalRoutingParallelSpfTestCase ()
+  : TestCase ("Global routes computed in parallel against the LSDB snapshot")
+{
+}
+
+void
+Ipv4GlobalRoutingParallelSpfTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  BuildGlobalRoutingMesh (nodes);
+
+  // Routes computed by the sequential SPF calculation of each router
+  GlobalRouteManagerImpl manager;
+  manager.BuildGlobalRoutingDatabase ();
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<GlobalRouter> router = nodes.Get (i)->GetObject<GlobalRouter> ();
+      if (router->GetNumLSAs ())
+        {
+          manager.DebugSPFCalculate (router->GetRouterId ());
+        }
+    }
+  std::vector<std::string> expected = GetGlobalRoutes (nodes, true);
+  NS_TEST_ASSERT_MSG_NE (expected[0], "", "No routes computed");
+
+  uint32_t numThreads[] = {1, 4};
+  for (uint32_t t = 0; t < 2; t++)
+    {
+      Config::SetGlobal ("GlobalRoutingNumThreads", UintegerValue (numThreads[t]));
+      manager.InitializeRoutes ();
+      std::vector<std::string> tables = GetGlobalRoutes (nodes, true);
+      for (uint32_t i = 0; i < nodes.GetN (); i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (tables[i], expected[i], "Wrong routes of node " << i <<
+                                 " with " << numThreads[t] << " threads");
+        }
+    }
+  Config::SetGlobal ("GlobalRoutingNumThreads", UintegerValue (1));
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the routes updated incrementally after changes of the
+ * links are those computed from scratch, including their order.
+ */
+class Ipv4GlobalRoutingIncrementalUpdateTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingIncrementalUpdateTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Set an interface of a link up or down.
+   * \param link the devices of the link
+   * \param i the index of the device in the link
+   * \param up whether the interface is set up or down
+   */
+  void SetInterface (const NetDeviceContainer &link, uint32_t i, bool up);
+};
+
+Ipv4GlobalRoutingIncrementalUpdateTestCase::Ipv4GlobalRoutingIncrementalUpdateTestCase ()
+  : TestCase ("Global routes updated incrementally after changes of the links")
+{
+}
+
+void
+Ipv4GlobalRoutingIncrementalUpdateTestCase::SetInterface (const NetDeviceContainer &link, uint32_t i, bool up)
+{
+  Ptr<Ipv4> ipv4 = link.Get (i)->GetNode ()->GetObject<Ipv4> ();
+  int32_t interface = ipv4->GetInterfaceForDevice (link.Get (i));
+  NS_ASSERT (interface >= 0);
+  if (up)
+    {
+      ipv4->SetUp (interface);
+    }
+  else
+    {
+      ipv4->SetDown (interface);
+    }
+}
+
+void
+Ipv4GlobalRoutingIncrementalUpdateTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  std::vector<NetDeviceContainer> links = BuildGlobalRoutingMesh (nodes);
+  // links 0 to 31 are the ring and its chords, 32 to 37 the hosts, 38 to 41
+  // the stub networks and 42 to 47 the tree
+  const NetDeviceContainer &ring = links[14];       // 10 - 11
+  const NetDeviceContainer &chord = links[13];      // 9 - 16
+  const NetDeviceContainer &far = links[19];        // 14 - 15
+  const NetDeviceContainer &host = links[32];       // 24 - 1
+  const NetDeviceContainer &lan = links[45];        // 34, 35, 36
+
+  GlobalRouteManagerImpl manager;
+  GlobalRouteManagerImpl reference;
+  manager.BuildGlobalRoutingDatabase ();
+  manager.InitializeRoutes ();
+
+  uint32_t nCalculated = 0;
+  for (uint32_t step = 0; step < 14; step++)
+    {
+      switch (step)
+        {
+        case 0: SetInterface (ring, 0, false); SetInterface (ring, 1, false); break;
+        case 1: SetInterface (ring, 0, true); SetInterface (ring, 1, true); break;
+        case 2: SetInterface (chord, 0, false); break;
+        case 3: SetInterface (chord, 0, true); break;
+        case 4: SetInterface (far, 1, false); SetInterface (far, 0, false); break;
+        case 5: SetInterface (far, 0, true); SetInterface (far, 1, true); break;
+        case 6:
+          nodes.Get (15)->GetObject<Ipv4> ()->SetMetric (1, 4);
+          Config::SetGlobal ("GlobalRoutingNumThreads", UintegerValue (3));
+          break;
+        case 7: SetInterface (host, 1, false); break;
+        case 8: SetInterface (host, 1, true); break;
+        case 9: SetInterface (lan, 1, false); break;
+        case 10: SetInterface (lan, 1, true); break;
+        case 11: nodes.Get (15)->GetObject<Ipv4> ()->SetMetric (1, 1); break;
+        case 12:
+          SetInterface (links[38], 0, false);
+          SetInterface (links[40], 0, false);
+          SetInterface (links[41], 0, false);
+          break;
+        case 13:
+          SetInterface (links[38], 0, true);
+          SetInterface (links[40], 0, true);
+          SetInterface (links[41], 0, true);
+          break;
+        }
+      manager.UpdateGlobalRoutes ();
+      // the links of each step are not on all the shortest paths
+      NS_TEST_EXPECT_MSG_LT (manager.DebugGetNCalculated (), nodes.GetN (),
+                             "SPF calculation run for all the routers at step " << step);
+      nCalculated += manager.DebugGetNCalculated ();
+      std::vector<std::string> tables = GetGlobalRoutes (nodes, false);
+
+      reference.DeleteGlobalRoutes ();
+      reference.BuildGlobalRoutingDatabase ();
+      reference.InitializeRoutes ();
+      std::vector<std::string> expected = GetGlobalRoutes (nodes, false);
+      for (uint32_t i = 0; i < nodes.GetN (); i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (tables[i], expected[i], "Wrong routes of node " << i <<
+                                 " after step " << step);
+        }
+    }
+  NS_TEST_EXPECT_MSG_GT (nCalculated, 0, "No SPF calculation");
+  Config::SetGlobal ("GlobalRoutingNumThreads", UintegerValue (1));
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Look up the routes of global routing nodes to all the addresses of
+ * the nodes.
+ * \param nodes the nodes
+ * \returns the route found by each node to each address
+ */
+static std::vector<std::string>
+GetGlobalLookups (const NodeContainer &nodes)
+{
+  std::vector<Ipv4Address> addresses;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Ipv4> ipv4 = nodes.Get (i)->GetObject<Ipv4> ();
+      for (uint32_t j = 1; j < ipv4->GetNInterfaces (); j++)
+        {
+          for (uint32_t k = 0; k < ipv4->GetNAddresses (j); k++)
+            {
+              addresses.push_back (ipv4->GetAddress (j, k).GetLocal ());
+            }
+        }
+    }
+  std::vector<std::string> lookups;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Ipv4GlobalRouting> routing = nodes.Get (i)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+      std::ostringstream lookup;
+      for (uint32_t j = 0; j < addresses.size (); j++)
+        {
+          Ipv4Header header;
+          header.SetDestination (addresses[j]);
+          Socket::SocketErrno error;
+          Ptr<Ipv4Route> route = routing->RouteOutput (Create<Packet> (), header, 0, error);
+          lookup << addresses[j];
+          if (route != 0)
+            {
+              lookup << " via " << route->GetGateway () << " dev " << route->GetOutputDevice ()->GetIfIndex ();
+            }
+          lookup << std::endl;
+        }
+      lookups.push_back (lookup.str ());
+    }
+  return lookups;
+}
+
+/**
+ * \brief Set whether global routing nodes store their routes in compact
+ * route tables.
+ * \param nodes the nodes, which have no global route
+ * \param compact whether the routes are stored in compact route tables
+ * \returns the memory used by the routes of the nodes before the change
+ */
+static std::size_t
+SetCompactRoutes (const NodeContainer &nodes, bool compact)
+{
+  std::size_t bytes = 0;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Ipv4GlobalRouting> routing = nodes.Get (i)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+      bytes += routing->GetMemoryUsage ();
+      routing->SetAttribute ("CompactRoutes", BooleanValue (compact));
+    }
+  return bytes;
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the routes computed and updated in the compact route
+ * tables are those of the default routing tables, and use less memory.
+ */
+class Ipv4GlobalRoutingCompactRoutesTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingCompactRoutesTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ipv4GlobalRoutingCompactRoutesTestCase::Ipv4GlobalRoutingCompactRoutesTestCase ()
+  : TestCase ("Global routes computed and updated in compact route tables")
+{
+}
+
+void
+Ipv4GlobalRoutingCompactRoutesTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  std::vector<NetDeviceContainer> links = BuildGlobalRoutingMesh (nodes);
+
+  GlobalRouteManagerImpl manager;
+  manager.BuildGlobalRoutingDatabase ();
+  manager.InitializeRoutes ();
+  std::vector<std::string> expectedTables = GetGlobalRoutes (nodes, false);
+  std::vector<std::string> expectedLookups = GetGlobalLookups (nodes);
+  manager.DeleteGlobalRoutes ();
+  std::size_t listBytes = SetCompactRoutes (nodes, true);
+
+  manager.BuildGlobalRoutingDatabase ();
+  manager.InitializeRoutes ();
+  std::vector<std::string> tables = GetGlobalRoutes (nodes, false);
+  std::vector<std::string> lookups = GetGlobalLookups (nodes);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (tables[i], expectedTables[i], "Wrong compact routes of node " << i);
+      NS_TEST_EXPECT_MSG_EQ (lookups[i], expectedLookups[i], "Wrong compact route lookups of node " << i);
+    }
+
+  // Update the compact routes after the failure of a ring link and of a stub
+  // network, and compare them to the routes computed in the default tables
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Ptr<NetDevice> device = (i < 2) ? links[14].Get (i) : links[38].Get (0);
+      Ptr<Ipv4> ipv4 = device->GetNode ()->GetObject<Ipv4> ();
+      ipv4->SetDown (ipv4->GetInterfaceForDevice (device));
+    }
+  manager.UpdateGlobalRoutes ();
+  tables = GetGlobalRoutes (nodes, false);
+  lookups = GetGlobalLookups (nodes);
+  manager.DeleteGlobalRoutes ();
+  std::size_t compactBytes = SetCompactRoutes (nodes, false);
+  NS_TEST_EXPECT_MSG_LT (compactBytes, listBytes, "The compact routes use more memory");
+
+  manager.BuildGlobalRoutingDatabase ();
+  manager.InitializeRoutes ();
+  expectedTables = GetGlobalRoutes (nodes, false);
+  expectedLookups = GetGlobalLookups (nodes);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (tables[i], expectedTables[i], "Wrong updated compact routes of node " << i);
+      NS_TEST_EXPECT_MSG_EQ (lookups[i], expectedLookups[i], "Wrong updated compact route lookups of node " << i);
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the routes of a compact route table against those of a
+ * default routing table, while routes are added, removed and replaced.
+ */
+class Ipv4CompactRouteTableTestCase : public TestCase
+{
+public:
+  Ipv4CompactRouteTableTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Append routes through the same next hop to consecutive prefixes.
+   * \param random the random variable
+   * \param host whether the routes are host routes
+   * \param routes the vector to which the routes are appended
+   */
+  void AddRandomRoutes (Ptr<UniformRandomVariable> random, bool host,
+                        std::vector<Ipv4RoutingTableEntry> &routes);
+
+  /**
+   * \brief Check the routes of a compact route table.
+   * \param compact the routing protocol with a compact route table
+   * \param expected the routing protocol with the same routes in a default table
+   * \param random the random variable
+   * \param step the step of the test
+   */
+  void CheckRoutes (Ptr<Ipv4GlobalRouting> compact, Ptr<Ipv4GlobalRouting> expected,
+                    Ptr<UniformRandomVariable> random, uint32_t step);
+
+  Ptr<Ipv4> m_ipv4;                    //!< the IPv4 stack of the node
+  std::vector<Ptr<NetDevice> > m_oifs; //!< the output devices, and 0
+};
+
+Ipv4CompactRouteTableTestCase::Ipv4CompactRouteTableTestCase ()
+  : TestCase ("Compact route table against the default routing table")
+{
+}
+
+void
+Ipv4CompactRouteTableTestCase::AddRandomRoutes (Ptr<UniformRandomVariable> random, bool host,
+                                                std::vector<Ipv4RoutingTableEntry> &routes)
+{
+  uint8_t lengths[] = {0, 8, 16, 24, 24, 29, 30, 32};
+  uint32_t length = host ? 32 : lengths[random->GetInteger (0, 7)];
+  Ipv4Mask mask (length == 0 ? 0 : 0xffffffff << (32 - length));
+  uint32_t address = 0x0a000000 | (random->GetInteger (0, 1) << 16) | (random->GetInteger (0, 7) << 8)
+    | random->GetInteger (0, 15);
+  if (!host && random->GetInteger (0, 3) > 0)
+    {
+      address &= mask.Get ();
+    }
+  uint32_t interface = random->GetInteger (1, 3);
+  Ipv4Address gateway = Ipv4Address::GetZero ();
+  if (length == 0 || random->GetInteger (0, 2) > 0)
+    {
+      gateway = Ipv4Address (m_ipv4->GetAddress (interface, 0).GetLocal ().Get () + random->GetInteger (1, 2));
+    }
+  uint32_t n = random->GetInteger (1, 4);
+  for (uint32_t j = 0; j < n; j++)
+    {
+      routes.push_back (Ipv4RoutingTableEntry::CreateNetworkRouteTo (Ipv4Address (address), mask, gateway,
+                                                                     interface));
+      address += (length == 0) ? 0 : 1 << (32 - length);
+    }
+}
+
+void
+Ipv4CompactRouteTableTestCase::CheckRoutes (Ptr<Ipv4GlobalRouting> compact, Ptr<Ipv4GlobalRouting> expected,
+                                            Ptr<UniformRandomVariable> random, uint32_t step)
+{
+  NS_TEST_ASSERT_MSG_EQ (compact->GetNHostRoutes (), expected->GetNHostRoutes (),
+                         "Wrong number of host routes at step " << step);
+  NS_TEST_ASSERT_MSG_EQ (compact->GetNNetworkRoutes (), expected->GetNNetworkRoutes (),
+                         "Wrong number of network routes at step " << step);
+  NS_TEST_ASSERT_MSG_EQ (compact->GetNASExternalRoutes (), expected->GetNASExternalRoutes (),
+                         "Wrong number of external routes at step " << step);
+  for (uint32_t i = 0; i < expected->GetNRoutes (); i++)
+    {
+      std::ostringstream route;
+      std::ostringstream expectedRoute;
+      route << *compact->GetRoute (i);
+      expectedRoute << *expected->GetRoute (i);
+      NS_TEST_ASSERT_MSG_EQ (route.str (), expectedRoute.str (), "Wrong route " << i << " at step " << step);
+    }
+  for (uint32_t k = 0; k < 20; k++)
+    {
+      Ipv4Header header;
+      header.SetDestination (Ipv4Address (0x0a000000 | (random->GetInteger (0, 1) << 16)
+                                          | (random->GetInteger (0, 9) << 8) | random->GetInteger (0, 15)));
+      Ptr<NetDevice> oif = m_oifs[random->GetInteger (0, 3)];
+      Socket::SocketErrno error;
+      Ptr<Ipv4Route> route = compact->RouteOutput (Create<Packet> (), header, oif, error);
+      Ptr<Ipv4Route> expectedRoute = expected->RouteOutput (Create<Packet> (), header, oif, error);
+      NS_TEST_ASSERT_MSG_EQ ((route != 0), (expectedRoute != 0),
+                             "Wrong route presence for " << header.GetDestination () << " at step " << step);
+      if (route != 0)
+        {
+          NS_TEST_ASSERT_MSG_EQ (route->GetDestination (), expectedRoute->GetDestination (),
+                                 "Wrong route for " << header.GetDestination () << " at step " << step);
+          NS_TEST_ASSERT_MSG_EQ (route->GetGateway (), expectedRoute->GetGateway (),
+                                 "Wrong route for " << header.GetDestination () << " at step " << step);
+          NS_TEST_ASSERT_MSG_EQ (route->GetOutputDevice (), expectedRoute->GetOutputDevice (),
+                                 "Wrong route for " << header.GetDestination () << " at step " << step);
+        }
+    }
+}
+
+void
+Ipv4CompactRouteTableTestCase::DoRun (void)
+{
+  // A node with three interfaces
+  NodeContainer nodes;
+  nodes.Create (2);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  SimpleNetDeviceHelper devices;
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("192.168.0.0", "255.255.255.0");
+  m_oifs.assign (1, 0);
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      NetDeviceContainer link = devices.Install (nodes);
+      ipv4.Assign (link);
+      ipv4.NewNetwork ();
+      m_oifs.push_back (link.Get (0));
+    }
+  m_ipv4 = nodes.Get (0)->GetObject<Ipv4> ();
+
+  Ptr<Ipv4GlobalRouting> expected = CreateObject<Ipv4GlobalRouting> ();
+  expected->SetIpv4 (m_ipv4);
+  Ptr<Ipv4GlobalRouting> compact = CreateObject<Ipv4GlobalRouting> ();
+  compact->SetAttribute ("CompactRoutes", BooleanValue (true));
+  compact->SetIpv4 (m_ipv4);
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (3);
+  for (uint32_t step = 0; step < 300; step++)
+    {
+      uint32_t list = random->GetInteger (0, 2);
+      std::vector<Ipv4RoutingTableEntry> routes;
+      AddRandomRoutes (random, list == 0, routes);
+      for (Ptr<Ipv4GlobalRouting> routing : {expected, compact})
+        {
+          for (std::size_t j = 0; j < routes.size (); j++)
+            {
+              const Ipv4RoutingTableEntry &r = routes[j];
+              if (list == 0)
+                {
+                  routing->AddHostRouteTo (r.GetDest (), r.GetGateway (), r.GetInterface ());
+                }
+              else if (list == 1)
+                {
+                  routing->AddNetworkRouteTo (r.GetDest (), r.GetDestNetworkMask (), r.GetGateway (),
+                                              r.GetInterface ());
+                }
+              else
+                {
+                  routing->AddASExternalRouteTo (r.GetDest (), r.GetDestNetworkMask (), r.GetGateway (),
+                                                 r.GetInterface ());
+                }
+            }
+        }
+
+      if (step % 5 == 4)
+        {
+          uint32_t i = random->GetInteger (0, expected->GetNRoutes () - 1);
+          expected->RemoveRoute (i);
+          compact->RemoveRoute (i);
+        }
+      if (step % 7 == 6 || step == 150 || step == 250)
+        {
+          // Replace a range of a list by some of its routes and new ones, or
+          // a whole list by itself at step 150 and reversed at step 250
+          list = random->GetInteger (0, 2);
+          uint32_t offset = (list > 0 ? expected->GetNHostRoutes () : 0)
+            + (list > 1 ? expected->GetNNetworkRoutes () : 0);
+          uint32_t size = (list == 0) ? expected->GetNHostRoutes ()
+            : (list == 1) ? expected->GetNNetworkRoutes () : expected->GetNASExternalRoutes ();
+          uint32_t first = (step % 50 == 0) ? 0 : random->GetInteger (0, size);
+          uint32_t n = (step % 50 == 0) ? size : random->GetInteger (0, std::min<uint32_t> (4, size - first));
+          routes.clear ();
+          for (uint32_t k = 0; k < n; k++)
+            {
+              if (step % 50 == 0 || random->GetInteger (0, 2) > 0)
+                {
+                  routes.push_back (*expected->GetRoute (offset + first + k));
+                }
+            }
+          if (step == 250)
+            {
+              std::reverse (routes.begin (), routes.end ());
+            }
+          else if (step % 50 != 0 && random->GetInteger (0, 1) > 0)
+            {
+              AddRandomRoutes (random, list == 0, routes);
+            }
+          for (Ptr<Ipv4GlobalRouting> routing : {expected, compact})
+            {
+              if (list == 0)
+                {
+                  routing->ReplaceHostRoutes (first, n, routes);
+                }
+              else if (list == 1)
+                {
+                  routing->ReplaceNetworkRoutes (first, n, routes);
+                }
+              else
+                {
+                  routing->ReplaceASExternalRoutes (first, n, routes);
+                }
+            }
+        }
+
+      CheckRoutes (compact, expected, random, step);
+    }
+
+  expected->Dispose ();
+  compact->Dispose ();
+  m_ipv4 = 0;
+  m_oifs.clear ();
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup internet-test
  * \ingroup tests
@@ -1267,6 +1923,10 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite ()
     AddTestCase (new TwoBridgeTest, TestCase::QUICK);
     AddTestCase (new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
     AddTestCase (new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4GlobalRoutingParallelSpfTestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4GlobalRoutingIncrementalUpdateTestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4GlobalRoutingCompactRoutesTestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4CompactRouteTableTestCase, TestCase::QUICK);
   }
 
 static Ipv4GlobalRoutingTestSuite g_globalRoutingTestSuite; //!< Static variable for test initialization
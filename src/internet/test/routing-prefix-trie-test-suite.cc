@@ -0,0 +1,516 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+// Tests of the prefix trie used by the routing protocols, and of the
+// indexed route lookups of Ipv4GlobalRouting, Ipv4StaticRouting and
+// Ipv6StaticRouting against a scan of their routing tables.
+
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/ipv6-route.h"
+#include "ns3/ipv6-static-routing.h"
+#include "ns3/ipv6-routing-table-entry.h"
+#include "ns3/routing-prefix-trie.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the prefixes found by RoutingPrefixTrie against a list of
+ * prefixes.
+ */
+class RoutingPrefixTrieTestCase : public TestCase
+{
+public:
+  RoutingPrefixTrieTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// A prefix and its value
+  struct Prefix
+  {
+    uint32_t address; //!< the prefix
+    uint8_t length;   //!< the prefix length
+    uint32_t value;   //!< the value
+  };
+
+  /**
+   * \brief Check the values found for an address.
+   * \param trie the trie
+   * \param prefixes the prefixes in the trie
+   * \param address the address
+   */
+  void CheckLookup (const RoutingPrefixTrie<4, uint32_t> &trie, const std::vector<Prefix> &prefixes,
+                    uint32_t address);
+};
+
+RoutingPrefixTrieTestCase::RoutingPrefixTrieTestCase ()
+  : TestCase ("Check the prefixes found by the routing prefix trie")
+{
+}
+
+/**
+ * \param address an address
+ * \param length a prefix length
+ * \returns the address masked by the prefix length
+ */
+static uint32_t
+MaskAddress (uint32_t address, uint8_t length)
+{
+  return length == 0 ? 0 : address & (0xffffffff << (32 - length));
+}
+
+void
+RoutingPrefixTrieTestCase::CheckLookup (const RoutingPrefixTrie<4, uint32_t> &trie,
+                                        const std::vector<Prefix> &prefixes, uint32_t address)
+{
+  // The values of the matching prefixes, by increasing length then insertion
+  std::vector<uint32_t> expected;
+  for (uint32_t length = 0; length <= 32; length++)
+    {
+      for (std::size_t i = 0; i < prefixes.size (); i++)
+        {
+          if (prefixes[i].length == length
+              && MaskAddress (prefixes[i].address, length) == MaskAddress (address, length))
+            {
+              expected.push_back (prefixes[i].value);
+            }
+        }
+    }
+
+  uint8_t bytes[4];
+  Ipv4Address (address).Serialize (bytes);
+  std::vector<const RoutingPrefixTrie<4, uint32_t>::Values *> matches;
+  trie.Lookup (bytes, matches);
+  std::vector<uint32_t> found;
+  for (std::size_t i = 0; i < matches.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (matches[i]->empty (), false, "Empty prefix returned");
+      found.insert (found.end (), matches[i]->begin (), matches[i]->end ());
+    }
+  NS_TEST_ASSERT_MSG_EQ (found.size (), expected.size (), "Wrong number of values for " << Ipv4Address (address));
+  for (std::size_t i = 0; i < found.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (found[i], expected[i], "Wrong value for " << Ipv4Address (address));
+    }
+}
+
+void
+RoutingPrefixTrieTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  RoutingPrefixTrie<4, uint32_t> trie;
+  std::vector<Prefix> prefixes;
+  for (uint32_t value = 0; value < 400; value++)
+    {
+      // Addresses in a small space, so that prefixes are nested and shared
+      Prefix prefix;
+      prefix.address = 0x0a000000 | (random->GetInteger (0, 3) << 16) | (random->GetInteger (0, 3) << 8)
+        | random->GetInteger (0, 15);
+      prefix.length = random->GetInteger (0, 32);
+      prefix.value = value;
+      uint8_t bytes[4];
+      Ipv4Address (prefix.address).Serialize (bytes);
+      trie.Insert (bytes, prefix.length, value);
+      prefixes.push_back (prefix);
+
+      if (value % 5 == 4)
+        {
+          // Remove a random prefix
+          std::size_t i = random->GetInteger (0, prefixes.size () - 1);
+          Ipv4Address (prefixes[i].address).Serialize (bytes);
+          NS_TEST_ASSERT_MSG_EQ (trie.Remove (bytes, prefixes[i].length, prefixes[i].value), true,
+                                 "Prefix not found");
+          NS_TEST_ASSERT_MSG_EQ (trie.Remove (bytes, prefixes[i].length, prefixes[i].value), false,
+                                 "Prefix removed twice");
+          prefixes.erase (prefixes.begin () + i);
+        }
+      for (uint32_t k = 0; k < 8; k++)
+        {
+          CheckLookup (trie, prefixes, 0x0a000000 | (random->GetInteger (0, 3) << 16)
+                       | (random->GetInteger (0, 3) << 8) | random->GetInteger (0, 15));
+        }
+    }
+  CheckLookup (trie, prefixes, 0xc0a80001);
+
+  trie.Clear ();
+  prefixes.clear ();
+  CheckLookup (trie, prefixes, 0x0a000001);
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the routes found by the route index of Ipv4StaticRouting,
+ * Ipv4GlobalRouting and Ipv6StaticRouting against a scan of their
+ * routing tables, while routes are added and removed.
+ */
+class RoutingIndexLookupTestCase : public TestCase
+{
+public:
+  RoutingIndexLookupTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param random the random variable
+   * \returns a random IPv4 address of a small address space
+   */
+  static Ipv4Address GetIpv4Address (Ptr<UniformRandomVariable> random);
+
+  /**
+   * \param random the random variable
+   * \returns a random IPv6 address of a small address space
+   */
+  static Ipv6Address GetIpv6Address (Ptr<UniformRandomVariable> random);
+
+  /**
+   * \brief Check the route of Ipv4StaticRouting to a destination.
+   * \param routing the routing protocol
+   * \param dest the destination
+   * \param oif the output device, or 0
+   */
+  void CheckIpv4Static (Ptr<Ipv4StaticRouting> routing, Ipv4Address dest, Ptr<NetDevice> oif);
+
+  /**
+   * \brief Check the route of Ipv4GlobalRouting to a destination.
+   * \param routing the routing protocol
+   * \param dest the destination
+   * \param oif the output device, or 0
+   */
+  void CheckIpv4Global (Ptr<Ipv4GlobalRouting> routing, Ipv4Address dest, Ptr<NetDevice> oif);
+
+  /**
+   * \brief Check the route of Ipv6StaticRouting to a destination.
+   * \param routing the routing protocol
+   * \param dest the destination
+   * \param oif the output device, or 0
+   */
+  void CheckIpv6Static (Ptr<Ipv6StaticRouting> routing, Ipv6Address dest, Ptr<NetDevice> oif);
+
+  Ptr<Ipv4> m_ipv4; //!< the IPv4 stack of the node
+  Ptr<Ipv6> m_ipv6; //!< the IPv6 stack of the node
+};
+
+RoutingIndexLookupTestCase::RoutingIndexLookupTestCase ()
+  : TestCase ("Check the indexed route lookups against a scan of the routing tables")
+{
+}
+
+Ipv4Address
+RoutingIndexLookupTestCase::GetIpv4Address (Ptr<UniformRandomVariable> random)
+{
+  return Ipv4Address (0x0a000000 | (random->GetInteger (0, 1) << 16) | (random->GetInteger (0, 3) << 8)
+                      | random->GetInteger (0, 7));
+}
+
+Ipv6Address
+RoutingIndexLookupTestCase::GetIpv6Address (Ptr<UniformRandomVariable> random)
+{
+  uint8_t bytes[16] = {0x20, 0x01, 0x0d, 0xb8};
+  bytes[5] = random->GetInteger (0, 1);
+  bytes[7] = random->GetInteger (0, 3);
+  bytes[15] = random->GetInteger (0, 7);
+  return Ipv6Address (bytes);
+}
+
+void
+RoutingIndexLookupTestCase::CheckIpv4Static (Ptr<Ipv4StaticRouting> routing, Ipv4Address dest,
+                                             Ptr<NetDevice> oif)
+{
+  // The route found by scanning the table, as done before the index
+  int32_t expected = -1;
+  uint16_t longestMask = 0;
+  uint32_t shortestMetric = 0xffffffff;
+  for (uint32_t i = 0; i < routing->GetNRoutes (); i++)
+    {
+      Ipv4RoutingTableEntry route = routing->GetRoute (i);
+      uint32_t metric = routing->GetMetric (i);
+      Ipv4Mask mask = route.GetDestNetworkMask ();
+      uint16_t masklen = mask.GetPrefixLength ();
+      if (!mask.IsMatch (dest, route.GetDestNetwork ())
+          || (oif != 0 && oif != m_ipv4->GetNetDevice (route.GetInterface ()))
+          || masklen < longestMask)
+        {
+          continue;
+        }
+      if (masklen > longestMask)
+        {
+          shortestMetric = 0xffffffff;
+        }
+      longestMask = masklen;
+      if (metric > shortestMetric)
+        {
+          continue;
+        }
+      shortestMetric = metric;
+      expected = i;
+      if (masklen == 32)
+        {
+          break;
+        }
+    }
+
+  Ipv4Header header;
+  header.SetDestination (dest);
+  Socket::SocketErrno error;
+  Ptr<Ipv4Route> found = routing->RouteOutput (Create<Packet> (), header, oif, error);
+  NS_TEST_ASSERT_MSG_EQ ((found != 0), (expected >= 0), "Wrong route presence for " << dest);
+  if (found != 0)
+    {
+      Ipv4RoutingTableEntry route = routing->GetRoute (expected);
+      NS_TEST_ASSERT_MSG_EQ (found->GetDestination (), route.GetDest (), "Wrong route for " << dest);
+      NS_TEST_ASSERT_MSG_EQ (found->GetGateway (), route.GetGateway (), "Wrong route for " << dest);
+      NS_TEST_ASSERT_MSG_EQ (found->GetOutputDevice (), m_ipv4->GetNetDevice (route.GetInterface ()),
+                             "Wrong route for " << dest);
+    }
+}
+
+void
+RoutingIndexLookupTestCase::CheckIpv4Global (Ptr<Ipv4GlobalRouting> routing, Ipv4Address dest,
+                                             Ptr<NetDevice> oif)
+{
+  // The first host route to the destination, else the first matching network
+  // route, else the first matching external route
+  uint32_t ends[3] = {routing->GetNHostRoutes (),
+                      routing->GetNHostRoutes () + routing->GetNNetworkRoutes (),
+                      routing->GetNRoutes ()};
+  int32_t expected = -1;
+  for (uint32_t i = 0, list = 0; list < 3 && expected < 0; list++)
+    {
+      for (; i < ends[list] && expected < 0; i++)
+        {
+          Ipv4RoutingTableEntry *route = routing->GetRoute (i);
+          bool match = (list == 0) ? route->GetDest () == dest
+            : route->GetDestNetworkMask ().IsMatch (dest, route->GetDestNetwork ());
+          if (match && (oif == 0 || oif == m_ipv4->GetNetDevice (route->GetInterface ())))
+            {
+              expected = i;
+            }
+        }
+    }
+
+  Ipv4Header header;
+  header.SetDestination (dest);
+  Socket::SocketErrno error;
+  Ptr<Ipv4Route> found = routing->RouteOutput (Create<Packet> (), header, oif, error);
+  NS_TEST_ASSERT_MSG_EQ ((found != 0), (expected >= 0), "Wrong route presence for " << dest);
+  if (found != 0)
+    {
+      Ipv4RoutingTableEntry *route = routing->GetRoute (expected);
+      NS_TEST_ASSERT_MSG_EQ (found->GetDestination (), route->GetDest (), "Wrong route for " << dest);
+      NS_TEST_ASSERT_MSG_EQ (found->GetGateway (), route->GetGateway (), "Wrong route for " << dest);
+      NS_TEST_ASSERT_MSG_EQ (found->GetOutputDevice (), m_ipv4->GetNetDevice (route->GetInterface ()),
+                             "Wrong route for " << dest);
+    }
+}
+
+void
+RoutingIndexLookupTestCase::CheckIpv6Static (Ptr<Ipv6StaticRouting> routing, Ipv6Address dest,
+                                             Ptr<NetDevice> oif)
+{
+  int32_t expected = -1;
+  uint16_t longestMask = 0;
+  uint32_t shortestMetric = 0xffffffff;
+  for (uint32_t i = 0; i < routing->GetNRoutes (); i++)
+    {
+      Ipv6RoutingTableEntry route = routing->GetRoute (i);
+      uint32_t metric = routing->GetMetric (i);
+      Ipv6Prefix mask = route.GetDestNetworkPrefix ();
+      uint16_t maskLen = mask.GetPrefixLength ();
+      if (!mask.IsMatch (dest, route.GetDestNetwork ())
+          || (oif != 0 && oif != m_ipv6->GetNetDevice (route.GetInterface ()))
+          || maskLen < longestMask)
+        {
+          continue;
+        }
+      if (maskLen > longestMask)
+        {
+          shortestMetric = 0xffffffff;
+        }
+      longestMask = maskLen;
+      if (metric > shortestMetric)
+        {
+          continue;
+        }
+      shortestMetric = metric;
+      expected = i;
+      if (maskLen == 128)
+        {
+          break;
+        }
+    }
+
+  Ipv6Header header;
+  header.SetDestination (dest);
+  Socket::SocketErrno error;
+  Ptr<Ipv6Route> found = routing->RouteOutput (Create<Packet> (), header, oif, error);
+  NS_TEST_ASSERT_MSG_EQ ((found != 0), (expected >= 0), "Wrong route presence for " << dest);
+  if (found != 0)
+    {
+      Ipv6RoutingTableEntry route = routing->GetRoute (expected);
+      NS_TEST_ASSERT_MSG_EQ (found->GetDestination (), route.GetDest (), "Wrong route for " << dest);
+      NS_TEST_ASSERT_MSG_EQ (found->GetGateway (), route.GetGateway (), "Wrong route for " << dest);
+      NS_TEST_ASSERT_MSG_EQ (found->GetOutputDevice (), m_ipv6->GetNetDevice (route.GetInterface ()),
+                             "Wrong route for " << dest);
+    }
+}
+
+void
+RoutingIndexLookupTestCase::DoRun (void)
+{
+  // A node with three interfaces
+  NodeContainer nodes;
+  nodes.Create (2);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  SimpleNetDeviceHelper devices;
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("192.168.0.0", "255.255.255.0");
+  Ipv6AddressHelper ipv6;
+  ipv6.SetBase (Ipv6Address ("2001:db8:ffff::"), Ipv6Prefix (64));
+  std::vector<Ptr<NetDevice> > oifs (1, 0);
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      NetDeviceContainer link = devices.Install (nodes);
+      ipv4.Assign (link);
+      ipv4.NewNetwork ();
+      ipv6.Assign (link);
+      ipv6.NewNetwork ();
+      oifs.push_back (link.Get (0));
+    }
+  m_ipv4 = nodes.Get (0)->GetObject<Ipv4> ();
+  m_ipv6 = nodes.Get (0)->GetObject<Ipv6> ();
+
+  Ptr<Ipv4StaticRouting> ipv4Static = CreateObject<Ipv4StaticRouting> ();
+  ipv4Static->SetIpv4 (m_ipv4);
+  Ptr<Ipv4GlobalRouting> ipv4Global = CreateObject<Ipv4GlobalRouting> ();
+  ipv4Global->SetIpv4 (m_ipv4);
+  Ptr<Ipv6StaticRouting> ipv6Static = CreateObject<Ipv6StaticRouting> ();
+  ipv6Static->SetIpv6 (m_ipv6);
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (2);
+  uint8_t ipv4Lengths[] = {0, 8, 15, 16, 22, 24, 29, 30, 32, 32};
+  uint8_t ipv6Lengths[] = {0, 32, 46, 48, 55, 56, 64, 125, 128, 128};
+  for (uint32_t step = 0; step < 300; step++)
+    {
+      uint32_t interface = random->GetInteger (1, 3);
+      uint32_t metric = random->GetInteger (0, 2);
+      Ipv4Address gateway4 = m_ipv4->GetAddress (interface, 0).GetLocal ();
+      uint32_t length = ipv4Lengths[random->GetInteger (0, 9)];
+      Ipv4Address network = GetIpv4Address (random);
+      Ipv4Mask mask (length == 0 ? 0 : 0xffffffff << (32 - length));
+      ipv4Static->AddNetworkRouteTo (network, mask, gateway4, interface, metric);
+      switch (random->GetInteger (0, 2))
+        {
+        case 0:
+          ipv4Global->AddHostRouteTo (network, gateway4, interface);
+          break;
+        case 1:
+          ipv4Global->AddNetworkRouteTo (network.CombineMask (mask), mask, gateway4, interface);
+          break;
+        default:
+          ipv4Global->AddASExternalRouteTo (network.CombineMask (mask), mask, gateway4, interface);
+          break;
+        }
+      Ipv6Address gateway6 = m_ipv6->GetAddress (interface, 0).GetAddress ();
+      ipv6Static->AddNetworkRouteTo (GetIpv6Address (random), Ipv6Prefix (ipv6Lengths[random->GetInteger (0, 9)]),
+                                     gateway6, interface, metric);
+
+      if (step % 4 == 3)
+        {
+          ipv4Static->RemoveRoute (random->GetInteger (0, ipv4Static->GetNRoutes () - 1));
+          ipv4Global->RemoveRoute (random->GetInteger (0, ipv4Global->GetNRoutes () - 1));
+          ipv6Static->RemoveRoute (random->GetInteger (0, ipv6Static->GetNRoutes () - 1));
+        }
+      if (step == 150)
+        {
+          // Replace the first network routes of the global routing table
+          std::vector<Ipv4RoutingTableEntry> routes;
+          routes.push_back (Ipv4RoutingTableEntry::CreateNetworkRouteTo ("10.0.0.0", "255.255.0.0", gateway4,
+                                                                         interface));
+          ipv4Global->ReplaceNetworkRoutes (0, std::min<uint32_t> (3, ipv4Global->GetNNetworkRoutes ()), routes);
+        }
+      if (step == 200)
+        {
+          // A non-contiguous mask disables the index until it is removed
+          ipv4Static->AddNetworkRouteTo ("10.0.0.0", "255.0.255.0", gateway4, interface, 0);
+          ipv4Global->AddNetworkRouteTo ("10.0.0.0", "255.0.255.0", gateway4, interface);
+        }
+      if (step == 250)
+        {
+          ipv4Static->RemoveRoute (ipv4Static->GetNRoutes () - 1);
+          ipv4Global->RemoveRoute (ipv4Global->GetNHostRoutes () + ipv4Global->GetNNetworkRoutes () - 1);
+        }
+
+      for (uint32_t k = 0; k < 10; k++)
+        {
+          Ptr<NetDevice> oif = oifs[random->GetInteger (0, 3)];
+          CheckIpv4Static (ipv4Static, GetIpv4Address (random), oif);
+          CheckIpv4Global (ipv4Global, GetIpv4Address (random), oif);
+          CheckIpv6Static (ipv6Static, GetIpv6Address (random), oif);
+        }
+    }
+
+  ipv4Static->Dispose ();
+  ipv4Global->Dispose ();
+  ipv6Static->Dispose ();
+  m_ipv4 = 0;
+  m_ipv6 = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Routing prefix trie TestSuite
+ */
+class RoutingPrefixTrieTestSuite : public TestSuite
+{
+public:
+  RoutingPrefixTrieTestSuite ();
+};
+
+RoutingPrefixTrieTestSuite::RoutingPrefixTrieTestSuite ()
+  : TestSuite ("routing-prefix-trie", UNIT)
+{
+  AddTestCase (new RoutingPrefixTrieTestCase, TestCase::QUICK);
+  AddTestCase (new RoutingIndexLookupTestCase, TestCase::QUICK);
+}
+
+static RoutingPrefixTrieTestSuite g_routingPrefixTrieTestSuite; //!< Static variable for test initialization
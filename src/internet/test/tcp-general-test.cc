@@ -1305,7 +1305,7 @@ TcpSocketSmallAcks::SendEmptyPacket (uint8_t flags)
       NS_LOG_LOGIC ("Schedule retransmission timeout at time "
                     << Simulator::Now ().GetSeconds () << " to expire at time "
                     << (Simulator::Now () + m_rto.Get ()).GetSeconds ());
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketSmallAcks::SendEmptyPacket, this, flags);
+      m_retxEvent.Schedule (m_rto, &TcpSocketSmallAcks::SendEmptyPacket, this, flags);
     }
 
   // send another ACK if bytes remain
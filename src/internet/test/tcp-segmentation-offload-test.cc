@@ -0,0 +1,567 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <list>
+
+#include "ns3/test.h"
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/traffic-control-helper.h"
+#include "ns3/segmentation-offload-tag.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpSegmentationOffloadTest");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the segments of a super-segment split by TcpL4Protocol.
+ */
+class TcpSegmentationOffloadSplitTest : public TestCase
+{
+public:
+  TcpSegmentationOffloadSplitTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpSegmentationOffloadSplitTest::TcpSegmentationOffloadSplitTest ()
+  : TestCase ("Split a super-segment into segments")
+{
+}
+
+void
+TcpSegmentationOffloadSplitTest::DoRun (void)
+{
+  Ptr<Packet> packet = Create<Packet> (5000);
+  TcpHeader header;
+  header.SetSequenceNumber (SequenceNumber32 (1000));
+  header.SetAckNumber (SequenceNumber32 (7));
+  header.SetFlags (TcpHeader::ACK | TcpHeader::PSH | TcpHeader::FIN);
+  packet->AddHeader (header);
+  packet->AddPacketTag (SegmentationOffloadTag (5000, 1448));
+
+  std::list<Ptr<Packet> > segments;
+  TcpL4Protocol::Segment (packet, segments);
+  NS_TEST_ASSERT_MSG_EQ (segments.size (), 4, "Wrong number of segments");
+
+  uint32_t offset = 0;
+  for (std::list<Ptr<Packet> >::iterator it = segments.begin (); it != segments.end (); it++)
+    {
+      SegmentationOffloadTag offload;
+      NS_TEST_ASSERT_MSG_EQ ((*it)->PeekPacketTag (offload), false, "A segment is tagged as a super-segment");
+      TcpHeader segmentHeader;
+      (*it)->RemoveHeader (segmentHeader);
+      bool last = offset + 1448 >= 5000;
+      uint32_t size = last ? 5000 - 3 * 1448 : 1448;
+      NS_TEST_ASSERT_MSG_EQ ((*it)->GetSize (), size, "Wrong segment size");
+      NS_TEST_ASSERT_MSG_EQ (segmentHeader.GetSequenceNumber (), SequenceNumber32 (1000 + offset),
+                             "Wrong sequence number");
+      NS_TEST_ASSERT_MSG_EQ (segmentHeader.GetAckNumber (), SequenceNumber32 (7), "Wrong ACK number");
+      uint8_t flags = last ? TcpHeader::ACK | TcpHeader::PSH | TcpHeader::FIN : TcpHeader::ACK;
+      NS_TEST_ASSERT_MSG_EQ (uint32_t (segmentHeader.GetFlags ()), uint32_t (flags), "Wrong flags");
+      offset += (*it)->GetSize ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (offset, 5000, "Wrong total payload");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that a super-segment is split before the queue discs, the
+ * receive error models and the device queues which would drop some of its
+ * segments.
+ */
+class TcpSegmentationOffloadFateTest : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param description The description of the test.
+   * \param queueDisc True to install a queue disc on the sender device.
+   * \param errorModel True to set a receive error model on the receiver device.
+   * \param queueSize The size of the queue of the sender device.
+   * \param enqueued The expected number of packets enqueued by the sender device.
+   * \param dropped The expected number of packets dropped by the sender device.
+   */
+  TcpSegmentationOffloadFateTest (std::string description, bool queueDisc, bool errorModel,
+                                  std::string queueSize, uint32_t enqueued, uint32_t dropped);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Count the packets enqueued by the sender device.
+   * \param packet The packet.
+   */
+  void Enqueue (Ptr<const Packet> packet);
+  /**
+   * Count the packets dropped by the sender device.
+   * \param packet The packet.
+   */
+  void Drop (Ptr<const Packet> packet);
+
+  bool m_queueDisc;      //!< True to install a queue disc
+  bool m_errorModel;     //!< True to set a receive error model
+  std::string m_queueSize; //!< The size of the device queue
+  uint32_t m_enqueued;   //!< The expected number of packets enqueued
+  uint32_t m_dropped;    //!< The expected number of packets dropped
+  uint32_t m_nEnqueued;  //!< The number of packets enqueued
+  uint32_t m_nDropped;   //!< The number of packets dropped
+};
+
+TcpSegmentationOffloadFateTest::TcpSegmentationOffloadFateTest (std::string description,
+                                                                bool queueDisc, bool errorModel,
+                                                                std::string queueSize,
+                                                                uint32_t enqueued, uint32_t dropped)
+  : TestCase ("Send a super-segment " + description),
+    m_queueDisc (queueDisc),
+    m_errorModel (errorModel),
+    m_queueSize (queueSize),
+    m_enqueued (enqueued),
+    m_dropped (dropped),
+    m_nEnqueued (0),
+    m_nDropped (0)
+{
+}
+
+void
+TcpSegmentationOffloadFateTest::Enqueue (Ptr<const Packet> packet)
+{
+  m_nEnqueued++;
+}
+
+void
+TcpSegmentationOffloadFateTest::Drop (Ptr<const Packet> packet)
+{
+  m_nDropped++;
+}
+
+void
+TcpSegmentationOffloadFateTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  NetDeviceContainer devices;
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      device->SetAttribute ("PointToPointMode", BooleanValue (true));
+      device->SetAttribute ("DataRate", DataRateValue (DataRate ("10Mbps")));
+      Ptr<Queue<Packet> > queue = CreateObject<DropTailQueue<Packet> > ();
+      queue->SetAttribute ("MaxSize", QueueSizeValue (QueueSize (m_queueSize)));
+      device->SetQueue (queue);
+      device->SetChannel (channel);
+      nodes.Get (i)->AddDevice (device);
+      devices.Add (device);
+    }
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = ipv4.Assign (devices);
+
+  Ptr<SimpleNetDevice> sender = DynamicCast<SimpleNetDevice> (devices.Get (0));
+  sender->GetQueue ()->TraceConnectWithoutContext ("Enqueue",
+    MakeCallback (&TcpSegmentationOffloadFateTest::Enqueue, this));
+  sender->GetQueue ()->TraceConnectWithoutContext ("Drop",
+    MakeCallback (&TcpSegmentationOffloadFateTest::Drop, this));
+  if (m_queueDisc)
+    {
+      TrafficControlHelper tch;
+      tch.SetRootQueueDisc ("ns3::FifoQueueDisc");
+      tch.Install (sender);
+    }
+  if (m_errorModel)
+    {
+      Ptr<ReceiveListErrorModel> errorModel = CreateObject<ReceiveListErrorModel> ();
+      devices.Get (1)->SetAttribute ("ReceiveErrorModel", PointerValue (errorModel));
+    }
+
+  // A super-segment of four segments, the last one shorter
+  Ptr<Packet> packet = Create<Packet> (5000);
+  TcpHeader header;
+  header.SetSourcePort (49153);
+  header.SetDestinationPort (9);
+  header.SetFlags (TcpHeader::ACK);
+  packet->AddHeader (header);
+  packet->AddPacketTag (SegmentationOffloadTag (5000, 1448));
+  Ptr<Ipv4L3Protocol> ip = nodes.Get (0)->GetObject<Ipv4L3Protocol> ();
+  Simulator::Schedule (Seconds (1), &Ipv4L3Protocol::Send, ip, packet,
+                       interfaces.GetAddress (0), interfaces.GetAddress (1),
+                       TcpL4Protocol::PROT_NUMBER, Ptr<Ipv4Route> ());
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_nEnqueued, m_enqueued, "Wrong number of packets enqueued by the device");
+  NS_TEST_ASSERT_MSG_EQ (m_nDropped, m_dropped, "Wrong number of packets dropped by the device");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief A SimpleNetDevice without segmentation offload.
+ */
+class NoOffloadSimpleNetDevice : public SimpleNetDevice
+{
+public:
+  virtual bool SupportsSegmentationOffload (Ptr<const Packet> packet) const
+  {
+    return false;
+  }
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that a bulk transfer sent with super-segments has the same
+ * goodput and congestion window as the transfer sent segment by segment.
+ *
+ * The sender is connected to the receiver through a router and a
+ * bottleneck link with a byte-mode queue.  The transfer is run with
+ * segmentation offload disabled, then with super-segments of up to 8
+ * segments.
+ */
+class TcpSegmentationOffloadTest : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param deviceOffload True if the devices support segmentation offload.
+   * \param useIpv6 True to use IPv6.
+   */
+  TcpSegmentationOffloadTest (bool deviceOffload, bool useIpv6);
+
+private:
+  virtual void DoRun (void);
+
+  /// The results of a transfer
+  struct Result
+  {
+    uint64_t rxBytes;   //!< The bytes received after the first second
+    double cwnd;        //!< The average congestion window, in bytes
+    uint32_t txPackets; //!< The packets sent by the IP layer of the sender
+  };
+
+  /**
+   * Run a transfer.
+   * \param offload The maximum number of segments of a super-segment.
+   * \returns The results of the transfer.
+   */
+  Result Run (uint32_t offload);
+  /**
+   * Add a device on a channel.
+   * \param node The node.
+   * \param channel The channel.
+   * \param rate The data rate of the device.
+   * \param queueSize The size of the queue of the device.
+   * \returns The device.
+   */
+  Ptr<SimpleNetDevice> AddDevice (Ptr<Node> node, Ptr<SimpleChannel> channel,
+                                  std::string rate, std::string queueSize);
+  /**
+   * Fill the transmit buffer of the sender.
+   * \param socket The sender socket.
+   * \param available The space available in the buffer.
+   */
+  void Fill (Ptr<Socket> socket, uint32_t available);
+  /**
+   * Accept a connection.
+   * \param socket The accepted socket.
+   * \param from The address of the sender.
+   */
+  void Accept (Ptr<Socket> socket, const Address &from);
+  /**
+   * Read the data received.
+   * \param socket The receiver socket.
+   */
+  void Receive (Ptr<Socket> socket);
+  /**
+   * Track the congestion window.
+   * \param oldValue The old value.
+   * \param newValue The new value.
+   */
+  void CwndChange (uint32_t oldValue, uint32_t newValue);
+  /**
+   * Count the packets sent by the IPv4 layer.
+   * \param packet The packet.
+   * \param ipv4 The IPv4 protocol.
+   * \param interface The interface.
+   */
+  void Tx4 (Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+  /**
+   * Count the packets sent by the IPv6 layer.
+   * \param packet The packet.
+   * \param ipv6 The IPv6 protocol.
+   * \param interface The interface.
+   */
+  void Tx6 (Ptr<const Packet> packet, Ptr<Ipv6> ipv6, uint32_t interface);
+
+  bool m_deviceOffload;  //!< True if the devices support segmentation offload
+  bool m_useIpv6;        //!< True to use IPv6
+  Result m_result;       //!< The results of the current transfer
+  uint32_t m_cwnd;       //!< The current congestion window
+  Time m_cwndTime;       //!< The time of the last change of the window
+  double m_cwndIntegral; //!< The integral of the window since the first second
+};
+
+TcpSegmentationOffloadTest::TcpSegmentationOffloadTest (bool deviceOffload, bool useIpv6)
+  : TestCase (std::string ("Compare a transfer with and without super-segments, ")
+              + (useIpv6 ? "IPv6" : "IPv4") + ", "
+              + (deviceOffload ? "segmented by the devices" : "segmented by the IP layer")),
+    m_deviceOffload (deviceOffload),
+    m_useIpv6 (useIpv6)
+{
+}
+
+Ptr<SimpleNetDevice>
+TcpSegmentationOffloadTest::AddDevice (Ptr<Node> node, Ptr<SimpleChannel> channel,
+                                       std::string rate, std::string queueSize)
+{
+  Ptr<SimpleNetDevice> device;
+  if (m_deviceOffload)
+    {
+      device = CreateObject<SimpleNetDevice> ();
+    }
+  else
+    {
+      device = CreateObject<NoOffloadSimpleNetDevice> ();
+    }
+  device->SetAddress (Mac48Address::Allocate ());
+  device->SetAttribute ("DataRate", DataRateValue (DataRate (rate)));
+  Ptr<Queue<Packet> > queue = CreateObject<DropTailQueue<Packet> > ();
+  queue->SetAttribute ("MaxSize", QueueSizeValue (QueueSize (queueSize)));
+  device->SetQueue (queue);
+  device->SetChannel (channel);
+  node->AddDevice (device);
+  return device;
+}
+
+void
+TcpSegmentationOffloadTest::Fill (Ptr<Socket> socket, uint32_t available)
+{
+  while (socket->GetTxAvailable () > 0)
+    {
+      uint32_t size = std::min<uint32_t> (socket->GetTxAvailable (), 10000);
+      if (socket->Send (Create<Packet> (size)) < 0)
+        {
+          break;
+        }
+    }
+}
+
+void
+TcpSegmentationOffloadTest::Accept (Ptr<Socket> socket, const Address &from)
+{
+  socket->SetRecvCallback (MakeCallback (&TcpSegmentationOffloadTest::Receive, this));
+}
+
+void
+TcpSegmentationOffloadTest::Receive (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      if (Simulator::Now () >= Seconds (1))
+        {
+          m_result.rxBytes += packet->GetSize ();
+        }
+    }
+}
+
+void
+TcpSegmentationOffloadTest::CwndChange (uint32_t oldValue, uint32_t newValue)
+{
+  Time now = std::max (Simulator::Now (), Seconds (1));
+  m_cwndIntegral += (now - m_cwndTime).GetSeconds () * m_cwnd;
+  m_cwndTime = now;
+  m_cwnd = newValue;
+}
+
+void
+TcpSegmentationOffloadTest::Tx4 (Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  m_result.txPackets++;
+}
+
+void
+TcpSegmentationOffloadTest::Tx6 (Ptr<const Packet> packet, Ptr<Ipv6> ipv6, uint32_t interface)
+{
+  m_result.txPackets++;
+}
+
+TcpSegmentationOffloadTest::Result
+TcpSegmentationOffloadTest::Run (uint32_t offload)
+{
+  m_result.rxBytes = 0;
+  m_result.txPackets = 0;
+  m_cwnd = 0;
+  m_cwndTime = Seconds (1);
+  m_cwndIntegral = 0;
+
+  // sender -- router -- receiver, the link to the receiver is the bottleneck
+  NodeContainer nodes;
+  nodes.Create (3);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ptr<SimpleChannel> access = CreateObject<SimpleChannel> ();
+  access->SetAttribute ("Delay", TimeValue (MilliSeconds (1)));
+  Ptr<SimpleChannel> bottleneck = CreateObject<SimpleChannel> ();
+  bottleneck->SetAttribute ("Delay", TimeValue (MilliSeconds (10)));
+  NetDeviceContainer accessDevices;
+  accessDevices.Add (AddDevice (nodes.Get (0), access, "100Mbps", "200000B"));
+  accessDevices.Add (AddDevice (nodes.Get (1), access, "100Mbps", "200000B"));
+  NetDeviceContainer bottleneckDevices;
+  bottleneckDevices.Add (AddDevice (nodes.Get (1), bottleneck, "10Mbps", "20000B"));
+  bottleneckDevices.Add (AddDevice (nodes.Get (2), bottleneck, "10Mbps", "200000B"));
+
+  Address sinkAddress;
+  Address receiverAddress;
+  if (m_useIpv6)
+    {
+      for (uint32_t i = 0; i < nodes.GetN (); i++)
+        {
+          nodes.Get (i)->GetObject<Icmpv6L4Protocol> ()->SetAttribute ("DAD", BooleanValue (false));
+        }
+      Ipv6AddressHelper ipv6;
+      ipv6.SetBase (Ipv6Address ("2001:1::"), Ipv6Prefix (64));
+      Ipv6InterfaceContainer accessInterfaces = ipv6.Assign (accessDevices);
+      accessInterfaces.SetForwarding (1, true);
+      accessInterfaces.SetDefaultRouteInAllNodes (1);
+      ipv6.SetBase (Ipv6Address ("2001:2::"), Ipv6Prefix (64));
+      Ipv6InterfaceContainer bottleneckInterfaces = ipv6.Assign (bottleneckDevices);
+      bottleneckInterfaces.SetForwarding (0, true);
+      bottleneckInterfaces.SetDefaultRouteInAllNodes (0);
+      sinkAddress = Inet6SocketAddress (Ipv6Address::GetAny (), 9);
+      receiverAddress = Inet6SocketAddress (bottleneckInterfaces.GetAddress (1, 1), 9);
+      nodes.Get (0)->GetObject<Ipv6L3Protocol> ()->TraceConnectWithoutContext ("Tx",
+        MakeCallback (&TcpSegmentationOffloadTest::Tx6, this));
+    }
+  else
+    {
+      Ipv4AddressHelper ipv4;
+      ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+      Ipv4InterfaceContainer accessInterfaces = ipv4.Assign (accessDevices);
+      ipv4.SetBase ("10.1.2.0", "255.255.255.0");
+      Ipv4InterfaceContainer bottleneckInterfaces = ipv4.Assign (bottleneckDevices);
+      Ipv4StaticRoutingHelper staticRouting;
+      staticRouting.GetStaticRouting (nodes.Get (0)->GetObject<Ipv4> ())
+        ->SetDefaultRoute (accessInterfaces.GetAddress (1), 1);
+      staticRouting.GetStaticRouting (nodes.Get (2)->GetObject<Ipv4> ())
+        ->SetDefaultRoute (bottleneckInterfaces.GetAddress (0), 1);
+      sinkAddress = InetSocketAddress (Ipv4Address::GetAny (), 9);
+      receiverAddress = InetSocketAddress (bottleneckInterfaces.GetAddress (1), 9);
+      nodes.Get (0)->GetObject<Ipv4L3Protocol> ()->TraceConnectWithoutContext ("Tx",
+        MakeCallback (&TcpSegmentationOffloadTest::Tx4, this));
+    }
+
+  Ptr<Socket> sink = Socket::CreateSocket (nodes.Get (2), TcpSocketFactory::GetTypeId ());
+  sink->SetAttribute ("SegmentSize", UintegerValue (1448));
+  sink->Bind (sinkAddress);
+  sink->Listen ();
+  sink->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                           MakeCallback (&TcpSegmentationOffloadTest::Accept, this));
+
+  Ptr<Socket> source = Socket::CreateSocket (nodes.Get (0), TcpSocketFactory::GetTypeId ());
+  source->SetAttribute ("SegmentSize", UintegerValue (1448));
+  source->SetAttribute ("SegmentationOffload", UintegerValue (offload));
+  source->TraceConnectWithoutContext ("CongestionWindow",
+                                      MakeCallback (&TcpSegmentationOffloadTest::CwndChange, this));
+  source->SetSendCallback (MakeCallback (&TcpSegmentationOffloadTest::Fill, this));
+  source->Bind ();
+  Simulator::Schedule (MilliSeconds (100), &Socket::Connect, source, receiverAddress);
+
+  Simulator::Stop (Seconds (21));
+  Simulator::Run ();
+  CwndChange (m_cwnd, m_cwnd);
+  m_result.cwnd = m_cwndIntegral / 20;
+  Simulator::Destroy ();
+  return m_result;
+}
+
+void
+TcpSegmentationOffloadTest::DoRun (void)
+{
+  Result segments = Run (1);
+  Result superSegments = Run (8);
+  NS_LOG_INFO ("Segments: " << segments.rxBytes << " bytes, cwnd " << segments.cwnd
+               << ", " << segments.txPackets << " packets");
+  NS_LOG_INFO ("Super-segments: " << superSegments.rxBytes << " bytes, cwnd " << superSegments.cwnd
+               << ", " << superSegments.txPackets << " packets");
+
+  // The bottleneck carries 20 s at 10 Mbps
+  NS_TEST_ASSERT_MSG_GT (segments.rxBytes, 20 * 10e6 / 8 * 0.9, "The transfer does not fill the bottleneck");
+  NS_TEST_ASSERT_MSG_EQ_TOL (double (superSegments.rxBytes), double (segments.rxBytes), 0.05 * segments.rxBytes,
+                             "The goodput differs with super-segments");
+  NS_TEST_ASSERT_MSG_EQ_TOL (superSegments.cwnd, segments.cwnd, 0.1 * segments.cwnd,
+                             "The average congestion window differs with super-segments");
+  if (m_deviceOffload)
+    {
+      // The ACKs of every other segment clock out super-segments of about
+      // two segments once the window is open
+      NS_TEST_ASSERT_MSG_LT (superSegments.txPackets, segments.txPackets * 2 / 3,
+                             "The super-segments are not sent as a whole");
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL (double (superSegments.txPackets), double (segments.txPackets),
+                                 0.05 * segments.txPackets,
+                                 "The super-segments are not segmented by the IP layer");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP segmentation offload TestSuite.
+ */
+class TcpSegmentationOffloadTestSuite : public TestSuite
+{
+public:
+  TcpSegmentationOffloadTestSuite ()
+    : TestSuite ("tcp-segmentation-offload", UNIT)
+  {
+    AddTestCase (new TcpSegmentationOffloadSplitTest (), TestCase::QUICK);
+    AddTestCase (new TcpSegmentationOffloadFateTest ("as a whole", false, false, "100000B", 1, 0),
+                 TestCase::QUICK);
+    AddTestCase (new TcpSegmentationOffloadFateTest ("to a queue disc", true, false, "100000B", 4, 0),
+                 TestCase::QUICK);
+    AddTestCase (new TcpSegmentationOffloadFateTest ("to an error model", false, true, "100000B", 4, 0),
+                 TestCase::QUICK);
+    AddTestCase (new TcpSegmentationOffloadFateTest ("to a short queue", false, false, "3000B", 3, 1),
+                 TestCase::QUICK);
+    AddTestCase (new TcpSegmentationOffloadFateTest ("to a queue of packets", false, false, "100p", 4, 0),
+                 TestCase::QUICK);
+    // Each of these simulates two transfers of 20 seconds
+    AddTestCase (new TcpSegmentationOffloadTest (true, false), TestCase::EXTENSIVE);
+    AddTestCase (new TcpSegmentationOffloadTest (false, false), TestCase::EXTENSIVE);
+    AddTestCase (new TcpSegmentationOffloadTest (true, true), TestCase::EXTENSIVE);
+    AddTestCase (new TcpSegmentationOffloadTest (false, true), TestCase::EXTENSIVE);
+  }
+};
+
+static TcpSegmentationOffloadTestSuite g_tcpSegmentationOffloadTestSuite; //!< Static variable for test initialization
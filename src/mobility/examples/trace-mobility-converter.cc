@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * This program converts an ns-2 movement file or a SUMO floating car data
+ * file to the binary format read by TraceMobilityHelper. The samples which
+ * can be interpolated from the other samples within the given tolerance are
+ * removed. For SUMO files, the identifiers of the vehicles and persons can be
+ * written to a text file, one per line, in the order of the node indices.
+ *
+ * Example:
+ *   ./ns3 run "trace-mobility-converter --input=fcd.xml --format=sumo
+ *              --output=vehicles.ns3mob --ids=vehicles.txt"
+ *
+ * and then, in the simulation program:
+ *   TraceMobilityHelper mobility ("vehicles.ns3mob");
+ *   mobility.Install (nodes);
+ */
+
+#include <fstream>
+#include <iostream>
+#include "ns3/core-module.h"
+#include "ns3/mobility-trace-data.h"
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  std::string input;
+  std::string format = "ns2";
+  std::string output;
+  std::string idsFile;
+  double tolerance = 0.01;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("input", "The ns-2 movement file or the SUMO floating car data file", input);
+  cmd.AddValue ("format", "The format of the input file (ns2 or sumo)", format);
+  cmd.AddValue ("output", "The binary trace file", output);
+  cmd.AddValue ("ids", "The file to which the SUMO identifiers of the nodes are written", idsFile);
+  cmd.AddValue ("tolerance", "The maximum interpolation error of the removed samples (m)", tolerance);
+  cmd.Parse (argc, argv);
+
+  if (input.empty () || output.empty ())
+    {
+      NS_FATAL_ERROR ("The input and the output files must be given");
+    }
+
+  Ptr<MobilityTraceData> trace;
+  std::vector<std::string> ids;
+  if (format == "ns2")
+    {
+      trace = MobilityTraceData::ReadNs2 (input);
+    }
+  else if (format == "sumo")
+    {
+      trace = MobilityTraceData::ReadSumoFcd (input, &ids);
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Unknown format " << format);
+    }
+  uint64_t nSamples = trace->GetNSamples ();
+  trace->Compact (tolerance);
+  trace->Write (output);
+
+  if (!idsFile.empty ())
+    {
+      std::ofstream file (idsFile.c_str ());
+      for (const std::string &id : ids)
+        {
+          file << id << std::endl;
+        }
+    }
+
+  std::cout << trace->GetNNodes () << " nodes, " << nSamples << " samples, "
+            << trace->GetNSamples () << " after compaction ("
+            << trace->GetNSamples () * (sizeof (int64_t) + 3 * sizeof (double)) / 1024 << " KiB)"
+            << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,88 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/trace-mobility-model.h"
+#include "trace-mobility-helper.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TraceMobilityHelper");
+
+TraceMobilityHelper::TraceMobilityHelper (Ptr<const MobilityTraceData> trace)
+  : m_trace (trace)
+{
+  NS_LOG_FUNCTION (this << trace);
+}
+
+TraceMobilityHelper::TraceMobilityHelper (std::string filename)
+  : m_trace (MobilityTraceData::Read (filename))
+{
+  NS_LOG_FUNCTION (this << filename);
+}
+
+Ptr<const MobilityTraceData>
+TraceMobilityHelper::GetTrace (void) const
+{
+  return m_trace;
+}
+
+void
+TraceMobilityHelper::Install (void) const
+{
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      if ((*i)->GetId () < m_trace->GetNNodes ())
+        {
+          Install (*i, (*i)->GetId ());
+        }
+    }
+}
+
+void
+TraceMobilityHelper::Install (NodeContainer c) const
+{
+  if (c.GetN () > m_trace->GetNNodes ())
+    {
+      NS_LOG_WARN ("The trace has only " << m_trace->GetNNodes () << " nodes");
+    }
+  for (uint32_t i = 0; i < c.GetN () && i < m_trace->GetNNodes (); i++)
+    {
+      Install (c.Get (i), i);
+    }
+}
+
+void
+TraceMobilityHelper::Install (Ptr<Node> node, uint32_t index) const
+{
+  NS_LOG_FUNCTION (this << node << index);
+  Ptr<MobilityModel> mobility = node->GetObject<MobilityModel> ();
+  Ptr<TraceMobilityModel> model = DynamicCast<TraceMobilityModel> (mobility);
+  if (mobility != 0 && model == 0)
+    {
+      NS_FATAL_ERROR ("Node " << node->GetId () << " already has a mobility model of type "
+                      << mobility->GetInstanceTypeId ().GetName ());
+    }
+  if (model == 0)
+    {
+      model = CreateObject<TraceMobilityModel> ();
+      node->AggregateObject (model);
+    }
+  model->SetTrace (m_trace, index);
+}
+
+} // namespace ns3
@@ -0,0 +1,86 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TRACE_MOBILITY_HELPER_H
+#define TRACE_MOBILITY_HELPER_H
+
+#include <string>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/node-container.h"
+#include "ns3/mobility-trace-data.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Helper class which installs a TraceMobilityModel on nodes
+ *
+ * All the mobility models share the same MobilityTraceData, which is
+ * typically read from a binary file converted once from an ns-2 movement
+ * file or from a SUMO floating car data file (see the
+ * trace-mobility-converter example). Unlike Ns2MobilityHelper, no event is
+ * scheduled to move the nodes.
+ *
+ * \code
+ *   TraceMobilityHelper mobility ("vehicles.ns3mob");
+ *   mobility.Install (nodes);
+ * \endcode
+ */
+class TraceMobilityHelper
+{
+public:
+  /**
+   * \param trace the trace, which must be finalized
+   */
+  TraceMobilityHelper (Ptr<const MobilityTraceData> trace);
+  /**
+   * \param filename the name of a binary file written by
+   *        MobilityTraceData::Write
+   */
+  TraceMobilityHelper (std::string filename);
+
+  /**
+   * \return the trace
+   */
+  Ptr<const MobilityTraceData> GetTrace (void) const;
+
+  /**
+   * Make every node of the global ns3::NodeList whose id is the index of a
+   * node of the trace follow that node.
+   */
+  void Install (void) const;
+  /**
+   * Make the i-th node of the container follow the i-th node of the trace.
+   *
+   * \param c the nodes
+   */
+  void Install (NodeContainer c) const;
+  /**
+   * Make a node follow a node of the trace. A TraceMobilityModel is
+   * aggregated to the node, unless it already has one.
+   *
+   * \param node the node
+   * \param index the index of the node in the trace
+   */
+  void Install (Ptr<Node> node, uint32_t index) const;
+
+private:
+  Ptr<const MobilityTraceData> m_trace; //!< the trace
+};
+
+} // namespace ns3
+
+#endif /* TRACE_MOBILITY_HELPER_H */
@@ -70,6 +70,14 @@ public:
    * \param vel Velocity vector
    */
   void SetVelocity (const Vector &vel);
+  /**
+   * Set new velocity vector at the given time, which is used by the models
+   * computing their trajectory lazily (the position must have been updated
+   * to the same time)
+   * \param vel Velocity vector
+   * \param now the time at which the velocity changes
+   */
+  void SetVelocity (const Vector &vel, Time now);
   /**
    * Pause mobility at current position
    */
@@ -93,6 +101,24 @@ public:
    * Update position, if not paused, from last position and time of last update
    */
   void Update (void) const;
+  /**
+   * Update position, if not paused, from last position and time of last
+   * update to the given time, which must not precede the last update
+   * \param now the time at which the position is computed
+   */
+  void Update (Time now) const;
+  /**
+   * Update position to the given time, if not paused, from last position and time of last update
+   * \param rectangle 2D bounding rectangle for resulting position; object will not move outside the rectangle 
+   * \param now the time at which the position is computed
+   */
+  void UpdateWithBounds (const Rectangle &rectangle, Time now) const;
+  /**
+   * Update position to the given time, if not paused, from last position and time of last update
+   * \param bounds 3D bounding box for resulting position; object will not move outside the box 
+   * \param now the time at which the position is computed
+   */
+  void UpdateWithBounds (const Box &bounds, Time now) const;
 private:
   mutable Time m_lastUpdate; //!< time of last update
   mutable Vector m_position; //!< state variable for current position
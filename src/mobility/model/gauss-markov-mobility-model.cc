@@ -22,6 +22,7 @@
 #include "ns3/double.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
+#include "ns3/boolean.h"
 #include "gauss-markov-mobility-model.h"
 #include "position-allocator.h"
 
@@ -80,22 +81,32 @@ GaussMarkovMobilityModel::GetTypeId (void)
                    "A gaussian random variable used to calculate the next pitch value.",
                    StringValue ("ns3::NormalRandomVariable[Mean=0.0|Variance=1.0|Bound=10.0]"),
                    MakePointerAccessor (&GaussMarkovMobilityModel::m_normalPitch),
-                   MakePointerChecker<NormalRandomVariable> ());
+                   MakePointerChecker<NormalRandomVariable> ())
+    .AddAttribute ("Lazy",
+                   "If true, the trajectory is computed when the position or the velocity is requested, "
+                   "instead of being advanced by events.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&GaussMarkovMobilityModel::m_lazy),
+                   MakeBooleanChecker ());
 
   return tid;
 }
 
 GaussMarkovMobilityModel::GaussMarkovMobilityModel ()
+  : m_lazy (false),
+    m_transitions (this, m_lazy)
 {
   m_meanVelocity = 0.0;
   m_meanDirection = 0.0;
   m_meanPitch = 0.0;
-  m_event = Simulator::ScheduleNow (&GaussMarkovMobilityModel::Start, this);
+  // the event is scheduled whatever the value of the Lazy attribute, which
+  // is not known yet
+  m_transitions.Schedule (Simulator::Now (), &GaussMarkovMobilityModel::Start);
   m_helper.Unpause ();
 }
 
 void
-GaussMarkovMobilityModel::Start (void)
+GaussMarkovMobilityModel::Start (Time now)
 {
   if (m_meanVelocity == 0.0)
     {
@@ -112,9 +123,9 @@ GaussMarkovMobilityModel::Start (void)
       m_Direction = m_meanDirection;
       m_Pitch = m_meanPitch;
       //Set the velocity vector to give to the constant velocity helper
-      m_helper.SetVelocity (Vector (m_Velocity*cosD*cosP, m_Velocity*sinD*cosP, m_Velocity*sinP));
+      m_helper.SetVelocity (Vector (m_Velocity*cosD*cosP, m_Velocity*sinD*cosP, m_Velocity*sinP), now);
     }
-  m_helper.Update ();
+  m_helper.Update (now);
 
   //Get the next values from the gaussian distributions for velocity, direction, and pitch
   double rv = m_normalVelocity->GetValue ();
@@ -138,17 +149,17 @@ GaussMarkovMobilityModel::Start (void)
   double vx = m_Velocity * cosDir * cosPit;
   double vy = m_Velocity * sinDir * cosPit;
   double vz = m_Velocity * sinPit;
-  m_helper.SetVelocity (Vector (vx, vy, vz));
+  m_helper.SetVelocity (Vector (vx, vy, vz), now);
 
   m_helper.Unpause ();
 
-  DoWalk (m_timeStep);
+  DoWalk (m_timeStep, now);
 }
 
 void
-GaussMarkovMobilityModel::DoWalk (Time delayLeft)
+GaussMarkovMobilityModel::DoWalk (Time delayLeft, Time now)
 {
-  m_helper.UpdateWithBounds (m_bounds);
+  m_helper.UpdateWithBounds (m_bounds, now);
   Vector position = m_helper.GetCurrentPosition ();
   Vector speed = m_helper.GetVelocity ();
   Vector nextPosition = position;
@@ -161,7 +172,7 @@ GaussMarkovMobilityModel::DoWalk (Time delayLeft)
   // If out of bounds, then alter the velocity vector and average direction to keep the position in bounds
   if (m_bounds.IsInside (nextPosition))
     {
-      m_event = Simulator::Schedule (delayLeft, &GaussMarkovMobilityModel::Start, this);
+      m_transitions.Schedule (now + delayLeft, &GaussMarkovMobilityModel::Start);
     }
   else
     {
@@ -185,11 +196,10 @@ GaussMarkovMobilityModel::DoWalk (Time delayLeft)
 
       m_Direction = m_meanDirection;
       m_Pitch = m_meanPitch;
-      m_helper.SetVelocity (speed);
+      m_helper.SetVelocity (speed, now);
       m_helper.Unpause ();
-      m_event = Simulator::Schedule (delayLeft, &GaussMarkovMobilityModel::Start, this);
+      m_transitions.Schedule (now + delayLeft, &GaussMarkovMobilityModel::Start);
     }
-  NotifyCourseChange ();
 }
 
 void
@@ -202,6 +212,7 @@ GaussMarkovMobilityModel::DoDispose (void)
 Vector
 GaussMarkovMobilityModel::DoGetPosition (void) const
 {
+  m_transitions.Advance ();
   m_helper.Update ();
   return m_helper.GetCurrentPosition ();
 }
@@ -209,12 +220,12 @@ void
 GaussMarkovMobilityModel::DoSetPosition (const Vector &position)
 {
   m_helper.SetPosition (position);
-  m_event.Cancel ();
-  m_event = Simulator::ScheduleNow (&GaussMarkovMobilityModel::Start, this);
+  m_transitions.Schedule (Simulator::Now (), &GaussMarkovMobilityModel::Start);
 }
 Vector
 GaussMarkovMobilityModel::DoGetVelocity (void) const
 {
+  m_transitions.Advance ();
   return m_helper.GetVelocity ();
 }
 
@@ -23,6 +23,7 @@
 #define GAUSS_MARKOV_MOBILITY_MODEL_H
 
 #include "constant-velocity-helper.h"
+#include "lazy-transitions.h"
 #include "mobility-model.h"
 #include "position-allocator.h"
 #include "ns3/ptr.h"
@@ -73,6 +74,14 @@ namespace ns3 {
  
     mobility.Install (wifiStaNodes);
  * \endcode
+ *
+ * If the "Lazy" attribute is true, no event is scheduled at every time step:
+ * the time steps which elapsed since the position or the velocity was last
+ * requested are computed at the next request, and a single course change is
+ * then notified. Events are only scheduled if the CourseChange trace source
+ * is connected when the next time step is scheduled (e.g., before the
+ * simulation starts), so that the course changes are notified on time.
+ *
  * [1] Tracy Camp, Jeff Boleng, Vanessa Davies, "A Survey of Mobility Models
  * for Ad Hoc Network Research", Wireless Communications and Mobile Computing,
  * Wiley, vol.2 iss.5, September 2002, pp.483-502
@@ -87,15 +96,19 @@ public:
   static TypeId GetTypeId (void);
   GaussMarkovMobilityModel ();
 private:
+  friend class LazyTransitions<GaussMarkovMobilityModel>;
+
   /**
    * Initialize the model and calculate new velocity, direction, and pitch
+   * \param now the time of the transition
    */
-  void Start (void);
+  void Start (Time now);
   /**
    * Perform a walk operation
    * \param timeLeft time until Start method is called again
+   * \param now the time at which the walk starts
    */
-  void DoWalk (Time timeLeft);
+  void DoWalk (Time timeLeft, Time now);
   virtual void DoDispose (void);
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
@@ -116,8 +129,9 @@ private:
   Ptr<NormalRandomVariable> m_normalDirection; //!< Gaussian rv for next direction value
   Ptr<RandomVariableStream> m_rndMeanPitch; //!< rv used to assign avg. pitch 
   Ptr<NormalRandomVariable> m_normalPitch; //!< Gaussian rv for next pitch
-  EventId m_event; //!< event id of scheduled start
   Box m_bounds; //!< bounding box
+  bool m_lazy; //!< whether the trajectory is computed lazily
+  LazyTransitions<GaussMarkovMobilityModel> m_transitions; //!< the transitions of the model
 };
 
 } // namespace ns3
@@ -0,0 +1,153 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef LAZY_TRANSITIONS_H
+#define LAZY_TRANSITIONS_H
+
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ *
+ * \brief Utility class used to perform the transitions of a random
+ * mobility model, either with events or lazily.
+ *
+ * The random mobility models move from one state to the next (a new walk,
+ * a pause, a rebound, ...) at times they draw at random.  The next of these
+ * transitions is scheduled with Schedule.  If the trajectory is computed
+ * lazily, the transitions which are due are only performed when the model
+ * calls Advance, before it reports its position or its velocity, and a
+ * single course change is then notified.  Events are still scheduled if the
+ * CourseChange trace source of the model is connected, so that the course
+ * changes are notified on time.
+ *
+ * The model must declare this class as a friend, so that it can notify its
+ * course changes.
+ *
+ * \tparam T \explicit The type of the mobility model
+ */
+template <typename T>
+class LazyTransitions
+{
+public:
+  /// A transition of the state of the model, performed at the given time
+  typedef void (T::*Transition) (Time now);
+
+  /**
+   * Create the transitions of a model.
+   * \param model the model
+   * \param lazy whether the trajectory of the model is computed lazily,
+   * usually an attribute of the model
+   */
+  LazyTransitions (T *model, const bool &lazy);
+
+  /**
+   * Set the next transition of the model, replacing the pending one, and
+   * schedule an event to perform it, unless the trajectory is computed
+   * lazily and the course changes are not traced
+   * \param time the time of the transition
+   * \param transition the transition
+   */
+  void Schedule (Time time, Transition transition);
+  /**
+   * Perform the transitions which are due, if the trajectory is computed
+   * lazily, and notify a single course change if any was performed
+   */
+  void Advance (void) const;
+
+private:
+  /**
+   * Perform a transition and notify the course change
+   * \param transition the transition
+   */
+  void Run (Transition transition);
+
+  /** Copy constructor, deleted. */
+  LazyTransitions (const LazyTransitions &) = delete;
+  /**
+   * Assignment operator, deleted.
+   * \returns The transitions.
+   */
+  LazyTransitions & operator = (const LazyTransitions &) = delete;
+
+  T *m_model; //!< the model
+  const bool &m_lazy; //!< whether the trajectory is computed lazily
+  Time m_time; //!< the time of the next transition
+  Transition m_transition; //!< the next transition
+  EventId m_event; //!< the event of the next transition
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+template <typename T>
+LazyTransitions<T>::LazyTransitions (T *model, const bool &lazy)
+  : m_model (model),
+    m_lazy (lazy),
+    m_transition (nullptr)
+{
+}
+
+template <typename T>
+void
+LazyTransitions<T>::Schedule (Time time, Transition transition)
+{
+  m_time = time;
+  m_transition = transition;
+  m_event.Cancel ();
+  if (!m_lazy || (m_model->IsCourseChangeTraced () && time >= Simulator::Now ()))
+    {
+      m_event = Simulator::Schedule (time - Simulator::Now (), &LazyTransitions<T>::Run,
+                                     this, transition);
+    }
+}
+
+template <typename T>
+void
+LazyTransitions<T>::Run (Transition transition)
+{
+  (m_model->*transition) (Simulator::Now ());
+  m_model->NotifyCourseChange ();
+}
+
+template <typename T>
+void
+LazyTransitions<T>::Advance (void) const
+{
+  if (!m_lazy || m_transition == nullptr || m_time > Simulator::Now ())
+    {
+      return;
+    }
+  // each transition schedules the next one
+  while (m_time <= Simulator::Now ())
+    {
+      (m_model->*m_transition) (m_time);
+    }
+  m_model->NotifyCourseChange ();
+}
+
+} // namespace ns3
+
+#endif /* LAZY_TRANSITIONS_H */
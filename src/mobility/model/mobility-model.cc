@@ -53,6 +53,7 @@ MobilityModel::GetTypeId (void)
 }
 
 MobilityModel::MobilityModel ()
+  : m_positionVersion (0)
 {
 }
 
@@ -87,6 +88,7 @@ MobilityModel::GetVelocity (void) const
 void 
 MobilityModel::SetPosition (const Vector &position)
 {
+  m_positionVersion++;
   DoSetPosition (position);
 }
 
@@ -107,9 +109,22 @@ MobilityModel::GetRelativeSpeed (Ptr<const MobilityModel> other) const
 void
 MobilityModel::NotifyCourseChange (void) const
 {
+  m_positionVersion++;
   m_courseChangeTrace (this);
 }
 
+bool
+MobilityModel::IsCourseChangeTraced (void) const
+{
+  return !m_courseChangeTrace.IsEmpty ();
+}
+
+uint64_t
+MobilityModel::GetPositionVersion (void) const
+{
+  return m_positionVersion;
+}
+
 int64_t
 MobilityModel::AssignStreams (int64_t start)
 {
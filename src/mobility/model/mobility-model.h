@@ -90,6 +90,16 @@ public:
    * \return the number of stream indices assigned by this model
    */
   int64_t AssignStreams (int64_t stream);
+  /**
+   * The position version is incremented every time the position is set or
+   * the course change listeners are notified. Provided that the velocity is
+   * null, the position is guaranteed not to have changed as long as the
+   * position version is unchanged, which allows users to cache values
+   * depending on the position (e.g., propagation losses).
+   *
+   * \return the position version
+   */
+  uint64_t GetPositionVersion (void) const;
 
   /**
    *  TracedCallback signature.
@@ -104,6 +114,11 @@ protected:
    * position changes to notify course change listeners.
    */
   void NotifyCourseChange (void) const;
+  /**
+   * \return true if at least a listener is connected to the CourseChange
+   *         trace source
+   */
+  bool IsCourseChangeTraced (void) const;
 private:
   /**
    * \return the current position.
@@ -149,6 +164,8 @@ private:
    */
   ns3::TracedCallback<Ptr<const MobilityModel> > m_courseChangeTrace;
 
+  mutable uint64_t m_positionVersion; //!< incremented on every position set and course change
+
 };
 
 } // namespace ns3
@@ -0,0 +1,656 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/fatal-error.h"
+#include "mobility-trace-data.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MobilityTraceData");
+
+/// The magic string at the beginning of the binary files
+static const char MOBILITY_TRACE_MAGIC[8] = {'n', 's', '3', 'm', 'o', 'b', 't', 'r'};
+/// The version of the format of the binary files
+static const uint32_t MOBILITY_TRACE_VERSION = 1;
+/// Index of a sample which does not exist
+static const uint64_t NO_SAMPLE = std::numeric_limits<uint64_t>::max ();
+/**
+ * Maximum number of consecutive samples removed by MobilityTraceData::Compact,
+ * which bounds the cost of checking the removed samples
+ */
+static const uint64_t MAX_REMOVED_SAMPLES = 100;
+
+MobilityTraceData::MobilityTraceData ()
+  : m_finalized (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MobilityTraceData::AddSample (uint32_t node, Time time, const Vector &position)
+{
+  NS_LOG_FUNCTION (this << node << time << position);
+  NS_ASSERT_MSG (!m_finalized, "Cannot add samples to a finalized trace");
+  if (node >= m_last.size ())
+    {
+      m_last.resize (node + 1, NO_SAMPLE);
+    }
+  int64_t ns = time.GetNanoSeconds ();
+  NS_ASSERT_MSG (m_last[node] == NO_SAMPLE || m_times[m_last[node]] <= ns,
+                 "The samples of node " << node << " are not sorted by time");
+  m_last[node] = m_times.size ();
+  m_nodes.push_back (node);
+  m_times.push_back (ns);
+  m_x.push_back (position.x);
+  m_y.push_back (position.y);
+  m_z.push_back (position.z);
+}
+
+void
+MobilityTraceData::AddDistinctSample (uint32_t node, Time time, const Vector &position)
+{
+  if (node < m_last.size () && m_last[node] != NO_SAMPLE)
+    {
+      uint64_t last = m_last[node];
+      if (m_times[last] == time.GetNanoSeconds ()
+          && m_x[last] == position.x && m_y[last] == position.y && m_z[last] == position.z)
+        {
+          return;
+        }
+    }
+  AddSample (node, time, position);
+}
+
+void
+MobilityTraceData::Finalize (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_finalized)
+    {
+      return;
+    }
+  uint32_t nNodes = m_last.size ();
+  m_offsets.assign (nNodes + 1, 0);
+  for (uint32_t node : m_nodes)
+    {
+      m_offsets[node + 1]++;
+    }
+  for (uint32_t node = 0; node < nNodes; node++)
+    {
+      m_offsets[node + 1] += m_offsets[node];
+    }
+
+  // the samples of every node are already in time order, so a stable
+  // counting sort by node is enough
+  std::vector<uint64_t> next (m_offsets.begin (), m_offsets.end () - 1);
+  std::vector<int64_t> times (m_times.size ());
+  std::vector<double> x (m_x.size ());
+  std::vector<double> y (m_y.size ());
+  std::vector<double> z (m_z.size ());
+  for (uint64_t i = 0; i < m_nodes.size (); i++)
+    {
+      uint64_t j = next[m_nodes[i]]++;
+      times[j] = m_times[i];
+      x[j] = m_x[i];
+      y[j] = m_y[i];
+      z[j] = m_z[i];
+    }
+  m_times.swap (times);
+  m_x.swap (x);
+  m_y.swap (y);
+  m_z.swap (z);
+  m_nodes = std::vector<uint32_t> ();
+  m_last = std::vector<uint64_t> ();
+  m_finalized = true;
+}
+
+void
+MobilityTraceData::Compact (double tolerance)
+{
+  NS_LOG_FUNCTION (this << tolerance);
+  NS_ASSERT_MSG (m_finalized, "The trace must be finalized");
+  // the kept samples are moved towards the beginning of the columns; a
+  // sample is only overwritten after the following sample is kept, i.e.,
+  // when it is no longer needed to check the removed samples
+  uint64_t w = 0;
+  for (uint32_t node = 0; node < GetNNodes (); node++)
+    {
+      uint64_t begin = m_offsets[node];
+      uint64_t end = m_offsets[node + 1];
+      m_offsets[node] = w;
+      for (uint64_t i = begin, kept = begin; i < end; i++)
+        {
+          bool remove = (i > begin && i + 1 < end
+                         && m_times[kept] < m_times[i] && m_times[i] < m_times[i + 1]
+                         && i - kept <= MAX_REMOVED_SAMPLES);
+          for (uint64_t j = kept + 1; remove && j <= i; j++)
+            {
+              double f = static_cast<double> (m_times[j] - m_times[kept]) / (m_times[i + 1] - m_times[kept]);
+              Vector interpolated (m_x[kept] + (m_x[i + 1] - m_x[kept]) * f,
+                                   m_y[kept] + (m_y[i + 1] - m_y[kept]) * f,
+                                   m_z[kept] + (m_z[i + 1] - m_z[kept]) * f);
+              remove = CalculateDistance (interpolated, Vector (m_x[j], m_y[j], m_z[j])) <= tolerance;
+            }
+          if (remove)
+            {
+              continue;
+            }
+          kept = i;
+          m_times[w] = m_times[i];
+          m_x[w] = m_x[i];
+          m_y[w] = m_y[i];
+          m_z[w] = m_z[i];
+          w++;
+        }
+    }
+  NS_LOG_DEBUG ("Kept " << w << " samples out of " << m_times.size ());
+  m_offsets.back () = w;
+  m_times.resize (w);
+  m_times.shrink_to_fit ();
+  m_x.resize (w);
+  m_x.shrink_to_fit ();
+  m_y.resize (w);
+  m_y.shrink_to_fit ();
+  m_z.resize (w);
+  m_z.shrink_to_fit ();
+}
+
+uint32_t
+MobilityTraceData::GetNNodes (void) const
+{
+  NS_ASSERT_MSG (m_finalized, "The trace must be finalized");
+  return m_offsets.size () - 1;
+}
+
+uint64_t
+MobilityTraceData::GetNSamples (void) const
+{
+  return m_times.size ();
+}
+
+uint64_t
+MobilityTraceData::GetBegin (uint32_t node) const
+{
+  NS_ASSERT_MSG (m_finalized, "The trace must be finalized");
+  NS_ASSERT (node < GetNNodes ());
+  return m_offsets[node];
+}
+
+uint64_t
+MobilityTraceData::GetEnd (uint32_t node) const
+{
+  NS_ASSERT_MSG (m_finalized, "The trace must be finalized");
+  NS_ASSERT (node < GetNNodes ());
+  return m_offsets[node + 1];
+}
+
+Time
+MobilityTraceData::GetSampleTime (uint64_t sample) const
+{
+  NS_ASSERT (sample < m_times.size ());
+  return NanoSeconds (m_times[sample]);
+}
+
+Vector
+MobilityTraceData::GetSamplePosition (uint64_t sample) const
+{
+  NS_ASSERT (sample < m_times.size ());
+  return Vector (m_x[sample], m_y[sample], m_z[sample]);
+}
+
+uint64_t
+MobilityTraceData::FindSample (uint32_t node, Time time, uint64_t hint) const
+{
+  uint64_t begin = GetBegin (node);
+  uint64_t end = GetEnd (node);
+  NS_ASSERT_MSG (begin < end, "Node " << node << " has no samples");
+  int64_t t = time.GetNanoSeconds ();
+  if (hint < begin || hint >= end)
+    {
+      hint = begin;
+    }
+
+  uint64_t first = begin;
+  uint64_t last = end;
+  if (m_times[hint] <= t)
+    {
+      // the time did not go backwards: check the hint and the next sample
+      if (hint + 1 == end || m_times[hint + 1] > t)
+        {
+          return hint;
+        }
+      if (hint + 2 == end || m_times[hint + 2] > t)
+        {
+          return hint + 1;
+        }
+      first = hint + 2;
+    }
+  else
+    {
+      last = hint;
+    }
+  std::vector<int64_t>::const_iterator it = std::upper_bound (m_times.begin () + first,
+                                                              m_times.begin () + last, t);
+  uint64_t sample = it - m_times.begin ();
+  return sample == begin ? begin : sample - 1;
+}
+
+void
+MobilityTraceData::Write (std::string filename) const
+{
+  NS_LOG_FUNCTION (this << filename);
+  NS_ASSERT_MSG (m_finalized, "The trace must be finalized");
+  std::ofstream file (filename.c_str (), std::ios::out | std::ios::binary);
+  if (!file.is_open ())
+    {
+      NS_FATAL_ERROR ("Cannot open the mobility trace file " << filename);
+    }
+  uint32_t nNodes = GetNNodes ();
+  uint64_t nSamples = GetNSamples ();
+  file.write (MOBILITY_TRACE_MAGIC, sizeof (MOBILITY_TRACE_MAGIC));
+  file.write (reinterpret_cast<const char *> (&MOBILITY_TRACE_VERSION), sizeof (MOBILITY_TRACE_VERSION));
+  file.write (reinterpret_cast<const char *> (&nNodes), sizeof (nNodes));
+  file.write (reinterpret_cast<const char *> (&nSamples), sizeof (nSamples));
+  file.write (reinterpret_cast<const char *> (m_offsets.data ()), m_offsets.size () * sizeof (uint64_t));
+  file.write (reinterpret_cast<const char *> (m_times.data ()), nSamples * sizeof (int64_t));
+  file.write (reinterpret_cast<const char *> (m_x.data ()), nSamples * sizeof (double));
+  file.write (reinterpret_cast<const char *> (m_y.data ()), nSamples * sizeof (double));
+  file.write (reinterpret_cast<const char *> (m_z.data ()), nSamples * sizeof (double));
+  if (!file.good ())
+    {
+      NS_FATAL_ERROR ("Cannot write the mobility trace file " << filename);
+    }
+}
+
+Ptr<MobilityTraceData>
+MobilityTraceData::Read (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  std::ifstream file (filename.c_str (), std::ios::in | std::ios::binary);
+  if (!file.is_open ())
+    {
+      NS_FATAL_ERROR ("Cannot open the mobility trace file " << filename);
+    }
+  char magic[sizeof (MOBILITY_TRACE_MAGIC)];
+  uint32_t version = 0;
+  uint32_t nNodes = 0;
+  uint64_t nSamples = 0;
+  file.read (magic, sizeof (magic));
+  file.read (reinterpret_cast<char *> (&version), sizeof (version));
+  file.read (reinterpret_cast<char *> (&nNodes), sizeof (nNodes));
+  file.read (reinterpret_cast<char *> (&nSamples), sizeof (nSamples));
+  if (!file.good () || std::memcmp (magic, MOBILITY_TRACE_MAGIC, sizeof (magic)) != 0)
+    {
+      NS_FATAL_ERROR (filename << " is not a mobility trace file");
+    }
+  if (version != MOBILITY_TRACE_VERSION)
+    {
+      NS_FATAL_ERROR ("Unsupported version " << version << " of the mobility trace file " << filename);
+    }
+
+  Ptr<MobilityTraceData> trace = Create<MobilityTraceData> ();
+  trace->m_offsets.resize (static_cast<uint64_t> (nNodes) + 1);
+  trace->m_times.resize (nSamples);
+  trace->m_x.resize (nSamples);
+  trace->m_y.resize (nSamples);
+  trace->m_z.resize (nSamples);
+  file.read (reinterpret_cast<char *> (trace->m_offsets.data ()), trace->m_offsets.size () * sizeof (uint64_t));
+  file.read (reinterpret_cast<char *> (trace->m_times.data ()), nSamples * sizeof (int64_t));
+  file.read (reinterpret_cast<char *> (trace->m_x.data ()), nSamples * sizeof (double));
+  file.read (reinterpret_cast<char *> (trace->m_y.data ()), nSamples * sizeof (double));
+  file.read (reinterpret_cast<char *> (trace->m_z.data ()), nSamples * sizeof (double));
+  if (!file.good ())
+    {
+      NS_FATAL_ERROR ("The mobility trace file " << filename << " is truncated");
+    }
+  if (trace->m_offsets.front () != 0 || trace->m_offsets.back () != nSamples
+      || !std::is_sorted (trace->m_offsets.begin (), trace->m_offsets.end ()))
+    {
+      NS_FATAL_ERROR ("The mobility trace file " << filename << " is corrupted");
+    }
+  trace->m_finalized = true;
+  NS_LOG_DEBUG ("Read " << nSamples << " samples of " << nNodes << " nodes from " << filename);
+  return trace;
+}
+
+/// A scheduled statement of an ns-2 movement file
+struct Ns2Statement
+{
+  uint32_t node;    //!< the node number
+  double time;      //!< the time of the statement (s)
+  bool setdest;     //!< whether the statement is a setdest or a set of a coordinate
+  char coord;       //!< the coordinate which is set (X, Y or Z)
+  double values[3]; //!< the destination and the speed, or the value of the coordinate
+};
+
+/**
+ * Get the node number from an ns-2 node token, e.g., $node_(3)
+ * \param token the token
+ * \param node the node number
+ * \return true if the token is a node token
+ */
+static bool
+GetNs2NodeNumber (const std::string &token, uint32_t &node)
+{
+  const std::string prefix = "$node_(";
+  if (token.compare (0, prefix.size (), prefix) != 0 || token.back () != ')')
+    {
+      return false;
+    }
+  char *endp;
+  unsigned long value = std::strtoul (token.c_str () + prefix.size (), &endp, 10);
+  node = value;
+  return endp == token.c_str () + token.size () - 1;
+}
+
+/**
+ * Set a coordinate of a position
+ * \param position the position
+ * \param coord the name of the coordinate (X_, Y_ or Z_)
+ * \param value the value of the coordinate
+ * \return true if the name of the coordinate is valid
+ */
+static bool
+SetNs2Coordinate (Vector &position, char coord, double value)
+{
+  switch (coord)
+    {
+    case 'X':
+      position.x = value;
+      return true;
+    case 'Y':
+      position.y = value;
+      return true;
+    case 'Z':
+      position.z = value;
+      return true;
+    default:
+      return false;
+    }
+}
+
+Ptr<MobilityTraceData>
+MobilityTraceData::ReadNs2 (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  std::ifstream file (filename.c_str (), std::ios::in);
+  if (!file.is_open ())
+    {
+      NS_FATAL_ERROR ("Cannot open the ns-2 movement file " << filename);
+    }
+
+  // the initial positions may be anywhere in the file, hence the movements
+  // are collected first
+  std::map<uint32_t, Vector> initialPositions;
+  std::vector<Ns2Statement> statements;
+  uint32_t nNodes = 0;
+  std::string line;
+  while (std::getline (file, line))
+    {
+      line = line.substr (0, line.find ('#'));
+      std::replace (line.begin (), line.end (), '"', ' ');
+      std::replace (line.begin (), line.end (), ';', ' ');
+      std::istringstream s (line);
+      std::vector<std::string> tokens;
+      std::string token;
+      while (s >> token)
+        {
+          tokens.push_back (token);
+        }
+      if (tokens.empty ())
+        {
+          continue;
+        }
+
+      uint32_t node;
+      Ns2Statement statement = Ns2Statement ();
+      if (tokens.size () == 4 && GetNs2NodeNumber (tokens[0], node) && tokens[1] == "set")
+        {
+          // $node_(0) set X_ 1.0
+          Vector &position = initialPositions[node];
+          if (!SetNs2Coordinate (position, tokens[2][0], std::atof (tokens[3].c_str ())))
+            {
+              NS_LOG_WARN ("Unknown coordinate: " << line);
+              continue;
+            }
+        }
+      else if (tokens.size () == 8 && tokens[0] == "$ns_" && tokens[1] == "at"
+               && GetNs2NodeNumber (tokens[3], node) && tokens[4] == "setdest")
+        {
+          // $ns_ at 1.0 "$node_(0) setdest 2.0 3.0 4.0"
+          statement.setdest = true;
+          statement.coord = 0;
+          for (uint32_t i = 0; i < 3; i++)
+            {
+              statement.values[i] = std::atof (tokens[5 + i].c_str ());
+            }
+        }
+      else if (tokens.size () == 7 && tokens[0] == "$ns_" && tokens[1] == "at"
+               && GetNs2NodeNumber (tokens[3], node) && tokens[4] == "set")
+        {
+          // $ns_ at 1.0 "$node_(0) set X_ 2.0"
+          statement.setdest = false;
+          statement.coord = tokens[5][0];
+          statement.values[0] = std::atof (tokens[6].c_str ());
+        }
+      else
+        {
+          NS_LOG_WARN ("Unsupported statement: " << line);
+          continue;
+        }
+      nNodes = std::max (nNodes, node + 1);
+      if (tokens.size () > 4)
+        {
+          statement.node = node;
+          statement.time = std::atof (tokens[2].c_str ());
+          if (statement.time < 0)
+            {
+              NS_LOG_WARN ("Negative time: " << line);
+              continue;
+            }
+          statements.push_back (statement);
+        }
+    }
+
+  // the statements of each node are replayed in time order, as they would
+  // be executed by the scheduler
+  std::stable_sort (statements.begin (), statements.end (),
+                    [] (const Ns2Statement &a, const Ns2Statement &b)
+                    {
+                      return a.node < b.node || (a.node == b.node && a.time < b.time);
+                    });
+  Ptr<MobilityTraceData> trace = Create<MobilityTraceData> ();
+  std::vector<Ns2Statement>::const_iterator it = statements.begin ();
+  for (uint32_t node = 0; node < nNodes; node++)
+    {
+      std::map<uint32_t, Vector>::const_iterator initial = initialPositions.find (node);
+      bool known = (initial != initialPositions.end ());
+      Vector position = known ? initial->second : Vector ();
+      if (known || (it != statements.end () && it->node == node))
+        {
+          trace->AddSample (node, Seconds (0), position);
+        }
+      // the current movement, from start to destination
+      Vector start = position;
+      Vector destination = position;
+      double startTime = 0;
+      double arrivalTime = 0;
+      for (; it != statements.end () && it->node == node; it++)
+        {
+          // the current movement ends at the time of the statement
+          if (arrivalTime > startTime)
+            {
+              if (arrivalTime <= it->time)
+                {
+                  trace->AddDistinctSample (node, Seconds (arrivalTime), destination);
+                  position = destination;
+                }
+              else
+                {
+                  double f = (it->time - startTime) / (arrivalTime - startTime);
+                  position = Vector (start.x + (destination.x - start.x) * f,
+                                     start.y + (destination.y - start.y) * f,
+                                     start.z + (destination.z - start.z) * f);
+                }
+            }
+          trace->AddDistinctSample (node, Seconds (it->time), position);
+          start = position;
+          destination = position;
+          startTime = it->time;
+          arrivalTime = it->time;
+          if (it->setdest)
+            {
+              Vector target (it->values[0], it->values[1], position.z);
+              double distance = CalculateDistance (position, target);
+              if (it->values[2] > 0 && distance > 0)
+                {
+                  destination = target;
+                  arrivalTime = it->time + distance / it->values[2];
+                }
+            }
+          else
+            {
+              if (!SetNs2Coordinate (position, it->coord, it->values[0]))
+                {
+                  NS_LOG_WARN ("Unknown coordinate " << it->coord << " for node " << node);
+                  continue;
+                }
+              trace->AddDistinctSample (node, Seconds (it->time), position);
+              start = position;
+              destination = position;
+            }
+        }
+      if (arrivalTime > startTime)
+        {
+          trace->AddDistinctSample (node, Seconds (arrivalTime), destination);
+        }
+    }
+  if (trace->m_last.size () < nNodes)
+    {
+      trace->m_last.resize (nNodes, NO_SAMPLE);
+    }
+  trace->Finalize ();
+  NS_LOG_DEBUG ("Read " << trace->GetNSamples () << " samples of " << nNodes << " nodes from " << filename);
+  return trace;
+}
+
+/**
+ * Get the value of an attribute of an XML element
+ * \param line the line containing the element
+ * \param name the name of the attribute
+ * \param value the value of the attribute
+ * \return true if the attribute was found
+ */
+static bool
+GetXmlAttribute (const std::string &line, const char *name, std::string &value)
+{
+  std::string pattern = std::string (" ") + name + "=\"";
+  std::string::size_type begin = line.find (pattern);
+  if (begin == std::string::npos)
+    {
+      return false;
+    }
+  begin += pattern.size ();
+  std::string::size_type end = line.find ('"', begin);
+  if (end == std::string::npos)
+    {
+      return false;
+    }
+  value = line.substr (begin, end - begin);
+  return true;
+}
+
+Ptr<MobilityTraceData>
+MobilityTraceData::ReadSumoFcd (std::string filename, std::vector<std::string> *ids)
+{
+  NS_LOG_FUNCTION (filename << ids);
+  std::ifstream file (filename.c_str (), std::ios::in);
+  if (!file.is_open ())
+    {
+      NS_FATAL_ERROR ("Cannot open the SUMO floating car data file " << filename);
+    }
+
+  Ptr<MobilityTraceData> trace = Create<MobilityTraceData> ();
+  std::unordered_map<std::string, uint32_t> nodes;
+  bool inTimestep = false;
+  Time time;
+  std::string line;
+  std::string value;
+  while (std::getline (file, line))
+    {
+      std::string::size_type begin = line.find_first_not_of (" \t");
+      if (begin == std::string::npos || line[begin] != '<')
+        {
+          continue;
+        }
+      if (line.compare (begin, 9, "<timestep") == 0)
+        {
+          if (!GetXmlAttribute (line, "time", value))
+            {
+              NS_FATAL_ERROR ("Timestep without time in " << filename << ": " << line);
+            }
+          time = Seconds (std::atof (value.c_str ()));
+          inTimestep = true;
+        }
+      else if (line.compare (begin, 11, "</timestep>") == 0)
+        {
+          inTimestep = false;
+        }
+      else if (line.compare (begin, 8, "<vehicle") == 0 || line.compare (begin, 7, "<person") == 0)
+        {
+          if (!inTimestep)
+            {
+              NS_LOG_WARN ("Element outside of a timestep: " << line);
+              continue;
+            }
+          std::string id;
+          std::string x;
+          std::string y;
+          if (!GetXmlAttribute (line, "id", id) || !GetXmlAttribute (line, "x", x) || !GetXmlAttribute (line, "y", y))
+            {
+              NS_FATAL_ERROR ("Element without id or position in " << filename << ": " << line);
+            }
+          Vector position (std::atof (x.c_str ()), std::atof (y.c_str ()), 0);
+          if (GetXmlAttribute (line, "z", value))
+            {
+              position.z = std::atof (value.c_str ());
+            }
+          std::pair<std::unordered_map<std::string, uint32_t>::iterator, bool> ret;
+          ret = nodes.insert (std::make_pair (id, static_cast<uint32_t> (nodes.size ())));
+          if (ret.second && ids != nullptr)
+            {
+              ids->push_back (id);
+            }
+          trace->AddSample (ret.first->second, time, position);
+        }
+    }
+  trace->Finalize ();
+  NS_LOG_DEBUG ("Read " << trace->GetNSamples () << " samples of " << nodes.size () << " nodes from " << filename);
+  return trace;
+}
+
+} // namespace ns3
@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MOBILITY_TRACE_DATA_H
+#define MOBILITY_TRACE_DATA_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief The positions of a set of nodes sampled over time, stored by columns
+ *
+ * The samples of the nodes are stored in a few contiguous arrays (the times
+ * in nanoseconds and the x, y and z coordinates), the samples of each node
+ * being contiguous and sorted by time. The position of a node between two
+ * samples is obtained by linear interpolation (see TraceMobilityModel).
+ * Two samples of a node may have the same time, in which case the node
+ * jumps from the first position to the second one at that time.
+ *
+ * The samples are added by means of AddSample, in any node order, and
+ * Finalize must be called before the trace is queried. A trace can be built
+ * from an ns-2 movement file (ReadNs2), from a SUMO floating car data file
+ * (ReadSumoFcd) or from the binary file written by Write (Read). The binary
+ * file consists of the following fields, in host byte order:
+ \verbatim
+   char     magic[8]            "ns3mobtr"
+   uint32_t version             1
+   uint32_t nNodes
+   uint64_t nSamples
+   uint64_t offsets[nNodes + 1] index of the first sample of each node
+   int64_t  times[nSamples]     nanoseconds
+   double   x[nSamples]
+   double   y[nSamples]
+   double   z[nSamples]
+ \endverbatim
+ * so that reading it amounts to a few bulk reads, without any parsing.
+ */
+class MobilityTraceData : public SimpleRefCount<MobilityTraceData>
+{
+public:
+  MobilityTraceData ();
+
+  /**
+   * Add a sample of the position of a node. The samples of a node must be
+   * added in time order.
+   *
+   * \param node the index of the node
+   * \param time the time of the sample
+   * \param position the position of the node at that time
+   */
+  void AddSample (uint32_t node, Time time, const Vector &position);
+  /**
+   * Group the samples added so far by node. No sample can be added
+   * afterwards.
+   */
+  void Finalize (void);
+  /**
+   * Remove the samples which can be obtained, within the given tolerance,
+   * by linear interpolation of the samples which are kept (e.g., the
+   * samples of a node which is stopped or which moves in a straight line
+   * at a constant speed). The first and the last sample of each node and
+   * the samples which make a node jump are always kept.
+   *
+   * \param tolerance the maximum distance (m) between a removed sample and
+   *        the interpolated position
+   */
+  void Compact (double tolerance);
+
+  /**
+   * \return the number of nodes
+   */
+  uint32_t GetNNodes (void) const;
+  /**
+   * \return the total number of samples
+   */
+  uint64_t GetNSamples (void) const;
+  /**
+   * \param node the index of the node
+   * \return the index of the first sample of the node
+   */
+  uint64_t GetBegin (uint32_t node) const;
+  /**
+   * \param node the index of the node
+   * \return the index following the last sample of the node
+   */
+  uint64_t GetEnd (uint32_t node) const;
+  /**
+   * \param sample the index of the sample
+   * \return the time of the sample
+   */
+  Time GetSampleTime (uint64_t sample) const;
+  /**
+   * \param sample the index of the sample
+   * \return the position of the sample
+   */
+  Vector GetSamplePosition (uint64_t sample) const;
+  /**
+   * Find the last sample of a node whose time is not later than the given
+   * time. The samples around the hint are checked first, so that the cost
+   * is constant when the node is queried at increasing times.
+   *
+   * \param node the index of the node, which must have samples
+   * \param time the time
+   * \param hint the index of a sample of the node, e.g., the result of the
+   *        previous call
+   * \return the index of the sample, or the index of the first sample of the
+   *         node if the time precedes it
+   */
+  uint64_t FindSample (uint32_t node, Time time, uint64_t hint) const;
+
+  /**
+   * Write the trace to a binary file.
+   *
+   * \param filename the name of the file
+   */
+  void Write (std::string filename) const;
+  /**
+   * Read a trace from a binary file written by Write.
+   *
+   * \param filename the name of the file
+   * \return the trace
+   */
+  static Ptr<MobilityTraceData> Read (std::string filename);
+  /**
+   * Read an ns-2 movement file (see Ns2MobilityHelper for the supported
+   * statements). The index of a node is its ns-2 node number. As with
+   * Ns2MobilityHelper, the statements of each node must be sorted by time.
+   *
+   * \param filename the name of the file
+   * \return the trace
+   */
+  static Ptr<MobilityTraceData> ReadNs2 (std::string filename);
+  /**
+   * Read a SUMO floating car data file, as written by the --fcd-output
+   * option of SUMO, with one element per line. The vehicles and the persons
+   * are indexed in the order in which they appear in the file.
+   *
+   * \param filename the name of the file
+   * \param ids if not null, filled with the SUMO identifiers of the nodes,
+   *        by index
+   * \return the trace
+   */
+  static Ptr<MobilityTraceData> ReadSumoFcd (std::string filename, std::vector<std::string> *ids = nullptr);
+
+private:
+  /**
+   * Add a sample of the position of a node, unless it repeats the last
+   * sample of the node.
+   *
+   * \param node the index of the node
+   * \param time the time of the sample
+   * \param position the position of the node at that time
+   */
+  void AddDistinctSample (uint32_t node, Time time, const Vector &position);
+
+  bool m_finalized;                     //!< whether the samples are grouped by node
+  std::vector<uint64_t> m_offsets;      //!< index of the first sample of each node, and the total number of samples
+  std::vector<int64_t> m_times;         //!< the times of the samples (ns)
+  std::vector<double> m_x;              //!< the x coordinates of the samples
+  std::vector<double> m_y;              //!< the y coordinates of the samples
+  std::vector<double> m_z;              //!< the z coordinates of the samples
+  std::vector<uint32_t> m_nodes;        //!< the nodes of the samples, until the trace is finalized
+  std::vector<uint64_t> m_last;         //!< the index of the last sample of each node, until the trace is finalized
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_TRACE_DATA_H */
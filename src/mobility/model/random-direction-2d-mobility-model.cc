@@ -23,6 +23,7 @@
 #include "ns3/log.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
 #include "random-direction-2d-mobility-model.h"
 
 namespace ns3 {
@@ -51,11 +52,19 @@ RandomDirection2dMobilityModel::GetTypeId (void)
                    StringValue ("ns3::ConstantRandomVariable[Constant=2.0]"),
                    MakePointerAccessor (&RandomDirection2dMobilityModel::m_pause),
                    MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("Lazy",
+                   "If true, the trajectory is computed when the position or the velocity is requested, "
+                   "instead of being advanced by events.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RandomDirection2dMobilityModel::m_lazy),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 RandomDirection2dMobilityModel::RandomDirection2dMobilityModel ()
+  : m_lazy (false),
+    m_transitions (this, m_lazy)
 {
   m_direction = CreateObject <UniformRandomVariable> ();
 }
@@ -69,53 +78,49 @@ RandomDirection2dMobilityModel::DoDispose (void)
 void
 RandomDirection2dMobilityModel::DoInitialize (void)
 {
-  DoInitializePrivate ();
+  DoInitializePrivate (Simulator::Now ());
+  NotifyCourseChange ();
   MobilityModel::DoInitialize ();
 }
 
 void
-RandomDirection2dMobilityModel::DoInitializePrivate (void)
+RandomDirection2dMobilityModel::DoInitializePrivate (Time now)
 {
   double direction = m_direction->GetValue (0, 2 * M_PI);
-  SetDirectionAndSpeed (direction);
+  SetDirectionAndSpeed (direction, now);
 }
 
 void
-RandomDirection2dMobilityModel::BeginPause (void)
+RandomDirection2dMobilityModel::BeginPause (Time now)
 {
-  m_helper.Update ();
+  m_helper.Update (now);
   m_helper.Pause ();
   Time pause = Seconds (m_pause->GetValue ());
-  m_event.Cancel ();
-  m_event = Simulator::Schedule (pause, &RandomDirection2dMobilityModel::ResetDirectionAndSpeed, this);
-  NotifyCourseChange ();
+  m_transitions.Schedule (now + pause, &RandomDirection2dMobilityModel::ResetDirectionAndSpeed);
 }
 
 void
-RandomDirection2dMobilityModel::SetDirectionAndSpeed (double direction)
+RandomDirection2dMobilityModel::SetDirectionAndSpeed (double direction, Time now)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_helper.UpdateWithBounds (m_bounds);
+  m_helper.UpdateWithBounds (m_bounds, now);
   Vector position = m_helper.GetCurrentPosition ();
   double speed = m_speed->GetValue ();
   const Vector vector (std::cos (direction) * speed,
                        std::sin (direction) * speed,
                        0.0);
-  m_helper.SetVelocity (vector);
+  m_helper.SetVelocity (vector, now);
   m_helper.Unpause ();
   Vector next = m_bounds.CalculateIntersection (position, vector);
   Time delay = Seconds (CalculateDistance (position, next) / speed);
-  m_event.Cancel ();
-  m_event = Simulator::Schedule (delay,
-                                 &RandomDirection2dMobilityModel::BeginPause, this);
-  NotifyCourseChange ();
+  m_transitions.Schedule (now + delay, &RandomDirection2dMobilityModel::BeginPause);
 }
 void
-RandomDirection2dMobilityModel::ResetDirectionAndSpeed (void)
+RandomDirection2dMobilityModel::ResetDirectionAndSpeed (Time now)
 {
   double direction = m_direction->GetValue (0, M_PI);
 
-  m_helper.UpdateWithBounds (m_bounds);
+  m_helper.UpdateWithBounds (m_bounds, now);
   Vector position = m_helper.GetCurrentPosition ();
   switch (m_bounds.GetClosestSide (position))
     {
@@ -132,11 +137,13 @@ RandomDirection2dMobilityModel::ResetDirectionAndSpeed (void)
       direction += 0.0;
       break;
     }
-  SetDirectionAndSpeed (direction);
+  SetDirectionAndSpeed (direction, now);
 }
+
 Vector
 RandomDirection2dMobilityModel::DoGetPosition (void) const
 {
+  m_transitions.Advance ();
   m_helper.UpdateWithBounds (m_bounds);
   return m_helper.GetCurrentPosition ();
 }
@@ -144,12 +151,12 @@ void
 RandomDirection2dMobilityModel::DoSetPosition (const Vector &position)
 {
   m_helper.SetPosition (position);
-  m_event.Cancel ();
-  m_event = Simulator::ScheduleNow (&RandomDirection2dMobilityModel::DoInitializePrivate, this);
+  m_transitions.Schedule (Simulator::Now (), &RandomDirection2dMobilityModel::DoInitializePrivate);
 }
 Vector
 RandomDirection2dMobilityModel::DoGetVelocity (void) const
 {
+  m_transitions.Advance ();
   return m_helper.GetVelocity ();
 }
 int64_t
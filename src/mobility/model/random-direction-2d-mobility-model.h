@@ -28,6 +28,7 @@
 #include "ns3/random-variable-stream.h"
 #include "mobility-model.h"
 #include "constant-velocity-helper.h"
+#include "lazy-transitions.h"
 
 namespace ns3 {
 
@@ -40,6 +41,13 @@ namespace ns3 {
  * then travels in the specific direction until it reaches one of
  * the boundaries of the model. When it reaches the boundary, it pauses,
  * selects a new direction and speed, aso.
+ *
+ * If the "Lazy" attribute is true, the pauses and the travels which ended
+ * since the position or the velocity was last requested are generated at the
+ * next request, instead of being triggered by events, and a single course
+ * change is then notified. Events are only scheduled if the CourseChange
+ * trace source is connected when a pause or a travel begins (e.g., before the
+ * simulation starts), so that the course changes are notified on time.
  */
 class RandomDirection2dMobilityModel : public MobilityModel
 {
@@ -52,23 +60,29 @@ public:
   RandomDirection2dMobilityModel ();
 
 private:
+  friend class LazyTransitions<RandomDirection2dMobilityModel>;
+
   /**
    * Set a new direction and speed
+   * \param now the time of the transition
    */
-  void ResetDirectionAndSpeed (void);
+  void ResetDirectionAndSpeed (Time now);
   /**
    * Pause, cancel currently scheduled event, schedule end of pause event
+   * \param now the time of the transition
    */
-  void BeginPause (void);
+  void BeginPause (Time now);
   /**
    * Set new velocity and direction, and schedule next pause event  
    * \param direction (radians)
+   * \param now the time at which the velocity changes
    */
-  void SetDirectionAndSpeed (double direction);
+  void SetDirectionAndSpeed (double direction, Time now);
   /**
    * Sets a new random direction and calls SetDirectionAndSpeed
+   * \param now the time of the transition
    */
-  void DoInitializePrivate (void);
+  void DoInitializePrivate (Time now);
   virtual void DoDispose (void);
   virtual void DoInitialize (void);
   virtual Vector DoGetPosition (void) const;
@@ -80,8 +94,9 @@ private:
   Rectangle m_bounds; //!< the 2D bounding area
   Ptr<RandomVariableStream> m_speed; //!< a random variable to control speed
   Ptr<RandomVariableStream> m_pause; //!< a random variable to control pause 
-  EventId m_event; //!< event ID of next scheduled event
   ConstantVelocityHelper m_helper; //!< helper for velocity computations
+  bool m_lazy; //!< whether the trajectory is computed lazily
+  LazyTransitions<RandomDirection2dMobilityModel> m_transitions; //!< the transitions of the model
 };
 
 } // namespace ns3
@@ -22,6 +22,7 @@
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include <cmath>
@@ -70,27 +71,40 @@ RandomWalk2dMobilityModel::GetTypeId (void)
                    "A random variable used to pick the speed (m/s).",
                    StringValue ("ns3::UniformRandomVariable[Min=2.0|Max=4.0]"),
                    MakePointerAccessor (&RandomWalk2dMobilityModel::m_speed),
-                   MakePointerChecker<RandomVariableStream> ());
+                   MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("Lazy",
+                   "If true, the trajectory is computed when the position or the velocity is requested, "
+                   "instead of being advanced by events.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RandomWalk2dMobilityModel::m_lazy),
+                   MakeBooleanChecker ());
   return tid;
 }
 
+RandomWalk2dMobilityModel::RandomWalk2dMobilityModel ()
+  : m_lazy (false),
+    m_transitions (this, m_lazy)
+{
+}
+
 void
 RandomWalk2dMobilityModel::DoInitialize (void)
 {
-  DoInitializePrivate ();
+  DoInitializePrivate (Simulator::Now ());
+  NotifyCourseChange ();
   MobilityModel::DoInitialize ();
 }
 
 void
-RandomWalk2dMobilityModel::DoInitializePrivate (void)
+RandomWalk2dMobilityModel::DoInitializePrivate (Time now)
 {
-  m_helper.Update ();
+  m_helper.Update (now);
   double speed = m_speed->GetValue ();
   double direction = m_direction->GetValue ();
   Vector vector (std::cos (direction) * speed,
                  std::sin (direction) * speed,
                  0.0);
-  m_helper.SetVelocity (vector);
+  m_helper.SetVelocity (vector, now);
   m_helper.Unpause ();
 
   Time delayLeft;
@@ -102,36 +116,34 @@ RandomWalk2dMobilityModel::DoInitializePrivate (void)
     {
       delayLeft = Seconds (m_modeDistance / speed); 
     }
-  DoWalk (delayLeft);
+  DoWalk (delayLeft, now);
 }
 
 void
-RandomWalk2dMobilityModel::DoWalk (Time delayLeft)
+RandomWalk2dMobilityModel::DoWalk (Time delayLeft, Time now)
 {
   Vector position = m_helper.GetCurrentPosition ();
   Vector speed = m_helper.GetVelocity ();
   Vector nextPosition = position;
   nextPosition.x += speed.x * delayLeft.GetSeconds ();
   nextPosition.y += speed.y * delayLeft.GetSeconds ();
-  m_event.Cancel ();
   if (m_bounds.IsInside (nextPosition))
     {
-      m_event = Simulator::Schedule (delayLeft, &RandomWalk2dMobilityModel::DoInitializePrivate, this);
+      m_transitions.Schedule (now + delayLeft, &RandomWalk2dMobilityModel::DoInitializePrivate);
     }
   else
     {
       nextPosition = m_bounds.CalculateIntersection (position, speed);
       Time delay = Seconds ((nextPosition.x - position.x) / speed.x);
-      m_event = Simulator::Schedule (delay, &RandomWalk2dMobilityModel::Rebound, this,
-                                     delayLeft - delay);
+      m_timeLeft = delayLeft - delay;
+      m_transitions.Schedule (now + delay, &RandomWalk2dMobilityModel::Rebound);
     }
-  NotifyCourseChange ();
 }
 
 void
-RandomWalk2dMobilityModel::Rebound (Time delayLeft)
+RandomWalk2dMobilityModel::Rebound (Time now)
 {
-  m_helper.UpdateWithBounds (m_bounds);
+  m_helper.UpdateWithBounds (m_bounds, now);
   Vector position = m_helper.GetCurrentPosition ();
   Vector speed = m_helper.GetVelocity ();
   switch (m_bounds.GetClosestSide (position))
@@ -145,9 +157,9 @@ RandomWalk2dMobilityModel::Rebound (Time delayLeft)
       speed.y = -speed.y;
       break;
     }
-  m_helper.SetVelocity (speed);
+  m_helper.SetVelocity (speed, now);
   m_helper.Unpause ();
-  DoWalk (delayLeft);
+  DoWalk (m_timeLeft, now);
 }
 
 void
@@ -159,6 +171,7 @@ RandomWalk2dMobilityModel::DoDispose (void)
 Vector
 RandomWalk2dMobilityModel::DoGetPosition (void) const
 {
+  m_transitions.Advance ();
   m_helper.UpdateWithBounds (m_bounds);
   return m_helper.GetCurrentPosition ();
 }
@@ -167,12 +180,12 @@ RandomWalk2dMobilityModel::DoSetPosition (const Vector &position)
 {
   NS_ASSERT (m_bounds.IsInside (position));
   m_helper.SetPosition (position);
-  m_event.Cancel ();
-  m_event = Simulator::ScheduleNow (&RandomWalk2dMobilityModel::DoInitializePrivate, this);
+  m_transitions.Schedule (Simulator::Now (), &RandomWalk2dMobilityModel::DoInitializePrivate);
 }
 Vector
 RandomWalk2dMobilityModel::DoGetVelocity (void) const
 {
+  m_transitions.Advance ();
   return m_helper.GetVelocity ();
 }
 int64_t
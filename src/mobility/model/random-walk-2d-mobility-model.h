@@ -27,6 +27,7 @@
 #include "ns3/random-variable-stream.h"
 #include "mobility-model.h"
 #include "constant-velocity-helper.h"
+#include "lazy-transitions.h"
 
 namespace ns3 {
 
@@ -42,6 +43,13 @@ namespace ns3 {
  * of the model, we rebound on the boundary with a reflexive angle
  * and speed. This model is often identified as a brownian motion
  * model.
+ *
+ * If the "Lazy" attribute is true, the walks and the rebounds are not
+ * triggered by events: the ones which are due are performed when the
+ * position or the velocity is requested, and a single course change is then
+ * notified. Events are only scheduled if the CourseChange trace source is
+ * connected when a walk or a rebound is scheduled (e.g., before the
+ * simulation starts), so that the course changes are notified on time.
  */
 class RandomWalk2dMobilityModel : public MobilityModel 
 {
@@ -57,22 +65,29 @@ public:
     MODE_TIME
   };
 
+  RandomWalk2dMobilityModel ();
+
 private:
+  friend class LazyTransitions<RandomWalk2dMobilityModel>;
+
   /**
-   * \brief Performs the rebound of the node if it reaches a boundary
-   * \param timeLeft The remaining time of the walk
+   * \brief Performs the rebound of the node if it reaches a boundary. The
+   * remaining time of the walk is m_timeLeft.
+   * \param now the time of the transition
    */
-  void Rebound (Time timeLeft);
+  void Rebound (Time now);
   /**
    * Walk according to position and velocity, until distance is reached,
    * time is reached, or intersection with the bounding box
    * \param timeLeft The remaining time of the walk
+   * \param now the time at which the walk starts
    */
-  void DoWalk (Time timeLeft);
+  void DoWalk (Time timeLeft, Time now);
   /**
    * Perform initialization of the object before MobilityModel::DoInitialize ()
+   * \param now the time of the transition
    */
-  void DoInitializePrivate (void);
+  void DoInitializePrivate (Time now);
   virtual void DoDispose (void);
   virtual void DoInitialize (void);
   virtual Vector DoGetPosition (void) const;
@@ -81,13 +96,15 @@ private:
   virtual int64_t DoAssignStreams (int64_t);
 
   ConstantVelocityHelper m_helper; //!< helper for this object
-  EventId m_event; //!< stored event ID 
   enum Mode m_mode; //!< whether in time or distance mode
   double m_modeDistance; //!< Change direction and speed after this distance
   Time m_modeTime; //!< Change current direction and speed after this delay
   Ptr<RandomVariableStream> m_speed; //!< rv for picking speed
   Ptr<RandomVariableStream> m_direction; //!< rv for picking direction
   Rectangle m_bounds; //!< Bounds of the area to cruise
+  Time m_timeLeft; //!< The remaining time of the walk after the next rebound
+  bool m_lazy; //!< whether the trajectory is computed lazily
+  LazyTransitions<RandomWalk2dMobilityModel> m_transitions; //!< the transitions of the model
 };
 
 
@@ -22,6 +22,7 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
+#include "ns3/boolean.h"
 #include "random-waypoint-mobility-model.h"
 #include "position-allocator.h"
 
@@ -50,15 +51,27 @@ RandomWaypointMobilityModel::GetTypeId (void)
                    "The position model used to pick a destination point.",
                    PointerValue (),
                    MakePointerAccessor (&RandomWaypointMobilityModel::m_position),
-                   MakePointerChecker<PositionAllocator> ());
+                   MakePointerChecker<PositionAllocator> ())
+    .AddAttribute ("Lazy",
+                   "If true, the trajectory is computed when the position or the velocity is requested, "
+                   "instead of being advanced by events.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RandomWaypointMobilityModel::m_lazy),
+                   MakeBooleanChecker ());
 
   return tid;
 }
 
+RandomWaypointMobilityModel::RandomWaypointMobilityModel ()
+  : m_lazy (false),
+    m_transitions (this, m_lazy)
+{
+}
+
 void
-RandomWaypointMobilityModel::BeginWalk (void)
+RandomWaypointMobilityModel::BeginWalk (Time now)
 {
-  m_helper.Update ();
+  m_helper.Update (now);
   Vector m_current = m_helper.GetCurrentPosition ();
   NS_ASSERT_MSG (m_position, "No position allocator added before using this model");
   UniformGridPositionAllocator::SetCoords(std::pair(m_current.x,m_current.y));
@@ -69,35 +82,33 @@ RandomWaypointMobilityModel::BeginWalk (void)
   double dz = (destination.z - m_current.z);
   double k = speed / std::sqrt (dx*dx + dy*dy + dz*dz);
 
-  m_helper.SetVelocity (Vector (k*dx, k*dy, k*dz));
+  m_helper.SetVelocity (Vector (k*dx, k*dy, k*dz), now);
   m_helper.Unpause ();
   Time travelDelay = Seconds (CalculateDistance (destination, m_current) / speed);
-  m_event.Cancel ();
-  m_event = Simulator::Schedule (travelDelay,
-                                 &RandomWaypointMobilityModel::DoInitializePrivate, this);
-  NotifyCourseChange ();
+  m_transitions.Schedule (now + travelDelay, &RandomWaypointMobilityModel::DoInitializePrivate);
 }
 
 void
 RandomWaypointMobilityModel::DoInitialize (void)
 {
-  DoInitializePrivate ();
+  DoInitializePrivate (Simulator::Now ());
+  NotifyCourseChange ();
   MobilityModel::DoInitialize ();
 }
 
 void
-RandomWaypointMobilityModel::DoInitializePrivate (void)
+RandomWaypointMobilityModel::DoInitializePrivate (Time now)
 {
-  m_helper.Update ();
+  m_helper.Update (now);
   m_helper.Pause ();
   Time pause = Seconds (m_pause->GetValue ());
-  m_event = Simulator::Schedule (pause, &RandomWaypointMobilityModel::BeginWalk, this);
-  NotifyCourseChange ();
+  m_transitions.Schedule (now + pause, &RandomWaypointMobilityModel::BeginWalk);
 }
 
 Vector
 RandomWaypointMobilityModel::DoGetPosition (void) const
 {
+  m_transitions.Advance ();
   m_helper.Update ();
   return m_helper.GetCurrentPosition ();
 }
@@ -105,12 +116,12 @@ void
 RandomWaypointMobilityModel::DoSetPosition (const Vector &position)
 {
   m_helper.SetPosition (position);
-  m_event.Cancel ();
-  m_event = Simulator::ScheduleNow (&RandomWaypointMobilityModel::DoInitializePrivate, this);
+  m_transitions.Schedule (Simulator::Now (), &RandomWaypointMobilityModel::DoInitializePrivate);
 }
 Vector
 RandomWaypointMobilityModel::DoGetVelocity (void) const
 {
+  m_transitions.Advance ();
   return m_helper.GetVelocity ();
 }
 int64_t
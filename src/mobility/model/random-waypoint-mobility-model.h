@@ -21,6 +21,7 @@
 #define RANDOM_WAYPOINT_MOBILITY_MODEL_H
 
 #include "constant-velocity-helper.h"
+#include "lazy-transitions.h"
 #include "mobility-model.h"
 #include "position-allocator.h"
 #include "ns3/ptr.h"
@@ -48,6 +49,17 @@ namespace ns3 {
  * a 3d random waypoint position model to this mobility model, the model 
  * will still work. There is no 3d position allocator for now but it should
  * be trivial to add one.
+ *
+ * If the "Lazy" attribute is true, no event is scheduled to advance the
+ * state of the model: the pauses and the walks which ended since the
+ * previous call are generated when the position or the velocity is
+ * requested, and a single course change is notified. Events are still
+ * scheduled if the CourseChange trace source is connected when the next
+ * pause or walk is generated (e.g., before the simulation starts), so that
+ * the course changes are notified on time. The trajectories are
+ * statistically equivalent to the ones generated by the events, but they
+ * differ if the PositionAllocator is shared by multiple models, as its random
+ * variables are drawn in a different order.
  */
 class RandomWaypointMobilityModel : public MobilityModel
 {
@@ -57,17 +69,22 @@ public:
    * \return the object TypeId
    */
   static TypeId GetTypeId (void);
+  RandomWaypointMobilityModel ();
 protected:
   virtual void DoInitialize (void);
 private:
+  friend class LazyTransitions<RandomWaypointMobilityModel>;
+
   /**
    * Get next position, begin moving towards it, schedule future pause event
+   * \param now the time of the transition
    */
-  void BeginWalk (void);
+  void BeginWalk (Time now);
   /**
    * Begin current pause event, schedule future walk event
+   * \param now the time of the transition
    */
-  void DoInitializePrivate (void);
+  void DoInitializePrivate (Time now);
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
@@ -77,7 +94,8 @@ private:
   Ptr<PositionAllocator> m_position; //!< pointer to position allocator
   Ptr<RandomVariableStream> m_speed; //!< random variable to generate speeds
   Ptr<RandomVariableStream> m_pause; //!< random variable to generate pauses
-  EventId m_event; //!< event ID of next scheduled event
+  bool m_lazy; //!< whether the trajectory is computed lazily
+  LazyTransitions<RandomWaypointMobilityModel> m_transitions; //!< the transitions of the model
 };
 
 } // namespace ns3
@@ -0,0 +1,227 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "trace-mobility-model.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TraceMobilityModel");
+
+NS_OBJECT_ENSURE_REGISTERED (TraceMobilityModel);
+
+TypeId
+TraceMobilityModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TraceMobilityModel")
+    .SetParent<MobilityModel> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<TraceMobilityModel> ()
+  ;
+  return tid;
+}
+
+TraceMobilityModel::TraceMobilityModel ()
+  : m_node (0),
+    m_sample (0),
+    m_positionEnd (Time::Max ()),
+    m_scheduled (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TraceMobilityModel::~TraceMobilityModel ()
+{
+}
+
+void
+TraceMobilityModel::SetTrace (Ptr<const MobilityTraceData> trace, uint32_t node)
+{
+  NS_LOG_FUNCTION (this << trace << node);
+  NS_ASSERT (trace != 0 && node < trace->GetNNodes ());
+  m_trace = trace;
+  m_node = node;
+  m_sample = trace->GetBegin (node);
+  m_positionEnd = (trace->GetBegin (node) < trace->GetEnd (node) ? Time (0) : Time::Max ());
+  if (IsInitialized ())
+    {
+      m_event.Cancel ();
+      m_scheduled = false;
+      ScheduleCourseChange ();
+      NotifyCourseChange ();
+    }
+}
+
+Ptr<const MobilityTraceData>
+TraceMobilityModel::GetTrace (void) const
+{
+  return m_trace;
+}
+
+uint32_t
+TraceMobilityModel::GetTraceNode (void) const
+{
+  return m_node;
+}
+
+void
+TraceMobilityModel::DoInitialize (void)
+{
+  NS_LOG_FUNCTION (this);
+  ScheduleCourseChange ();
+  MobilityModel::DoInitialize ();
+}
+
+void
+TraceMobilityModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_event.Cancel ();
+  m_trace = 0;
+  MobilityModel::DoDispose ();
+}
+
+bool
+TraceMobilityModel::FollowsTrace (void) const
+{
+  if (Simulator::Now () < m_positionEnd)
+    {
+      return false;
+    }
+  if (m_positionEnd > Time (0))
+    {
+      // back on the trace after a position set explicitly
+      m_positionEnd = Time (0);
+      if (!m_scheduled)
+        {
+          NotifyCourseChange ();
+        }
+    }
+  return true;
+}
+
+uint64_t
+TraceMobilityModel::FindCurrentSample (void) const
+{
+  uint64_t sample = m_trace->FindSample (m_node, Simulator::Now (), m_sample);
+  if (sample != m_sample)
+    {
+      m_sample = sample;
+      // Without course change events, the course change is notified when
+      // it is first seen, so that the position version changes
+      if (!m_scheduled)
+        {
+          NotifyCourseChange ();
+        }
+    }
+  return m_sample;
+}
+
+Vector
+TraceMobilityModel::DoGetPosition (void) const
+{
+  if (!FollowsTrace ())
+    {
+      return m_position;
+    }
+  uint64_t i = FindCurrentSample ();
+  Time now = Simulator::Now ();
+  Time t1 = m_trace->GetSampleTime (i);
+  Vector p1 = m_trace->GetSamplePosition (i);
+  if (now <= t1 || i + 1 == m_trace->GetEnd (m_node))
+    {
+      return p1;
+    }
+  Time t2 = m_trace->GetSampleTime (i + 1);
+  Vector p2 = m_trace->GetSamplePosition (i + 1);
+  double f = (now - t1).GetSeconds () / (t2 - t1).GetSeconds ();
+  return Vector (p1.x + (p2.x - p1.x) * f,
+                 p1.y + (p2.y - p1.y) * f,
+                 p1.z + (p2.z - p1.z) * f);
+}
+
+void
+TraceMobilityModel::DoSetPosition (const Vector &position)
+{
+  NS_LOG_FUNCTION (this << position);
+  m_position = position;
+  m_positionEnd = Time::Max ();
+  if (m_trace != 0 && m_trace->GetBegin (m_node) < m_trace->GetEnd (m_node))
+    {
+      // the position is used until the next sample
+      uint64_t i = FindCurrentSample ();
+      if (Simulator::Now () < m_trace->GetSampleTime (i))
+        {
+          m_positionEnd = m_trace->GetSampleTime (i);
+        }
+      else if (i + 1 < m_trace->GetEnd (m_node))
+        {
+          m_positionEnd = m_trace->GetSampleTime (i + 1);
+        }
+    }
+  NotifyCourseChange ();
+}
+
+Vector
+TraceMobilityModel::DoGetVelocity (void) const
+{
+  if (!FollowsTrace ())
+    {
+      return Vector (0.0, 0.0, 0.0);
+    }
+  uint64_t i = FindCurrentSample ();
+  Time t1 = m_trace->GetSampleTime (i);
+  if (Simulator::Now () < t1 || i + 1 == m_trace->GetEnd (m_node))
+    {
+      return Vector (0.0, 0.0, 0.0);
+    }
+  Vector p1 = m_trace->GetSamplePosition (i);
+  Vector p2 = m_trace->GetSamplePosition (i + 1);
+  double duration = (m_trace->GetSampleTime (i + 1) - t1).GetSeconds ();
+  return Vector ((p2.x - p1.x) / duration,
+                 (p2.y - p1.y) / duration,
+                 (p2.z - p1.z) / duration);
+}
+
+void
+TraceMobilityModel::ScheduleCourseChange (void)
+{
+  if (!IsCourseChangeTraced () || m_trace == 0 || m_trace->GetBegin (m_node) == m_trace->GetEnd (m_node))
+    {
+      return;
+    }
+  m_scheduled = true;
+  uint64_t i = FindCurrentSample ();
+  Time now = Simulator::Now ();
+  if (now >= m_trace->GetSampleTime (i))
+    {
+      if (i + 1 == m_trace->GetEnd (m_node))
+        {
+          return;
+        }
+      i++;
+    }
+  m_event = Simulator::Schedule (m_trace->GetSampleTime (i) - now, &TraceMobilityModel::CourseChange, this);
+}
+
+void
+TraceMobilityModel::CourseChange (void)
+{
+  NotifyCourseChange ();
+  ScheduleCourseChange ();
+}
+
+} // namespace ns3
@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TRACE_MOBILITY_MODEL_H
+#define TRACE_MOBILITY_MODEL_H
+
+#include "mobility-model.h"
+#include "mobility-trace-data.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Mobility model which follows the samples of a MobilityTraceData
+ *
+ * The position of the node is interpolated linearly between the samples of
+ * the trace when it is queried. Before its first sample, the node is at the
+ * position of the first sample and, after its last sample, at the position
+ * of the last one. The trace can be shared by the mobility models of all
+ * the nodes (see TraceMobilityHelper).
+ *
+ * No event is scheduled, unless the CourseChange trace source is connected
+ * when the model is initialized (or when SetTrace is called afterwards): in
+ * this case, a course change is notified at the time of every sample.
+ * Otherwise, a course change is notified when the position or the velocity
+ * is first queried after a sample, which updates the position version (see
+ * MobilityModel::GetPositionVersion).
+ *
+ * If the position is set explicitly, the node stays at that position until
+ * the next sample of the trace, and then follows the trace again.
+ */
+class TraceMobilityModel : public MobilityModel
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  TraceMobilityModel ();
+  virtual ~TraceMobilityModel ();
+
+  /**
+   * Set the trace followed by the node
+   *
+   * \param trace the trace, which must be finalized
+   * \param node the index of the node in the trace
+   */
+  void SetTrace (Ptr<const MobilityTraceData> trace, uint32_t node);
+  /**
+   * \return the trace followed by the node
+   */
+  Ptr<const MobilityTraceData> GetTrace (void) const;
+  /**
+   * \return the index of the node in the trace
+   */
+  uint32_t GetTraceNode (void) const;
+
+protected:
+  virtual void DoInitialize (void);
+  virtual void DoDispose (void);
+
+private:
+  virtual Vector DoGetPosition (void) const;
+  virtual void DoSetPosition (const Vector &position);
+  virtual Vector DoGetVelocity (void) const;
+
+  /**
+   * Notify a course change when the node gets back on the trace, if the
+   * course changes are not notified by events
+   * \return true if the node follows the trace at the current time
+   */
+  bool FollowsTrace (void) const;
+  /**
+   * Find the sample which precedes the current time, or the first sample,
+   * and notify a course change if it is a new sample and the course changes
+   * are not notified by events
+   * \return the index of the sample
+   */
+  uint64_t FindCurrentSample (void) const;
+  /**
+   * Schedule the notification of the next course change, if the
+   * CourseChange trace source is connected
+   */
+  void ScheduleCourseChange (void);
+  /**
+   * Notify a course change and schedule the next one
+   */
+  void CourseChange (void);
+
+  Ptr<const MobilityTraceData> m_trace; //!< the trace followed by the node
+  uint32_t m_node;                      //!< the index of the node in the trace
+  mutable uint64_t m_sample;            //!< the last sample found, used as a hint
+  Vector m_position;                    //!< the position set explicitly
+  mutable Time m_positionEnd;           //!< the time until which the position set explicitly is used
+  EventId m_event;                      //!< the next course change event
+  bool m_scheduled;                     //!< whether the course changes are notified by events
+};
+
+} // namespace ns3
+
+#endif /* TRACE_MOBILITY_MODEL_H */
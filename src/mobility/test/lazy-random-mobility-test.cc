@@ -0,0 +1,212 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/object-factory.h"
+#include "ns3/random-waypoint-mobility-model.h"
+#include "ns3/random-walk-2d-mobility-model.h"
+#include "ns3/random-direction-2d-mobility-model.h"
+#include "ns3/gauss-markov-mobility-model.h"
+#include "ns3/position-allocator.h"
+#include "ns3/rectangle.h"
+#include "ns3/box.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that the trajectory computed by a random mobility model whose
+ * "Lazy" attribute is true is the one computed by means of events, and that
+ * no event is scheduled unless the course changes are traced.
+ */
+class LazyRandomMobilityTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param factory the factory of the mobility model, with its attributes set
+   */
+  LazyRandomMobilityTestCase (ObjectFactory factory);
+  virtual ~LazyRandomMobilityTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Create and initialize a mobility model
+   * \param lazy the value of the Lazy attribute
+   * \param courseChanges if not null, the counter of the course changes of the model
+   * \return the mobility model
+   */
+  Ptr<MobilityModel> CreateModel (bool lazy, uint32_t *courseChanges);
+  /**
+   * Compare the positions and the velocities of the two models
+   * \param eager the model advanced by events
+   * \param lazy the model advanced lazily
+   */
+  void Compare (Ptr<MobilityModel> eager, Ptr<MobilityModel> lazy);
+  /**
+   * Course change callback
+   * \param counter the counter to increment
+   * \param model the mobility model
+   */
+  static void CourseChange (uint32_t *counter, Ptr<const MobilityModel> model);
+
+  ObjectFactory m_factory; //!< the factory of the mobility model
+};
+
+LazyRandomMobilityTestCase::LazyRandomMobilityTestCase (ObjectFactory factory)
+  : TestCase ("Check the Lazy attribute of " + factory.GetTypeId ().GetName ()),
+    m_factory (factory)
+{
+}
+
+LazyRandomMobilityTestCase::~LazyRandomMobilityTestCase ()
+{
+}
+
+Ptr<MobilityModel>
+LazyRandomMobilityTestCase::CreateModel (bool lazy, uint32_t *courseChanges)
+{
+  Ptr<MobilityModel> model = m_factory.Create<MobilityModel> ();
+  model->SetAttribute ("Lazy", BooleanValue (lazy));
+  if (m_factory.GetTypeId ().GetName () == "ns3::RandomWaypointMobilityModel")
+    {
+      // each model needs its own allocator to draw the same waypoints
+      Ptr<PositionAllocator> allocator = CreateObject<RandomRectanglePositionAllocator> ();
+      allocator->SetAttribute ("X", StringValue ("ns3::UniformRandomVariable[Min=10.0|Max=90.0]"));
+      allocator->SetAttribute ("Y", StringValue ("ns3::UniformRandomVariable[Min=10.0|Max=90.0]"));
+      model->SetAttribute ("PositionAllocator", PointerValue (allocator));
+    }
+  model->AssignStreams (100);
+  if (courseChanges != nullptr)
+    {
+      model->TraceConnectWithoutContext ("CourseChange",
+                                         MakeBoundCallback (&LazyRandomMobilityTestCase::CourseChange, courseChanges));
+    }
+  model->Initialize ();
+  model->SetPosition (Vector (50.0, 50.0, 50.0));
+  return model;
+}
+
+void
+LazyRandomMobilityTestCase::Compare (Ptr<MobilityModel> eager, Ptr<MobilityModel> lazy)
+{
+  Vector eagerPosition = eager->GetPosition ();
+  Vector lazyPosition = lazy->GetPosition ();
+  NS_TEST_EXPECT_MSG_LT (CalculateDistance (eagerPosition, lazyPosition), 1e-6,
+                         "Different positions at " << Simulator::Now ().As (Time::S));
+  NS_TEST_EXPECT_MSG_LT (CalculateDistance (eager->GetVelocity (), lazy->GetVelocity ()), 1e-6,
+                         "Different velocities at " << Simulator::Now ().As (Time::S));
+}
+
+void
+LazyRandomMobilityTestCase::CourseChange (uint32_t *counter, Ptr<const MobilityModel> model)
+{
+  (*counter)++;
+}
+
+void
+LazyRandomMobilityTestCase::DoRun (void)
+{
+  // the lazy model is queried at irregular intervals, the eager model is
+  // advanced by events; the query times do not coincide with the time steps
+  // of the Gauss-Markov model, whose transition would otherwise happen after
+  // the query in the eager case and before the query in the lazy case
+  Ptr<MobilityModel> eager = CreateModel (false, nullptr);
+  Ptr<MobilityModel> lazy = CreateModel (true, nullptr);
+  for (double t = 0.35; t < 60; t += 1.7)
+    {
+      Simulator::Schedule (Seconds (t), &LazyRandomMobilityTestCase::Compare, this, eager, lazy);
+    }
+  Simulator::Stop (Seconds (60));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // without course change listeners, a lazy model does not schedule events
+  // (but for the first time step of the Gauss-Markov model)
+  lazy = CreateModel (true, nullptr);
+  Simulator::Stop (Seconds (60));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_LT (Simulator::GetEventCount (), 3, "Unexpected events");
+  Vector position = lazy->GetPosition ();
+  NS_TEST_EXPECT_MSG_EQ ((position.x >= 0 && position.x <= 100 && position.y >= 0 && position.y <= 100),
+                         true, "The model left its bounds");
+  Simulator::Destroy ();
+
+  // the course changes are notified on time if the trace source is connected
+  // before the model is initialized
+  uint32_t eagerCourseChanges = 0;
+  uint32_t lazyCourseChanges = 0;
+  eager = CreateModel (false, &eagerCourseChanges);
+  lazy = CreateModel (true, &lazyCourseChanges);
+  Simulator::Stop (Seconds (60));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_GT (eagerCourseChanges, 10, "Too few course changes");
+  NS_TEST_EXPECT_MSG_EQ (lazyCourseChanges, eagerCourseChanges, "Unexpected number of course changes");
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Lazy random mobility models test suite
+ */
+class LazyRandomMobilityTestSuite : public TestSuite
+{
+public:
+  LazyRandomMobilityTestSuite ();
+};
+
+LazyRandomMobilityTestSuite::LazyRandomMobilityTestSuite ()
+  : TestSuite ("lazy-random-mobility", UNIT)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (RandomWaypointMobilityModel::GetTypeId ());
+  factory.Set ("Pause", StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=2.0]"));
+  factory.Set ("Speed", StringValue ("ns3::UniformRandomVariable[Min=1.0|Max=20.0]"));
+  AddTestCase (new LazyRandomMobilityTestCase (factory), TestCase::QUICK);
+
+  factory = ObjectFactory ();
+  factory.SetTypeId (RandomWalk2dMobilityModel::GetTypeId ());
+  factory.Set ("Bounds", RectangleValue (Rectangle (0.0, 100.0, 0.0, 100.0)));
+  factory.Set ("Mode", StringValue ("Time"));
+  factory.Set ("Time", StringValue ("5s"));
+  factory.Set ("Speed", StringValue ("ns3::UniformRandomVariable[Min=5.0|Max=20.0]"));
+  AddTestCase (new LazyRandomMobilityTestCase (factory), TestCase::QUICK);
+
+  factory = ObjectFactory ();
+  factory.SetTypeId (RandomDirection2dMobilityModel::GetTypeId ());
+  factory.Set ("Bounds", RectangleValue (Rectangle (0.0, 100.0, 0.0, 100.0)));
+  factory.Set ("Speed", StringValue ("ns3::UniformRandomVariable[Min=5.0|Max=20.0]"));
+  factory.Set ("Pause", StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=2.0]"));
+  AddTestCase (new LazyRandomMobilityTestCase (factory), TestCase::QUICK);
+
+  factory = ObjectFactory ();
+  factory.SetTypeId (GaussMarkovMobilityModel::GetTypeId ());
+  factory.Set ("Bounds", BoxValue (Box (0.0, 100.0, 0.0, 100.0, 0.0, 100.0)));
+  factory.Set ("MeanVelocity", StringValue ("ns3::UniformRandomVariable[Min=5.0|Max=10.0]"));
+  factory.Set ("Alpha", StringValue ("0.85"));
+  AddTestCase (new LazyRandomMobilityTestCase (factory), TestCase::QUICK);
+}
+
+static LazyRandomMobilityTestSuite g_lazyRandomMobilityTestSuite; ///< the test suite
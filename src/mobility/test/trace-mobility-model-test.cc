@@ -0,0 +1,367 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/ns2-mobility-helper.h"
+#include "ns3/mobility-trace-data.h"
+#include "ns3/trace-mobility-model.h"
+#include "ns3/trace-mobility-helper.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check the positions and the velocities interpolated by the
+ * TraceMobilityModel, and the course change notifications.
+ */
+class TraceMobilityModelTestCase : public TestCase
+{
+public:
+  TraceMobilityModelTestCase ();
+  virtual ~TraceMobilityModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the position and the velocity of a model
+   * \param model the mobility model
+   * \param position the expected position
+   * \param velocity the expected velocity
+   */
+  void Check (Ptr<MobilityModel> model, Vector position, Vector velocity);
+  /**
+   * Course change callback
+   * \param model the mobility model
+   */
+  void CourseChange (Ptr<const MobilityModel> model);
+
+  std::vector<Time> m_courseChanges; //!< the times of the course changes
+};
+
+TraceMobilityModelTestCase::TraceMobilityModelTestCase ()
+  : TestCase ("Check the interpolation of the positions of a trace")
+{
+}
+
+TraceMobilityModelTestCase::~TraceMobilityModelTestCase ()
+{
+}
+
+void
+TraceMobilityModelTestCase::Check (Ptr<MobilityModel> model, Vector position, Vector velocity)
+{
+  NS_TEST_EXPECT_MSG_LT (CalculateDistance (model->GetPosition (), position), 1e-9,
+                         "Unexpected position " << model->GetPosition () << " at " << Simulator::Now ().As (Time::S));
+  NS_TEST_EXPECT_MSG_LT (CalculateDistance (model->GetVelocity (), velocity), 1e-9,
+                         "Unexpected velocity " << model->GetVelocity () << " at " << Simulator::Now ().As (Time::S));
+}
+
+void
+TraceMobilityModelTestCase::CourseChange (Ptr<const MobilityModel> model)
+{
+  m_courseChanges.push_back (Simulator::Now ());
+}
+
+void
+TraceMobilityModelTestCase::DoRun (void)
+{
+  // node 0 has no samples, node 1 jumps at 3 s
+  Ptr<MobilityTraceData> trace = Create<MobilityTraceData> ();
+  trace->AddSample (1, Seconds (1), Vector (0, 0, 0));
+  trace->AddSample (1, Seconds (3), Vector (20, 0, 0));
+  trace->AddSample (2, Seconds (0), Vector (7, 7, 7));
+  trace->AddSample (1, Seconds (3), Vector (50, 50, 0));
+  trace->AddSample (1, Seconds (5), Vector (50, 70, 0));
+  trace->Finalize ();
+  NS_TEST_ASSERT_MSG_EQ (trace->GetNNodes (), 3, "Unexpected number of nodes");
+  NS_TEST_ASSERT_MSG_EQ (trace->GetNSamples (), 5, "Unexpected number of samples");
+  NS_TEST_ASSERT_MSG_EQ (trace->GetBegin (0), trace->GetEnd (0), "Node 0 should have no samples");
+  uint64_t begin = trace->GetBegin (1);
+  NS_TEST_ASSERT_MSG_EQ (trace->GetEnd (1) - begin, 4, "Unexpected number of samples of node 1");
+  for (uint64_t hint = begin; hint < trace->GetEnd (1); hint++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (trace->FindSample (1, Seconds (0), hint), begin, "Wrong sample before the first one");
+      NS_TEST_EXPECT_MSG_EQ (trace->FindSample (1, Seconds (2), hint), begin, "Wrong sample at 2 s");
+      NS_TEST_EXPECT_MSG_EQ (trace->FindSample (1, Seconds (3), hint), begin + 2, "Wrong sample at 3 s");
+      NS_TEST_EXPECT_MSG_EQ (trace->FindSample (1, Seconds (9), hint), begin + 3, "Wrong sample after the last one");
+    }
+
+  Ptr<TraceMobilityModel> model = CreateObject<TraceMobilityModel> ();
+  model->SetTrace (trace, 1);
+  model->TraceConnectWithoutContext ("CourseChange", MakeCallback (&TraceMobilityModelTestCase::CourseChange, this));
+  model->Initialize ();
+  Ptr<TraceMobilityModel> empty = CreateObject<TraceMobilityModel> ();
+  empty->SetTrace (trace, 0);
+  empty->SetPosition (Vector (1, 2, 3));
+  empty->Initialize ();
+
+  Vector zero;
+  Simulator::Schedule (Seconds (0.5), &TraceMobilityModelTestCase::Check, this, model, Vector (0, 0, 0), zero);
+  Simulator::Schedule (Seconds (2), &TraceMobilityModelTestCase::Check, this, model, Vector (10, 0, 0), Vector (10, 0, 0));
+  Simulator::Schedule (Seconds (3), &TraceMobilityModelTestCase::Check, this, model, Vector (50, 50, 0), Vector (0, 10, 0));
+  Simulator::Schedule (Seconds (3.5), &MobilityModel::SetPosition, model, Vector (1, 1, 1));
+  Simulator::Schedule (Seconds (4), &TraceMobilityModelTestCase::Check, this, model, Vector (1, 1, 1), zero);
+  Simulator::Schedule (Seconds (5), &TraceMobilityModelTestCase::Check, this, model, Vector (50, 70, 0), zero);
+  Simulator::Schedule (Seconds (6), &TraceMobilityModelTestCase::Check, this, model, Vector (50, 70, 0), zero);
+  Simulator::Schedule (Seconds (6), &TraceMobilityModelTestCase::Check, this, empty, Vector (1, 2, 3), zero);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // one notification per sample time, and one when the position is set
+  std::vector<Time> expected = {Seconds (1), Seconds (3), Seconds (3.5), Seconds (5)};
+  NS_TEST_ASSERT_MSG_EQ (m_courseChanges.size (), expected.size (), "Unexpected number of course changes");
+  for (uint32_t i = 0; i < expected.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_courseChanges[i], expected[i], "Unexpected time of course change " << i);
+    }
+
+  // without listeners, no event is scheduled
+  model = CreateObject<TraceMobilityModel> ();
+  model->SetTrace (trace, 1);
+  model->Initialize ();
+  NS_TEST_EXPECT_MSG_EQ (Simulator::IsFinished (), true, "No event should be scheduled");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that MobilityTraceData::Compact removes the redundant samples
+ * and that a trace is unchanged after it is written to a file and read back.
+ */
+class MobilityTraceDataFileTestCase : public TestCase
+{
+public:
+  MobilityTraceDataFileTestCase ();
+  virtual ~MobilityTraceDataFileTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MobilityTraceDataFileTestCase::MobilityTraceDataFileTestCase ()
+  : TestCase ("Check the compaction and the binary file of a trace")
+{
+}
+
+MobilityTraceDataFileTestCase::~MobilityTraceDataFileTestCase ()
+{
+}
+
+void
+MobilityTraceDataFileTestCase::DoRun (void)
+{
+  // node 0 moves straight at a constant speed from 0 to 10 s, stops from 10
+  // to 20 s, turns at 25 s and stops at 30 s; node 1 moves on a circle
+  Ptr<MobilityTraceData> trace = Create<MobilityTraceData> ();
+  for (uint32_t t = 0; t <= 30; t++)
+    {
+      double x = std::min (t, 10u) * 2.0 + (t > 20 ? std::min (t, 25u) - 20.0 : 0.0);
+      double y = (t > 25 ? std::min (t, 30u) - 25.0 : 0.0);
+      trace->AddSample (0, Seconds (t), Vector (x, y, 1.5));
+      trace->AddSample (1, Seconds (t), Vector (100 * std::cos (t * 0.1), 100 * std::sin (t * 0.1), 0));
+    }
+  trace->Finalize ();
+  Ptr<MobilityTraceData> compacted = Create<MobilityTraceData> (*trace);
+  compacted->Compact (1e-9);
+  // the samples of node 0 at 0, 10, 20, 25 and 30 s are kept
+  NS_TEST_EXPECT_MSG_EQ (compacted->GetEnd (0) - compacted->GetBegin (0), 5, "Unexpected number of samples of node 0");
+  NS_TEST_EXPECT_MSG_EQ (compacted->GetEnd (1) - compacted->GetBegin (1), 31, "No sample of node 1 should be removed");
+
+  std::string filename = CreateTempDirFilename ("trace-mobility-model-test.ns3mob");
+  compacted->Write (filename);
+  Ptr<MobilityTraceData> read = MobilityTraceData::Read (filename);
+  NS_TEST_ASSERT_MSG_EQ (read->GetNNodes (), compacted->GetNNodes (), "Unexpected number of nodes");
+  NS_TEST_ASSERT_MSG_EQ (read->GetNSamples (), compacted->GetNSamples (), "Unexpected number of samples");
+  for (uint32_t node = 0; node < read->GetNNodes (); node++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (read->GetBegin (node), compacted->GetBegin (node), "Unexpected first sample");
+    }
+  for (uint64_t i = 0; i < read->GetNSamples (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (read->GetSampleTime (i), compacted->GetSampleTime (i), "Unexpected time");
+      NS_TEST_EXPECT_MSG_EQ (read->GetSamplePosition (i), compacted->GetSamplePosition (i), "Unexpected position");
+    }
+
+  // the original and the compacted traces yield the same positions
+  NodeContainer nodes;
+  nodes.Create (2);
+  NodeContainer compactedNodes;
+  compactedNodes.Create (2);
+  TraceMobilityHelper (trace).Install (nodes);
+  TraceMobilityHelper (filename).Install (compactedNodes);
+  for (double t = 0; t < 35; t += 0.25)
+    {
+      Simulator::Stop (Seconds (t) - Simulator::Now ());
+      Simulator::Run ();
+      for (uint32_t i = 0; i < 2; i++)
+        {
+          Ptr<MobilityModel> model = nodes.Get (i)->GetObject<MobilityModel> ();
+          Ptr<MobilityModel> compactedModel = compactedNodes.Get (i)->GetObject<MobilityModel> ();
+          NS_TEST_EXPECT_MSG_LT (CalculateDistance (model->GetPosition (), compactedModel->GetPosition ()), 1e-6,
+                                 "Different positions of node " << i << " at " << t << " s");
+        }
+    }
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check the conversion of an ns-2 movement file against the
+ * Ns2MobilityHelper and the conversion of a SUMO floating car data file.
+ */
+class MobilityTraceDataConversionTestCase : public TestCase
+{
+public:
+  MobilityTraceDataConversionTestCase ();
+  virtual ~MobilityTraceDataConversionTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compare the positions of the nodes moved by the Ns2MobilityHelper and
+   * of the nodes following the converted trace
+   * \param ns2Nodes the nodes moved by the Ns2MobilityHelper
+   * \param traceNodes the nodes following the trace
+   */
+  void Compare (NodeContainer ns2Nodes, NodeContainer traceNodes);
+};
+
+MobilityTraceDataConversionTestCase::MobilityTraceDataConversionTestCase ()
+  : TestCase ("Check the conversion of ns-2 and SUMO traces")
+{
+}
+
+MobilityTraceDataConversionTestCase::~MobilityTraceDataConversionTestCase ()
+{
+}
+
+void
+MobilityTraceDataConversionTestCase::Compare (NodeContainer ns2Nodes, NodeContainer traceNodes)
+{
+  for (uint32_t i = 0; i < ns2Nodes.GetN (); i++)
+    {
+      Vector expected = ns2Nodes.Get (i)->GetObject<MobilityModel> ()->GetPosition ();
+      Vector actual = traceNodes.Get (i)->GetObject<MobilityModel> ()->GetPosition ();
+      NS_TEST_EXPECT_MSG_LT (CalculateDistance (actual, expected), 1e-6,
+                             "Node " << i << " at " << actual << " instead of " << expected
+                             << " at " << Simulator::Now ().As (Time::S));
+    }
+}
+
+void
+MobilityTraceDataConversionTestCase::DoRun (void)
+{
+  std::string ns2File = CreateTempDirFilename ("trace-mobility-model-test.tcl");
+  std::ofstream ns2 (ns2File.c_str ());
+  ns2 << "$node_(0) set X_ 0.0\n"
+      << "$node_(0) set Y_ 0.0\n"
+      << "$node_(0) set Z_ 0.0\n"
+      << "$node_(1) set X_ 100.0\n"
+      << "$node_(1) set Y_ 0.0\n"
+      << "$node_(1) set Z_ 0.0\n"
+      << "$ns_ at 1.0 \"$node_(0) setdest 10.0 0.0 2.0\"\n"      // arrives at 6 s
+      << "$ns_ at 2.0 \"$node_(1) setdest 100.0 50.0 5.0\"\n"    // interrupted at 4 s
+      << "$ns_ at 4.0 \"$node_(1) setdest 40.0 90.0 10.0\"\n"    // arrives at 14 s
+      << "$ns_ at 8.0 \"$node_(0) setdest 10.0 20.0 4.0\"\n"     // arrives at 13 s
+      << "$ns_ at 9.0 \"$node_(2) setdest 5.0 5.0 0.0\"\n"       // does not move
+      << "$node_(3) set X_ 1.0\n"
+      << "$ns_ at 20.0 \"$node_(3) set X_ 30.0\"\n";
+  ns2.close ();
+  Ptr<MobilityTraceData> trace = MobilityTraceData::ReadNs2 (ns2File);
+  NS_TEST_ASSERT_MSG_EQ (trace->GetNNodes (), 4, "Unexpected number of nodes");
+
+  // the Ns2MobilityHelper moves a node to the position set at a given time
+  // when the file is parsed, hence node 3 is not compared
+  NodeContainer ns2Nodes;
+  ns2Nodes.Create (3);
+  Ns2MobilityHelper (ns2File).Install (ns2Nodes.Begin (), ns2Nodes.End ());
+  NodeContainer traceNodes;
+  traceNodes.Create (3);
+  TraceMobilityHelper (trace).Install (traceNodes);
+  for (double t = 0; t < 20; t += 0.3)
+    {
+      Simulator::Schedule (Seconds (t), &MobilityTraceDataConversionTestCase::Compare, this, ns2Nodes, traceNodes);
+    }
+  Simulator::Stop (Seconds (21));
+  Simulator::Run ();
+  Ptr<TraceMobilityModel> model = CreateObject<TraceMobilityModel> ();
+  model->SetTrace (trace, 3);
+  NS_TEST_EXPECT_MSG_LT (CalculateDistance (model->GetPosition (), Vector (30, 0, 0)), 1e-9, "Wrong position after set X_");
+  Simulator::Destroy ();
+
+  std::string fcdFile = CreateTempDirFilename ("trace-mobility-model-test.xml");
+  std::ofstream fcd (fcdFile.c_str ());
+  fcd << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      << "<fcd-export>\n"
+      << "    <timestep time=\"0.00\">\n"
+      << "        <vehicle id=\"car1\" x=\"0.00\" y=\"5.00\" angle=\"90.00\" type=\"DEFAULT_VEHTYPE\" speed=\"0.00\" pos=\"5.10\" lane=\"e0_0\" slope=\"0.00\"/>\n"
+      << "    </timestep>\n"
+      << "    <timestep time=\"1.00\">\n"
+      << "        <vehicle id=\"car1\" x=\"10.00\" y=\"5.00\" angle=\"90.00\" type=\"DEFAULT_VEHTYPE\" speed=\"10.00\" pos=\"15.10\" lane=\"e0_0\" slope=\"0.00\"/>\n"
+      << "        <vehicle id=\"car2\" x=\"50.00\" y=\"50.00\" z=\"2.00\" angle=\"0.00\" type=\"DEFAULT_VEHTYPE\" speed=\"0.00\" pos=\"5.10\" lane=\"e1_0\" slope=\"0.00\"/>\n"
+      << "        <person id=\"ped0\" x=\"1.00\" y=\"1.00\" angle=\"0.00\" speed=\"0.00\" pos=\"0.00\" edge=\"e1\" slope=\"0.00\"/>\n"
+      << "    </timestep>\n"
+      << "    <timestep time=\"2.00\">\n"
+      << "        <vehicle id=\"car2\" x=\"50.00\" y=\"70.00\" z=\"2.00\" angle=\"0.00\" type=\"DEFAULT_VEHTYPE\" speed=\"20.00\" pos=\"25.10\" lane=\"e1_0\" slope=\"0.00\"/>\n"
+      << "    </timestep>\n"
+      << "</fcd-export>\n";
+  fcd.close ();
+  std::vector<std::string> ids;
+  trace = MobilityTraceData::ReadSumoFcd (fcdFile, &ids);
+  std::vector<std::string> expectedIds = {"car1", "car2", "ped0"};
+  NS_TEST_ASSERT_MSG_EQ (trace->GetNNodes (), 3, "Unexpected number of nodes");
+  NS_TEST_EXPECT_MSG_EQ ((ids == expectedIds), true, "Unexpected identifiers");
+  NS_TEST_EXPECT_MSG_EQ (trace->GetNSamples (), 5, "Unexpected number of samples");
+  model = CreateObject<TraceMobilityModel> ();
+  model->SetTrace (trace, 1);
+  Simulator::Stop (Seconds (1.5));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_LT (CalculateDistance (model->GetPosition (), Vector (50, 60, 2)), 1e-9, "Wrong position");
+  NS_TEST_EXPECT_MSG_LT (CalculateDistance (model->GetVelocity (), Vector (0, 20, 0)), 1e-9, "Wrong velocity");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Trace mobility model test suite
+ */
+class TraceMobilityModelTestSuite : public TestSuite
+{
+public:
+  TraceMobilityModelTestSuite ();
+};
+
+TraceMobilityModelTestSuite::TraceMobilityModelTestSuite ()
+  : TestSuite ("trace-mobility-model", UNIT)
+{
+  AddTestCase (new TraceMobilityModelTestCase, TestCase::QUICK);
+  AddTestCase (new MobilityTraceDataFileTestCase, TestCase::QUICK);
+  AddTestCase (new MobilityTraceDataConversionTestCase, TestCase::QUICK);
+}
+
+static TraceMobilityModelTestSuite g_traceMobilityModelTestSuite; ///< the test suite
@@ -41,4 +41,10 @@ NetDevice::~NetDevice ()
   NS_LOG_FUNCTION (this);
 }
 
+bool
+NetDevice::SupportsSegmentationOffload (Ptr<const Packet> packet) const
+{
+  return false;
+}
+
 } // namespace ns3
@@ -359,6 +359,20 @@ public:
    */
   virtual bool SupportsSendFrom (void) const = 0;
 
+  /**
+   * \param packet A super-segment marked with a SegmentationOffloadTag,
+   * with its network layer header.
+   * \return true if this interface can send the super-segment as a whole,
+   * with the same outcome as its segments, false otherwise.
+   *
+   * The network layer splits the super-segments into segments before the
+   * queue discs, which drop and mark each packet, and before the devices
+   * which cannot send them as a whole.  A device which can should check
+   * that none of the segments would be dropped by its queue or by an error
+   * model.  The default is false.
+   */
+  virtual bool SupportsSegmentationOffload (Ptr<const Packet> packet) const;
+
 };
 
 } // namespace ns3
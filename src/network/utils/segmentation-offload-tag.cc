@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "segmentation-offload-tag.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/queue.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SegmentationOffloadTag");
+
+NS_OBJECT_ENSURE_REGISTERED (SegmentationOffloadTag);
+
+TypeId
+SegmentationOffloadTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SegmentationOffloadTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Network")
+    .AddConstructor<SegmentationOffloadTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+SegmentationOffloadTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+SegmentationOffloadTag::GetSerializedSize (void) const
+{
+  return 6;
+}
+
+void
+SegmentationOffloadTag::Serialize (TagBuffer buf) const
+{
+  buf.WriteU32 (m_payloadSize);
+  buf.WriteU16 (m_segmentSize);
+}
+
+void
+SegmentationOffloadTag::Deserialize (TagBuffer buf)
+{
+  m_payloadSize = buf.ReadU32 ();
+  m_segmentSize = buf.ReadU16 ();
+}
+
+void
+SegmentationOffloadTag::Print (std::ostream &os) const
+{
+  os << "PayloadSize=" << m_payloadSize << " SegmentSize=" << m_segmentSize;
+}
+
+SegmentationOffloadTag::SegmentationOffloadTag ()
+  : Tag (),
+    m_payloadSize (0),
+    m_segmentSize (1)
+{
+}
+
+SegmentationOffloadTag::SegmentationOffloadTag (uint32_t payloadSize, uint16_t segmentSize)
+  : Tag (),
+    m_payloadSize (payloadSize),
+    m_segmentSize (segmentSize)
+{
+  NS_LOG_FUNCTION (this << payloadSize << segmentSize);
+  NS_ASSERT (segmentSize > 0);
+}
+
+uint32_t
+SegmentationOffloadTag::GetPayloadSize (void) const
+{
+  return m_payloadSize;
+}
+
+uint16_t
+SegmentationOffloadTag::GetSegmentSize (void) const
+{
+  return m_segmentSize;
+}
+
+uint32_t
+SegmentationOffloadTag::GetSegments (void) const
+{
+  return (m_payloadSize + m_segmentSize - 1) / m_segmentSize;
+}
+
+uint32_t
+SegmentationOffloadTag::GetWireSize (uint32_t packetSize) const
+{
+  NS_ASSERT (packetSize >= m_payloadSize);
+  return m_payloadSize + GetSegments () * (packetSize - m_payloadSize);
+}
+
+bool
+SegmentationOffloadTag::FitsIn (Ptr<const QueueBase> queue, uint32_t packetSize) const
+{
+  return queue->GetMaxSize ().GetUnit () == QueueSizeUnit::BYTES
+         && !queue->WouldOverflow (GetSegments (), GetWireSize (packetSize));
+}
+
+} // namespace ns3
@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef SEGMENTATION_OFFLOAD_TAG_H
+#define SEGMENTATION_OFFLOAD_TAG_H
+
+#include "ns3/tag.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+class QueueBase;
+
+/**
+ * \ingroup network
+ *
+ * \brief Tag of a super-segment, which carries the payload of several
+ * segments behind a single copy of their headers.
+ *
+ * The super-segments sent by a transport protocol with segmentation
+ * offload stay aggregated down to the devices which support it (see
+ * NetDevice::SupportsSegmentationOffload), and are split into segments by
+ * the network layer before the queue discs and the other devices.  A device which sends a
+ * super-segment as a whole takes the time needed to transmit all its
+ * segments, each with a copy of the headers, on the wire.
+ */
+class SegmentationOffloadTag : public Tag
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * The largest payload of a super-segment, which fits in an IP packet
+   * with the largest IPv4 and TCP headers
+   */
+  static constexpr uint32_t MAX_PAYLOAD_SIZE = 65535 - 60 - 60;
+
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer buf) const;
+  virtual void Deserialize (TagBuffer buf);
+  virtual void Print (std::ostream &os) const;
+  SegmentationOffloadTag ();
+
+  /**
+   * Constructs a SegmentationOffloadTag
+   *
+   * \param payloadSize the number of bytes of payload of the super-segment
+   * \param segmentSize the maximum number of bytes of payload of a segment
+   */
+  SegmentationOffloadTag (uint32_t payloadSize, uint16_t segmentSize);
+
+  /**
+   * \returns the number of bytes of payload of the super-segment
+   */
+  uint32_t GetPayloadSize (void) const;
+  /**
+   * \returns the maximum number of bytes of payload of a segment
+   */
+  uint16_t GetSegmentSize (void) const;
+  /**
+   * \returns the number of segments of the super-segment
+   */
+  uint32_t GetSegments (void) const;
+  /**
+   * \param packetSize the size of the super-segment, with its headers
+   * \returns the total size of the segments, each with a copy of the headers
+   */
+  uint32_t GetWireSize (uint32_t packetSize) const;
+  /**
+   * A queue counts a super-segment as one packet, with one copy of the
+   * headers.  The super-segment has the same fate as its segments only in a
+   * queue of bytes, up to the copies of the headers, and only if the queue
+   * has room for all its segments.
+   *
+   * \param queue the queue of a device
+   * \param packetSize the size of the super-segment in the queue, with its
+   * headers
+   * \returns true if the queue would hold all the segments
+   */
+  bool FitsIn (Ptr<const QueueBase> queue, uint32_t packetSize) const;
+
+private:
+  uint32_t m_payloadSize; //!< Payload size of the super-segment
+  uint16_t m_segmentSize; //!< Maximum payload size of a segment
+};
+
+} // namespace ns3
+
+#endif /* SEGMENTATION_OFFLOAD_TAG_H */
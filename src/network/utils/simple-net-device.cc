@@ -30,6 +30,7 @@
 #include "ns3/tag.h"
 #include "ns3/simulator.h"
 #include "ns3/queue.h"
+#include "segmentation-offload-tag.h"
 
 namespace ns3 {
 
@@ -428,7 +429,8 @@ bool
 SimpleNetDevice::SendFrom (Ptr<Packet> p, const Address& source, const Address& dest, uint16_t protocolNumber)
 {
   NS_LOG_FUNCTION (this << p << source << dest << protocolNumber);
-  if (p->GetSize () > GetMtu ())
+  SegmentationOffloadTag offload;
+  if (p->GetSize () > GetMtu () && !p->PeekPacketTag (offload))
     {
       return false;
     }
@@ -479,7 +481,14 @@ SimpleNetDevice::StartTransmission ()
   Time txTime = Time (0);
   if (m_bps > DataRate (0))
     {
-      txTime = m_bps.CalculateBytesTxTime (packet->GetSize ());
+      // A super-segment takes the time of its segments on the wire
+      uint32_t size = packet->GetSize ();
+      SegmentationOffloadTag offload;
+      if (packet->PeekPacketTag (offload))
+        {
+          size = offload.GetWireSize (size);
+        }
+      txTime = m_bps.CalculateBytesTxTime (size);
     }
   FinishTransmissionEvent = Simulator::Schedule (txTime, &SimpleNetDevice::FinishTransmission, this, packet);
 }
@@ -562,4 +571,27 @@ SimpleNetDevice::SupportsSendFrom (void) const
   return true;
 }
 
+bool
+SimpleNetDevice::SupportsSegmentationOffload (Ptr<const Packet> packet) const
+{
+  NS_LOG_FUNCTION (this << packet);
+  SegmentationOffloadTag offload;
+  bool found = packet->PeekPacketTag (offload);
+  NS_ASSERT_MSG (found, "Not a super-segment");
+  if (m_channel == 0 || !offload.FitsIn (m_queue, packet->GetSize ()))
+    {
+      return false;
+    }
+  // The receive error models of the other devices act on each segment
+  for (std::size_t i = 0; i < m_channel->GetNDevices (); i++)
+    {
+      Ptr<SimpleNetDevice> device = DynamicCast<SimpleNetDevice> (m_channel->GetDevice (i));
+      if (device != 0 && device != this && device->m_receiveErrorModel != 0)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
 } // namespace ns3
@@ -134,6 +134,7 @@ public:
 
   virtual void SetPromiscReceiveCallback (PromiscReceiveCallback cb);
   virtual bool SupportsSendFrom (void) const;
+  virtual bool SupportsSegmentationOffload (Ptr<const Packet> packet) const;
 
 protected:
   virtual void DoDispose (void);
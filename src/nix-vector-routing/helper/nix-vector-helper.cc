@@ -26,6 +26,7 @@
 #include "nix-vector-helper.h"
 #include "ns3/nix-vector-routing.h"
 #include "ns3/assert.h"
+#include "ns3/abort.h"
 
 namespace ns3 {
 
@@ -78,6 +79,19 @@ NixVectorHelper<T>::PrintRoute (Ptr<Node> source, IpAddress dest, Ptr<OutputStre
   rp->PrintRoutingPath (source, dest, stream, unit);
 }
 
+template <typename T>
+void
+NixVectorHelper<T>::PrecomputeBfsTrees (NodeContainer sources) const
+{
+  if (sources.GetN () == 0)
+    {
+      return;
+    }
+  Ptr<NixVectorRouting<IpRoutingProtocol>> rp = sources.Get (0)->GetObject<NixVectorRouting<IpRoutingProtocol>> ();
+  NS_ABORT_MSG_UNLESS (rp, "NixVectorHelper::PrecomputeBfsTrees (): the sources do not use nix-vector routing");
+  rp->PrecomputeBfsTrees (sources);
+}
+
 template class NixVectorHelper<Ipv4RoutingHelper>;
 template class NixVectorHelper<Ipv6RoutingHelper>;
 
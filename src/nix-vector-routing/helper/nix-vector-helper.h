@@ -27,6 +27,7 @@
 #define NIX_VECTOR_HELPER_H
 
 #include "ns3/object-factory.h"
+#include "ns3/node-container.h"
 #include "ns3/ipv4-routing-helper.h"
 #include "ns3/ipv6-routing-helper.h"
 
@@ -104,6 +105,19 @@ public:
    */
   void PrintRoutingPathAt (Time printTime, Ptr<Node> source, IpAddress dest, Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S);
 
+  /**
+   * \brief computes the BFS trees of the sources, from which the nix-vectors
+   * to every destination are built, before they are needed.
+   * \param sources the source nodes, which must use nix-vector routing
+   *
+   * This method calls the PrecomputeBfsTrees() method of the
+   * NixVectorRouting, which computes the trees in parallel using the
+   * number of threads given by the NixVectorRoutingNumThreads global value.
+   * It is typically called before Simulator::Run, once the addresses are
+   * assigned.
+   */
+  void PrecomputeBfsTrees (NodeContainer sources) const;
+
 private:
   /**
    * \brief Assignment operator declared private and not implemented to disallow
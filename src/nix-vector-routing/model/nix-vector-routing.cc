@@ -25,10 +25,17 @@
 
 #include <queue>
 #include <iomanip>
+#include <limits>
+#include <algorithm>
+#include <set>
 
 #include "ns3/log.h"
 #include "ns3/abort.h"
 #include "ns3/names.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
+#include "ns3/core-config.h"
+#include "ns3/system-thread.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/loopback-net-device.h"
 
@@ -41,9 +48,152 @@ NS_LOG_COMPONENT_DEFINE ("NixVectorRouting");
 NS_OBJECT_TEMPLATE_CLASS_DEFINE (NixVectorRouting, Ipv4RoutingProtocol);
 NS_OBJECT_TEMPLATE_CLASS_DEFINE (NixVectorRouting, Ipv6RoutingProtocol);
 
+/**
+ * \relates NixVectorRouting
+ * \anchor GlobalValueNixVectorRoutingNumThreads
+ * \brief The number of threads used to precompute the BFS trees.
+ */
+static GlobalValue g_nixVectorRoutingNumThreads = GlobalValue ("NixVectorRoutingNumThreads",
+                                                               "The number of threads used by PrecomputeBfsTrees "
+                                                               "to compute the BFS trees of nix-vector routing. "
+                                                               "The trees do not depend on this value.",
+                                                               UintegerValue (1),
+                                                               MakeUintegerChecker<uint32_t> (1));
+
+namespace {
+
+/// The parent of the nodes which are not reached by a BFS tree
+const uint32_t NO_PARENT = std::numeric_limits<uint32_t>::max ();
+
+/**
+ * \ingroup nix-vector-routing
+ * \brief Compute a BFS tree from the neighbors of the nodes.
+ *
+ * The tree is the one built by NixVectorRouting::BFS, which stops
+ * when it reaches its destination, but spans all the nodes reached.
+ *
+ * \param [in] adjacency The neighbors of each node, in the order of the BFS
+ * \param [in] source The ID of the source node
+ * \param [out] parentVector The parent of each node, or NO_PARENT
+ */
+void
+ComputeBfsTree (const std::vector<std::vector<uint32_t> > &adjacency, uint32_t source,
+                std::vector<uint32_t> &parentVector)
+{
+  parentVector.assign (adjacency.size (), NO_PARENT);
+  // The nodes in the order of their discovery; the nodes from the
+  // head on have unexplored children
+  std::vector<uint32_t> greyNodeList;
+  greyNodeList.push_back (source);
+  parentVector[source] = source;
+  for (std::size_t head = 0; head < greyNodeList.size (); head++)
+    {
+      uint32_t currNode = greyNodeList[head];
+      for (uint32_t remoteNode : adjacency[currNode])
+        {
+          if (parentVector[remoteNode] == NO_PARENT)
+            {
+              parentVector[remoteNode] = currNode;
+              greyNodeList.push_back (remoteNode);
+            }
+        }
+    }
+}
+
+/**
+ * \ingroup nix-vector-routing
+ * \param tree A BFS tree
+ * \param node The ID of a node
+ * \returns The parent of the node in the tree, or NO_PARENT
+ */
+uint32_t
+GetParent (const std::vector<uint32_t> &tree, uint32_t node)
+{
+  return node < tree.size () ? tree[node] : NO_PARENT;
+}
+
+/**
+ * \ingroup nix-vector-routing
+ * \param tree A BFS tree
+ * \param node The ID of a node
+ * \returns The depth of the node in the tree, or NO_PARENT
+ */
+uint32_t
+GetDepth (const std::vector<uint32_t> &tree, uint32_t node)
+{
+  if (GetParent (tree, node) == NO_PARENT)
+    {
+      return NO_PARENT;
+    }
+  uint32_t depth = 0;
+  for (; tree[node] != node; node = tree[node])
+    {
+      depth++;
+    }
+  return depth;
+}
+
+/**
+ * \ingroup nix-vector-routing
+ * \brief A share of the BFS trees computed by NixVectorRouting::PrecomputeBfsTrees.
+ *
+ * The tasks only read the neighbors of the nodes and each writes to the
+ * trees of its own sources, so that they can run in parallel.
+ */
+class BfsTask
+{
+public:
+  /**
+   * Constructor
+   * \param adjacency the neighbors of each node
+   * \param sources the sources whose trees are computed
+   * \param first the index of the first source whose tree is computed by this task
+   * \param step the distance between two sources whose trees are computed by this task
+   * \param trees the BFS trees, by node ID
+   */
+  BfsTask (const std::vector<std::vector<uint32_t> > *adjacency, const std::vector<uint32_t> *sources,
+           std::size_t first, std::size_t step, std::vector<std::vector<uint32_t> > *trees)
+    : m_adjacency (adjacency),
+      m_sources (sources),
+      m_first (first),
+      m_step (step),
+      m_trees (trees)
+  {
+  }
+  /**
+   * Compute the trees of the sources assigned to this task
+   */
+  void Run (void)
+  {
+    for (std::size_t i = m_first; i < m_sources->size (); i += m_step)
+      {
+        uint32_t source = (*m_sources)[i];
+        ComputeBfsTree (*m_adjacency, source, (*m_trees)[source]);
+      }
+  }
+
+private:
+  const std::vector<std::vector<uint32_t> > *m_adjacency; //!< the neighbors of each node
+  const std::vector<uint32_t> *m_sources; //!< the sources
+  std::size_t m_first; //!< the index of the first source of this task
+  std::size_t m_step; //!< the distance between two sources of this task
+  std::vector<std::vector<uint32_t> > *m_trees; //!< the BFS trees
+};
+
+} // unnamed namespace
+
 template <typename T>
 bool NixVectorRouting<T>::g_isCacheDirty = false;
 
+template <typename T>
+std::vector<typename NixVectorRouting<T>::BfsTree_t> NixVectorRouting<T>::g_bfsTrees;
+
+template <typename T>
+typename NixVectorRouting<T>::Adjacency_t NixVectorRouting<T>::g_adjacency;
+
+template <typename T>
+std::vector<typename NixVectorRouting<T>::TopologyChange> NixVectorRouting<T>::g_topologyChanges;
+
 template <typename T>
 typename NixVectorRouting<T>::IpAddressToNodeMap NixVectorRouting<T>::g_ipAddressToNodeMap;
 
@@ -122,6 +272,11 @@ NixVectorRouting<T>::DoDispose ()
   m_node = 0;
   m_ip = 0;
 
+  // The trees refer to the nodes by ID, which the next simulation reuses
+  g_bfsTrees.clear ();
+  g_adjacency.clear ();
+  g_topologyChanges.clear ();
+
   T::DoDispose ();
 }
 
@@ -140,6 +295,21 @@ NixVectorRouting<T>::FlushGlobalNixRoutingCache (void) const
 {
   NS_LOG_FUNCTION_NOARGS ();
 
+  FlushNodeCaches ();
+
+  // The BFS trees and the neighbors of the nodes are potentially invalid
+  // so clear them.  Will be computed again when needed.
+  g_bfsTrees.clear ();
+  g_adjacency.clear ();
+  g_topologyChanges.clear ();
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::FlushNodeCaches (void) const
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
   NodeList::Iterator listEnd = NodeList::End ();
   for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
     {
@@ -160,6 +330,297 @@ NixVectorRouting<T>::FlushGlobalNixRoutingCache (void) const
   g_ipAddressToNodeMap.clear ();
 }
 
+template <typename T>
+void
+NixVectorRouting<T>::AddTopologyChange (uint32_t interface, bool removal)
+{
+  NS_LOG_FUNCTION (this << interface << removal);
+
+  if (m_node == 0)
+    {
+      g_isCacheDirty = true;
+      return;
+    }
+  TopologyChange change;
+  change.node = m_node->GetId ();
+  change.interface = interface;
+  change.removal = removal;
+  g_topologyChanges.push_back (change);
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::InvalidateBfsTrees (void) const
+{
+  NS_LOG_FUNCTION (this << g_topologyChanges.size ());
+
+  // The nix-vectors and the routes are built again from the trees which
+  // are kept: the neighbor indexes of the nodes whose links changed may
+  // differ even where the trees do not.
+  FlushNodeCaches ();
+
+  std::vector<TopologyChange> changes;
+  changes.swap (g_topologyChanges);
+  if (g_adjacency.empty ())
+    {
+      // No tree has been computed since the last flush
+      return;
+    }
+
+  // Many changes, such as the configuration of the topology, are
+  // handled faster by computing the trees again
+  bool flushAll = changes.size () > g_adjacency.size ();
+
+  // The other nodes of the channel of each change, and the nodes
+  // whose neighbors may have changed
+  std::vector<std::vector<uint32_t> > peers (changes.size ());
+  std::set<uint32_t> changedNodes;
+  for (std::size_t c = 0; c < changes.size () && !flushAll; c++)
+    {
+      Ptr<Node> node = NodeList::GetNode (changes[c].node);
+      Ptr<NetDevice> device = node->GetObject<IpL3Protocol> ()->GetNetDevice (changes[c].interface);
+      changedNodes.insert (changes[c].node);
+      Ptr<Channel> channel = device->GetChannel ();
+      if (channel == 0)
+        {
+          continue;
+        }
+      for (std::size_t i = 0; i < channel->GetNDevices (); i++)
+        {
+          Ptr<NetDevice> remoteDevice = channel->GetDevice (i);
+          if (remoteDevice->IsBridge () || NetDeviceIsBridged (remoteDevice))
+            {
+              // The neighbors through a bridge span several channels
+              flushAll = true;
+              break;
+            }
+          uint32_t remoteNode = remoteDevice->GetNode ()->GetId ();
+          if (remoteNode != changes[c].node)
+            {
+              peers[c].push_back (remoteNode);
+              changedNodes.insert (remoteNode);
+            }
+        }
+    }
+
+  if (flushAll)
+    {
+      NS_LOG_LOGIC ("Discarding all the BFS trees after " << changes.size () << " topology changes");
+      g_bfsTrees.clear ();
+      g_adjacency.clear ();
+      return;
+    }
+
+  // A link which is removed changes a tree only if it is a link of the
+  // tree.  A link which is added does not change a tree if its nodes are
+  // at the same depth, or both unreached: they are then discovered before
+  // either of them is explored.  A tree is kept when every link between
+  // the nodes of a change meets the condition of its kind.
+  for (std::size_t source = 0; source < g_bfsTrees.size (); source++)
+    {
+      BfsTree_t &tree = g_bfsTrees[source];
+      bool affected = false;
+      for (std::size_t c = 0; c < changes.size () && !tree.empty () && !affected; c++)
+        {
+          uint32_t node = changes[c].node;
+          for (uint32_t remoteNode : peers[c])
+            {
+              if (GetParent (tree, remoteNode) == node || GetParent (tree, node) == remoteNode
+                  || (!changes[c].removal && GetDepth (tree, node) != GetDepth (tree, remoteNode)))
+                {
+                  affected = true;
+                  break;
+                }
+            }
+        }
+      if (affected)
+        {
+          NS_LOG_LOGIC ("Discarding the BFS tree of node " << source);
+          BfsTree_t ().swap (tree);
+        }
+    }
+
+  // Update the neighbors of the nodes of the changes
+  BuildIpAddressToNodeMap ();
+  for (uint32_t id : changedNodes)
+    {
+      if (id < g_adjacency.size ())
+        {
+          g_adjacency[id].clear ();
+          GetBfsNeighbors (NodeList::GetNode (id), g_adjacency[id]);
+        }
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::GetBfsNeighbors (Ptr<Node> node, std::vector<uint32_t> &neighbors) const
+{
+  NS_LOG_FUNCTION (this << node);
+
+  Ptr<IpL3Protocol> ip = node->GetObject<IpL3Protocol> ();
+
+  // Iterate over the node's adjacent vertices as BFS does
+  for (uint32_t i = 0; i < node->GetNDevices (); i++)
+    {
+      Ptr<NetDevice> localNetDevice = node->GetDevice (i);
+
+      // make sure that we can go this way
+      if (ip)
+        {
+          uint32_t interfaceIndex = (ip)->GetInterfaceForDevice (localNetDevice);
+          if (!(ip->IsUp (interfaceIndex)))
+            {
+              continue;
+            }
+        }
+      if (!(localNetDevice->IsLinkUp ()))
+        {
+          continue;
+        }
+      Ptr<Channel> channel = localNetDevice->GetChannel ();
+      if (channel == 0)
+        {
+          continue;
+        }
+
+      NetDeviceContainer netDeviceContainer;
+      GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
+
+      for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
+        {
+          Ptr<IpInterface> remoteIpInterface = GetInterfaceByNetDevice (*iter);
+          if (remoteIpInterface == 0 || !(remoteIpInterface->IsUp ()))
+            {
+              continue;
+            }
+          neighbors.push_back ((*iter)->GetNode ()->GetId ());
+        }
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::BuildAdjacency (void) const
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  uint32_t numberOfNodes = NodeList::GetNNodes ();
+  if (g_adjacency.size () >= numberOfNodes)
+    {
+      return;
+    }
+  // The map of the devices to their interfaces is up to date
+  // when the map of the addresses is
+  if (g_ipAddressToNodeMap.empty ())
+    {
+      BuildIpAddressToNodeMap ();
+    }
+  for (uint32_t id = g_adjacency.size (); id < numberOfNodes; id++)
+    {
+      g_adjacency.emplace_back ();
+      GetBfsNeighbors (NodeList::GetNode (id), g_adjacency.back ());
+    }
+}
+
+template <typename T>
+const typename NixVectorRouting<T>::BfsTree_t &
+NixVectorRouting<T>::GetBfsTree (uint32_t source) const
+{
+  NS_LOG_FUNCTION (this << source);
+
+  BuildAdjacency ();
+  if (g_bfsTrees.size () < g_adjacency.size ())
+    {
+      g_bfsTrees.resize (g_adjacency.size ());
+    }
+  BfsTree_t &tree = g_bfsTrees[source];
+  if (tree.empty ())
+    {
+      NS_LOG_LOGIC ("Computing the BFS tree of node " << source);
+      ComputeBfsTree (g_adjacency, source, tree);
+    }
+  return tree;
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::PrecomputeBfsTrees (const NodeContainer &sources) const
+{
+  NS_LOG_FUNCTION (this << sources.GetN ());
+
+  CheckCacheStateAndFlush ();
+  BuildAdjacency ();
+  if (g_bfsTrees.size () < g_adjacency.size ())
+    {
+      g_bfsTrees.resize (g_adjacency.size ());
+    }
+
+  std::vector<uint32_t> missing;
+  for (NodeContainer::Iterator i = sources.Begin (); i != sources.End (); i++)
+    {
+      if (g_bfsTrees[(*i)->GetId ()].empty ())
+        {
+          missing.push_back ((*i)->GetId ());
+        }
+    }
+  // Each tree is computed once, by a single task
+  std::sort (missing.begin (), missing.end ());
+  missing.erase (std::unique (missing.begin (), missing.end ()), missing.end ());
+
+  // The calling thread runs its share of the trees while the other
+  // threads are running.
+  UintegerValue numThreads;
+  g_nixVectorRoutingNumThreads.GetValue (numThreads);
+  std::size_t numTasks = std::min<std::size_t> (numThreads.Get (), missing.size ());
+#ifndef HAVE_PTHREAD_H
+  numTasks = std::min<std::size_t> (numTasks, 1);
+#endif
+  std::vector<BfsTask> tasks;
+  for (std::size_t i = 0; i < numTasks; i++)
+    {
+      tasks.push_back (BfsTask (&g_adjacency, &missing, i, numTasks, &g_bfsTrees));
+    }
+#ifdef HAVE_PTHREAD_H
+  std::vector<Ptr<SystemThread> > threads;
+  for (std::size_t i = 1; i < numTasks; i++)
+    {
+      threads.push_back (Create<SystemThread> (MakeCallback (&BfsTask::Run, &tasks[i])));
+      threads.back ()->Start ();
+    }
+#endif
+  if (numTasks > 0)
+    {
+      tasks[0].Run ();
+    }
+#ifdef HAVE_PTHREAD_H
+  for (std::size_t i = 0; i < threads.size (); i++)
+    {
+      threads[i]->Join ();
+    }
+#endif
+  NS_LOG_LOGIC ("Computed " << missing.size () << " BFS trees using " << numTasks << " threads");
+}
+
+template <typename T>
+uint32_t
+NixVectorRouting<T>::GetNBfsTrees (void) const
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  CheckCacheStateAndFlush ();
+
+  uint32_t nTrees = 0;
+  for (std::size_t i = 0; i < g_bfsTrees.size (); i++)
+    {
+      if (!g_bfsTrees[i].empty ())
+        {
+          nTrees++;
+        }
+    }
+  return nTrees;
+}
+
 template <typename T>
 void
 NixVectorRouting<T>::FlushNixCache (void) const
@@ -206,19 +667,23 @@ NixVectorRouting<T>::GetNixVector (Ptr<Node> source, IpAddress dest, Ptr<NetDevi
     {
       // otherwise proceed as normal 
       // and build the nix vector
-      std::vector< Ptr<Node> > parentVector;
+      BfsTree_t parentVector;
+      bool found;
 
-      if (BFS (NodeList::GetNNodes (), source, destNode, parentVector, oif))
+      if (oif)
         {
-          if (BuildNixVector (parentVector, source->GetId (), destNode->GetId (), nixVector))
-            {
-              return nixVector;
-            }
-          else
-            {
-              NS_LOG_ERROR ("No routing path exists");
-              return 0;
-            }
+          found = BFS (NodeList::GetNNodes (), source, destNode, parentVector, oif)
+            && BuildNixVector (parentVector, source->GetId (), destNode->GetId (), nixVector);
+        }
+      else
+        {
+          // The BFS tree of the source is shared by all the destinations
+          found = BuildNixVector (GetBfsTree (source->GetId ()), source->GetId (), destNode->GetId (), nixVector);
+        }
+
+      if (found)
+        {
+          return nixVector;
         }
       else
         {
@@ -271,7 +736,7 @@ NixVectorRouting<T>::GetIpRouteInCache (IpAddress address)
 
 template <typename T>
 bool
-NixVectorRouting<T>::BuildNixVector (const std::vector< Ptr<Node> > & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector) const
+NixVectorRouting<T>::BuildNixVector (const BfsTree_t & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector) const
 {
   NS_LOG_FUNCTION (this << parentVector << source << dest << nixVector);
 
@@ -280,12 +745,12 @@ NixVectorRouting<T>::BuildNixVector (const std::vector< Ptr<Node> > & parentVect
       return true;
     }
 
-  if (parentVector.at (dest) == 0)
+  if (GetParent (parentVector, dest) == NO_PARENT)
     {
       return false;
     }
 
-  Ptr<Node> parentNode = parentVector.at (dest);
+  Ptr<Node> parentNode = NodeList::GetNode (parentVector.at (dest));
 
   uint32_t numberOfDevices = parentNode->GetNDevices ();
   uint32_t destId = 0;
@@ -339,7 +804,7 @@ NixVectorRouting<T>::BuildNixVector (const std::vector< Ptr<Node> > & parentVect
 
   // recurse through T vector, grabbing the path
   // and building the nix vector
-  BuildNixVector (parentVector, source, (parentVector.at (dest))->GetId (), nixVector);
+  BuildNixVector (parentVector, source, parentVector.at (dest), nixVector);
   return true;
 }
 
@@ -1018,43 +1483,44 @@ template <typename T>
 void
 NixVectorRouting<T>::NotifyInterfaceUp (uint32_t i)
 {
-  g_isCacheDirty = true;
+  AddTopologyChange (i, false);
 }
 template <typename T>
 void
 NixVectorRouting<T>::NotifyInterfaceDown (uint32_t i)
 {
-  g_isCacheDirty = true;
+  AddTopologyChange (i, true);
 }
 template <typename T>
 void
 NixVectorRouting<T>::NotifyAddAddress (uint32_t interface, IpInterfaceAddress address)
 {
-  g_isCacheDirty = true;
+  AddTopologyChange (interface, false);
 }
 template <typename T>
 void
 NixVectorRouting<T>::NotifyRemoveAddress (uint32_t interface, IpInterfaceAddress address)
 {
-  g_isCacheDirty = true;
+  AddTopologyChange (interface, false);
 }
 template <typename T>
 void
 NixVectorRouting<T>::NotifyAddRoute (IpAddress dst, Ipv6Prefix mask, IpAddress nextHop, uint32_t interface, IpAddress prefixToUse)
 {
-  g_isCacheDirty = true;
+  // The nix-vectors do not depend on the routes, and the addresses
+  // which come with them are notified separately
 }
 template <typename T>
 void
 NixVectorRouting<T>::NotifyRemoveRoute (IpAddress dst, Ipv6Prefix mask, IpAddress nextHop, uint32_t interface, IpAddress prefixToUse)
 {
-  g_isCacheDirty = true;
+  // The nix-vectors do not depend on the routes
 }
 
 template <typename T>
 bool
 NixVectorRouting<T>::BFS (uint32_t numberOfNodes, Ptr<Node> source,
-                           Ptr<Node> dest, std::vector< Ptr<Node> > & parentVector,
+                           Ptr<Node> dest, BfsTree_t & parentVector,
                            Ptr<NetDevice> oif) const
 {
   NS_LOG_FUNCTION (this << numberOfNodes << source << dest << parentVector << oif);
@@ -1063,11 +1529,11 @@ NixVectorRouting<T>::BFS (uint32_t numberOfNodes, Ptr<Node> source,
   std::queue< Ptr<Node> > greyNodeList;  // discovered nodes with unexplored children
 
   // reset the parent vector
-  parentVector.assign (numberOfNodes, 0); // initialize to 0
+  parentVector.assign (numberOfNodes, NO_PARENT);
 
   // Add the source node to the queue, set its parent to itself
   greyNodeList.push (source);
-  parentVector.at (source->GetId ()) = source;
+  parentVector.at (source->GetId ()) = source->GetId ();
 
   // BFS loop
   while (greyNodeList.size () != 0)
@@ -1128,11 +1594,11 @@ NixVectorRouting<T>::BFS (uint32_t numberOfNodes, Ptr<Node> source,
 
               // check to see if this node has been pushed before
               // by checking to see if it has a parent
-              // if it doesn't (null or 0), then set its parent and
+              // if it doesn't (NO_PARENT), then set its parent and
               // push to the queue
-              if (parentVector.at (remoteNode->GetId ()) == 0)
+              if (parentVector.at (remoteNode->GetId ()) == NO_PARENT)
                 {
-                  parentVector.at (remoteNode->GetId ()) = currNode;
+                  parentVector.at (remoteNode->GetId ()) = currNode->GetId ();
                   greyNodeList.push (remoteNode);
                 }
             }
@@ -1190,11 +1656,11 @@ NixVectorRouting<T>::BFS (uint32_t numberOfNodes, Ptr<Node> source,
 
                   // check to see if this node has been pushed before
                   // by checking to see if it has a parent
-                  // if it doesn't (null or 0), then set its parent and
+                  // if it doesn't (NO_PARENT), then set its parent and
                   // push to the queue
-                  if (parentVector.at (remoteNode->GetId ()) == 0)
+                  if (parentVector.at (remoteNode->GetId ()) == NO_PARENT)
                     {
-                      parentVector.at (remoteNode->GetId ()) = currNode;
+                      parentVector.at (remoteNode->GetId ()) = currNode->GetId ();
                       greyNodeList.push (remoteNode);
                     }
                 }
@@ -1351,9 +1817,17 @@ NixVectorRouting<T>::CheckCacheStateAndFlush (void) const
       FlushGlobalNixRoutingCache ();
       g_isCacheDirty = false;
     }
+  else if (!g_topologyChanges.empty ())
+    {
+      InvalidateBfsTrees ();
+    }
 }
 
 /* Public template function declarations */
+template void NixVectorRouting<Ipv4RoutingProtocol>::PrecomputeBfsTrees (const NodeContainer &sources) const;
+template void NixVectorRouting<Ipv6RoutingProtocol>::PrecomputeBfsTrees (const NodeContainer &sources) const;
+template uint32_t NixVectorRouting<Ipv4RoutingProtocol>::GetNBfsTrees (void) const;
+template uint32_t NixVectorRouting<Ipv6RoutingProtocol>::GetNBfsTrees (void) const;
 template void NixVectorRouting<Ipv4RoutingProtocol>::SetNode (Ptr<Node> node);
 template void NixVectorRouting<Ipv6RoutingProtocol>::SetNode (Ptr<Node> node);
 template void NixVectorRouting<Ipv4RoutingProtocol>::FlushGlobalNixRoutingCache (void) const;
@@ -44,6 +44,7 @@
 
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 namespace ns3 {
 
@@ -113,7 +114,7 @@ public:
   /**
    * @brief Called when run-time link topology change occurs
    * which iterates through the node list and flushes any
-   * nix vector caches
+   * nix vector caches, and discards all the BFS trees
    *
    * \internal
    * \c const is used here due to need to potentially flush the cache
@@ -134,9 +135,88 @@ public:
    */
   void PrintRoutingPath (Ptr<Node> source, IpAddress dest, Ptr<OutputStreamWrapper> stream, Time::Unit unit) const;
 
+  /**
+   * @brief Compute the BFS trees of some sources in advance
+   *
+   * The BFS tree of a source is computed on demand, the first time a
+   * nix-vector from this source is built, and is then shared by the
+   * nix-vectors to every destination.  This method computes the trees
+   * of the given sources at once, typically before Simulator::Run, using
+   * the number of threads given by the NixVectorRoutingNumThreads global
+   * value.
+   *
+   * \param sources The source nodes
+   */
+  void PrecomputeBfsTrees (const NodeContainer &sources) const;
+
+  /**
+   * @brief Get the number of BFS trees stored
+   *
+   * The trees are shared by the nix-vector routing protocols of all the
+   * nodes.  A topology change only discards the trees which it may change.
+   *
+   * \returns The number of BFS trees stored
+   */
+  uint32_t GetNBfsTrees (void) const;
+
 
 private:
 
+  /// The parent of each node in a BFS tree, by node ID
+  typedef std::vector<uint32_t> BfsTree_t;
+  /// The neighbors of each node, in the order of the BFS, by node ID
+  typedef std::vector<std::vector<uint32_t> > Adjacency_t;
+
+  /// A change of an interface notified to a nix-vector routing protocol
+  struct TopologyChange
+  {
+    uint32_t node;      //!< The ID of the node
+    uint32_t interface; //!< The index of the interface
+    bool removal;       //!< True if links of the interface can only have been removed
+  };
+
+  /**
+   * Flushes the nix-vector and IpRoute caches of all the nodes, and
+   * the IP address to node map
+   */
+  void FlushNodeCaches (void) const;
+
+  /**
+   * Record a change of an interface of this node, for the
+   * selective invalidation of the BFS trees
+   * \param interface The index of the interface
+   * \param removal True if links of the interface can only have been removed
+   */
+  void AddTopologyChange (uint32_t interface, bool removal);
+
+  /**
+   * Discards the BFS trees which may be changed by the recorded
+   * topology changes, updates the neighbors of the nodes involved
+   * and flushes the caches of the nodes
+   */
+  void InvalidateBfsTrees (void) const;
+
+  /**
+   * Appends the neighbors of a node to the neighbor list, in the order
+   * in which the BFS explores them
+   * \param [in] node The node
+   * \param [out] neighbors The IDs of the neighbors
+   */
+  void GetBfsNeighbors (Ptr<Node> node, std::vector<uint32_t> &neighbors) const;
+
+  /**
+   * Adds the neighbors of the nodes created since the last call
+   * to the adjacency shared by the BFS trees
+   */
+  void BuildAdjacency (void) const;
+
+  /**
+   * Returns the BFS tree of a source, computing it if needed
+   * \param source The ID of the source node
+   * \returns The BFS tree
+   */
+  const BfsTree_t & GetBfsTree (uint32_t source) const;
+
   /**
    * Flushes the cache which stores nix-vector based on
    * destination IP
@@ -216,7 +296,7 @@ private:
    * \param [out] nixVector the NixVector to be used for routing
    * \returns true on success, false otherwise.
    */
-  bool BuildNixVector (const std::vector< Ptr<Node> > & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector) const;
+  bool BuildNixVector (const BfsTree_t & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector) const;
 
   /**
    * Simply iterates through the nodes net-devices and determines
@@ -257,7 +337,7 @@ private:
   bool BFS (uint32_t numberOfNodes,
             Ptr<Node> source,
             Ptr<Node> dest,
-            std::vector< Ptr<Node> > & parentVector,
+            BfsTree_t & parentVector,
             Ptr<NetDevice> oif) const;
 
   /**
@@ -448,6 +528,18 @@ private:
    */
   static bool g_isCacheDirty;
 
+  /**
+   * The BFS trees of the sources, by node ID, shared by the protocols
+   * of all the nodes.  A tree which is not computed is empty.
+   */
+  static std::vector<BfsTree_t> g_bfsTrees;
+
+  /** The neighbors of the nodes, from which the BFS trees are computed */
+  static Adjacency_t g_adjacency;
+
+  /** The topology changes since the BFS trees were last invalidated */
+  static std::vector<TopologyChange> g_topologyChanges;
+
   /** Cache stores nix-vectors based on destination ip */
   mutable NixMap_t m_nixCache;
 
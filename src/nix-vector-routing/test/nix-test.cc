@@ -23,6 +23,8 @@
 #include "ns3/udp-socket-factory.h"
 #include "ns3/simulator.h"
 #include "ns3/socket.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
 
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
@@ -34,6 +36,7 @@
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/simple-net-device-helper.h"
 #include "ns3/nix-vector-helper.h"
+#include "ns3/nix-vector-routing.h"
 
 using namespace ns3;
 /**
@@ -362,6 +365,141 @@ NixVectorRoutingTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup nix-vector-routing-test
+ * \ingroup tests
+ *
+ * The topology is a grid of point-to-point links:
+ * \verbatim
+    n0 -- n1 -- n2 -- n3
+    |     |     |     |
+    n4 -- n5 -- n6 -- n7
+    |     |     |     |
+    n8 -- n9 -- n10-- n11
+    |     |     |     |
+    n12-- n13-- n14-- n15
+   \endverbatim
+ *
+ * Following are the tests in this test case:
+ * - Test that the BFS trees of all the nodes are precomputed by two threads.
+ * - Test that the routing paths between all the nodes are the same with
+ *   the precomputed trees and after a global flush.
+ * (Set down, then up, the interfaces of each link in turn.)
+ * - Test that the BFS trees which are kept after each change give the
+ *   same routing paths between all the nodes as after a global flush.
+ * - Test that some trees are kept when a link is set down.
+ *
+ * \brief IPv4 Nix-Vector Routing BFS Tree Test
+ */
+class NixVectorRoutingBfsTreeTest : public TestCase
+{
+public:
+  NixVectorRoutingBfsTreeTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Print the routing paths between all the nodes.
+   * \param nodes The nodes.
+   * \returns The routing paths.
+   */
+  std::string PrintRoutingPaths (NodeContainer nodes);
+};
+
+NixVectorRoutingBfsTreeTest::NixVectorRoutingBfsTreeTest ()
+  : TestCase ("BFS trees shared, precomputed and selectively invalidated")
+{
+}
+
+std::string
+NixVectorRoutingBfsTreeTest::PrintRoutingPaths (NodeContainer nodes)
+{
+  std::ostringstream paths;
+  Ptr<OutputStreamWrapper> stream = Create<OutputStreamWrapper> (&paths);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Ipv4NixVectorRouting> routing = nodes.Get (i)->GetObject<Ipv4NixVectorRouting> ();
+      for (uint32_t j = 0; j < nodes.GetN (); j++)
+        {
+          Ipv4Address dest = nodes.Get (j)->GetObject<Ipv4> ()->GetAddress (1, 0).GetLocal ();
+          routing->PrintRoutingPath (nodes.Get (i), dest, stream, Time::S);
+        }
+    }
+  return paths.str ();
+}
+
+void
+NixVectorRoutingBfsTreeTest::DoRun (void)
+{
+  const uint32_t side = 4;
+  NodeContainer nodes;
+  nodes.Create (side * side);
+
+  Ipv4NixVectorHelper nixRouting;
+  InternetStackHelper stack;
+  stack.SetRoutingHelper (nixRouting);
+  stack.SetIpv6StackInstall (false);
+  stack.Install (nodes);
+
+  SimpleNetDeviceHelper devHelper;
+  devHelper.SetNetDevicePointToPointMode (true);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.255.255.0");
+  std::vector<NetDeviceContainer> links;
+  for (uint32_t row = 0; row < side; row++)
+    {
+      for (uint32_t col = 0; col < side; col++)
+        {
+          uint32_t id = row * side + col;
+          if (col + 1 < side)
+            {
+              links.push_back (devHelper.Install (NodeContainer (nodes.Get (id), nodes.Get (id + 1))));
+            }
+          if (row + 1 < side)
+            {
+              links.push_back (devHelper.Install (NodeContainer (nodes.Get (id), nodes.Get (id + side))));
+            }
+        }
+    }
+  for (std::size_t i = 0; i < links.size (); i++)
+    {
+      address.Assign (links[i]);
+      address.NewNetwork ();
+    }
+
+  GlobalValue::Bind ("NixVectorRoutingNumThreads", UintegerValue (2));
+  nixRouting.PrecomputeBfsTrees (nodes);
+  GlobalValue::Bind ("NixVectorRoutingNumThreads", UintegerValue (1));
+  Ptr<Ipv4NixVectorRouting> routing = nodes.Get (0)->GetObject<Ipv4NixVectorRouting> ();
+  NS_TEST_EXPECT_MSG_EQ (routing->GetNBfsTrees (), nodes.GetN (), "The trees of all the nodes should be precomputed.");
+
+  std::string precomputed = PrintRoutingPaths (nodes);
+  routing->FlushGlobalNixRoutingCache ();
+  NS_TEST_EXPECT_MSG_EQ (PrintRoutingPaths (nodes), precomputed, "The precomputed trees should give the same paths.");
+
+  uint32_t keptAfterDown = 0;
+  for (std::size_t i = 0; i < links.size (); i++)
+    {
+      Ptr<Ipv4> ipv4 = links[i].Get (0)->GetNode ()->GetObject<Ipv4> ();
+      int32_t ifIndex = ipv4->GetInterfaceForDevice (links[i].Get (0));
+
+      ipv4->SetDown (ifIndex);
+      keptAfterDown += routing->GetNBfsTrees ();
+      std::string selective = PrintRoutingPaths (nodes);
+      routing->FlushGlobalNixRoutingCache ();
+      NS_TEST_EXPECT_MSG_EQ (PrintRoutingPaths (nodes), selective, "The kept trees should give the same paths after link " << i << " is set down.");
+
+      ipv4->SetUp (ifIndex);
+      selective = PrintRoutingPaths (nodes);
+      routing->FlushGlobalNixRoutingCache ();
+      NS_TEST_EXPECT_MSG_EQ (PrintRoutingPaths (nodes), selective, "The kept trees should give the same paths after link " << i << " is set up.");
+    }
+  NS_TEST_EXPECT_MSG_GT (keptAfterDown, 0, "Some trees should be kept when a link is set down.");
+  NS_TEST_EXPECT_MSG_LT (keptAfterDown, links.size () * nodes.GetN (), "Some trees should be discarded when a link is set down.");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup nix-vector-routing-test
  * \ingroup tests
@@ -374,6 +512,7 @@ public:
   NixVectorRoutingTestSuite () : TestSuite ("nix-vector-routing", UNIT)
   {
     AddTestCase (new NixVectorRoutingTest (), TestCase::QUICK);
+    AddTestCase (new NixVectorRoutingBfsTreeTest (), TestCase::QUICK);
   }
 };
 
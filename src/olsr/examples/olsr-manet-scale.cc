@@ -0,0 +1,161 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+// This program measures the CPU time taken to simulate a large OLSR MANET,
+// with and without the incremental routing table computation.
+//
+// The --nodes nodes walk randomly in a square area, sized so that a node
+// has about --degree nodes within the range of 250 m of its 802.11b ad hoc
+// interface.  The nodes only exchange OLSR messages.  After a warm-up of
+// 10 s, during which the routing tables converge, the program reports the
+// CPU time per simulated second, the number of routing table computations
+// and of events processed, and the average number of routes of a node.
+// The routing tables do not depend on --incremental (the
+// IncrementalRouting attribute of ns3::olsr::RoutingProtocol).
+//
+// Example:
+//   ./ns3 run "olsr-manet-scale --nodes=200 --incremental=0"
+//   ./ns3 run "olsr-manet-scale --nodes=200 --incremental=1"
+
+#include <cmath>
+#include <iostream>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/olsr-helper.h"
+#include "ns3/olsr-routing-protocol.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("OlsrManetScale");
+
+/// The number of routing table computations
+static uint64_t g_computations = 0;
+
+/**
+ * Count the routing table computations.
+ * \param size The size of the routing table.
+ */
+static void
+RoutingTableChanged (uint32_t size)
+{
+  g_computations++;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nodes = 100;
+  double degree = 10;
+  double time = 30;
+  bool incremental = true;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("nodes", "The number of nodes", nodes);
+  cmd.AddValue ("degree", "The average number of nodes in range of a node", degree);
+  cmd.AddValue ("time", "The duration of the simulation after the warm-up, in seconds", time);
+  cmd.AddValue ("incremental", "Update the routing tables incrementally", incremental);
+  cmd.Parse (argc, argv);
+
+  if (nodes < 2 || degree <= 0 || time <= 0)
+    {
+      NS_FATAL_ERROR ("The number of nodes must be at least 2, and the degree and duration positive");
+    }
+
+  const double range = 250;
+  const double warmUp = 10;
+  double side = std::sqrt (nodes * M_PI * range * range / degree);
+
+  NodeContainer c;
+  c.Create (nodes);
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_STANDARD_80211b);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("DsssRate11Mbps"),
+                                "ControlMode", StringValue ("DsssRate11Mbps"));
+  YansWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss ("ns3::RangePropagationLossModel",
+                                  "MaxRange", DoubleValue (range));
+  YansWifiPhyHelper wifiPhy;
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  WifiMacHelper wifiMac;
+  wifiMac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, c);
+
+  std::ostringstream bound;
+  bound << "0|" << side << "|0|" << side;
+  std::ostringstream uniform;
+  uniform << "ns3::UniformRandomVariable[Min=0.0|Max=" << side << "]";
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::RandomRectanglePositionAllocator",
+                                 "X", StringValue (uniform.str ()),
+                                 "Y", StringValue (uniform.str ()));
+  mobility.SetMobilityModel ("ns3::RandomWalk2dMobilityModel",
+                             "Bounds", StringValue (bound.str ()),
+                             "Speed", StringValue ("ns3::UniformRandomVariable[Min=1.0|Max=10.0]"),
+                             "Time", StringValue ("5s"),
+                             "Mode", StringValue ("Time"));
+  mobility.Install (c);
+
+  OlsrHelper olsr;
+  olsr.Set ("IncrementalRouting", BooleanValue (incremental));
+  InternetStackHelper internet;
+  internet.SetRoutingHelper (olsr);
+  internet.Install (c);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.0.0.0", "255.255.0.0");
+  ipv4.Assign (devices);
+
+  Config::ConnectWithoutContext ("/NodeList/*/$ns3::olsr::RoutingProtocol/RoutingTableChanged",
+                                 MakeCallback (&RoutingTableChanged));
+
+  std::cout << nodes << " nodes in a " << side << " m square, incremental routing "
+            << (incremental ? "on" : "off") << std::endl;
+  Simulator::Stop (Seconds (warmUp));
+  Simulator::Run ();
+
+  g_computations = 0;
+  uint64_t events = Simulator::GetEventCount ();
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Stop (Seconds (time));
+  Simulator::Run ();
+  int64_t ms = clock.End ();
+  int64_t cpu = clock.GetElapsedUser () + clock.GetElapsedSystem ();
+
+  uint64_t routes = 0;
+  for (uint32_t i = 0; i < nodes; i++)
+    {
+      Ptr<olsr::RoutingProtocol> protocol =
+        DynamicCast<olsr::RoutingProtocol> (c.Get (i)->GetObject<Ipv4> ()->GetRoutingProtocol ());
+      routes += protocol->GetRoutingTableEntries ().size ();
+    }
+
+  std::cout << "Routing table computations: " << g_computations << std::endl;
+  std::cout << "Routes per node:            " << double (routes) / nodes << std::endl;
+  std::cout << "Events processed:           " << Simulator::GetEventCount () - events << std::endl;
+  std::cout << "Simulated in " << ms << " ms, " << cpu << " ms of CPU time" << std::endl;
+  std::cout << "CPU time per simulated second: " << cpu / time << " ms" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
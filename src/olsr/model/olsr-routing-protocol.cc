@@ -33,6 +33,8 @@
 
 
 #include <iomanip>
+#include <limits>
+#include <algorithm>
 #include "olsr-routing-protocol.h"
 #include "ns3/socket-factory.h"
 #include "ns3/udp-socket-factory.h"
@@ -183,6 +185,13 @@ RoutingProtocol::GetTypeId (void)
                                     OLSR_WILL_DEFAULT, "default",
                                     OLSR_WILL_HIGH, "high",
                                     OLSR_WILL_ALWAYS, "always"))
+    .AddAttribute ("IncrementalRouting",
+                   "Update the routing table from the changes of the topology set "
+                   "while the routes to the 1-hop and 2-hop neighbors do not change, "
+                   "instead of computing it from scratch.  The routes are the same.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&RoutingProtocol::m_incrementalRouting),
+                   MakeBooleanChecker ())
     .AddTraceSource ("Rx", "Receive OLSR packet.",
                      MakeTraceSourceAccessor (&RoutingProtocol::m_rxPacketTrace),
                      "ns3::olsr::RoutingProtocol::PacketTxRxTracedCallback")
@@ -199,6 +208,7 @@ RoutingProtocol::GetTypeId (void)
 
 RoutingProtocol::RoutingProtocol (void)
   : m_routingTableAssociation (0),
+  m_incrementalRouting (true),
   m_ipv4 (0),
   m_helloTimer (Timer::CANCEL_ON_DESTROY),
   m_tcTimer (Timer::CANCEL_ON_DESTROY),
@@ -263,6 +273,9 @@ void RoutingProtocol::DoDispose (void)
     }
   m_sendSockets.clear ();
   m_table.clear ();
+  m_neighborhoodRoutes.clear ();
+  m_ifaceAssocRoutes.clear ();
+  m_expiries.Clear ();
 
   Ipv4RoutingProtocol::DoDispose ();
 }
@@ -659,6 +672,36 @@ CoverTwoHopNeighbors (Ipv4Address neighborMainAddr, TwoHopNeighborSet & N2)
         }
     }
 }
+
+///
+/// \brief Checks if two routing tables hold the same routes.
+/// This is a helper function used by RoutingTableComputation.
+///
+/// \param a The first routing table.
+/// \param b The second routing table.
+/// \return true if the routing tables hold the same routes.
+///
+bool
+SameRoutes (const std::map<Ipv4Address, RoutingTableEntry> &a,
+            const std::map<Ipv4Address, RoutingTableEntry> &b)
+{
+  if (a.size () != b.size ())
+    {
+      return false;
+    }
+  for (std::map<Ipv4Address, RoutingTableEntry>::const_iterator i = a.begin (), j = b.begin ();
+       i != a.end (); i++, j++)
+    {
+      if (i->first != j->first
+          || i->second.nextAddr != j->second.nextAddr
+          || i->second.interface != j->second.interface
+          || i->second.distance != j->second.distance)
+        {
+          return false;
+        }
+    }
+  return true;
+}
 }  // unnamed namespace
 
 void
@@ -979,7 +1022,57 @@ RoutingProtocol::RoutingTableComputation  (void)
                                                << ": RoutingTableComputation begin...");
 
   // 1. All the entries from the routing table are removed.
-  Clear ();
+  // (The previous entries are set aside for the incremental update.)
+  std::map<Ipv4Address, RoutingTableEntry> previous;
+  m_table.swap (previous);
+
+  AddNeighborhoodRoutes ();
+
+  if (m_incrementalRouting && SameRoutes (m_table, m_neighborhoodRoutes))
+    {
+      // The routes to the neighbors did not change, so that a change of
+      // the topology tuples of a node does not affect the routes of at most
+      // the distance of this node: the longer routes are recomputed.
+      m_table.swap (previous);
+      for (std::vector<Ipv4Address>::const_iterator it = m_ifaceAssocRoutes.begin ();
+           it != m_ifaceAssocRoutes.end (); it++)
+        {
+          m_table.erase (*it);
+        }
+      uint32_t h = std::numeric_limits<uint32_t>::max ();
+      const std::set<Ipv4Address> &changes = m_state.GetTopologyChanges ();
+      for (std::set<Ipv4Address>::const_iterator it = changes.begin ();
+           it != changes.end (); it++)
+        {
+          std::map<Ipv4Address, RoutingTableEntry>::const_iterator entry = m_table.find (*it);
+          if (entry != m_table.end ())
+            {
+              h = std::min (h, entry->second.distance);
+            }
+        }
+      if (h != std::numeric_limits<uint32_t>::max ())
+        {
+          UpdateTopologyRoutes (std::max (h, 2u));
+        }
+    }
+  else
+    {
+      m_neighborhoodRoutes = m_table;
+      AddTopologyRoutes ();
+    }
+  m_state.ClearTopologyChanges ();
+
+  AddIfaceAssocRoutes ();
+  ComputeHnaRoutes ();
+
+  NS_LOG_DEBUG ("Node " << m_mainAddress << ": RoutingTableComputation end.");
+  m_routingTableChanged (GetSize ());
+}
+
+void
+RoutingProtocol::AddNeighborhoodRoutes (void)
+{
+  NS_LOG_FUNCTION (this);
 
   // 2. The new routing entries are added starting with the
   // symmetric neighbors (h=1) as the destination nodes.
@@ -1122,6 +1215,12 @@ RoutingProtocol::RoutingTableComputation  (void)
                         << " not found in the routing table)");
         }
     }
+}
+
+void
+RoutingProtocol::AddTopologyRoutes (void)
+{
+  NS_LOG_FUNCTION (this);
 
   for (uint32_t h = 2;; h++)
     {
@@ -1177,12 +1276,91 @@ RoutingProtocol::RoutingTableComputation  (void)
           break;
         }
     }
+}
+
+void
+RoutingProtocol::UpdateTopologyRoutes (uint32_t h)
+{
+  NS_LOG_FUNCTION (this << h);
+
+  // The routes of more than h hops are removed
+  std::vector<Ipv4Address> level;
+  for (std::map<Ipv4Address, RoutingTableEntry>::iterator it = m_table.begin ();
+       it != m_table.end (); )
+    {
+      if (it->second.distance > h)
+        {
+          m_table.erase (it++);
+          continue;
+        }
+      if (it->second.distance == h)
+        {
+          level.push_back (it->first);
+        }
+      it++;
+    }
+
+  // 3.1. As in AddTopologyRoutes, a destination without a route entry is
+  // reached through the first topology tuple, in the order of the topology
+  // set, whose T_last_addr has a route entry of h hops.  The tuples are
+  // found from the nodes at h hops instead of scanning the topology set.
+  const TopologySet &topology = m_state.GetTopologySet ();
+  while (!level.empty ())
+    {
+      std::map<Ipv4Address, uint32_t> first;
+      for (std::vector<Ipv4Address>::const_iterator it = level.begin ();
+           it != level.end (); it++)
+        {
+          const std::vector<uint32_t> *positions = m_state.FindTopologyTuples (*it);
+          if (positions == NULL)
+            {
+              continue;
+            }
+          for (std::vector<uint32_t>::const_iterator position = positions->begin ();
+               position != positions->end (); position++)
+            {
+              const Ipv4Address &destAddr = topology[*position].destAddr;
+              if (m_table.find (destAddr) != m_table.end ())
+                {
+                  continue;
+                }
+              std::pair<std::map<Ipv4Address, uint32_t>::iterator, bool> inserted =
+                first.insert (std::make_pair (destAddr, *position));
+              if (!inserted.second && *position < inserted.first->second)
+                {
+                  inserted.first->second = *position;
+                }
+            }
+        }
+
+      level.clear ();
+      for (std::map<Ipv4Address, uint32_t>::const_iterator it = first.begin ();
+           it != first.end (); it++)
+        {
+          const TopologyTuple &topology_tuple = topology[it->second];
+          RoutingTableEntry lastAddrEntry;
+          Lookup (topology_tuple.lastAddr, lastAddrEntry);
+          AddEntry (topology_tuple.destAddr,
+                    lastAddrEntry.nextAddr,
+                    lastAddrEntry.interface,
+                    h + 1);
+          level.push_back (topology_tuple.destAddr);
+        }
+      h++;
+    }
+}
+
+void
+RoutingProtocol::AddIfaceAssocRoutes (void)
+{
+  NS_LOG_FUNCTION (this);
 
   // 4. For each entry in the multiple interface association base
   // where there exists a routing entry such that:
   // R_dest_addr == I_main_addr (of the multiple interface association entry)
   // AND there is no routing entry such that:
   // R_dest_addr == I_iface_addr
+  m_ifaceAssocRoutes.clear ();
   const IfaceAssocSet &ifaceAssocSet = m_state.GetIfaceAssocSet ();
   for (IfaceAssocSet::const_iterator it = ifaceAssocSet.begin ();
        it != ifaceAssocSet.end (); it++)
@@ -1203,8 +1381,15 @@ RoutingProtocol::RoutingTableComputation  (void)
                     entry1.nextAddr,
                     entry1.interface,
                     entry1.distance);
+          m_ifaceAssocRoutes.push_back (tuple.ifaceAddr);
         }
     }
+}
+
+void
+RoutingProtocol::ComputeHnaRoutes (void)
+{
+  NS_LOG_FUNCTION (this);
 
   // 5. For each tuple in the association set,
   //    If there is no entry in the routing table with:
@@ -1283,9 +1468,6 @@ RoutingProtocol::RoutingTableComputation  (void)
 
         }
     }
-
-  NS_LOG_DEBUG ("Node " << m_mainAddress << ": RoutingTableComputation end.");
-  m_routingTableChanged (GetSize ());
 }
 
 
@@ -1410,11 +1592,11 @@ RoutingProtocol::ProcessTc (const olsr::MessageHeader &msg,
           AddTopologyTuple (topologyTuple);
 
           // Schedules topology tuple deletion
-          m_events.Track (Simulator::Schedule (DELAY (topologyTuple.expirationTime),
-                                               &RoutingProtocol::TopologyTupleTimerExpire,
-                                               this,
-                                               topologyTuple.destAddr,
-                                               topologyTuple.lastAddr));
+          m_expiries.Schedule (DELAY (topologyTuple.expirationTime),
+                               &RoutingProtocol::TopologyTupleTimerExpire,
+                               this,
+                               topologyTuple.destAddr,
+                               topologyTuple.lastAddr);
         }
     }
 
@@ -1479,7 +1661,7 @@ RoutingProtocol::ProcessMid (const olsr::MessageHeader &msg,
           AddIfaceAssocTuple (tuple);
           NS_LOG_LOGIC ("New IfaceAssoc added: " << tuple);
           // Schedules iface association tuple deletion
-          Simulator::Schedule (DELAY (tuple.time),
+          m_expiries.Schedule (DELAY (tuple.time),
                                &RoutingProtocol::IfaceAssocTupleTimerExpire, this, tuple.ifaceAddr);
         }
     }
@@ -1554,7 +1736,7 @@ RoutingProtocol::ProcessHna (const olsr::MessageHeader &msg,
           AddAssociationTuple (assocTuple);
 
           //Schedule Association Tuple deletion
-          Simulator::Schedule (DELAY (assocTuple.expirationTime),
+          m_expiries.Schedule (DELAY (assocTuple.expirationTime),
                                &RoutingProtocol::AssociationTupleTimerExpire, this,
                                assocTuple.gatewayAddr,assocTuple.networkAddr,assocTuple.netmask);
         }
@@ -1624,7 +1806,7 @@ RoutingProtocol::ForwardDefault (olsr::MessageHeader olsrMessage,
       newDup.ifaceList.push_back (localIface);
       AddDuplicateTuple (newDup);
       // Schedule dup tuple deletion
-      Simulator::Schedule (OLSR_DUP_HOLD_TIME,
+      m_expiries.Schedule (OLSR_DUP_HOLD_TIME,
                            &RoutingProtocol::DupTupleTimerExpire, this,
                            newDup.address, newDup.sequenceNumber);
     }
@@ -2135,9 +2317,9 @@ RoutingProtocol::LinkSensing (const olsr::MessageHeader &msg,
   if (created)
     {
       LinkTupleAdded (*link_tuple, hello.willingness);
-      m_events.Track (Simulator::Schedule (DELAY (std::min (link_tuple->time, link_tuple->symTime)),
-                                           &RoutingProtocol::LinkTupleTimerExpire, this,
-                                           link_tuple->neighborIfaceAddr));
+      m_expiries.Schedule (DELAY (std::min (link_tuple->time, link_tuple->symTime)),
+                           &RoutingProtocol::LinkTupleTimerExpire, this,
+                           link_tuple->neighborIfaceAddr);
     }
   NS_LOG_DEBUG ("@" << now.As (Time::S) << ": Olsr node " << m_mainAddress
                     << ": LinkSensing END");
@@ -2229,10 +2411,10 @@ RoutingProtocol::PopulateTwoHopNeighborSet (const olsr::MessageHeader &msg,
                       new_nb2hop_tuple.expirationTime = now + msg.GetVTime ();
                       AddTwoHopNeighborTuple (new_nb2hop_tuple);
                       // Schedules nb2hop tuple deletion
-                      m_events.Track (Simulator::Schedule (DELAY (new_nb2hop_tuple.expirationTime),
-                                                           &RoutingProtocol::Nb2hopTupleTimerExpire, this,
-                                                           new_nb2hop_tuple.neighborMainAddr,
-                                                           new_nb2hop_tuple.twoHopNeighborAddr));
+                      m_expiries.Schedule (DELAY (new_nb2hop_tuple.expirationTime),
+                                           &RoutingProtocol::Nb2hopTupleTimerExpire, this,
+                                           new_nb2hop_tuple.neighborMainAddr,
+                                           new_nb2hop_tuple.twoHopNeighborAddr);
                     }
                   else
                     {
@@ -2300,10 +2482,9 @@ RoutingProtocol::PopulateMprSelectorSet (const olsr::MessageHeader &msg,
                       AddMprSelectorTuple (mprsel_tuple);
 
                       // Schedules mpr selector tuple deletion
-                      m_events.Track (Simulator::Schedule
-                                        (DELAY (mprsel_tuple.expirationTime),
-                                        &RoutingProtocol::MprSelTupleTimerExpire, this,
-                                        mprsel_tuple.mainAddr));
+                      m_expiries.Schedule (DELAY (mprsel_tuple.expirationTime),
+                                           &RoutingProtocol::MprSelTupleTimerExpire, this,
+                                           mprsel_tuple.mainAddr);
                     }
                   else
                     {
@@ -2691,9 +2872,9 @@ RoutingProtocol::DupTupleTimerExpire (Ipv4Address address, uint16_t sequenceNumb
     }
   else
     {
-      m_events.Track (Simulator::Schedule (DELAY (tuple->expirationTime),
-                                           &RoutingProtocol::DupTupleTimerExpire, this,
-                                           address, sequenceNumber));
+      m_expiries.Schedule (DELAY (tuple->expirationTime),
+                           &RoutingProtocol::DupTupleTimerExpire, this,
+                           address, sequenceNumber);
     }
 }
 
@@ -2723,15 +2904,15 @@ RoutingProtocol::LinkTupleTimerExpire (Ipv4Address neighborIfaceAddr)
           NeighborLoss (*tuple);
         }
 
-      m_events.Track (Simulator::Schedule (DELAY (tuple->time),
-                                           &RoutingProtocol::LinkTupleTimerExpire, this,
-                                           neighborIfaceAddr));
+      m_expiries.Schedule (DELAY (tuple->time),
+                           &RoutingProtocol::LinkTupleTimerExpire, this,
+                           neighborIfaceAddr);
     }
   else
     {
-      m_events.Track (Simulator::Schedule (DELAY (std::min (tuple->time, tuple->symTime)),
-                                           &RoutingProtocol::LinkTupleTimerExpire, this,
-                                           neighborIfaceAddr));
+      m_expiries.Schedule (DELAY (std::min (tuple->time, tuple->symTime)),
+                           &RoutingProtocol::LinkTupleTimerExpire, this,
+                           neighborIfaceAddr);
     }
 }
 
@@ -2750,9 +2931,9 @@ RoutingProtocol::Nb2hopTupleTimerExpire (Ipv4Address neighborMainAddr, Ipv4Addre
     }
   else
     {
-      m_events.Track (Simulator::Schedule (DELAY (tuple->expirationTime),
-                                           &RoutingProtocol::Nb2hopTupleTimerExpire,
-                                           this, neighborMainAddr, twoHopNeighborAddr));
+      m_expiries.Schedule (DELAY (tuple->expirationTime),
+                           &RoutingProtocol::Nb2hopTupleTimerExpire,
+                           this, neighborMainAddr, twoHopNeighborAddr);
     }
 }
 
@@ -2770,9 +2951,9 @@ RoutingProtocol::MprSelTupleTimerExpire (Ipv4Address mainAddr)
     }
   else
     {
-      m_events.Track (Simulator::Schedule (DELAY (tuple->expirationTime),
-                                           &RoutingProtocol::MprSelTupleTimerExpire,
-                                           this, mainAddr));
+      m_expiries.Schedule (DELAY (tuple->expirationTime),
+                           &RoutingProtocol::MprSelTupleTimerExpire,
+                           this, mainAddr);
     }
 }
 
@@ -2790,9 +2971,9 @@ RoutingProtocol::TopologyTupleTimerExpire (Ipv4Address destAddr, Ipv4Address las
     }
   else
     {
-      m_events.Track (Simulator::Schedule (DELAY (tuple->expirationTime),
-                                           &RoutingProtocol::TopologyTupleTimerExpire,
-                                           this, tuple->destAddr, tuple->lastAddr));
+      m_expiries.Schedule (DELAY (tuple->expirationTime),
+                           &RoutingProtocol::TopologyTupleTimerExpire,
+                           this, tuple->destAddr, tuple->lastAddr);
     }
 }
 
@@ -2810,9 +2991,9 @@ RoutingProtocol::IfaceAssocTupleTimerExpire (Ipv4Address ifaceAddr)
     }
   else
     {
-      m_events.Track (Simulator::Schedule (DELAY (tuple->time),
-                                           &RoutingProtocol::IfaceAssocTupleTimerExpire,
-                                           this, ifaceAddr));
+      m_expiries.Schedule (DELAY (tuple->time),
+                           &RoutingProtocol::IfaceAssocTupleTimerExpire,
+                           this, ifaceAddr);
     }
 }
 
@@ -2830,9 +3011,9 @@ RoutingProtocol::AssociationTupleTimerExpire (Ipv4Address gatewayAddr, Ipv4Addre
     }
   else
     {
-      m_events.Track (Simulator::Schedule (DELAY (tuple->expirationTime),
-                                           &RoutingProtocol::AssociationTupleTimerExpire,
-                                           this, gatewayAddr, networkAddr, netmask));
+      m_expiries.Schedule (DELAY (tuple->expirationTime),
+                           &RoutingProtocol::AssociationTupleTimerExpire,
+                           this, gatewayAddr, networkAddr, netmask);
     }
 }
 
@@ -32,7 +32,7 @@
 #include "ns3/packet.h"
 #include "ns3/node.h"
 #include "ns3/socket.h"
-#include "ns3/event-garbage-collector.h"
+#include "ns3/expiry-calendar.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/timer.h"
 #include "ns3/traced-callback.h"
@@ -241,10 +241,13 @@ protected:
 
 private:
   std::map<Ipv4Address, RoutingTableEntry> m_table; //!< Data structure for the routing table.
+  bool m_incrementalRouting; //!< Update the routing table from the changes of the topology set.
+  std::map<Ipv4Address, RoutingTableEntry> m_neighborhoodRoutes; //!< Routes to the 1-hop and 2-hop neighbors.
+  std::vector<Ipv4Address> m_ifaceAssocRoutes; //!< Destinations of the routes to the interface association set.
 
   Ptr<Ipv4StaticRouting> m_hnaRoutingTable; //!< Routing table for HNA routes
 
-  EventGarbageCollector m_events; //!< Running events.
+  ExpiryCalendar m_expiries; //!< Expirations of the tuples.
 
   uint16_t m_packetSequenceNumber;    //!< Packets sequence number counter.
   uint16_t m_messageSequenceNumber;   //!< Messages sequence number counter.
@@ -398,9 +401,49 @@ private:
 
   /**
    * \brief Creates the routing table of the node following \RFC{3626} hints.
+   *
+   * With the IncrementalRouting attribute, while the routes to the 1-hop
+   * and 2-hop neighbors do not change, the routes through the topology set
+   * are updated from the changes of the topology set since the previous
+   * computation, instead of being computed from scratch.
    */
   void RoutingTableComputation (void);
 
+  /**
+   * \brief Adds the routes to the 1-hop and 2-hop neighbors to the routing
+   * table (steps 2 and 3 of the routing table computation of \RFC{3626}).
+   */
+  void AddNeighborhoodRoutes (void);
+
+  /**
+   * \brief Adds the routes through the topology set to the routing table,
+   * scanning the topology set once for each distance (step 3.1).
+   */
+  void AddTopologyRoutes (void);
+
+  /**
+   * \brief Recomputes the routes of more than \p h hops through the
+   * topology set.
+   *
+   * The routes are the same as those of AddTopologyRoutes, but the
+   * topology tuples are found from the nodes at each distance.
+   *
+   * \param h The distance of the routes which are kept.
+   */
+  void UpdateTopologyRoutes (uint32_t h);
+
+  /**
+   * \brief Adds the routes to the interfaces of the multiple interface
+   * association set to the routing table (step 4).
+   */
+  void AddIfaceAssocRoutes (void);
+
+  /**
+   * \brief Recomputes the HNA routing table from the association set
+   * (step 5).
+   */
+  void ComputeHnaRoutes (void);
+
 public:
   /**
    * \brief Gets the main address associated with a given interface address.
@@ -26,12 +26,36 @@
 ///		state of an OLSR node.
 ///
 
+#include <algorithm>
 #include "olsr-state.h"
 
 
 namespace ns3 {
 namespace olsr {
 
+template <typename T>
+const std::vector<uint32_t> *
+OlsrState::FindPositions (AddressIndex &index, bool &valid,
+                          const std::vector<T> &set, Ipv4Address T::*key,
+                          const Ipv4Address &address)
+{
+  if (!valid)
+    {
+      index.clear ();
+      for (uint32_t i = 0; i < set.size (); i++)
+        {
+          index[set[i].*key].push_back (i);
+        }
+      valid = true;
+    }
+  AddressIndex::const_iterator it = index.find (address);
+  if (it == index.end ())
+    {
+      return NULL;
+    }
+  return &it->second;
+}
+
 /********** MPR Selector Set Manipulation **********/
 
 MprSelectorTuple*
@@ -111,26 +135,32 @@ OlsrState::PrintMprSelectorSet () const
 NeighborTuple*
 OlsrState::FindNeighborTuple (Ipv4Address const &mainAddr)
 {
-  for (NeighborSet::iterator it = m_neighborSet.begin ();
-       it != m_neighborSet.end (); it++)
+  const std::vector<uint32_t> *positions =
+    FindPositions (m_neighborIndex, m_neighborIndexValid, m_neighborSet,
+                   &NeighborTuple::neighborMainAddr, mainAddr);
+  if (positions == NULL)
     {
-      if (it->neighborMainAddr == mainAddr)
-        {
-          return &(*it);
-        }
+      return NULL;
     }
-  return NULL;
+  return &m_neighborSet[positions->front ()];
 }
 
 const NeighborTuple*
 OlsrState::FindSymNeighborTuple (Ipv4Address const &mainAddr) const
 {
-  for (NeighborSet::const_iterator it = m_neighborSet.begin ();
-       it != m_neighborSet.end (); it++)
+  const std::vector<uint32_t> *positions =
+    FindPositions (m_neighborIndex, m_neighborIndexValid, m_neighborSet,
+                   &NeighborTuple::neighborMainAddr, mainAddr);
+  if (positions == NULL)
+    {
+      return NULL;
+    }
+  for (std::vector<uint32_t>::const_iterator it = positions->begin ();
+       it != positions->end (); it++)
     {
-      if (it->neighborMainAddr == mainAddr && it->status == NeighborTuple::STATUS_SYM)
+      if (m_neighborSet[*it].status == NeighborTuple::STATUS_SYM)
         {
-          return &(*it);
+          return &m_neighborSet[*it];
         }
     }
   return NULL;
@@ -139,12 +169,19 @@ OlsrState::FindSymNeighborTuple (Ipv4Address const &mainAddr) const
 NeighborTuple*
 OlsrState::FindNeighborTuple (Ipv4Address const &mainAddr, uint8_t willingness)
 {
-  for (NeighborSet::iterator it = m_neighborSet.begin ();
-       it != m_neighborSet.end (); it++)
+  const std::vector<uint32_t> *positions =
+    FindPositions (m_neighborIndex, m_neighborIndexValid, m_neighborSet,
+                   &NeighborTuple::neighborMainAddr, mainAddr);
+  if (positions == NULL)
+    {
+      return NULL;
+    }
+  for (std::vector<uint32_t>::const_iterator it = positions->begin ();
+       it != positions->end (); it++)
     {
-      if (it->neighborMainAddr == mainAddr && it->willingness == willingness)
+      if (m_neighborSet[*it].willingness == willingness)
         {
-          return &(*it);
+          return &m_neighborSet[*it];
         }
     }
   return NULL;
@@ -153,12 +190,20 @@ OlsrState::FindNeighborTuple (Ipv4Address const &mainAddr, uint8_t willingness)
 void
 OlsrState::EraseNeighborTuple (const NeighborTuple &tuple)
 {
-  for (NeighborSet::iterator it = m_neighborSet.begin ();
-       it != m_neighborSet.end (); it++)
+  const std::vector<uint32_t> *positions =
+    FindPositions (m_neighborIndex, m_neighborIndexValid, m_neighborSet,
+                   &NeighborTuple::neighborMainAddr, tuple.neighborMainAddr);
+  if (positions == NULL)
     {
-      if (*it == tuple)
+      return;
+    }
+  for (std::vector<uint32_t>::const_iterator it = positions->begin ();
+       it != positions->end (); it++)
+    {
+      if (m_neighborSet[*it] == tuple)
         {
-          m_neighborSet.erase (it);
+          m_neighborSet.erase (m_neighborSet.begin () + *it);
+          m_neighborIndexValid = false;
           break;
         }
     }
@@ -167,31 +212,31 @@ OlsrState::EraseNeighborTuple (const NeighborTuple &tuple)
 void
 OlsrState::EraseNeighborTuple (const Ipv4Address &mainAddr)
 {
-  for (NeighborSet::iterator it = m_neighborSet.begin ();
-       it != m_neighborSet.end (); it++)
+  const std::vector<uint32_t> *positions =
+    FindPositions (m_neighborIndex, m_neighborIndexValid, m_neighborSet,
+                   &NeighborTuple::neighborMainAddr, mainAddr);
+  if (positions != NULL)
     {
-      if (it->neighborMainAddr == mainAddr)
-        {
-          it = m_neighborSet.erase (it);
-          break;
-        }
+      m_neighborSet.erase (m_neighborSet.begin () + positions->front ());
+      m_neighborIndexValid = false;
     }
 }
 
 void
 OlsrState::InsertNeighborTuple (NeighborTuple const &tuple)
 {
-  for (NeighborSet::iterator it = m_neighborSet.begin ();
-       it != m_neighborSet.end (); it++)
+  NeighborTuple *existing = FindNeighborTuple (tuple.neighborMainAddr);
+  if (existing != NULL)
     {
-      if (it->neighborMainAddr == tuple.neighborMainAddr)
-        {
-          // Update it
-          *it = tuple;
-          return;
-        }
+      // Update it
+      *existing = tuple;
+      return;
     }
   m_neighborSet.push_back (tuple);
+  if (m_neighborIndexValid)
+    {
+      m_neighborIndex[tuple.neighborMainAddr].push_back (m_neighborSet.size () - 1);
+    }
 }
 
 /********** Neighbor 2 Hop Set Manipulation **********/
@@ -200,13 +245,19 @@ TwoHopNeighborTuple*
 OlsrState::FindTwoHopNeighborTuple (Ipv4Address const &neighborMainAddr,
                                     Ipv4Address const &twoHopNeighborAddr)
 {
-  for (TwoHopNeighborSet::iterator it = m_twoHopNeighborSet.begin ();
-       it != m_twoHopNeighborSet.end (); it++)
+  const std::vector<uint32_t> *positions =
+    FindPositions (m_twoHopNeighborIndex, m_twoHopNeighborIndexValid, m_twoHopNeighborSet,
+                   &TwoHopNeighborTuple::neighborMainAddr, neighborMainAddr);
+  if (positions == NULL)
     {
-      if (it->neighborMainAddr == neighborMainAddr
-          && it->twoHopNeighborAddr == twoHopNeighborAddr)
+      return NULL;
+    }
+  for (std::vector<uint32_t>::const_iterator it = positions->begin ();
+       it != positions->end (); it++)
+    {
+      if (m_twoHopNeighborSet[*it].twoHopNeighborAddr == twoHopNeighborAddr)
         {
-          return &(*it);
+          return &m_twoHopNeighborSet[*it];
         }
     }
   return NULL;
@@ -215,14 +266,12 @@ OlsrState::FindTwoHopNeighborTuple (Ipv4Address const &neighborMainAddr,
 void
 OlsrState::EraseTwoHopNeighborTuple (const TwoHopNeighborTuple &tuple)
 {
-  for (TwoHopNeighborSet::iterator it = m_twoHopNeighborSet.begin ();
-       it != m_twoHopNeighborSet.end (); it++)
+  TwoHopNeighborTuple *found = FindTwoHopNeighborTuple (tuple.neighborMainAddr,
+                                                        tuple.twoHopNeighborAddr);
+  if (found != NULL)
     {
-      if (*it == tuple)
-        {
-          m_twoHopNeighborSet.erase (it);
-          break;
-        }
+      m_twoHopNeighborSet.erase (m_twoHopNeighborSet.begin () + (found - &m_twoHopNeighborSet[0]));
+      m_twoHopNeighborIndexValid = false;
     }
 }
 
@@ -230,6 +279,10 @@ void
 OlsrState::EraseTwoHopNeighborTuples (const Ipv4Address &neighborMainAddr,
                                       const Ipv4Address &twoHopNeighborAddr)
 {
+  if (FindTwoHopNeighborTuple (neighborMainAddr, twoHopNeighborAddr) == NULL)
+    {
+      return;
+    }
   for (TwoHopNeighborSet::iterator it = m_twoHopNeighborSet.begin ();
        it != m_twoHopNeighborSet.end (); )
     {
@@ -243,11 +296,17 @@ OlsrState::EraseTwoHopNeighborTuples (const Ipv4Address &neighborMainAddr,
           it++;
         }
     }
+  m_twoHopNeighborIndexValid = false;
 }
 
 void
 OlsrState::EraseTwoHopNeighborTuples (const Ipv4Address &neighborMainAddr)
 {
+  if (FindPositions (m_twoHopNeighborIndex, m_twoHopNeighborIndexValid, m_twoHopNeighborSet,
+                     &TwoHopNeighborTuple::neighborMainAddr, neighborMainAddr) == NULL)
+    {
+      return;
+    }
   for (TwoHopNeighborSet::iterator it = m_twoHopNeighborSet.begin ();
        it != m_twoHopNeighborSet.end (); )
     {
@@ -260,12 +319,17 @@ OlsrState::EraseTwoHopNeighborTuples (const Ipv4Address &neighborMainAddr)
           it++;
         }
     }
+  m_twoHopNeighborIndexValid = false;
 }
 
 void
 OlsrState::InsertTwoHopNeighborTuple (TwoHopNeighborTuple const &tuple)
 {
   m_twoHopNeighborSet.push_back (tuple);
+  if (m_twoHopNeighborIndexValid)
+    {
+      m_twoHopNeighborIndex[tuple.neighborMainAddr].push_back (m_twoHopNeighborSet.size () - 1);
+    }
 }
 
 /********** MPR Set Manipulation **********/
@@ -293,12 +357,17 @@ OlsrState::GetMprSet () const
 DuplicateTuple*
 OlsrState::FindDuplicateTuple (Ipv4Address const &addr, uint16_t sequenceNumber)
 {
-  for (DuplicateSet::iterator it = m_duplicateSet.begin ();
-       it != m_duplicateSet.end (); it++)
+  AddressIndex::const_iterator positions = m_duplicateIndex.find (addr);
+  if (positions == m_duplicateIndex.end ())
     {
-      if (it->address == addr && it->sequenceNumber == sequenceNumber)
+      return NULL;
+    }
+  for (std::vector<uint32_t>::const_iterator it = positions->second.begin ();
+       it != positions->second.end (); it++)
+    {
+      if (m_duplicateSet[*it].sequenceNumber == sequenceNumber)
         {
-          return &(*it);
+          return &m_duplicateSet[*it];
         }
     }
   return NULL;
@@ -307,12 +376,32 @@ OlsrState::FindDuplicateTuple (Ipv4Address const &addr, uint16_t sequenceNumber)
 void
 OlsrState::EraseDuplicateTuple (const DuplicateTuple &tuple)
 {
-  for (DuplicateSet::iterator it = m_duplicateSet.begin ();
-       it != m_duplicateSet.end (); it++)
+  // The order of the duplicate set does not matter: the last tuple takes
+  // the place of the erased one, so that the index is updated in place
+  AddressIndex::iterator positions = m_duplicateIndex.find (tuple.address);
+  if (positions == m_duplicateIndex.end ())
     {
-      if (*it == tuple)
+      return;
+    }
+  std::vector<uint32_t> &erased = positions->second;
+  for (std::vector<uint32_t>::iterator it = erased.begin (); it != erased.end (); it++)
+    {
+      if (m_duplicateSet[*it] == tuple)
         {
-          m_duplicateSet.erase (it);
+          uint32_t position = *it;
+          uint32_t last = m_duplicateSet.size () - 1;
+          erased.erase (it);
+          if (erased.empty ())
+            {
+              m_duplicateIndex.erase (positions);
+            }
+          if (position != last)
+            {
+              std::vector<uint32_t> &moved = m_duplicateIndex[m_duplicateSet[last].address];
+              *std::find (moved.begin (), moved.end (), last) = position;
+              m_duplicateSet[position] = m_duplicateSet[last];
+            }
+          m_duplicateSet.pop_back ();
           break;
         }
     }
@@ -322,6 +411,7 @@ void
 OlsrState::InsertDuplicateTuple (DuplicateTuple const &tuple)
 {
   m_duplicateSet.push_back (tuple);
+  m_duplicateIndex[tuple.address].push_back (m_duplicateSet.size () - 1);
 }
 
 /********** Link Set Manipulation **********/
@@ -329,34 +419,23 @@ OlsrState::InsertDuplicateTuple (DuplicateTuple const &tuple)
 LinkTuple*
 OlsrState::FindLinkTuple (Ipv4Address const & ifaceAddr)
 {
-  for (LinkSet::iterator it = m_linkSet.begin ();
-       it != m_linkSet.end (); it++)
+  const std::vector<uint32_t> *positions =
+    FindPositions (m_linkIndex, m_linkIndexValid, m_linkSet,
+                   &LinkTuple::neighborIfaceAddr, ifaceAddr);
+  if (positions == NULL)
     {
-      if (it->neighborIfaceAddr == ifaceAddr)
-        {
-          return &(*it);
-        }
+      return NULL;
     }
-  return NULL;
+  return &m_linkSet[positions->front ()];
 }
 
 LinkTuple*
 OlsrState::FindSymLinkTuple (Ipv4Address const &ifaceAddr, Time now)
 {
-  for (LinkSet::iterator it = m_linkSet.begin ();
-       it != m_linkSet.end (); it++)
+  LinkTuple *tuple = FindLinkTuple (ifaceAddr);
+  if (tuple != NULL && tuple->symTime > now)
     {
-      if (it->neighborIfaceAddr == ifaceAddr)
-        {
-          if (it->symTime > now)
-            {
-              return &(*it);
-            }
-          else
-            {
-              break;
-            }
-        }
+      return tuple;
     }
   return NULL;
 }
@@ -364,12 +443,20 @@ OlsrState::FindSymLinkTuple (Ipv4Address const &ifaceAddr, Time now)
 void
 OlsrState::EraseLinkTuple (const LinkTuple &tuple)
 {
-  for (LinkSet::iterator it = m_linkSet.begin ();
-       it != m_linkSet.end (); it++)
+  const std::vector<uint32_t> *positions =
+    FindPositions (m_linkIndex, m_linkIndexValid, m_linkSet,
+                   &LinkTuple::neighborIfaceAddr, tuple.neighborIfaceAddr);
+  if (positions == NULL)
     {
-      if (*it == tuple)
+      return;
+    }
+  for (std::vector<uint32_t>::const_iterator it = positions->begin ();
+       it != positions->end (); it++)
+    {
+      if (m_linkSet[*it] == tuple)
         {
-          m_linkSet.erase (it);
+          m_linkSet.erase (m_linkSet.begin () + *it);
+          m_linkIndexValid = false;
           break;
         }
     }
@@ -379,6 +466,10 @@ LinkTuple&
 OlsrState::InsertLinkTuple (LinkTuple const &tuple)
 {
   m_linkSet.push_back (tuple);
+  if (m_linkIndexValid)
+    {
+      m_linkIndex[tuple.neighborIfaceAddr].push_back (m_linkSet.size () - 1);
+    }
   return m_linkSet.back ();
 }
 
@@ -388,12 +479,17 @@ TopologyTuple*
 OlsrState::FindTopologyTuple (Ipv4Address const &destAddr,
                               Ipv4Address const &lastAddr)
 {
-  for (TopologySet::iterator it = m_topologySet.begin ();
-       it != m_topologySet.end (); it++)
+  const std::vector<uint32_t> *positions = FindTopologyTuples (lastAddr);
+  if (positions == NULL)
+    {
+      return NULL;
+    }
+  for (std::vector<uint32_t>::const_iterator it = positions->begin ();
+       it != positions->end (); it++)
     {
-      if (it->destAddr == destAddr && it->lastAddr == lastAddr)
+      if (m_topologySet[*it].destAddr == destAddr)
         {
-          return &(*it);
+          return &m_topologySet[*it];
         }
     }
   return NULL;
@@ -402,12 +498,17 @@ OlsrState::FindTopologyTuple (Ipv4Address const &destAddr,
 TopologyTuple*
 OlsrState::FindNewerTopologyTuple (Ipv4Address const & lastAddr, uint16_t ansn)
 {
-  for (TopologySet::iterator it = m_topologySet.begin ();
-       it != m_topologySet.end (); it++)
+  const std::vector<uint32_t> *positions = FindTopologyTuples (lastAddr);
+  if (positions == NULL)
+    {
+      return NULL;
+    }
+  for (std::vector<uint32_t>::const_iterator it = positions->begin ();
+       it != positions->end (); it++)
     {
-      if (it->lastAddr == lastAddr && it->sequenceNumber > ansn)
+      if (m_topologySet[*it].sequenceNumber > ansn)
         {
-          return &(*it);
+          return &m_topologySet[*it];
         }
     }
   return NULL;
@@ -416,12 +517,19 @@ OlsrState::FindNewerTopologyTuple (Ipv4Address const & lastAddr, uint16_t ansn)
 void
 OlsrState::EraseTopologyTuple (const TopologyTuple &tuple)
 {
-  for (TopologySet::iterator it = m_topologySet.begin ();
-       it != m_topologySet.end (); it++)
+  const std::vector<uint32_t> *positions = FindTopologyTuples (tuple.lastAddr);
+  if (positions == NULL)
     {
-      if (*it == tuple)
+      return;
+    }
+  for (std::vector<uint32_t>::const_iterator it = positions->begin ();
+       it != positions->end (); it++)
+    {
+      if (m_topologySet[*it] == tuple)
         {
-          m_topologySet.erase (it);
+          m_topologySet.erase (m_topologySet.begin () + *it);
+          m_topologyIndexValid = false;
+          m_topologyChanges.insert (tuple.lastAddr);
           break;
         }
     }
@@ -430,6 +538,21 @@ OlsrState::EraseTopologyTuple (const TopologyTuple &tuple)
 void
 OlsrState::EraseOlderTopologyTuples (const Ipv4Address &lastAddr, uint16_t ansn)
 {
+  const std::vector<uint32_t> *positions = FindTopologyTuples (lastAddr);
+  if (positions == NULL)
+    {
+      return;
+    }
+  bool older = false;
+  for (std::vector<uint32_t>::const_iterator it = positions->begin ();
+       it != positions->end () && !older; it++)
+    {
+      older = m_topologySet[*it].sequenceNumber < ansn;
+    }
+  if (!older)
+    {
+      return;
+    }
   for (TopologySet::iterator it = m_topologySet.begin ();
        it != m_topologySet.end (); )
     {
@@ -442,12 +565,26 @@ OlsrState::EraseOlderTopologyTuples (const Ipv4Address &lastAddr, uint16_t ansn)
           it++;
         }
     }
+  m_topologyIndexValid = false;
+  m_topologyChanges.insert (lastAddr);
 }
 
 void
 OlsrState::InsertTopologyTuple (TopologyTuple const &tuple)
 {
   m_topologySet.push_back (tuple);
+  if (m_topologyIndexValid)
+    {
+      m_topologyIndex[tuple.lastAddr].push_back (m_topologySet.size () - 1);
+    }
+  m_topologyChanges.insert (tuple.lastAddr);
+}
+
+const std::vector<uint32_t> *
+OlsrState::FindTopologyTuples (const Ipv4Address &lastAddr) const
+{
+  return FindPositions (m_topologyIndex, m_topologyIndexValid, m_topologySet,
+                        &TopologyTuple::lastAddr, lastAddr);
 }
 
 /********** Interface Association Set Manipulation **********/
@@ -455,40 +592,46 @@ OlsrState::InsertTopologyTuple (TopologyTuple const &tuple)
 IfaceAssocTuple*
 OlsrState::FindIfaceAssocTuple (Ipv4Address const &ifaceAddr)
 {
-  for (IfaceAssocSet::iterator it = m_ifaceAssocSet.begin ();
-       it != m_ifaceAssocSet.end (); it++)
+  const std::vector<uint32_t> *positions =
+    FindPositions (m_ifaceAssocIndex, m_ifaceAssocIndexValid, m_ifaceAssocSet,
+                   &IfaceAssocTuple::ifaceAddr, ifaceAddr);
+  if (positions == NULL)
     {
-      if (it->ifaceAddr == ifaceAddr)
-        {
-          return &(*it);
-        }
+      return NULL;
     }
-  return NULL;
+  return &m_ifaceAssocSet[positions->front ()];
 }
 
 const IfaceAssocTuple*
 OlsrState::FindIfaceAssocTuple (Ipv4Address const &ifaceAddr) const
 {
-  for (IfaceAssocSet::const_iterator it = m_ifaceAssocSet.begin ();
-       it != m_ifaceAssocSet.end (); it++)
+  const std::vector<uint32_t> *positions =
+    FindPositions (m_ifaceAssocIndex, m_ifaceAssocIndexValid, m_ifaceAssocSet,
+                   &IfaceAssocTuple::ifaceAddr, ifaceAddr);
+  if (positions == NULL)
     {
-      if (it->ifaceAddr == ifaceAddr)
-        {
-          return &(*it);
-        }
+      return NULL;
     }
-  return NULL;
+  return &m_ifaceAssocSet[positions->front ()];
 }
 
 void
 OlsrState::EraseIfaceAssocTuple (const IfaceAssocTuple &tuple)
 {
-  for (IfaceAssocSet::iterator it = m_ifaceAssocSet.begin ();
-       it != m_ifaceAssocSet.end (); it++)
+  const std::vector<uint32_t> *positions =
+    FindPositions (m_ifaceAssocIndex, m_ifaceAssocIndexValid, m_ifaceAssocSet,
+                   &IfaceAssocTuple::ifaceAddr, tuple.ifaceAddr);
+  if (positions == NULL)
     {
-      if (*it == tuple)
+      return;
+    }
+  for (std::vector<uint32_t>::const_iterator it = positions->begin ();
+       it != positions->end (); it++)
+    {
+      if (m_ifaceAssocSet[*it] == tuple)
         {
-          m_ifaceAssocSet.erase (it);
+          m_ifaceAssocSet.erase (m_ifaceAssocSet.begin () + *it);
+          m_ifaceAssocIndexValid = false;
           break;
         }
     }
@@ -498,6 +641,10 @@ void
 OlsrState::InsertIfaceAssocTuple (const IfaceAssocTuple &tuple)
 {
   m_ifaceAssocSet.push_back (tuple);
+  if (m_ifaceAssocIndexValid)
+    {
+      m_ifaceAssocIndex[tuple.ifaceAddr].push_back (m_ifaceAssocSet.size () - 1);
+    }
 }
 
 std::vector<Ipv4Address>
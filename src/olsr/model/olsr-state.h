@@ -24,6 +24,7 @@
 #ifndef OLSR_STATE_H
 #define OLSR_STATE_H
 
+#include <unordered_map>
 #include "olsr-repositories.h"
 
 namespace ns3 {
@@ -31,6 +32,11 @@ namespace olsr {
 
 /// \ingroup olsr
 /// This class encapsulates all data structures needed for maintaining internal state of an OLSR node.
+///
+/// The link, neighbor, 2-hop neighbor, topology, interface association and
+/// duplicate sets are indexed by address, so that their tuples are found
+/// without scanning the sets.  The indexes are rebuilt after tuples are
+/// erased or after a set is modified through a mutable reference.
 class OlsrState
 {
   //  friend class Olsr;
@@ -49,6 +55,11 @@ protected:
 
 public:
   OlsrState ()
+    : m_linkIndexValid (false),
+      m_neighborIndexValid (false),
+      m_twoHopNeighborIndexValid (false),
+      m_topologyIndexValid (false),
+      m_ifaceAssocIndexValid (false)
   {
   }
 
@@ -106,10 +117,15 @@ public:
   }
   /**
    * Gets the neighbor set.
+   *
+   * The neighbor index is rebuilt at the next search, since the tuples
+   * may be modified through the returned reference.
+   *
    * \returns The neighbor set.
    */
   NeighborSet & GetNeighbors ()
   {
+    m_neighborIndexValid = false;
     return m_neighborSet;
   }
 
@@ -165,10 +181,15 @@ public:
   }
   /**
    * Gets the 2-hop neighbor set.
+   *
+   * The 2-hop neighbor index is rebuilt at the next search, since the
+   * tuples may be modified through the returned reference.
+   *
    * \returns The 2-hop neighbor set.
    */
   TwoHopNeighborSet & GetTwoHopNeighbors ()
   {
+    m_twoHopNeighborIndexValid = false;
     return m_twoHopNeighborSet;
   }
 
@@ -325,6 +346,29 @@ public:
    * \param tuple The tuple to insert.
    */
   void InsertTopologyTuple (const TopologyTuple &tuple);
+  /**
+   * Finds the topology tuples with a given last address.
+   * \param lastAddr The address of the node previous to the destination.
+   * \returns The positions of the tuples in the topology set, in increasing
+   * order, or a null pointer if there are none.
+   */
+  const std::vector<uint32_t> * FindTopologyTuples (const Ipv4Address &lastAddr) const;
+  /**
+   * Gets the last addresses of the topology tuples inserted or erased
+   * since the changes were last cleared.
+   * \returns The last addresses.
+   */
+  const std::set<Ipv4Address> & GetTopologyChanges () const
+  {
+    return m_topologyChanges;
+  }
+  /**
+   * Clears the record of the changes of the topology set.
+   */
+  void ClearTopologyChanges ()
+  {
+    m_topologyChanges.clear ();
+  }
 
   // Interface association
 
@@ -338,10 +382,15 @@ public:
   }
   /**
    * Gets a mutable reference to the interface association set.
+   *
+   * The interface association index is rebuilt at the next search, since
+   * the tuples may be modified through the returned reference.
+   *
    * \returns The interface association set.
    */
   IfaceAssocSet & GetIfaceAssocSetMutable ()
   {
+    m_ifaceAssocIndexValid = false;
     return m_ifaceAssocSet;
   }
 
@@ -427,6 +476,42 @@ public:
   std::vector<Ipv4Address>
   FindNeighborInterfaces (const Ipv4Address &neighborMainAddr) const;
 
+private:
+  /// The positions of the tuples of a set, in increasing order, by address
+  typedef std::unordered_map<Ipv4Address, std::vector<uint32_t>, Ipv4AddressHash> AddressIndex;
+
+  /**
+   * \brief Find the positions of the tuples of a set with an address.
+   *
+   * The index is rebuilt from the set if it is invalid.
+   *
+   * \tparam T \deduced The type of the tuples.
+   * \param [in,out] index The index of the set.
+   * \param [in,out] valid True if the index matches the set.
+   * \param [in] set The set.
+   * \param [in] key The address member by which the tuples are indexed.
+   * \param [in] address The address.
+   * \returns The positions of the tuples, or a null pointer if there are none.
+   */
+  template <typename T>
+  static const std::vector<uint32_t> * FindPositions (AddressIndex &index, bool &valid,
+                                                      const std::vector<T> &set,
+                                                      Ipv4Address T::*key,
+                                                      const Ipv4Address &address);
+
+  mutable AddressIndex m_linkIndex;         //!< Index of the link set by neighbor interface address
+  mutable AddressIndex m_neighborIndex;     //!< Index of the neighbor set by main address
+  mutable AddressIndex m_twoHopNeighborIndex; //!< Index of the 2-hop neighbor set by neighbor main address
+  mutable AddressIndex m_topologyIndex;     //!< Index of the topology set by last address
+  mutable AddressIndex m_ifaceAssocIndex;   //!< Index of the interface association set by interface address
+  AddressIndex m_duplicateIndex;            //!< Index of the duplicate set by originator address, in any order
+  mutable bool m_linkIndexValid;            //!< True if the link index matches the link set
+  mutable bool m_neighborIndexValid;        //!< True if the neighbor index matches the neighbor set
+  mutable bool m_twoHopNeighborIndexValid;  //!< True if the 2-hop neighbor index matches the 2-hop neighbor set
+  mutable bool m_topologyIndexValid;        //!< True if the topology index matches the topology set
+  mutable bool m_ifaceAssocIndexValid;      //!< True if the interface association index matches its set
+  std::set<Ipv4Address> m_topologyChanges;  //!< Last addresses of the topology tuples inserted or erased
+
 };
 
 }
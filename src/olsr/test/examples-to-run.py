@@ -9,6 +9,7 @@
 # See test.py for more information.
 cpp_examples = [
     ("simple-point-to-point-olsr", "True", "True"),
+    ("olsr-manet-scale --nodes=20 --time=5", "True", "False"),
 ]
 
 # A list of Python examples to run in order to ensure that they remain
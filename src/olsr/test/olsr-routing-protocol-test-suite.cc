@@ -20,9 +20,22 @@
  *          Gustavo J. A. M. Carneiro <gjc@inescporto.pt>
  */
 
+#include <sstream>
 #include "ns3/test.h"
 #include "ns3/olsr-routing-protocol.h"
+#include "ns3/olsr-helper.h"
 #include "ns3/ipv4-header.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/vector.h"
 
 /**
  * \ingroup olsr
@@ -178,6 +191,192 @@ OlsrMprTestCase::DoRun ()
   NS_TEST_EXPECT_MSG_EQ ((mpr.find ("10.0.0.9") == mpr.end ()), true, "Node 1 must NOT select node 8 as MPR");
 }
 
+/**
+ * \ingroup olsr-test
+ * \ingroup tests
+ *
+ * Testcase for the incremental routing table computation: nodes which move
+ * in and out of range of each other must have the same routing tables with
+ * and without the IncrementalRouting attribute.
+ */
+class OlsrIncrementalRoutingTestCase : public TestCase
+{
+public:
+  OlsrIncrementalRoutingTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Simulate the moving nodes.
+   * \param incremental The value of the IncrementalRouting attribute.
+   * \returns The routing tables of the nodes, sampled every second.
+   */
+  std::vector<std::string> Simulate (bool incremental);
+  /**
+   * Move the nodes and block the devices which are out of range.
+   */
+  void Move (void);
+  /**
+   * Record the routing tables of the nodes.
+   */
+  void Sample (void);
+
+  NodeContainer m_nodes;                           //!< The nodes
+  std::vector<std::vector<Ptr<SimpleNetDevice> > > m_devices; //!< The devices of each channel, by node
+  std::vector<Ptr<SimpleChannel> > m_channels;     //!< The channels
+  std::vector<Vector> m_positions;                 //!< The positions of the nodes
+  Ptr<UniformRandomVariable> m_random;             //!< The moves of the nodes
+  std::vector<std::string> m_tables;               //!< The sampled routing tables
+  uint32_t m_longRoutes;                           //!< The number of sampled routes of more than 2 hops
+};
+
+OlsrIncrementalRoutingTestCase::OlsrIncrementalRoutingTestCase ()
+  : TestCase ("Check that the incremental routing table computation finds the same routes"),
+    m_longRoutes (0)
+{
+}
+
+void
+OlsrIncrementalRoutingTestCase::Move (void)
+{
+  const double range = 250;
+  for (uint32_t i = 0; i < m_positions.size (); i++)
+    {
+      m_positions[i].x = std::min (700.0, std::max (0.0, m_positions[i].x + m_random->GetValue (-60, 60)));
+      m_positions[i].y = std::min (300.0, std::max (0.0, m_positions[i].y + m_random->GetValue (-60, 60)));
+    }
+  for (uint32_t c = 0; c < m_channels.size (); c++)
+    {
+      for (uint32_t i = 0; i < m_devices[c].size (); i++)
+        {
+          for (uint32_t j = 0; j < m_devices[c].size (); j++)
+            {
+              Ptr<SimpleNetDevice> from = m_devices[c][i];
+              Ptr<SimpleNetDevice> to = m_devices[c][j];
+              if (i == j || from == 0 || to == 0)
+                {
+                  continue;
+                }
+              if (CalculateDistance (m_positions[i], m_positions[j]) > range)
+                {
+                  m_channels[c]->BlackList (from, to);
+                }
+              else
+                {
+                  m_channels[c]->UnBlackList (from, to);
+                }
+            }
+        }
+    }
+  Simulator::Schedule (Seconds (2), &OlsrIncrementalRoutingTestCase::Move, this);
+}
+
+void
+OlsrIncrementalRoutingTestCase::Sample (void)
+{
+  std::ostringstream os;
+  os << Simulator::Now ().As (Time::S) << std::endl;
+  for (uint32_t i = 0; i < m_nodes.GetN (); i++)
+    {
+      Ptr<RoutingProtocol> olsr =
+        DynamicCast<RoutingProtocol> (m_nodes.Get (i)->GetObject<Ipv4> ()->GetRoutingProtocol ());
+      std::vector<RoutingTableEntry> entries = olsr->GetRoutingTableEntries ();
+      for (std::vector<RoutingTableEntry>::const_iterator it = entries.begin (); it != entries.end (); it++)
+        {
+          os << i << " " << it->destAddr << " " << it->nextAddr << " "
+             << it->interface << " " << it->distance << std::endl;
+          if (it->distance > 2)
+            {
+              m_longRoutes++;
+            }
+        }
+    }
+  m_tables.push_back (os.str ());
+  Simulator::Schedule (Seconds (1), &OlsrIncrementalRoutingTestCase::Sample, this);
+}
+
+std::vector<std::string>
+OlsrIncrementalRoutingTestCase::Simulate (bool incremental)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+
+  m_nodes = NodeContainer ();
+  m_nodes.Create (20);
+  OlsrHelper olsr;
+  olsr.Set ("IncrementalRouting", BooleanValue (incremental));
+  InternetStackHelper internet;
+  internet.SetRoutingHelper (olsr);
+  internet.Install (m_nodes);
+  olsr.AssignStreams (m_nodes, 0);
+
+  // Every node is on the first channel, and one node out of three is also
+  // on the second channel, so that MID messages are sent
+  SimpleNetDeviceHelper simple;
+  simple.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  simple.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NodeContainer multi;
+  for (uint32_t i = 0; i < m_nodes.GetN (); i += 3)
+    {
+      multi.Add (m_nodes.Get (i));
+    }
+  NetDeviceContainer devices[2] = {simple.Install (m_nodes), simple.Install (multi)};
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.0.0");
+  ipv4.Assign (devices[0]);
+  ipv4.SetBase ("10.2.0.0", "255.255.0.0");
+  ipv4.Assign (devices[1]);
+
+  m_channels.clear ();
+  m_devices.assign (2, std::vector<Ptr<SimpleNetDevice> > (m_nodes.GetN ()));
+  for (uint32_t c = 0; c < 2; c++)
+    {
+      m_channels.push_back (DynamicCast<SimpleChannel> (devices[c].Get (0)->GetChannel ()));
+      for (uint32_t i = 0; i < devices[c].GetN (); i++)
+        {
+          Ptr<NetDevice> device = devices[c].Get (i);
+          m_devices[c][device->GetNode ()->GetId () - m_nodes.Get (0)->GetId ()] =
+            DynamicCast<SimpleNetDevice> (device);
+        }
+    }
+
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (100);
+  m_positions.clear ();
+  for (uint32_t i = 0; i < m_nodes.GetN (); i++)
+    {
+      m_positions.push_back (Vector (m_random->GetValue (0, 700), m_random->GetValue (0, 300), 0));
+    }
+  Move ();
+
+  m_tables.clear ();
+  Simulator::Schedule (Seconds (10), &OlsrIncrementalRoutingTestCase::Sample, this);
+  Simulator::Stop (Seconds (40));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  m_random = 0;
+  m_channels.clear ();
+  m_devices.clear ();
+  m_nodes = NodeContainer ();
+  return m_tables;
+}
+
+void
+OlsrIncrementalRoutingTestCase::DoRun (void)
+{
+  std::vector<std::string> full = Simulate (false);
+  m_longRoutes = 0;
+  std::vector<std::string> incremental = Simulate (true);
+
+  NS_TEST_ASSERT_MSG_EQ (incremental.size (), full.size (), "Different number of samples");
+  NS_TEST_EXPECT_MSG_GT (m_longRoutes, 0, "The network should have routes of more than 2 hops");
+  for (uint32_t i = 0; i < full.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (incremental[i], full[i], "The routing tables differ");
+    }
+}
+
 /**
  * \ingroup olsr-test
  * \ingroup tests
@@ -194,6 +393,7 @@ OlsrProtocolTestSuite::OlsrProtocolTestSuite ()
   : TestSuite ("routing-olsr", UNIT)
 {
   AddTestCase (new OlsrMprTestCase (), TestCase::QUICK);
+  AddTestCase (new OlsrIncrementalRoutingTestCase (), TestCase::QUICK);
 }
 
 static OlsrProtocolTestSuite g_olsrProtocolTestSuite; //!< Static variable for test initialization
@@ -25,6 +25,7 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 #include "ns3/pointer.h"
+#include "ns3/segmentation-offload-tag.h"
 #include "point-to-point-net-device.h"
 #include "point-to-point-channel.h"
 #include "ppp-header.h"
@@ -248,7 +249,14 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   m_currentPkt = p;
   m_phyTxBeginTrace (m_currentPkt);
 
-  Time txTime = m_bps.CalculateBytesTxTime (p->GetSize ());
+  // A super-segment takes the time of its segments on the wire
+  uint32_t size = p->GetSize ();
+  SegmentationOffloadTag offload;
+  if (p->PeekPacketTag (offload))
+    {
+      size = offload.GetWireSize (size);
+    }
+  Time txTime = m_bps.CalculateBytesTxTime (size);
   Time txCompleteTime = txTime + m_tInterframeGap;
 
   NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << txCompleteTime.As (Time::S));
@@ -605,6 +613,30 @@ PointToPointNetDevice::SupportsSendFrom (void) const
   return false;
 }
 
+bool
+PointToPointNetDevice::SupportsSegmentationOffload (Ptr<const Packet> packet) const
+{
+  NS_LOG_FUNCTION (this << packet);
+  SegmentationOffloadTag offload;
+  bool found = packet->PeekPacketTag (offload);
+  NS_ASSERT_MSG (found, "Not a super-segment");
+  PppHeader ppp;
+  if (m_channel == 0 || !offload.FitsIn (m_queue, packet->GetSize () + ppp.GetSerializedSize ()))
+    {
+      return false;
+    }
+  // The receive error model of the other end acts on each segment
+  for (std::size_t i = 0; i < m_channel->GetNDevices (); i++)
+    {
+      Ptr<PointToPointNetDevice> device = m_channel->GetPointToPointDevice (i);
+      if (device != this && device->m_receiveErrorModel != 0)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
 void
 PointToPointNetDevice::DoMpiReceive (Ptr<Packet> p)
 {
@@ -0,0 +1,109 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * This program precomputes the Jakes fading of a set of links and writes it
+ * to files which can be read by TraceFadingLossModel (spectrum module): each
+ * file contains rbNum lines of samples in dB, one sample every step. The
+ * Jakes model is narrowband, so that all the lines of a file are equal.
+ * With --complex, each file contains instead one line per sample with the
+ * time [s] and the real and imaginary parts of the complex gain.
+ *
+ * Example:
+ *   ./ns3 run "jakes-fading-trace-generator --dopplerHz=10 --duration=10
+ *              --step=1ms --links=3 --output=fading"
+ *
+ * writes fading-0.fad, fading-1.fad and fading-2.fad, which are used with:
+ *   ns3::TraceFadingLossModel::TraceFilename=fading-0.fad
+ *   ns3::TraceFadingLossModel::TraceLength=10s
+ *   ns3::TraceFadingLossModel::SamplesNum=10000
+ *   ns3::TraceFadingLossModel::RbNum=100
+ */
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/jakes-propagation-loss-model.h"
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  double dopplerHz = 80;
+  uint32_t nOscillators = 20;
+  Time duration = Seconds (10);
+  Time step = MilliSeconds (1);
+  uint32_t rbNum = 100;
+  uint32_t nLinks = 1;
+  bool complex = false;
+  std::string output = "jakes-fading";
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("dopplerHz", "The maximum Doppler frequency [Hz]", dopplerHz);
+  cmd.AddValue ("oscillators", "The number of oscillators of the Jakes processes", nOscillators);
+  cmd.AddValue ("duration", "The duration of the traces", duration);
+  cmd.AddValue ("step", "The time between two samples", step);
+  cmd.AddValue ("rbNum", "The number of resource blocks of the traces", rbNum);
+  cmd.AddValue ("links", "The number of links, each with its own trace", nLinks);
+  cmd.AddValue ("complex", "Write the complex gains instead of the gains in dB", complex);
+  cmd.AddValue ("output", "The prefix of the trace files", output);
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::JakesProcess::DopplerFrequencyHz", DoubleValue (dopplerHz));
+  Config::SetDefault ("ns3::JakesProcess::NumberOfOscillators", UintegerValue (nOscillators));
+
+  uint32_t nSamples = duration.GetInteger () / step.GetInteger ();
+  Ptr<JakesPropagationLossModel> loss = CreateObject<JakesPropagationLossModel> ();
+  Ptr<MobilityModel> ap = CreateObject<ConstantPositionMobilityModel> ();
+  for (uint32_t i = 0; i < nLinks; i++)
+    {
+      Ptr<MobilityModel> station = CreateObject<ConstantPositionMobilityModel> ();
+      std::vector<std::complex<double> > gains = loss->GetJakesProcess (ap, station)->GetComplexGains (Seconds (0), step, nSamples);
+
+      std::ostringstream filename;
+      filename << output << "-" << i << ".fad";
+      std::ofstream file (filename.str ().c_str ());
+      if (!file.good ())
+        {
+          NS_FATAL_ERROR ("Cannot open " << filename.str ());
+        }
+      if (complex)
+        {
+          for (uint32_t s = 0; s < nSamples; s++)
+            {
+              file << (step * s).GetSeconds () << " " << gains[s].real () << " " << gains[s].imag () << std::endl;
+            }
+        }
+      else
+        {
+          std::ostringstream row;
+          for (uint32_t s = 0; s < nSamples; s++)
+            {
+              row << JakesProcess::GetChannelGainDb (gains[s]) << (s + 1 < nSamples ? " " : "\n");
+            }
+          for (uint32_t rb = 0; rb < rbNum; rb++)
+            {
+              file << row.str ();
+            }
+        }
+    }
+
+  std::cout << nLinks << " traces of " << nSamples << " samples written" << std::endl;
+  return 0;
+}
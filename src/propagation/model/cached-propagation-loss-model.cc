@@ -0,0 +1,186 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "cached-propagation-loss-model.h"
+#include "ns3/log.h"
+#include "ns3/pointer.h"
+#include "ns3/uinteger.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CachedPropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED (CachedPropagationLossModel);
+
+TypeId
+CachedPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Propagation")
+    .AddConstructor<CachedPropagationLossModel> ()
+    .AddAttribute ("Model",
+                   "The deterministic propagation loss model whose loss is memoized.",
+                   PointerValue (),
+                   MakePointerAccessor (&CachedPropagationLossModel::SetModel,
+                                        &CachedPropagationLossModel::GetModel),
+                   MakePointerChecker<PropagationLossModel> ())
+    .AddAttribute ("MaxEntries",
+                   "The maximum number of (transmitter, receiver) pairs in the cache. "
+                   "The least recently used pair is evicted when the cache is full.",
+                   UintegerValue (100000),
+                   MakeUintegerAccessor (&CachedPropagationLossModel::m_maxEntries),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+CachedPropagationLossModel::CachedPropagationLossModel ()
+  : m_hits (0),
+    m_misses (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+CachedPropagationLossModel::~CachedPropagationLossModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+CachedPropagationLossModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_INFO ("Cache hits: " << m_hits << ", misses: " << m_misses);
+  ClearCache ();
+  m_model = 0;
+  PropagationLossModel::DoDispose ();
+}
+
+void
+CachedPropagationLossModel::SetModel (Ptr<PropagationLossModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_model = model;
+  ClearCache ();
+}
+
+Ptr<PropagationLossModel>
+CachedPropagationLossModel::GetModel (void) const
+{
+  return m_model;
+}
+
+void
+CachedPropagationLossModel::ClearCache (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_index.clear ();
+  m_lru.clear ();
+}
+
+std::size_t
+CachedPropagationLossModel::GetCacheSize (void) const
+{
+  return m_index.size ();
+}
+
+uint64_t
+CachedPropagationLossModel::GetCacheHits (void) const
+{
+  return m_hits;
+}
+
+uint64_t
+CachedPropagationLossModel::GetCacheMisses (void) const
+{
+  return m_misses;
+}
+
+std::size_t
+CachedPropagationLossModel::CacheKeyHash::operator() (const CacheKey &key) const
+{
+  std::size_t h1 = std::hash<const MobilityModel *> () (key.first);
+  std::size_t h2 = std::hash<const MobilityModel *> () (key.second);
+  return h1 ^ (h2 + 0x9e3779b9 + (h1 << 6) + (h1 >> 2));
+}
+
+double
+CachedPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                           Ptr<MobilityModel> a,
+                                           Ptr<MobilityModel> b) const
+{
+  NS_ASSERT_MSG (m_model != 0, "No propagation loss model to memoize");
+
+  // the velocities are checked first, as mobility models may lazily update
+  // their position (and notify a course change) when queried
+  if (!(a->GetVelocity () == Vector () && b->GetVelocity () == Vector ()))
+    {
+      NS_LOG_LOGIC ("Moving node, loss not cached");
+      m_misses++;
+      return m_model->CalcRxPower (txPowerDbm, a, b);
+    }
+
+  uint64_t versionA = a->GetPositionVersion ();
+  uint64_t versionB = b->GetPositionVersion ();
+  CacheKey key (PeekPointer (a), PeekPointer (b));
+  CacheIndex::iterator it = m_index.find (key);
+  if (it != m_index.end ())
+    {
+      LruList::iterator entry = it->second;
+      if (entry->versionA == versionA && entry->versionB == versionB)
+        {
+          m_hits++;
+          m_lru.splice (m_lru.begin (), m_lru, entry);
+          if (txPowerDbm == entry->txPowerDbm)
+            {
+              return entry->rxPowerDbm;
+            }
+          return txPowerDbm - (entry->txPowerDbm - entry->rxPowerDbm);
+        }
+      NS_LOG_LOGIC ("Stale entry for " << a << " " << b);
+      m_lru.erase (entry);
+      m_index.erase (it);
+    }
+
+  m_misses++;
+  double rxPowerDbm = m_model->CalcRxPower (txPowerDbm, a, b);
+  if (m_maxEntries == 0)
+    {
+      return rxPowerDbm;
+    }
+  if (m_index.size () >= m_maxEntries)
+    {
+      const CacheEntry &lru = m_lru.back ();
+      m_index.erase (CacheKey (PeekPointer (lru.a), PeekPointer (lru.b)));
+      m_lru.pop_back ();
+    }
+  m_lru.push_front (CacheEntry {a, b, versionA, versionB, txPowerDbm, rxPowerDbm});
+  m_index[key] = m_lru.begin ();
+  return rxPowerDbm;
+}
+
+int64_t
+CachedPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  if (m_model == 0)
+    {
+      return 0;
+    }
+  return m_model->AssignStreams (stream);
+}
+
+} // namespace ns3
@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CACHED_PROPAGATION_LOSS_MODEL_H
+#define CACHED_PROPAGATION_LOSS_MODEL_H
+
+#include "ns3/propagation-loss-model.h"
+#include "ns3/mobility-model.h"
+#include <list>
+#include <unordered_map>
+
+namespace ns3 {
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Memoize the loss computed by a deterministic propagation loss model
+ *
+ * This model wraps another propagation loss model (possibly a chain of
+ * models, see PropagationLossModel::SetNext) and memoizes the loss it
+ * returns for every (transmitter, receiver) pair of mobility models. A
+ * cached loss is reused as long as none of the two mobility models has
+ * moved, i.e., as long as both velocities are null and the position
+ * versions (see MobilityModel::GetPositionVersion) did not change since
+ * the loss was computed. The cache is a hash table whose size is bounded
+ * by the MaxEntries attribute; the least recently used entry is evicted
+ * when the cache is full.
+ *
+ * The wrapped model must be deterministic, i.e., the loss it returns must
+ * only depend on the positions of the two nodes and not on the transmit
+ * power or the time. Random components (e.g., NakagamiPropagationLossModel
+ * or RandomPropagationLossModel) must not be wrapped; they should be
+ * chained after this model by means of SetNext, so that they are still
+ * evaluated at every call:
+ *
+ * \code
+ *   Ptr<CachedPropagationLossModel> cached = CreateObject<CachedPropagationLossModel> ();
+ *   cached->SetModel (CreateObject<LogDistancePropagationLossModel> ());
+ *   cached->SetNext (CreateObject<NakagamiPropagationLossModel> ());
+ * \endcode
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  CachedPropagationLossModel ();
+  virtual ~CachedPropagationLossModel ();
+
+  // Delete copy constructor and assignment operator to avoid misuse
+  CachedPropagationLossModel (const CachedPropagationLossModel &) = delete;
+  CachedPropagationLossModel & operator = (const CachedPropagationLossModel &) = delete;
+
+  /**
+   * Set the deterministic propagation loss model whose loss is memoized.
+   * The cache is cleared.
+   *
+   * \param model the propagation loss model
+   */
+  void SetModel (Ptr<PropagationLossModel> model);
+  /**
+   * \return the deterministic propagation loss model whose loss is memoized
+   */
+  Ptr<PropagationLossModel> GetModel (void) const;
+
+  /**
+   * Remove all the entries from the cache. This must be called if the
+   * parameters of the wrapped model are changed during the simulation.
+   */
+  void ClearCache (void);
+  /**
+   * \return the number of entries in the cache
+   */
+  std::size_t GetCacheSize (void) const;
+  /**
+   * \return the number of calls for which the cached loss was used
+   */
+  uint64_t GetCacheHits (void) const;
+  /**
+   * \return the number of calls for which the loss was computed by the wrapped model
+   */
+  uint64_t GetCacheMisses (void) const;
+
+protected:
+  void DoDispose (void) override;
+
+private:
+  double DoCalcRxPower (double txPowerDbm,
+                        Ptr<MobilityModel> a,
+                        Ptr<MobilityModel> b) const override;
+  int64_t DoAssignStreams (int64_t stream) override;
+
+  /// Key identifying a (transmitter, receiver) pair
+  typedef std::pair<const MobilityModel *, const MobilityModel *> CacheKey;
+
+  /// Hash function for the cache keys
+  struct CacheKeyHash
+  {
+    /**
+     * \param key the cache key
+     * \return the hash of the key
+     */
+    std::size_t operator() (const CacheKey &key) const;
+  };
+
+  /// Entry of the cache
+  struct CacheEntry
+  {
+    Ptr<const MobilityModel> a;  //!< transmitter mobility model
+    Ptr<const MobilityModel> b;  //!< receiver mobility model
+    uint64_t versionA;           //!< position version of the transmitter when the loss was computed
+    uint64_t versionB;           //!< position version of the receiver when the loss was computed
+    double txPowerDbm;           //!< the transmit power used to compute the loss (dBm)
+    double rxPowerDbm;           //!< the receive power returned by the wrapped model (dBm)
+  };
+
+  /// Entries ordered from the most recently used to the least recently used
+  typedef std::list<CacheEntry> LruList;
+  /// Map from a cache key to the corresponding entry
+  typedef std::unordered_map<CacheKey, LruList::iterator, CacheKeyHash> CacheIndex;
+
+  Ptr<PropagationLossModel> m_model;  //!< the memoized deterministic model
+  uint32_t m_maxEntries;              //!< the maximum number of entries in the cache
+  mutable LruList m_lru;              //!< the cache entries, in LRU order
+  mutable CacheIndex m_index;         //!< the index of the cache entries
+  mutable uint64_t m_hits;            //!< number of cache hits
+  mutable uint64_t m_misses;          //!< number of cache misses
+};
+
+} // namespace ns3
+
+#endif /* CACHED_PROPAGATION_LOSS_MODEL_H */
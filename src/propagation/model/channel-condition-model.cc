@@ -23,8 +23,10 @@
 #include "ns3/mobility-model.h"
 #include <cmath>
 #include "ns3/node.h"
+#include "ns3/node-container.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
+#include "ns3/boolean.h"
 
 namespace ns3 {
 
@@ -141,6 +143,84 @@ std::ostream& operator<< (std::ostream& os, ChannelCondition::LosConditionValue
 }
 // ------------------------------------------------------------------------- //
 
+ChannelConditionStore::ChannelConditionStore ()
+{}
+
+ChannelConditionStore::~ChannelConditionStore ()
+{}
+
+std::size_t
+ChannelConditionStore::KeyHash::operator() (const Key &key) const
+{
+  std::size_t h1 = std::hash<const MobilityModel *> () (key.first);
+  std::size_t h2 = std::hash<const MobilityModel *> () (key.second);
+  return h1 ^ (h2 + 0x9e3779b9 + (h1 << 6) + (h1 >> 2));
+}
+
+ChannelConditionStore::Key
+ChannelConditionStore::GetKey (const MobilityModel *a, const MobilityModel *b)
+{
+  // sort the mobility models so that the key is reciprocal
+  return (a < b) ? Key (a, b) : Key (b, a);
+}
+
+Ptr<ChannelCondition>
+ChannelConditionStore::Lookup (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b,
+                               Time maxAge, bool checkCourse)
+{
+  auto it = m_items.find (GetKey (PeekPointer (a), PeekPointer (b)));
+  if (it == m_items.end ())
+    {
+      NS_LOG_DEBUG ("channel condition not found");
+      return nullptr;
+    }
+  const Item &item = it->second;
+  if (!maxAge.IsZero () && Simulator::Now () - item.m_generatedTime > maxAge)
+    {
+      NS_LOG_DEBUG ("the channel condition has expired");
+      m_items.erase (it);
+      return nullptr;
+    }
+  if (checkCourse
+      && (item.m_first->GetPositionVersion () != item.m_firstVersion
+          || item.m_second->GetPositionVersion () != item.m_secondVersion))
+    {
+      NS_LOG_DEBUG ("the course of a node changed");
+      m_items.erase (it);
+      return nullptr;
+    }
+  NS_LOG_DEBUG ("found the channel condition");
+  return item.m_condition;
+}
+
+void
+ChannelConditionStore::Store (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b,
+                              Ptr<ChannelCondition> cond)
+{
+  Key key = GetKey (PeekPointer (a), PeekPointer (b));
+  Item &item = m_items[key];
+  item.m_condition = cond;
+  item.m_generatedTime = Simulator::Now ();
+  item.m_first = key.first;
+  item.m_second = key.second;
+  item.m_firstVersion = key.first->GetPositionVersion ();
+  item.m_secondVersion = key.second->GetPositionVersion ();
+}
+
+void
+ChannelConditionStore::Clear (void)
+{
+  m_items.clear ();
+}
+
+std::size_t
+ChannelConditionStore::GetSize (void) const
+{
+  return m_items.size ();
+}
+
+// ------------------------------------------------------------------------- //
+
 NS_OBJECT_ENSURE_REGISTERED (ChannelConditionModel);
 
 TypeId
@@ -159,6 +239,27 @@ ChannelConditionModel::ChannelConditionModel ()
 ChannelConditionModel::~ChannelConditionModel ()
 {}
 
+void
+ChannelConditionModel::PrecomputeChannelConditions (const NodeContainer &nodes) const
+{
+  NS_LOG_FUNCTION (this << nodes.GetN ());
+  std::vector<Ptr<const MobilityModel> > mobilityModels;
+  mobilityModels.reserve (nodes.GetN ());
+  for (NodeContainer::Iterator it = nodes.Begin (); it != nodes.End (); ++it)
+    {
+      Ptr<const MobilityModel> mobility = (*it)->GetObject<MobilityModel> ();
+      NS_ASSERT_MSG (mobility != nullptr, "Node " << (*it)->GetId () << " has no mobility model");
+      mobilityModels.push_back (mobility);
+    }
+  for (std::size_t i = 0; i < mobilityModels.size (); i++)
+    {
+      for (std::size_t j = i + 1; j < mobilityModels.size (); j++)
+        {
+          GetChannelCondition (mobilityModels[i], mobilityModels[j]);
+        }
+    }
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (AlwaysLosChannelConditionModel);
@@ -282,12 +383,17 @@ ThreeGppChannelConditionModel::GetTypeId (void)
                    TimeValue (MilliSeconds (0)),
                    MakeTimeAccessor (&ThreeGppChannelConditionModel::m_updatePeriod),
                    MakeTimeChecker ())
+    .AddAttribute ("UpdateOnCourseChange", "If true, the channel condition is also recomputed when the course of one of the two nodes changes (see MobilityModel::GetPositionVersion).",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&ThreeGppChannelConditionModel::m_updateOnCourseChange),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 ThreeGppChannelConditionModel::ThreeGppChannelConditionModel ()
-  : ChannelConditionModel ()
+  : ChannelConditionModel (),
+    m_updateOnCourseChange (false)
 {
   m_uniformVar = CreateObject<UniformRandomVariable> ();
   m_uniformVar->SetAttribute ("Min", DoubleValue (0));
@@ -299,7 +405,7 @@ ThreeGppChannelConditionModel::~ThreeGppChannelConditionModel ()
 
 void ThreeGppChannelConditionModel::DoDispose ()
 {
-  m_channelConditionMap.clear ();
+  m_channelConditions.Clear ();
   m_updatePeriod = Seconds (0.0);
 }
 
@@ -307,45 +413,15 @@ Ptr<ChannelCondition>
 ThreeGppChannelConditionModel::GetChannelCondition (Ptr<const MobilityModel> a,
                                                     Ptr<const MobilityModel> b) const
 {
-  Ptr<ChannelCondition> cond;
-
-  // get the key for this channel
-  uint32_t key = GetKey (a, b);
-
-  bool notFound = false; // indicates if the channel condition is not present in the map
-  bool update = false; // indicates if the channel condition has to be updated
-
-  // look for the channel condition in m_channelConditionMap
-  auto mapItem = m_channelConditionMap.find (key);
-  if (mapItem != m_channelConditionMap.end ())
-    {
-      NS_LOG_DEBUG ("found the channel condition in the map");
-      cond = mapItem->second.m_condition;
-
-      // check if it has to be updated
-      if (!m_updatePeriod.IsZero () && Simulator::Now () - mapItem->second.m_generatedTime > m_updatePeriod)
-        {
-          NS_LOG_DEBUG ("it has to be updated");
-          update = true;
-        }
-    }
-  else
-    {
-      NS_LOG_DEBUG ("channel condition not found");
-      notFound = true;
-    }
+  // look for a valid channel condition in the cache
+  Ptr<ChannelCondition> cond = m_channelConditions.Lookup (a, b, m_updatePeriod, m_updateOnCourseChange);
 
   // if the channel condition was not found or if it has to be updated
   // generate a new channel condition
-  if (notFound || update)
+  if (cond == nullptr)
     {
       cond = ComputeChannelCondition (a, b);
-      // store the channel condition in m_channelConditionMap, used as cache.
-      // For this reason you see a const_cast.
-      Item mapItem;
-      mapItem.m_condition = cond;
-      mapItem.m_generatedTime = Simulator::Now ();
-      const_cast<ThreeGppChannelConditionModel*> (this)->m_channelConditionMap [key] = mapItem;
+      m_channelConditions.Store (a, b, cond);
     }
 
   return cond;
@@ -413,20 +489,6 @@ ThreeGppChannelConditionModel::Calculate2dDistance (const Vector &a, const Vecto
   return distance2D;
 }
 
-uint32_t
-ThreeGppChannelConditionModel::GetKey (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b)
-{
-  // use the nodes ids to obtain a unique key for the channel between a and b
-  // sort the nodes ids so that the key is reciprocal
-  uint32_t x1 = std::min (a->GetObject<Node> ()->GetId (), b->GetObject<Node> ()->GetId ());
-  uint32_t x2 = std::max (a->GetObject<Node> ()->GetId (), b->GetObject<Node> ()->GetId ());
-
-  // use the cantor function to obtain the key
-  uint32_t key = (((x1 + x2) * (x1 + x2 + 1)) / 2) + x2;
-
-  return key;
-}
-
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (ThreeGppRmaChannelConditionModel);
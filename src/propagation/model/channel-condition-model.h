@@ -29,6 +29,7 @@
 namespace ns3 {
 
 class MobilityModel;
+class NodeContainer;
 
 /**
  * \ingroup propagation
@@ -190,6 +191,93 @@ private:
 
 };
 
+/**
+ * \ingroup propagation
+ *
+ * \brief Stores the channel conditions of pairs of nodes
+ *
+ * The channel conditions are reciprocal, i.e., the condition stored for the
+ * channel between a and b is also returned for the channel between b and a,
+ * and are looked up in constant time. Each condition is stored along with the
+ * time at which it was generated and the position versions (see
+ * MobilityModel::GetPositionVersion) of the two mobility models, so that it
+ * can be invalidated when it expires or when the course of one of the two
+ * nodes changes.
+ */
+class ChannelConditionStore
+{
+public:
+  ChannelConditionStore ();
+  ~ChannelConditionStore ();
+
+  /**
+   * Look for the condition of the channel between a and b. A condition
+   * which is no longer valid is removed from the store.
+   *
+   * \param a mobility model
+   * \param b mobility model
+   * \param maxAge if not zero, the conditions generated more than maxAge ago are no longer valid
+   * \param checkCourse if true, the conditions stored before a course change of
+   *        a or b (i.e., before their position version changed) are no longer valid
+   * \return the condition of the channel between a and b, or a null pointer if
+   *         there is no valid condition
+   */
+  Ptr<ChannelCondition> Lookup (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b,
+                                Time maxAge, bool checkCourse);
+  /**
+   * Store the condition of the channel between a and b, replacing the previous one
+   *
+   * \param a mobility model
+   * \param b mobility model
+   * \param cond the condition of the channel between a and b
+   */
+  void Store (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, Ptr<ChannelCondition> cond);
+  /**
+   * Remove all the conditions from the store
+   */
+  void Clear (void);
+  /**
+   * \return the number of conditions in the store
+   */
+  std::size_t GetSize (void) const;
+
+private:
+  /// Key identifying a channel, i.e., the pair of mobility models sorted by address
+  typedef std::pair<const MobilityModel *, const MobilityModel *> Key;
+
+  /// Hash function for the keys
+  struct KeyHash
+  {
+    /**
+     * \param key the key
+     * \return the hash of the key
+     */
+    std::size_t operator() (const Key &key) const;
+  };
+
+  /**
+   * \param a mobility model
+   * \param b mobility model
+   * \return the reciprocal key of the channel between a and b
+   */
+  static Key GetKey (const MobilityModel *a, const MobilityModel *b);
+
+  /**
+   * Struct to store a channel condition
+   */
+  struct Item
+  {
+    Ptr<ChannelCondition> m_condition; //!< the channel condition
+    Time m_generatedTime;              //!< the time when the condition was generated
+    Ptr<const MobilityModel> m_first;  //!< the first mobility model of the key, kept alive while stored
+    Ptr<const MobilityModel> m_second; //!< the second mobility model of the key, kept alive while stored
+    uint64_t m_firstVersion;           //!< the position version of the first mobility model
+    uint64_t m_secondVersion;          //!< the position version of the second mobility model
+  };
+
+  std::unordered_map<Key, Item, KeyHash> m_items; //!< the stored channel conditions
+};
+
 /**
  * \ingroup propagation
  *
@@ -239,6 +327,20 @@ public:
    */
   virtual int64_t AssignStreams (int64_t stream) = 0;
 
+  /**
+   * Compute the conditions of the channels between all the pairs of the
+   * given nodes, which must have a mobility model. This is meant to be called
+   * at the beginning of the simulation of static deployments, so that the
+   * models which store the channel conditions (e.g.,
+   * ThreeGppChannelConditionModel and BuildingsChannelConditionModel) do not
+   * have to compute them when the channels are first used. The conditions are
+   * computed by calling GetChannelCondition in a deterministic order, hence
+   * the random variables are drawn in the same order in every run.
+   *
+   * \param nodes the nodes
+   */
+  void PrecomputeChannelConditions (const NodeContainer &nodes) const;
+
   /**
   * \brief Copy constructor
   *
@@ -469,7 +571,8 @@ public:
    *
    * If the channel condition does not exists, the method computes it by calling 
    * ComputeChannelCondition and stores it in a local cache, that will be updated 
-   * following the "UpdatePeriod" parameter.
+   * following the "UpdatePeriod" parameter and, if the "UpdateOnCourseChange"
+   * parameter is true, when the course of a or b changes.
    *
    * \param a mobility model
    * \param b mobility model
@@ -541,25 +644,9 @@ private:
    */
   virtual double ComputePnlos (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b) const;
 
-  /**
-   * \brief Returns a unique and reciprocal key for the channel between a and b.
-   * \param a tx mobility model
-   * \param b rx mobility model
-   * \return channel key
-   */
-  static uint32_t GetKey (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b);
-
-  /**
-   * Struct to store the channel condition in the m_channelConditionMap
-   */
-  struct Item
-  {
-    Ptr<ChannelCondition> m_condition; //!< the channel condition
-    Time m_generatedTime; //!< the time when the condition was generated
-  };
-
-  std::unordered_map<uint32_t, Item> m_channelConditionMap; //!< map to store the channel conditions
+  mutable ChannelConditionStore m_channelConditions; //!< the channel conditions, used as cache
   Time m_updatePeriod; //!< the update period for the channel condition
+  bool m_updateOnCourseChange; //!< whether the channel condition is updated when the course of a node changes
 };
 
 /**
@@ -30,17 +30,50 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("JakesProcess");
 
-/// Represents a single oscillator
-JakesProcess::Oscillator::Oscillator (std::complex<double> amplitude, double initialPhase, double omega) :
-  m_amplitude (amplitude),
-  m_phase (initialPhase),
-  m_omega (omega)
-{}
+/// Number of samples after which the rotated oscillators are recomputed by JakesProcess::GetComplexGains
+static const uint32_t JAKES_RESYNC_SAMPLES = 1000;
 
-std::complex<double>
-JakesProcess::Oscillator::GetValueAt (Time at) const
+/**
+ * Compute the cosines of the phases of a set of oscillators at a given time.
+ *
+ * The phases are reduced to [-pi, pi] and folded to [0, pi/2], where the
+ * cosine is approximated by its Taylor polynomial of degree 16 (the error is
+ * below 1e-12). The loop has no branch and no library call, so that the
+ * compiler can vectorize it.
+ *
+ * \param omegas the rotation speeds of the oscillators
+ * \param t the time [s]
+ * \param phase the initial phase of the oscillators
+ * \param values the cosines
+ * \param n the number of oscillators
+ */
+static void
+ComputeCosines (const double *omegas, double t, double phase, double *values, std::size_t n)
 {
-  return (m_amplitude * std::cos (at.GetSeconds () * m_omega + m_phase));
+  // adding and subtracting 1.5 * 2^52 rounds to the nearest integer
+  const double round = 6755399441055744.0;
+  // 2 pi as the sum of two doubles, for an accurate reduction
+  const double twoPiHigh = 6.28318530717958623200;
+  const double twoPiLow = 2.44929359829470635445e-16;
+  for (std::size_t i = 0; i < n; i++)
+    {
+      double x = omegas[i] * t + phase;
+      double k = (x * (0.5 / M_PI) + round) - round;
+      double a = std::fabs ((x - k * twoPiHigh) - k * twoPiLow);
+      double sign = (a > M_PI_2 ? -1.0 : 1.0);
+      a = (a > M_PI_2 ? M_PI - a : a);
+      double a2 = a * a;
+      double c = 1.0 / 20922789888000.0;
+      c = c * a2 - 1.0 / 87178291200.0;
+      c = c * a2 + 1.0 / 479001600.0;
+      c = c * a2 - 1.0 / 3628800.0;
+      c = c * a2 + 1.0 / 40320.0;
+      c = c * a2 - 1.0 / 720.0;
+      c = c * a2 + 1.0 / 24.0;
+      c = c * a2 - 1.0 / 2.0;
+      c = c * a2 + 1.0;
+      values[i] = sign * c;
+    }
 }
 
 NS_OBJECT_ENSURE_REGISTERED (JakesProcess);
@@ -94,9 +127,12 @@ JakesProcess::ConstructOscillators ()
 {
   NS_ASSERT (m_jakes);
   // Initial phase is common for all oscillators:
-  double phi = m_jakes->GetUniformRandomVariable ()->GetValue ();
+  m_phase = m_jakes->GetUniformRandomVariable ()->GetValue ();
   // Theta is common for all oscillators:
   double theta = m_jakes->GetUniformRandomVariable ()->GetValue ();
+  m_amplitudesReal.clear ();
+  m_amplitudesImag.clear ();
+  m_omegas.clear ();
   for (unsigned int i = 0; i < m_nOscillators; i++)
     {
       unsigned int n = i + 1;
@@ -104,16 +140,17 @@ JakesProcess::ConstructOscillators ()
       /// 1a. Initiate \f[ \alpha_n = \frac{2\pi n - \pi + \theta}{4M},  n=1,2, \ldots,M\f], n is oscillatorNumber, M is m_nOscillators
       double alpha = (2.0 * M_PI * n - M_PI + theta) / (4.0 * m_nOscillators);
       /// 1b. Initiate rotation speed:
-      double omega = m_omegaDopplerMax * std::cos (alpha);
+      m_omegas.push_back (m_omegaDopplerMax * std::cos (alpha));
       /// 2. Initiate complex amplitude:
       double psi = m_jakes->GetUniformRandomVariable ()->GetValue ();
-      std::complex<double> amplitude = std::complex<double> (std::cos (psi), std::sin (psi)) * 2.0 / std::sqrt (m_nOscillators);
-      /// 3. Construct oscillator:
-      m_oscillators.push_back (Oscillator (amplitude, phi, omega)); 
+      m_amplitudesReal.push_back (std::cos (psi) * 2.0 / std::sqrt (m_nOscillators));
+      m_amplitudesImag.push_back (std::sin (psi) * 2.0 / std::sqrt (m_nOscillators));
     }
+  m_values.resize (m_nOscillators);
 }
 
 JakesProcess::JakesProcess () :
+  m_phase (0),
   m_omegaDopplerMax (0),
   m_nOscillators (0)
 {
@@ -121,7 +158,6 @@ JakesProcess::JakesProcess () :
 
 JakesProcess::~JakesProcess()
 {
-  m_oscillators.clear ();
 }
 
 void
@@ -133,18 +169,89 @@ JakesProcess::DoDispose ()
 std::complex<double>
 JakesProcess::GetComplexGain () const
 {
-  std::complex<double> sumAplitude = std::complex<double> (0, 0);
-  for (unsigned int i = 0; i < m_oscillators.size (); i++)
+  return GetComplexGain (Now ());
+}
+
+std::complex<double>
+JakesProcess::GetComplexGain (Time t) const
+{
+  std::size_t n = m_omegas.size ();
+  ComputeCosines (m_omegas.data (), t.GetSeconds (), m_phase, m_values.data (), n);
+  double real = 0;
+  double imag = 0;
+  for (std::size_t i = 0; i < n; i++)
+    {
+      real += m_amplitudesReal[i] * m_values[i];
+      imag += m_amplitudesImag[i] * m_values[i];
+    }
+  return std::complex<double> (real, imag);
+}
+
+std::vector<std::complex<double> >
+JakesProcess::GetComplexGains (Time start, Time step, uint32_t nSamples) const
+{
+  // each oscillator is a phasor, which is rotated by omega * step from one
+  // sample to the next; the phasors are recomputed periodically so that the
+  // rounding errors do not accumulate
+  std::size_t n = m_omegas.size ();
+  std::vector<double> phasorsReal (n);
+  std::vector<double> phasorsImag (n);
+  std::vector<double> rotationsReal (n);
+  std::vector<double> rotationsImag (n);
+  double t0 = start.GetSeconds ();
+  double dt = step.GetSeconds ();
+  for (std::size_t i = 0; i < n; i++)
     {
-      sumAplitude += m_oscillators[i].GetValueAt (Now ());
+      rotationsReal[i] = std::cos (m_omegas[i] * dt);
+      rotationsImag[i] = std::sin (m_omegas[i] * dt);
     }
-  return sumAplitude;
+
+  std::vector<std::complex<double> > gains;
+  gains.reserve (nSamples);
+  for (uint32_t s = 0; s < nSamples; s++)
+    {
+      if (s % JAKES_RESYNC_SAMPLES == 0)
+        {
+          double t = t0 + s * dt;
+          for (std::size_t i = 0; i < n; i++)
+            {
+              phasorsReal[i] = std::cos (m_omegas[i] * t + m_phase);
+              phasorsImag[i] = std::sin (m_omegas[i] * t + m_phase);
+            }
+        }
+      double real = 0;
+      double imag = 0;
+      for (std::size_t i = 0; i < n; i++)
+        {
+          real += m_amplitudesReal[i] * phasorsReal[i];
+          imag += m_amplitudesImag[i] * phasorsReal[i];
+        }
+      gains.push_back (std::complex<double> (real, imag));
+      for (std::size_t i = 0; i < n; i++)
+        {
+          double rotated = phasorsReal[i] * rotationsReal[i] - phasorsImag[i] * rotationsImag[i];
+          phasorsImag[i] = phasorsReal[i] * rotationsImag[i] + phasorsImag[i] * rotationsReal[i];
+          phasorsReal[i] = rotated;
+        }
+    }
+  return gains;
 }
 
 double
 JakesProcess::GetChannelGainDb () const
 {
-  std::complex<double> complexGain = GetComplexGain ();
+  return GetChannelGainDb (GetComplexGain ());
+}
+
+double
+JakesProcess::GetChannelGainDb (Time t) const
+{
+  return GetChannelGainDb (GetComplexGain (t));
+}
+
+double
+JakesProcess::GetChannelGainDb (std::complex<double> complexGain)
+{
   return (10 * std::log10 ((std::pow (complexGain.real (), 2) + std::pow (complexGain.imag (), 2)) / 2));
 }
 
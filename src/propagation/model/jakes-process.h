@@ -24,6 +24,7 @@
 #include "ns3/nstime.h"
 #include "ns3/random-variable-stream.h"
 #include <complex>
+#include <vector>
 
 namespace ns3
 {
@@ -69,11 +70,39 @@ public:
    * \return the channel complex gain
    */
   std::complex<double> GetComplexGain () const;
+  /**
+   * Get the channel complex gain at a given time
+   * \param t the time
+   * \return the channel complex gain
+   */
+  std::complex<double> GetComplexGain (Time t) const;
+  /**
+   * Get the channel complex gains at regularly spaced times. The
+   * oscillators are rotated from one sample to the next, which is much
+   * cheaper than evaluating them at every sample.
+   * \param start the time of the first sample
+   * \param step the time between two samples
+   * \param nSamples the number of samples
+   * \return the channel complex gains
+   */
+  std::vector<std::complex<double> > GetComplexGains (Time start, Time step, uint32_t nSamples) const;
   /**
    * Get the channel gain in dB
    * \return the channel gain [dB]
    */
   double GetChannelGainDb () const;
+  /**
+   * Get the channel gain in dB at a given time
+   * \param t the time
+   * \return the channel gain [dB]
+   */
+  double GetChannelGainDb (Time t) const;
+  /**
+   * Convert a channel complex gain to a channel gain in dB
+   * \param complexGain the channel complex gain
+   * \return the channel gain [dB]
+   */
+  static double GetChannelGainDb (std::complex<double> complexGain);
 
   /**
    * Set the propagation model using this class
@@ -81,30 +110,6 @@ public:
    */
   void SetPropagationLossModel (Ptr<const PropagationLossModel> model);
 private:
-  /**
-   * This class Represents a single oscillator
-   */
-  struct Oscillator
-  {
-    /**
-     * Initiate oscillator with complex amplitude, initial phase and rotation speed
-     * \param amplitude initial complex amplitude
-     * \param initialPhase initial phase
-     * \param omega rotation speed
-     */
-    Oscillator (std::complex<double> amplitude, double initialPhase, double omega);
-    /**
-     * Get the complex amplitude at a given moment
-     * \param t time instant
-     * \returns the complex amplitude
-     */
-    std::complex<double> GetValueAt (Time t) const;
-
-    std::complex<double> m_amplitude; //!< Complex number \f$Re=\cos(\psi_n), Im = i\sin(\psi_n)]\f$
-    double m_phase; //!< Phase \f$\phi_n\f$ of the oscillator
-    double m_omega; //!< Rotation speed of the oscillator \f$\omega_d \cos(\alpha_n)\f$
-  };
-private:
 
   /**
    * Set the number of Oscillators to use
@@ -123,7 +128,16 @@ private:
    */
   void ConstructOscillators ();
 private:
-  std::vector<Oscillator> m_oscillators; //!< Vector of oscillators
+  /*
+   * The oscillators are stored by columns, so that their values are
+   * computed by a loop which the compiler can vectorize. The initial phase
+   * \f$\phi\f$ is common to all the oscillators.
+   */
+  std::vector<double> m_amplitudesReal; //!< \f$\frac{2}{\sqrt{M}}\cos(\psi_n)\f$
+  std::vector<double> m_amplitudesImag; //!< \f$\frac{2}{\sqrt{M}}\sin(\psi_n)\f$
+  std::vector<double> m_omegas;         //!< Rotation speeds \f$\omega_d \cos(\alpha_n)\f$ of the oscillators
+  double m_phase;                       //!< Initial phase \f$\phi\f$ of the oscillators
+  mutable std::vector<double> m_values; //!< Values of the cosines of the oscillators, computed before the sums
   double m_omegaDopplerMax; //!< max rotation speed Doppler frequency
   unsigned int m_nOscillators;  //!< number of oscillators
   Ptr<UniformRandomVariable> m_uniformVariable; //!< random stream
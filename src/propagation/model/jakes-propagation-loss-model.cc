@@ -21,6 +21,7 @@
 #include "jakes-propagation-loss-model.h"
 #include "ns3/double.h"
 #include "ns3/log.h"
+#include "ns3/simulator.h"
 
 namespace ns3
 {
@@ -51,10 +52,8 @@ JakesPropagationLossModel::GetTypeId ()
   return tid;
 }
 
-double
-JakesPropagationLossModel::DoCalcRxPower (double txPowerDbm,
-                                          Ptr<MobilityModel> a,
-                                          Ptr<MobilityModel> b) const
+Ptr<JakesProcess>
+JakesPropagationLossModel::GetJakesProcess (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
 {
   Ptr<JakesProcess> pathData = m_propagationCache.GetPathData (a, b, 0 /**Spectrum model uid is not used in PropagationLossModel*/);
   if (pathData == 0)
@@ -63,7 +62,27 @@ JakesPropagationLossModel::DoCalcRxPower (double txPowerDbm,
       pathData->SetPropagationLossModel (this);
       m_propagationCache.AddPathData (pathData, a, b, 0 /**Spectrum model uid is not used in PropagationLossModel*/);
     }
-  return txPowerDbm + pathData->GetChannelGainDb ();
+  return pathData;
+}
+
+double
+JakesPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                          Ptr<MobilityModel> a,
+                                          Ptr<MobilityModel> b) const
+{
+  return txPowerDbm + GetJakesProcess (a, b)->GetChannelGainDb ();
+}
+
+void
+JakesPropagationLossModel::DoCalcRxPowers (const PropagationReceiverBatch &receivers,
+                                           double *powerDbm) const
+{
+  Ptr<MobilityModel> a = receivers.GetTransmitter ();
+  Time now = Simulator::Now ();
+  for (std::size_t i = 0; i < receivers.GetNReceivers (); i++)
+    {
+      powerDbm[i] += GetJakesProcess (a, receivers.GetReceiver (i))->GetChannelGainDb (now);
+    }
 }
 
 Ptr<UniformRandomVariable>
@@ -48,12 +48,24 @@ public:
   JakesPropagationLossModel (const JakesPropagationLossModel &) = delete;
   JakesPropagationLossModel & operator = (const JakesPropagationLossModel &) = delete;
 
+  /**
+   * Get the fading process of a link, which is created if needed. The
+   * process of the link (a, b) is the process of the link (b, a).
+   *
+   * \param a the mobility model of one end of the link
+   * \param b the mobility model of the other end of the link
+   * \return the fading process of the link
+   */
+  Ptr<JakesProcess> GetJakesProcess (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+
 private:
   friend class JakesProcess;
 
   double DoCalcRxPower (double txPowerDbm,
                         Ptr<MobilityModel> a,
                         Ptr<MobilityModel> b) const override;
+  void DoCalcRxPowers (const PropagationReceiverBatch &receivers,
+                       double *powerDbm) const override;
 
   int64_t DoAssignStreams (int64_t stream) override;
 
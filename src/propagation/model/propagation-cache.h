@@ -21,7 +21,7 @@
 #define PROPAGATION_CACHE_H_
 
 #include "ns3/mobility-model.h"
-#include <map>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -45,10 +45,10 @@ public:
    * \param modelUid model UID
    * \return the model
    */
-  Ptr<T> GetPathData (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
+  Ptr<T> GetPathData (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid) const
   {
     PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
-    typename PathCache::iterator it = m_pathCache.find (key);
+    typename PathCache::const_iterator it = m_pathCache.find (key);
     if (it == m_pathCache.end ())
       {
         return 0;
@@ -87,38 +87,42 @@ private:
     uint32_t m_spectrumModelUid; //!< model UID
 
     /**
-     * Less-than operator.
+     * Equality operator.
      *
-     * The goal of this operator is just to provide a stable comparison
-     * to be used in containers requiring a order (of any kind).
-     *
-     * If the models are different, the comparison is based on their Uid.
-     * Otherwise, the comparison is based on the pointers of the Mobility models.
+     * Links are supposed to be symmetrical, so that the order of the
+     * mobility models does not matter.
      *
      * \param other Right value of the operator.
-     * \returns True if the Left value is less than the Right value.
+     * \returns True if the two identifiers designate the same path.
+     */
+    bool operator == (const PropagationPathIdentifier & other) const
+    {
+      return m_spectrumModelUid == other.m_spectrumModelUid
+             && std::min (m_dstMobility, m_srcMobility) == std::min (other.m_dstMobility, other.m_srcMobility)
+             && std::max (m_dstMobility, m_srcMobility) == std::max (other.m_dstMobility, other.m_srcMobility);
+    }
+  };
+
+  /// Hash of a PropagationPathIdentifier, which does not depend on the order of the mobility models
+  struct PropagationPathIdentifierHash
+  {
+    /**
+     * \param key the path identifier
+     * \return the hash of the identifier
      */
-    bool operator < (const PropagationPathIdentifier & other) const
+    std::size_t operator () (const PropagationPathIdentifier & key) const
     {
-      if (m_spectrumModelUid != other.m_spectrumModelUid)
-        {
-          return m_spectrumModelUid < other.m_spectrumModelUid;
-        }
-      /// Links are supposed to be symmetrical!
-      if (std::min (m_dstMobility, m_srcMobility) != std::min (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::min (m_dstMobility, m_srcMobility) < std::min (other.m_dstMobility, other.m_srcMobility);
-        }
-      if (std::max (m_dstMobility, m_srcMobility) != std::max (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::max (m_dstMobility, m_srcMobility) < std::max (other.m_dstMobility, other.m_srcMobility);
-        }
-      return false;
+      std::size_t a = std::hash<const MobilityModel *> () (PeekPointer (key.m_srcMobility));
+      std::size_t b = std::hash<const MobilityModel *> () (PeekPointer (key.m_dstMobility));
+      std::size_t h = std::min (a, b);
+      h ^= std::max (a, b) + 0x9e3779b9 + (h << 6) + (h >> 2);
+      h ^= std::hash<uint32_t> () (key.m_spectrumModelUid) + 0x9e3779b9 + (h << 6) + (h >> 2);
+      return h;
     }
   };
 
   /// Typedef: PropagationPathIdentifier, Ptr<T>
-  typedef std::map<PropagationPathIdentifier, Ptr<T> > PathCache;
+  typedef std::unordered_map<PropagationPathIdentifier, Ptr<T>, PropagationPathIdentifierHash> PathCache;
 private:
   PathCache m_pathCache; //!< Path cache
 };
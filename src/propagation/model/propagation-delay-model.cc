@@ -41,6 +41,18 @@ PropagationDelayModel::~PropagationDelayModel ()
 {
 }
 
+void
+PropagationDelayModel::GetDelays (const PropagationReceiverBatch &receivers, std::vector<Time> &delays) const
+{
+  Ptr<MobilityModel> a = receivers.GetTransmitter ();
+  std::size_t n = receivers.GetNReceivers ();
+  delays.resize (n);
+  for (std::size_t i = 0; i < n; i++)
+    {
+      delays[i] = GetDelay (a, receivers.GetReceiver (i));
+    }
+}
+
 int64_t
 PropagationDelayModel::AssignStreams (int64_t stream)
 {
@@ -114,6 +126,17 @@ ConstantSpeedPropagationDelayModel::GetDelay (Ptr<MobilityModel> a, Ptr<Mobility
   return Seconds (seconds);
 }
 void
+ConstantSpeedPropagationDelayModel::GetDelays (const PropagationReceiverBatch &receivers, std::vector<Time> &delays) const
+{
+  const double *distance = receivers.GetDistances ();
+  std::size_t n = receivers.GetNReceivers ();
+  delays.resize (n);
+  for (std::size_t i = 0; i < n; i++)
+    {
+      delays[i] = Seconds (distance[i] / m_speed);
+    }
+}
+void
 ConstantSpeedPropagationDelayModel::SetSpeed (double speed)
 {
   m_speed = speed;
@@ -24,6 +24,8 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/propagation-receiver-batch.h"
+#include <vector>
 
 namespace ns3 {
 
@@ -52,6 +54,16 @@ public:
    * source and destination.
    */
   virtual Time GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const = 0;
+  /**
+   * \param receivers the transmitter and the receivers
+   * \param delays the propagation delay to every receiver, in the order
+   *               the receivers were added to the batch
+   *
+   * Calculate the propagation delays between a source and a set of
+   * destinations. The default implementation calls GetDelay for each
+   * receiver in turn.
+   */
+  virtual void GetDelays (const PropagationReceiverBatch &receivers, std::vector<Time> &delays) const;
   /**
    * If this delay model uses objects of type RandomVariableStream,
    * set the stream numbers to the integers starting with the offset
@@ -119,6 +131,7 @@ public:
    */
   ConstantSpeedPropagationDelayModel ();
   Time GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const override;
+  void GetDelays (const PropagationReceiverBatch &receivers, std::vector<Time> &delays) const override;
   /**
    * \param speed the new speed (m/s)
    */
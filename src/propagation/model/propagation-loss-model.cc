@@ -82,6 +82,29 @@ PropagationLossModel::CalcRxPower (double txPowerDbm,
   return self;
 }
 
+void
+PropagationLossModel::CalcRxPowers (double txPowerDbm,
+                                    const PropagationReceiverBatch &receivers,
+                                    std::vector<double> &rxPowerDbm) const
+{
+  rxPowerDbm.assign (receivers.GetNReceivers (), txPowerDbm);
+  for (const PropagationLossModel *model = this; model != 0; model = PeekPointer (model->m_next))
+    {
+      model->DoCalcRxPowers (receivers, rxPowerDbm.data ());
+    }
+}
+
+void
+PropagationLossModel::DoCalcRxPowers (const PropagationReceiverBatch &receivers,
+                                      double *powerDbm) const
+{
+  Ptr<MobilityModel> a = receivers.GetTransmitter ();
+  for (std::size_t i = 0; i < receivers.GetNReceivers (); i++)
+    {
+      powerDbm[i] = DoCalcRxPower (powerDbm[i], a, receivers.GetReceiver (i));
+    }
+}
+
 int64_t
 PropagationLossModel::AssignStreams (int64_t stream)
 {
@@ -255,7 +278,23 @@ FriisPropagationLossModel::DoCalcRxPower (double txPowerDbm,
    * L: system loss (unit-less)
    * lambda: wavelength (m)
    */
-  double distance = a->GetDistanceFrom (b);
+  return CalcRxPowerFromDistance (txPowerDbm, a->GetDistanceFrom (b));
+}
+
+void
+FriisPropagationLossModel::DoCalcRxPowers (const PropagationReceiverBatch &receivers,
+                                           double *powerDbm) const
+{
+  const double *distance = receivers.GetDistances ();
+  for (std::size_t i = 0; i < receivers.GetNReceivers (); i++)
+    {
+      powerDbm[i] = CalcRxPowerFromDistance (powerDbm[i], distance[i]);
+    }
+}
+
+double
+FriisPropagationLossModel::CalcRxPowerFromDistance (double txPowerDbm, double distance) const
+{
   if (distance < 3*m_lambda)
     {
       NS_LOG_WARN ("distance not within the far field region => inaccurate propagation loss value");
@@ -407,10 +446,32 @@ TwoRayGroundPropagationLossModel::DoCalcRxPower (double txPowerDbm,
     {
       return txPowerDbm;
     }
+  return CalcRxPowerFromDistance (txPowerDbm, distance, a->GetPosition ().z, b->GetPosition ().z);
+}
+
+void
+TwoRayGroundPropagationLossModel::DoCalcRxPowers (const PropagationReceiverBatch &receivers,
+                                                  double *powerDbm) const
+{
+  const double *distance = receivers.GetDistances ();
+  const double *rxZ = receivers.GetReceiversZ ();
+  double txZ = receivers.GetTransmitterPosition ().z;
+  for (std::size_t i = 0; i < receivers.GetNReceivers (); i++)
+    {
+      if (distance[i] > m_minDistance)
+        {
+          powerDbm[i] = CalcRxPowerFromDistance (powerDbm[i], distance[i], txZ, rxZ[i]);
+        }
+    }
+}
 
+double
+TwoRayGroundPropagationLossModel::CalcRxPowerFromDistance (double txPowerDbm, double distance,
+                                                           double txZ, double rxZ) const
+{
   // Set the height of the Tx and Rx antennae
-  double txAntHeight = a->GetPosition ().z + m_heightAboveZ;
-  double rxAntHeight = b->GetPosition ().z + m_heightAboveZ;
+  double txAntHeight = txZ + m_heightAboveZ;
+  double rxAntHeight = rxZ + m_heightAboveZ;
 
   // Calculate a crossover distance, under which we use Friis
   /*
@@ -508,7 +569,23 @@ LogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
                                                 Ptr<MobilityModel> a,
                                                 Ptr<MobilityModel> b) const
 {
-  double distance = a->GetDistanceFrom (b);
+  return CalcRxPowerFromDistance (txPowerDbm, a->GetDistanceFrom (b));
+}
+
+void
+LogDistancePropagationLossModel::DoCalcRxPowers (const PropagationReceiverBatch &receivers,
+                                                 double *powerDbm) const
+{
+  const double *distance = receivers.GetDistances ();
+  for (std::size_t i = 0; i < receivers.GetNReceivers (); i++)
+    {
+      powerDbm[i] = CalcRxPowerFromDistance (powerDbm[i], distance[i]);
+    }
+}
+
+double
+LogDistancePropagationLossModel::CalcRxPowerFromDistance (double txPowerDbm, double distance) const
+{
   if (distance <= m_referenceDistance)
     {
       return txPowerDbm - m_referenceLoss;
@@ -600,7 +677,23 @@ ThreeLogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
                                                      Ptr<MobilityModel> a,
                                                      Ptr<MobilityModel> b) const
 {
-  double distance = a->GetDistanceFrom (b);
+  return CalcRxPowerFromDistance (txPowerDbm, a->GetDistanceFrom (b));
+}
+
+void
+ThreeLogDistancePropagationLossModel::DoCalcRxPowers (const PropagationReceiverBatch &receivers,
+                                                      double *powerDbm) const
+{
+  const double *distance = receivers.GetDistances ();
+  for (std::size_t i = 0; i < receivers.GetNReceivers (); i++)
+    {
+      powerDbm[i] = CalcRxPowerFromDistance (powerDbm[i], distance[i]);
+    }
+}
+
+double
+ThreeLogDistancePropagationLossModel::CalcRxPowerFromDistance (double txPowerDbm, double distance) const
+{
   NS_ASSERT (distance >= 0);
 
   // See doxygen comments for the formula and explanation
@@ -924,6 +1017,17 @@ RangePropagationLossModel::DoCalcRxPower (double txPowerDbm,
     }
 }
 
+void
+RangePropagationLossModel::DoCalcRxPowers (const PropagationReceiverBatch &receivers,
+                                           double *powerDbm) const
+{
+  const double *distance = receivers.GetDistances ();
+  for (std::size_t i = 0; i < receivers.GetNReceivers (); i++)
+    {
+      powerDbm[i] = (distance[i] <= m_range) ? powerDbm[i] : -1000;
+    }
+}
+
 int64_t
 RangePropagationLossModel::DoAssignStreams (int64_t stream)
 {
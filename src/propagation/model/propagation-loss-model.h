@@ -27,6 +27,7 @@
 
 #include "ns3/object.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/propagation-receiver-batch.h"
 #include <map>
 
 namespace ns3 {
@@ -102,6 +103,20 @@ public:
                       Ptr<MobilityModel> a,
                       Ptr<MobilityModel> b) const;
 
+  /**
+   * Returns the Rx Power at every receiver of a batch, taking into account
+   * all the PropagationLossModel(s) chained to the current one. The result
+   * is the same as calling CalcRxPower for each receiver in turn.
+   *
+   * \param txPowerDbm current transmission power (in dBm)
+   * \param receivers the transmitter and the receivers
+   * \param rxPowerDbm the reception power at every receiver (in dBm), in the
+   *                   order the receivers were added to the batch
+   */
+  void CalcRxPowers (double txPowerDbm,
+                     const PropagationReceiverBatch &receivers,
+                     std::vector<double> &rxPowerDbm) const;
+
   /**
    * If this loss model uses objects of type RandomVariableStream,
    * set the stream numbers to the integers starting with the offset
@@ -139,6 +154,18 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const = 0;
+  /**
+   * Batch version of DoCalcRxPower. The default implementation calls
+   * DoCalcRxPower for each receiver; subclasses whose loss only depends on
+   * the positions can override it to process all the receivers at once.
+   *
+   * \param receivers the transmitter and the receivers
+   * \param powerDbm on input, the power transmitted to every receiver
+   *                 (in dBm); on output, the power received by every
+   *                 receiver (in dBm)
+   */
+  virtual void DoCalcRxPowers (const PropagationReceiverBatch &receivers,
+                               double *powerDbm) const;
 
   Ptr<PropagationLossModel> m_next; //!< Next propagation loss model in the list
 };
@@ -304,6 +331,16 @@ private:
   double DoCalcRxPower (double txPowerDbm,
                         Ptr<MobilityModel> a,
                         Ptr<MobilityModel> b) const override;
+  void DoCalcRxPowers (const PropagationReceiverBatch &receivers,
+                       double *powerDbm) const override;
+  /**
+   * Compute the reception power at a given distance
+   *
+   * \param txPowerDbm the transmission power (in dBm)
+   * \param distance the distance between the transmitter and the receiver (m)
+   * \return the reception power (in dBm)
+   */
+  double CalcRxPowerFromDistance (double txPowerDbm, double distance) const;
   int64_t DoAssignStreams (int64_t stream) override;
 
   /**
@@ -414,6 +451,18 @@ private:
   double DoCalcRxPower (double txPowerDbm,
                         Ptr<MobilityModel> a,
                         Ptr<MobilityModel> b) const override;
+  void DoCalcRxPowers (const PropagationReceiverBatch &receivers,
+                       double *powerDbm) const override;
+  /**
+   * Compute the reception power at a given distance, beyond the minimum distance
+   *
+   * \param txPowerDbm the transmission power (in dBm)
+   * \param distance the distance between the transmitter and the receiver (m)
+   * \param txZ the z coordinate of the transmitter (m)
+   * \param rxZ the z coordinate of the receiver (m)
+   * \return the reception power (in dBm)
+   */
+  double CalcRxPowerFromDistance (double txPowerDbm, double distance, double txZ, double rxZ) const;
   int64_t DoAssignStreams (int64_t stream) override;
 
   /**
@@ -492,6 +541,16 @@ private:
   double DoCalcRxPower (double txPowerDbm,
                         Ptr<MobilityModel> a,
                         Ptr<MobilityModel> b) const override;
+  void DoCalcRxPowers (const PropagationReceiverBatch &receivers,
+                       double *powerDbm) const override;
+  /**
+   * Compute the reception power at a given distance
+   *
+   * \param txPowerDbm the transmission power (in dBm)
+   * \param distance the distance between the transmitter and the receiver (m)
+   * \return the reception power (in dBm)
+   */
+  double CalcRxPowerFromDistance (double txPowerDbm, double distance) const;
 
   int64_t DoAssignStreams (int64_t stream) override;
 
@@ -566,6 +625,16 @@ private:
   double DoCalcRxPower (double txPowerDbm,
                         Ptr<MobilityModel> a,
                         Ptr<MobilityModel> b) const override;
+  void DoCalcRxPowers (const PropagationReceiverBatch &receivers,
+                       double *powerDbm) const override;
+  /**
+   * Compute the reception power at a given distance
+   *
+   * \param txPowerDbm the transmission power (in dBm)
+   * \param distance the distance between the transmitter and the receiver (m)
+   * \return the reception power (in dBm)
+   */
+  double CalcRxPowerFromDistance (double txPowerDbm, double distance) const;
 
   int64_t DoAssignStreams (int64_t stream) override;
 
@@ -771,6 +840,8 @@ private:
   double DoCalcRxPower (double txPowerDbm,
                         Ptr<MobilityModel> a,
                         Ptr<MobilityModel> b) const override;
+  void DoCalcRxPowers (const PropagationReceiverBatch &receivers,
+                       double *powerDbm) const override;
 
   int64_t DoAssignStreams (int64_t stream) override;
 
@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "propagation-receiver-batch.h"
+#include "ns3/mobility-model.h"
+#include "ns3/assert.h"
+#include <cmath>
+
+namespace ns3 {
+
+PropagationReceiverBatch::PropagationReceiverBatch ()
+  : m_distancesValid (false)
+{
+}
+
+void
+PropagationReceiverBatch::SetTransmitter (Ptr<MobilityModel> transmitter)
+{
+  NS_ASSERT (transmitter != 0);
+  m_transmitter = transmitter;
+  m_transmitterPosition = transmitter->GetPosition ();
+  m_receivers.clear ();
+  m_x.clear ();
+  m_y.clear ();
+  m_z.clear ();
+  m_distancesValid = false;
+}
+
+Ptr<MobilityModel>
+PropagationReceiverBatch::GetTransmitter (void) const
+{
+  return m_transmitter;
+}
+
+const Vector &
+PropagationReceiverBatch::GetTransmitterPosition (void) const
+{
+  return m_transmitterPosition;
+}
+
+void
+PropagationReceiverBatch::AddReceiver (Ptr<MobilityModel> receiver)
+{
+  NS_ASSERT (receiver != 0);
+  Vector position = receiver->GetPosition ();
+  m_receivers.push_back (receiver);
+  m_x.push_back (position.x);
+  m_y.push_back (position.y);
+  m_z.push_back (position.z);
+  m_distancesValid = false;
+}
+
+std::size_t
+PropagationReceiverBatch::GetNReceivers (void) const
+{
+  return m_receivers.size ();
+}
+
+Ptr<MobilityModel>
+PropagationReceiverBatch::GetReceiver (std::size_t i) const
+{
+  return m_receivers[i];
+}
+
+const double *
+PropagationReceiverBatch::GetReceiversX (void) const
+{
+  return m_x.data ();
+}
+
+const double *
+PropagationReceiverBatch::GetReceiversY (void) const
+{
+  return m_y.data ();
+}
+
+const double *
+PropagationReceiverBatch::GetReceiversZ (void) const
+{
+  return m_z.data ();
+}
+
+const double *
+PropagationReceiverBatch::GetDistances (void) const
+{
+  if (!m_distancesValid)
+    {
+      std::size_t n = m_receivers.size ();
+      m_distances.resize (n);
+      const double *x = m_x.data ();
+      const double *y = m_y.data ();
+      const double *z = m_z.data ();
+      double *d = m_distances.data ();
+      double tx = m_transmitterPosition.x;
+      double ty = m_transmitterPosition.y;
+      double tz = m_transmitterPosition.z;
+      // same operations as CalculateDistance, in a loop the compiler can vectorize
+      for (std::size_t i = 0; i < n; i++)
+        {
+          double dx = x[i] - tx;
+          double dy = y[i] - ty;
+          double dz = z[i] - tz;
+          d[i] = std::sqrt (dx * dx + dy * dy + dz * dz);
+        }
+      m_distancesValid = true;
+    }
+  return m_distances.data ();
+}
+
+} // namespace ns3
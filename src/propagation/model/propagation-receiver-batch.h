@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PROPAGATION_RECEIVER_BATCH_H
+#define PROPAGATION_RECEIVER_BATCH_H
+
+#include "ns3/ptr.h"
+#include "ns3/vector.h"
+#include <vector>
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup propagation
+ *
+ * \brief A transmitter and the set of receivers of a one-to-many
+ * propagation computation
+ *
+ * This class is the argument of the batch methods of the propagation loss
+ * and delay models (PropagationLossModel::CalcRxPowers and
+ * PropagationDelayModel::GetDelays). The positions of the receivers are
+ * read once when they are added and stored in one contiguous array per
+ * coordinate, so that models only depending on the positions can process
+ * all the receivers in a tight loop. The distances between the transmitter
+ * and the receivers are computed on first use and shared by all the models.
+ * The mobility models of the receivers are kept for the models that need
+ * them.
+ */
+class PropagationReceiverBatch
+{
+public:
+  PropagationReceiverBatch ();
+
+  /**
+   * Set the transmitter and remove all the receivers.
+   *
+   * \param transmitter the mobility model of the transmitter
+   */
+  void SetTransmitter (Ptr<MobilityModel> transmitter);
+  /**
+   * \return the mobility model of the transmitter
+   */
+  Ptr<MobilityModel> GetTransmitter (void) const;
+  /**
+   * \return the position of the transmitter
+   */
+  const Vector & GetTransmitterPosition (void) const;
+  /**
+   * Add a receiver.
+   *
+   * \param receiver the mobility model of the receiver
+   */
+  void AddReceiver (Ptr<MobilityModel> receiver);
+  /**
+   * \return the number of receivers
+   */
+  std::size_t GetNReceivers (void) const;
+  /**
+   * \param i the index of the receiver
+   * \return the mobility model of the i-th receiver
+   */
+  Ptr<MobilityModel> GetReceiver (std::size_t i) const;
+  /**
+   * \return the x coordinates of the receivers
+   */
+  const double * GetReceiversX (void) const;
+  /**
+   * \return the y coordinates of the receivers
+   */
+  const double * GetReceiversY (void) const;
+  /**
+   * \return the z coordinates of the receivers
+   */
+  const double * GetReceiversZ (void) const;
+  /**
+   * The distances are equal to the value returned by
+   * MobilityModel::GetDistanceFrom.
+   *
+   * \return the distances (m) between the transmitter and the receivers
+   */
+  const double * GetDistances (void) const;
+
+private:
+  Ptr<MobilityModel> m_transmitter;               //!< mobility model of the transmitter
+  Vector m_transmitterPosition;                   //!< position of the transmitter
+  std::vector<Ptr<MobilityModel> > m_receivers;   //!< mobility models of the receivers
+  std::vector<double> m_x;                        //!< x coordinates of the receivers
+  std::vector<double> m_y;                        //!< y coordinates of the receivers
+  std::vector<double> m_z;                        //!< z coordinates of the receivers
+  mutable std::vector<double> m_distances;        //!< distances between the transmitter and the receivers
+  mutable bool m_distancesValid;                  //!< whether m_distances is up to date
+};
+
+} // namespace ns3
+
+#endif /* PROPAGATION_RECEIVER_BATCH_H */
@@ -22,6 +22,7 @@
 #include "ns3/test.h"
 #include "ns3/config.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/channel-condition-model.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/simulator.h"
@@ -264,6 +265,98 @@ ThreeGppChannelConditionModelTestCase::DoRun (void)
     }
 }
 
+/**
+ * \ingroup propagation-tests
+ *
+ * Test case for the ChannelConditionStore and its use by the 3GPP channel
+ * condition models. It checks that the stored conditions are reciprocal and
+ * that they are invalidated when the course of a node changes, if requested.
+ */
+class ChannelConditionStoreTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  ChannelConditionStoreTestCase ();
+
+  /**
+   * Destructor
+   */
+  virtual ~ChannelConditionStoreTestCase ();
+
+private:
+  /**
+   * Builds the simulation scenario and perform the tests
+   */
+  virtual void DoRun (void);
+};
+
+ChannelConditionStoreTestCase::ChannelConditionStoreTestCase ()
+  : TestCase ("Test case for the ChannelConditionStore")
+{}
+
+ChannelConditionStoreTestCase::~ChannelConditionStoreTestCase ()
+{}
+
+void
+ChannelConditionStoreTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+  std::vector<Ptr<MobilityModel> > mobilityModels;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (100.0 * i, 0.0, 1.5));
+      nodes.Get (i)->AggregateObject (mobility);
+      mobilityModels.push_back (mobility);
+    }
+  Ptr<MobilityModel> a = mobilityModels[0];
+  Ptr<MobilityModel> b = mobilityModels[1];
+  Ptr<MobilityModel> c = mobilityModels[2];
+
+  ChannelConditionStore store;
+  Ptr<ChannelCondition> cond = CreateObject<ChannelCondition> (ChannelCondition::LOS);
+  NS_TEST_ASSERT_MSG_EQ (store.Lookup (a, b, Seconds (0), true), nullptr, "The store should be empty");
+  store.Store (a, b, cond);
+  NS_TEST_ASSERT_MSG_EQ (store.Lookup (a, b, Seconds (0), true), cond, "The stored condition should be found");
+  NS_TEST_ASSERT_MSG_EQ (store.Lookup (b, a, Seconds (0), true), cond, "The stored condition should be reciprocal");
+  NS_TEST_ASSERT_MSG_EQ (store.Lookup (a, c, Seconds (0), true), nullptr, "No condition was stored for this channel");
+  store.Store (b, c, CreateObject<ChannelCondition> (ChannelCondition::NLOS));
+  NS_TEST_ASSERT_MSG_EQ (store.GetSize (), 2, "Unexpected number of stored conditions");
+
+  // a course change invalidates the conditions of the channels of the node
+  // only if the course is checked
+  b->SetPosition (Vector (150.0, 0.0, 1.5));
+  NS_TEST_ASSERT_MSG_EQ (store.Lookup (a, b, Seconds (0), false), cond, "The condition should still be valid");
+  NS_TEST_ASSERT_MSG_EQ (store.Lookup (a, b, Seconds (0), true), nullptr, "The condition should be invalidated");
+  NS_TEST_ASSERT_MSG_EQ (store.Lookup (c, b, Seconds (0), true), nullptr, "The condition should be invalidated");
+  NS_TEST_ASSERT_MSG_EQ (store.GetSize (), 0, "The invalidated conditions should be removed");
+  store.Store (a, b, cond);
+  store.Clear ();
+  NS_TEST_ASSERT_MSG_EQ (store.GetSize (), 0, "The store should be empty");
+
+  // by default, the 3GPP models keep the channel condition until it expires
+  Ptr<ThreeGppChannelConditionModel> condModel = CreateObject<ThreeGppUmaChannelConditionModel> ();
+  condModel->PrecomputeChannelConditions (nodes);
+  cond = condModel->GetChannelCondition (a, b);
+  NS_TEST_ASSERT_MSG_EQ (condModel->GetChannelCondition (b, a), cond, "The channel condition should be reused");
+  a->SetPosition (Vector (0.0, 10.0, 1.5));
+  NS_TEST_ASSERT_MSG_EQ (condModel->GetChannelCondition (a, b), cond, "The channel condition should be reused");
+
+  condModel = CreateObject<ThreeGppUmaChannelConditionModel> ();
+  condModel->SetAttribute ("UpdateOnCourseChange", BooleanValue (true));
+  cond = condModel->GetChannelCondition (a, b);
+  NS_TEST_ASSERT_MSG_EQ (condModel->GetChannelCondition (a, b), cond, "The channel condition should be reused");
+  a->SetPosition (Vector (0.0, 20.0, 1.5));
+  Ptr<ChannelCondition> newCond = condModel->GetChannelCondition (b, a);
+  NS_TEST_ASSERT_MSG_NE (newCond, cond, "The channel condition should be updated");
+  NS_TEST_ASSERT_MSG_EQ (condModel->GetChannelCondition (a, b), newCond, "The channel condition should be reused");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup propagation-tests
  *
@@ -279,6 +372,7 @@ ChannelConditionModelsTestSuite::ChannelConditionModelsTestSuite ()
   : TestSuite ("propagation-channel-condition-model", UNIT)
 {
   AddTestCase (new ThreeGppChannelConditionModelTestCase, TestCase::QUICK);
+  AddTestCase (new ChannelConditionStoreTestCase, TestCase::QUICK);
 }
 
 /// Static variable for test initialization
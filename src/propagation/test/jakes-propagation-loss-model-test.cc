@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/jakes-propagation-loss-model.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("JakesPropagationLossModelTest");
+
+/**
+ * \ingroup propagation-tests
+ *
+ * \brief Check that the complex gains computed at regularly spaced times by
+ * JakesProcess::GetComplexGains are equal to the gains computed at each time
+ * by JakesProcess::GetComplexGain.
+ */
+class JakesProcessComplexGainsTestCase : public TestCase
+{
+public:
+  JakesProcessComplexGainsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+JakesProcessComplexGainsTestCase::JakesProcessComplexGainsTestCase ()
+  : TestCase ("Check the complex gains of a Jakes process at regularly spaced times")
+{
+}
+
+void
+JakesProcessComplexGainsTestCase::DoRun (void)
+{
+  Ptr<JakesPropagationLossModel> loss = CreateObject<JakesPropagationLossModel> ();
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<JakesProcess> process = loss->GetJakesProcess (a, b);
+  process->SetAttribute ("DopplerFrequencyHz", DoubleValue (200));
+  process->SetAttribute ("NumberOfOscillators", UintegerValue (50));
+  process->SetPropagationLossModel (loss);
+
+  Time start = Seconds (3.5);
+  Time step = MicroSeconds (250);
+  uint32_t nSamples = 5000;
+  std::vector<std::complex<double> > gains = process->GetComplexGains (start, step, nSamples);
+  NS_TEST_ASSERT_MSG_EQ (gains.size (), nSamples, "Wrong number of samples");
+  for (uint32_t s = 0; s < nSamples; s++)
+    {
+      std::complex<double> gain = process->GetComplexGain (start + step * s);
+      NS_TEST_ASSERT_MSG_EQ_TOL (gains[s].real (), gain.real (), 1e-9, "Wrong real part of sample " << s);
+      NS_TEST_ASSERT_MSG_EQ_TOL (gains[s].imag (), gain.imag (), 1e-9, "Wrong imaginary part of sample " << s);
+    }
+}
+
+/**
+ * \ingroup propagation-tests
+ *
+ * \brief Check the gains of the links of a JakesPropagationLossModel: they
+ * are symmetric, CalcRxPowers gives the same powers as CalcRxPower and the
+ * mean gain is 0 dB.
+ */
+class JakesPropagationLossModelLinksTestCase : public TestCase
+{
+public:
+  JakesPropagationLossModelLinksTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the gains of the links at the current time
+   * \param loss the propagation loss model
+   * \param nodes the mobility models of the nodes, each linked with all the others
+   */
+  void CheckGains (Ptr<JakesPropagationLossModel> loss, std::vector<Ptr<MobilityModel> > nodes);
+
+  double m_sum;      //!< sum of the linear gains
+  uint32_t m_nGains; //!< number of gains in m_sum
+};
+
+JakesPropagationLossModelLinksTestCase::JakesPropagationLossModelLinksTestCase ()
+  : TestCase ("Check the gains of the links of a Jakes propagation loss model"),
+    m_sum (0),
+    m_nGains (0)
+{
+}
+
+void
+JakesPropagationLossModelLinksTestCase::CheckGains (Ptr<JakesPropagationLossModel> loss, std::vector<Ptr<MobilityModel> > nodes)
+{
+  for (uint32_t i = 0; i < nodes.size (); i++)
+    {
+      PropagationReceiverBatch receivers;
+      receivers.SetTransmitter (nodes[i]);
+      for (uint32_t j = 0; j < nodes.size (); j++)
+        {
+          if (j != i)
+            {
+              receivers.AddReceiver (nodes[j]);
+            }
+        }
+      std::vector<double> rxPowers;
+      loss->CalcRxPowers (10, receivers, rxPowers);
+      NS_TEST_ASSERT_MSG_EQ (rxPowers.size (), receivers.GetNReceivers (), "Wrong number of powers");
+      for (uint32_t k = 0; k < receivers.GetNReceivers (); k++)
+        {
+          Ptr<MobilityModel> receiver = receivers.GetReceiver (k);
+          double rxPower = loss->CalcRxPower (10, nodes[i], receiver);
+          NS_TEST_ASSERT_MSG_EQ_TOL (rxPowers[k], rxPower, 1e-12, "CalcRxPowers differs from CalcRxPower");
+          rxPower = loss->CalcRxPower (10, receiver, nodes[i]);
+          NS_TEST_ASSERT_MSG_EQ_TOL (rxPowers[k], rxPower, 1e-12, "The gain is not symmetric");
+          m_sum += std::pow (10, (rxPowers[k] - 10) / 10);
+          m_nGains++;
+        }
+    }
+}
+
+void
+JakesPropagationLossModelLinksTestCase::DoRun (void)
+{
+  Ptr<JakesPropagationLossModel> loss = CreateObject<JakesPropagationLossModel> ();
+  std::vector<Ptr<MobilityModel> > nodes;
+  for (uint32_t i = 0; i < 40; i++)
+    {
+      nodes.push_back (CreateObject<ConstantPositionMobilityModel> ());
+    }
+
+  for (uint32_t k = 0; k < 10; k++)
+    {
+      Simulator::Schedule (Seconds (0.37 * k), &JakesPropagationLossModelLinksTestCase::CheckGains, this, loss, nodes);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_nGains, 10 * nodes.size () * (nodes.size () - 1), "Some gains were not checked");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_sum / m_nGains, 1, 0.05, "The mean linear gain is not 1");
+}
+
+/**
+ * \ingroup propagation-tests
+ *
+ * \brief Jakes propagation loss model test suite
+ */
+class JakesPropagationLossModelTestSuite : public TestSuite
+{
+public:
+  JakesPropagationLossModelTestSuite ();
+};
+
+JakesPropagationLossModelTestSuite::JakesPropagationLossModelTestSuite ()
+  : TestSuite ("jakes-propagation-loss-model", UNIT)
+{
+  AddTestCase (new JakesProcessComplexGainsTestCase, TestCase::QUICK);
+  AddTestCase (new JakesPropagationLossModelLinksTestCase, TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static JakesPropagationLossModelTestSuite g_jakesPropagationLossModelTestSuite;
@@ -21,8 +21,14 @@
 #include "ns3/test.h"
 #include "ns3/config.h"
 #include "ns3/double.h"
+#include "ns3/uinteger.h"
 #include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/cached-propagation-loss-model.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/mobility-trace-data.h"
+#include "ns3/trace-mobility-model.h"
 #include "ns3/simulator.h"
 
 using namespace ns3;
@@ -473,6 +479,253 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup propagation-tests
+ *
+ * \brief CachedPropagationLossModel Test
+ */
+class CachedPropagationLossModelTestCase : public TestCase
+{
+public:
+  CachedPropagationLossModelTestCase ();
+  virtual ~CachedPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CachedPropagationLossModelTestCase::CachedPropagationLossModelTestCase ()
+  : TestCase ("Test CachedPropagationLossModel")
+{
+}
+
+CachedPropagationLossModelTestCase::~CachedPropagationLossModelTestCase ()
+{
+}
+
+void
+CachedPropagationLossModelTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0,0,0));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (100,0,0));
+  Ptr<MobilityModel> c = CreateObject<ConstantPositionMobilityModel> ();
+  c->SetPosition (Vector (0,200,0));
+  Ptr<ConstantVelocityMobilityModel> d = CreateObject<ConstantVelocityMobilityModel> ();
+  d->SetPosition (Vector (0,0,50));
+  d->SetVelocity (Vector (10,0,0));
+
+  Ptr<LogDistancePropagationLossModel> reference = CreateObject<LogDistancePropagationLossModel> ();
+  Ptr<CachedPropagationLossModel> cached = CreateObject<CachedPropagationLossModel> ();
+  cached->SetModel (CreateObject<LogDistancePropagationLossModel> ());
+  cached->SetAttribute ("MaxEntries", UintegerValue (2));
+
+  double txPowerDbm = 16.0206;
+  NS_TEST_ASSERT_MSG_EQ (cached->CalcRxPower (txPowerDbm, a, b), reference->CalcRxPower (txPowerDbm, a, b), "Unexpected loss a -> b");
+  NS_TEST_ASSERT_MSG_EQ (cached->CalcRxPower (txPowerDbm, a, b), reference->CalcRxPower (txPowerDbm, a, b), "Unexpected cached loss a -> b");
+  double rxPowerDbm = cached->CalcRxPower (0, a, b);
+  NS_TEST_ASSERT_MSG_EQ_TOL (rxPowerDbm, reference->CalcRxPower (0, a, b), 1e-9, "Cached loss should not depend on the transmit power");
+  NS_TEST_ASSERT_MSG_EQ (cached->GetCacheMisses (), 1, "Expected a single computation of the loss a -> b");
+  NS_TEST_ASSERT_MSG_EQ (cached->GetCacheHits (), 2, "Expected the loss a -> b to be reused");
+
+  // the loss must be recomputed when a node moves
+  b->SetPosition (Vector (50,0,0));
+  NS_TEST_ASSERT_MSG_EQ (cached->CalcRxPower (txPowerDbm, a, b), reference->CalcRxPower (txPowerDbm, a, b), "Stale loss a -> b");
+  NS_TEST_ASSERT_MSG_EQ (cached->GetCacheMisses (), 2, "Expected the loss a -> b to be recomputed");
+  NS_TEST_ASSERT_MSG_EQ (cached->GetCacheSize (), 1, "Unexpected number of cache entries");
+
+  // the loss is never cached for moving nodes
+  rxPowerDbm = cached->CalcRxPower (txPowerDbm, a, d);
+  NS_TEST_ASSERT_MSG_EQ (rxPowerDbm, reference->CalcRxPower (txPowerDbm, a, d), "Unexpected loss a -> d");
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (cached->CalcRxPower (txPowerDbm, a, d), reference->CalcRxPower (txPowerDbm, a, d), "Stale loss a -> d");
+  NS_TEST_ASSERT_MSG_LT (cached->CalcRxPower (txPowerDbm, a, d), rxPowerDbm, "Node d should have moved away");
+  NS_TEST_ASSERT_MSG_EQ (cached->GetCacheSize (), 1, "Moving nodes should not be cached");
+
+  // the least recently used pair is evicted
+  cached->CalcRxPower (txPowerDbm, a, c);
+  cached->CalcRxPower (txPowerDbm, a, b);
+  cached->CalcRxPower (txPowerDbm, b, c);
+  NS_TEST_ASSERT_MSG_EQ (cached->GetCacheSize (), 2, "Cache size should be bounded");
+  uint64_t misses = cached->GetCacheMisses ();
+  cached->CalcRxPower (txPowerDbm, a, b);
+  NS_TEST_ASSERT_MSG_EQ (cached->GetCacheMisses (), misses, "Pair a -> b should still be cached");
+  cached->CalcRxPower (txPowerDbm, a, c);
+  NS_TEST_ASSERT_MSG_EQ (cached->GetCacheMisses (), misses + 1, "Pair a -> c should have been evicted");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup propagation-tests
+ *
+ * \brief Check that CachedPropagationLossModel recomputes the loss when a
+ * node following a trace moves between still periods
+ */
+class CachedPropagationLossModelTraceTestCase : public TestCase
+{
+public:
+  CachedPropagationLossModelTraceTestCase ();
+  virtual ~CachedPropagationLossModelTraceTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the cached loss against the reference loss
+   * \param cached the cached model
+   * \param reference the reference model
+   * \param a the first mobility model
+   * \param b the second mobility model
+   */
+  void Check (Ptr<PropagationLossModel> cached, Ptr<PropagationLossModel> reference,
+              Ptr<MobilityModel> a, Ptr<MobilityModel> b);
+};
+
+CachedPropagationLossModelTraceTestCase::CachedPropagationLossModelTraceTestCase ()
+  : TestCase ("Test CachedPropagationLossModel with TraceMobilityModel")
+{
+}
+
+CachedPropagationLossModelTraceTestCase::~CachedPropagationLossModelTraceTestCase ()
+{
+}
+
+void
+CachedPropagationLossModelTraceTestCase::Check (Ptr<PropagationLossModel> cached,
+                                                Ptr<PropagationLossModel> reference,
+                                                Ptr<MobilityModel> a, Ptr<MobilityModel> b)
+{
+  NS_TEST_ASSERT_MSG_EQ_TOL (cached->CalcRxPower (0, a, b), reference->CalcRxPower (0, a, b), 1e-9,
+                             "Stale loss at " << Simulator::Now ().As (Time::S));
+}
+
+void
+CachedPropagationLossModelTraceTestCase::DoRun (void)
+{
+  // the node stays at 10 m, then jumps to 1000 m and stays there
+  Ptr<MobilityTraceData> trace = Create<MobilityTraceData> ();
+  trace->AddSample (0, Seconds (0), Vector (10, 0, 0));
+  trace->AddSample (0, Seconds (10), Vector (10, 0, 0));
+  trace->AddSample (0, Seconds (20), Vector (1000, 0, 0));
+  trace->AddSample (0, Seconds (30), Vector (1000, 0, 0));
+  trace->Finalize ();
+  Ptr<TraceMobilityModel> b = CreateObject<TraceMobilityModel> ();
+  b->SetTrace (trace, 0);
+  b->Initialize ();
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0, 0, 0));
+
+  Ptr<FriisPropagationLossModel> reference = CreateObject<FriisPropagationLossModel> ();
+  Ptr<CachedPropagationLossModel> cached = CreateObject<CachedPropagationLossModel> ();
+  cached->SetModel (CreateObject<FriisPropagationLossModel> ());
+
+  for (double t : {5.0, 8.0, 15.0, 25.0, 28.0, 35.0})
+    {
+      Simulator::Schedule (Seconds (t), &CachedPropagationLossModelTraceTestCase::Check, this,
+                           cached, reference, a, b);
+    }
+  // the position set explicitly is used until the next sample
+  Simulator::Schedule (Seconds (26), &MobilityModel::SetPosition, b, Vector (100, 0, 0));
+  Simulator::Schedule (Seconds (29), &CachedPropagationLossModelTraceTestCase::Check, this,
+                       cached, reference, a, b);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup propagation-tests
+ *
+ * \brief Check that the batch methods of the propagation loss and delay
+ * models return the same values as their per-receiver counterparts
+ */
+class PropagationBatchTestCase : public TestCase
+{
+public:
+  PropagationBatchTestCase ();
+  virtual ~PropagationBatchTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the batch computation of a loss model against CalcRxPower
+   * \param model the propagation loss model
+   * \param receivers the transmitter and the receivers
+   */
+  void CheckLoss (Ptr<PropagationLossModel> model, const PropagationReceiverBatch &receivers);
+};
+
+PropagationBatchTestCase::PropagationBatchTestCase ()
+  : TestCase ("Test the batch propagation loss and delay computations")
+{
+}
+
+PropagationBatchTestCase::~PropagationBatchTestCase ()
+{
+}
+
+void
+PropagationBatchTestCase::CheckLoss (Ptr<PropagationLossModel> model, const PropagationReceiverBatch &receivers)
+{
+  double txPowerDbm = 20;
+  std::vector<double> rxPowerDbm;
+  model->CalcRxPowers (txPowerDbm, receivers, rxPowerDbm);
+  NS_TEST_ASSERT_MSG_EQ (rxPowerDbm.size (), receivers.GetNReceivers (), "Unexpected number of results");
+  for (std::size_t i = 0; i < receivers.GetNReceivers (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (rxPowerDbm[i],
+                             model->CalcRxPower (txPowerDbm, receivers.GetTransmitter (), receivers.GetReceiver (i)),
+                             model->GetInstanceTypeId ().GetName () << ": unexpected rx power for receiver " << i);
+    }
+}
+
+void
+PropagationBatchTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> tx = CreateObject<ConstantPositionMobilityModel> ();
+  tx->SetPosition (Vector (0, 0, 1.5));
+  PropagationReceiverBatch receivers;
+  receivers.SetTransmitter (tx);
+  // receivers in every distance field of the models, including co-located
+  double distances[] = {0, 0.3, 1, 2.5, 10, 80, 150, 199.9, 250, 300, 600, 1000, 5000};
+  for (double d : distances)
+    {
+      Ptr<MobilityModel> rx = CreateObject<ConstantPositionMobilityModel> ();
+      rx->SetPosition (Vector (d * 0.6, d * 0.8, 1 + d / 1000));
+      receivers.AddReceiver (rx);
+      NS_TEST_ASSERT_MSG_EQ (receivers.GetDistances ()[receivers.GetNReceivers () - 1], tx->GetDistanceFrom (rx),
+                             "Unexpected distance");
+    }
+
+  CheckLoss (CreateObject<FriisPropagationLossModel> (), receivers);
+  CheckLoss (CreateObject<TwoRayGroundPropagationLossModel> (), receivers);
+  CheckLoss (CreateObject<LogDistancePropagationLossModel> (), receivers);
+  CheckLoss (CreateObject<ThreeLogDistancePropagationLossModel> (), receivers);
+  CheckLoss (CreateObject<RangePropagationLossModel> (), receivers);
+
+  // a chain mixing batch implementations and the default implementation
+  Ptr<LogDistancePropagationLossModel> chain = CreateObject<LogDistancePropagationLossModel> ();
+  Ptr<MatrixPropagationLossModel> matrix = CreateObject<MatrixPropagationLossModel> ();
+  matrix->SetDefaultLoss (3);
+  matrix->SetLoss (tx, receivers.GetReceiver (4), 10);
+  chain->SetNext (matrix);
+  matrix->SetNext (CreateObject<RangePropagationLossModel> ());
+  CheckLoss (chain, receivers);
+
+  Ptr<ConstantSpeedPropagationDelayModel> delayModel = CreateObject<ConstantSpeedPropagationDelayModel> ();
+  std::vector<Time> delays;
+  delayModel->GetDelays (receivers, delays);
+  NS_TEST_ASSERT_MSG_EQ (delays.size (), receivers.GetNReceivers (), "Unexpected number of delays");
+  for (std::size_t i = 0; i < receivers.GetNReceivers (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (delays[i], delayModel->GetDelay (tx, receivers.GetReceiver (i)),
+                             "Unexpected delay for receiver " << i);
+    }
+
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup propagation-tests
  *
@@ -484,6 +737,8 @@ RangePropagationLossModelTestCase::DoRun (void)
  *   - LogDistancePropagationLossModel
  *   - MatrixPropagationLossModel
  *   - RangePropagationLossModel
+ *   - CachedPropagationLossModel
+ *   - batch computation of the propagation loss and delay
  */
 class PropagationLossModelsTestSuite : public TestSuite
 {
@@ -499,6 +754,9 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new CachedPropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new CachedPropagationLossModelTraceTestCase, TestCase::QUICK);
+  AddTestCase (new PropagationBatchTestCase, TestCase::QUICK);
 }
 
 /// Static variable for test initialization
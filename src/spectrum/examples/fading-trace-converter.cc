@@ -0,0 +1,60 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * This program converts a text fading trace, as written by
+ * src/lte/model/fading-traces/fading_trace_generator.m, to the binary format
+ * of FadingTrace, which is mapped in memory and shared by all the
+ * TraceFadingLossModel instances. The samples can be stored as single or as
+ * half-precision numbers.
+ *
+ * Example:
+ *   ./ns3 run "fading-trace-converter --input=fading_trace_EPA_3kmph.fad
+ *              --output=fading_trace_EPA_3kmph.bin --half=1"
+ *
+ * and then, in the simulation program:
+ *   lteHelper->SetFadingModelAttribute ("TraceFilename", StringValue ("fading_trace_EPA_3kmph.bin"));
+ */
+
+#include <iostream>
+#include "ns3/core-module.h"
+#include "ns3/fading-trace.h"
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+  bool half = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("input", "The text fading trace file", input);
+  cmd.AddValue ("output", "The binary fading trace file", output);
+  cmd.AddValue ("half", "Store the samples as half-precision numbers", half);
+  cmd.Parse (argc, argv);
+
+  if (input.empty () || output.empty ())
+    {
+      NS_FATAL_ERROR ("The input and the output files must be given");
+    }
+
+  FadingTrace::ConvertText (input, output, half ? FadingTrace::FLOAT16 : FadingTrace::FLOAT32);
+  std::cout << input << " converted to " << output << std::endl;
+
+  return 0;
+}
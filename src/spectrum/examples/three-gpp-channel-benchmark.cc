@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * This program measures the cost of the generation of the channel matrices
+ * by the ThreeGppChannelModel, for a number of gNB-UE links (100 by
+ * default: 4 gNBs with 8x8 antenna arrays and 25 UEs with 4x4 antenna
+ * arrays).
+ *
+ * The channel matrices of all the links are requested once per
+ * UpdatePeriod, after they expired. If "pregenerate" is
+ * true, the first request regenerates the channel matrices of all the links
+ * using "numThreads" threads; otherwise, each matrix is regenerated when it
+ * is requested.
+ *
+ * The wall clock time per update period (in milliseconds) is printed.
+ */
+
+#include <iostream>
+#include <chrono>
+#include "ns3/core-module.h"
+#include "ns3/node-container.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/uniform-planar-array.h"
+#include "ns3/isotropic-antenna-model.h"
+#include "ns3/channel-condition-model.h"
+#include "ns3/three-gpp-channel-model.h"
+
+using namespace ns3;
+
+/**
+ * Request the channel matrices of all the gNB-UE links
+ * \param channelModel the channel model
+ * \param mobilityModels the mobility models of the nodes
+ * \param antennas the antenna arrays of the nodes
+ * \param numGnbs the number of gNBs, i.e., the number of nodes before the first UE
+ */
+static void
+GetAllChannels (Ptr<ThreeGppChannelModel> channelModel,
+                const std::vector<Ptr<MobilityModel> > &mobilityModels,
+                const std::vector<Ptr<PhasedArrayModel> > &antennas,
+                uint32_t numGnbs)
+{
+  for (uint32_t gnb = 0; gnb < numGnbs; gnb++)
+    {
+      for (uint32_t ue = numGnbs; ue < mobilityModels.size (); ue++)
+        {
+          channelModel->GetChannel (mobilityModels[gnb], mobilityModels[ue], antennas[gnb], antennas[ue]);
+        }
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t numGnbs = 4;
+  uint32_t numUes = 25;
+  uint32_t gnbAntennaSize = 8;
+  uint32_t ueAntennaSize = 4;
+  uint32_t numUpdates = 5;
+  Time updatePeriod = MilliSeconds (10);
+  bool pregenerate = true;
+  uint32_t numThreads = 1;
+  std::string scenario = "UMa";
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("numGnbs", "Number of gNBs", numGnbs);
+  cmd.AddValue ("numUes", "Number of UEs, each UE has a link with every gNB", numUes);
+  cmd.AddValue ("gnbAntennaSize", "Number of rows and columns of the gNB antenna arrays", gnbAntennaSize);
+  cmd.AddValue ("ueAntennaSize", "Number of rows and columns of the UE antenna arrays", ueAntennaSize);
+  cmd.AddValue ("numUpdates", "Number of update periods", numUpdates);
+  cmd.AddValue ("updatePeriod", "The channel update period", updatePeriod);
+  cmd.AddValue ("pregenerate", "Regenerate the channel matrices of all the links together", pregenerate);
+  cmd.AddValue ("numThreads", "Number of threads used to regenerate the channel matrices", numThreads);
+  cmd.AddValue ("scenario", "The 3GPP scenario", scenario);
+  cmd.Parse (argc, argv);
+
+  Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel> ();
+  channelModel->SetAttribute ("Frequency", DoubleValue (28.0e9));
+  channelModel->SetAttribute ("Scenario", StringValue (scenario));
+  channelModel->SetAttribute ("ChannelConditionModel", PointerValue (CreateObject<AlwaysLosChannelConditionModel> ()));
+  channelModel->SetAttribute ("UpdatePeriod", TimeValue (updatePeriod));
+  channelModel->SetAttribute ("PregenerateChannels", BooleanValue (pregenerate));
+  channelModel->SetAttribute ("NumThreads", UintegerValue (numThreads));
+
+  // the gNBs are placed along the x axis, the UEs on a grid around them
+  NodeContainer nodes;
+  nodes.Create (numGnbs + numUes);
+  std::vector<Ptr<MobilityModel> > mobilityModels;
+  std::vector<Ptr<PhasedArrayModel> > antennas;
+  for (uint32_t n = 0; n < nodes.GetN (); n++)
+    {
+      bool isGnb = (n < numGnbs);
+      Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel> ();
+      if (isGnb)
+        {
+          mob->SetPosition (Vector (200.0 * n, 0.0, 25.0));
+        }
+      else
+        {
+          uint32_t ue = n - numGnbs;
+          mob->SetPosition (Vector (-100.0 + 40.0 * (ue % 10), -100.0 + 40.0 * (ue / 10), 1.5));
+        }
+      nodes.Get (n)->AggregateObject (mob);
+      mobilityModels.push_back (mob);
+      uint32_t size = isGnb ? gnbAntennaSize : ueAntennaSize;
+      antennas.push_back (CreateObjectWithAttributes<UniformPlanarArray> ("NumColumns", UintegerValue (size),
+                                                                          "NumRows", UintegerValue (size),
+                                                                          "AntennaElement", PointerValue (CreateObject<IsotropicAntennaModel> ())));
+    }
+
+  // request the channel matrices once per update period, slightly more
+  // than an update period after the previous request, so that all the
+  // channel matrices have expired
+  for (uint32_t i = 0; i <= numUpdates; i++)
+    {
+      Simulator::Schedule ((updatePeriod + NanoSeconds (1)) * i, &GetAllChannels,
+                           channelModel, mobilityModels, antennas, numGnbs);
+    }
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  Simulator::Run ();
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now () - start;
+  Simulator::Destroy ();
+
+  std::cout << numGnbs * numUes << " links, " << gnbAntennaSize * gnbAntennaSize << "x"
+            << ueAntennaSize * ueAntennaSize << " antenna elements, "
+            << (pregenerate ? "pregenerated with " + std::to_string (numThreads) + " thread(s)" : "on demand")
+            << ": " << elapsed.count () / (numUpdates + 1) << " ms per update period" << std::endl;
+
+  return 0;
+}
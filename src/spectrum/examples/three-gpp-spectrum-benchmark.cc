@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * This program measures the cost of the computation of the rx PSD by the
+ * ThreeGppSpectrumPropagationLossModel, i.e., of the application of the
+ * beamforming gain to the tx PSD, for a transmission over a number of
+ * resource blocks (275 by default, the maximum number of resource blocks
+ * of an NR carrier).
+ *
+ * The channel matrix and the long term component are computed by the first
+ * call and reused by the following ones, so that the printed time per call
+ * (in microseconds) is dominated by the computation of the gain of each
+ * resource block.
+ */
+
+#include <iostream>
+#include <chrono>
+#include "ns3/core-module.h"
+#include "ns3/node-container.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/uniform-planar-array.h"
+#include "ns3/isotropic-antenna-model.h"
+#include "ns3/channel-condition-model.h"
+#include "ns3/three-gpp-spectrum-propagation-loss-model.h"
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t numRbs = 275;
+  double rbWidth = 360e3;
+  uint32_t numCalls = 10000;
+  std::string scenario = "UMi-StreetCanyon";
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("numRbs", "Number of resource blocks", numRbs);
+  cmd.AddValue ("rbWidth", "Width of a resource block (Hz)", rbWidth);
+  cmd.AddValue ("numCalls", "Number of rx PSD computations", numCalls);
+  cmd.AddValue ("scenario", "The 3GPP scenario", scenario);
+  cmd.Parse (argc, argv);
+
+  Ptr<ThreeGppSpectrumPropagationLossModel> lossModel = CreateObject<ThreeGppSpectrumPropagationLossModel> ();
+  lossModel->SetChannelModelAttribute ("Frequency", DoubleValue (28.0e9));
+  lossModel->SetChannelModelAttribute ("Scenario", StringValue (scenario));
+  lossModel->SetChannelModelAttribute ("ChannelConditionModel", PointerValue (CreateObject<NeverLosChannelConditionModel> ()));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  Ptr<MobilityModel> txMob = CreateObject<ConstantPositionMobilityModel> ();
+  txMob->SetPosition (Vector (0.0, 0.0, 10.0));
+  Ptr<MobilityModel> rxMob = CreateObject<ConstantPositionMobilityModel> ();
+  rxMob->SetPosition (Vector (100.0, 50.0, 1.5));
+  nodes.Get (0)->AggregateObject (txMob);
+  nodes.Get (1)->AggregateObject (rxMob);
+
+  Ptr<PhasedArrayModel> txAntenna = CreateObjectWithAttributes<UniformPlanarArray> ("NumColumns", UintegerValue (8),
+                                                                                    "NumRows", UintegerValue (8),
+                                                                                    "AntennaElement", PointerValue (CreateObject<IsotropicAntennaModel> ()));
+  Ptr<PhasedArrayModel> rxAntenna = CreateObjectWithAttributes<UniformPlanarArray> ("NumColumns", UintegerValue (4),
+                                                                                    "NumRows", UintegerValue (4),
+                                                                                    "AntennaElement", PointerValue (CreateObject<IsotropicAntennaModel> ()));
+  txAntenna->SetBeamformingVector (txAntenna->GetBeamformingVector (Angles (rxMob->GetPosition (), txMob->GetPosition ())));
+  rxAntenna->SetBeamformingVector (rxAntenna->GetBeamformingVector (Angles (txMob->GetPosition (), rxMob->GetPosition ())));
+
+  std::vector<double> freqs;
+  for (uint32_t i = 0; i < numRbs; i++)
+    {
+      freqs.push_back (28.0e9 + (i - numRbs / 2.0) * rbWidth);
+    }
+  Ptr<SpectrumValue> txPsd = Create<SpectrumValue> (Create<SpectrumModel> (freqs));
+  (*txPsd) = 1e-9;
+
+  // the first call computes the channel matrix and the long term component
+  Ptr<SpectrumValue> rxPsd = lossModel->DoCalcRxPowerSpectralDensity (txPsd, txMob, rxMob, txAntenna, rxAntenna);
+  double check = 0;
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  for (uint32_t n = 0; n < numCalls; n++)
+    {
+      rxPsd = lossModel->DoCalcRxPowerSpectralDensity (txPsd, txMob, rxMob, txAntenna, rxAntenna);
+      check += (*rxPsd)[n % numRbs];
+    }
+  std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now () - start;
+  Simulator::Destroy ();
+
+  std::cout << numRbs << " resource blocks: " << elapsed.count () / numCalls << " us per rx PSD"
+            << " (check " << check << ")" << std::endl;
+
+  return 0;
+}
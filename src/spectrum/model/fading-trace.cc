@@ -0,0 +1,392 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "fading-trace.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/fatal-error.h"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <tuple>
+
+#ifdef HAVE_SYS_MMAN_H
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FadingTrace");
+
+/// The magic string at the beginning of the binary files
+static const char FADING_TRACE_MAGIC[8] = {'n', 's', '3', 'f', 'a', 'd', 't', 'r'};
+/// The version of the binary file format
+static const uint32_t FADING_TRACE_VERSION = 1;
+/// The size of the header of the binary files
+static const std::size_t FADING_TRACE_HEADER_SIZE = sizeof (FADING_TRACE_MAGIC) + 4 * sizeof (uint32_t);
+
+/// The key of a loaded trace: file name, number of resource blocks and number of samples
+typedef std::tuple<std::string, uint32_t, uint32_t> FadingTraceKey;
+
+/**
+ * \return the traces which are currently loaded
+ *
+ * The traces are not owned by the registry, they remove themselves from it
+ * when they are deleted.
+ */
+static std::map<FadingTraceKey, FadingTrace *> &
+GetLoadedTraces (void)
+{
+  static std::map<FadingTraceKey, FadingTrace *> traces;
+  return traces;
+}
+
+/**
+ * Convert a single-precision number to the nearest half-precision number
+ * \param value the single-precision number
+ * \return the bits of the half-precision number
+ */
+static uint16_t
+FloatToHalf (float value)
+{
+  uint32_t bits;
+  std::memcpy (&bits, &value, sizeof (bits));
+  uint16_t sign = (bits >> 16) & 0x8000;
+  int32_t exponent = static_cast<int32_t> ((bits >> 23) & 0xff) - 127 + 15;
+  uint32_t mantissa = bits & 0x7fffff;
+  if (((bits >> 23) & 0xff) == 0xff)
+    {
+      // infinity or NaN
+      return sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0);
+    }
+  if (exponent >= 31)
+    {
+      return sign | 0x7c00;
+    }
+  uint32_t shift = 13;
+  uint32_t half;
+  if (exponent <= 0)
+    {
+      // subnormal half-precision number, or zero
+      if (exponent < -10)
+        {
+          return sign;
+        }
+      mantissa |= 0x800000;
+      shift = 14 - exponent;
+      half = mantissa >> shift;
+    }
+  else
+    {
+      half = (exponent << 10) | (mantissa >> shift);
+    }
+  // round to nearest, ties to even; a carry into the exponent is correct
+  uint32_t remainder = mantissa & ((1u << shift) - 1);
+  uint32_t halfway = 1u << (shift - 1);
+  if (remainder > halfway || (remainder == halfway && (half & 1)))
+    {
+      half++;
+    }
+  return sign | static_cast<uint16_t> (half);
+}
+
+/**
+ * Convert a half-precision number to a single-precision number
+ * \param half the bits of the half-precision number
+ * \return the single-precision number
+ */
+static float
+HalfToFloat (uint16_t half)
+{
+  uint32_t sign = static_cast<uint32_t> (half & 0x8000) << 16;
+  uint32_t exponent = (half >> 10) & 0x1f;
+  uint32_t mantissa = half & 0x3ff;
+  if (exponent == 0)
+    {
+      float value = std::ldexp (static_cast<float> (mantissa), -24);
+      return sign ? -value : value;
+    }
+  uint32_t bits;
+  if (exponent == 31)
+    {
+      bits = sign | 0x7f800000 | (mantissa << 13);
+    }
+  else
+    {
+      bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    }
+  float value;
+  std::memcpy (&value, &bits, sizeof (value));
+  return value;
+}
+
+FadingTrace::FadingTrace (std::string filename, uint32_t rbNum, uint32_t samplesNum)
+  : m_filename (filename),
+    m_rbNum (rbNum),
+    m_samplesNum (samplesNum),
+    m_sampleType (FLOAT32),
+    m_samples (0),
+    m_mapping (0),
+    m_mappingSize (0)
+{
+  NS_LOG_FUNCTION (this << filename << rbNum << samplesNum);
+  std::ifstream file (filename.c_str (), std::ios::in | std::ios::binary);
+  if (!file.is_open ())
+    {
+      NS_FATAL_ERROR ("Cannot open the fading trace file " << filename);
+    }
+  char magic[sizeof (FADING_TRACE_MAGIC)];
+  file.read (magic, sizeof (magic));
+  bool binary = file.good () && std::memcmp (magic, FADING_TRACE_MAGIC, sizeof (magic)) == 0;
+  file.close ();
+  if (binary)
+    {
+      ReadBinary (filename);
+    }
+  else
+    {
+      ReadText (filename);
+    }
+}
+
+FadingTrace::~FadingTrace ()
+{
+  NS_LOG_FUNCTION (this);
+  GetLoadedTraces ().erase (FadingTraceKey (m_filename, m_rbNum, m_samplesNum));
+#ifdef HAVE_SYS_MMAN_H
+  if (m_mapping != 0)
+    {
+      munmap (m_mapping, m_mappingSize);
+    }
+#endif
+}
+
+Ptr<const FadingTrace>
+FadingTrace::Get (std::string filename, uint32_t rbNum, uint32_t samplesNum)
+{
+  NS_LOG_FUNCTION (filename << rbNum << samplesNum);
+  std::map<FadingTraceKey, FadingTrace *> &traces = GetLoadedTraces ();
+  FadingTraceKey key (filename, rbNum, samplesNum);
+  std::map<FadingTraceKey, FadingTrace *>::const_iterator it = traces.find (key);
+  if (it != traces.end ())
+    {
+      return Ptr<const FadingTrace> (it->second);
+    }
+  Ptr<FadingTrace> trace (new FadingTrace (filename, rbNum, samplesNum), false);
+  traces[key] = PeekPointer (trace);
+  return trace;
+}
+
+std::size_t
+FadingTrace::GetNLoadedTraces (void)
+{
+  return GetLoadedTraces ().size ();
+}
+
+void
+FadingTrace::ReadText (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::ifstream file (filename.c_str ());
+  std::vector<float> values (static_cast<std::size_t> (m_rbNum) * m_samplesNum);
+  for (float &value : values)
+    {
+      file >> value;
+    }
+  if (file.fail ())
+    {
+      NS_FATAL_ERROR ("The fading trace file " << filename << " has fewer than "
+                      << m_rbNum << " x " << m_samplesNum << " samples");
+    }
+  m_sampleType = FLOAT32;
+  m_buffer.resize (values.size () * sizeof (float));
+  std::memcpy (m_buffer.data (), values.data (), m_buffer.size ());
+  m_samples = m_buffer.data ();
+}
+
+void
+FadingTrace::ReadBinary (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::ifstream file (filename.c_str (), std::ios::in | std::ios::binary);
+  char magic[sizeof (FADING_TRACE_MAGIC)];
+  uint32_t version = 0;
+  uint32_t sampleType = 0;
+  uint32_t rbNum = 0;
+  uint32_t samplesNum = 0;
+  file.read (magic, sizeof (magic));
+  file.read (reinterpret_cast<char *> (&version), sizeof (version));
+  file.read (reinterpret_cast<char *> (&sampleType), sizeof (sampleType));
+  file.read (reinterpret_cast<char *> (&rbNum), sizeof (rbNum));
+  file.read (reinterpret_cast<char *> (&samplesNum), sizeof (samplesNum));
+  if (!file.good () || version != FADING_TRACE_VERSION || (sampleType != FLOAT32 && sampleType != FLOAT16))
+    {
+      NS_FATAL_ERROR ("Unsupported version " << version << " of the fading trace file " << filename);
+    }
+  if (rbNum < m_rbNum || samplesNum != m_samplesNum)
+    {
+      NS_FATAL_ERROR ("The fading trace file " << filename << " has " << rbNum << " x " << samplesNum
+                      << " samples instead of " << m_rbNum << " x " << m_samplesNum);
+    }
+  m_sampleType = static_cast<SampleType> (sampleType);
+  std::size_t size = static_cast<std::size_t> (m_rbNum) * m_samplesNum
+    * (m_sampleType == FLOAT16 ? sizeof (uint16_t) : sizeof (float));
+
+#ifdef HAVE_SYS_MMAN_H
+  int fd = open (filename.c_str (), O_RDONLY);
+  struct stat st;
+  if (fd >= 0 && fstat (fd, &st) == 0 && static_cast<std::size_t> (st.st_size) >= FADING_TRACE_HEADER_SIZE + size)
+    {
+      m_mappingSize = FADING_TRACE_HEADER_SIZE + size;
+      void *mapping = mmap (0, m_mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapping != MAP_FAILED)
+        {
+          m_mapping = mapping;
+          m_samples = static_cast<const char *> (mapping) + FADING_TRACE_HEADER_SIZE;
+        }
+    }
+  if (fd >= 0)
+    {
+      close (fd);
+    }
+  if (m_mapping != 0)
+    {
+      NS_LOG_DEBUG ("Mapped " << m_rbNum << " x " << m_samplesNum << " samples of " << filename);
+      return;
+    }
+#endif
+
+  m_buffer.resize (size);
+  file.read (m_buffer.data (), size);
+  if (!file.good ())
+    {
+      NS_FATAL_ERROR ("The fading trace file " << filename << " is truncated");
+    }
+  m_samples = m_buffer.data ();
+}
+
+void
+FadingTrace::ConvertText (std::string textFilename, std::string binaryFilename, SampleType sampleType)
+{
+  NS_LOG_FUNCTION (textFilename << binaryFilename << sampleType);
+  std::ifstream input (textFilename.c_str ());
+  if (!input.is_open ())
+    {
+      NS_FATAL_ERROR ("Cannot open the fading trace file " << textFilename);
+    }
+  std::ofstream output (binaryFilename.c_str (), std::ios::out | std::ios::binary);
+  if (!output.is_open ())
+    {
+      NS_FATAL_ERROR ("Cannot open the fading trace file " << binaryFilename);
+    }
+  uint32_t type = sampleType;
+  uint32_t rbNum = 0;
+  uint32_t samplesNum = 0;
+  output.write (FADING_TRACE_MAGIC, sizeof (FADING_TRACE_MAGIC));
+  output.write (reinterpret_cast<const char *> (&FADING_TRACE_VERSION), sizeof (FADING_TRACE_VERSION));
+  output.write (reinterpret_cast<const char *> (&type), sizeof (type));
+  output.write (reinterpret_cast<const char *> (&rbNum), sizeof (rbNum));
+  output.write (reinterpret_cast<const char *> (&samplesNum), sizeof (samplesNum));
+
+  // each line holds the samples of a resource block
+  std::string line;
+  std::vector<float> samples;
+  std::vector<uint16_t> halves;
+  while (std::getline (input, line))
+    {
+      std::istringstream iss (line);
+      samples.clear ();
+      float sample;
+      while (iss >> sample)
+        {
+          samples.push_back (sample);
+        }
+      if (samples.empty ())
+        {
+          continue;
+        }
+      if (rbNum == 0)
+        {
+          samplesNum = samples.size ();
+        }
+      else if (samples.size () != samplesNum)
+        {
+          NS_FATAL_ERROR ("Line " << rbNum + 1 << " of the fading trace file " << textFilename << " has "
+                          << samples.size () << " samples instead of " << samplesNum);
+        }
+      if (sampleType == FLOAT16)
+        {
+          halves.resize (samples.size ());
+          for (std::size_t i = 0; i < samples.size (); i++)
+            {
+              halves[i] = FloatToHalf (samples[i]);
+            }
+          output.write (reinterpret_cast<const char *> (halves.data ()), halves.size () * sizeof (uint16_t));
+        }
+      else
+        {
+          output.write (reinterpret_cast<const char *> (samples.data ()), samples.size () * sizeof (float));
+        }
+      rbNum++;
+    }
+
+  // the dimensions are known once the whole file is read
+  output.seekp (sizeof (FADING_TRACE_MAGIC) + 2 * sizeof (uint32_t));
+  output.write (reinterpret_cast<const char *> (&rbNum), sizeof (rbNum));
+  output.write (reinterpret_cast<const char *> (&samplesNum), sizeof (samplesNum));
+  if (!output.good ())
+    {
+      NS_FATAL_ERROR ("Cannot write the fading trace file " << binaryFilename);
+    }
+  NS_LOG_DEBUG ("Converted " << rbNum << " x " << samplesNum << " samples of " << textFilename);
+}
+
+uint32_t
+FadingTrace::GetRbNum (void) const
+{
+  return m_rbNum;
+}
+
+uint32_t
+FadingTrace::GetSamplesNum (void) const
+{
+  return m_samplesNum;
+}
+
+bool
+FadingTrace::IsMapped (void) const
+{
+  return m_mapping != 0;
+}
+
+double
+FadingTrace::GetValue (uint32_t rb, uint32_t sample) const
+{
+  NS_ASSERT_MSG (rb < m_rbNum && sample < m_samplesNum, "Sample " << rb << " x " << sample << " out of the trace");
+  std::size_t i = static_cast<std::size_t> (rb) * m_samplesNum + sample;
+  if (m_sampleType == FLOAT16)
+    {
+      return HalfToFloat (static_cast<const uint16_t *> (m_samples)[i]);
+    }
+  return static_cast<const float *> (m_samples)[i];
+}
+
+} // namespace ns3
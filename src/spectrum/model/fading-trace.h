@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FADING_TRACE_H
+#define FADING_TRACE_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup spectrum
+ * \brief A fading trace, shared by all the models which use it
+ *
+ * A fading trace is made of the fading samples (in dB) of a number of
+ * resource blocks. The traces are obtained by means of Get, which loads a
+ * trace file only once: all the TraceFadingLossModel instances reading the
+ * same file share the same FadingTrace, which is unloaded when the last of
+ * them releases it.
+ *
+ * A trace file is either a text file, as written by
+ * fading_trace_generator.m (one line of samples per resource block), or a
+ * binary file written by ConvertText. The samples of a text file are
+ * parsed and kept in memory as single-precision numbers. A binary file is
+ * mapped in memory when the system supports it, so that only the pages
+ * which are accessed are read, and traces larger than the memory can be
+ * used. It consists of the following fields, in host byte order:
+ \verbatim
+   char     magic[8]            "ns3fadtr"
+   uint32_t version             1
+   uint32_t sampleType          0 (float32) or 1 (float16)
+   uint32_t rbNum
+   uint32_t samplesNum
+   samples[rbNum][samplesNum]   fading in dB
+ \endverbatim
+ * Half-precision samples halve the size of the file, with an error below
+ * 0.02 dB for fading values above -64 dB.
+ */
+class FadingTrace : public SimpleRefCount<FadingTrace>
+{
+public:
+  /// The type of the samples of a binary trace file
+  enum SampleType
+  {
+    FLOAT32 = 0, //!< IEEE 754 single-precision numbers
+    FLOAT16 = 1  //!< IEEE 754 half-precision numbers
+  };
+
+  ~FadingTrace ();
+
+  // Delete copy constructor and assignment operator to avoid misuse
+  FadingTrace (const FadingTrace &) = delete;
+  FadingTrace & operator = (const FadingTrace &) = delete;
+
+  /**
+   * Get a trace, which is loaded if it is not used yet.
+   *
+   * \param filename the name of the text or binary trace file
+   * \param rbNum the number of resource blocks of the trace
+   * \param samplesNum the number of samples of each resource block
+   * \return the trace
+   */
+  static Ptr<const FadingTrace> Get (std::string filename, uint32_t rbNum, uint32_t samplesNum);
+  /**
+   * \return the number of traces which are currently loaded
+   */
+  static std::size_t GetNLoadedTraces (void);
+  /**
+   * Convert a text trace file to a binary trace file. The text file is read
+   * one line at a time, so that it does not need to fit in memory.
+   *
+   * \param textFilename the name of the text trace file
+   * \param binaryFilename the name of the binary trace file
+   * \param sampleType the type of the samples of the binary file
+   */
+  static void ConvertText (std::string textFilename, std::string binaryFilename,
+                           SampleType sampleType = FLOAT32);
+
+  /**
+   * \return the number of resource blocks
+   */
+  uint32_t GetRbNum (void) const;
+  /**
+   * \return the number of samples of each resource block
+   */
+  uint32_t GetSamplesNum (void) const;
+  /**
+   * \return whether the samples are mapped from a binary file rather than
+   *         read in memory
+   */
+  bool IsMapped (void) const;
+  /**
+   * \param rb the index of the resource block
+   * \param sample the index of the sample
+   * \return the fading (in dB)
+   */
+  double GetValue (uint32_t rb, uint32_t sample) const;
+
+private:
+  /**
+   * \param filename the name of the trace file
+   * \param rbNum the number of resource blocks of the trace
+   * \param samplesNum the number of samples of each resource block
+   */
+  FadingTrace (std::string filename, uint32_t rbNum, uint32_t samplesNum);
+
+  /**
+   * Read the samples of a text trace file
+   * \param filename the name of the file
+   */
+  void ReadText (std::string filename);
+  /**
+   * Map or read the samples of a binary trace file
+   * \param filename the name of the file
+   */
+  void ReadBinary (std::string filename);
+
+  std::string m_filename;      //!< the name of the trace file
+  uint32_t m_rbNum;            //!< the number of resource blocks
+  uint32_t m_samplesNum;       //!< the number of samples of each resource block
+  SampleType m_sampleType;     //!< the type of the samples
+  const void *m_samples;       //!< the samples, mapped or in m_buffer
+  std::vector<char> m_buffer;  //!< the samples, when they are not mapped
+  void *m_mapping;             //!< the mapped file, if any
+  std::size_t m_mappingSize;   //!< the size of the mapped file
+};
+
+} // namespace ns3
+
+#endif /* FADING_TRACE_H */
@@ -27,6 +27,7 @@
 #include <ns3/nstime.h>
 #include <ns3/vector.h>
 #include <ns3/phased-array-model.h>
+#include <ns3/spectrum-value.h>
 #include <tuple>
 
 namespace ns3 {
@@ -54,12 +55,116 @@ public:
   typedef std::vector<PhasedArrayModel::ComplexVector> Complex2DVector; //!< type definition for complex matrices
   typedef std::vector<Complex2DVector> Complex3DVector; //!< type definition for complex 3D matrices
 
+  /**
+   * Complex 3D array, used to store the channel matrix H[u][s][n].
+   *
+   * The elements are stored in a single contiguous buffer, aligned to
+   * SpectrumValueAllocator::ALIGNMENT bytes. Each page (i.e., the matrix of
+   * a cluster n) is stored in column-major order, so that the elements
+   * H[0][s][n], ..., H[U-1][s][n] are contiguous.
+   */
+  class Complex3DArray
+  {
+  public:
+    /**
+     * Create an empty array
+     */
+    Complex3DArray ()
+      : m_numRows (0),
+        m_numCols (0),
+        m_numPages (0)
+    {
+    }
+    /**
+     * Create an array whose elements are set to zero
+     * \param numRows the number of rows (u)
+     * \param numCols the number of columns (s)
+     * \param numPages the number of pages (n)
+     */
+    Complex3DArray (std::size_t numRows, std::size_t numCols, std::size_t numPages)
+    {
+      Resize (numRows, numCols, numPages);
+    }
+    /**
+     * Change the dimensions of the array. All the elements are set to zero.
+     * \param numRows the number of rows (u)
+     * \param numCols the number of columns (s)
+     * \param numPages the number of pages (n)
+     */
+    void Resize (std::size_t numRows, std::size_t numCols, std::size_t numPages)
+    {
+      m_numRows = numRows;
+      m_numCols = numCols;
+      m_numPages = numPages;
+      m_values.assign (numRows * numCols * numPages, std::complex<double> (0, 0));
+    }
+    /**
+     * \return the number of rows (u)
+     */
+    std::size_t GetNumRows (void) const
+    {
+      return m_numRows;
+    }
+    /**
+     * \return the number of columns (s)
+     */
+    std::size_t GetNumCols (void) const
+    {
+      return m_numCols;
+    }
+    /**
+     * \return the number of pages (n)
+     */
+    std::size_t GetNumPages (void) const
+    {
+      return m_numPages;
+    }
+    /**
+     * \param row the row index (u)
+     * \param col the column index (s)
+     * \param page the page index (n)
+     * \return a reference to the element H[row][col][page]
+     */
+    std::complex<double>& operator () (std::size_t row, std::size_t col, std::size_t page)
+    {
+      NS_ASSERT (row < m_numRows && col < m_numCols && page < m_numPages);
+      return m_values[(page * m_numCols + col) * m_numRows + row];
+    }
+    /**
+     * \param row the row index (u)
+     * \param col the column index (s)
+     * \param page the page index (n)
+     * \return a const reference to the element H[row][col][page]
+     */
+    const std::complex<double>& operator () (std::size_t row, std::size_t col, std::size_t page) const
+    {
+      NS_ASSERT (row < m_numRows && col < m_numCols && page < m_numPages);
+      return m_values[(page * m_numCols + col) * m_numRows + row];
+    }
+    /**
+     * \param page the page index (n)
+     * \return a pointer to the first element of the given page, whose
+     *         element H[u][s][page] is at offset s * GetNumRows () + u
+     */
+    const std::complex<double>* GetPage (std::size_t page) const
+    {
+      NS_ASSERT (page < m_numPages);
+      return m_values.data () + page * m_numCols * m_numRows;
+    }
+
+  private:
+    std::size_t m_numRows;  //!< the number of rows
+    std::size_t m_numCols;  //!< the number of columns
+    std::size_t m_numPages; //!< the number of pages
+    std::vector<std::complex<double>, SpectrumValueAllocator<std::complex<double> > > m_values; //!< the elements
+  };
+
   /**
    * Data structure that stores a channel realization
    */
   struct ChannelMatrix : public SimpleRefCount<ChannelMatrix>
   {
-    Complex3DVector    m_channel; //!< channel matrix H[u][s][n].
+    Complex3DArray     m_channel; //!< channel matrix H[u][s][n], accessed as m_channel (u, s, n).
     Time               m_generatedTime; //!< generation time
     std::pair<uint32_t, uint32_t> m_antennaPair; //!< the first element is the ID of the antenna of the s-node (the antenna of the transmitter when the channel was generated), the second element is ID of the antenna of the u-node antenna (the antenna of the receiver when the channel was generated)
     std::pair<uint32_t, uint32_t> m_nodeIds; //!< the first element is the s-node ID (the transmitter when the channel was generated), the second element is the u-node ID (the receiver when the channel was generated)
@@ -22,11 +22,172 @@
 #include <ns3/spectrum-value.h>
 #include <ns3/math.h>
 #include <ns3/log.h>
+#include <algorithm>
+#include <new>
+
+#if defined (__AVX__)
+#include <immintrin.h>
+#elif defined (__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("SpectrumValue");
 
+void*
+SpectrumValueAllocate (std::size_t size)
+{
+  return ::operator new (size, std::align_val_t (SpectrumValueAllocator<double>::ALIGNMENT));
+}
+
+void
+SpectrumValueDeallocate (void *p)
+{
+  ::operator delete (p, std::align_val_t (SpectrumValueAllocator<double>::ALIGNMENT));
+}
+
+namespace {
+
+/*
+ * Packed double precision operations used by the element-wise kernels below.
+ * The widest instruction set enabled at compile time is used (e.g., AVX when
+ * building with NS3_NATIVE_OPTIMIZATIONS on a capable host); otherwise the
+ * kernels operate on one value at a time. Each operation performs the same
+ * IEEE operation as the scalar code, hence results do not depend on the
+ * instruction set.
+ */
+#if defined (__AVX__)
+typedef __m256d Packed;
+const std::size_t PACKED_SIZE = 4;
+inline Packed Load (const double *p) { return _mm256_loadu_pd (p); }
+inline void Store (double *p, Packed v) { _mm256_storeu_pd (p, v); }
+inline Packed Broadcast (double s) { return _mm256_set1_pd (s); }
+inline Packed PackedAdd (Packed a, Packed b) { return _mm256_add_pd (a, b); }
+inline Packed PackedSub (Packed a, Packed b) { return _mm256_sub_pd (a, b); }
+inline Packed PackedMul (Packed a, Packed b) { return _mm256_mul_pd (a, b); }
+inline Packed PackedDiv (Packed a, Packed b) { return _mm256_div_pd (a, b); }
+#elif defined (__SSE2__)
+typedef __m128d Packed;
+const std::size_t PACKED_SIZE = 2;
+inline Packed Load (const double *p) { return _mm_loadu_pd (p); }
+inline void Store (double *p, Packed v) { _mm_storeu_pd (p, v); }
+inline Packed Broadcast (double s) { return _mm_set1_pd (s); }
+inline Packed PackedAdd (Packed a, Packed b) { return _mm_add_pd (a, b); }
+inline Packed PackedSub (Packed a, Packed b) { return _mm_sub_pd (a, b); }
+inline Packed PackedMul (Packed a, Packed b) { return _mm_mul_pd (a, b); }
+inline Packed PackedDiv (Packed a, Packed b) { return _mm_div_pd (a, b); }
+#else
+typedef double Packed;
+const std::size_t PACKED_SIZE = 1;
+inline Packed Load (const double *p) { return *p; }
+inline void Store (double *p, Packed v) { *p = v; }
+inline Packed Broadcast (double s) { return s; }
+inline Packed PackedAdd (Packed a, Packed b) { return a + b; }
+inline Packed PackedSub (Packed a, Packed b) { return a - b; }
+inline Packed PackedMul (Packed a, Packed b) { return a * b; }
+inline Packed PackedDiv (Packed a, Packed b) { return a / b; }
+#endif
+
+/**
+ * Apply dst[i] = op (dst[i], src[i]) to n values
+ * \param dst the destination values
+ * \param src the source values (may be equal to dst)
+ * \param n the number of values
+ * \param op the packed operation
+ */
+template <class Op>
+inline void
+ApplyVector (double *dst, const double *src, std::size_t n, Op op)
+{
+  std::size_t i = 0;
+  for (; i + PACKED_SIZE <= n; i += PACKED_SIZE)
+    {
+      Store (dst + i, op (Load (dst + i), Load (src + i)));
+    }
+  for (; i < n; i++)
+    {
+      dst[i] = op (dst[i], src[i]);
+    }
+}
+
+/**
+ * Apply dst[i] = op (dst[i], s) to n values
+ * \param dst the destination values
+ * \param s the scalar
+ * \param n the number of values
+ * \param op the packed operation
+ */
+template <class Op>
+inline void
+ApplyScalar (double *dst, double s, std::size_t n, Op op)
+{
+  Packed ps = Broadcast (s);
+  std::size_t i = 0;
+  for (; i + PACKED_SIZE <= n; i += PACKED_SIZE)
+    {
+      Store (dst + i, op (Load (dst + i), ps));
+    }
+  for (; i < n; i++)
+    {
+      dst[i] = op (dst[i], s);
+    }
+}
+
+/// Addition functor, usable on both packed and scalar operands
+struct AddOp
+{
+  /**
+   * \param a first operand \param b second operand \return a + b
+   */
+  template <class T> T operator() (T a, T b) const { return a + b; }
+  /**
+   * \param a first operand \param b second operand \return a + b
+   */
+  Packed operator() (Packed a, Packed b) const { return PackedAdd (a, b); }
+};
+
+/// Subtraction functor, usable on both packed and scalar operands
+struct SubOp
+{
+  /**
+   * \param a first operand \param b second operand \return a - b
+   */
+  template <class T> T operator() (T a, T b) const { return a - b; }
+  /**
+   * \param a first operand \param b second operand \return a - b
+   */
+  Packed operator() (Packed a, Packed b) const { return PackedSub (a, b); }
+};
+
+/// Multiplication functor, usable on both packed and scalar operands
+struct MulOp
+{
+  /**
+   * \param a first operand \param b second operand \return a * b
+   */
+  template <class T> T operator() (T a, T b) const { return a * b; }
+  /**
+   * \param a first operand \param b second operand \return a * b
+   */
+  Packed operator() (Packed a, Packed b) const { return PackedMul (a, b); }
+};
+
+/// Division functor, usable on both packed and scalar operands
+struct DivOp
+{
+  /**
+   * \param a first operand \param b second operand \return a / b
+   */
+  template <class T> T operator() (T a, T b) const { return a / b; }
+  /**
+   * \param a first operand \param b second operand \return a / b
+   */
+  Packed operator() (Packed a, Packed b) const { return PackedDiv (a, b); }
+};
+
+} // unnamed namespace
+
 SpectrumValue::SpectrumValue ()
 {
 }
@@ -106,31 +267,17 @@ SpectrumValue::ConstBandsEnd () const
 void
 SpectrumValue::Add (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
   NS_ASSERT (m_values.size () == x.m_values.size ());
 
-  while (it1 != m_values.end ())
-    {
-      *it1 += *it2;
-      ++it1;
-      ++it2;
-    }
+  ApplyVector (m_values.data (), x.m_values.data (), m_values.size (), AddOp ());
 }
 
 
 void
 SpectrumValue::Add (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
-    {
-      *it1 += s;
-      ++it1;
-    }
+  ApplyScalar (m_values.data (), s, m_values.size (), AddOp ());
 }
 
 
@@ -138,18 +285,10 @@ SpectrumValue::Add (double s)
 void
 SpectrumValue::Subtract (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
   NS_ASSERT (m_values.size () == x.m_values.size ());
 
-  while (it1 != m_values.end ())
-    {
-      *it1 -= *it2;
-      ++it1;
-      ++it2;
-    }
+  ApplyVector (m_values.data (), x.m_values.data (), m_values.size (), SubOp ());
 }
 
 
@@ -164,31 +303,17 @@ SpectrumValue::Subtract (double s)
 void
 SpectrumValue::Multiply (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
   NS_ASSERT (m_values.size () == x.m_values.size ());
 
-  while (it1 != m_values.end ())
-    {
-      *it1 *= *it2;
-      ++it1;
-      ++it2;
-    }
+  ApplyVector (m_values.data (), x.m_values.data (), m_values.size (), MulOp ());
 }
 
 
 void
 SpectrumValue::Multiply (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
-    {
-      *it1 *= s;
-      ++it1;
-    }
+  ApplyScalar (m_values.data (), s, m_values.size (), MulOp ());
 }
 
 
@@ -197,18 +322,10 @@ SpectrumValue::Multiply (double s)
 void
 SpectrumValue::Divide (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
   NS_ASSERT (m_values.size () == x.m_values.size ());
 
-  while (it1 != m_values.end ())
-    {
-      *it1 /= *it2;
-      ++it1;
-      ++it2;
-    }
+  ApplyVector (m_values.data (), x.m_values.data (), m_values.size (), DivOp ());
 }
 
 
@@ -216,13 +333,55 @@ void
 SpectrumValue::Divide (double s)
 {
   NS_LOG_FUNCTION (this << s);
-  Values::iterator it1 = m_values.begin ();
+  ApplyScalar (m_values.data (), s, m_values.size (), DivOp ());
+}
 
-  while (it1 != m_values.end ())
+
+SpectrumValue&
+SpectrumValue::AddScaled (const SpectrumValue& x, double s)
+{
+  NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+
+  double *dst = m_values.data ();
+  const double *src = x.m_values.data ();
+  std::size_t n = m_values.size ();
+  Packed ps = Broadcast (s);
+  std::size_t i = 0;
+  for (; i + PACKED_SIZE <= n; i += PACKED_SIZE)
     {
-      *it1 /= s;
-      ++it1;
+      Store (dst + i, PackedAdd (Load (dst + i), PackedMul (Load (src + i), ps)));
     }
+  for (; i < n; i++)
+    {
+      dst[i] += src[i] * s;
+    }
+  return *this;
+}
+
+
+SpectrumValue&
+SpectrumValue::AddProduct (const SpectrumValue& x, const SpectrumValue& y)
+{
+  NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_spectrumModel == y.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  NS_ASSERT (m_values.size () == y.m_values.size ());
+
+  double *dst = m_values.data ();
+  const double *src1 = x.m_values.data ();
+  const double *src2 = y.m_values.data ();
+  std::size_t n = m_values.size ();
+  std::size_t i = 0;
+  for (; i + PACKED_SIZE <= n; i += PACKED_SIZE)
+    {
+      Store (dst + i, PackedAdd (Load (dst + i), PackedMul (Load (src1 + i), Load (src2 + i))));
+    }
+  for (; i < n; i++)
+    {
+      dst[i] += src1[i] * src2[i];
+    }
+  return *this;
 }
 
 
@@ -467,9 +626,8 @@ operator+ (double lhs, const SpectrumValue& rhs)
 SpectrumValue
 operator- (const SpectrumValue& lhs, const SpectrumValue& rhs)
 {
-  SpectrumValue res = rhs;
-  res.ChangeSign ();
-  res.Add (lhs);
+  SpectrumValue res = lhs;
+  res.Subtract (rhs);
   return res;
 }
 
@@ -664,13 +822,7 @@ SpectrumValue::operator/= (double rhs)
 SpectrumValue&
 SpectrumValue::operator= (double rhs)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
-    {
-      *it1 = rhs;
-      ++it1;
-    }
+  std::fill (m_values.begin (), m_values.end (), rhs);
   return *this;
 }
 
@@ -24,14 +24,102 @@
 #include <ns3/ptr.h>
 #include <ns3/simple-ref-count.h>
 #include <ns3/spectrum-model.h>
+#include <cstddef>
 #include <ostream>
 #include <vector>
 
 namespace ns3 {
 
+/**
+ * Allocate a memory block aligned to SpectrumValueAllocator::ALIGNMENT bytes
+ *
+ * \param size the size of the block in bytes
+ * \return a pointer to the memory block
+ */
+void* SpectrumValueAllocate (std::size_t size);
+/**
+ * Release a memory block allocated by SpectrumValueAllocate
+ *
+ * \param p a pointer to the memory block
+ */
+void SpectrumValueDeallocate (void *p);
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief Allocator of the storage backing the Values of a SpectrumValue
+ *
+ * The storage is aligned to the size of the widest SIMD register used by
+ * the SpectrumValue arithmetic, so that vector loads and stores never
+ * cross a cache line boundary.
+ */
+template <class T>
+class SpectrumValueAllocator
+{
+public:
+  typedef T value_type;                     //!< type of the allocated elements
+  static const std::size_t ALIGNMENT = 32;  //!< alignment of the storage in bytes
+
+  /// Rebind the allocator to another element type
+  template <class U>
+  struct rebind
+  {
+    typedef SpectrumValueAllocator<U> other;  //!< the rebound allocator
+  };
+
+  SpectrumValueAllocator ()
+  {
+  }
+  /**
+   * Copy constructor from an allocator of another element type
+   * \param other the allocator
+   */
+  template <class U>
+  SpectrumValueAllocator (const SpectrumValueAllocator<U> &other)
+  {
+  }
+  /**
+   * \param n the number of elements
+   * \return a pointer to an aligned block of n elements
+   */
+  T* allocate (std::size_t n)
+  {
+    return static_cast<T *> (SpectrumValueAllocate (n * sizeof (T)));
+  }
+  /**
+   * \param p a pointer to a block returned by allocate
+   * \param n the number of elements of the block
+   */
+  void deallocate (T *p, std::size_t n)
+  {
+    SpectrumValueDeallocate (p);
+  }
+};
+
+/**
+ * \param lhs the first allocator
+ * \param rhs the second allocator
+ * \return true, since all the SpectrumValueAllocator instances are interchangeable
+ */
+template <class T, class U>
+bool operator== (const SpectrumValueAllocator<T> &lhs, const SpectrumValueAllocator<U> &rhs)
+{
+  return true;
+}
+
+/**
+ * \param lhs the first allocator
+ * \param rhs the second allocator
+ * \return false, since all the SpectrumValueAllocator instances are interchangeable
+ */
+template <class T, class U>
+bool operator!= (const SpectrumValueAllocator<T> &lhs, const SpectrumValueAllocator<U> &rhs)
+{
+  return false;
+}
 
 /// Container for element values
-typedef std::vector<double> Values;
+typedef std::vector<double, SpectrumValueAllocator<double> > Values;
 
 /**
  * \ingroup spectrum
@@ -50,6 +138,10 @@ typedef std::vector<double> Values;
  * Space.
  * Mathematical operations are defined in this Function Space; these
  * operations are implemented by means of operator overloading.
+ * Element-wise operations are vectorized with SSE2/AVX instructions when
+ * the build enables them. Binary operators return a new SpectrumValue;
+ * the compound assignment operators and the fused AddScaled and
+ * AddProduct operations work in place and do not allocate any memory.
  *
  * The intended use of this class is to represent frequency-dependent
  * things, such as power spectral densities, frequency-dependent
@@ -420,6 +512,28 @@ public:
    */
   SpectrumValue& operator= (double rhs);
 
+  /**
+   * Add the Right Hand Side multiplied by a scalar to *this, component
+   * by component, i.e., *this += x * s without building a temporary
+   *
+   * @param x the SpectrumValue to add
+   * @param s the scalar by which x is multiplied
+   *
+   * @return a reference to *this
+   */
+  SpectrumValue& AddScaled (const SpectrumValue& x, double s);
+
+  /**
+   * Add the component by component product of two SpectrumValues to *this,
+   * i.e., *this += x * y without building a temporary
+   *
+   * @param x the first factor
+   * @param y the second factor
+   *
+   * @return a reference to *this
+   */
+  SpectrumValue& AddProduct (const SpectrumValue& x, const SpectrumValue& y);
+
 
 
   /**
@@ -27,12 +27,18 @@
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/integer.h"
+#include "ns3/uinteger.h"
+#include "ns3/core-config.h"
 #include <algorithm>
 #include <random>
+#include <set>
 #include "ns3/log.h"
 #include <ns3/simulator.h>
 #include "ns3/mobility-model.h"
 #include "ns3/pointer.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
 
 namespace ns3 {
 
@@ -241,7 +247,69 @@ static const double sqrtC_office_NLOS[6][6] = {
   {0, -0.069282, 0.295397, 0.430696, 0.468462, 0.709214},
 };
 
+/**
+ * A channel matrix to be computed by ThreeGppChannelModel::UpdateAllChannels
+ */
+struct ThreeGppChannelModel::ChannelUpdate
+{
+  Ptr<const ThreeGppChannelParams> channelParams; //!< the channel parameters of the link
+  Ptr<const ParamsTable> table3gpp; //!< the 3gpp parameters table
+  Vector sPos; //!< the position of node s
+  Vector uPos; //!< the position of node u
+  Ptr<const PhasedArrayModel> sAntenna; //!< the antenna array of node s
+  Ptr<const PhasedArrayModel> uAntenna; //!< the antenna array of node u
+  Ptr<ChannelMatrix> channelMatrix; //!< the channel matrix to compute
+};
+
+/**
+ * Computes the coefficients of the channel matrices first, first + step,
+ * first + 2 * step, ... of a list of channel updates. The objects are only
+ * accessed through references, so that the reference counts are never
+ * modified concurrently by different tasks.
+ */
+class ThreeGppChannelModel::ChannelUpdateTask
+{
+public:
+  /**
+   * Constructor
+   * \param model the channel model
+   * \param updates the channel updates
+   * \param first the index of the first channel update to compute
+   * \param step the distance between two channel updates computed by this task
+   */
+  ChannelUpdateTask (const ThreeGppChannelModel *model, std::vector<ChannelUpdate> *updates,
+                     std::size_t first, std::size_t step)
+    : m_model (model),
+      m_updates (updates),
+      m_first (first),
+      m_step (step)
+  {
+  }
+  /**
+   * Compute the coefficients of the channel matrices assigned to this task
+   */
+  void Run (void)
+  {
+    for (std::size_t i = m_first; i < m_updates->size (); i += m_step)
+      {
+        ChannelUpdate &update = (*m_updates)[i];
+        bool isSameDirection = (update.channelParams->m_nodeIds == update.channelMatrix->m_nodeIds);
+        m_model->GenerateChannelCoefficients (*update.channelParams, *update.table3gpp, update.sPos, update.uPos,
+                                              isSameDirection, *update.sAntenna, *update.uAntenna,
+                                              update.channelMatrix->m_channel);
+      }
+  }
+
+private:
+  const ThreeGppChannelModel *m_model; //!< the channel model
+  std::vector<ChannelUpdate> *m_updates; //!< the channel updates
+  std::size_t m_first; //!< the index of the first channel update to compute
+  std::size_t m_step; //!< the distance between two channel updates computed by this task
+};
+
 ThreeGppChannelModel::ThreeGppChannelModel ()
+  : m_pregenerateChannels (false),
+    m_numThreads (1)
 {
   NS_LOG_FUNCTION (this);
   m_uniformRv = CreateObject<UniformRandomVariable> ();
@@ -268,6 +336,7 @@ ThreeGppChannelModel::DoDispose ()
     }
   m_channelMatrixMap.clear ();
   m_channelParamsMap.clear ();
+  m_links.clear ();
   m_channelConditionModel = nullptr;
 }
 
@@ -301,6 +370,20 @@ ThreeGppChannelModel::GetTypeId (void)
                    TimeValue (MilliSeconds (0)),
                    MakeTimeAccessor (&ThreeGppChannelModel::m_updatePeriod),
                    MakeTimeChecker ())
+    .AddAttribute ("PregenerateChannels",
+                   "If true and UpdatePeriod is not zero, the channel matrices of all the "
+                   "known links are regenerated together by the first call to GetChannel "
+                   "following every multiple of UpdatePeriod, using NumThreads threads, "
+                   "instead of being regenerated one by one when they are requested",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&ThreeGppChannelModel::m_pregenerateChannels),
+                   MakeBooleanChecker ())
+    .AddAttribute ("NumThreads",
+                   "The number of threads used to compute the channel matrices when "
+                   "PregenerateChannels is true. The results do not depend on this value.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&ThreeGppChannelModel::m_numThreads),
+                   MakeUintegerChecker<uint32_t> (1))
     // attributes for the blockage model
     .AddAttribute ("Blockage",
                    "Enable blockage model A (sec 7.6.4.1)",
@@ -1086,6 +1169,11 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
 {
   NS_LOG_FUNCTION (this);
 
+  if (m_pregenerateChannels && !m_updatePeriod.IsZero () && Simulator::Now () >= m_nextUpdate)
+    {
+      UpdateAllChannels ();
+    }
+
   // Compute the channel params key. The key is reciprocal, i.e., key (a, b) = key (b, a)
   uint64_t channelParamsKey = GetKey (aMob->GetObject<Node> ()->GetId (), bMob->GetObject<Node> ()->GetId ());
   // Compute the channel matrix key. The key is reciprocal, i.e., key (a, b) = key (b, a)
@@ -1166,11 +1254,120 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
 
       // store or replace the channel matrix in the channel map
       m_channelMatrixMap[channelMatrixKey] = channelMatrix;
+
+      if (m_pregenerateChannels)
+        {
+          LinkInfo &link = m_links[channelMatrixKey];
+          link.sMob = aMob;
+          link.uMob = bMob;
+          link.sAntenna = aAntenna;
+          link.uAntenna = bAntenna;
+        }
     }
 
   return channelMatrix;
 }
 
+void
+ThreeGppChannelModel::UpdateAllChannels (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Time now = Simulator::Now ();
+  m_nextUpdate = m_updatePeriod * (now.GetTimeStep () / m_updatePeriod.GetTimeStep () + 1);
+
+  // Regenerate the channel parameters and prepare the channel matrices. The
+  // random variables are only used in this loop, which visits the links in
+  // a deterministic order.
+  std::vector<ChannelUpdate> updates;
+  std::set<uint64_t> updatedParams;
+  for (const auto &link : m_links)
+    {
+      const LinkInfo &info = link.second;
+      uint32_t sNodeId = info.sMob->GetObject<Node> ()->GetId ();
+      uint32_t uNodeId = info.uMob->GetObject<Node> ()->GetId ();
+      uint64_t channelParamsKey = GetKey (sNodeId, uNodeId);
+
+      Ptr<const ChannelCondition> condition = m_channelConditionModel->GetChannelCondition (info.sMob, info.uMob);
+
+      Vector sPos = info.sMob->GetPosition ();
+      Vector uPos = info.uMob->GetPosition ();
+      double x = sPos.x - uPos.x;
+      double y = sPos.y - uPos.y;
+      double distance2D = sqrt (x * x + y * y);
+      // NOTE we assume hUT = min (height(a), height(b)) and
+      // hBS = max (height (a), height (b))
+      double hUt = std::min (sPos.z, uPos.z);
+      double hBs = std::max (sPos.z, uPos.z);
+      Ptr<const ParamsTable> table3gpp = GetThreeGppTable (condition, hBs, hUt, distance2D);
+
+      auto paramsIt = m_channelParamsMap.find (channelParamsKey);
+      NS_ASSERT_MSG (paramsIt != m_channelParamsMap.end (), "No channel params for a known link");
+      Ptr<ThreeGppChannelParams> channelParams = paramsIt->second;
+      // the parameters of a pair of nodes are shared by all their antenna pairs
+      if (updatedParams.insert (channelParamsKey).second
+          && (channelParams->m_generatedTime < now || ChannelParamsNeedsUpdate (channelParams, condition)))
+        {
+          channelParams = GenerateChannelParameters (condition, table3gpp, info.sMob, info.uMob);
+          m_channelParamsMap[channelParamsKey] = channelParams;
+        }
+
+      if (ChannelMatrixNeedsUpdate (channelParams, m_channelMatrixMap[link.first]))
+        {
+          ChannelUpdate update;
+          update.channelParams = channelParams;
+          update.table3gpp = table3gpp;
+          update.sPos = sPos;
+          update.uPos = uPos;
+          update.sAntenna = info.sAntenna;
+          update.uAntenna = info.uAntenna;
+          update.channelMatrix = Create<ChannelMatrix> ();
+          update.channelMatrix->m_generatedTime = now;
+          update.channelMatrix->m_nodeIds = std::make_pair (sNodeId, uNodeId);
+          update.channelMatrix->m_antennaPair = std::make_pair (info.sAntenna->GetId (), info.uAntenna->GetId ());
+          updates.push_back (update);
+        }
+    }
+
+  // Compute the channel coefficients. The calling thread computes its share
+  // of the channel matrices while the other threads are running.
+  std::size_t numTasks = std::min<std::size_t> (m_numThreads, updates.size ());
+#ifndef HAVE_PTHREAD_H
+  numTasks = std::min<std::size_t> (numTasks, 1);
+#endif
+  std::vector<ChannelUpdateTask> tasks;
+  for (std::size_t i = 0; i < numTasks; i++)
+    {
+      tasks.push_back (ChannelUpdateTask (this, &updates, i, numTasks));
+    }
+#ifdef HAVE_PTHREAD_H
+  std::vector<Ptr<SystemThread> > threads;
+  for (std::size_t i = 1; i < numTasks; i++)
+    {
+      threads.push_back (Create<SystemThread> (MakeCallback (&ChannelUpdateTask::Run, &tasks[i])));
+      threads.back ()->Start ();
+    }
+#endif
+  if (numTasks > 0)
+    {
+      tasks[0].Run ();
+    }
+#ifdef HAVE_PTHREAD_H
+  for (auto &thread : threads)
+    {
+      thread->Join ();
+    }
+#endif
+
+  for (const auto &update : updates)
+    {
+      const std::pair<uint32_t, uint32_t> &antennaPair = update.channelMatrix->m_antennaPair;
+      m_channelMatrixMap[GetKey (antennaPair.first, antennaPair.second)] = update.channelMatrix;
+    }
+  NS_LOG_DEBUG ("Regenerated " << updates.size () << " channel matrices of " << m_links.size ()
+                << " links using " << numTasks << " threads");
+}
+
 Ptr<const MatrixBasedChannelModel::ChannelParams>
 ThreeGppChannelModel::GetParams (Ptr<const MobilityModel> aMob,
                                  Ptr<const MobilityModel> bMob) const
@@ -1785,121 +1982,216 @@ ThreeGppChannelModel::GetNewChannel (Ptr<const ThreeGppChannelParams> channelPar
   // check if channelParams structure is generated in direction s-to-u or u-to-s
   bool isSameDirection = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
 
-  MatrixBasedChannelModel::Double2DVector rayAodRadian;
-  MatrixBasedChannelModel::Double2DVector rayAoaRadian;
-  MatrixBasedChannelModel::Double2DVector rayZodRadian;
-  MatrixBasedChannelModel::Double2DVector rayZoaRadian;
+  //Step 11: Generate channel coefficients for each cluster n and each receiver
+  // and transmitter element pair u,s.
+  GenerateChannelCoefficients (*channelParams, *table3gpp, sMob->GetPosition (), uMob->GetPosition (),
+                               isSameDirection, *sAntenna, *uAntenna, channelMatrix->m_channel);
+
+  const Complex3DArray &hUsn = channelMatrix->m_channel;
+  NS_LOG_DEBUG ("Husn (sAntenna, uAntenna):" << sAntenna->GetId () << ", " << uAntenna->GetId ());
+  for (std::size_t uIndex = 0; uIndex < hUsn.GetNumRows (); uIndex++)
+    {
+      for (std::size_t sIndex = 0; sIndex < hUsn.GetNumCols (); sIndex++)
+        {
+          for (std::size_t nIndex = 0; nIndex < hUsn.GetNumPages (); nIndex++)
+            {
+              NS_LOG_DEBUG (" " << hUsn (uIndex, sIndex, nIndex) << ",");
+            }
+        }
+    }
+  NS_LOG_INFO ("size of coefficient matrix =[" << hUsn.GetNumRows () << "][" << hUsn.GetNumCols () << "][" << hUsn.GetNumPages () << "]");
+  return channelMatrix;
+}
 
+void
+ThreeGppChannelModel::GenerateChannelCoefficients (const ThreeGppChannelParams &channelParams,
+                                                   const ParamsTable &table3gpp,
+                                                   const Vector &sPos,
+                                                   const Vector &uPos,
+                                                   bool isSameDirection,
+                                                   const PhasedArrayModel &sAntenna,
+                                                   const PhasedArrayModel &uAntenna,
+                                                   Complex3DArray &hUsn) const
+{
   // if channel params is generated in the same direction in which we
   // generate the channel matrix, angles and zenit od departure and arrival are ok,
   // just set them to corresponding variable that will be used for the generation
   // of channel matrix, otherwise we need to flip angles and zenits of departure and arrival
-  if (isSameDirection)
+  const Double2DVector &rayAodRadian = isSameDirection ? channelParams.m_rayAodRadian : channelParams.m_rayAoaRadian;
+  const Double2DVector &rayAoaRadian = isSameDirection ? channelParams.m_rayAoaRadian : channelParams.m_rayAodRadian;
+  const Double2DVector &rayZodRadian = isSameDirection ? channelParams.m_rayZodRadian : channelParams.m_rayZoaRadian;
+  const Double2DVector &rayZoaRadian = isSameDirection ? channelParams.m_rayZoaRadian : channelParams.m_rayZodRadian;
+
+  uint64_t uSize = uAntenna.GetNumberOfElements ();
+  uint64_t sSize = sAntenna.GetNumberOfElements ();
+  uint8_t numClusters = channelParams.m_reducedClusterNumber;
+  uint8_t raysPerCluster = table3gpp.m_raysPerCluster;
+
+  NS_ASSERT (numClusters <= channelParams.m_clusterPhase.size ());
+  NS_ASSERT (numClusters <= channelParams.m_clusterPower.size ());
+  NS_ASSERT (numClusters <= channelParams.m_crossPolarizationPowerRatios.size ());
+  NS_ASSERT (numClusters <= rayZoaRadian.size ());
+  NS_ASSERT (numClusters <= rayZodRadian.size ());
+  NS_ASSERT (numClusters <= rayAoaRadian.size ());
+  NS_ASSERT (numClusters <= rayAodRadian.size ());
+  NS_ASSERT (raysPerCluster <= channelParams.m_clusterPhase[0].size ());
+  NS_ASSERT (raysPerCluster <= channelParams.m_crossPolarizationPowerRatios[0].size ());
+  NS_ASSERT (raysPerCluster <= rayZoaRadian[0].size ());
+  NS_ASSERT (raysPerCluster <= rayZodRadian[0].size ());
+  NS_ASSERT (raysPerCluster <= rayAoaRadian[0].size ());
+  NS_ASSERT (raysPerCluster <= rayAodRadian[0].size ());
+
+  // channel coffecient hUsn (u, s, n), where u and s are receive and transmit
+  // antenna element, n is cluster index.
+  // NOTE Since each of the strongest 2 clusters are divided into 3 sub-clusters,
+  // the total cluster will be numReducedCLuster + 4. The coefficients of the
+  // second and third sub-clusters are stored after the ones of the N clusters.
+  std::size_t numPages = numClusters;
+  for (uint8_t nIndex = 0; nIndex < numClusters; nIndex++)
     {
-      rayAodRadian = channelParams->m_rayAodRadian;
-      rayAoaRadian = channelParams->m_rayAoaRadian;
-      rayZodRadian = channelParams->m_rayZodRadian;
-      rayZoaRadian = channelParams->m_rayZoaRadian;
+      if (nIndex == channelParams.m_cluster1st || nIndex == channelParams.m_cluster2nd)
+        {
+          numPages += 2;
+        }
     }
-  else
+  hUsn.Resize (uSize, sSize, numPages);
+
+  // The polarization term (which includes the field patterns) and the
+  // direction of each ray do not depend on the antenna elements, hence they
+  // are computed once per ray. The phase terms of each ray are then computed
+  // once per receive element and once per transmit element.
+  std::size_t numRays = numClusters * raysPerCluster;
+  std::vector<std::complex<double> > polarization (numRays);
+  std::vector<Vector> rxDirection (numRays);
+  std::vector<Vector> txDirection (numRays);
+  for (uint8_t nIndex = 0; nIndex < numClusters; nIndex++)
     {
-      rayAodRadian = channelParams->m_rayAoaRadian;
-      rayAoaRadian = channelParams->m_rayAodRadian;
-      rayZodRadian = channelParams->m_rayZoaRadian;
-      rayZoaRadian = channelParams->m_rayZodRadian;
+      bool isWeakCluster = (nIndex != channelParams.m_cluster1st && nIndex != channelParams.m_cluster2nd);
+      for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
+        {
+          std::size_t rIndex = nIndex * raysPerCluster + mIndex;
+          const DoubleVector &initialPhase = channelParams.m_clusterPhase[nIndex][mIndex];
+          NS_ASSERT (4 <= initialPhase.size ());
+          double k = channelParams.m_crossPolarizationPowerRatios[nIndex][mIndex];
+
+          double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
+          if (isWeakCluster)
+            {
+              //Compute the N-2 weakest cluster, assuming 0 slant angle and a
+              //polarization slant angle configured in the array (7.5-22)
+              std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna.GetElementFieldPattern (Angles (channelParams.m_rayAoaRadian[nIndex][mIndex], channelParams.m_rayZoaRadian[nIndex][mIndex]));
+              std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna.GetElementFieldPattern (Angles (channelParams.m_rayAodRadian[nIndex][mIndex], channelParams.m_rayZodRadian[nIndex][mIndex]));
+            }
+          else  //(7.5-28)
+            {
+              std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna.GetElementFieldPattern (Angles (rayAoaRadian[nIndex][mIndex], rayZoaRadian[nIndex][mIndex]));
+              std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna.GetElementFieldPattern (Angles (rayAodRadian[nIndex][mIndex], rayZodRadian[nIndex][mIndex]));
+            }
+          polarization[rIndex] = std::complex<double> (cos (initialPhase[0]), sin (initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
+            std::complex<double> (cos (initialPhase[1]), sin (initialPhase[1])) * std::sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
+            std::complex<double> (cos (initialPhase[2]), sin (initialPhase[2])) * std::sqrt (1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
+            std::complex<double> (cos (initialPhase[3]), sin (initialPhase[3])) * rxFieldPatternPhi * txFieldPatternPhi;
+
+          rxDirection[rIndex] = Vector (sin (rayZoaRadian[nIndex][mIndex]) * cos (rayAoaRadian[nIndex][mIndex]),
+                                        sin (rayZoaRadian[nIndex][mIndex]) * sin (rayAoaRadian[nIndex][mIndex]),
+                                        cos (rayZoaRadian[nIndex][mIndex]));
+          txDirection[rIndex] = Vector (sin (rayZodRadian[nIndex][mIndex]) * cos (rayAodRadian[nIndex][mIndex]),
+                                        sin (rayZodRadian[nIndex][mIndex]) * sin (rayAodRadian[nIndex][mIndex]),
+                                        cos (rayZodRadian[nIndex][mIndex]));
+        }
     }
 
-  //Step 11: Generate channel coefficients for each cluster n and each receiver
-  // and transmitter element pair u,s.
-  Complex3DVector hUsn;  //channel coffecient hUsn[u][s][n];
-  // where u and s are receive and transmit antenna element, n is cluster index.
-  // NOTE Since each of the strongest 2 clusters are divided into 3 sub-clusters,
-  // the total cluster will be numReducedCLuster + 4.
-  uint64_t uSize = uAntenna->GetNumberOfElements ();
-  uint64_t sSize = sAntenna->GetNumberOfElements ();
+  Angles sAngle (uPos, sPos);
+  Angles uAngle (sPos, uPos);
 
-  hUsn.resize (uSize);
+  //lambda_0 is accounted in the antenna spacing uLoc and sLoc.
+  std::vector<std::complex<double> > rxPhase (uSize * numRays);
+  std::vector<std::complex<double> > rxLosPhase (uSize);
   for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
     {
-      hUsn[uIndex].resize (sSize);
-      for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
+      Vector uLoc = uAntenna.GetElementLocation (uIndex);
+      for (std::size_t rIndex = 0; rIndex < numRays; rIndex++)
         {
-          hUsn[uIndex][sIndex].resize (channelParams->m_reducedClusterNumber);
+          double rxPhaseDiff = 2 * M_PI * (rxDirection[rIndex].x * uLoc.x
+                                           + rxDirection[rIndex].y * uLoc.y
+                                           + rxDirection[rIndex].z * uLoc.z);
+          rxPhase[uIndex * numRays + rIndex] = std::complex<double> (cos (rxPhaseDiff), sin (rxPhaseDiff));
         }
+      double rxPhaseDiff = 2 * M_PI * (sin (uAngle.GetInclination ()) * cos (uAngle.GetAzimuth ()) * uLoc.x
+                                       + sin (uAngle.GetInclination ()) * sin (uAngle.GetAzimuth ()) * uLoc.y
+                                       + cos (uAngle.GetInclination ()) * uLoc.z);
+      rxLosPhase[uIndex] = std::complex<double> (cos (rxPhaseDiff), sin (rxPhaseDiff));
+    }
+  std::vector<std::complex<double> > txPhase (sSize * numRays);
+  std::vector<std::complex<double> > txLosPhase (sSize);
+  for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
+    {
+      Vector sLoc = sAntenna.GetElementLocation (sIndex);
+      for (std::size_t rIndex = 0; rIndex < numRays; rIndex++)
+        {
+          double txPhaseDiff = 2 * M_PI * (txDirection[rIndex].x * sLoc.x
+                                           + txDirection[rIndex].y * sLoc.y
+                                           + txDirection[rIndex].z * sLoc.z);
+          txPhase[sIndex * numRays + rIndex] = std::complex<double> (cos (txPhaseDiff), sin (txPhaseDiff));
+        }
+      double txPhaseDiff = 2 * M_PI * (sin (sAngle.GetInclination ()) * cos (sAngle.GetAzimuth ()) * sLoc.x
+                                       + sin (sAngle.GetInclination ()) * sin (sAngle.GetAzimuth ()) * sLoc.y
+                                       + cos (sAngle.GetInclination ()) * sLoc.z);
+      txLosPhase[sIndex] = std::complex<double> (cos (txPhaseDiff), sin (txPhaseDiff));
     }
 
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= channelParams->m_clusterPhase.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= channelParams->m_clusterPower.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= channelParams->m_crossPolarizationPowerRatios.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= rayZoaRadian.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= rayZodRadian.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= rayAoaRadian.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= rayAodRadian.size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= channelParams->m_clusterPhase[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= channelParams->m_crossPolarizationPowerRatios[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= rayZoaRadian[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= rayZodRadian[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= rayAoaRadian[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= rayAodRadian[0].size ());
-
-
-  double x = sMob->GetPosition ().x - uMob->GetPosition ().x;
-  double y = sMob->GetPosition ().y - uMob->GetPosition ().y;
-  double distance2D = sqrt (x * x + y * y);
-  // NOTE we assume hUT = min (height(a), height(b)) and
-  // hBS = max (height (a), height (b))
-  double hUt = std::min (sMob->GetPosition ().z, uMob->GetPosition ().z);
-  double hBs = std::max (sMob->GetPosition ().z, uMob->GetPosition ().z);
-  // compute the 3D distance using eq. 7.4-1
-  double distance3D = std::sqrt (distance2D * distance2D + (hBs - hUt) * (hBs - hUt));
-
-  Angles sAngle (uMob->GetPosition (), sMob->GetPosition ());
-  Angles uAngle (sMob->GetPosition (), uMob->GetPosition ());
-
+  // the terms of the LOS ray (7.5-29) which do not depend on the antenna elements
+  bool isLos = (channelParams.m_losCondition == ChannelCondition::LOS);
+  std::complex<double> losRay (0, 0);
+  double kLinear = 0;
+  if (isLos)
+    {
+      double x = sPos.x - uPos.x;
+      double y = sPos.y - uPos.y;
+      double distance2D = sqrt (x * x + y * y);
+      // NOTE we assume hUT = min (height(a), height(b)) and
+      // hBS = max (height (a), height (b))
+      double hUt = std::min (sPos.z, uPos.z);
+      double hBs = std::max (sPos.z, uPos.z);
+      // compute the 3D distance using eq. 7.4-1
+      double distance3D = std::sqrt (distance2D * distance2D + (hBs - hUt) * (hBs - hUt));
+
+      double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
+      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna.GetElementFieldPattern (Angles (uAngle.GetAzimuth (), uAngle.GetInclination ()));
+      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna.GetElementFieldPattern (Angles (sAngle.GetAzimuth (), sAngle.GetInclination ()));
+
+      double lambda = 3e8 / m_frequency; // the wavelength of the carrier frequency
+
+      losRay = (rxFieldPatternTheta * txFieldPatternTheta - rxFieldPatternPhi * txFieldPatternPhi)
+        * std::complex<double> (cos (-2 * M_PI * distance3D / lambda), sin (-2 * M_PI * distance3D / lambda));
+      kLinear = pow (10, channelParams.m_K_factor / 10);
+    }
 
   // The following for loops computes the channel coefficients
   for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
     {
-      Vector uLoc = uAntenna->GetElementLocation (uIndex);
+      const std::complex<double> *uPhase = &rxPhase[uIndex * numRays];
 
       for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
         {
-          Vector sLoc = sAntenna->GetElementLocation (sIndex);
+          const std::complex<double> *sPhase = &txPhase[sIndex * numRays];
+          std::size_t subClusterIndex = numClusters;
 
-          for (uint8_t nIndex = 0; nIndex < channelParams->m_reducedClusterNumber; nIndex++)
+          for (uint8_t nIndex = 0; nIndex < numClusters; nIndex++)
             {
-              //Compute the N-2 weakest cluster, assuming 0 slant angle and a
-              //polarization slant angle configured in the array (7.5-22)
-              if (nIndex != channelParams->m_cluster1st && nIndex != channelParams->m_cluster2nd)
+              const std::complex<double> *clusterPolarization = &polarization[nIndex * raysPerCluster];
+              const std::complex<double> *clusterRxPhase = uPhase + nIndex * raysPerCluster;
+              const std::complex<double> *clusterTxPhase = sPhase + nIndex * raysPerCluster;
+              // NOTE Doppler is computed in the CalcBeamformingGain function and is simplified to only account for the center angle of each cluster.
+              if (nIndex != channelParams.m_cluster1st && nIndex != channelParams.m_cluster2nd)
                 {
                   std::complex<double> rays (0,0);
-                  for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
+                  for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
                     {
-                      DoubleVector initialPhase = channelParams->m_clusterPhase[nIndex][mIndex];
-                      double k = channelParams->m_crossPolarizationPowerRatios[nIndex][mIndex];
-                      //lambda_0 is accounted in the antenna spacing uLoc and sLoc.
-                      double rxPhaseDiff = 2 * M_PI * (sin (rayZoaRadian[nIndex][mIndex]) * cos (rayAoaRadian[nIndex][mIndex]) * uLoc.x
-                                                       + sin (rayZoaRadian[nIndex][mIndex]) * sin (rayAoaRadian[nIndex][mIndex]) * uLoc.y
-                                                       + cos (rayZoaRadian[nIndex][mIndex]) * uLoc.z);
-
-                      double txPhaseDiff = 2 * M_PI * (sin (rayZodRadian[nIndex][mIndex]) * cos (rayAodRadian[nIndex][mIndex]) * sLoc.x
-                                                       + sin (rayZodRadian[nIndex][mIndex]) * sin (rayAodRadian[nIndex][mIndex]) * sLoc.y
-                                                       + cos (rayZodRadian[nIndex][mIndex]) * sLoc.z);
-                      // NOTE Doppler is computed in the CalcBeamformingGain function and is simplified to only account for the center angle of each cluster.
-
-                      double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
-                      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (channelParams->m_rayAoaRadian[nIndex][mIndex], channelParams->m_rayZoaRadian[nIndex][mIndex]));
-                      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (channelParams->m_rayAodRadian[nIndex][mIndex], channelParams->m_rayZodRadian[nIndex][mIndex]));
-                      NS_ASSERT (4 <= initialPhase.size ());
-                      rays += (std::complex<double> (cos (initialPhase[0]), sin (initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
-                               std::complex<double> (cos (initialPhase[1]), sin (initialPhase[1])) * std::sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
-                               std::complex<double> (cos (initialPhase[2]), sin (initialPhase[2])) * std::sqrt (1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
-                               std::complex<double> (cos (initialPhase[3]), sin (initialPhase[3])) * rxFieldPatternPhi * txFieldPatternPhi)
-                        * std::complex<double> (cos (rxPhaseDiff), sin (rxPhaseDiff))
-                        * std::complex<double> (cos (txPhaseDiff), sin (txPhaseDiff));
+                      rays += clusterPolarization[mIndex] * clusterRxPhase[mIndex] * clusterTxPhase[mIndex];
                     }
-                  rays *= sqrt (channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                  hUsn[uIndex][sIndex][nIndex] = rays;
+                  rays *= sqrt (channelParams.m_clusterPower[nIndex] / raysPerCluster);
+                  hUsn (uIndex, sIndex, nIndex) = rays;
                 }
               else  //(7.5-28)
                 {
@@ -1907,31 +2199,10 @@ ThreeGppChannelModel::GetNewChannel (Ptr<const ThreeGppChannelParams> channelPar
                   std::complex<double> raysSub2 (0, 0);
                   std::complex<double> raysSub3 (0, 0);
 
-                  for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
+                  for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
                     {
-                      double k = channelParams->m_crossPolarizationPowerRatios[nIndex][mIndex];
-
                       //ZML:Just remind me that the angle offsets for the 3 subclusters were not generated correctly.
-                      DoubleVector initialPhase = channelParams->m_clusterPhase[nIndex][mIndex];
-                      NS_ASSERT (4 <= initialPhase.size ());
-
-                      double rxPhaseDiff = 2 * M_PI * (sin (rayZoaRadian[nIndex][mIndex]) * cos (rayAoaRadian[nIndex][mIndex]) * uLoc.x
-                                                       + sin (rayZoaRadian[nIndex][mIndex]) * sin (rayAoaRadian[nIndex][mIndex]) * uLoc.y
-                                                       + cos (rayZoaRadian[nIndex][mIndex]) * uLoc.z);
-                      double txPhaseDiff = 2 * M_PI * (sin (rayZodRadian[nIndex][mIndex]) * cos (rayAodRadian[nIndex][mIndex]) * sLoc.x
-                                                       + sin (rayZodRadian[nIndex][mIndex]) * sin (rayAodRadian[nIndex][mIndex]) * sLoc.y
-                                                       + cos (rayZodRadian[nIndex][mIndex]) * sLoc.z);
-
-                      double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
-                      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (rayAoaRadian[nIndex][mIndex], rayZoaRadian[nIndex][mIndex]));
-                      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (rayAodRadian[nIndex][mIndex], rayZodRadian[nIndex][mIndex]));
-
-                      std::complex<double> raySub = (std::complex<double> (cos (initialPhase[0]), sin (initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
-                                                     std::complex<double> (cos (initialPhase[1]), sin (initialPhase[1])) * sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
-                                                     std::complex<double> (cos (initialPhase[2]), sin (initialPhase[2])) * sqrt (1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
-                                                     std::complex<double> (cos (initialPhase[3]), sin (initialPhase[3])) * rxFieldPatternPhi * txFieldPatternPhi)
-                        * std::complex<double> (cos (rxPhaseDiff), sin (rxPhaseDiff))
-                        * std::complex<double> (cos (txPhaseDiff), sin (txPhaseDiff));
+                      std::complex<double> raySub = clusterPolarization[mIndex] * clusterRxPhase[mIndex] * clusterTxPhase[mIndex];
 
                       switch (mIndex)
                         {
@@ -1954,62 +2225,28 @@ ThreeGppChannelModel::GetNewChannel (Ptr<const ThreeGppChannelParams> channelPar
                             break;
                         }
                     }
-                  raysSub1 *= sqrt (channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                  raysSub2 *= sqrt (channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                  raysSub3 *= sqrt (channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                  hUsn[uIndex][sIndex][nIndex] = raysSub1;
-                  hUsn[uIndex][sIndex].push_back (raysSub2);
-                  hUsn[uIndex][sIndex].push_back (raysSub3);
+                  raysSub1 *= sqrt (channelParams.m_clusterPower[nIndex] / raysPerCluster);
+                  raysSub2 *= sqrt (channelParams.m_clusterPower[nIndex] / raysPerCluster);
+                  raysSub3 *= sqrt (channelParams.m_clusterPower[nIndex] / raysPerCluster);
+                  hUsn (uIndex, sIndex, nIndex) = raysSub1;
+                  hUsn (uIndex, sIndex, subClusterIndex++) = raysSub2;
+                  hUsn (uIndex, sIndex, subClusterIndex++) = raysSub3;
                 }
             }
 
-          if (channelParams->m_losCondition == ChannelCondition::LOS) //(7.5-29) && (7.5-30)
+          if (isLos) //(7.5-29) && (7.5-30)
             {
-              std::complex<double> ray (0, 0);
-              double rxPhaseDiff = 2 * M_PI * (sin (uAngle.GetInclination ()) * cos (uAngle.GetAzimuth ()) * uLoc.x
-                                               + sin (uAngle.GetInclination ()) * sin (uAngle.GetAzimuth ()) * uLoc.y
-                                               + cos (uAngle.GetInclination ()) * uLoc.z);
-              double txPhaseDiff = 2 * M_PI * (sin (sAngle.GetInclination ()) * cos (sAngle.GetAzimuth ()) * sLoc.x
-                                               + sin (sAngle.GetInclination ()) * sin (sAngle.GetAzimuth ()) * sLoc.y
-                                               + cos (sAngle.GetInclination ()) * sLoc.z);
-
-              double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
-              std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (uAngle.GetAzimuth (), uAngle.GetInclination ()));
-              std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (sAngle.GetAzimuth (), sAngle.GetInclination ()));
-
-              double lambda = 3e8 / m_frequency; // the wavelength of the carrier frequency
-
-              ray = (rxFieldPatternTheta * txFieldPatternTheta - rxFieldPatternPhi * txFieldPatternPhi)
-                * std::complex<double> (cos (-2 * M_PI * distance3D / lambda), sin (-2 * M_PI * distance3D / lambda))
-                * std::complex<double> (cos (rxPhaseDiff), sin (rxPhaseDiff))
-                * std::complex<double> (cos (txPhaseDiff), sin (txPhaseDiff));
-
-              double kLinear = pow (10, channelParams->m_K_factor / 10);
+              std::complex<double> ray = losRay * rxLosPhase[uIndex] * txLosPhase[sIndex];
+
               // the LOS path should be attenuated if blockage is enabled.
-              hUsn[uIndex][sIndex][0] = sqrt (1 / (kLinear + 1)) * hUsn[uIndex][sIndex][0] + sqrt (kLinear / (1 + kLinear)) * ray / pow (10, channelParams->m_attenuation_dB[0] / 10);           //(7.5-30) for tau = tau1
-              double tempSize = hUsn[uIndex][sIndex].size ();
-              for (uint8_t nIndex = 1; nIndex < tempSize; nIndex++)
+              hUsn (uIndex, sIndex, 0) = sqrt (1 / (kLinear + 1)) * hUsn (uIndex, sIndex, 0) + sqrt (kLinear / (1 + kLinear)) * ray / pow (10, channelParams.m_attenuation_dB[0] / 10);           //(7.5-30) for tau = tau1
+              for (std::size_t nIndex = 1; nIndex < numPages; nIndex++)
                 {
-                  hUsn[uIndex][sIndex][nIndex] *= sqrt (1 / (kLinear + 1)); //(7.5-30) for tau = tau2...taunN
+                  hUsn (uIndex, sIndex, nIndex) *= sqrt (1 / (kLinear + 1)); //(7.5-30) for tau = tau2...taunN
                 }
             }
         }
     }
-
-  NS_LOG_DEBUG ("Husn (sAntenna, uAntenna):" << sAntenna->GetId () << ", " << uAntenna->GetId ());
-  for (auto& i:hUsn)
-    {
-      for (auto& j:i)
-        {
-          for (auto& k:j)
-            {
-              NS_LOG_DEBUG (" " << k << ",");
-            }
-        }
-    }
-  NS_LOG_INFO ("size of coefficient matrix =[" << hUsn.size () << "][" << hUsn[0].size () << "][" << hUsn[0][0].size () << "]");
-  channelMatrix->m_channel = hUsn;
-  return channelMatrix;
 }
 
 std::pair<double, double>
@@ -29,6 +29,7 @@
 #include <ns3/random-variable-stream.h>
 #include <ns3/boolean.h>
 #include <unordered_map>
+#include <map>
 #include <ns3/channel-condition-model.h>
 #include <ns3/matrix-based-channel-model.h>
 
@@ -108,6 +109,10 @@ public:
    * be updated, it generates a new uncorrelated channel matrix using the
    * method GetNewChannel and updates m_channelMap.
    *
+   * If the PregenerateChannels attribute is true and UpdatePeriod is not
+   * zero, the first call following an UpdatePeriod boundary regenerates the
+   * channel matrices of all the known links (see UpdateAllChannels).
+   *
    * \param aMob mobility model of the a device
    * \param bMob mobility model of the b device
    * \param aAntenna antenna of the a device
@@ -283,6 +288,42 @@ protected:
                                     const Ptr<const MobilityModel> uMob,
                                     Ptr<const PhasedArrayModel> sAntenna,
                                     Ptr<const PhasedArrayModel> uAntenna) const;
+
+  /**
+   * Compute the channel coefficients H[u][s][n] between the antenna arrays
+   * of the nodes s and u (Step 11 of 3GPP TR 38.901).
+   *
+   * This method does not draw any random value and does not modify any
+   * object, hence it can be called concurrently for different channel
+   * matrices.
+   *
+   * \param channelParams the channel parameters previously generated for the pair of nodes s and u
+   * \param table3gpp the 3gpp parameters table
+   * \param sPos the position of node s
+   * \param uPos the position of node u
+   * \param isSameDirection true if the channel parameters were generated with s as transmitter
+   * \param sAntenna the antenna array of node s
+   * \param uAntenna the antenna array of node u
+   * \param hUsn the array storing the channel coefficients
+   */
+  void GenerateChannelCoefficients (const ThreeGppChannelParams &channelParams,
+                                    const ParamsTable &table3gpp,
+                                    const Vector &sPos,
+                                    const Vector &uPos,
+                                    bool isSameDirection,
+                                    const PhasedArrayModel &sAntenna,
+                                    const PhasedArrayModel &uAntenna,
+                                    Complex3DArray &hUsn) const;
+
+  /**
+   * Regenerate the channel parameters and the channel matrices of all the
+   * links for which a channel matrix was generated, as if they all expired
+   * now. The random variables are drawn by the calling thread, one link
+   * after the other in increasing order of channel matrix key. The channel
+   * coefficients are then computed by NumThreads threads. Hence, the
+   * results do not depend on the number of threads.
+   */
+  void UpdateAllChannels (void);
   /**
    * Applies the blockage model A described in 3GPP TR 38.901
    * \param channelParams the channel parameters structure
@@ -315,6 +356,26 @@ protected:
   std::unordered_map<uint64_t, Ptr<ChannelMatrix> > m_channelMatrixMap; //!< map containing the channel realizations per pair of PhasedAntennaArray instances, the key of this map is reciprocal uniquely identifies a pair of PhasedAntennaArrays
   std::unordered_map<uint64_t, Ptr<ThreeGppChannelParams> > m_channelParamsMap; //!< map containing the common channel parameters per pair of nodes, the key of this map is reciprocal and uniquely identifies a pair of nodes
   Time m_updatePeriod; //!< the channel update period
+
+  /**
+   * The mobility models and the antenna arrays of a link, in the order
+   * used to generate its last channel matrix
+   */
+  struct LinkInfo
+  {
+    Ptr<const MobilityModel> sMob; //!< the mobility model of node s
+    Ptr<const MobilityModel> uMob; //!< the mobility model of node u
+    Ptr<const PhasedArrayModel> sAntenna; //!< the antenna array of node s
+    Ptr<const PhasedArrayModel> uAntenna; //!< the antenna array of node u
+  };
+
+  struct ChannelUpdate; //!< a channel matrix to be computed by UpdateAllChannels
+  class ChannelUpdateTask; //!< computes a subset of the channel matrices in UpdateAllChannels
+
+  bool m_pregenerateChannels; //!< whether the channel matrices of all the links are regenerated at every update period
+  uint32_t m_numThreads; //!< the number of threads computing the channel matrices in UpdateAllChannels
+  Time m_nextUpdate; //!< the time of the next UpdatePeriod boundary
+  std::map<uint64_t, LinkInfo> m_links; //!< the known links, indexed by channel matrix key
   double m_frequency; //!< the operating frequency
   std::string m_scenario; //!< the 3GPP scenario
   Ptr<ChannelConditionModel> m_channelConditionModel; //!< the channel condition model
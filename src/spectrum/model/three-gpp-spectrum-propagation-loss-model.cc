@@ -87,6 +87,13 @@ ThreeGppSpectrumPropagationLossModel::GetChannelModel () const
 double
 ThreeGppSpectrumPropagationLossModel::GetFrequency () const
 {
+  // read the frequency directly if possible, since looking up the attribute
+  // is slow compared to the computation of the beamforming gain
+  Ptr<const ThreeGppChannelModel> threeGppChannelModel = DynamicCast<const ThreeGppChannelModel> (m_channelModel);
+  if (threeGppChannelModel)
+    {
+      return threeGppChannelModel->GetFrequency ();
+    }
   DoubleValue freq;
   m_channelModel->GetAttribute ("Frequency", freq);
   return freq.Get ();
@@ -114,55 +121,45 @@ ThreeGppSpectrumPropagationLossModel::CalcLongTerm (Ptr<const MatrixBasedChannel
   uint16_t sAntenna = static_cast<uint16_t> (sW.size ());
   uint16_t uAntenna = static_cast<uint16_t> (uW.size ());
 
-  NS_ASSERT (uAntenna == params->m_channel.size ());
-  NS_ASSERT (sAntenna == params->m_channel.at (0).size());
+  NS_ASSERT (uAntenna == params->m_channel.GetNumRows ());
+  NS_ASSERT (sAntenna == params->m_channel.GetNumCols ());
 
   NS_LOG_DEBUG ("CalcLongTerm with sAntenna " << sAntenna << " uAntenna " << uAntenna);
   //store the long term part to reduce computation load
   //only the small scale fading needs to be updated if the large scale parameters and antenna weights remain unchanged.
-  PhasedArrayModel::ComplexVector longTerm;
-  uint8_t numCluster = static_cast<uint8_t> (params->m_channel[0][0].size ());
-
-  NS_ASSERT (uAntenna == params->m_channel.size ());
-  NS_ASSERT (sAntenna == params->m_channel.at (0).size());
+  uint8_t numCluster = static_cast<uint8_t> (params->m_channel.GetNumPages ());
+  PhasedArrayModel::ComplexVector longTerm (numCluster);
 
   for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
     {
+      // the elements of a cluster matrix are stored column by column, i.e.,
+      // the u elements associated with an s element are contiguous
+      const std::complex<double> *h = params->m_channel.GetPage (cIndex);
       std::complex<double> txSum (0, 0);
       for (uint16_t sIndex = 0; sIndex < sAntenna; sIndex++)
         {
           std::complex<double> rxSum (0, 0);
           for (uint16_t uIndex = 0; uIndex < uAntenna; uIndex++)
             {
-              rxSum = rxSum + uW[uIndex] * params->m_channel[uIndex][sIndex][cIndex];
+              rxSum = rxSum + uW[uIndex] * h[uIndex];
             }
           txSum = txSum + sW[sIndex] * rxSum;
+          h += uAntenna;
         }
-      longTerm.push_back (txSum);
+      longTerm[cIndex] = txSum;
     }
   return longTerm;
 }
 
-Ptr<SpectrumValue>
-ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> txPsd,
-                                                           PhasedArrayModel::ComplexVector longTerm,
-                                                           Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
-                                                           Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
-                                                           const ns3::Vector &sSpeed, const ns3::Vector &uSpeed) const
+MatrixBasedChannelModel::DoubleVector
+ThreeGppSpectrumPropagationLossModel::CalcDoppler (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                                                   Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
+                                                   const ns3::Vector &sSpeed, const ns3::Vector &uSpeed) const
 {
   NS_LOG_FUNCTION (this);
 
-  Ptr<SpectrumValue> tempPsd = Copy<SpectrumValue> (txPsd);
-
   //channel[rx][tx][cluster]
-  uint8_t numCluster = static_cast<uint8_t> (channelMatrix->m_channel[0][0].size ());
-
-  // compute the doppler term
-  // NOTE the update of Doppler is simplified by only taking the center angle of
-  // each cluster in to consideration.
-  double slotTime = Simulator::Now ().GetSeconds ();
-  double factor = 2 * M_PI * slotTime * GetFrequency () / 3e8;
-  PhasedArrayModel::ComplexVector doppler;
+  uint8_t numCluster = static_cast<uint8_t> (channelMatrix->m_channel.GetNumPages ());
 
   // The following asserts might seem paranoic, but it is important to
   // make sure that all the structures that are passed to this function
@@ -175,35 +172,20 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> tx
   NS_ASSERT (numCluster <= channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX].size());
   NS_ASSERT (numCluster <= channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX].size());
   NS_ASSERT (numCluster <= channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX].size());
-  NS_ASSERT (numCluster <= longTerm.size());
 
   // check if channelParams structure is generated in direction s-to-u or u-to-s
   bool isSameDirection = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
 
-  MatrixBasedChannelModel::DoubleVector zoa;
-  MatrixBasedChannelModel::DoubleVector zod;
-  MatrixBasedChannelModel::DoubleVector aoa;
-  MatrixBasedChannelModel::DoubleVector aod;
-
   // if channel params is generated in the same direction in which we
   // generate the channel matrix, angles and zenit od departure and arrival are ok,
   // just set them to corresponding variable that will be used for the generation
   // of channel matrix, otherwise we need to flip angles and zenits of departure and arrival
-  if (isSameDirection)
-    {
-      zoa = channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX];
-      zod = channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX];
-      aoa = channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX];
-      aod = channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX];
-    }
-  else
-    {
-      zod = channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX];
-      zoa = channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX];
-      aod = channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX];
-      aoa = channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX];
-    }
+  const MatrixBasedChannelModel::DoubleVector &zoa = channelParams->m_angle[isSameDirection ? MatrixBasedChannelModel::ZOA_INDEX : MatrixBasedChannelModel::ZOD_INDEX];
+  const MatrixBasedChannelModel::DoubleVector &zod = channelParams->m_angle[isSameDirection ? MatrixBasedChannelModel::ZOD_INDEX : MatrixBasedChannelModel::ZOA_INDEX];
+  const MatrixBasedChannelModel::DoubleVector &aoa = channelParams->m_angle[isSameDirection ? MatrixBasedChannelModel::AOA_INDEX : MatrixBasedChannelModel::AOD_INDEX];
+  const MatrixBasedChannelModel::DoubleVector &aod = channelParams->m_angle[isSameDirection ? MatrixBasedChannelModel::AOD_INDEX : MatrixBasedChannelModel::AOA_INDEX];
 
+  MatrixBasedChannelModel::DoubleVector doppler (numCluster);
   for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
     {
       // Compute alpha and D as described in 3GPP TR 37.885 v15.3.0, Sec. 6.2.3
@@ -221,104 +203,204 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> tx
       double D = channelParams->m_D [cIndex];
 
       //cluster angle angle[direction][n], where direction = 0(aoa), 1(zoa).
-      double tempDoppler = factor * ((sin (zoa [cIndex] * M_PI / 180) * cos (aoa [cIndex] * M_PI / 180) * uSpeed.x
-                                       + sin (zoa [cIndex] * M_PI / 180) * sin (aoa [cIndex] * M_PI / 180) * uSpeed.y
-                                       + cos (zoa [cIndex] * M_PI / 180) * uSpeed.z)
-                                       + (sin (zod [cIndex] * M_PI / 180) * cos (aod [cIndex] * M_PI / 180) * sSpeed.x
-                                       + sin (zod [cIndex] * M_PI / 180) * sin (aod [cIndex] * M_PI / 180) * sSpeed.y
-                                       + cos (zod [cIndex] * M_PI / 180) * sSpeed.z) + 2 * alpha * D);
-      doppler.push_back (std::complex<double> (cos (tempDoppler), sin (tempDoppler)));
+      // NOTE the update of Doppler is simplified by only taking the center angle of
+      // each cluster in to consideration.
+      doppler[cIndex] = (sin (zoa [cIndex] * M_PI / 180) * cos (aoa [cIndex] * M_PI / 180) * uSpeed.x
+                         + sin (zoa [cIndex] * M_PI / 180) * sin (aoa [cIndex] * M_PI / 180) * uSpeed.y
+                         + cos (zoa [cIndex] * M_PI / 180) * uSpeed.z)
+                        + (sin (zod [cIndex] * M_PI / 180) * cos (aod [cIndex] * M_PI / 180) * sSpeed.x
+                           + sin (zod [cIndex] * M_PI / 180) * sin (aod [cIndex] * M_PI / 180) * sSpeed.y
+                           + cos (zod [cIndex] * M_PI / 180) * sSpeed.z) + 2 * alpha * D;
     }
+  return doppler;
+}
 
-  NS_ASSERT (numCluster <= doppler.size());
+void
+ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> psd,
+                                                           Ptr<const LongTerm> longTerm,
+                                                           Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams) const
+{
+  NS_LOG_FUNCTION (this);
+
+  std::size_t numCluster = longTerm->m_doppler.size ();
+  NS_ASSERT (numCluster <= longTerm->m_longTerm.size ());
+  NS_ASSERT (numCluster <= channelParams->m_delay.size ());
+
+  // compute the doppler term
+  double slotTime = Simulator::Now ().GetSeconds ();
+  double factor = 2 * M_PI * slotTime * GetFrequency () / 3e8;
 
-  // apply the doppler term and the propagation delay to the long term component
-  // to obtain the beamforming gain
-  auto vit = tempPsd->ValuesBegin (); // psd iterator
-  auto sbit = tempPsd->ConstBandsBegin (); // band iterator
-  while (vit != tempPsd->ValuesEnd ())
+  // only the bands between the first and the last band with a non-null PSD
+  // need to be considered
+  std::size_t numBands = psd->GetValuesN ();
+  std::size_t first = 0;
+  while (first < numBands && (*psd)[first] == 0.0)
     {
-      if ((*vit) != 0.00)
+      first++;
+    }
+  if (first == numBands)
+    {
+      return;
+    }
+  std::size_t last = numBands - 1;
+  while ((*psd)[last] == 0.0)
+    {
+      last--;
+    }
+  Bands::const_iterator bands = psd->ConstBandsBegin ();
+
+  // check if the bands are equally spaced
+  double step = 0.0;
+  bool isUniform = (last > first);
+  if (isUniform)
+    {
+      step = (bands[last].fc - bands[first].fc) / (last - first);
+      for (std::size_t i = first + 1; isUniform && i <= last; i++)
         {
-          std::complex<double> subsbandGain (0.0, 0.0);
-          double fsb = (*sbit).fc; // center frequency of the sub-band
-          for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
+          isUniform = (std::abs (bands[i].fc - bands[i - 1].fc - step) <= 1e-9 * std::abs (step));
+        }
+    }
+
+  if (!isUniform)
+    {
+      // apply the doppler term and the propagation delay to the long term component
+      // of each band to obtain the beamforming gain
+      for (std::size_t i = first; i <= last; i++)
+        {
+          if ((*psd)[i] != 0.0)
+            {
+              std::complex<double> subsbandGain (0.0, 0.0);
+              double fsb = bands[i].fc; // center frequency of the sub-band
+              for (std::size_t cIndex = 0; cIndex < numCluster; cIndex++)
+                {
+                  double tempDoppler = factor * longTerm->m_doppler[cIndex];
+                  double delay = -2 * M_PI * fsb * (channelParams->m_delay[cIndex]);
+                  subsbandGain = subsbandGain + longTerm->m_longTerm[cIndex] * std::complex<double> (cos (tempDoppler), sin (tempDoppler))
+                    * std::complex<double> (cos (delay), sin (delay));
+                }
+              (*psd)[i] = (*psd)[i] * (norm (subsbandGain));
+            }
+        }
+      return;
+    }
+
+  // The term of the cluster n for the band i + 1 is the term for the band i
+  // rotated by exp (-j 2 pi step tau_n). The bands are processed in blocks of
+  // numLanes consecutive bands, each lane holding the term of one band of
+  // the block, which is rotated by numLanes bands at a time. The real and
+  // imaginary parts are kept in separate arrays so that the lanes can be
+  // vectorized by the compiler.
+  const std::size_t numLanes = 4;
+  std::size_t numUsedBands = last - first + 1;
+  m_gainReal.assign (numUsedBands, 0.0);
+  m_gainImag.assign (numUsedBands, 0.0);
+  double *gainReal = m_gainReal.data ();
+  double *gainImag = m_gainImag.data ();
+  for (std::size_t cIndex = 0; cIndex < numCluster; cIndex++)
+    {
+      double tau = channelParams->m_delay[cIndex];
+      double phase = factor * longTerm->m_doppler[cIndex] - 2 * M_PI * bands[first].fc * tau;
+      std::complex<double> term = longTerm->m_longTerm[cIndex] * std::complex<double> (cos (phase), sin (phase));
+      std::complex<double> bandRotation (cos (-2 * M_PI * step * tau), sin (-2 * M_PI * step * tau));
+
+      double termReal[numLanes];
+      double termImag[numLanes];
+      for (std::size_t lane = 0; lane < numLanes; lane++)
+        {
+          termReal[lane] = term.real ();
+          termImag[lane] = term.imag ();
+          term *= bandRotation;
+        }
+      std::complex<double> blockRotation = bandRotation * bandRotation;
+      blockRotation *= blockRotation;
+      double rotationReal = blockRotation.real ();
+      double rotationImag = blockRotation.imag ();
+
+      std::size_t i = 0;
+      for (; i + numLanes <= numUsedBands; i += numLanes)
+        {
+          for (std::size_t lane = 0; lane < numLanes; lane++)
             {
-              double delay = -2 * M_PI * fsb * (channelParams->m_delay[cIndex]);
-              subsbandGain = subsbandGain + longTerm[cIndex] * doppler[cIndex] * std::complex<double> (cos (delay), sin (delay));
+              gainReal[i + lane] += termReal[lane];
+              gainImag[i + lane] += termImag[lane];
+              double real = termReal[lane] * rotationReal - termImag[lane] * rotationImag;
+              termImag[lane] = termReal[lane] * rotationImag + termImag[lane] * rotationReal;
+              termReal[lane] = real;
             }
-          *vit = (*vit) * (norm (subsbandGain));
         }
-      vit++;
-      sbit++;
+      for (std::size_t lane = 0; i + lane < numUsedBands; lane++)
+        {
+          gainReal[i + lane] += termReal[lane];
+          gainImag[i + lane] += termImag[lane];
+        }
+    }
+
+  Values::iterator vit = psd->ValuesBegin () + first;
+  for (std::size_t i = 0; i < numUsedBands; i++, vit++)
+    {
+      *vit *= gainReal[i] * gainReal[i] + gainImag[i] * gainImag[i];
     }
-  return tempPsd;
 }
 
-PhasedArrayModel::ComplexVector
+Ptr<const ThreeGppSpectrumPropagationLossModel::LongTerm>
 ThreeGppSpectrumPropagationLossModel::GetLongTerm (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                                                   Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
                                                    Ptr<const PhasedArrayModel> aPhasedArrayModel,
-                                                   Ptr<const PhasedArrayModel> bPhasedArrayModel) const
+                                                   Ptr<const PhasedArrayModel> bPhasedArrayModel,
+                                                   const Vector &sSpeed, const Vector &uSpeed) const
 {
-  PhasedArrayModel::ComplexVector longTerm; // vector containing the long term component for each cluster
-
   // check if the channel matrix was generated considering a as the s-node and
   // b as the u-node or viceversa
-  PhasedArrayModel::ComplexVector sW, uW;
-  if (!channelMatrix->IsReverse (aPhasedArrayModel->GetId (), bPhasedArrayModel->GetId ()))
-  {
-    sW = aPhasedArrayModel->GetBeamformingVector ();
-    uW = bPhasedArrayModel->GetBeamformingVector ();
-  }
-  else
-  {
-    sW = bPhasedArrayModel->GetBeamformingVector ();
-    uW = aPhasedArrayModel->GetBeamformingVector ();
-  }
-
-  bool update = false; // indicates whether the long term has to be updated
-  bool notFound = false; // indicates if the long term has not been computed yet
+  bool isReverse = channelMatrix->IsReverse (aPhasedArrayModel->GetId (), bPhasedArrayModel->GetId ());
+  PhasedArrayModel::ComplexVector sW = (isReverse ? bPhasedArrayModel : aPhasedArrayModel)->GetBeamformingVector ();
+  PhasedArrayModel::ComplexVector uW = (isReverse ? aPhasedArrayModel : bPhasedArrayModel)->GetBeamformingVector ();
 
   // compute the long term key, the key is unique for each tx-rx pair
   uint64_t longTermId = MatrixBasedChannelModel::GetKey (aPhasedArrayModel->GetId (), bPhasedArrayModel->GetId ());
 
   // look for the long term in the map and check if it is valid
-  if (m_longTermMap.find (longTermId) != m_longTermMap.end ())
+  Ptr<LongTerm> longTermItem;
+  auto it = m_longTermMap.find (longTermId);
+  if (it != m_longTermMap.end ())
     {
       NS_LOG_DEBUG ("found the long term component in the map");
-      longTerm = m_longTermMap[longTermId]->m_longTerm;
-
-      // check if the channel matrix has been updated
-      // or the s beam has been changed
-      // or the u beam has been changed
-      update = (m_longTermMap[longTermId]->m_channel->m_generatedTime != channelMatrix->m_generatedTime
-                || m_longTermMap[longTermId]->m_sW != sW
-                || m_longTermMap[longTermId]->m_uW != uW);
-
+      longTermItem = it->second;
     }
   else
     {
       NS_LOG_DEBUG ("long term component NOT found");
-      notFound = true;
     }
 
-  if (update || notFound)
+  // check if the channel matrix has been updated
+  // or the s beam has been changed
+  // or the u beam has been changed
+  if (!longTermItem
+      || longTermItem->m_channel->m_generatedTime != channelMatrix->m_generatedTime
+      || longTermItem->m_sW != sW
+      || longTermItem->m_uW != uW)
     {
       NS_LOG_DEBUG ("compute the long term");
-      // compute the long term component
-      longTerm = CalcLongTerm (channelMatrix, sW, uW);
-
-      // store the long term
-      Ptr<LongTerm> longTermItem = Create<LongTerm> ();
-      longTermItem->m_longTerm = longTerm;
+      // compute and store the long term component
+      longTermItem = Create<LongTerm> ();
+      longTermItem->m_longTerm = CalcLongTerm (channelMatrix, sW, uW);
       longTermItem->m_channel = channelMatrix;
-      longTermItem->m_sW = sW;
-      longTermItem->m_uW = uW;
-
+      longTermItem->m_sW = std::move (sW);
+      longTermItem->m_uW = std::move (uW);
       m_longTermMap[longTermId] = longTermItem;
     }
 
-  return longTerm;
+  // check if the Doppler factors have to be updated
+  if (longTermItem->m_params != channelParams
+      || longTermItem->m_sSpeed != sSpeed
+      || longTermItem->m_uSpeed != uSpeed)
+    {
+      longTermItem->m_doppler = CalcDoppler (channelMatrix, channelParams, sSpeed, uSpeed);
+      longTermItem->m_params = channelParams;
+      longTermItem->m_sSpeed = sSpeed;
+      longTermItem->m_uSpeed = uSpeed;
+    }
+
+  return longTermItem;
 }
 
 Ptr<SpectrumValue>
@@ -348,11 +430,12 @@ ThreeGppSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity (Ptr<const Sp
   Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix = m_channelModel->GetChannel (a, b, aPhasedArrayModel, bPhasedArrayModel);
   Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams = m_channelModel->GetParams (a, b);
 
-  // retrieve the long term component
-  PhasedArrayModel::ComplexVector longTerm = GetLongTerm (channelMatrix, aPhasedArrayModel, bPhasedArrayModel);
+  // retrieve the long term component and the Doppler factors
+  Ptr<const LongTerm> longTerm = GetLongTerm (channelMatrix, channelParams, aPhasedArrayModel, bPhasedArrayModel,
+                                              a->GetVelocity (), b->GetVelocity ());
 
   // apply the beamforming gain
-  rxPsd = CalcBeamformingGain (rxPsd, longTerm, channelMatrix, channelParams, a->GetVelocity (), b->GetVelocity ());
+  CalcBeamformingGain (rxPsd, longTerm, channelParams);
 
   return rxPsd;
 }
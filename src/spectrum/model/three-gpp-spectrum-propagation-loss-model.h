@@ -133,6 +133,10 @@ private:
     Ptr<const MatrixBasedChannelModel::ChannelMatrix> m_channel; //!< pointer to the channel matrix used to compute the long term
     PhasedArrayModel::ComplexVector m_sW; //!< the beamforming vector for the node s used to compute the long term
     PhasedArrayModel::ComplexVector m_uW; //!< the beamforming vector for the node u used to compute the long term
+    MatrixBasedChannelModel::DoubleVector m_doppler; //!< the Doppler factor of each cluster, see CalcDoppler
+    Ptr<const MatrixBasedChannelModel::ChannelParams> m_params; //!< pointer to the channel params used to compute the Doppler factors
+    Vector m_sSpeed; //!< the speed of the first node used to compute the Doppler factors
+    Vector m_uSpeed; //!< the speed of the second node used to compute the Doppler factors
   };
 
   /**
@@ -144,15 +148,22 @@ private:
   /**
    * Looks for the long term component in m_longTermMap. If found, checks
    * whether it has to be updated. If not found or if it has to be updated,
-   * calls the method CalcLongTerm to compute it.
+   * calls the method CalcLongTerm to compute it. The Doppler factors are
+   * stored with the long term component and recomputed by means of the
+   * method CalcDoppler when the channel params or the speeds change.
    * \param channelMatrix the channel matrix
+   * \param channelParams the channel params
    * \param aPhasedArrayModel the antenna array of the tx device
    * \param bPhasedArrayModel the antenna array of the rx device
-   * \return vector containing the long term component for each cluster
+   * \param sSpeed speed of the first node
+   * \param uSpeed speed of the second node
+   * \return the long term component and the Doppler factors of each cluster
    */
-  PhasedArrayModel::ComplexVector GetLongTerm (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
-                                               Ptr<const PhasedArrayModel> aPhasedArrayModel,
-                                               Ptr<const PhasedArrayModel> bPhasedArrayModel) const;
+  Ptr<const LongTerm> GetLongTerm (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                                   Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
+                                   Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                                   Ptr<const PhasedArrayModel> bPhasedArrayModel,
+                                   const Vector &sSpeed, const Vector &uSpeed) const;
   /**
    * Computes the long term component
    * \param channelMatrix the channel matrix H
@@ -165,23 +176,42 @@ private:
                                                 const PhasedArrayModel::ComplexVector &uW) const;
 
   /**
-   * Computes the beamforming gain and applies it to the tx PSD
-   * \param txPsd the tx PSD
-   * \param longTerm the long term component
+   * Computes the Doppler factor of each cluster, i.e., the time independent
+   * part of the Doppler phase: the Doppler phase of the cluster n at time t
+   * is 2 pi f t / c times the Doppler factor of the cluster n.
    * \param channelMatrix The channel matrix structure
    * \param channelParams The channel params structure
    * \param sSpeed speed of the first node
    * \param uSpeed speed of the second node
-   * \return the rx PSD
+   * \return the Doppler factor of each cluster
+   */
+  MatrixBasedChannelModel::DoubleVector CalcDoppler (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                                                     Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
+                                                     const Vector &sSpeed, const Vector &uSpeed) const;
+
+  /**
+   * Computes the beamforming gain and applies it to the PSD, in place.
+   *
+   * The gain of the band centered at f is |sum_n l_n d_n exp (-j 2 pi f tau_n)|^2,
+   * where l_n, d_n and tau_n are the long term component, the Doppler term
+   * and the delay of the cluster n. If the bands are equally spaced, the
+   * terms of consecutive bands are obtained by means of a complex rotation
+   * rather than by evaluating a sine and a cosine per band and cluster, and
+   * the gains are accumulated in the m_gainReal and m_gainImag buffers,
+   * which are reused across the calls.
+   *
+   * \param psd the tx PSD, which is replaced by the rx PSD
+   * \param longTerm the long term component and the Doppler factors
+   * \param channelParams The channel params structure
    */
-  Ptr<SpectrumValue> CalcBeamformingGain (Ptr<SpectrumValue> txPsd,
-                                          PhasedArrayModel::ComplexVector longTerm,
-                                          Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
-                                          Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
-                                          const Vector &sSpeed, const Vector &uSpeed) const;
+  void CalcBeamformingGain (Ptr<SpectrumValue> psd,
+                            Ptr<const LongTerm> longTerm,
+                            Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams) const;
 
-  mutable std::unordered_map < uint64_t, Ptr<const LongTerm> > m_longTermMap; //!< map containing the long term components
+  mutable std::unordered_map < uint64_t, Ptr<LongTerm> > m_longTermMap; //!< map containing the long term components
   Ptr<MatrixBasedChannelModel> m_channelModel; //!< the model to generate the channel matrix
+  mutable std::vector<double> m_gainReal; //!< real part of the complex gain of each band
+  mutable std::vector<double> m_gainImag; //!< imaginary part of the complex gain of each band
 };
 } // namespace ns3
 
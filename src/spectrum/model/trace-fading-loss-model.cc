@@ -27,7 +27,6 @@
 #include <ns3/string.h>
 #include <ns3/double.h>
 #include "ns3/uinteger.h"
-#include <fstream>
 #include <ns3/simulator.h>
 
 namespace ns3 {
@@ -48,7 +47,7 @@ TraceFadingLossModel::TraceFadingLossModel ()
 
 TraceFadingLossModel::~TraceFadingLossModel ()
 {
-  m_fadingTrace.clear ();
+  m_fadingTrace = 0;
   m_windowOffsetsMap.clear ();
   m_startVariableMap.clear ();
 }
@@ -115,33 +114,19 @@ TraceFadingLossModel::DoInitialize ()
   LoadTrace ();
 }
 
+void
+TraceFadingLossModel::DoDispose ()
+{
+  m_fadingTrace = 0;
+  SpectrumPropagationLossModel::DoDispose ();
+}
+
 
 void
 TraceFadingLossModel::LoadTrace ()
 {
   NS_LOG_FUNCTION (this << "Loading Fading Trace " << m_traceFile);
-  std::ifstream ifTraceFile;
-  ifTraceFile.open (m_traceFile.c_str (), std::ifstream::in);
-  m_fadingTrace.clear ();
-  if (!ifTraceFile.good ())
-    {
-      NS_LOG_INFO (this << " File: " << m_traceFile);
-      NS_ASSERT_MSG(ifTraceFile.good (), " Fading trace file not found");
-    }
-
-//   NS_LOG_INFO (this << " length " << m_traceLength.GetSeconds ());
-//   NS_LOG_INFO (this << " RB " << (uint32_t)m_rbNum << " samples " << m_samplesNum);
-  for (uint32_t i = 0; i < m_rbNum; i++)
-    {
-      FadingTraceSample rbTimeFadingTrace;
-      for (uint32_t j = 0; j < m_samplesNum; j++)
-        {
-          double sample;
-          ifTraceFile >> sample;
-          rbTimeFadingTrace.push_back (sample);
-        }
-      m_fadingTrace.push_back (rbTimeFadingTrace);
-    }
+  m_fadingTrace = FadingTrace::Get (m_traceFile, m_rbNum, m_samplesNum);
   m_timeGranularity = m_traceLength.GetMilliSeconds () / m_samplesNum;
   m_lastWindowUpdate = Simulator::Now ();
 }
@@ -201,7 +186,7 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
   //double speed = std::sqrt (std::pow (aSpeedVector.x-bSpeedVector.x,2) + std::pow (aSpeedVector.y-bSpeedVector.y,2));
 
   NS_LOG_LOGIC (this << *rxPsd);
-  NS_ASSERT (!m_fadingTrace.empty ());
+  NS_ASSERT (m_fadingTrace != 0);
   int now_ms = static_cast<int> (Simulator::Now ().GetMilliSeconds () * m_timeGranularity);
   int lastUpdate_ms = static_cast<int> (m_lastWindowUpdate.GetMilliSeconds () * m_timeGranularity);
   int index = ((*itOff).second + now_ms - lastUpdate_ms) % m_samplesNum;
@@ -211,7 +196,7 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
       NS_ASSERT (subChannel < 100);
       if (*vit != 0.)
         {
-          double fading = m_fadingTrace.at (subChannel).at (index);
+          double fading = m_fadingTrace->GetValue (subChannel, index);
           NS_LOG_INFO (this << " FADING now " << now_ms << " offset " << (*itOff).second << " id " << index << " fading " << fading);
           double power = *vit; // in Watt/Hz
           power = 10 * std::log10 (180000 * power); // in dB
@@ -29,6 +29,7 @@
 #include <map>
 #include "ns3/random-variable-stream.h"
 #include <ns3/nstime.h>
+#include <ns3/fading-trace.h>
 
 namespace ns3 {
 
@@ -40,6 +41,9 @@ class MobilityModel;
  * \ingroup spectrum
  *
  * \brief fading loss model based on precalculated fading traces
+ *
+ * The trace is a FadingTrace, which is shared by all the instances of the
+ * model reading the same file.
  */
 class TraceFadingLossModel : public SpectrumPropagationLossModel
 {
@@ -54,6 +58,7 @@ public:
   static TypeId GetTypeId ();
   
   virtual void DoInitialize (void);
+  virtual void DoDispose (void);
 
   /**
    * \brief The couple of mobility node that form a fading channel realization
@@ -112,20 +117,9 @@ private:
   
   mutable std::map <ChannelRealizationId_t, Ptr<UniformRandomVariable> > m_startVariableMap; ///< start variable map
   
-  /**
-   * Vector with fading samples in time domain (for a fixed RB)
-   */
-  typedef std::vector<double> FadingTraceSample;
-  /**
-   * Vector collecting the time fading traces in the frequency domain (per RB)
-   */
-  typedef std::vector<FadingTraceSample> FadingTrace;
-
-
-  
   std::string m_traceFile; ///< the trace file name
   
-  FadingTrace m_fadingTrace; ///< fading trace
+  Ptr<const FadingTrace> m_fadingTrace; ///< fading trace
 
   
   Time m_traceLength; ///< the trace time
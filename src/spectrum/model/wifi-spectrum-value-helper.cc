@@ -24,6 +24,7 @@
 
 #include <map>
 #include <cmath>
+#include <tuple>
 #include "wifi-spectrum-value-helper.h"
 #include "ns3/log.h"
 #include "ns3/fatal-error.h"
@@ -131,6 +132,144 @@ WifiSpectrumValueHelper::GetSpectrumModel (uint32_t centerFrequency, uint16_t ch
   return ret;
 }
 
+/// Type of the transmit PSD stored in a template
+enum WifiTxPsdTemplateType : uint8_t
+{
+  WIFI_TX_PSD_OFDM = 0,
+  WIFI_TX_PSD_HT_OFDM,
+  WIFI_TX_PSD_HE_OFDM
+};
+
+///< Wifi transmit PSD template structure
+struct WifiTxPsdTemplateId
+{
+  /**
+   * Constructor
+   * \param t the type of transmit PSD
+   * \param f the frequency (in MHz)
+   * \param w the channel width (in MHz)
+   * \param g the guard band width (in MHz)
+   * \param inner the minimum relative power in the inner band (in dBr)
+   * \param outer the minimum relative power in the outer band (in dBr)
+   * \param lowest the maximum relative power of the outermost subcarriers of the guard band (in dBr)
+   */
+  WifiTxPsdTemplateId (WifiTxPsdTemplateType t, uint32_t f, uint16_t w, uint16_t g,
+                       double inner, double outer, double lowest);
+  WifiTxPsdTemplateType m_type; ///< type of transmit PSD
+  uint32_t m_centerFrequency;   ///< center frequency (in MHz)
+  uint16_t m_channelWidth;      ///< channel width (in MHz)
+  uint16_t m_guardBandwidth;    ///< guard band width (in MHz)
+  double m_minInnerBandDbr;     ///< minimum relative power in the inner band (in dBr)
+  double m_minOuterBandDbr;     ///< minimum relative power in the outer band (in dBr)
+  double m_lowestPointDbr;      ///< maximum relative power of the outermost subcarriers (in dBr)
+};
+
+WifiTxPsdTemplateId::WifiTxPsdTemplateId (WifiTxPsdTemplateType t, uint32_t f, uint16_t w, uint16_t g,
+                                          double inner, double outer, double lowest)
+  : m_type (t),
+    m_centerFrequency (f),
+    m_channelWidth (w),
+    m_guardBandwidth (g),
+    m_minInnerBandDbr (inner),
+    m_minOuterBandDbr (outer),
+    m_lowestPointDbr (lowest)
+{
+}
+
+/**
+ * Less than operator
+ * \param a the first transmit PSD template to compare
+ * \param b the second transmit PSD template to compare
+ * \returns true if the first template is less than the second template
+ */
+bool
+operator < (const WifiTxPsdTemplateId& a, const WifiTxPsdTemplateId& b)
+{
+  return std::tie (a.m_type, a.m_centerFrequency, a.m_channelWidth, a.m_guardBandwidth,
+                   a.m_minInnerBandDbr, a.m_minOuterBandDbr, a.m_lowestPointDbr)
+         < std::tie (b.m_type, b.m_centerFrequency, b.m_channelWidth, b.m_guardBandwidth,
+                     b.m_minInnerBandDbr, b.m_minOuterBandDbr, b.m_lowestPointDbr);
+}
+
+///< Wifi RF filter structure
+struct WifiRfFilterId
+{
+  /**
+   * Constructor
+   * \param f the frequency (in MHz)
+   * \param w the total channel width (in MHz)
+   * \param b the width of each band (in Hz)
+   * \param g the guard band width (in MHz)
+   * \param band the pair of start and stop indexes of the filtered band
+   */
+  WifiRfFilterId (uint32_t f, uint16_t w, uint32_t b, uint16_t g, WifiSpectrumBand band);
+  uint32_t m_centerFrequency; ///< center frequency (in MHz)
+  uint16_t m_channelWidth;    ///< total channel width (in MHz)
+  uint32_t m_bandBandwidth;   ///< width of each band (in Hz)
+  uint16_t m_guardBandwidth;  ///< guard band width (in MHz)
+  WifiSpectrumBand m_band;    ///< start and stop indexes of the filtered band
+};
+
+WifiRfFilterId::WifiRfFilterId (uint32_t f, uint16_t w, uint32_t b, uint16_t g, WifiSpectrumBand band)
+  : m_centerFrequency (f),
+    m_channelWidth (w),
+    m_bandBandwidth (b),
+    m_guardBandwidth (g),
+    m_band (band)
+{
+}
+
+/**
+ * Less than operator
+ * \param a the first RF filter to compare
+ * \param b the second RF filter to compare
+ * \returns true if the first RF filter is less than the second RF filter
+ */
+bool
+operator < (const WifiRfFilterId& a, const WifiRfFilterId& b)
+{
+  return std::tie (a.m_centerFrequency, a.m_channelWidth, a.m_bandBandwidth, a.m_guardBandwidth, a.m_band)
+         < std::tie (b.m_centerFrequency, b.m_channelWidth, b.m_bandBandwidth, b.m_guardBandwidth, b.m_band);
+}
+
+static std::map<WifiTxPsdTemplateId, Ptr<const SpectrumValue> > g_wifiTxPsdTemplateMap; ///< transmit PSDs for a transmit power of 1 W
+static std::map<WifiRfFilterId, Ptr<const SpectrumValue> > g_wifiRfFilterMap; ///< RF filters
+static WifiSpectrumValueCacheStats g_wifiSpectrumValueCacheStats; ///< statistics of the above caches
+
+/**
+ * Scale a transmit PSD template (built for a transmit power of 1 W)
+ * to the given transmit power.
+ *
+ * \param psdTemplate the transmit PSD template
+ * \param txPowerW the transmit power (W) to allocate
+ * \return a pointer to a newly allocated SpectrumValue representing the Transmit Power Spectral Density in W/Hz for each Band
+ */
+static Ptr<SpectrumValue>
+ScaleTxPsdTemplate (Ptr<const SpectrumValue> psdTemplate, double txPowerW)
+{
+  Ptr<SpectrumValue> c = psdTemplate->Copy ();
+  (*c) *= txPowerW;
+  return c;
+}
+
+WifiSpectrumValueCacheStats
+WifiSpectrumValueHelper::GetCacheStats (void)
+{
+  WifiSpectrumValueCacheStats stats = g_wifiSpectrumValueCacheStats;
+  stats.txPsdEntries = g_wifiTxPsdTemplateMap.size ();
+  stats.rfFilterEntries = g_wifiRfFilterMap.size ();
+  return stats;
+}
+
+void
+WifiSpectrumValueHelper::ClearCache (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_wifiTxPsdTemplateMap.clear ();
+  g_wifiRfFilterMap.clear ();
+  g_wifiSpectrumValueCacheStats = WifiSpectrumValueCacheStats ();
+}
+
 // Power allocated to 71 center subbands out of 135 total subbands in the band
 Ptr<SpectrumValue>
 WifiSpectrumValueHelper::CreateDsssTxPowerSpectralDensity (uint32_t centerFrequency, double txPowerW, uint16_t guardBandwidth)
@@ -159,6 +298,27 @@ WifiSpectrumValueHelper::CreateDsssTxPowerSpectralDensity (uint32_t centerFreque
 Ptr<SpectrumValue>
 WifiSpectrumValueHelper::CreateOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
                                                            double minInnerBandDbr, double minOuterBandDbr, double lowestPointDbr)
+{
+  NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth << minInnerBandDbr << minOuterBandDbr << lowestPointDbr);
+  WifiTxPsdTemplateId key (WIFI_TX_PSD_OFDM, centerFrequency, channelWidth, guardBandwidth, minInnerBandDbr, minOuterBandDbr, lowestPointDbr);
+  auto it = g_wifiTxPsdTemplateMap.find (key);
+  if (it == g_wifiTxPsdTemplateMap.end ())
+    {
+      g_wifiSpectrumValueCacheStats.txPsdMisses++;
+      Ptr<const SpectrumValue> psdTemplate = DoCreateOfdmTxPowerSpectralDensity (centerFrequency, channelWidth, 1.0, guardBandwidth,
+                                                                                 minInnerBandDbr, minOuterBandDbr, lowestPointDbr);
+      it = g_wifiTxPsdTemplateMap.insert (std::make_pair (key, psdTemplate)).first;
+    }
+  else
+    {
+      g_wifiSpectrumValueCacheStats.txPsdHits++;
+    }
+  return ScaleTxPsdTemplate (it->second, txPowerW);
+}
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::DoCreateOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
+                                                             double minInnerBandDbr, double minOuterBandDbr, double lowestPointDbr)
 {
   NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth << minInnerBandDbr << minOuterBandDbr << lowestPointDbr);
   uint32_t bandBandwidth = 0;
@@ -214,6 +374,27 @@ WifiSpectrumValueHelper::CreateOfdmTxPowerSpectralDensity (uint32_t centerFreque
 Ptr<SpectrumValue>
 WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
                                                              double minInnerBandDbr, double minOuterBandDbr, double lowestPointDbr)
+{
+  NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth << minInnerBandDbr << minOuterBandDbr << lowestPointDbr);
+  WifiTxPsdTemplateId key (WIFI_TX_PSD_HT_OFDM, centerFrequency, channelWidth, guardBandwidth, minInnerBandDbr, minOuterBandDbr, lowestPointDbr);
+  auto it = g_wifiTxPsdTemplateMap.find (key);
+  if (it == g_wifiTxPsdTemplateMap.end ())
+    {
+      g_wifiSpectrumValueCacheStats.txPsdMisses++;
+      Ptr<const SpectrumValue> psdTemplate = DoCreateHtOfdmTxPowerSpectralDensity (centerFrequency, channelWidth, 1.0, guardBandwidth,
+                                                                                   minInnerBandDbr, minOuterBandDbr, lowestPointDbr);
+      it = g_wifiTxPsdTemplateMap.insert (std::make_pair (key, psdTemplate)).first;
+    }
+  else
+    {
+      g_wifiSpectrumValueCacheStats.txPsdHits++;
+    }
+  return ScaleTxPsdTemplate (it->second, txPowerW);
+}
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::DoCreateHtOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
+                                                               double minInnerBandDbr, double minOuterBandDbr, double lowestPointDbr)
 {
   NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth << minInnerBandDbr << minOuterBandDbr << lowestPointDbr);
   uint32_t bandBandwidth = 312500;
@@ -328,6 +509,27 @@ WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (uint32_t centerFreq
 Ptr<SpectrumValue>
 WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
                                                              double minInnerBandDbr, double minOuterBandDbr, double lowestPointDbr)
+{
+  NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth << minInnerBandDbr << minOuterBandDbr << lowestPointDbr);
+  WifiTxPsdTemplateId key (WIFI_TX_PSD_HE_OFDM, centerFrequency, channelWidth, guardBandwidth, minInnerBandDbr, minOuterBandDbr, lowestPointDbr);
+  auto it = g_wifiTxPsdTemplateMap.find (key);
+  if (it == g_wifiTxPsdTemplateMap.end ())
+    {
+      g_wifiSpectrumValueCacheStats.txPsdMisses++;
+      Ptr<const SpectrumValue> psdTemplate = DoCreateHeOfdmTxPowerSpectralDensity (centerFrequency, channelWidth, 1.0, guardBandwidth,
+                                                                                   minInnerBandDbr, minOuterBandDbr, lowestPointDbr);
+      it = g_wifiTxPsdTemplateMap.insert (std::make_pair (key, psdTemplate)).first;
+    }
+  else
+    {
+      g_wifiSpectrumValueCacheStats.txPsdHits++;
+    }
+  return ScaleTxPsdTemplate (it->second, txPowerW);
+}
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::DoCreateHeOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
+                                                               double minInnerBandDbr, double minOuterBandDbr, double lowestPointDbr)
 {
   NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth << minInnerBandDbr << minOuterBandDbr << lowestPointDbr);
   uint32_t bandBandwidth = 78125;
@@ -479,6 +681,14 @@ WifiSpectrumValueHelper::CreateRfFilter (uint32_t centerFrequency, uint16_t tota
   uint32_t startIndex = band.first;
   uint32_t stopIndex = band.second;
   NS_LOG_FUNCTION (centerFrequency << totalChannelWidth << bandBandwidth << guardBandwidth << startIndex << stopIndex);
+  WifiRfFilterId key (centerFrequency, totalChannelWidth, bandBandwidth, guardBandwidth, band);
+  auto it = g_wifiRfFilterMap.find (key);
+  if (it != g_wifiRfFilterMap.end ())
+    {
+      g_wifiSpectrumValueCacheStats.rfFilterHits++;
+      return it->second->Copy ();
+    }
+  g_wifiSpectrumValueCacheStats.rfFilterMisses++;
   Ptr<SpectrumValue> c = Create <SpectrumValue> (GetSpectrumModel (centerFrequency, totalChannelWidth, bandBandwidth, guardBandwidth));
   Bands::const_iterator bit = c->ConstBandsBegin ();
   Values::iterator vit = c->ValuesBegin ();
@@ -489,6 +699,7 @@ WifiSpectrumValueHelper::CreateRfFilter (uint32_t centerFrequency, uint16_t tota
       *vit = 1;
     }
   NS_LOG_LOGIC ("Added subbands " << startIndex << " to " << stopIndex << " to filter");
+  g_wifiRfFilterMap.insert (std::make_pair (key, c->Copy ()));
   return c;
 }
 
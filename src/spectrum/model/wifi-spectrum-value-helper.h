@@ -33,6 +33,22 @@ namespace ns3 {
  */
 typedef std::pair<uint32_t, uint32_t> WifiSpectrumBand;
 
+/**
+ * \ingroup spectrum
+ *
+ * Statistics of the caches of transmit PSD templates and RF filters
+ * maintained by WifiSpectrumValueHelper.
+ */
+struct WifiSpectrumValueCacheStats
+{
+  uint64_t txPsdHits {0};        //!< number of transmit PSDs obtained from a cached template
+  uint64_t txPsdMisses {0};      //!< number of transmit PSD templates that had to be built
+  std::size_t txPsdEntries {0};  //!< number of cached transmit PSD templates
+  uint64_t rfFilterHits {0};     //!< number of RF filters obtained from the cache
+  uint64_t rfFilterMisses {0};   //!< number of RF filters that had to be built
+  std::size_t rfFilterEntries {0}; //!< number of cached RF filters
+};
+
 /**
  * \ingroup spectrum
  *
@@ -249,6 +265,73 @@ public:
    * \return band power in W
    */
   static double GetBandPowerW (Ptr<SpectrumValue> psd, const WifiSpectrumBand &band);
+
+  /**
+   * The OFDM, HT and HE transmit PSDs only depend on the transmit power
+   * through a scaling factor. They are therefore built once per
+   * (center frequency, channel width, guard bandwidth, spectral mask)
+   * combination for a transmit power of 1 W, stored in a cache shared by all
+   * the PHYs of the simulation and scaled by the requested transmit power.
+   * RF filters are similarly cached per band.
+   *
+   * \return the statistics of the transmit PSD template and RF filter caches
+   */
+  static WifiSpectrumValueCacheStats GetCacheStats (void);
+
+  /**
+   * Remove all the transmit PSD templates and RF filters from the cache
+   * and reset the cache statistics.
+   */
+  static void ClearCache (void);
+
+private:
+  /**
+   * Build a transmit power spectral density corresponding to OFDM
+   * (802.11a/g) without looking up the template cache.
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \param minInnerBandDbr the minimum relative power in the inner band (in dBr)
+   * \param minOuterbandDbr the minimum relative power in the outer band (in dBr)
+   * \param lowestPointDbr maximum relative power of the outermost subcarriers of the guard band (in dBr)
+   * \return a pointer to a newly allocated SpectrumValue representing the OFDM Transmit Power Spectral Density in W/Hz for each Band
+   */
+  static Ptr<SpectrumValue> DoCreateOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
+                                                                double minInnerBandDbr, double minOuterbandDbr, double lowestPointDbr);
+
+  /**
+   * Build a transmit power spectral density corresponding to OFDM
+   * High Throughput (HT) (802.11n/ac) without looking up the template cache.
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \param minInnerBandDbr the minimum relative power in the inner band (in dBr)
+   * \param minOuterbandDbr the minimum relative power in the outer band (in dBr)
+   * \param lowestPointDbr maximum relative power of the outermost subcarriers of the guard band (in dBr)
+   * \return a pointer to a newly allocated SpectrumValue representing the HT OFDM Transmit Power Spectral Density in W/Hz for each Band
+   */
+  static Ptr<SpectrumValue> DoCreateHtOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
+                                                                  double minInnerBandDbr, double minOuterbandDbr, double lowestPointDbr);
+
+  /**
+   * Build a transmit power spectral density corresponding to OFDM
+   * High Efficiency (HE) (802.11ax) without looking up the template cache.
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \param minInnerBandDbr the minimum relative power in the inner band (in dBr)
+   * \param minOuterbandDbr the minimum relative power in the outer band (in dBr)
+   * \param lowestPointDbr maximum relative power of the outermost subcarriers of the guard band (in dBr)
+   * \return a pointer to a newly allocated SpectrumValue representing the HE OFDM Transmit Power Spectral Density in W/Hz for each Band
+   */
+  static Ptr<SpectrumValue> DoCreateHeOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
+                                                                  double minInnerBandDbr, double minOuterbandDbr, double lowestPointDbr);
 };
 
 /**
@@ -0,0 +1,238 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <fstream>
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/fading-trace.h"
+#include "ns3/trace-fading-loss-model.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("FadingTraceTest");
+
+/**
+ * Write a text fading trace
+ * \param filename the name of the file
+ * \param rbNum the number of resource blocks
+ * \param samplesNum the number of samples of each resource block
+ * \return the samples, as written in the file
+ */
+static std::vector<double>
+WriteTextTrace (std::string filename, uint32_t rbNum, uint32_t samplesNum)
+{
+  std::ofstream file (filename.c_str ());
+  std::vector<double> samples;
+  for (uint32_t rb = 0; rb < rbNum; rb++)
+    {
+      std::ostringstream line;
+      for (uint32_t s = 0; s < samplesNum; s++)
+        {
+          line << -16 + 24 * std::sin (0.1 * s + rb) << " ";
+        }
+      file << line.str () << std::endl;
+      std::istringstream values (line.str ());
+      double sample;
+      while (values >> sample)
+        {
+          samples.push_back (sample);
+        }
+    }
+  return samples;
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Check that the text and binary fading trace files give the same
+ * samples, and that the traces are shared.
+ */
+class FadingTraceFormatsTestCase : public TestCase
+{
+public:
+  FadingTraceFormatsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+FadingTraceFormatsTestCase::FadingTraceFormatsTestCase ()
+  : TestCase ("Check the text and binary fading trace files")
+{
+}
+
+void
+FadingTraceFormatsTestCase::DoRun (void)
+{
+  uint32_t rbNum = 5;
+  uint32_t samplesNum = 200;
+  std::string text = CreateTempDirFilename ("trace.fad");
+  std::string float32 = CreateTempDirFilename ("trace-float32.bin");
+  std::string float16 = CreateTempDirFilename ("trace-float16.bin");
+  std::vector<double> samples = WriteTextTrace (text, rbNum, samplesNum);
+  FadingTrace::ConvertText (text, float32, FadingTrace::FLOAT32);
+  FadingTrace::ConvertText (text, float16, FadingTrace::FLOAT16);
+
+  std::size_t nLoadedTraces = FadingTrace::GetNLoadedTraces ();
+  Ptr<const FadingTrace> textTrace = FadingTrace::Get (text, rbNum, samplesNum);
+  Ptr<const FadingTrace> float32Trace = FadingTrace::Get (float32, rbNum, samplesNum);
+  Ptr<const FadingTrace> float16Trace = FadingTrace::Get (float16, rbNum, samplesNum);
+  NS_TEST_ASSERT_MSG_EQ (FadingTrace::GetNLoadedTraces (), nLoadedTraces + 3, "Wrong number of loaded traces");
+  NS_TEST_ASSERT_MSG_EQ (FadingTrace::Get (text, rbNum, samplesNum), textTrace, "The text trace is not shared");
+  NS_TEST_ASSERT_MSG_EQ (FadingTrace::Get (float16, rbNum, samplesNum), float16Trace, "The binary trace is not shared");
+  NS_TEST_ASSERT_MSG_EQ (FadingTrace::GetNLoadedTraces (), nLoadedTraces + 3, "Wrong number of loaded traces");
+  NS_TEST_ASSERT_MSG_EQ (textTrace->IsMapped (), false, "A text trace cannot be mapped");
+#ifdef HAVE_SYS_MMAN_H
+  NS_TEST_ASSERT_MSG_EQ (float32Trace->IsMapped (), true, "The binary trace is not mapped");
+#endif
+
+  for (uint32_t rb = 0; rb < rbNum; rb++)
+    {
+      for (uint32_t s = 0; s < samplesNum; s++)
+        {
+          double sample = samples[rb * samplesNum + s];
+          NS_TEST_ASSERT_MSG_EQ_TOL (textTrace->GetValue (rb, s), sample, 1e-5, "Wrong text sample " << rb << " " << s);
+          NS_TEST_ASSERT_MSG_EQ (float32Trace->GetValue (rb, s), textTrace->GetValue (rb, s), "Wrong float32 sample " << rb << " " << s);
+          NS_TEST_ASSERT_MSG_EQ_TOL (float16Trace->GetValue (rb, s), sample, 0.02, "Wrong float16 sample " << rb << " " << s);
+        }
+    }
+
+  // the first resource blocks of a trace can be used
+  Ptr<const FadingTrace> partialTrace = FadingTrace::Get (float32, 2, samplesNum);
+  NS_TEST_ASSERT_MSG_EQ (partialTrace->GetRbNum (), 2, "Wrong number of resource blocks");
+  NS_TEST_ASSERT_MSG_EQ (partialTrace->GetValue (1, 7), float32Trace->GetValue (1, 7), "Wrong sample of a partial trace");
+
+  textTrace = 0;
+  float32Trace = 0;
+  float16Trace = 0;
+  partialTrace = 0;
+  NS_TEST_ASSERT_MSG_EQ (FadingTrace::GetNLoadedTraces (), nLoadedTraces, "The traces are not unloaded");
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Check that TraceFadingLossModel gives the same fading with a text
+ * and a binary trace file.
+ */
+class TraceFadingLossModelBinaryTestCase : public TestCase
+{
+public:
+  TraceFadingLossModelBinaryTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Create a fading model
+   * \param filename the name of the trace file
+   * \return the fading model
+   */
+  Ptr<TraceFadingLossModel> CreateModel (std::string filename);
+};
+
+TraceFadingLossModelBinaryTestCase::TraceFadingLossModelBinaryTestCase ()
+  : TestCase ("Check the TraceFadingLossModel with a binary trace file")
+{
+}
+
+Ptr<TraceFadingLossModel>
+TraceFadingLossModelBinaryTestCase::CreateModel (std::string filename)
+{
+  Ptr<TraceFadingLossModel> model = CreateObject<TraceFadingLossModel> ();
+  model->SetAttribute ("TraceFilename", StringValue (filename));
+  model->SetAttribute ("TraceLength", TimeValue (MilliSeconds (200)));
+  model->SetAttribute ("SamplesNum", UintegerValue (200));
+  model->SetAttribute ("WindowSize", TimeValue (MilliSeconds (50)));
+  model->SetAttribute ("RbNum", UintegerValue (5));
+  model->Initialize ();
+  model->AssignStreams (7);
+  return model;
+}
+
+void
+TraceFadingLossModelBinaryTestCase::DoRun (void)
+{
+  std::string text = CreateTempDirFilename ("trace.fad");
+  std::string binary = CreateTempDirFilename ("trace.bin");
+  WriteTextTrace (text, 5, 200);
+  FadingTrace::ConvertText (text, binary);
+
+  std::size_t nLoadedTraces = FadingTrace::GetNLoadedTraces ();
+  Ptr<TraceFadingLossModel> textModel = CreateModel (text);
+  Ptr<TraceFadingLossModel> otherTextModel = CreateModel (text);
+  Ptr<TraceFadingLossModel> binaryModel = CreateModel (binary);
+  NS_TEST_ASSERT_MSG_EQ (FadingTrace::GetNLoadedTraces (), nLoadedTraces + 2, "The trace is not shared by the models");
+
+  std::vector<BandInfo> bands;
+  for (uint32_t rb = 0; rb < 5; rb++)
+    {
+      BandInfo band;
+      band.fl = 2.1e9 + rb * 180e3;
+      band.fc = band.fl + 90e3;
+      band.fh = band.fl + 180e3;
+      bands.push_back (band);
+    }
+  Ptr<SpectrumValue> txPsd = Create<SpectrumValue> (Create<SpectrumModel> (bands));
+  (*txPsd) = 1e-10;
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+
+  for (uint32_t t = 0; t < 150; t += 7)
+    {
+      Simulator::Stop (MilliSeconds (t) - Simulator::Now ());
+      Simulator::Run ();
+      Ptr<SpectrumValue> textPsd = textModel->CalcRxPowerSpectralDensity (txPsd, a, b);
+      Ptr<SpectrumValue> binaryPsd = binaryModel->CalcRxPowerSpectralDensity (txPsd, a, b);
+      for (uint32_t rb = 0; rb < 5; rb++)
+        {
+          NS_TEST_ASSERT_MSG_EQ ((*binaryPsd)[rb], (*textPsd)[rb], "Wrong fading of RB " << rb << " at " << t << " ms");
+        }
+    }
+  Simulator::Destroy ();
+
+  textModel->Dispose ();
+  otherTextModel->Dispose ();
+  binaryModel->Dispose ();
+  NS_TEST_ASSERT_MSG_EQ (FadingTrace::GetNLoadedTraces (), nLoadedTraces, "The traces are not unloaded");
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Fading trace test suite
+ */
+class FadingTraceTestSuite : public TestSuite
+{
+public:
+  FadingTraceTestSuite ();
+};
+
+FadingTraceTestSuite::FadingTraceTestSuite ()
+  : TestSuite ("fading-trace", UNIT)
+{
+  AddTestCase (new FadingTraceFormatsTestCase, TestCase::QUICK);
+  AddTestCase (new TraceFadingLossModelBinaryTestCase, TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static FadingTraceTestSuite g_fadingTraceTestSuite;
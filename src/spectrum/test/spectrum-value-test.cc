@@ -242,6 +242,47 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   AddTestCase (new SpectrumValueTestCase (tv9b, v9, "tv9b =  doubleValue * v1"), TestCase::QUICK);
   AddTestCase (new SpectrumValueTestCase (tv10b, v10, "tv10b = doubleValue div v1"), TestCase::QUICK);
 
+  SpectrumValue tv3c (f), tv5c (f), tv9c (f);
+  tv3c = v1;
+  tv3c.AddScaled (v2, 1);
+  tv5c.AddProduct (v1, v2);
+  tv9c.AddScaled (v1, doubleValue);
+  AddTestCase (new SpectrumValueTestCase (tv3c, v3, "tv3c = v1, tv3c.AddScaled (v2, 1)"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv5c, v5, "tv5c.AddProduct (v1, v2)"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv9c, v9, "tv9c.AddScaled (v1, doubleValue)"), TestCase::QUICK);
+
+  // check the packed kernels against the scalar definition on a number of
+  // values that is not a multiple of any SIMD register size
+  std::vector<double> manyFreqs;
+  for (int i = 1; i <= 37; i++)
+    {
+      manyFreqs.push_back (i);
+    }
+  Ptr<SpectrumModel> g = Create<SpectrumModel> (manyFreqs);
+  SpectrumValue w1 (g), w2 (g), w3 (g), w4 (g), w5 (g), w6 (g);
+  for (uint32_t i = 0; i < manyFreqs.size (); i++)
+    {
+      w1[i] = std::sin (i + 1.0);
+      w2[i] = 1.5 + std::cos (i + 1.0);
+      w3[i] = w1[i] + w2[i] * doubleValue;
+      w4[i] = w1[i] * w2[i] / doubleValue;
+      w5[i] = w1[i] + w1[i] * w2[i];
+    }
+  SpectrumValue tw3 = w1;
+  tw3.AddScaled (w2, doubleValue);
+  SpectrumValue tw4 = w1;
+  tw4 *= w2;
+  tw4 /= doubleValue;
+  SpectrumValue tw5 = w1;
+  tw5.AddProduct (w1, w2);
+  w6 = w1;
+  w6 -= w2;
+  w6 += w2;
+  AddTestCase (new SpectrumValueTestCase (tw3, w3, "tw3 = w1, tw3.AddScaled (w2, doubleValue)"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tw4, w4, "tw4 = w1 * w2 div doubleValue"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tw5, w5, "tw5 = w1, tw5.AddProduct (w1, w2)"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (w6, w1, "w6 = w1 - w2 + w2"), TestCase::QUICK);
+
 
 
 
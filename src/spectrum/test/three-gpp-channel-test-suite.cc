@@ -22,6 +22,7 @@
 #include "ns3/config.h"
 #include "ns3/double.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/string.h"
 #include "ns3/angles.h"
 #include "ns3/pointer.h"
@@ -35,6 +36,7 @@
 #include "ns3/channel-condition-model.h"
 #include "ns3/three-gpp-spectrum-propagation-loss-model.h"
 #include "ns3/wifi-spectrum-value-helper.h"
+#include "ns3/rng-seed-manager.h"
 
 using namespace ns3;
 
@@ -97,7 +99,7 @@ ThreeGppChannelMatrixComputationTest::DoComputeNorm (Ptr<ThreeGppChannelModel> c
   Ptr<const ThreeGppChannelModel::ChannelMatrix> channelMatrix = channelModel->GetChannel (txMob, rxMob, txAntenna, rxAntenna);
 
   double channelNorm = 0;
-  uint8_t numTotClusters = channelMatrix->m_channel.at (0).at (0).size ();
+  uint8_t numTotClusters = channelMatrix->m_channel.GetNumPages ();
   for (uint8_t cIndex = 0; cIndex < numTotClusters; cIndex++)
   {
     double clusterNorm = 0;
@@ -105,7 +107,7 @@ ThreeGppChannelMatrixComputationTest::DoComputeNorm (Ptr<ThreeGppChannelModel> c
     {
       for (uint32_t uIndex = 0; uIndex < rxAntennaElements; uIndex++)
       {
-        clusterNorm += std::pow (std::abs (channelMatrix->m_channel.at (uIndex).at (sIndex).at (cIndex)), 2);
+        clusterNorm += std::pow (std::abs (channelMatrix->m_channel (uIndex, sIndex, cIndex)), 2);
       }
     }
     channelNorm += clusterNorm;
@@ -167,8 +169,8 @@ ThreeGppChannelMatrixComputationTest::DoRun (void)
   Ptr<const ThreeGppChannelModel::ChannelMatrix> channelMatrix = channelModel->GetChannel (txMob, rxMob, txAntenna, rxAntenna);
 
   // check the channel matrix dimensions
-  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.at (0).size (), txAntennaElements [0] * txAntennaElements [1], "The second dimension of H should be equal to the number of tx antenna elements");
-  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.size (), rxAntennaElements [0] * rxAntennaElements [1], "The first dimension of H should be equal to the number of rx antenna elements");
+  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.GetNumCols (), txAntennaElements [0] * txAntennaElements [1], "The second dimension of H should be equal to the number of tx antenna elements");
+  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.GetNumRows (), rxAntennaElements [0] * rxAntennaElements [1], "The first dimension of H should be equal to the number of rx antenna elements");
 
   // test if the channel matrix is correctly generated
   uint16_t numIt = 1000;
@@ -349,6 +351,158 @@ ThreeGppChannelMatrixUpdateTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for the PregenerateChannels attribute of the ThreeGppChannelModel
+ * class. It checks that the channel matrices of all the links are
+ * regenerated by the first call to GetChannel following an update period
+ * boundary, and that the channel matrices do not depend on the number of
+ * threads used to compute them.
+ */
+class ThreeGppChannelMatrixPregenerationTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  ThreeGppChannelMatrixPregenerationTest ();
+
+  /**
+   * Destructor
+   */
+  virtual ~ThreeGppChannelMatrixPregenerationTest ();
+
+private:
+  /**
+   * Build the test scenario
+   */
+  virtual void DoRun (void);
+
+  /**
+   * Retrieve the channel matrices of all the links from the two channel
+   * models, check that they are identical and whether they were regenerated
+   * \param update whether the channel matrices should have been regenerated
+   */
+  void CheckChannels (bool update);
+
+  Ptr<ThreeGppChannelModel> m_channelModels[2]; //!< the channel models, using one and four threads
+  std::vector<Ptr<MobilityModel> > m_mobilityModels; //!< the mobility models of the nodes
+  std::vector<Ptr<PhasedArrayModel> > m_antennas; //!< the antenna arrays of the nodes
+  std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > m_channels; //!< the channel matrices retrieved by the last call to CheckChannels
+};
+
+ThreeGppChannelMatrixPregenerationTest::ThreeGppChannelMatrixPregenerationTest ()
+  : TestCase ("Check the periodic regeneration of the channel matrices of all the links")
+{
+}
+
+ThreeGppChannelMatrixPregenerationTest::~ThreeGppChannelMatrixPregenerationTest ()
+{
+}
+
+void
+ThreeGppChannelMatrixPregenerationTest::CheckChannels (bool update)
+{
+  std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > channels;
+  // nodes 0 and 1 are the base stations, the other nodes are the users
+  for (uint32_t bs = 0; bs < 2; bs++)
+    {
+      for (uint32_t ut = 2; ut < m_mobilityModels.size (); ut++)
+        {
+          Ptr<const ThreeGppChannelModel::ChannelMatrix> channelMatrices[2];
+          for (uint32_t i = 0; i < 2; i++)
+            {
+              channelMatrices[i] = m_channelModels[i]->GetChannel (m_mobilityModels[bs], m_mobilityModels[ut],
+                                                                   m_antennas[bs], m_antennas[ut]);
+              if (update && !m_channels.empty () && channels.empty ())
+                {
+                  // after the first update period, the first call must have
+                  // regenerated the parameters of all the links
+                  for (uint32_t ut2 = 2; ut2 < m_mobilityModels.size (); ut2++)
+                    {
+                      NS_TEST_ASSERT_MSG_EQ (m_channelModels[i]->GetParams (m_mobilityModels[1 - bs], m_mobilityModels[ut2])->m_generatedTime,
+                                             Simulator::Now (), "The channel params should have been regenerated");
+                    }
+                }
+            }
+
+          const ThreeGppChannelModel::Complex3DArray &h0 = channelMatrices[0]->m_channel;
+          const ThreeGppChannelModel::Complex3DArray &h1 = channelMatrices[1]->m_channel;
+          NS_TEST_ASSERT_MSG_EQ (h0.GetNumRows (), m_antennas[ut]->GetNumberOfElements (), "Unexpected number of rows");
+          NS_TEST_ASSERT_MSG_EQ (h0.GetNumCols (), m_antennas[bs]->GetNumberOfElements (), "Unexpected number of columns");
+          NS_TEST_ASSERT_MSG_EQ (h0.GetNumPages (), h1.GetNumPages (), "The number of clusters should not depend on the number of threads");
+          for (std::size_t uIndex = 0; uIndex < h0.GetNumRows (); uIndex++)
+            {
+              for (std::size_t sIndex = 0; sIndex < h0.GetNumCols (); sIndex++)
+                {
+                  for (std::size_t nIndex = 0; nIndex < h0.GetNumPages (); nIndex++)
+                    {
+                      NS_TEST_ASSERT_MSG_EQ (h0 (uIndex, sIndex, nIndex), h1 (uIndex, sIndex, nIndex),
+                                             "The channel matrix should not depend on the number of threads");
+                    }
+                }
+            }
+
+          if (!m_channels.empty ())
+            {
+              NS_TEST_ASSERT_MSG_EQ ((channelMatrices[0] != m_channels[channels.size ()]), update,
+                                     Simulator::Now ().GetMilliSeconds () << " The channel matrix is not correctly updated");
+            }
+          channels.push_back (channelMatrices[0]);
+        }
+    }
+  m_channels = channels;
+}
+
+void
+ThreeGppChannelMatrixPregenerationTest::DoRun (void)
+{
+  uint32_t updatePeriodMs = 10; // update period in ms
+  uint32_t numThreads[] {1, 4};
+
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      m_channelModels[i] = CreateObject<ThreeGppChannelModel> ();
+      m_channelModels[i]->SetAttribute ("Frequency", DoubleValue (28.0e9));
+      m_channelModels[i]->SetAttribute ("Scenario", StringValue ("UMa"));
+      m_channelModels[i]->SetAttribute ("ChannelConditionModel", PointerValue (CreateObject<AlwaysLosChannelConditionModel> ()));
+      m_channelModels[i]->SetAttribute ("UpdatePeriod", TimeValue (MilliSeconds (updatePeriodMs)));
+      m_channelModels[i]->SetAttribute ("PregenerateChannels", BooleanValue (true));
+      m_channelModels[i]->SetAttribute ("NumThreads", UintegerValue (numThreads[i]));
+      m_channelModels[i]->AssignStreams (1);
+    }
+
+  // create two base stations and three users
+  NodeContainer nodes;
+  nodes.Create (5);
+  for (uint32_t n = 0; n < nodes.GetN (); n++)
+    {
+      Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel> ();
+      mob->SetPosition (n < 2 ? Vector (200.0 * n, 0.0, 25.0) : Vector (50.0 * n, 40.0 * n - 100, 1.5));
+      nodes.Get (n)->AggregateObject (mob);
+      m_mobilityModels.push_back (mob);
+      uint32_t size = (n < 2 ? 4 : 2);
+      m_antennas.push_back (CreateObjectWithAttributes<UniformPlanarArray> ("NumColumns", UintegerValue (size),
+                                                                            "NumRows", UintegerValue (size),
+                                                                            "AntennaElement", PointerValue (CreateObject<IsotropicAntennaModel> ())));
+    }
+
+  // generate the channel matrices for the first time
+  Simulator::Schedule (MilliSeconds (1), &ThreeGppChannelMatrixPregenerationTest::CheckChannels, this, true);
+  // the channel matrices should not be updated before the update period boundary
+  Simulator::Schedule (MilliSeconds (updatePeriodMs - 1), &ThreeGppChannelMatrixPregenerationTest::CheckChannels, this, false);
+  // the first call after the boundary should update the channel matrices of all the links
+  Simulator::Schedule (MilliSeconds (updatePeriodMs + 5), &ThreeGppChannelMatrixPregenerationTest::CheckChannels, this, true);
+  Simulator::Schedule (MilliSeconds (2 * updatePeriodMs - 1), &ThreeGppChannelMatrixPregenerationTest::CheckChannels, this, false);
+
+  Simulator::Run ();
+  m_channels.clear ();
+  m_channelModels[0] = nullptr;
+  m_channelModels[1] = nullptr;
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup spectrum-tests
  * \brief A structure that holds the parameters for the function
@@ -577,6 +731,119 @@ ThreeGppSpectrumPropagationLossModelTest::DoRun ()
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for the computation of the beamforming gain of the
+ * ThreeGppSpectrumPropagationLossModel. The rx PSD of a set of equally
+ * spaced bands, for which the gain is computed by rotating the delay term
+ * from a band to the next one, is compared with the rx PSD obtained by
+ * adding a band with a different spacing, for which the delay term of
+ * every band is computed separately.
+ */
+class ThreeGppBeamformingGainTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  ThreeGppBeamformingGainTest ();
+
+  /**
+   * Destructor
+   */
+  virtual ~ThreeGppBeamformingGainTest ();
+
+private:
+  /**
+   * Build the test scenario
+   */
+  virtual void DoRun (void);
+};
+
+ThreeGppBeamformingGainTest::ThreeGppBeamformingGainTest ()
+  : TestCase ("Check the computation of the beamforming gain for equally spaced bands")
+{
+}
+
+ThreeGppBeamformingGainTest::~ThreeGppBeamformingGainTest ()
+{
+}
+
+void
+ThreeGppBeamformingGainTest::DoRun ()
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+
+  Ptr<ThreeGppSpectrumPropagationLossModel> lossModel = CreateObject<ThreeGppSpectrumPropagationLossModel> ();
+  lossModel->SetChannelModelAttribute ("Frequency", DoubleValue (28.0e9));
+  lossModel->SetChannelModelAttribute ("Scenario", StringValue ("UMi-StreetCanyon"));
+  lossModel->SetChannelModelAttribute ("ChannelConditionModel", PointerValue (CreateObject<NeverLosChannelConditionModel> ()));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  Ptr<MobilityModel> txMob = CreateObject<ConstantPositionMobilityModel> ();
+  txMob->SetPosition (Vector (0.0, 0.0, 10.0));
+  Ptr<MobilityModel> rxMob = CreateObject<ConstantPositionMobilityModel> ();
+  rxMob->SetPosition (Vector (100.0, 50.0, 1.5));
+  nodes.Get (0)->AggregateObject (txMob);
+  nodes.Get (1)->AggregateObject (rxMob);
+
+  Ptr<PhasedArrayModel> txAntenna = CreateObjectWithAttributes<UniformPlanarArray> ("NumColumns", UintegerValue (4),
+                                                                                    "NumRows", UintegerValue (4),
+                                                                                    "AntennaElement", PointerValue (CreateObject<IsotropicAntennaModel> ()));
+  Ptr<PhasedArrayModel> rxAntenna = CreateObjectWithAttributes<UniformPlanarArray> ("NumColumns", UintegerValue (2),
+                                                                                    "NumRows", UintegerValue (2),
+                                                                                    "AntennaElement", PointerValue (CreateObject<IsotropicAntennaModel> ()));
+  txAntenna->SetBeamformingVector (txAntenna->GetBeamformingVector (Angles (rxMob->GetPosition (), txMob->GetPosition ())));
+  rxAntenna->SetBeamformingVector (rxAntenna->GetBeamformingVector (Angles (txMob->GetPosition (), rxMob->GetPosition ())));
+
+  // 275 resource blocks of 180 kHz, the PSD of a block in the middle of the
+  // band is null
+  uint32_t numBands = 275;
+  double step = 180e3;
+  std::vector<double> freqs;
+  for (uint32_t i = 0; i < numBands; i++)
+    {
+      freqs.push_back (28.0e9 + (i - numBands / 2.0) * step);
+    }
+  Ptr<SpectrumValue> uniformTxPsd = Create<SpectrumValue> (Create<SpectrumModel> (freqs));
+  freqs.push_back (freqs.back () + 10 * step);
+  Ptr<SpectrumValue> nonUniformTxPsd = Create<SpectrumValue> (Create<SpectrumModel> (freqs));
+  for (uint32_t i = 0; i < numBands; i++)
+    {
+      double value = (i >= 100 && i < 110) ? 0.0 : 1e-9 * (1 + i % 7);
+      (*uniformTxPsd)[i] = value;
+      (*nonUniformTxPsd)[i] = value;
+    }
+  (*nonUniformTxPsd)[numBands] = 1e-9;
+
+  Ptr<SpectrumValue> uniformRxPsd = lossModel->DoCalcRxPowerSpectralDensity (uniformTxPsd, txMob, rxMob, txAntenna, rxAntenna);
+  Ptr<SpectrumValue> nonUniformRxPsd = lossModel->DoCalcRxPowerSpectralDensity (nonUniformTxPsd, txMob, rxMob, txAntenna, rxAntenna);
+
+  double maxGain = 0.0;
+  for (uint32_t i = 0; i < numBands; i++)
+    {
+      maxGain = std::max (maxGain, (*nonUniformRxPsd)[i] / (*nonUniformTxPsd)[i]);
+    }
+  NS_TEST_ASSERT_MSG_GT (maxGain, 0.0, "The beamforming gain should not be null");
+  for (uint32_t i = 0; i < numBands; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL ((*uniformRxPsd)[i], (*nonUniformRxPsd)[i], 1e-9 * maxGain * (*uniformTxPsd)[i],
+                                 "The rx PSD of the band " << i << " does not match");
+      if ((*uniformTxPsd)[i] == 0.0)
+        {
+          NS_TEST_ASSERT_MSG_EQ ((*uniformRxPsd)[i], 0.0, "The rx PSD of a band with a null tx PSD should be null");
+        }
+    }
+
+  // the tx PSD must not be modified
+  NS_TEST_ASSERT_MSG_EQ ((*uniformTxPsd)[0], 1e-9, "The tx PSD has been modified");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup spectrum-tests
  *
@@ -596,7 +863,9 @@ ThreeGppChannelTestSuite::ThreeGppChannelTestSuite ()
 {
   AddTestCase (new ThreeGppChannelMatrixComputationTest, TestCase::QUICK);
   AddTestCase (new ThreeGppChannelMatrixUpdateTest, TestCase::QUICK);
+  AddTestCase (new ThreeGppChannelMatrixPregenerationTest, TestCase::QUICK);
   AddTestCase (new ThreeGppSpectrumPropagationLossModelTest, TestCase::QUICK);
+  AddTestCase (new ThreeGppBeamformingGainTest, TestCase::QUICK);
 }
 
 /// Static variable for test initialization
@@ -0,0 +1,104 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/wifi-spectrum-value-helper.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Test the transmit PSD template and RF filter caches of WifiSpectrumValueHelper
+ */
+class WifiSpectrumValueCacheTestCase : public TestCase
+{
+public:
+  WifiSpectrumValueCacheTestCase ();
+  virtual ~WifiSpectrumValueCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+WifiSpectrumValueCacheTestCase::WifiSpectrumValueCacheTestCase ()
+  : TestCase ("Check the WifiSpectrumValueHelper transmit PSD and RF filter caches")
+{
+}
+
+WifiSpectrumValueCacheTestCase::~WifiSpectrumValueCacheTestCase ()
+{
+}
+
+void
+WifiSpectrumValueCacheTestCase::DoRun (void)
+{
+  WifiSpectrumValueHelper::ClearCache ();
+  WifiSpectrumValueCacheStats stats = WifiSpectrumValueHelper::GetCacheStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.txPsdEntries, 0, "Cache should be empty");
+
+  Ptr<SpectrumValue> psd1 = WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (5250, 80, 0.1, 80);
+  Ptr<SpectrumValue> psd2 = WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (5250, 80, 0.025, 80);
+  Ptr<SpectrumValue> psd3 = WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (5250, 80, 0.1, 80);
+  stats = WifiSpectrumValueHelper::GetCacheStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.txPsdMisses, 2, "Expected one template per PSD type");
+  NS_TEST_ASSERT_MSG_EQ (stats.txPsdHits, 1, "Expected the second HE PSD to be built from the template");
+  NS_TEST_ASSERT_MSG_EQ (stats.txPsdEntries, 2, "Unexpected number of cached templates");
+
+  NS_TEST_ASSERT_MSG_EQ_TOL (Integral (*psd1), 0.1, 1e-9, "Unexpected total power");
+  NS_TEST_ASSERT_MSG_EQ_TOL (Integral (*psd2), 0.025, 1e-9, "Unexpected total power");
+  NS_TEST_ASSERT_MSG_EQ_TOL (Integral (*psd3), 0.1, 1e-9, "Unexpected total power");
+  for (uint32_t i = 0; i < psd1->GetValuesN (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL ((*psd1)[i], 4 * (*psd2)[i], 1e-6 * (*psd1)[i], "PSD should scale with transmit power");
+    }
+
+  // the returned PSD must be a copy of the template
+  (*psd1) *= 0.0;
+  Ptr<SpectrumValue> psd4 = WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (5250, 80, 0.1, 80);
+  NS_TEST_ASSERT_MSG_EQ_TOL (Integral (*psd4), 0.1, 1e-9, "Cached template should not be modified by the caller");
+
+  Ptr<SpectrumValue> filter1 = WifiSpectrumValueHelper::CreateRfFilter (5250, 80, 78125, 80, std::make_pair (1024, 1279));
+  (*filter1) *= 0.0;
+  Ptr<SpectrumValue> filter2 = WifiSpectrumValueHelper::CreateRfFilter (5250, 80, 78125, 80, std::make_pair (1024, 1279));
+  NS_TEST_ASSERT_MSG_EQ (Sum (*filter2), 256, "Unexpected RF filter");
+  stats = WifiSpectrumValueHelper::GetCacheStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.rfFilterMisses, 1, "Expected a single RF filter to be built");
+  NS_TEST_ASSERT_MSG_EQ (stats.rfFilterHits, 1, "Expected the second RF filter to come from the cache");
+
+  WifiSpectrumValueHelper::ClearCache ();
+  stats = WifiSpectrumValueHelper::GetCacheStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.txPsdEntries + stats.rfFilterEntries, 0, "Cache should be empty");
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief WifiSpectrumValueHelper TestSuite
+ */
+class WifiSpectrumValueHelperTestSuite : public TestSuite
+{
+public:
+  WifiSpectrumValueHelperTestSuite ();
+};
+
+WifiSpectrumValueHelperTestSuite::WifiSpectrumValueHelperTestSuite ()
+  : TestSuite ("wifi-spectrum-value-helper", UNIT)
+{
+  AddTestCase (new WifiSpectrumValueCacheTestCase, TestCase::QUICK);
+}
+
+static WifiSpectrumValueHelperTestSuite g_wifiSpectrumValueHelperTestSuite; ///< the test suite
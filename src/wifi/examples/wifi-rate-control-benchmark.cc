@@ -0,0 +1,257 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Benchmark the cost of the rate control of an AP serving a large number of
+// stations, most of which are idle.
+//
+// A single AP is created and a number of (virtual) stations are added to its
+// remote station manager. At each transmission opportunity, a station is
+// drawn among the active ones, a rate decision is taken and the outcome of
+// the transmission is reported to the manager (the success probability
+// decreases with the selected data rate). Every idle station transmits once
+// per idle period, which exercises the refresh of statistics that were left
+// untouched for a long time.
+//
+// The wall clock time spent in the simulation and the number of rate
+// decisions per second are printed. Options:
+// --wifiManager (Minstrel, MinstrelHt)
+// --nStations (number of stations associated with the AP)
+// --nActive (number of stations with traffic)
+// --txInterval (interval between two transmission opportunities)
+// --idlePeriod (interval between two transmissions of an idle station)
+// --simulationTime (simulated time, in seconds)
+
+#include <algorithm>
+#include "ns3/log.h"
+#include "ns3/command-line.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-mac.h"
+#include "ns3/wifi-mac-queue-item.h"
+#include "ns3/wifi-remote-station-manager.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("WifiRateControlBenchmark");
+
+/**
+ * Rate control benchmark
+ */
+class RateControlBenchmark
+{
+public:
+  /**
+   * Constructor
+   * \param manager the remote station manager of the AP
+   * \param apAddress the MAC address of the AP
+   * \param nStations the number of stations
+   * \param nActive the number of stations with traffic
+   */
+  RateControlBenchmark (Ptr<WifiRemoteStationManager> manager, Mac48Address apAddress,
+                        uint32_t nStations, uint32_t nActive);
+  /**
+   * Schedule the transmissions
+   * \param txInterval the interval between two transmission opportunities
+   * \param idlePeriod the interval between two transmissions of an idle station
+   */
+  void Start (Time txInterval, Time idlePeriod);
+  /**
+   * \return the number of rate decisions taken
+   */
+  uint64_t GetNDecisions (void) const;
+
+private:
+  /**
+   * Transmit a frame to the given station and report the outcome.
+   * \param station the station index
+   */
+  void Transmit (uint32_t station);
+  /**
+   * Transmit a frame to a randomly drawn active station.
+   * \param txInterval the interval between two transmission opportunities
+   */
+  void TransmitToActive (Time txInterval);
+  /**
+   * Transmit a frame to every idle station.
+   * \param idlePeriod the interval between two transmissions of an idle station
+   */
+  void TransmitToIdle (Time idlePeriod);
+
+  Ptr<WifiRemoteStationManager> m_manager;  ///< the remote station manager of the AP
+  Mac48Address m_apAddress;                 ///< the MAC address of the AP
+  std::vector<Mac48Address> m_stations;     ///< the MAC addresses of the stations
+  uint32_t m_nActive;                       ///< the number of stations with traffic
+  Ptr<UniformRandomVariable> m_random;      ///< random variable for stations and outcomes
+  uint64_t m_nDecisions;                    ///< number of rate decisions
+};
+
+RateControlBenchmark::RateControlBenchmark (Ptr<WifiRemoteStationManager> manager, Mac48Address apAddress,
+                                            uint32_t nStations, uint32_t nActive)
+  : m_manager (manager),
+    m_apAddress (apAddress),
+    m_nActive (std::min (nActive, nStations)),
+    m_random (CreateObject<UniformRandomVariable> ()),
+    m_nDecisions (0)
+{
+  Ptr<WifiMac> mac = manager->GetMac ();
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      Mac48Address address = Mac48Address::Allocate ();
+      m_manager->AddAllSupportedModes (address);
+      if (mac->GetHtSupported ())
+        {
+          m_manager->AddStationHtCapabilities (address, mac->GetHtCapabilities ());
+        }
+      if (mac->GetVhtSupported ())
+        {
+          m_manager->AddStationVhtCapabilities (address, mac->GetVhtCapabilities ());
+        }
+      if (mac->GetHeSupported ())
+        {
+          m_manager->AddStationHeCapabilities (address, mac->GetHeCapabilities ());
+        }
+      m_manager->AddAllSupportedMcs (address);
+      m_stations.push_back (address);
+    }
+}
+
+void
+RateControlBenchmark::Start (Time txInterval, Time idlePeriod)
+{
+  if (m_nActive > 0)
+    {
+      Simulator::Schedule (txInterval, &RateControlBenchmark::TransmitToActive, this, txInterval);
+    }
+  if (m_nActive < m_stations.size ())
+    {
+      Simulator::Schedule (idlePeriod, &RateControlBenchmark::TransmitToIdle, this, idlePeriod);
+    }
+}
+
+uint64_t
+RateControlBenchmark::GetNDecisions (void) const
+{
+  return m_nDecisions;
+}
+
+void
+RateControlBenchmark::Transmit (uint32_t station)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_DATA);
+  hdr.SetAddr1 (m_stations[station]);
+  hdr.SetAddr2 (m_apAddress);
+  hdr.SetAddr3 (m_apAddress);
+  Ptr<const WifiMacQueueItem> mpdu = Create<WifiMacQueueItem> (Create<Packet> (1000), hdr);
+
+  WifiTxVector txVector = m_manager->GetDataTxVector (hdr);
+  m_nDecisions++;
+
+  double successProbability = std::max (0.05, 1 - txVector.GetMode ().GetDataRate (txVector) / 150e6);
+  if (m_random->GetValue () < successProbability)
+    {
+      m_manager->ReportDataOk (mpdu, 20, txVector.GetMode (), 20, txVector);
+    }
+  else
+    {
+      m_manager->ReportDataFailed (mpdu);
+      m_manager->ReportFinalDataFailed (mpdu);
+    }
+}
+
+void
+RateControlBenchmark::TransmitToActive (Time txInterval)
+{
+  Transmit (m_random->GetInteger (0, m_nActive - 1));
+  Simulator::Schedule (txInterval, &RateControlBenchmark::TransmitToActive, this, txInterval);
+}
+
+void
+RateControlBenchmark::TransmitToIdle (Time idlePeriod)
+{
+  for (uint32_t i = m_nActive; i < m_stations.size (); i++)
+    {
+      Transmit (i);
+    }
+  Simulator::Schedule (idlePeriod, &RateControlBenchmark::TransmitToIdle, this, idlePeriod);
+}
+
+int main (int argc, char *argv[])
+{
+  std::string wifiManager ("MinstrelHt");
+  uint32_t nStations = 1000;
+  uint32_t nActive = 50;
+  Time txInterval = MicroSeconds (200);
+  Time idlePeriod = Seconds (1);
+  double simulationTime = 10; //seconds
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("wifiManager", "Rate control algorithm (Minstrel, MinstrelHt)", wifiManager);
+  cmd.AddValue ("nStations", "Number of stations associated with the AP", nStations);
+  cmd.AddValue ("nActive", "Number of stations with traffic", nActive);
+  cmd.AddValue ("txInterval", "Interval between two transmission opportunities", txInterval);
+  cmd.AddValue ("idlePeriod", "Interval between two transmissions of an idle station", idlePeriod);
+  cmd.AddValue ("simulationTime", "Simulation time in seconds", simulationTime);
+  cmd.Parse (argc, argv);
+
+  NodeContainer apNode;
+  apNode.Create (1);
+
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy;
+  phy.SetChannel (channel.Create ());
+
+  WifiHelper wifi;
+  // legacy Minstrel does not support HT rates
+  wifi.SetStandard (wifiManager == "Minstrel" ? WIFI_STANDARD_80211a : WIFI_STANDARD_80211ax);
+  wifi.SetRemoteStationManager ("ns3::" + wifiManager + "WifiManager");
+
+  WifiMacHelper mac;
+  mac.SetType ("ns3::ApWifiMac",
+               "BeaconGeneration", BooleanValue (false));
+  NetDeviceContainer apDevice = wifi.Install (phy, mac, apNode);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (apNode);
+
+  Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (apDevice.Get (0));
+  RateControlBenchmark benchmark (device->GetRemoteStationManager (), device->GetMac ()->GetAddress (),
+                                  nStations, nActive);
+  benchmark.Start (txInterval, idlePeriod);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Stop (Seconds (simulationTime));
+  Simulator::Run ();
+  int64_t elapsedMs = clock.End ();
+  Simulator::Destroy ();
+
+  std::cout << wifiManager << ": " << nStations << " stations (" << nActive << " active), "
+            << benchmark.GetNDecisions () << " rate decisions in " << elapsedMs << " ms";
+  if (elapsedMs > 0)
+    {
+      std::cout << " (" << benchmark.GetNDecisions () * 1000 / elapsedMs << " decisions/s)";
+    }
+  std::cout << std::endl;
+
+  return 0;
+}
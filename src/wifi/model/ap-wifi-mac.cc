@@ -36,6 +36,7 @@
 #include "wifi-phy.h"
 #include "wifi-net-device.h"
 #include "wifi-mac-queue.h"
+#include "beacon-abstraction-tag.h"
 #include "ns3/ht-configuration.h"
 #include "ns3/he-configuration.h"
 #include "qos-txop.h"
@@ -75,6 +76,15 @@ ApWifiMac::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&ApWifiMac::SetBeaconGeneration),
                    MakeBooleanChecker ())
+    .AddAttribute ("EnableBeaconAbstraction",
+                   "If enabled, a beacon whose content did not change since the previous beacon "
+                   "is marked so that the associated stations can process it analytically, i.e., "
+                   "without going through the events of the reception process. Such beacons still "
+                   "contend for the medium and occupy airtime. Beacon abstraction is currently "
+                   "supported by the YansWifiChannel only.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&ApWifiMac::m_enableBeaconAbstraction),
+                   MakeBooleanChecker ())
     .AddAttribute ("EnableNonErpProtection", "Whether or not protection mechanism should be used when non-ERP STAs are present within the BSS."
                    "This parameter is only used when ERP is supported by the AP.",
                    BooleanValue (true),
@@ -131,6 +141,7 @@ ApWifiMac::DoDispose ()
   m_beaconTxop = 0;
   m_enableBeaconGeneration = false;
   m_beaconEvent.Cancel ();
+  m_lastBeacon.clear ();
   WifiMac::DoDispose ();
 }
 
@@ -961,6 +972,22 @@ ApWifiMac::SendOneBeacon (void)
     }
   packet->AddHeader (beacon);
 
+  if (m_enableBeaconAbstraction)
+    {
+      //Skip the timestamp, which changes at every beacon
+      std::vector<uint8_t> content (packet->GetSize ());
+      packet->CopyData (content.data (), content.size ());
+      content.erase (content.begin (), content.begin () + 8);
+      if (content == m_lastBeacon)
+        {
+          //Associated stations have already processed the same information
+          NS_LOG_DEBUG ("Beacon content unchanged, mark it for beacon abstraction");
+          BeaconAbstractionTag tag;
+          packet->AddPacketTag (tag);
+        }
+      m_lastBeacon.swap (content);
+    }
+
   //The beacon has it's own special queue, so we load it in there
   m_beaconTxop->Queue (packet, hdr);
   m_beaconEvent = Simulator::Schedule (GetBeaconInterval (), &ApWifiMac::SendOneBeacon, this);
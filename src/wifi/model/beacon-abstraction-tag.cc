@@ -0,0 +1,66 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "beacon-abstraction-tag.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (BeaconAbstractionTag);
+
+TypeId
+BeaconAbstractionTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BeaconAbstractionTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<BeaconAbstractionTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+BeaconAbstractionTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+BeaconAbstractionTag::BeaconAbstractionTag ()
+{
+}
+
+uint32_t
+BeaconAbstractionTag::GetSerializedSize (void) const
+{
+  return 0;
+}
+
+void
+BeaconAbstractionTag::Serialize (TagBuffer i) const
+{
+}
+
+void
+BeaconAbstractionTag::Deserialize (TagBuffer i)
+{
+}
+
+void
+BeaconAbstractionTag::Print (std::ostream &os) const
+{
+  os << "BeaconAbstraction";
+}
+
+} //namespace ns3
@@ -656,6 +656,13 @@ HePhy::IsConfigSupported (Ptr<const WifiPpdu> ppdu) const
   return true;
 }
 
+bool
+HePhy::UseAbstractReception (Ptr<const WifiPpdu> ppdu) const
+{
+  //the OFDMA part of HE TB PPDUs is scheduled at the end of SIG-A, hence HE TB PPDUs are always received field by field
+  return (ppdu->GetType () != WIFI_PPDU_TYPE_UL_MU) && PhyEntity::UseAbstractReception (ppdu);
+}
+
 void
 HePhy::DoStartReceivePayload (Ptr<Event> event)
 {
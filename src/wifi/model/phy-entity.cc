@@ -282,42 +282,76 @@ PhyEntity::EndReceiveField (WifiPpduField field, Ptr<Event> event)
   NS_ASSERT (m_wifiPhy); //no sense if no owner WifiPhy instance
   NS_ASSERT (m_wifiPhy->m_endPhyRxEvent.IsExpired ());
   PhyFieldRxStatus status = DoEndReceiveField (field, event);
-  WifiTxVector txVector = event->GetTxVector ();
   if (status.isSuccess) //move to next field if reception succeeded
     {
-      StartReceiveField (GetNextField (field, txVector.GetPreambleType ()), event);
+      StartReceiveField (GetNextField (field, event->GetTxVector ().GetPreambleType ()), event);
     }
   else
     {
-      Ptr<const WifiPpdu> ppdu = event->GetPpdu ();
-      switch (status.actionIfFailure)
+      HandleFieldRxFailure (field, event, status, GetRemainingDurationAfterField (event->GetPpdu (), field));
+    }
+}
+
+void
+PhyEntity::EndReceivePhyHeader (Ptr<Event> event)
+{
+  NS_LOG_FUNCTION (this << *event);
+  NS_ASSERT (m_wifiPhy); //no sense if no owner WifiPhy instance
+  NS_ASSERT (m_wifiPhy->m_endPhyRxEvent.IsExpired ());
+  const WifiTxVector& txVector = event->GetTxVector ();
+  WifiPpduField field = WIFI_PPDU_FIELD_PREAMBLE;
+  while (field != WIFI_PPDU_FIELD_DATA)
+    {
+      if (field != WIFI_PPDU_FIELD_PREAMBLE)
         {
-          case ABORT:
-            //Abort reception, but consider medium as busy
-            AbortCurrentReception (status.reason);
-            if (event->GetEndTime () > (Simulator::Now () + m_state->GetDelayUntilIdle ()))
-              {
-                m_wifiPhy->SwitchMaybeToCcaBusy (GetMeasurementChannelWidth (ppdu));
-              }
-            break;
-          case DROP:
-            //Notify drop, keep in CCA busy, and perform same processing as IGNORE case
-            if (status.reason == FILTERED)
-              {
-                //PHY-RXSTART is immediately followed by PHY-RXEND (Filtered)
-                m_wifiPhy->m_phyRxPayloadBeginTrace (txVector, NanoSeconds (0)); //this callback (equivalent to PHY-RXSTART primitive) is also triggered for filtered PPDUs
-              }
-            m_wifiPhy->NotifyRxDrop (GetAddressedPsduInPpdu (ppdu), status.reason);
-            m_state->SwitchMaybeToCcaBusy (GetRemainingDurationAfterField (ppdu, field)); //keep in CCA busy state till the end
-          //no break
-          case IGNORE:
-            //Keep in Rx state and reset at end
-            m_endRxPayloadEvents.push_back (Simulator::Schedule (GetRemainingDurationAfterField (ppdu, field),
-                                                                 &PhyEntity::ResetReceive, this, event));
-            break;
-          default:
-            NS_FATAL_ERROR ("Unknown action in case of failure");
+          bool supported = DoStartReceiveField (field, event);
+          NS_ABORT_MSG_IF (!supported, "Unknown field " << field << " for this PHY entity");
         }
+      PhyFieldRxStatus status = DoEndReceiveField (field, event);
+      if (!status.isSuccess)
+        {
+          //the PHY header has been entirely received, so the whole payload remains
+          Time remainingDuration = event->GetPpdu ()->GetTxDuration () - CalculatePhyPreambleAndHeaderDuration (txVector);
+          HandleFieldRxFailure (field, event, status, remainingDuration);
+          return;
+        }
+      field = GetNextField (field, txVector.GetPreambleType ());
+    }
+  StartReceivePayload (event);
+}
+
+void
+PhyEntity::HandleFieldRxFailure (WifiPpduField field, Ptr<Event> event, PhyFieldRxStatus status, Time remainingDuration)
+{
+  NS_LOG_FUNCTION (this << field << *event << status << remainingDuration);
+  Ptr<const WifiPpdu> ppdu = event->GetPpdu ();
+  switch (status.actionIfFailure)
+    {
+      case ABORT:
+        //Abort reception, but consider medium as busy
+        AbortCurrentReception (status.reason);
+        if (event->GetEndTime () > (Simulator::Now () + m_state->GetDelayUntilIdle ()))
+          {
+            m_wifiPhy->SwitchMaybeToCcaBusy (GetMeasurementChannelWidth (ppdu));
+          }
+        break;
+      case DROP:
+        //Notify drop, keep in CCA busy, and perform same processing as IGNORE case
+        if (status.reason == FILTERED)
+          {
+            //PHY-RXSTART is immediately followed by PHY-RXEND (Filtered)
+            m_wifiPhy->m_phyRxPayloadBeginTrace (ppdu->GetTxVector (), NanoSeconds (0)); //this callback (equivalent to PHY-RXSTART primitive) is also triggered for filtered PPDUs
+          }
+        m_wifiPhy->NotifyRxDrop (GetAddressedPsduInPpdu (ppdu), status.reason);
+        m_state->SwitchMaybeToCcaBusy (remainingDuration); //keep in CCA busy state till the end
+      //no break
+      case IGNORE:
+        //Keep in Rx state and reset at end
+        m_endRxPayloadEvents.push_back (Simulator::Schedule (remainingDuration,
+                                                             &PhyEntity::ResetReceive, this, event));
+        break;
+      default:
+        NS_FATAL_ERROR ("Unknown action in case of failure");
     }
 }
 
@@ -547,7 +581,11 @@ PhyEntity::DoStartReceivePayload (Ptr<Event> event)
   uint16_t staId = GetStaId (ppdu);
   m_signalNoiseMap.insert ({std::make_pair (ppdu->GetUid (), staId), SignalNoiseDbm ()});
   m_statusPerMpduMap.insert ({std::make_pair (ppdu->GetUid (), staId), std::vector<bool> ()});
-  ScheduleEndOfMpdus (event);
+  if (!UseAbstractReception (ppdu))
+    {
+      ScheduleEndOfMpdus (event);
+    }
+  //else the MPDUs are processed at the end of the PPDU
   m_endRxPayloadEvents.push_back (Simulator::Schedule (ppdu->GetTxDuration () - CalculatePhyPreambleAndHeaderDuration (event->GetTxVector ()),
                                                        &PhyEntity::EndReceivePayload, this, event));
 }
@@ -568,6 +606,8 @@ PhyEntity::ScheduleEndOfMpdus (Ptr<Event> event)
   MpduType mpduType = (nMpdus > 1) ? FIRST_MPDU_IN_AGGREGATE : (psdu->IsSingle () ? SINGLE_MPDU : NORMAL_MPDU);
   uint32_t totalAmpduSize = 0;
   double totalAmpduNumSymbols = 0.0;
+  bool abstractReception = UseAbstractReception (ppdu);
+  NS_ASSERT (!abstractReception || event->GetEndTime () == Simulator::Now ());
   auto mpdu = psdu->begin ();
   for (size_t i = 0; i < nMpdus && mpdu != psdu->end (); ++mpdu)
     {
@@ -589,7 +629,14 @@ PhyEntity::ScheduleEndOfMpdus (Ptr<Event> event)
       NS_LOG_INFO ("Schedule end of MPDU #" << i << " in " << endOfMpduDuration.As (Time::NS) <<
                    " (relativeStart=" << relativeStart.As (Time::NS) << ", mpduDuration=" << mpduDuration.As (Time::NS) <<
                    ", remainingAmdpuDuration=" << remainingAmpduDuration.As (Time::NS) << ")");
-      m_endOfMpduEvents.push_back (Simulator::Schedule (endOfMpduDuration, &PhyEntity::EndOfMpdu, this, event, Create<WifiPsdu> (*mpdu, false), i, relativeStart, mpduDuration));
+      if (abstractReception)
+        {
+          EndOfMpdu (event, Create<WifiPsdu> (*mpdu, false), i, relativeStart, mpduDuration);
+        }
+      else
+        {
+          m_endOfMpduEvents.push_back (Simulator::Schedule (endOfMpduDuration, &PhyEntity::EndOfMpdu, this, event, Create<WifiPsdu> (*mpdu, false), i, relativeStart, mpduDuration));
+        }
 
       //Prepare next iteration
       ++i;
@@ -637,6 +684,10 @@ PhyEntity::EndReceivePayload (Ptr<Event> event)
   Time psduDuration = ppdu->GetTxDuration () - CalculatePhyPreambleAndHeaderDuration (txVector);
   NS_LOG_FUNCTION (this << *event << psduDuration);
   NS_ASSERT (event->GetEndTime () == Simulator::Now ());
+  if (UseAbstractReception (ppdu))
+    {
+      ScheduleEndOfMpdus (event); //MPDUs are processed right away
+    }
   uint16_t staId = GetStaId (ppdu);
   const auto & channelWidthAndBand = GetChannelWidthAndBand (event->GetTxVector (), staId);
   double snr = m_wifiPhy->m_interference.CalculateSnr (event, channelWidthAndBand.first, txVector.GetNss (staId), channelWidthAndBand.second);
@@ -875,10 +926,20 @@ PhyEntity::EndPreambleDetectionPeriod (Ptr<Event> event)
       m_wifiPhy->NotifyRxBegin (GetAddressedPsduInPpdu (m_wifiPhy->m_currentEvent->GetPpdu ()), m_wifiPhy->m_currentEvent->GetRxPowerWPerBand ());
       m_wifiPhy->m_timeLastPreambleDetected = Simulator::Now ();
 
-      //Continue receiving preamble
-      Time durationTillEnd = GetDuration (WIFI_PPDU_FIELD_PREAMBLE, event->GetTxVector ()) - m_wifiPhy->GetPreambleDetectionDuration ();
-      m_state->SwitchMaybeToCcaBusy (durationTillEnd); //will be prolonged by next field
-      m_wifiPhy->m_endPhyRxEvent = Simulator::Schedule (durationTillEnd, &PhyEntity::EndReceiveField, this, WIFI_PPDU_FIELD_PREAMBLE, event);
+      if (UseAbstractReception (event->GetPpdu ()))
+        {
+          //Resolve all PHY header fields at once when the payload starts
+          Time durationTillPayload = CalculatePhyPreambleAndHeaderDuration (event->GetTxVector ()) - m_wifiPhy->GetPreambleDetectionDuration ();
+          m_state->SwitchMaybeToCcaBusy (durationTillPayload);
+          m_wifiPhy->m_endPhyRxEvent = Simulator::Schedule (durationTillPayload, &PhyEntity::EndReceivePhyHeader, this, event);
+        }
+      else
+        {
+          //Continue receiving preamble
+          Time durationTillEnd = GetDuration (WIFI_PPDU_FIELD_PREAMBLE, event->GetTxVector ()) - m_wifiPhy->GetPreambleDetectionDuration ();
+          m_state->SwitchMaybeToCcaBusy (durationTillEnd); //will be prolonged by next field
+          m_wifiPhy->m_endPhyRxEvent = Simulator::Schedule (durationTillEnd, &PhyEntity::EndReceiveField, this, WIFI_PPDU_FIELD_PREAMBLE, event);
+        }
     }
   else
     {
@@ -909,6 +970,12 @@ PhyEntity::IsConfigSupported (Ptr<const WifiPpdu> ppdu) const
   return true;
 }
 
+bool
+PhyEntity::UseAbstractReception (Ptr<const WifiPpdu> /* ppdu */) const
+{
+  return m_wifiPhy->GetAbstractReception ();
+}
+
 void
 PhyEntity::CancelAllEvents (void)
 {
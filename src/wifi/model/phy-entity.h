@@ -385,6 +385,19 @@ public:
    * \param event the event holding incoming PPDU's information
    */
   void EndReceiveField (WifiPpduField field, Ptr<Event> event);
+  /**
+   * End receiving all the PHY header fields at once (i.e. the first symbol
+   * of the PSDU has arrived) when the abstract reception mode is used.
+   *
+   * This method successively calls DoStartReceiveField and DoEndReceiveField
+   * for every field following the preamble. The SNIR of each field is computed
+   * over the same interval as when the field is received on its own. In case
+   * of success, the reception of the payload is started, otherwise the
+   * indications in the \see PhyFieldRxStatus of the failed field are performed.
+   *
+   * \param event the event holding incoming PPDU's information
+   */
+  void EndReceivePhyHeader (Ptr<Event> event);
 
   /**
    * The last symbol of the PPDU has arrived.
@@ -588,6 +601,27 @@ protected:
    */
   virtual bool IsConfigSupported (Ptr<const WifiPpdu> ppdu) const;
 
+  /**
+   * Check whether the abstract reception mode (\see WifiPhy::SetAbstractReception)
+   * can be used to receive the given PPDU.
+   *
+   * \param ppdu the received PPDU
+   * \return \c true if the PHY header fields and the MPDUs of the PPDU are
+   *         resolved without per-field and per-MPDU events, \c false otherwise
+   */
+  virtual bool UseAbstractReception (Ptr<const WifiPpdu> ppdu) const;
+
+  /**
+   * Perform the actions indicated by the status of a PPDU field whose
+   * reception failed.
+   *
+   * \param field the PPDU field whose reception failed
+   * \param event the event holding incoming PPDU's information
+   * \param status the status of the reception of the PPDU field
+   * \param remainingDuration the remaining duration of the PPDU
+   */
+  void HandleFieldRxFailure (WifiPpduField field, Ptr<Event> event, PhyFieldRxStatus status, Time remainingDuration);
+
   /**
    * Drop the PPDU and the corresponding preamble detection event, but keep CCA busy
    * state after the completion of the currently processed event.
@@ -637,6 +671,9 @@ protected:
   /**
    * Schedule end of MPDUs events.
    *
+   * In abstract reception mode, this method is called at the end of the
+   * PPDU and the MPDUs are processed right away instead.
+   *
    * \param event the event holding incoming PPDU's information
    */
   void ScheduleEndOfMpdus (Ptr<Event> event);
@@ -65,6 +65,12 @@ struct MinstrelHtWifiRemoteStation : MinstrelWifiRemoteStation
   uint32_t m_ampduPacketCount; //!< Number of A-MPDUs transmitted.
 
   McsGroupData m_groupsTable;  //!< Table of groups with stats.
+  /**
+   * EWMA of the success probability of every rate, indexed by GetIndex (groupId, rateId).
+   * Together with m_throughput, kept in contiguous storage for the best rate search.
+   */
+  std::vector<double> m_ewmaProb;
+  std::vector<double> m_throughput; //!< Throughput of every rate (in packets per second), indexed by GetIndex (groupId, rateId).
   bool m_isHt;                 //!< If the station is HT capable.
 
   std::ofstream m_statsFile;   //!< File where statistics table is written.
@@ -1132,13 +1138,13 @@ MinstrelHtWifiManager::FindRate (MinstrelHtWifiRemoteStation *station)
            * Also do not sample if the probability is already higher than 95%
            * to avoid wasting airtime.
            */
-          MinstrelHtRateInfo sampleRateInfo = station->m_groupsTable[sampleGroupId].m_ratesTable[sampleRateId];
+          const MinstrelHtRateInfo &sampleRateInfo = station->m_groupsTable[sampleGroupId].m_ratesTable[sampleRateId];
 
           NS_LOG_DEBUG ("Use sample rate? MaxTpRate= " << station->m_maxTpRate << " CurrentRate= " << station->m_txrate <<
-                        " SampleRate= " << sampleIdx << " SampleProb= " << sampleRateInfo.ewmaProb);
+                        " SampleRate= " << sampleIdx << " SampleProb= " << station->m_ewmaProb[sampleIdx]);
 
           if (sampleIdx != station->m_maxTpRate && sampleIdx != station->m_maxTpRate2
-              && sampleIdx != station->m_maxProbRate && sampleRateInfo.ewmaProb <= 95)
+              && sampleIdx != station->m_maxProbRate && station->m_ewmaProb[sampleIdx] <= 95)
             {
 
               /**
@@ -1208,7 +1214,27 @@ MinstrelHtWifiManager::UpdateStats (MinstrelHtWifiRemoteStation *station)
 {
   NS_LOG_FUNCTION (this << station);
 
-  station->m_nextStatsUpdate = Simulator::Now () + m_updateStats;
+  /**
+   * Statistics are only refreshed when the station is used, hence several update
+   * intervals may have elapsed since the last update. All the attempts made since
+   * then belong to the first elapsed interval; the other intervals had no attempt
+   * and are accounted for in closed form below.
+   */
+  int64_t missedIntervals = 0;
+  if (Simulator::Now () < station->m_nextStatsUpdate)
+    {
+      //initial update
+      station->m_nextStatsUpdate = Simulator::Now () + m_updateStats;
+    }
+  else
+    {
+      if (m_updateStats.IsStrictlyPositive ())
+        {
+          missedIntervals = (Simulator::Now () - station->m_nextStatsUpdate).GetTimeStep () / m_updateStats.GetTimeStep ();
+        }
+      station->m_nextStatsUpdate += (missedIntervals + 1) * m_updateStats;
+    }
+  NS_LOG_DEBUG ("Next update at " << station->m_nextStatsUpdate << " (" << missedIntervals << " intervals without attempts)");
 
   station->m_numSamplesSlow = 0;
   station->m_sampleCount = 0;
@@ -1224,9 +1250,10 @@ MinstrelHtWifiManager::UpdateStats (MinstrelHtWifiRemoteStation *station)
     }
 
   /* Initialize global rate indexes */
-  station->m_maxTpRate = GetLowestIndex (station);
-  station->m_maxTpRate2 = GetLowestIndex (station);
-  station->m_maxProbRate = GetLowestIndex (station);
+  uint16_t lowestIndex = GetLowestIndex (station);
+  station->m_maxTpRate = lowestIndex;
+  station->m_maxTpRate2 = lowestIndex;
+  station->m_maxProbRate = lowestIndex;
 
   /// Update throughput and EWMA for each rate inside each group.
   for (uint8_t j = 0; j < m_numGroups; j++)
@@ -1236,67 +1263,76 @@ MinstrelHtWifiManager::UpdateStats (MinstrelHtWifiRemoteStation *station)
           station->m_sampleCount++;
 
           /* (re)Initialize group rate indexes */
-          station->m_groupsTable[j].m_maxTpRate = GetLowestIndex (station, j);
-          station->m_groupsTable[j].m_maxTpRate2 = GetLowestIndex (station, j);
-          station->m_groupsTable[j].m_maxProbRate = GetLowestIndex (station, j);
+          uint16_t groupLowestIndex = GetLowestIndex (station, j);
+          station->m_groupsTable[j].m_maxTpRate = groupLowestIndex;
+          station->m_groupsTable[j].m_maxTpRate2 = groupLowestIndex;
+          station->m_groupsTable[j].m_maxProbRate = groupLowestIndex;
 
           for (uint8_t i = 0; i < m_numRates; i++)
             {
-              if (station->m_groupsTable[j].m_ratesTable[i].supported)
+              MinstrelHtRateInfo &rate = station->m_groupsTable[j].m_ratesTable[i];
+              if (rate.supported)
                 {
-                  station->m_groupsTable[j].m_ratesTable[i].retryUpdated = false;
+                  uint16_t index = GetIndex (j, i);
+                  rate.retryUpdated = false;
 
-                  NS_LOG_DEBUG (+i << " " << GetMcsSupported (station, station->m_groupsTable[j].m_ratesTable[i].mcsIndex) <<
-                                "\t attempt=" << station->m_groupsTable[j].m_ratesTable[i].numRateAttempt <<
-                                "\t success=" << station->m_groupsTable[j].m_ratesTable[i].numRateSuccess);
+                  NS_LOG_DEBUG (+i << " " << GetMcsSupported (station, rate.mcsIndex) <<
+                                "\t attempt=" << rate.numRateAttempt <<
+                                "\t success=" << rate.numRateSuccess);
 
                   /// If we've attempted something.
-                  if (station->m_groupsTable[j].m_ratesTable[i].numRateAttempt > 0)
+                  if (rate.numRateAttempt > 0)
                     {
-                      station->m_groupsTable[j].m_ratesTable[i].numSamplesSkipped = 0;
+                      rate.numSamplesSkipped = 0;
                       /**
                        * Calculate the probability of success.
                        * Assume probability scales from 0 to 100.
                        */
-                      tempProb = (100 * station->m_groupsTable[j].m_ratesTable[i].numRateSuccess) / station->m_groupsTable[j].m_ratesTable[i].numRateAttempt;
+                      tempProb = (100 * rate.numRateSuccess) / rate.numRateAttempt;
 
                       /// Bookkeeping.
-                      station->m_groupsTable[j].m_ratesTable[i].prob = tempProb;
+                      rate.prob = tempProb;
 
-                      if (station->m_groupsTable[j].m_ratesTable[i].successHist == 0)
+                      if (rate.successHist == 0)
                         {
-                          station->m_groupsTable[j].m_ratesTable[i].ewmaProb = tempProb;
+                          station->m_ewmaProb[index] = tempProb;
                         }
                       else
                         {
-                          station->m_groupsTable[j].m_ratesTable[i].ewmsdProb = CalculateEwmsd (station->m_groupsTable[j].m_ratesTable[i].ewmsdProb,
-                                                                                                tempProb, station->m_groupsTable[j].m_ratesTable[i].ewmaProb,
-                                                                                                m_ewmaLevel);
+                          rate.ewmsdProb = CalculateEwmsd (rate.ewmsdProb, tempProb, station->m_ewmaProb[index], m_ewmaLevel);
                           /// EWMA probability
-                          tempProb = (tempProb * (100 - m_ewmaLevel) + station->m_groupsTable[j].m_ratesTable[i].ewmaProb * m_ewmaLevel)  / 100;
-                          station->m_groupsTable[j].m_ratesTable[i].ewmaProb = tempProb;
+                          tempProb = (tempProb * (100 - m_ewmaLevel) + station->m_ewmaProb[index] * m_ewmaLevel)  / 100;
+                          station->m_ewmaProb[index] = tempProb;
                         }
 
-                      station->m_groupsTable[j].m_ratesTable[i].throughput = CalculateThroughput (station, j, i, tempProb);
+                      station->m_throughput[index] = CalculateThroughput (station, j, i, tempProb);
 
-                      station->m_groupsTable[j].m_ratesTable[i].successHist += station->m_groupsTable[j].m_ratesTable[i].numRateSuccess;
-                      station->m_groupsTable[j].m_ratesTable[i].attemptHist += station->m_groupsTable[j].m_ratesTable[i].numRateAttempt;
+                      rate.successHist += rate.numRateSuccess;
+                      rate.attemptHist += rate.numRateAttempt;
                     }
                   else
                     {
-                      station->m_groupsTable[j].m_ratesTable[i].numSamplesSkipped++;
+                      rate.numSamplesSkipped++;
                     }
 
                   /// Bookkeeping.
-                  station->m_groupsTable[j].m_ratesTable[i].prevNumRateSuccess = station->m_groupsTable[j].m_ratesTable[i].numRateSuccess;
-                  station->m_groupsTable[j].m_ratesTable[i].prevNumRateAttempt = station->m_groupsTable[j].m_ratesTable[i].numRateAttempt;
-                  station->m_groupsTable[j].m_ratesTable[i].numRateSuccess = 0;
-                  station->m_groupsTable[j].m_ratesTable[i].numRateAttempt = 0;
+                  rate.prevNumRateSuccess = rate.numRateSuccess;
+                  rate.prevNumRateAttempt = rate.numRateAttempt;
+                  rate.numRateSuccess = 0;
+                  rate.numRateAttempt = 0;
+
+                  /// Intervals elapsed without any attempt.
+                  if (missedIntervals > 0)
+                    {
+                      rate.numSamplesSkipped += missedIntervals;
+                      rate.prevNumRateSuccess = 0;
+                      rate.prevNumRateAttempt = 0;
+                    }
 
-                  if (station->m_groupsTable[j].m_ratesTable[i].throughput != 0)
+                  if (station->m_throughput[index] != 0)
                     {
-                      SetBestStationThRates (station, GetIndex (j, i));
-                      SetBestProbabilityRate (station, GetIndex (j, i));
+                      SetBestStationThRates (station, index);
+                      SetBestProbabilityRate (station, index);
                     }
 
                 }
@@ -1352,51 +1388,29 @@ MinstrelHtWifiManager::CalculateThroughput (MinstrelHtWifiRemoteStation *station
 void
 MinstrelHtWifiManager::SetBestProbabilityRate (MinstrelHtWifiRemoteStation *station, uint16_t index)
 {
-  GroupInfo *group;
-  MinstrelHtRateInfo rate;
-  uint8_t tmpGroupId, tmpRateId;
-  double tmpTh, tmpProb;
-  uint8_t groupId, rateId;
-  double currentTh;
-  // maximum group probability (GP) variables
-  uint8_t maxGPGroupId, maxGPRateId;
-  double maxGPTh;
-
-  groupId = GetGroupId (index);
-  rateId = GetRateId (index);
-  group = &station->m_groupsTable[groupId];
-  rate = group->m_ratesTable[rateId];
-
-  tmpGroupId = GetGroupId (station->m_maxProbRate);
-  tmpRateId = GetRateId (station->m_maxProbRate);
-  tmpProb = station->m_groupsTable[tmpGroupId].m_ratesTable[tmpRateId].ewmaProb;
-  tmpTh =  station->m_groupsTable[tmpGroupId].m_ratesTable[tmpRateId].throughput;
-
-  if (rate.ewmaProb > 75)
-    {
-      currentTh = station->m_groupsTable[groupId].m_ratesTable[rateId].throughput;
-      if (currentTh > tmpTh)
+  GroupInfo *group = &station->m_groupsTable[GetGroupId (index)];
+  double prob = station->m_ewmaProb[index];
+  double th = station->m_throughput[index];
+
+  if (prob > 75)
+    {
+      if (th > station->m_throughput[station->m_maxProbRate])
         {
           station->m_maxProbRate = index;
         }
-
-      maxGPGroupId = GetGroupId (group->m_maxProbRate);
-      maxGPRateId = GetRateId (group->m_maxProbRate);
-      maxGPTh = station->m_groupsTable[maxGPGroupId].m_ratesTable[maxGPRateId].throughput;
-
-      if (currentTh > maxGPTh)
+      // maximum group probability (GP)
+      if (th > station->m_throughput[group->m_maxProbRate])
         {
           group->m_maxProbRate = index;
         }
     }
   else
     {
-      if (rate.ewmaProb > tmpProb)
+      if (prob > station->m_ewmaProb[station->m_maxProbRate])
         {
           station->m_maxProbRate = index;
         }
-      maxGPRateId = GetRateId (group->m_maxProbRate);
-      if (rate.ewmaProb > group->m_ratesTable[maxGPRateId].ewmaProb)
+      if (prob > station->m_ewmaProb[group->m_maxProbRate])
         {
           group->m_maxProbRate = index;
         }
@@ -1413,57 +1427,32 @@ MinstrelHtWifiManager::SetBestProbabilityRate (MinstrelHtWifiRemoteStation *stat
 void
 MinstrelHtWifiManager::SetBestStationThRates (MinstrelHtWifiRemoteStation *station, uint16_t index)
 {
-  uint8_t groupId, rateId;
-  double th, prob;
-  uint8_t maxTpGroupId, maxTpRateId;
-  uint8_t maxTp2GroupId, maxTp2RateId;
-  double maxTpTh, maxTpProb;
-  double maxTp2Th, maxTp2Prob;
-
-  groupId = GetGroupId (index);
-  rateId = GetRateId (index);
-  prob = station->m_groupsTable[groupId].m_ratesTable[rateId].ewmaProb;
-  th = station->m_groupsTable[groupId].m_ratesTable[rateId].throughput;
-
-  maxTpGroupId = GetGroupId (station->m_maxTpRate);
-  maxTpRateId = GetRateId (station->m_maxTpRate);
-  maxTpProb = station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTpRateId].ewmaProb;
-  maxTpTh = station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTpRateId].throughput;
-
-  maxTp2GroupId = GetGroupId (station->m_maxTpRate2);
-  maxTp2RateId = GetRateId (station->m_maxTpRate2);
-  maxTp2Prob = station->m_groupsTable[maxTp2GroupId].m_ratesTable[maxTp2RateId].ewmaProb;
-  maxTp2Th = station->m_groupsTable[maxTp2GroupId].m_ratesTable[maxTp2RateId].throughput;
-
-  if (th > maxTpTh || (th == maxTpTh && prob > maxTpProb))
+  double prob = station->m_ewmaProb[index];
+  double th = station->m_throughput[index];
+
+  if (th > station->m_throughput[station->m_maxTpRate]
+      || (th == station->m_throughput[station->m_maxTpRate] && prob > station->m_ewmaProb[station->m_maxTpRate]))
     {
       station->m_maxTpRate2 = station->m_maxTpRate;
       station->m_maxTpRate = index;
     }
-  else if (th > maxTp2Th || (th == maxTp2Th && prob > maxTp2Prob))
+  else if (th > station->m_throughput[station->m_maxTpRate2]
+           || (th == station->m_throughput[station->m_maxTpRate2] && prob > station->m_ewmaProb[station->m_maxTpRate2]))
     {
       station->m_maxTpRate2 = index;
     }
 
   //Find best rates per group
 
-  GroupInfo *group = &station->m_groupsTable[groupId];
-  maxTpGroupId = GetGroupId (group->m_maxTpRate);
-  maxTpRateId = GetRateId (group->m_maxTpRate);
-  maxTpProb = group->m_ratesTable[maxTpRateId].ewmaProb;
-  maxTpTh = station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTpRateId].throughput;
-
-  maxTp2GroupId = GetGroupId (group->m_maxTpRate2);
-  maxTp2RateId = GetRateId (group->m_maxTpRate2);
-  maxTp2Prob = group->m_ratesTable[maxTp2RateId].ewmaProb;
-  maxTp2Th = station->m_groupsTable[maxTp2GroupId].m_ratesTable[maxTp2RateId].throughput;
-
-  if (th > maxTpTh || (th == maxTpTh && prob > maxTpProb))
+  GroupInfo *group = &station->m_groupsTable[GetGroupId (index)];
+  if (th > station->m_throughput[group->m_maxTpRate]
+      || (th == station->m_throughput[group->m_maxTpRate] && prob > station->m_ewmaProb[group->m_maxTpRate]))
     {
       group->m_maxTpRate2 = group->m_maxTpRate;
       group->m_maxTpRate = index;
     }
-  else if (th > maxTp2Th || (th == maxTp2Th && prob > maxTp2Prob))
+  else if (th > station->m_throughput[group->m_maxTpRate2]
+           || (th == station->m_throughput[group->m_maxTpRate2] && prob > station->m_ewmaProb[group->m_maxTpRate2]))
     {
       group->m_maxTpRate2 = index;
     }
@@ -1475,6 +1464,8 @@ MinstrelHtWifiManager::RateInit (MinstrelHtWifiRemoteStation *station)
   NS_LOG_FUNCTION (this << station);
 
   station->m_groupsTable = McsGroupData (m_numGroups);
+  station->m_ewmaProb.assign (m_numGroups * m_numRates, 0);
+  station->m_throughput.assign (m_numGroups * m_numRates, 0);
 
   /**
   * Initialize groups supported by the receiver.
@@ -1577,13 +1568,11 @@ MinstrelHtWifiManager::RateInit (MinstrelHtWifiRemoteStation *station)
                   station->m_groupsTable[groupId].m_ratesTable[rateId].numRateAttempt = 0;
                   station->m_groupsTable[groupId].m_ratesTable[rateId].numRateSuccess = 0;
                   station->m_groupsTable[groupId].m_ratesTable[rateId].prob = 0;
-                  station->m_groupsTable[groupId].m_ratesTable[rateId].ewmaProb = 0;
                   station->m_groupsTable[groupId].m_ratesTable[rateId].prevNumRateAttempt = 0;
                   station->m_groupsTable[groupId].m_ratesTable[rateId].prevNumRateSuccess = 0;
                   station->m_groupsTable[groupId].m_ratesTable[rateId].numSamplesSkipped = 0;
                   station->m_groupsTable[groupId].m_ratesTable[rateId].successHist = 0;
                   station->m_groupsTable[groupId].m_ratesTable[rateId].attemptHist = 0;
-                  station->m_groupsTable[groupId].m_ratesTable[rateId].throughput = 0;
                   station->m_groupsTable[groupId].m_ratesTable[rateId].perfectTxTime = GetFirstMpduTxTime (groupId, GetMcsSupported (station, i));
                   station->m_groupsTable[groupId].m_ratesTable[rateId].retryCount = 0;
                   station->m_groupsTable[groupId].m_ratesTable[rateId].adjustedRetryCount = 0;
@@ -1625,7 +1614,7 @@ MinstrelHtWifiManager::CalculateRetransmits (MinstrelHtWifiRemoteStation *statio
   Time slotTime = GetPhy ()->GetSlot ();
   Time ackTime = GetPhy ()->GetSifs () + GetPhy ()->GetBlockAckTxTime ();
 
-  if (station->m_groupsTable[groupId].m_ratesTable[rateId].ewmaProb < 1)
+  if (station->m_ewmaProb[GetIndex (groupId, rateId)] < 1)
     {
       station->m_groupsTable[groupId].m_ratesTable[rateId].retryCount = 1;
     }
@@ -1789,8 +1778,8 @@ MinstrelHtWifiManager::StatsDump (MinstrelHtWifiRemoteStation *station, uint8_t
           of << std::setw (6) << txTime.GetMicroSeconds () << "  ";
 
           of << std::setw (7) << CalculateThroughput (station, groupId, i, 100) / 100 << "   " <<
-            std::setw (7) << station->m_groupsTable[groupId].m_ratesTable[i].throughput / 100 << "   " <<
-            std::setw (7) << station->m_groupsTable[groupId].m_ratesTable[i].ewmaProb << "  " <<
+            std::setw (7) << station->m_throughput[GetIndex (groupId, i)] / 100 << "   " <<
+            std::setw (7) << station->m_ewmaProb[GetIndex (groupId, i)] << "  " <<
             std::setw (7) << station->m_groupsTable[groupId].m_ratesTable[i].ewmsdProb << "  " <<
             std::setw (7) << station->m_groupsTable[groupId].m_ratesTable[i].prob << "  " <<
             std::setw (2) << station->m_groupsTable[groupId].m_ratesTable[i].retryCount << "   " <<
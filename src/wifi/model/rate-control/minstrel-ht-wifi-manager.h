@@ -98,6 +98,11 @@ typedef std::vector<McsGroup> MinstrelMcsGroups;
 struct MinstrelHtWifiRemoteStation;
 /**
  * A struct to contain all statistics information related to a data rate.
+ * The EWMA of the success probability and the throughput, which are scanned
+ * by the best rate search, are stored per station in contiguous arrays
+ * instead (see MinstrelHtWifiRemoteStation).
+ * EWMA calculation:
+ * ewma_prob =[prob *(100 - ewma_level) + (ewma_prob_old * ewma_level)]/100
  */
 struct MinstrelHtRateInfo
 {
@@ -114,19 +119,12 @@ struct MinstrelHtRateInfo
   uint32_t numRateSuccess;      //!< Number of successful frames transmitted so far.
   double prob;                  //!< Current probability within last time interval. (# frame success )/(# total frames)
   bool retryUpdated;            //!< If number of retries was updated already.
-  /**
-   * Exponential weighted moving average of probability.
-   * EWMA calculation:
-   * ewma_prob =[prob *(100 - ewma_level) + (ewma_prob_old * ewma_level)]/100
-   */
-  double ewmaProb;
   double ewmsdProb;             //!< Exponential weighted moving standard deviation of probability.
   uint32_t prevNumRateAttempt;  //!< Number of transmission attempts with previous rate.
   uint32_t prevNumRateSuccess;  //!< Number of successful frames transmitted with previous rate.
   uint32_t numSamplesSkipped;   //!< Number of times this rate statistics were not updated because no attempts have been made.
   uint64_t successHist;         //!< Aggregate of all transmission successes.
   uint64_t attemptHist;         //!< Aggregate of all transmission attempts.
-  double throughput;            //!< Throughput of this rate (in packets per second).
 };
 
 /**
@@ -30,6 +30,7 @@
  */
 
 #include <iomanip>
+#include <algorithm>
 #include "ns3/packet.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/simulator.h"
@@ -542,8 +543,19 @@ MinstrelWifiManager::UpdateStats (MinstrelWifiRemoteStation *station)
       return;
     }
   NS_LOG_FUNCTION (this);
-  station->m_nextStatsUpdate = Simulator::Now () + m_updateStats;
-  NS_LOG_DEBUG ("Next update at " << station->m_nextStatsUpdate);
+  /**
+   * Statistics are only refreshed when the station is used, hence several update
+   * intervals may have elapsed since the last update. All the attempts made since
+   * then belong to the first elapsed interval; the other intervals had no attempt
+   * and are accounted for in closed form below.
+   */
+  int64_t missedIntervals = 0;
+  if (m_updateStats.IsStrictlyPositive ())
+    {
+      missedIntervals = (Simulator::Now () - station->m_nextStatsUpdate).GetTimeStep () / m_updateStats.GetTimeStep ();
+    }
+  station->m_nextStatsUpdate += (missedIntervals + 1) * m_updateStats;
+  NS_LOG_DEBUG ("Next update at " << station->m_nextStatsUpdate << " (" << missedIntervals << " intervals without attempts)");
   NS_LOG_DEBUG ("Currently using rate: " << station->m_txrate << " (" << GetSupported (station, station->m_txrate) << ")");
 
   Time txTime;
@@ -607,6 +619,14 @@ MinstrelWifiManager::UpdateStats (MinstrelWifiRemoteStation *station)
       station->m_minstrelTable[i].numRateSuccess = 0;
       station->m_minstrelTable[i].numRateAttempt = 0;
 
+      //intervals elapsed without any attempt
+      if (missedIntervals > 0)
+        {
+          station->m_minstrelTable[i].numSamplesSkipped = static_cast<uint8_t> (std::min<int64_t> (station->m_minstrelTable[i].numSamplesSkipped + missedIntervals, UINT8_MAX));
+          station->m_minstrelTable[i].prevNumRateSuccess = 0;
+          station->m_minstrelTable[i].prevNumRateAttempt = 0;
+        }
+
       //Sample less often below 10% and  above 95% of success
       if ((station->m_minstrelTable[i].ewmaProb > 17100) || (station->m_minstrelTable[i].ewmaProb < 1800))
         {
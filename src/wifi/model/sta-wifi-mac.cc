@@ -28,6 +28,7 @@
 #include "wifi-phy.h"
 #include "mgt-headers.h"
 #include "snr-tag.h"
+#include "wifi-psdu.h"
 #include "wifi-net-device.h"
 #include "ns3/ht-configuration.h"
 #include "ns3/he-configuration.h"
@@ -144,6 +145,8 @@ StaWifiMac::SetWifiPhy (const Ptr<WifiPhy> phy)
   NS_LOG_FUNCTION (this << phy);
   WifiMac::SetWifiPhy (phy);
   GetWifiPhy ()->SetCapabilitiesChangedCallback (MakeCallback (&StaWifiMac::PhyCapabilitiesChanged, this));
+  GetWifiPhy ()->SetAbstractBeaconCallbacks (MakeCallback (&StaWifiMac::CanReceiveAbstractBeacon, this),
+                                             MakeCallback (&StaWifiMac::ReceiveAbstractBeacon, this));
 }
 
 void
@@ -430,6 +433,32 @@ StaWifiMac::Disassociated (void)
   TryToEnsureAssociated ();
 }
 
+bool
+StaWifiMac::CanReceiveAbstractBeacon (Ptr<const WifiPsdu> psdu) const
+{
+  NS_LOG_FUNCTION (this << *psdu);
+  const WifiMacHeader& hdr = psdu->GetHeader (0);
+  NS_ASSERT (hdr.IsBeacon ());
+  //Stations that are scanning or associating need the full content of the beacon
+  return (m_state == ASSOCIATED && hdr.GetAddr3 () == GetBssid ());
+}
+
+void
+StaWifiMac::ReceiveAbstractBeacon (Ptr<const WifiPsdu> psdu)
+{
+  NS_LOG_FUNCTION (this << *psdu);
+  if (!CanReceiveAbstractBeacon (psdu))
+    {
+      NS_LOG_DEBUG ("No longer associated with the AP that sent the beacon, ignore it");
+      return;
+    }
+  NS_LOG_DEBUG ("Beacon from " << psdu->GetHeader (0).GetAddr2 () << " processed analytically");
+  MgtBeaconHeader beacon;
+  psdu->GetPayload (0)->PeekHeader (beacon);
+  m_beaconArrival (Simulator::Now ());
+  RestartBeaconWatchdog (MicroSeconds (beacon.GetBeaconIntervalUs () * m_maxMissedBeacons));
+}
+
 void
 StaWifiMac::RestartBeaconWatchdog (Time delay)
 {
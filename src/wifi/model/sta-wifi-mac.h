@@ -34,6 +34,7 @@ namespace ns3  {
 
 class SupportedRates;
 class CapabilityInformation;
+class WifiPsdu;
 
 /**
  * \ingroup wifi
@@ -270,6 +271,23 @@ private:
    * \param delay the delay before the watchdog fires
    */
   void RestartBeaconWatchdog (Time delay);
+  /**
+   * Check whether a beacon can be processed analytically (beacon abstraction).
+   * This is only possible if we are associated with the AP that sent the beacon.
+   *
+   * \param psdu the PSDU containing the beacon
+   * \return true if the beacon can be processed analytically, false if it has
+   *         to be received through the regular reception process
+   */
+  bool CanReceiveAbstractBeacon (Ptr<const WifiPsdu> psdu) const;
+  /**
+   * Process a beacon analytically (beacon abstraction) at the end of its
+   * successful reception: the beacon watchdog is restarted as if the beacon
+   * were received.
+   *
+   * \param psdu the PSDU containing the beacon
+   */
+  void ReceiveAbstractBeacon (Ptr<const WifiPsdu> psdu);
   /**
    * Take actions after disassociation.
    */
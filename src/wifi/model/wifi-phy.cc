@@ -38,6 +38,7 @@
 #include "wifi-net-device.h"
 #include "wifi-psdu.h"
 #include "wifi-ppdu.h"
+#include "beacon-abstraction-tag.h"
 #include "ns3/dsss-phy.h"
 #include "ns3/erp-ofdm-phy.h"
 #include "ns3/he-phy.h" //includes OFDM, HT, and VHT
@@ -199,6 +200,18 @@ WifiPhy::GetTypeId (void)
                    MakeBooleanAccessor (&WifiPhy::GetShortPhyPreambleSupported,
                                         &WifiPhy::SetShortPhyPreambleSupported),
                    MakeBooleanChecker ())
+    .AddAttribute ("AbstractReception",
+                   "If enabled, the reception of the PHY header fields is resolved by a single "
+                   "event at the start of the payload and the reception of the MPDUs is resolved "
+                   "at the end of the PPDU, instead of scheduling one event per PHY header field "
+                   "and per MPDU. The SNIR computations and the timing of the PHY state changes "
+                   "(CCA busy, RX start and RX end) are preserved, but MPDUs of an A-MPDU are "
+                   "forwarded to the MAC at the end of the PPDU. HE TB PPDUs are always "
+                   "received field by field.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&WifiPhy::GetAbstractReception,
+                                        &WifiPhy::SetAbstractReception),
+                   MakeBooleanChecker ())
     .AddAttribute ("FrameCaptureModel",
                    "Ptr to an object that implements the frame capture model",
                    PointerValue (),
@@ -289,6 +302,12 @@ WifiPhy::GetTypeId (void)
                      "has been dropped by the device during reception",
                      MakeTraceSourceAccessor (&WifiPhy::m_phyRxDropTrace),
                      "ns3::Packet::TracedCallback")
+    .AddTraceSource ("PhyRxAbstractBeacon",
+                     "Trace source indicating a beacon has been processed "
+                     "analytically (beacon abstraction), hence saving "
+                     "the events of the reception process",
+                     MakeTraceSourceAccessor (&WifiPhy::m_phyRxAbstractBeaconTrace),
+                     "ns3::Packet::TracedCallback")
     .AddTraceSource ("MonitorSnifferRx",
                      "Trace source simulating a wifi device in monitor mode "
                      "sniffing all received frames",
@@ -323,6 +342,7 @@ WifiPhy::WifiPhy ()
     m_blockAckTxTime (Seconds (0)),
     m_powerRestricted (false),
     m_channelAccessRequested (false),
+    m_abstractReception (false),
     m_txSpatialStreams (0),
     m_rxSpatialStreams (0),
     m_wifiRadioEnergyModel (0),
@@ -358,6 +378,7 @@ WifiPhy::DoDispose (void)
   m_random = 0;
   m_state = 0;
   m_currentEvent = 0;
+  m_abstractBeaconEvent = 0;
   for (auto & preambleEvent : m_currentPreambleEvents)
     {
       preambleEvent.second = 0;
@@ -414,6 +435,13 @@ WifiPhy::SetCapabilitiesChangedCallback (Callback<void> callback)
   m_capabilitiesChangedCallback = callback;
 }
 
+void
+WifiPhy::SetAbstractBeaconCallbacks (AbstractBeaconCheckCallback check, AbstractBeaconCallback receive)
+{
+  m_abstractBeaconCheckCallback = check;
+  m_abstractBeaconCallback = receive;
+}
+
 void
 WifiPhy::SetRxSensitivity (double threshold)
 {
@@ -526,6 +554,19 @@ WifiPhy::GetShortPhyPreambleSupported (void) const
   return m_shortPreamble;
 }
 
+void
+WifiPhy::SetAbstractReception (bool enable)
+{
+  NS_LOG_FUNCTION (this << enable);
+  m_abstractReception = enable;
+}
+
+bool
+WifiPhy::GetAbstractReception (void) const
+{
+  return m_abstractReception;
+}
+
 void
 WifiPhy::SetDevice (const Ptr<WifiNetDevice> device)
 {
@@ -1801,6 +1842,17 @@ WifiPhy::Reset (void)
 void
 WifiPhy::StartReceivePreamble (Ptr<WifiPpdu> ppdu, RxPowerWattPerChannelBand& rxPowersW, Time rxDuration)
 {
+  if (m_abstractBeaconEvent != 0 && m_abstractBeaconEvent == m_currentEvent && m_endPhyRxEvent.IsRunning ()
+      && m_abstractBeaconEvent->GetEndTime () == Simulator::Now ())
+    {
+      //The beacon processed analytically ends when this PPDU arrives
+      m_endPhyRxEvent.Cancel ();
+      EndReceiveAbstractBeacon ();
+    }
+  if (ReceiveAbstractBeacon (ppdu, rxPowersW))
+    {
+      return;
+    }
   WifiModulationClass modulation = ppdu->GetTxVector ().GetModulationClass ();
   auto it = m_phyEntities.find (modulation);
   if (it != m_phyEntities.end ())
@@ -1819,6 +1871,109 @@ WifiPhy::StartReceivePreamble (Ptr<WifiPpdu> ppdu, RxPowerWattPerChannelBand& rx
     }
 }
 
+bool
+WifiPhy::ReceiveAbstractBeacon (Ptr<const WifiPpdu> ppdu, RxPowerWattPerChannelBand& rxPowersW)
+{
+  NS_LOG_FUNCTION (this << ppdu);
+  //Beacons are sent in non-HT PPDUs
+  BeaconAbstractionTag tag;
+  if (m_abstractBeaconCheckCallback.IsNull ()
+      || ppdu->GetModulation () >= WIFI_MOD_CLASS_HT
+      || m_phyEntities.find (ppdu->GetModulation ()) == m_phyEntities.end ()
+      || ppdu->IsTruncatedTx ()
+      || ppdu->GetPsdu ()->GetNMpdus () != 1
+      || !ppdu->GetPsdu ()->GetHeader (0).IsBeacon ()
+      || !ppdu->GetPsdu ()->GetPayload (0)->PeekPacketTag (tag))
+    {
+      return false;
+    }
+  if (m_currentEvent != 0 || !m_currentPreambleEvents.empty ()
+      || !(m_state->IsStateIdle () || m_state->IsStateCcaBusy ())
+      || !m_abstractBeaconCheckCallback (ppdu->GetPsdu ()))
+    {
+      return false;
+    }
+  Time rxDuration = ppdu->GetTxDuration ();
+  Ptr<Event> event = m_interference.Add (ppdu, ppdu->GetTxVector (), rxDuration, rxPowersW);
+
+  //Preamble detection is performed with the signals present when the beacon arrives
+  uint16_t measurementChannelWidth = GetMeasurementChannelWidth (ppdu);
+  WifiSpectrumBand measurementBand = GetPrimaryBand (measurementChannelWidth);
+  double rxPowerW = event->GetRxPowerW (measurementBand);
+  double snr = m_interference.CalculateSnr (event, measurementChannelWidth, 1, measurementBand);
+  NS_LOG_DEBUG ("SNR(dB)=" << RatioToDb (snr) << " at the start of the beacon processed analytically");
+  if ((!m_preambleDetectionModel && rxPowerW <= 0.0)
+      || (m_preambleDetectionModel && !m_preambleDetectionModel->IsPreambleDetected (rxPowerW, snr, measurementChannelWidth)))
+    {
+      NS_LOG_DEBUG ("Drop beacon because PHY preamble detection failed");
+      NotifyRxDrop (ppdu->GetPsdu (), PREAMBLE_DETECT_FAILURE);
+      SwitchMaybeToCcaBusy (measurementChannelWidth);
+      return true;
+    }
+
+  NS_LOG_DEBUG ("Beacon processed analytically, medium busy for " << rxDuration.As (Time::US));
+  m_interference.NotifyRxStart ();
+  m_currentEvent = event;
+  m_abstractBeaconEvent = event;
+  m_timeLastPreambleDetected = Simulator::Now ();
+  m_state->SwitchMaybeToCcaBusy (rxDuration);
+  m_endPhyRxEvent = Simulator::Schedule (rxDuration, &WifiPhy::EndReceiveAbstractBeacon, this);
+  return true;
+}
+
+void
+WifiPhy::EndReceiveAbstractBeacon (void)
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<Event> event = m_abstractBeaconEvent;
+  NS_ASSERT (event != 0 && event == m_currentEvent);
+  NS_ASSERT (event->GetEndTime () == Simulator::Now ());
+  m_abstractBeaconEvent = 0;
+  Ptr<const WifiPpdu> ppdu = event->GetPpdu ();
+  Ptr<const WifiPsdu> psdu = ppdu->GetPsdu ();
+  uint16_t measurementChannelWidth = GetMeasurementChannelWidth (ppdu);
+  WifiSpectrumBand measurementBand = GetPrimaryBand (measurementChannelWidth);
+
+  //Same random draws as the regular reception process: PHY header, then payload
+  PhyEntity::SnrPer snrPer = m_interference.CalculatePhyHeaderSnrPer (event, measurementChannelWidth, measurementBand,
+                                                                      WIFI_PPDU_FIELD_NON_HT_HEADER);
+  NS_LOG_DEBUG ("PHY header: SNR(dB)=" << RatioToDb (snrPer.snr) << ", PER=" << snrPer.per);
+  bool headerSuccess = (m_random->GetValue () > snrPer.per);
+  bool success = false;
+  if (headerSuccess)
+    {
+      Time psduDuration = ppdu->GetTxDuration () - CalculatePhyPreambleAndHeaderDuration (ppdu->GetTxVector ());
+      snrPer = m_interference.CalculatePayloadSnrPer (event, measurementChannelWidth, measurementBand, SU_STA_ID,
+                                                      std::make_pair (Seconds (0), psduDuration));
+      NS_LOG_DEBUG ("Payload: SNR(dB)=" << RatioToDb (snrPer.snr) << ", PER=" << snrPer.per);
+      success = (m_random->GetValue () > snrPer.per
+                 && !(m_postReceptionErrorModel && m_postReceptionErrorModel->IsCorrupt (psdu->GetPacket ()->Copy ())));
+    }
+
+  m_interference.NotifyRxEnd (Simulator::Now ());
+  m_currentEvent = 0;
+  if (m_state->IsStateSleep ())
+    {
+      NS_LOG_DEBUG ("Drop beacon because in sleep mode");
+      NotifyRxDrop (psdu, SLEEPING);
+    }
+  else if (!headerSuccess)
+    {
+      NS_LOG_DEBUG ("Drop beacon because PHY header reception failed");
+      NotifyRxDrop (psdu, L_SIG_FAILURE);
+    }
+  else if (success)
+    {
+      m_phyRxAbstractBeaconTrace (psdu->GetPacket ());
+      m_abstractBeaconCallback (psdu);
+    }
+  else
+    {
+      NS_LOG_DEBUG ("Beacon processed analytically has not been successfully received");
+    }
+  SwitchMaybeToCcaBusy (measurementChannelWidth);
+}
+
 WifiSpectrumBand
 WifiPhy::ConvertHeRuSubcarriers (uint16_t bandWidth, uint16_t guardBandwidth,
                                  HeRu::SubcarrierRange range, uint8_t bandIndex) const
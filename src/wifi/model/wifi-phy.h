@@ -96,6 +96,27 @@ public:
    */
   void SetCapabilitiesChangedCallback (Callback<void> callback);
 
+  /**
+   * Callback invoked when the reception of a beacon marked by the AP as
+   * suitable for beacon abstraction starts, to let the MAC tell whether it can
+   * process the beacon analytically. If not, the beacon goes through the
+   * regular reception process.
+   */
+  typedef Callback<bool, Ptr<const WifiPsdu>> AbstractBeaconCheckCallback;
+  /**
+   * Callback invoked when a beacon processed analytically has been
+   * successfully received.
+   */
+  typedef Callback<void, Ptr<const WifiPsdu>> AbstractBeaconCallback;
+
+  /**
+   * \param check the callback to invoke when the reception of a beacon marked
+   *        by the AP as suitable for beacon abstraction starts
+   * \param receive the callback to invoke at the end of the successful
+   *        reception of a beacon processed analytically
+   */
+  void SetAbstractBeaconCallbacks (AbstractBeaconCheckCallback check, AbstractBeaconCallback receive);
+
   /**
    * Start receiving the PHY preamble of a PPDU (i.e. the first bit of the preamble has arrived).
    *
@@ -955,6 +976,20 @@ public:
    * \returns if short PHY preamble is supported or not
    */
   bool GetShortPhyPreambleSupported (void) const;
+  /**
+   * Enable or disable the abstract reception mode, in which the PHY header
+   * fields are resolved by a single event at the start of the payload and
+   * the MPDUs are resolved at the end of the PPDU.
+   *
+   * \param enable whether the abstract reception mode is enabled
+   */
+  void SetAbstractReception (bool enable);
+  /**
+   * Return whether the abstract reception mode is enabled.
+   *
+   * \returns true if the abstract reception mode is enabled
+   */
+  bool GetAbstractReception (void) const;
 
   /**
    * Sets the error rate model.
@@ -1245,6 +1280,33 @@ protected:
 
 
 private:
+  /**
+   * Try to process the given PPDU as a beacon processed analytically (beacon
+   * abstraction). This is only possible if the AP marked the beacon as
+   * suitable, the PHY is neither receiving nor transmitting and the MAC
+   * accepts the beacon (see SetAbstractBeaconCallbacks). The beacon is then
+   * added to the interference helper and preamble detection is performed
+   * right away. If the preamble is detected, the PHY synchronizes on the
+   * beacon, keeps CCA busy for its duration and schedules a single event at
+   * its end, where the PHY header and the payload are checked (see
+   * EndReceiveAbstractBeacon).
+   *
+   * \param ppdu the arriving PPDU
+   * \param rxPowersW the receive power in W per band
+   * \return true if the PPDU has been processed as a beacon processed
+   *         analytically, false if it must go through the regular reception
+   *         process
+   */
+  bool ReceiveAbstractBeacon (Ptr<const WifiPpdu> ppdu, RxPowerWattPerChannelBand& rxPowersW);
+  /**
+   * End the reception of the beacon processed analytically: the success of
+   * the PHY header and of the payload is drawn from the PER computed by the
+   * interference helper over the whole beacon, as the regular reception
+   * process would do, and the beacon is handed to the MAC if it has been
+   * successfully received.
+   */
+  void EndReceiveAbstractBeacon (void);
+
   /**
    * Configure WifiPhy with appropriate channel frequency and
    * supported rates for 802.11a standard.
@@ -1381,6 +1443,14 @@ private:
    */
   TracedCallback<Ptr<const Packet>, WifiPhyRxfailureReason > m_phyRxDropTrace;
 
+  /**
+   * The trace source fired when a beacon is processed analytically, i.e.,
+   * without going through the events of the reception process.
+   *
+   * \see class CallBackTraceSource
+   */
+  TracedCallback<Ptr<const Packet> > m_phyRxAbstractBeaconTrace;
+
   /**
    * A trace source that emulates a Wi-Fi device in monitor mode
    * sniffing a packet being received.
@@ -1448,6 +1518,8 @@ private:
   double m_txPowerMaxMimo;       //!< MIMO maximum transmit power due to OBSS PD SR power restriction (dBm)
   bool m_channelAccessRequested; //!< Flag if channels access has been requested (used for OBSS_PD SR)
 
+  bool m_abstractReception;      //!< Flag if PHY header fields and MPDUs are resolved without per-field events
+
   bool m_shortPreamble;        //!< Flag if short PHY preamble is supported
   uint8_t m_numberOfAntennas;  //!< Number of transmitters
   uint8_t m_txSpatialStreams;  //!< Number of supported TX spatial streams
@@ -1465,6 +1537,9 @@ private:
   Time m_timeLastPreambleDetected;                      //!< Record the time the last preamble was detected
 
   Callback<void> m_capabilitiesChangedCallback; //!< Callback when PHY capabilities changed
+  AbstractBeaconCheckCallback m_abstractBeaconCheckCallback; //!< Callback to check whether a beacon can be processed analytically
+  AbstractBeaconCallback m_abstractBeaconCallback; //!< Callback to process beacons analytically
+  Ptr<Event> m_abstractBeaconEvent; //!< the beacon being processed analytically, if any
 };
 
 /**
@@ -88,38 +88,49 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double
   NS_LOG_FUNCTION (this << sender << ppdu << txPowerDbm);
   Ptr<MobilityModel> senderMobility = sender->GetMobility ();
   NS_ASSERT (senderMobility != 0);
+  //For now don't account for inter channel interference nor channel bonding
+  PropagationReceiverBatch receivers;
+  receivers.SetTransmitter (senderMobility);
+  std::vector<Ptr<YansWifiPhy> > phys;
   for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
     {
-      if (sender != (*i))
+      if (sender != (*i) && (*i)->GetChannelNumber () == sender->GetChannelNumber ())
         {
-          //For now don't account for inter channel interference nor channel bonding
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
-            {
-              continue;
-            }
-
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<WifiPpdu> copy = ppdu->Copy ();
-          Ptr<NetDevice> dstNetDevice = (*i)->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
-            {
-              dstNode = 0xffffffff;
-            }
-          else
-            {
-              dstNode = dstNetDevice->GetNode ()->GetId ();
-            }
-
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive,
-                                          (*i), copy, rxPowerDbm);
+          receivers.AddReceiver ((*i)->GetMobility ()->GetObject<MobilityModel> ());
+          phys.push_back (*i);
         }
     }
+  if (phys.empty ())
+    {
+      return;
+    }
+  std::vector<Time> delays;
+  m_delay->GetDelays (receivers, delays);
+  std::vector<double> rxPowersDbm;
+  m_loss->CalcRxPowers (txPowerDbm, receivers, rxPowersDbm);
+
+  for (std::size_t j = 0; j < phys.size (); j++)
+    {
+      Ptr<YansWifiPhy> phy = phys[j];
+      double rxPowerDbm = rxPowersDbm[j];
+      NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                    "distance=" << receivers.GetDistances ()[j] << "m, delay=" << delays[j]);
+      Ptr<WifiPpdu> copy = ppdu->Copy ();
+      Ptr<NetDevice> dstNetDevice = phy->GetDevice ();
+      uint32_t dstNode;
+      if (dstNetDevice == 0)
+        {
+          dstNode = 0xffffffff;
+        }
+      else
+        {
+          dstNode = dstNetDevice->GetNode ()->GetId ();
+        }
+
+      Simulator::ScheduleWithContext (dstNode,
+                                      delays[j], &YansWifiChannel::Receive,
+                                      phy, copy, rxPowerDbm);
+    }
 }
 
 void
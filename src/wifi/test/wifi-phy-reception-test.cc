@@ -1438,7 +1438,11 @@ TestPhyHeadersReception::DoRun (void)
 class TestAmpduReception : public TestCase
 {
 public:
-  TestAmpduReception ();
+  /**
+   * Constructor
+   * \param abstractReception whether the PHY uses the abstract (single-event) reception mode
+   */
+  TestAmpduReception (bool abstractReception = false);
   virtual ~TestAmpduReception ();
 
 protected:
@@ -1540,17 +1544,19 @@ private:
   uint8_t m_rxDroppedBitmapAmpdu2; ///< bitmap of dropped MPDUs in A-MPDU #2
 
   uint64_t m_uid;                  ///< UID
+  bool m_abstractReception;        ///< whether the PHY uses the abstract reception mode
 };
 
-TestAmpduReception::TestAmpduReception ()
-: TestCase ("A-MPDU reception test"),
+TestAmpduReception::TestAmpduReception (bool abstractReception)
+: TestCase (std::string ("A-MPDU reception test") + (abstractReception ? " with abstract reception" : "")),
   m_rxSuccessBitmapAmpdu1 (0),
   m_rxSuccessBitmapAmpdu2 (0),
   m_rxFailureBitmapAmpdu1 (0),
   m_rxFailureBitmapAmpdu2 (0),
   m_rxDroppedBitmapAmpdu1 (0),
   m_rxDroppedBitmapAmpdu2 (0),
-  m_uid (0)
+  m_uid (0),
+  m_abstractReception (abstractReception)
 {
 }
 
@@ -1780,6 +1786,7 @@ TestAmpduReception::DoSetup (void)
   Ptr<ErrorRateModel> error = CreateObject<NistErrorRateModel> ();
   m_phy->SetErrorRateModel (error);
   m_phy->SetOperatingChannel (WifiPhy::ChannelTuple {CHANNEL_NUMBER, 0, WIFI_PHY_BAND_5GHZ, 0});
+  m_phy->SetAbstractReception (m_abstractReception);
 
   m_phy->SetReceiveOkCallback (MakeCallback (&TestAmpduReception::RxSuccess, this));
   m_phy->SetReceiveErrorCallback (MakeCallback (&TestAmpduReception::RxFailure, this));
@@ -2566,6 +2573,7 @@ WifiPhyReceptionTestSuite::WifiPhyReceptionTestSuite ()
   AddTestCase (new TestSimpleFrameCaptureModel, TestCase::QUICK);
   AddTestCase (new TestPhyHeadersReception, TestCase::QUICK);
   AddTestCase (new TestAmpduReception, TestCase::QUICK);
+  AddTestCase (new TestAmpduReception (true), TestCase::QUICK);
   AddTestCase (new TestUnsupportedModulationReception (), TestCase::QUICK);
 }
 
@@ -1997,6 +1997,185 @@ StaWifiMacScanningTestCase::DoRun (void)
   }
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that beacon abstraction does not change the beacon arrivals.
+ *
+ * The scenario considers an access point and two stations, attached to a
+ * YansWifiChannel or to a MultiModelSpectrumChannel. When the
+ * EnableBeaconAbstraction attribute of the AP is set, the beacons whose
+ * content did not change are expected to be processed analytically by the
+ * associated stations. From 1.2 seconds, the first station drops all the
+ * received frames through its post-reception error model, hence it misses
+ * the beacons and loses its association. Beacon abstraction must not change
+ * anything else than the number of events: the beacon arrivals are expected
+ * to be reported at the same times and in the context of the same nodes as
+ * when the attribute is not set, and the first station must lose its
+ * association the same way.
+ */
+class BeaconAbstractionTestCase : public TestCase
+{
+public:
+  BeaconAbstractionTestCase ();
+  virtual ~BeaconAbstractionTestCase ();
+  void DoRun (void) override;
+
+private:
+  /**
+   * Run the scenario
+   * \param enableBeaconAbstraction whether beacon abstraction is enabled at the AP
+   * \param useSpectrum whether the devices use SpectrumWifiPhy instead of YansWifiPhy
+   */
+  void RunOne (bool enableBeaconAbstraction, bool useSpectrum);
+  /**
+   * Callback function on beacon arrival at a STA
+   * \param context context string
+   * \param time the time of the beacon arrival
+   */
+  void BeaconArrival (std::string context, Time time);
+  /**
+   * Callback function on beacon processed analytically at a STA
+   * \param context context string
+   * \param packet the beacon
+   */
+  void AbstractBeacon (std::string context, Ptr<const Packet> packet);
+  /**
+   * Callback function on STA deassoc event
+   * \param context context string
+   * \param bssid the AP's bssid
+   */
+  void DeAssocCallback (std::string context, Mac48Address bssid);
+
+  /// The beacon arrivals, as pairs of the time of the arrival and of the simulation context
+  typedef std::vector<std::pair<Time, uint32_t> > BeaconArrivals;
+
+  BeaconArrivals m_beaconArrivals; ///< beacon arrivals at the STAs
+  uint32_t m_abstractBeacons;      ///< number of beacons processed analytically at the STAs
+  uint32_t m_deAssocs;             ///< number of disassociations
+};
+
+BeaconAbstractionTestCase::BeaconAbstractionTestCase ()
+  : TestCase ("Test case for beacon abstraction"),
+    m_abstractBeacons (0),
+    m_deAssocs (0)
+{
+}
+
+BeaconAbstractionTestCase::~BeaconAbstractionTestCase ()
+{
+}
+
+void
+BeaconAbstractionTestCase::BeaconArrival (std::string context, Time time)
+{
+  //context is "/NodeList/<node>/DeviceList/..."
+  uint32_t nodeId = std::stoul (context.substr (10, context.find ('/', 10) - 10));
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetContext (), nodeId, "Beacon arrival not reported in the context of the STA");
+  NS_TEST_EXPECT_MSG_EQ (time, Simulator::Now (), "Beacon arrival not reported when it occurs");
+  m_beaconArrivals.push_back (std::make_pair (time, Simulator::GetContext ()));
+}
+
+void
+BeaconAbstractionTestCase::AbstractBeacon (std::string context, Ptr<const Packet> packet)
+{
+  m_abstractBeacons++;
+}
+
+void
+BeaconAbstractionTestCase::DeAssocCallback (std::string context, Mac48Address bssid)
+{
+  m_deAssocs++;
+}
+
+void
+BeaconAbstractionTestCase::RunOne (bool enableBeaconAbstraction, bool useSpectrum)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  int64_t streamNumber = 1;
+  m_beaconArrivals.clear ();
+  m_abstractBeacons = 0;
+  m_deAssocs = 0;
+
+  Ptr<Node> apNode = CreateObject<Node> ();
+  NodeContainer staNodes;
+  staNodes.Create (2);
+
+  YansWifiPhyHelper yansPhy;
+  YansWifiChannelHelper yansChannel = YansWifiChannelHelper::Default ();
+  yansPhy.SetChannel (yansChannel.Create ());
+
+  SpectrumWifiPhyHelper spectrumPhy;
+  Ptr<MultiModelSpectrumChannel> spectrumChannel = CreateObject<MultiModelSpectrumChannel> ();
+  spectrumChannel->AddPropagationLossModel (CreateObject<FriisPropagationLossModel> ());
+  spectrumChannel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  spectrumPhy.SetChannel (spectrumChannel);
+
+  const WifiPhyHelper &phy = useSpectrum ? static_cast<const WifiPhyHelper &> (spectrumPhy) : yansPhy;
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_STANDARD_80211n);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager");
+
+  WifiMacHelper mac;
+  NetDeviceContainer apDevice, staDevices;
+  mac.SetType ("ns3::ApWifiMac",
+               "EnableBeaconAbstraction", BooleanValue (enableBeaconAbstraction));
+  apDevice = wifi.Install (phy, mac, apNode);
+  mac.SetType ("ns3::StaWifiMac");
+  staDevices = wifi.Install (phy, mac, staNodes);
+
+  // Assign fixed streams to random variables in use
+  wifi.AssignStreams (apDevice, streamNumber);
+  wifi.AssignStreams (staDevices, streamNumber + 1);
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (5.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (0.0, 5.0, 0.0));
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (apNode);
+  mobility.Install (staNodes);
+
+  Ptr<RateErrorModel> errorModel = CreateObject<RateErrorModel> ();
+  errorModel->SetAttribute ("ErrorRate", DoubleValue (1.0));
+  errorModel->SetAttribute ("ErrorUnit", StringValue ("ERROR_UNIT_PACKET"));
+  Ptr<WifiPhy> staPhy = DynamicCast<WifiNetDevice> (staDevices.Get (0))->GetPhy ();
+  Simulator::Schedule (Seconds (1.2), &WifiPhy::SetPostReceptionErrorModel, staPhy, errorModel);
+
+  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::StaWifiMac/BeaconArrival", MakeCallback (&BeaconAbstractionTestCase::BeaconArrival, this));
+  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::StaWifiMac/DeAssoc", MakeCallback (&BeaconAbstractionTestCase::DeAssocCallback, this));
+  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyRxAbstractBeacon", MakeCallback (&BeaconAbstractionTestCase::AbstractBeacon, this));
+
+  Simulator::Stop (Seconds (3.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+BeaconAbstractionTestCase::DoRun (void)
+{
+  for (bool useSpectrum : {false, true})
+    {
+      RunOne (false, useSpectrum);
+      NS_TEST_ASSERT_MSG_EQ (m_abstractBeacons, 0, "No beacon should be processed analytically");
+      NS_TEST_ASSERT_MSG_EQ (m_deAssocs, 1, "The first STA should lose its association");
+      BeaconArrivals beaconArrivals = m_beaconArrivals;
+
+      RunOne (true, useSpectrum);
+      NS_TEST_ASSERT_MSG_GT (m_abstractBeacons, 0, "Unchanged beacons should be processed analytically");
+      NS_TEST_ASSERT_MSG_EQ (m_deAssocs, 1, "The first STA should lose its association");
+      NS_TEST_ASSERT_MSG_EQ (m_beaconArrivals.size (), beaconArrivals.size (), "Beacon abstraction should not change the number of beacon arrivals");
+      for (std::size_t i = 0; i < beaconArrivals.size (); i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (m_beaconArrivals[i].first, beaconArrivals[i].first, "Beacon abstraction should not change the time of beacon arrival #" << i);
+          NS_TEST_EXPECT_MSG_EQ (m_beaconArrivals[i].second, beaconArrivals[i].second, "Beacon abstraction should not change the context of beacon arrival #" << i);
+        }
+    }
+}
+
 //-----------------------------------------------------------------------------
 /**
  * Make sure that the ADDBA handshake process is protected.
@@ -3165,6 +3344,7 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new Bug2843TestCase, TestCase::QUICK); //Bug 2843
   AddTestCase (new Bug2831TestCase, TestCase::QUICK); //Bug 2831
   AddTestCase (new StaWifiMacScanningTestCase, TestCase::QUICK); //Bug 2399
+  AddTestCase (new BeaconAbstractionTestCase, TestCase::QUICK);
   AddTestCase (new Bug2470TestCase, TestCase::QUICK); //Bug 2470
   AddTestCase (new Issue40TestCase, TestCase::QUICK); //Issue #40
   AddTestCase (new Issue169TestCase, TestCase::QUICK); //Issue #169